@@ -6,6 +6,8 @@
 #include "App.h"
 #include "Explorer++.h"
 #include "AsyncIconFetcher.h"
+#include "BinaryAppStorageFactory.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
 #include "BrowserWindow.h"
 #include "ColorRuleModel.h"
 #include "ColorRuleModelFactory.h"
@@ -15,12 +17,17 @@
 #include "DriveEnumeratorImpl.h"
 #include "ExitCode.h"
 #include "FileSystemWatcher.h"
+#include "FolderListingCache.h"
+#include "FolderPrefetcher.h"
+#include "HistorySearchIndex.h"
+#include "IncrementalSettingsWriter.h"
 #include "LanguageHelper.h"
 #include "MainRebarStorage.h"
 #include "MainResource.h"
 #include "RegistryAppStorage.h"
 #include "RegistryAppStorageFactory.h"
 #include "ResourceHelper.h"
+#include "SettingsChangeTracker.h"
 #include "ShellWatcher.h"
 #include "TabStorage.h"
 #include "UIThreadExecutor.h"
@@ -35,11 +42,45 @@
 
 using namespace std::chrono_literals;
 
+namespace
+{
+
+XmlAppStorageFactory::Backend GetXmlStorageBackend(const FeatureList &featureList)
+{
+	return featureList.IsEnabled(Feature::StreamingXmlStorage)
+		? XmlAppStorageFactory::Backend::Streaming
+		: XmlAppStorageFactory::Backend::MsXml;
+}
+
+// Prefetched listings are stored in the listing cache, so prefetching is only possible when that
+// cache is also enabled. When prefetching is disabled, there's no need to create the prefetch
+// thread at all.
+std::unique_ptr<FolderPrefetcher> MaybeCreateFolderPrefetcher(const FeatureList &featureList,
+	std::shared_ptr<FolderListingCache> folderListingCache)
+{
+	if (!featureList.IsEnabled(Feature::FolderListingCache)
+		|| !featureList.IsEnabled(Feature::FolderPrefetch))
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<FolderPrefetcher>(folderListingCache,
+		std::make_shared<ComStaThreadPoolExecutor>(1,
+			ComStaThreadPoolExecutor::ThreadPriority::Background),
+		&FolderPrefetcher::IsLocalFixedDriveFolder);
+}
+
+}
+
 App::App(const CommandLine::Settings *commandLineSettings) :
 	m_commandLineSettings(commandLineSettings),
 	m_runtime(std::make_unique<UIThreadExecutor>(),
 		std::make_unique<ComStaThreadPoolExecutor>(std::max(
 			static_cast<int>(std::thread::hardware_concurrency()), MIN_COM_STA_THREADPOOL_SIZE))),
+	m_taskScheduler(GetTaskSchedulerExecutors(m_runtime),
+		std::max(m_runtime.GetComStaExecutor()->max_concurrency_level()
+				- NUM_THREADS_RESERVED_FROM_TASK_SCHEDULER,
+			1)),
 	m_featureList(commandLineSettings->featuresToEnable),
 	m_acceleratorManager(InitializeAcceleratorManager()),
 	m_directoryWatcherFactory(&m_config, &m_shellWatcherManager, m_runtime.GetUiThreadExecutor()),
@@ -47,11 +88,14 @@ App::App(const CommandLine::Settings *commandLineSettings) :
 	m_themeManager(&m_darkModeManager, &m_darkModeColorProvider),
 	m_cachedIcons(std::make_shared<CachedIcons>(MAX_CACHED_ICONS)),
 	m_iconFetcher(std::make_shared<AsyncIconFetcher>(&m_runtime, m_cachedIcons)),
+	m_folderListingCache(std::make_shared<FolderListingCache>()),
+	m_folderPrefetcher(MaybeCreateFolderPrefetcher(m_featureList, m_folderListingCache)),
 	m_colorRuleModel(ColorRuleModelFactory::Create()),
 	m_resourceInstance(GetModuleHandle(nullptr)),
 	m_processManager(&m_browserList),
 	m_tabList(&m_tabEvents),
 	m_tabRestorer(&m_tabEvents, &m_browserList),
+	m_tabMemoryManager(&m_tabList, &m_config),
 	m_historyTracker(&m_historyModel, &m_navigationEvents),
 	m_frequentLocationsModel(m_platformContext.GetSystemClock()),
 	m_frequentLocationsTracker(&m_frequentLocationsModel, &m_navigationEvents),
@@ -109,6 +153,11 @@ int App::Run()
 	const auto saveFrequency = 30s;
 	m_saveSettingsTimer = m_runtime.GetTimerQueue()->make_timer(saveFrequency, saveFrequency,
 		m_runtime.GetUiThreadExecutor(), std::bind_front(&App::SaveSettings, this));
+
+	const auto tabMemoryCheckFrequency = 30s;
+	m_tabMemoryTimer = m_runtime.GetTimerQueue()->make_timer(tabMemoryCheckFrequency,
+		tabMemoryCheckFrequency, m_runtime.GetUiThreadExecutor(),
+		std::bind_front(&TabMemoryManager::EnforceBudget, &m_tabMemoryManager));
 #pragma warning(pop)
 
 	MSG msg;
@@ -122,6 +171,19 @@ int App::Run()
 		}
 	}
 
+	// Any settings that are being written in the background need to be saved before the
+	// application exits.
+	if (m_incrementalSettingsWriter)
+	{
+		m_incrementalSettingsWriter->WaitForPendingWrites();
+	}
+
+	if (m_pendingSnapshotStorage)
+	{
+		m_pendingSnapshotStorage->Commit();
+		m_pendingSnapshotStorage.reset();
+	}
+
 	return static_cast<int>(msg.wParam);
 }
 
@@ -142,14 +204,29 @@ void App::SetUpSession()
 	SetUpLanguageResourceInstance();
 
 	RestoreSession(windows);
+
+	UpdateIncrementalSettingsWriter();
 }
 
 void App::LoadSettings(std::vector<WindowStorageData> &windows)
 {
-	// Settings will be loaded from the config file by default, if that file is present and can be
-	// read.
-	std::unique_ptr<AppStorage> appStorage = XmlAppStorageFactory::MaybeCreate(
-		Storage::GetConfigFilePath(), Storage::OperationType::Load);
+	std::unique_ptr<AppStorage> appStorage;
+
+	// The snapshot is only used if it's in sync with the config file, so loading from it is
+	// equivalent to loading from the config file.
+	if (m_featureList.IsEnabled(Feature::BinarySnapshotStorage))
+	{
+		appStorage = BinaryAppStorageFactory::MaybeCreate(Storage::GetConfigSnapshotFilePath(),
+			Storage::GetConfigFilePath(), Storage::OperationType::Load);
+	}
+
+	// Otherwise, settings will be loaded from the config file by default, if that file is present
+	// and can be read.
+	if (!appStorage)
+	{
+		appStorage = XmlAppStorageFactory::MaybeCreate(Storage::GetConfigFilePath(),
+			Storage::OperationType::Load, GetXmlStorageBackend(m_featureList));
+	}
 
 	if (appStorage)
 	{
@@ -174,6 +251,7 @@ void App::LoadSettings(std::vector<WindowStorageData> &windows)
 	appStorage->LoadDialogStates();
 	appStorage->LoadDefaultColumns(m_config.globalFolderSettings.folderColumns);
 	appStorage->LoadFrequentLocations(&m_frequentLocationsModel);
+	appStorage->LoadHistory(&m_historyModel);
 
 	ValidateColumns(m_config.globalFolderSettings.folderColumns);
 }
@@ -185,12 +263,24 @@ void App::SaveSettings()
 	// already been closed.
 	CHECK(!m_exitStarted);
 
+	if (m_incrementalSettingsWriter)
+	{
+		// There are no change notifications for these sections, so they're always re-serialized.
+		// If their content hasn't changed, the config file won't be rewritten.
+		m_incrementalSettingsWriter->MarkDirty(IncrementalSettingsWriter::Section::Config);
+		m_incrementalSettingsWriter->MarkDirty(IncrementalSettingsWriter::Section::Windows);
+		m_incrementalSettingsWriter->MarkDirty(IncrementalSettingsWriter::Section::DialogStates);
+		m_incrementalSettingsWriter->MarkDirty(IncrementalSettingsWriter::Section::DefaultColumns);
+		m_incrementalSettingsWriter->Flush();
+		return;
+	}
+
 	std::unique_ptr<AppStorage> appStorage;
 
 	if (m_savePreferencesToXmlFile)
 	{
 		appStorage = XmlAppStorageFactory::MaybeCreate(Storage::GetConfigFilePath(),
-			Storage::OperationType::Save);
+			Storage::OperationType::Save, GetXmlStorageBackend(m_featureList));
 	}
 	else
 	{
@@ -203,15 +293,30 @@ void App::SaveSettings()
 		return;
 	}
 
-	std::vector<WindowStorageData> windows;
+	auto windows = GetWindowStorageData();
 
-	for (const auto *browser : m_browserList.GetList())
+	SaveSettingsToStorage(appStorage.get(), windows);
+	appStorage->Commit();
+
+	// The snapshot records the state of the config file, so it has to be written after the config
+	// file has been committed.
+	if (m_savePreferencesToXmlFile && m_featureList.IsEnabled(Feature::BinarySnapshotStorage))
 	{
-		windows.push_back(browser->GetStorageData());
-	}
+		auto snapshotStorage = BinaryAppStorageFactory::MaybeCreate(
+			Storage::GetConfigSnapshotFilePath(), Storage::GetConfigFilePath(),
+			Storage::OperationType::Save);
 
-	DCHECK_GE(windows.size(), 1u);
+		if (snapshotStorage)
+		{
+			SaveSettingsToStorage(snapshotStorage.get(), windows);
+			snapshotStorage->Commit();
+		}
+	}
+}
 
+void App::SaveSettingsToStorage(AppStorage *appStorage,
+	const std::vector<WindowStorageData> &windows)
+{
 	appStorage->SaveConfig(m_config);
 	appStorage->SaveWindows(windows);
 	appStorage->SaveBookmarks(&m_bookmarkTree);
@@ -220,8 +325,90 @@ void App::SaveSettings()
 	appStorage->SaveDialogStates();
 	appStorage->SaveDefaultColumns(m_config.globalFolderSettings.folderColumns);
 	appStorage->SaveFrequentLocations(&m_frequentLocationsModel);
+	appStorage->SaveHistory(&m_historyModel);
+}
 
-	appStorage->Commit();
+void App::SaveSettingsSection(AppStorage *appStorage, IncrementalSettingsWriter::Section section)
+{
+	switch (section)
+	{
+	case IncrementalSettingsWriter::Section::Config:
+		appStorage->SaveConfig(m_config);
+		break;
+
+	case IncrementalSettingsWriter::Section::Windows:
+		appStorage->SaveWindows(GetWindowStorageData());
+		break;
+
+	case IncrementalSettingsWriter::Section::Bookmarks:
+		appStorage->SaveBookmarks(&m_bookmarkTree);
+		break;
+
+	case IncrementalSettingsWriter::Section::ColorRules:
+		appStorage->SaveColorRules(m_colorRuleModel.get());
+		break;
+
+	case IncrementalSettingsWriter::Section::Applications:
+		appStorage->SaveApplications(&m_applicationModel);
+		break;
+
+	case IncrementalSettingsWriter::Section::DialogStates:
+		appStorage->SaveDialogStates();
+		break;
+
+	case IncrementalSettingsWriter::Section::DefaultColumns:
+		appStorage->SaveDefaultColumns(m_config.globalFolderSettings.folderColumns);
+		break;
+
+	case IncrementalSettingsWriter::Section::FrequentLocations:
+		appStorage->SaveFrequentLocations(&m_frequentLocationsModel);
+		break;
+
+	case IncrementalSettingsWriter::Section::History:
+		appStorage->SaveHistory(&m_historyModel);
+		break;
+
+	default:
+		DCHECK(false);
+		break;
+	}
+}
+
+std::vector<WindowStorageData> App::GetWindowStorageData() const
+{
+	std::vector<WindowStorageData> windows;
+
+	for (const auto *browser : m_browserList.GetList())
+	{
+		windows.push_back(browser->GetStorageData());
+	}
+
+	DCHECK_GE(windows.size(), 1u);
+
+	return windows;
+}
+
+void App::UpdateIncrementalSettingsWriter()
+{
+	if (!m_savePreferencesToXmlFile
+		|| !m_featureList.IsEnabled(Feature::AsyncSettingsPersistence))
+	{
+		m_settingsChangeTracker.reset();
+		m_incrementalSettingsWriter.reset();
+		return;
+	}
+
+	if (m_incrementalSettingsWriter)
+	{
+		return;
+	}
+
+	m_incrementalSettingsWriter = std::make_unique<IncrementalSettingsWriter>(&m_runtime,
+		Storage::GetConfigFilePath(), std::bind_front(&App::SaveSettingsSection, this));
+	m_settingsChangeTracker = std::make_unique<SettingsChangeTracker>(
+		m_incrementalSettingsWriter.get(), &m_bookmarkTree, m_colorRuleModel.get(),
+		&m_applicationModel, &m_frequentLocationsModel, &m_historyModel, &m_tabEvents,
+		&m_navigationEvents);
 }
 
 void App::SetUpLanguageResourceInstance()
@@ -358,6 +545,7 @@ bool App::GetSavePreferencesToXmlFile() const
 void App::SetSavePreferencesToXmlFile(bool savePreferencesToXmlFile)
 {
 	m_savePreferencesToXmlFile = savePreferencesToXmlFile;
+	UpdateIncrementalSettingsWriter();
 }
 
 PlatformContext *App::GetPlatformContext()
@@ -370,6 +558,22 @@ Runtime *App::GetRuntime()
 	return &m_runtime;
 }
 
+TaskScheduler *App::GetTaskScheduler()
+{
+	return &m_taskScheduler;
+}
+
+TaskScheduler::Executors App::GetTaskSchedulerExecutors(const Runtime &runtime)
+{
+	auto comStaExecutor =
+		std::dynamic_pointer_cast<ComStaThreadPoolExecutor>(runtime.GetComStaExecutor());
+	CHECK(comStaExecutor);
+
+	return { comStaExecutor->GetExecutorForPriority(TaskScheduler::Priority::Interactive),
+		comStaExecutor->GetExecutorForPriority(TaskScheduler::Priority::Visible),
+		comStaExecutor->GetExecutorForPriority(TaskScheduler::Priority::Background) };
+}
+
 ClipboardWatcher *App::GetClipboardWatcher()
 {
 	return &m_clipboardWatcher;
@@ -405,6 +609,16 @@ std::shared_ptr<AsyncIconFetcher> App::GetIconFetcher()
 	return m_iconFetcher;
 }
 
+std::shared_ptr<FolderListingCache> App::GetFolderListingCache()
+{
+	return m_folderListingCache;
+}
+
+FolderPrefetcher *App::GetFolderPrefetcher()
+{
+	return m_folderPrefetcher.get();
+}
+
 BrowserList *App::GetBrowserList()
 {
 	return &m_browserList;
@@ -420,6 +634,18 @@ BookmarkTree *App::GetBookmarkTree()
 	return &m_bookmarkTree;
 }
 
+BookmarkSearchIndex *App::GetBookmarkSearchIndex()
+{
+	// Building the index requires every bookmark to be visited, so that's only done once the index
+	// is actually needed, rather than at startup.
+	if (!m_bookmarkSearchIndex)
+	{
+		m_bookmarkSearchIndex = std::make_unique<BookmarkSearchIndex>(&m_bookmarkTree);
+	}
+
+	return m_bookmarkSearchIndex.get();
+}
+
 ColorRuleModel *App::GetColorRuleModel() const
 {
 	return m_colorRuleModel.get();
@@ -485,6 +711,17 @@ HistoryModel *App::GetHistoryModel()
 	return &m_historyModel;
 }
 
+HistorySearchIndex *App::GetHistorySearchIndex()
+{
+	if (!m_historySearchIndex)
+	{
+		m_historySearchIndex = std::make_unique<HistorySearchIndex>(&m_historyModel,
+			&m_taskScheduler, m_runtime.GetUiThreadExecutor());
+	}
+
+	return m_historySearchIndex.get();
+}
+
 FrequentLocationsModel *App::GetFrequentLocationsModel()
 {
 	return &m_frequentLocationsModel;
@@ -580,8 +817,29 @@ void App::OnExitStarted()
 	// The application is going to exit, so the settings need to be saved before the shutdown
 	// begins.
 	m_saveSettingsTimer.cancel();
+	m_tabMemoryTimer.cancel();
+
+	// Closing the windows will generate change notifications (e.g. as each tab is removed). Those
+	// changes shouldn't be saved.
+	m_settingsChangeTracker.reset();
+
 	SaveSettings();
 
+	if (m_incrementalSettingsWriter && m_featureList.IsEnabled(Feature::BinarySnapshotStorage))
+	{
+		// The snapshot records the state of the config file, so it can only be committed once the
+		// config file has been written in the background. The data is captured here, while the
+		// windows are still open, and the snapshot is committed once the message loop has exited.
+		m_pendingSnapshotStorage = BinaryAppStorageFactory::MaybeCreate(
+			Storage::GetConfigSnapshotFilePath(), Storage::GetConfigFilePath(),
+			Storage::OperationType::Save);
+
+		if (m_pendingSnapshotStorage)
+		{
+			SaveSettingsToStorage(m_pendingSnapshotStorage.get(), GetWindowStorageData());
+		}
+	}
+
 	m_exitStarted = true;
 }
 
@@ -595,4 +853,10 @@ void App::SessionEnding()
 	}
 
 	SaveSettings();
+
+	// The session is ending, so the process may be terminated shortly after this returns.
+	if (m_incrementalSettingsWriter)
+	{
+		m_incrementalSettingsWriter->WaitForPendingWrites();
+	}
 }
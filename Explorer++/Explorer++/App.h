@@ -21,6 +21,7 @@
 #include "FrequentLocationsTracker.h"
 #include "HistoryModel.h"
 #include "HistoryTracker.h"
+#include "IncrementalSettingsWriter.h"
 #include "ModelessDialogList.h"
 #include "PlatformContextImpl.h"
 #include "ProcessManager.h"
@@ -30,7 +31,9 @@
 #include "ShellWatcherManager.h"
 #include "TabEvents.h"
 #include "TabList.h"
+#include "TabMemoryManager.h"
 #include "TabRestorer.h"
+#include "TaskScheduler.h"
 #include "ThemeManager.h"
 #include "../Helper/ClipboardWatcher.h"
 #include "../Helper/UniqueResources.h"
@@ -39,10 +42,16 @@
 #include <memory>
 #include <vector>
 
+class AppStorage;
 class AsyncIconFetcher;
+class BookmarkSearchIndex;
 class CachedIcons;
 class ColorRuleModel;
+class FolderListingCache;
+class FolderPrefetcher;
+class HistorySearchIndex;
 class ResourceLoader;
+class SettingsChangeTracker;
 struct WindowStorageData;
 
 class App : private boost::noncopyable
@@ -60,6 +69,7 @@ public:
 	void SetSavePreferencesToXmlFile(bool savePreferencesToXmlFile);
 	PlatformContext *GetPlatformContext();
 	Runtime *GetRuntime();
+	TaskScheduler *GetTaskScheduler();
 	ClipboardWatcher *GetClipboardWatcher();
 	FeatureList *GetFeatureList();
 	AcceleratorManager *GetAcceleratorManager();
@@ -67,9 +77,15 @@ public:
 	DirectoryWatcherFactory *GetDirectoryWatcherFactory();
 	CachedIcons *GetCachedIcons();
 	std::shared_ptr<AsyncIconFetcher> GetIconFetcher();
+	std::shared_ptr<FolderListingCache> GetFolderListingCache();
+	// Returns null if folder prefetching is disabled.
+	FolderPrefetcher *GetFolderPrefetcher();
 	BrowserList *GetBrowserList();
 	ModelessDialogList *GetModelessDialogList();
 	BookmarkTree *GetBookmarkTree();
+	// The index is built the first time this is called. After that, it's kept in sync with the
+	// bookmark tree.
+	BookmarkSearchIndex *GetBookmarkSearchIndex();
 	ColorRuleModel *GetColorRuleModel() const;
 	Applications::ApplicationModel *GetApplicationModel();
 	HINSTANCE GetResourceInstance() const;
@@ -83,6 +99,9 @@ public:
 	DarkModeColorProvider *GetDarkModeColorProvider();
 	ThemeManager *GetThemeManager();
 	HistoryModel *GetHistoryModel();
+	// The index is created the first time this is called. The names of the history items are then
+	// retrieved in the background.
+	HistorySearchIndex *GetHistorySearchIndex();
 	FrequentLocationsModel *GetFrequentLocationsModel();
 	DriveModel *GetDriveModel();
 
@@ -96,10 +115,22 @@ private:
 
 	static constexpr int MIN_COM_STA_THREADPOOL_SIZE = 5;
 
+	// The number of threads in the COM STA pool that won't be used by tasks queued via the
+	// TaskScheduler. That leaves threads available for other work (e.g. enumerating folders), even
+	// when there are a large number of scheduled tasks.
+	static constexpr int NUM_THREADS_RESERVED_FROM_TASK_SCHEDULER = 2;
+
+	static TaskScheduler::Executors GetTaskSchedulerExecutors(const Runtime &runtime);
+
 	void OnBrowserRemoved();
 	void SetUpSession();
 	void LoadSettings(std::vector<WindowStorageData> &windows);
 	void SaveSettings();
+	void SaveSettingsToStorage(AppStorage *appStorage,
+		const std::vector<WindowStorageData> &windows);
+	void SaveSettingsSection(AppStorage *appStorage, IncrementalSettingsWriter::Section section);
+	std::vector<WindowStorageData> GetWindowStorageData() const;
+	void UpdateIncrementalSettingsWriter();
 	void SetUpLanguageResourceInstance();
 	void RestoreSession(const std::vector<WindowStorageData> &windows);
 	void RestorePreviousWindows(const std::vector<WindowStorageData> &windows);
@@ -116,6 +147,7 @@ private:
 	bool m_savePreferencesToXmlFile = false;
 	PlatformContextImpl m_platformContext;
 	Runtime m_runtime;
+	TaskScheduler m_taskScheduler;
 	EventWindow m_eventWindow;
 	ClipboardWatcher m_clipboardWatcher;
 	FeatureList m_featureList;
@@ -128,9 +160,12 @@ private:
 	ThemeManager m_themeManager;
 	std::shared_ptr<CachedIcons> m_cachedIcons;
 	std::shared_ptr<AsyncIconFetcher> m_iconFetcher;
+	std::shared_ptr<FolderListingCache> m_folderListingCache;
+	std::unique_ptr<FolderPrefetcher> m_folderPrefetcher;
 	BrowserList m_browserList;
 	ModelessDialogList m_modelessDialogList;
 	BookmarkTree m_bookmarkTree;
+	std::unique_ptr<BookmarkSearchIndex> m_bookmarkSearchIndex;
 	std::unique_ptr<ColorRuleModel> m_colorRuleModel;
 	Applications::ApplicationModel m_applicationModel;
 	HINSTANCE m_resourceInstance;
@@ -141,9 +176,11 @@ private:
 	NavigationEvents m_navigationEvents;
 	TabList m_tabList;
 	TabRestorer m_tabRestorer;
+	TabMemoryManager m_tabMemoryManager;
 
 	HistoryModel m_historyModel;
 	HistoryTracker m_historyTracker;
+	std::unique_ptr<HistorySearchIndex> m_historySearchIndex;
 
 	FrequentLocationsModel m_frequentLocationsModel;
 	FrequentLocationsTracker m_frequentLocationsTracker;
@@ -152,6 +189,13 @@ private:
 	DriveModel m_driveModel;
 
 	concurrencpp::timer m_saveSettingsTimer;
+	concurrencpp::timer m_tabMemoryTimer;
+
+	// These are only used when the AsyncSettingsPersistence feature is enabled and settings are
+	// being saved to the config file.
+	std::unique_ptr<IncrementalSettingsWriter> m_incrementalSettingsWriter;
+	std::unique_ptr<SettingsChangeTracker> m_settingsChangeTracker;
+	std::unique_ptr<AppStorage> m_pendingSnapshotStorage;
 
 	unique_gdiplus_shutdown m_uniqueGdiplusShutdown;
 	wil::unique_hmodule m_richEditLib;
@@ -18,6 +18,7 @@ class ColorRuleModel;
 struct Config;
 struct FolderColumns;
 class FrequentLocationsModel;
+class HistoryModel;
 struct WindowStorageData;
 
 class AppStorage
@@ -33,6 +34,7 @@ public:
 	virtual void LoadDialogStates() = 0;
 	virtual void LoadDefaultColumns(FolderColumns &defaultColumns) = 0;
 	virtual void LoadFrequentLocations(FrequentLocationsModel *frequentLocationsModel) = 0;
+	virtual void LoadHistory(HistoryModel *historyModel) = 0;
 
 	virtual void SaveConfig(const Config &config) = 0;
 	virtual void SaveWindows(const std::vector<WindowStorageData> &windows) = 0;
@@ -42,5 +44,6 @@ public:
 	virtual void SaveDialogStates() = 0;
 	virtual void SaveDefaultColumns(const FolderColumns &defaultColumns) = 0;
 	virtual void SaveFrequentLocations(const FrequentLocationsModel *frequentLocationsModel) = 0;
+	virtual void SaveHistory(const HistoryModel *historyModel) = 0;
 	virtual void Commit() = 0;
 };
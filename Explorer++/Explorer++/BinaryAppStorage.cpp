@@ -0,0 +1,898 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "BinaryAppStorage.h"
+#include "FrequentLocationsModel.h"
+#include "FrequentLocationsStorageHelper.h"
+#include "HistoryModel.h"
+#include "LocationVisitInfo.h"
+#include "MainRebarStorage.h"
+#include "Tab.h"
+#include "TabStorage.h"
+#include "WindowStorage.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "../Helper/MemoryStreamBuf.h"
+#include "../Helper/StringHelper.h"
+#include <cereal/archives/binary.hpp>
+#include <filesystem>
+#include <istream>
+#include <sstream>
+
+namespace
+{
+
+using InputArchive = cereal::BinaryInputArchive;
+using OutputArchive = cereal::BinaryOutputArchive;
+
+// Each section is stored as its identifier, followed by its size, followed by its contents.
+constexpr size_t SECTION_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+
+// Thrown when a value read from a section is out of range. This is treated in the same way as any
+// other error raised while reading an archive.
+[[noreturn]] void ThrowInvalidData()
+{
+	throw cereal::Exception("Invalid snapshot data");
+}
+
+template <typename T>
+void WriteOptional(OutputArchive &archive, const std::optional<T> &value)
+{
+	archive(value.has_value());
+
+	if (value)
+	{
+		archive(*value);
+	}
+}
+
+template <typename T>
+std::optional<T> ReadOptional(InputArchive &archive)
+{
+	bool hasValue;
+	archive(hasValue);
+
+	if (!hasValue)
+	{
+		return std::nullopt;
+	}
+
+	T value;
+	archive(value);
+	return value;
+}
+
+template <typename T>
+void WriteBetterEnum(OutputArchive &archive, T value)
+{
+	archive(value._to_integral());
+}
+
+template <typename T>
+T ReadBetterEnum(InputArchive &archive)
+{
+	typename T::_integral integral;
+	archive(integral);
+
+	auto value = T::_from_integral_nothrow(integral);
+
+	if (!value)
+	{
+		ThrowInvalidData();
+	}
+
+	return *value;
+}
+
+uint64_t ReadCount(InputArchive &archive)
+{
+	uint64_t count;
+	archive(count);
+	return count;
+}
+
+void WritePidl(OutputArchive &archive, const PidlAbsolute &pidl)
+{
+	std::string bytes;
+
+	if (pidl.HasValue())
+	{
+		bytes.assign(reinterpret_cast<const char *>(pidl.Raw()), ILGetSize(pidl.Raw()));
+	}
+
+	archive(bytes);
+}
+
+PidlAbsolute ReadPidl(InputArchive &archive)
+{
+	std::string bytes;
+	archive(bytes);
+
+	if (bytes.empty())
+	{
+		return {};
+	}
+
+	return CreatePidlFromBytes(bytes.data(), bytes.size());
+}
+
+void WriteFileTime(OutputArchive &archive, const FILETIME &fileTime)
+{
+	archive(static_cast<uint32_t>(fileTime.dwLowDateTime),
+		static_cast<uint32_t>(fileTime.dwHighDateTime));
+}
+
+FILETIME ReadFileTime(InputArchive &archive)
+{
+	uint32_t lowDateTime;
+	uint32_t highDateTime;
+	archive(lowDateTime, highDateTime);
+	return { .dwLowDateTime = lowDateTime, .dwHighDateTime = highDateTime };
+}
+
+void WriteColumns(OutputArchive &archive, const std::vector<Column_t> &columns)
+{
+	archive(static_cast<uint64_t>(columns.size()));
+
+	for (const auto &column : columns)
+	{
+		WriteBetterEnum(archive, column.type);
+		archive(column.checked != FALSE, static_cast<int32_t>(column.width));
+	}
+}
+
+std::vector<Column_t> ReadColumns(InputArchive &archive)
+{
+	std::vector<Column_t> columns;
+	auto count = ReadCount(archive);
+
+	for (uint64_t i = 0; i < count; i++)
+	{
+		auto type = ReadBetterEnum<ColumnType>(archive);
+
+		bool checked;
+		int32_t width;
+		archive(checked, width);
+
+		columns.push_back({ type, checked, width });
+	}
+
+	return columns;
+}
+
+void WriteFolderColumns(OutputArchive &archive, const FolderColumns &folderColumns)
+{
+	WriteColumns(archive, folderColumns.realFolderColumns);
+	WriteColumns(archive, folderColumns.myComputerColumns);
+	WriteColumns(archive, folderColumns.controlPanelColumns);
+	WriteColumns(archive, folderColumns.recycleBinColumns);
+	WriteColumns(archive, folderColumns.printersColumns);
+	WriteColumns(archive, folderColumns.networkConnectionsColumns);
+	WriteColumns(archive, folderColumns.myNetworkPlacesColumns);
+}
+
+FolderColumns ReadFolderColumns(InputArchive &archive)
+{
+	FolderColumns folderColumns;
+	folderColumns.realFolderColumns = ReadColumns(archive);
+	folderColumns.myComputerColumns = ReadColumns(archive);
+	folderColumns.controlPanelColumns = ReadColumns(archive);
+	folderColumns.recycleBinColumns = ReadColumns(archive);
+	folderColumns.printersColumns = ReadColumns(archive);
+	folderColumns.networkConnectionsColumns = ReadColumns(archive);
+	folderColumns.myNetworkPlacesColumns = ReadColumns(archive);
+	return folderColumns;
+}
+
+void WriteTab(OutputArchive &archive, const TabStorageData &tab)
+{
+	WritePidl(archive, tab.pidl);
+	archive(tab.directory);
+
+	WriteOptional(archive, tab.tabSettings.name);
+	WriteOptional(archive,
+		tab.tabSettings.lockState
+			? std::make_optional(static_cast<int32_t>(*tab.tabSettings.lockState))
+			: std::nullopt);
+	WriteOptional(archive,
+		tab.tabSettings.index ? std::make_optional(static_cast<int32_t>(*tab.tabSettings.index))
+							  : std::nullopt);
+	WriteOptional(archive, tab.tabSettings.selected);
+
+	const auto &folderSettings = tab.folderSettings;
+	WriteBetterEnum(archive, folderSettings.sortMode);
+	WriteBetterEnum(archive, folderSettings.groupMode);
+	WriteBetterEnum(archive, folderSettings.viewMode);
+	archive(folderSettings.autoArrangeEnabled);
+	WriteBetterEnum(archive, folderSettings.sortDirection);
+	WriteBetterEnum(archive, folderSettings.groupSortDirection);
+	archive(folderSettings.showInGroups, folderSettings.showHidden, folderSettings.filterEnabled,
+		folderSettings.filterCaseSensitive, folderSettings.filter);
+
+	WriteFolderColumns(archive, tab.columns);
+}
+
+TabStorageData ReadTab(InputArchive &archive)
+{
+	TabStorageData tab;
+	tab.pidl = ReadPidl(archive);
+	archive(tab.directory);
+
+	tab.tabSettings.name = ReadOptional<std::wstring>(archive);
+
+	if (auto lockState = ReadOptional<int32_t>(archive))
+	{
+		if (*lockState < static_cast<int32_t>(Tab::LockState::NotLocked)
+			|| *lockState > static_cast<int32_t>(Tab::LockState::AddressLocked))
+		{
+			ThrowInvalidData();
+		}
+
+		tab.tabSettings.lockState = static_cast<Tab::LockState>(*lockState);
+	}
+
+	tab.tabSettings.index = ReadOptional<int32_t>(archive);
+	tab.tabSettings.selected = ReadOptional<bool>(archive);
+
+	auto &folderSettings = tab.folderSettings;
+	folderSettings.sortMode = ReadBetterEnum<SortMode>(archive);
+	folderSettings.groupMode = ReadBetterEnum<SortMode>(archive);
+	folderSettings.viewMode = ReadBetterEnum<ViewMode>(archive);
+	archive(folderSettings.autoArrangeEnabled);
+	folderSettings.sortDirection = ReadBetterEnum<SortDirection>(archive);
+	folderSettings.groupSortDirection = ReadBetterEnum<SortDirection>(archive);
+	archive(folderSettings.showInGroups, folderSettings.showHidden, folderSettings.filterEnabled,
+		folderSettings.filterCaseSensitive, folderSettings.filter);
+
+	tab.columns = ReadFolderColumns(archive);
+
+	return tab;
+}
+
+void WriteWindow(OutputArchive &archive, const WindowStorageData &window)
+{
+	archive(static_cast<int32_t>(window.bounds.left), static_cast<int32_t>(window.bounds.top),
+		static_cast<int32_t>(window.bounds.right), static_cast<int32_t>(window.bounds.bottom));
+	WriteBetterEnum(archive, window.showState);
+
+	archive(static_cast<uint64_t>(window.tabs.size()));
+
+	for (const auto &tab : window.tabs)
+	{
+		WriteTab(archive, tab);
+	}
+
+	archive(static_cast<int32_t>(window.selectedTab));
+
+	archive(static_cast<uint64_t>(window.mainRebarInfo.size()));
+
+	for (const auto &rebarInfo : window.mainRebarInfo)
+	{
+		archive(static_cast<uint32_t>(rebarInfo.id), static_cast<uint32_t>(rebarInfo.style),
+			static_cast<uint32_t>(rebarInfo.length));
+	}
+
+	archive(window.mainToolbarButtons.has_value());
+
+	if (window.mainToolbarButtons)
+	{
+		const auto &buttons = window.mainToolbarButtons->GetButtons();
+		archive(static_cast<uint64_t>(buttons.size()));
+
+		for (auto button : buttons)
+		{
+			WriteBetterEnum(archive, button);
+		}
+	}
+
+	archive(static_cast<int32_t>(window.treeViewWidth),
+		static_cast<int32_t>(window.displayWindowWidth),
+		static_cast<int32_t>(window.displayWindowHeight));
+}
+
+WindowStorageData ReadWindow(InputArchive &archive)
+{
+	WindowStorageData window;
+
+	int32_t left;
+	int32_t top;
+	int32_t right;
+	int32_t bottom;
+	archive(left, top, right, bottom);
+	window.bounds = { left, top, right, bottom };
+
+	window.showState = ReadBetterEnum<WindowShowState>(archive);
+
+	auto numTabs = ReadCount(archive);
+
+	for (uint64_t i = 0; i < numTabs; i++)
+	{
+		window.tabs.push_back(ReadTab(archive));
+	}
+
+	int32_t selectedTab;
+	archive(selectedTab);
+	window.selectedTab = selectedTab;
+
+	auto numRebarBands = ReadCount(archive);
+
+	for (uint64_t i = 0; i < numRebarBands; i++)
+	{
+		uint32_t id;
+		uint32_t style;
+		uint32_t length;
+		archive(id, style, length);
+		window.mainRebarInfo.push_back({ id, style, length });
+	}
+
+	bool hasMainToolbarButtons;
+	archive(hasMainToolbarButtons);
+
+	if (hasMainToolbarButtons)
+	{
+		MainToolbarStorage::MainToolbarButtons buttons;
+		auto numButtons = ReadCount(archive);
+
+		for (uint64_t i = 0; i < numButtons; i++)
+		{
+			buttons.AddButton(ReadBetterEnum<MainToolbarButton>(archive));
+		}
+
+		window.mainToolbarButtons = buttons;
+	}
+
+	int32_t treeViewWidth;
+	int32_t displayWindowWidth;
+	int32_t displayWindowHeight;
+	archive(treeViewWidth, displayWindowWidth, displayWindowHeight);
+	window.treeViewWidth = treeViewWidth;
+	window.displayWindowWidth = displayWindowWidth;
+	window.displayWindowHeight = displayWindowHeight;
+
+	return window;
+}
+
+void WriteBookmarkChildren(OutputArchive &archive, const BookmarkItem *parentBookmarkItem)
+{
+	const auto &children = parentBookmarkItem->GetChildren();
+	archive(static_cast<uint64_t>(children.size()));
+
+	for (const auto &child : children)
+	{
+		archive(child->IsFolder(), child->GetGUID(), child->GetName());
+
+		if (child->IsBookmark())
+		{
+			archive(child->GetLocation());
+		}
+
+		WriteFileTime(archive, child->GetDateCreated());
+		WriteFileTime(archive, child->GetDateModified());
+
+		if (child->IsFolder())
+		{
+			WriteBookmarkChildren(archive, child.get());
+		}
+	}
+}
+
+BookmarkItems ReadBookmarkChildren(InputArchive &archive)
+{
+	BookmarkItems children;
+	auto count = ReadCount(archive);
+
+	for (uint64_t i = 0; i < count; i++)
+	{
+		bool isFolder;
+		std::wstring guid;
+		std::wstring name;
+		archive(isFolder, guid, name);
+
+		std::optional<std::wstring> location;
+
+		if (!isFolder)
+		{
+			location.emplace();
+			archive(*location);
+		}
+
+		auto bookmarkItem = std::make_unique<BookmarkItem>(guid, name, location);
+		auto dateCreated = ReadFileTime(archive);
+		auto dateModified = ReadFileTime(archive);
+
+		if (isFolder)
+		{
+			for (auto &child : ReadBookmarkChildren(archive))
+			{
+				bookmarkItem->AddChild(std::move(child));
+			}
+		}
+
+		// Adding a child updates the modification date of the parent, so the dates are only set
+		// once the children have been added.
+		bookmarkItem->SetDateCreated(dateCreated);
+		bookmarkItem->SetDateModified(dateModified);
+
+		children.push_back(std::move(bookmarkItem));
+	}
+
+	return children;
+}
+
+void WritePermanentFolder(OutputArchive &archive, const BookmarkItem *bookmarkItem)
+{
+	WriteFileTime(archive, bookmarkItem->GetDateCreated());
+	WriteFileTime(archive, bookmarkItem->GetDateModified());
+	WriteBookmarkChildren(archive, bookmarkItem);
+}
+
+struct PermanentFolderData
+{
+	FILETIME dateCreated;
+	FILETIME dateModified;
+	BookmarkItems children;
+};
+
+PermanentFolderData ReadPermanentFolder(InputArchive &archive)
+{
+	PermanentFolderData data;
+	data.dateCreated = ReadFileTime(archive);
+	data.dateModified = ReadFileTime(archive);
+	data.children = ReadBookmarkChildren(archive);
+	return data;
+}
+
+void AddPermanentFolderToTree(PermanentFolderData &&data, BookmarkTree *bookmarkTree,
+	BookmarkItem *bookmarkItem)
+{
+	bookmarkTree->AddBookmarkItems(bookmarkItem, std::move(data.children));
+	bookmarkItem->SetDateCreated(data.dateCreated);
+	bookmarkItem->SetDateModified(data.dateModified);
+}
+
+struct ConfigFileStamp
+{
+	int64_t lastWriteTime;
+	uint64_t size;
+
+	bool operator==(const ConfigFileStamp &) const = default;
+};
+
+std::optional<ConfigFileStamp> MaybeGetConfigFileStamp(const std::wstring &configFilePath)
+{
+	std::error_code error;
+	auto lastWriteTime = std::filesystem::last_write_time(configFilePath, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	auto size = std::filesystem::file_size(configFilePath, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	return ConfigFileStamp{ static_cast<int64_t>(lastWriteTime.time_since_epoch().count()),
+		static_cast<uint64_t>(size) };
+}
+
+template <typename Function>
+std::string WriteSection(Function &&function)
+{
+	std::ostringstream stream;
+
+	{
+		OutputArchive archive(stream);
+		function(archive);
+	}
+
+	return std::move(stream).str();
+}
+
+// Returns false if the section couldn't be read in its entirety.
+template <typename Function>
+bool ReadSection(std::string_view section, Function &&function)
+{
+	MemoryStreamBuf streamBuf(section);
+	std::istream stream(&streamBuf);
+
+	try
+	{
+		InputArchive archive(stream);
+		function(archive);
+	}
+	catch (const cereal::Exception &)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+BinaryAppStorage::BinaryAppStorage(std::unique_ptr<SnapshotFile::MappedSnapshot> snapshot,
+	Sections sections, wil::com_ptr_nothrow<IXMLDOMDocument> xmlDocument,
+	wil::com_ptr_nothrow<IXMLDOMNode> rootNode, const std::wstring &snapshotFilePath,
+	const std::wstring &configFilePath, Storage::OperationType operationType) :
+	m_snapshot(std::move(snapshot)),
+	m_sections(std::move(sections)),
+	m_xmlDocument(xmlDocument),
+	m_xmlAppStorage(xmlDocument, rootNode, configFilePath, operationType),
+	m_snapshotFilePath(snapshotFilePath),
+	m_configFilePath(configFilePath),
+	m_operationType(operationType)
+{
+}
+
+std::optional<BinaryAppStorage::Sections> BinaryAppStorage::MaybeParseSections(
+	std::string_view payload)
+{
+	Sections sections;
+
+	while (!payload.empty())
+	{
+		if (payload.size() < SECTION_HEADER_SIZE)
+		{
+			return std::nullopt;
+		}
+
+		uint32_t id;
+		uint64_t size;
+		std::memcpy(&id, payload.data(), sizeof(id));
+		std::memcpy(&size, payload.data() + sizeof(id), sizeof(size));
+		payload.remove_prefix(SECTION_HEADER_SIZE);
+
+		if (size > payload.size())
+		{
+			return std::nullopt;
+		}
+
+		// Sections with an unknown identifier are retained, but will never be looked up.
+		sections[static_cast<SectionId>(id)] = payload.substr(0, static_cast<size_t>(size));
+		payload.remove_prefix(static_cast<size_t>(size));
+	}
+
+	return sections;
+}
+
+bool BinaryAppStorage::IsSnapshotCurrent(const Sections &sections,
+	const std::wstring &configFilePath)
+{
+	auto itr = sections.find(SectionId::ConfigFileStamp);
+
+	if (itr == sections.end())
+	{
+		return false;
+	}
+
+	ConfigFileStamp savedStamp;
+	bool res = ReadSection(itr->second,
+		[&savedStamp](InputArchive &archive)
+		{ archive(savedStamp.lastWriteTime, savedStamp.size); });
+
+	if (!res)
+	{
+		return false;
+	}
+
+	auto currentStamp = MaybeGetConfigFileStamp(configFilePath);
+	return currentStamp && *currentStamp == savedStamp;
+}
+
+void BinaryAppStorage::LoadConfig(Config &config)
+{
+	m_xmlAppStorage.LoadConfig(config);
+}
+
+std::vector<WindowStorageData> BinaryAppStorage::LoadWindows()
+{
+	auto section = MaybeGetSection(SectionId::Windows);
+
+	if (!section)
+	{
+		return {};
+	}
+
+	std::vector<WindowStorageData> windows;
+	bool res = ReadSection(*section,
+		[&windows](InputArchive &archive)
+		{
+			auto numWindows = ReadCount(archive);
+
+			for (uint64_t i = 0; i < numWindows; i++)
+			{
+				windows.push_back(ReadWindow(archive));
+			}
+		});
+
+	if (!res)
+	{
+		return {};
+	}
+
+	return windows;
+}
+
+void BinaryAppStorage::LoadBookmarks(BookmarkTree *bookmarkTree)
+{
+	auto section = MaybeGetSection(SectionId::Bookmarks);
+
+	if (!section)
+	{
+		return;
+	}
+
+	// The bookmarks are fully read before any of them are added to the tree, so that nothing is
+	// added if the section is invalid.
+	PermanentFolderData bookmarksToolbar;
+	PermanentFolderData bookmarksMenu;
+	PermanentFolderData otherBookmarks;
+	bool res = ReadSection(*section,
+		[&](InputArchive &archive)
+		{
+			bookmarksToolbar = ReadPermanentFolder(archive);
+			bookmarksMenu = ReadPermanentFolder(archive);
+			otherBookmarks = ReadPermanentFolder(archive);
+		});
+
+	if (!res)
+	{
+		return;
+	}
+
+	AddPermanentFolderToTree(std::move(bookmarksToolbar), bookmarkTree,
+		bookmarkTree->GetBookmarksToolbarFolder());
+	AddPermanentFolderToTree(std::move(bookmarksMenu), bookmarkTree,
+		bookmarkTree->GetBookmarksMenuFolder());
+	AddPermanentFolderToTree(std::move(otherBookmarks), bookmarkTree,
+		bookmarkTree->GetOtherBookmarksFolder());
+}
+
+void BinaryAppStorage::LoadColorRules(ColorRuleModel *model)
+{
+	m_xmlAppStorage.LoadColorRules(model);
+}
+
+void BinaryAppStorage::LoadApplications(Applications::ApplicationModel *model)
+{
+	m_xmlAppStorage.LoadApplications(model);
+}
+
+void BinaryAppStorage::LoadDialogStates()
+{
+	m_xmlAppStorage.LoadDialogStates();
+}
+
+void BinaryAppStorage::LoadDefaultColumns(FolderColumns &defaultColumns)
+{
+	m_xmlAppStorage.LoadDefaultColumns(defaultColumns);
+}
+
+void BinaryAppStorage::LoadFrequentLocations(FrequentLocationsModel *frequentLocationsModel)
+{
+	auto section = MaybeGetSection(SectionId::FrequentLocations);
+
+	if (!section)
+	{
+		return;
+	}
+
+	std::vector<LocationVisitInfo> frequentLocations;
+	bool res = ReadSection(*section,
+		[&frequentLocations](InputArchive &archive)
+		{
+			auto count = ReadCount(archive);
+
+			for (uint64_t i = 0; i < count; i++)
+			{
+				auto pidl = ReadPidl(archive);
+
+				int32_t numVisits;
+				FrequentLocationsStorageHelper::StorageDurationType::rep timeSinceEpoch;
+				double frecencyKey;
+				archive(numVisits, timeSinceEpoch, frecencyKey);
+
+				if (!pidl.HasValue())
+				{
+					continue;
+				}
+
+				frequentLocations.emplace_back(pidl, numVisits,
+					SystemClock::TimePoint(
+						FrequentLocationsStorageHelper::StorageDurationType(timeSinceEpoch)),
+					frecencyKey);
+			}
+		});
+
+	if (!res)
+	{
+		return;
+	}
+
+	frequentLocationsModel->SetLocationVisits(frequentLocations);
+}
+
+void BinaryAppStorage::LoadHistory(HistoryModel *historyModel)
+{
+	auto section = MaybeGetSection(SectionId::History);
+
+	if (!section)
+	{
+		return;
+	}
+
+	std::vector<PidlAbsolute> historyItems;
+	bool res = ReadSection(*section,
+		[&historyItems](InputArchive &archive)
+		{
+			auto count = ReadCount(archive);
+
+			for (uint64_t i = 0; i < count; i++)
+			{
+				auto pidl = ReadPidl(archive);
+
+				if (!pidl.HasValue())
+				{
+					continue;
+				}
+
+				historyItems.push_back(std::move(pidl));
+			}
+		});
+
+	if (!res)
+	{
+		return;
+	}
+
+	historyModel->SetHistoryItems(historyItems);
+}
+
+void BinaryAppStorage::SaveConfig(const Config &config)
+{
+	m_xmlAppStorage.SaveConfig(config);
+}
+
+void BinaryAppStorage::SaveWindows(const std::vector<WindowStorageData> &windows)
+{
+	m_outputSections[SectionId::Windows] = WriteSection(
+		[&windows](OutputArchive &archive)
+		{
+			archive(static_cast<uint64_t>(windows.size()));
+
+			for (const auto &window : windows)
+			{
+				WriteWindow(archive, window);
+			}
+		});
+}
+
+void BinaryAppStorage::SaveBookmarks(const BookmarkTree *bookmarkTree)
+{
+	m_outputSections[SectionId::Bookmarks] = WriteSection(
+		[bookmarkTree](OutputArchive &archive)
+		{
+			WritePermanentFolder(archive, bookmarkTree->GetBookmarksToolbarFolder());
+			WritePermanentFolder(archive, bookmarkTree->GetBookmarksMenuFolder());
+			WritePermanentFolder(archive, bookmarkTree->GetOtherBookmarksFolder());
+		});
+}
+
+void BinaryAppStorage::SaveColorRules(const ColorRuleModel *model)
+{
+	m_xmlAppStorage.SaveColorRules(model);
+}
+
+void BinaryAppStorage::SaveApplications(const Applications::ApplicationModel *model)
+{
+	m_xmlAppStorage.SaveApplications(model);
+}
+
+void BinaryAppStorage::SaveDialogStates()
+{
+	m_xmlAppStorage.SaveDialogStates();
+}
+
+void BinaryAppStorage::SaveDefaultColumns(const FolderColumns &defaultColumns)
+{
+	m_xmlAppStorage.SaveDefaultColumns(defaultColumns);
+}
+
+void BinaryAppStorage::SaveFrequentLocations(const FrequentLocationsModel *frequentLocationsModel)
+{
+	m_outputSections[SectionId::FrequentLocations] = WriteSection(
+		[frequentLocationsModel](OutputArchive &archive)
+		{
+			auto visits = frequentLocationsModel->GetVisits()
+				| std::views::take(FrequentLocationsStorageHelper::MAX_ITEMS_TO_STORE);
+			archive(static_cast<uint64_t>(std::ranges::distance(visits)));
+
+			for (const auto &visit : visits)
+			{
+				WritePidl(archive, visit.GetLocation());
+				archive(static_cast<int32_t>(visit.GetNumVisits()),
+					std::chrono::duration_cast<FrequentLocationsStorageHelper::StorageDurationType>(
+						visit.GetLastVisitTime().time_since_epoch())
+						.count(),
+					visit.GetFrecencyKey());
+			}
+		});
+}
+
+void BinaryAppStorage::SaveHistory(const HistoryModel *historyModel)
+{
+	m_outputSections[SectionId::History] = WriteSection(
+		[historyModel](OutputArchive &archive)
+		{
+			const auto &historyItems = historyModel->GetHistoryItems();
+			archive(static_cast<uint64_t>(historyItems.size()));
+
+			for (const auto &pidl : historyItems)
+			{
+				WritePidl(archive, pidl);
+			}
+		});
+}
+
+void BinaryAppStorage::Commit()
+{
+	if (m_operationType != Storage::OperationType::Save)
+	{
+		DCHECK(false);
+		return;
+	}
+
+	// Without a stamp, the snapshot would never be considered current, so there's no point in
+	// writing it.
+	auto configFileStamp = MaybeGetConfigFileStamp(m_configFilePath);
+
+	if (!configFileStamp)
+	{
+		return;
+	}
+
+	m_outputSections[SectionId::ConfigFileStamp] =
+		WriteSection([&configFileStamp](OutputArchive &archive)
+			{ archive(configFileStamp->lastWriteTime, configFileStamp->size); });
+
+	wil::unique_bstr xml;
+	HRESULT hr = m_xmlDocument->get_xml(&xml);
+
+	if (FAILED(hr))
+	{
+		DCHECK(false);
+		return;
+	}
+
+	m_outputSections[SectionId::Xml] = wstrToUtf8Str(xml.get());
+
+	std::string payload;
+
+	for (const auto &[id, data] : m_outputSections)
+	{
+		auto rawId = static_cast<uint32_t>(id);
+		auto size = static_cast<uint64_t>(data.size());
+		payload.append(reinterpret_cast<const char *>(&rawId), sizeof(rawId));
+		payload.append(reinterpret_cast<const char *>(&size), sizeof(size));
+		payload += data;
+	}
+
+	SnapshotFile::Write(m_snapshotFilePath, SNAPSHOT_VERSION, payload);
+}
+
+std::optional<std::string_view> BinaryAppStorage::MaybeGetSection(SectionId sectionId) const
+{
+	auto itr = m_sections.find(sectionId);
+
+	if (itr == m_sections.end())
+	{
+		return std::nullopt;
+	}
+
+	return itr->second;
+}
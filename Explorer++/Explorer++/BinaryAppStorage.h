@@ -0,0 +1,100 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "AppStorage.h"
+#include "Storage.h"
+#include "XmlAppStorage.h"
+#include "../Helper/SnapshotFile.h"
+#include <wil/com.h>
+#include <MsXml2.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Stores settings in a binary snapshot file, which is considerably faster to load than the XML
+// config file. The snapshot is only a cache of the config file; it records the timestamp and size
+// of the config file it was saved alongside and is ignored if the config file has changed since
+// then. That way, the config file remains the canonical copy of the settings and can still be
+// edited by hand.
+//
+// The windows (including all their tabs), bookmarks, frequent locations and history are serialized
+// directly.
+// The remaining settings are small and are stored as an embedded XML document, using the same
+// format as the config file.
+class BinaryAppStorage : public AppStorage
+{
+public:
+	// This should be incremented whenever the format of any section changes. Snapshots with a
+	// different version will be ignored.
+	static constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+	// These values are written to the snapshot file and shouldn't be changed.
+	enum class SectionId : uint32_t
+	{
+		ConfigFileStamp = 1,
+		Xml = 2,
+		Windows = 3,
+		Bookmarks = 4,
+		FrequentLocations = 5,
+		History = 6
+	};
+
+	using Sections = std::map<SectionId, std::string_view>;
+
+	BinaryAppStorage(std::unique_ptr<SnapshotFile::MappedSnapshot> snapshot, Sections sections,
+		wil::com_ptr_nothrow<IXMLDOMDocument> xmlDocument,
+		wil::com_ptr_nothrow<IXMLDOMNode> rootNode, const std::wstring &snapshotFilePath,
+		const std::wstring &configFilePath, Storage::OperationType operationType);
+
+	// Splits a snapshot payload into its individual sections. Returns nothing if the payload is
+	// malformed.
+	static std::optional<Sections> MaybeParseSections(std::string_view payload);
+
+	// Returns true if the config file is unchanged since the snapshot was saved.
+	static bool IsSnapshotCurrent(const Sections &sections, const std::wstring &configFilePath);
+
+	void LoadConfig(Config &config) override;
+	[[nodiscard]] std::vector<WindowStorageData> LoadWindows() override;
+	void LoadBookmarks(BookmarkTree *bookmarkTree) override;
+	void LoadColorRules(ColorRuleModel *model) override;
+	void LoadApplications(Applications::ApplicationModel *model) override;
+	void LoadDialogStates() override;
+	void LoadDefaultColumns(FolderColumns &defaultColumns) override;
+	void LoadFrequentLocations(FrequentLocationsModel *frequentLocationsModel) override;
+	void LoadHistory(HistoryModel *historyModel) override;
+
+	void SaveConfig(const Config &config) override;
+	void SaveWindows(const std::vector<WindowStorageData> &windows) override;
+	void SaveBookmarks(const BookmarkTree *bookmarkTree) override;
+	void SaveColorRules(const ColorRuleModel *model) override;
+	void SaveApplications(const Applications::ApplicationModel *model) override;
+	void SaveDialogStates() override;
+	void SaveDefaultColumns(const FolderColumns &defaultColumns) override;
+	void SaveFrequentLocations(const FrequentLocationsModel *frequentLocationsModel) override;
+	void SaveHistory(const HistoryModel *historyModel) override;
+
+	// Note that this should only be called once the config file itself has been saved, since the
+	// current state of that file is recorded in the snapshot.
+	void Commit() override;
+
+private:
+	std::optional<std::string_view> MaybeGetSection(SectionId sectionId) const;
+
+	// Keeps the mapped view (which the section data points into) alive.
+	const std::unique_ptr<SnapshotFile::MappedSnapshot> m_snapshot;
+	const Sections m_sections;
+
+	const wil::com_ptr_nothrow<IXMLDOMDocument> m_xmlDocument;
+	XmlAppStorage m_xmlAppStorage;
+	const std::wstring m_snapshotFilePath;
+	const std::wstring m_configFilePath;
+	const Storage::OperationType m_operationType;
+
+	std::map<SectionId, std::string> m_outputSections;
+};
@@ -0,0 +1,103 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "BinaryAppStorageFactory.h"
+#include "BinaryAppStorage.h"
+#include "../Helper/SnapshotFile.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/XMLSettings.h"
+
+std::unique_ptr<AppStorage> BinaryAppStorageFactory::MaybeCreate(
+	const std::wstring &snapshotFilePath, const std::wstring &configFilePath,
+	Storage::OperationType operationType)
+{
+	if (operationType == Storage::OperationType::Load)
+	{
+		return BuildForLoad(snapshotFilePath, configFilePath);
+	}
+	else
+	{
+		return BuildForSave(snapshotFilePath, configFilePath);
+	}
+}
+
+std::unique_ptr<AppStorage> BinaryAppStorageFactory::BuildForLoad(
+	const std::wstring &snapshotFilePath, const std::wstring &configFilePath)
+{
+	auto snapshot = SnapshotFile::MappedSnapshot::MaybeOpen(snapshotFilePath,
+		BinaryAppStorage::SNAPSHOT_VERSION);
+
+	if (!snapshot)
+	{
+		return nullptr;
+	}
+
+	auto sections = BinaryAppStorage::MaybeParseSections(snapshot->GetPayload());
+
+	if (!sections || !BinaryAppStorage::IsSnapshotCurrent(*sections, configFilePath))
+	{
+		return nullptr;
+	}
+
+	auto xmlSection = sections->find(BinaryAppStorage::SectionId::Xml);
+
+	if (xmlSection == sections->end())
+	{
+		return nullptr;
+	}
+
+	auto xmlDocument = XMLSettings::CreateXmlDocument();
+
+	if (!xmlDocument)
+	{
+		return nullptr;
+	}
+
+	auto xml = wil::make_bstr_failfast(utf8StrToWstr(std::string(xmlSection->second)).c_str());
+	VARIANT_BOOL status;
+	xmlDocument->loadXML(xml.get(), &status);
+
+	if (status != VARIANT_TRUE)
+	{
+		return nullptr;
+	}
+
+	wil::com_ptr_nothrow<IXMLDOMNode> rootNode;
+	auto query = wil::make_bstr_failfast(Storage::CONFIG_FILE_ROOT_NODE_NAME);
+	HRESULT hr = xmlDocument->selectSingleNode(query.get(), &rootNode);
+
+	if (hr != S_OK)
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<BinaryAppStorage>(std::move(snapshot), std::move(*sections),
+		xmlDocument, rootNode, snapshotFilePath, configFilePath, Storage::OperationType::Load);
+}
+
+std::unique_ptr<AppStorage> BinaryAppStorageFactory::BuildForSave(
+	const std::wstring &snapshotFilePath, const std::wstring &configFilePath)
+{
+	auto xmlDocument = XMLSettings::CreateXmlDocument();
+
+	if (!xmlDocument)
+	{
+		return nullptr;
+	}
+
+	auto rootTag = wil::make_bstr_nothrow(Storage::CONFIG_FILE_ROOT_NODE_NAME);
+	wil::com_ptr_nothrow<IXMLDOMElement> rootNode;
+	HRESULT hr = xmlDocument->createElement(rootTag.get(), &rootNode);
+
+	if (hr != S_OK)
+	{
+		return nullptr;
+	}
+
+	XMLSettings::AppendChildToParent(rootNode.get(), xmlDocument.get());
+
+	return std::make_unique<BinaryAppStorage>(nullptr, BinaryAppStorage::Sections{},
+		xmlDocument, rootNode, snapshotFilePath, configFilePath, Storage::OperationType::Save);
+}
@@ -0,0 +1,26 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Storage.h"
+#include <memory>
+#include <string>
+
+class AppStorage;
+
+class BinaryAppStorageFactory
+{
+public:
+	// When loading, this will only succeed if the snapshot is valid and was saved alongside the
+	// current version of the config file.
+	static std::unique_ptr<AppStorage> MaybeCreate(const std::wstring &snapshotFilePath,
+		const std::wstring &configFilePath, Storage::OperationType operationType);
+
+private:
+	static std::unique_ptr<AppStorage> BuildForLoad(const std::wstring &snapshotFilePath,
+		const std::wstring &configFilePath);
+	static std::unique_ptr<AppStorage> BuildForSave(const std::wstring &snapshotFilePath,
+		const std::wstring &configFilePath);
+};
@@ -0,0 +1,814 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Bookmarks/BookmarkImporter.h"
+#include "../Helper/StringHelper.h"
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+// The number of 100-nanosecond intervals between the FILETIME epoch (1601-01-01) and the Unix
+// epoch (1970-01-01).
+constexpr uint64_t UNIX_EPOCH_OFFSET = 116444736000000000;
+
+constexpr uint64_t INTERVALS_PER_SECOND = 10'000'000;
+constexpr uint64_t INTERVALS_PER_MICROSECOND = 10;
+
+std::optional<uint64_t> ParseUint64(std::string_view text)
+{
+	uint64_t value;
+	auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+	if (ec != std::errc() || ptr != text.data() + text.size())
+	{
+		return std::nullopt;
+	}
+
+	return value;
+}
+
+FILETIME Uint64ToFileTime(uint64_t value)
+{
+	FILETIME fileTime;
+	fileTime.dwLowDateTime = static_cast<DWORD>(value & 0xFFFFFFFF);
+	fileTime.dwHighDateTime = static_cast<DWORD>(value >> 32);
+	return fileTime;
+}
+
+// Dates in the Netscape format are stored as the number of seconds since the Unix epoch.
+std::optional<FILETIME> ParseUnixTime(std::string_view text)
+{
+	auto seconds = ParseUint64(text);
+
+	if (!seconds || *seconds == 0)
+	{
+		return std::nullopt;
+	}
+
+	return Uint64ToFileTime(*seconds * INTERVALS_PER_SECOND + UNIX_EPOCH_OFFSET);
+}
+
+// Chromium stores dates as the number of microseconds since the FILETIME epoch.
+std::optional<FILETIME> ParseChromiumTime(std::string_view text)
+{
+	auto microseconds = ParseUint64(text);
+
+	if (!microseconds || *microseconds == 0)
+	{
+		return std::nullopt;
+	}
+
+	return Uint64ToFileTime(*microseconds * INTERVALS_PER_MICROSECOND);
+}
+
+void SetDates(BookmarkItem *bookmarkItem, const std::optional<FILETIME> &dateCreated,
+	const std::optional<FILETIME> &dateModified)
+{
+	if (dateCreated)
+	{
+		bookmarkItem->SetDateCreated(*dateCreated);
+	}
+
+	if (dateModified)
+	{
+		bookmarkItem->SetDateModified(*dateModified);
+	}
+	else if (dateCreated)
+	{
+		bookmarkItem->SetDateModified(*dateCreated);
+	}
+}
+
+namespace NetscapeHtml
+{
+
+void AppendUtf8(std::string &output, char32_t codePoint)
+{
+	if (codePoint < 0x80)
+	{
+		output += static_cast<char>(codePoint);
+	}
+	else if (codePoint < 0x800)
+	{
+		output += static_cast<char>(0xC0 | (codePoint >> 6));
+		output += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		output += static_cast<char>(0xE0 | (codePoint >> 12));
+		output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		output += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		output += static_cast<char>(0xF0 | (codePoint >> 18));
+		output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		output += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
+
+std::optional<char32_t> DecodeEntity(std::string_view entity)
+{
+	if (entity == "amp")
+	{
+		return U'&';
+	}
+	else if (entity == "lt")
+	{
+		return U'<';
+	}
+	else if (entity == "gt")
+	{
+		return U'>';
+	}
+	else if (entity == "quot")
+	{
+		return U'"';
+	}
+	else if (entity == "apos")
+	{
+		return U'\'';
+	}
+	else if (entity == "nbsp")
+	{
+		return U' ';
+	}
+
+	if (entity.size() < 2 || entity[0] != '#')
+	{
+		return std::nullopt;
+	}
+
+	int base = 10;
+	entity.remove_prefix(1);
+
+	if (entity[0] == 'x' || entity[0] == 'X')
+	{
+		base = 16;
+		entity.remove_prefix(1);
+	}
+
+	uint32_t codePoint;
+	auto [ptr, ec] =
+		std::from_chars(entity.data(), entity.data() + entity.size(), codePoint, base);
+
+	if (ec != std::errc() || ptr != entity.data() + entity.size() || codePoint == 0
+		|| codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+	{
+		return std::nullopt;
+	}
+
+	return static_cast<char32_t>(codePoint);
+}
+
+std::wstring DecodeText(std::string_view text)
+{
+	// Entity references are short, so there's no need to look any further than this for the
+	// terminating semicolon.
+	const size_t maxEntityLength = 10;
+
+	std::string decodedText;
+	decodedText.reserve(text.size());
+
+	size_t i = 0;
+
+	while (i < text.size())
+	{
+		if (text[i] != '&')
+		{
+			decodedText += text[i];
+			i++;
+			continue;
+		}
+
+		auto end = text.find(';', i);
+
+		if (end == std::string_view::npos || end - i > maxEntityLength)
+		{
+			decodedText += text[i];
+			i++;
+			continue;
+		}
+
+		auto codePoint = DecodeEntity(text.substr(i + 1, end - i - 1));
+
+		if (!codePoint)
+		{
+			decodedText += text[i];
+			i++;
+			continue;
+		}
+
+		AppendUtf8(decodedText, *codePoint);
+		i = end + 1;
+	}
+
+	return utf8StrToWstr(decodedText);
+}
+
+bool IsWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Only the attributes that are actually used are retained.
+struct Attributes
+{
+	std::string href;
+	std::string addDate;
+	std::string lastModified;
+};
+
+Attributes ParseAttributes(std::string_view text)
+{
+	Attributes attributes;
+	size_t i = 0;
+
+	while (i < text.size())
+	{
+		while (i < text.size() && IsWhitespace(text[i]))
+		{
+			i++;
+		}
+
+		size_t nameStart = i;
+
+		while (i < text.size() && !IsWhitespace(text[i]) && text[i] != '=')
+		{
+			i++;
+		}
+
+		std::string name(text.substr(nameStart, i - nameStart));
+		std::ranges::transform(name, name.begin(),
+			[](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+
+		if (i >= text.size() || text[i] != '=')
+		{
+			continue;
+		}
+
+		i++;
+
+		std::string_view value;
+
+		if (i < text.size() && (text[i] == '"' || text[i] == '\''))
+		{
+			char quote = text[i];
+			i++;
+
+			auto end = text.find(quote, i);
+
+			if (end == std::string_view::npos)
+			{
+				end = text.size();
+			}
+
+			value = text.substr(i, end - i);
+			i = end + 1;
+		}
+		else
+		{
+			size_t valueStart = i;
+
+			while (i < text.size() && !IsWhitespace(text[i]))
+			{
+				i++;
+			}
+
+			value = text.substr(valueStart, i - valueStart);
+		}
+
+		if (name == "HREF")
+		{
+			attributes.href = value;
+		}
+		else if (name == "ADD_DATE")
+		{
+			attributes.addDate = value;
+		}
+		else if (name == "LAST_MODIFIED")
+		{
+			attributes.lastModified = value;
+		}
+	}
+
+	return attributes;
+}
+
+// The format consists of a series of nested lists. Each folder is represented by a <H3> tag, which
+// is followed by a <DL> list containing the items within the folder. Each bookmark is represented
+// by an <A> tag. For example:
+//
+// <DL><p>
+//     <DT><H3 ADD_DATE="1600000000">Folder</H3>
+//     <DL><p>
+//         <DT><A HREF="https://example.com" ADD_DATE="1600000000">Bookmark</A>
+//     </DL><p>
+// </DL><p>
+//
+// The input is read one tag at a time, with the folder hierarchy tracked using a stack.
+class Parser
+{
+public:
+	std::optional<BookmarkItems> Parse(std::istream &stream)
+	{
+		std::string text;
+		std::string tag;
+
+		while (std::getline(stream, text, '<'))
+		{
+			if (m_captureType != CaptureType::None)
+			{
+				m_capturedText += text;
+			}
+
+			if (!std::getline(stream, tag, '>'))
+			{
+				break;
+			}
+
+			OnTag(tag);
+		}
+
+		if (!m_foundList)
+		{
+			return std::nullopt;
+		}
+
+		// If the file was truncated, any lists that are still open are closed here, so that the
+		// items that were read are retained.
+		while (!m_lists.empty())
+		{
+			CloseList();
+		}
+
+		return std::move(m_topLevelItems);
+	}
+
+private:
+	enum class CaptureType
+	{
+		None,
+		FolderName,
+		BookmarkName
+	};
+
+	struct PendingFolder
+	{
+		std::wstring name;
+		Attributes attributes;
+	};
+
+	struct List
+	{
+		// This will be empty if the list isn't associated with a folder (e.g. the top-level list).
+		std::optional<PendingFolder> folder;
+
+		BookmarkItems items;
+	};
+
+	void OnTag(std::string_view tag)
+	{
+		// Comments and the DOCTYPE declaration.
+		if (tag.starts_with('!'))
+		{
+			return;
+		}
+
+		auto nameEnd = std::ranges::find_if(tag, [](char c) { return IsWhitespace(c); });
+		std::string name(tag.begin(), nameEnd);
+		std::ranges::transform(name, name.begin(),
+			[](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+
+		if (name == "DL")
+		{
+			m_foundList = true;
+			m_lists.push_back({ std::exchange(m_pendingFolder, std::nullopt), {} });
+		}
+		else if (name == "/DL")
+		{
+			FlushPendingFolder();
+
+			if (!m_lists.empty())
+			{
+				CloseList();
+			}
+		}
+		else if (name == "DT")
+		{
+			FlushPendingFolder();
+		}
+		else if (name == "H3" || name == "A")
+		{
+			FlushPendingFolder();
+
+			m_captureType = (name == "H3") ? CaptureType::FolderName : CaptureType::BookmarkName;
+			m_capturedText.clear();
+			m_capturedAttributes =
+				ParseAttributes(std::string_view(nameEnd, tag.end()));
+		}
+		else if (name == "/H3" && m_captureType == CaptureType::FolderName)
+		{
+			// The folder isn't created until its list has been read. That's because adding each of
+			// the children would otherwise overwrite the folder's modification date.
+			m_pendingFolder = { DecodeText(m_capturedText), std::move(m_capturedAttributes) };
+			m_captureType = CaptureType::None;
+		}
+		else if (name == "/A" && m_captureType == CaptureType::BookmarkName)
+		{
+			auto bookmark = std::make_unique<BookmarkItem>(std::nullopt,
+				DecodeText(m_capturedText), DecodeText(m_capturedAttributes.href));
+			SetDates(bookmark.get(), ParseUnixTime(m_capturedAttributes.addDate),
+				ParseUnixTime(m_capturedAttributes.lastModified));
+			AddItem(std::move(bookmark));
+
+			m_captureType = CaptureType::None;
+		}
+	}
+
+	// A folder that isn't followed by a list is empty.
+	void FlushPendingFolder()
+	{
+		if (!m_pendingFolder)
+		{
+			return;
+		}
+
+		AddItem(CreateFolder(*std::exchange(m_pendingFolder, std::nullopt), {}));
+	}
+
+	void CloseList()
+	{
+		List list = std::move(m_lists.back());
+		m_lists.pop_back();
+
+		if (!list.folder)
+		{
+			// Lists that aren't associated with a folder are merged into their parent.
+			for (auto &item : list.items)
+			{
+				AddItem(std::move(item));
+			}
+
+			return;
+		}
+
+		AddItem(CreateFolder(*list.folder, std::move(list.items)));
+	}
+
+	std::unique_ptr<BookmarkItem> CreateFolder(const PendingFolder &pendingFolder,
+		BookmarkItems children)
+	{
+		auto folder = std::make_unique<BookmarkItem>(std::nullopt, pendingFolder.name, std::nullopt);
+
+		for (auto &child : children)
+		{
+			folder->AddChild(std::move(child));
+		}
+
+		SetDates(folder.get(), ParseUnixTime(pendingFolder.attributes.addDate),
+			ParseUnixTime(pendingFolder.attributes.lastModified));
+
+		return folder;
+	}
+
+	void AddItem(std::unique_ptr<BookmarkItem> bookmarkItem)
+	{
+		if (m_lists.empty())
+		{
+			m_topLevelItems.push_back(std::move(bookmarkItem));
+			return;
+		}
+
+		m_lists.back().items.push_back(std::move(bookmarkItem));
+	}
+
+	std::vector<List> m_lists;
+	std::optional<PendingFolder> m_pendingFolder;
+	BookmarkItems m_topLevelItems;
+	bool m_foundList = false;
+
+	CaptureType m_captureType = CaptureType::None;
+	std::string m_capturedText;
+	Attributes m_capturedAttributes;
+};
+
+}
+
+namespace ChromiumJson
+{
+
+// The file has the following structure:
+//
+// {
+//     "roots": {
+//         "bookmark_bar": { "type": "folder", "name": "...", "children": [ ... ] },
+//         "other": { ... },
+//         "synced": { ... }
+//     },
+//     "version": 1
+// }
+//
+// Each item in a "children" array is either another folder, or a bookmark of the form:
+//
+// { "type": "url", "name": "...", "url": "...", "date_added": "..." }
+//
+// The file is processed using the SAX interface, with the current position within that structure
+// tracked using a stack. Any values that aren't part of the structure above (e.g. metadata) are
+// skipped.
+class Handler : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+	bool null() override
+	{
+		return true;
+	}
+
+	bool boolean(bool value) override
+	{
+		UNREFERENCED_PARAMETER(value);
+
+		return true;
+	}
+
+	bool number_integer(number_integer_t value) override
+	{
+		UNREFERENCED_PARAMETER(value);
+
+		return true;
+	}
+
+	bool number_unsigned(number_unsigned_t value) override
+	{
+		UNREFERENCED_PARAMETER(value);
+
+		return true;
+	}
+
+	bool number_float(number_float_t value, const string_t &text) override
+	{
+		UNREFERENCED_PARAMETER(value);
+		UNREFERENCED_PARAMETER(text);
+
+		return true;
+	}
+
+	bool string(string_t &value) override
+	{
+		if (m_frames.empty() || m_frames.back().type != FrameType::Node)
+		{
+			return true;
+		}
+
+		auto &frame = m_frames.back();
+
+		if (frame.key == "type")
+		{
+			frame.node.type = std::move(value);
+		}
+		else if (frame.key == "name")
+		{
+			frame.node.name = std::move(value);
+		}
+		else if (frame.key == "url")
+		{
+			frame.node.url = std::move(value);
+		}
+		else if (frame.key == "date_added")
+		{
+			frame.node.dateAdded = std::move(value);
+		}
+		else if (frame.key == "date_modified")
+		{
+			frame.node.dateModified = std::move(value);
+		}
+
+		return true;
+	}
+
+	bool binary(binary_t &value) override
+	{
+		UNREFERENCED_PARAMETER(value);
+
+		return true;
+	}
+
+	bool start_object(std::size_t numElements) override
+	{
+		UNREFERENCED_PARAMETER(numElements);
+
+		auto type = FrameType::Ignored;
+
+		if (m_frames.empty())
+		{
+			type = FrameType::Document;
+		}
+		else if (m_frames.back().type == FrameType::Document && m_frames.back().key == "roots")
+		{
+			type = FrameType::Roots;
+			m_foundRoots = true;
+		}
+		else if (m_frames.back().type == FrameType::Roots
+			|| m_frames.back().type == FrameType::Children)
+		{
+			type = FrameType::Node;
+		}
+
+		m_frames.push_back({ type });
+
+		return true;
+	}
+
+	bool key(string_t &value) override
+	{
+		m_frames.back().key = std::move(value);
+
+		return true;
+	}
+
+	bool end_object() override
+	{
+		Frame frame = std::move(m_frames.back());
+		m_frames.pop_back();
+
+		if (frame.type != FrameType::Node)
+		{
+			return true;
+		}
+
+		auto bookmarkItem = CreateBookmarkItem(std::move(frame.node));
+
+		if (!bookmarkItem)
+		{
+			return true;
+		}
+
+		auto &parentFrame = m_frames.back();
+
+		if (parentFrame.type == FrameType::Children)
+		{
+			// The frame below the children array is the folder that contains it.
+			m_frames[m_frames.size() - 2].node.children.push_back(std::move(bookmarkItem));
+		}
+		else if (parentFrame.type == FrameType::Roots && bookmarkItem->IsFolder()
+			&& !bookmarkItem->GetChildren().empty())
+		{
+			m_topLevelItems.push_back(std::move(bookmarkItem));
+		}
+
+		return true;
+	}
+
+	bool start_array(std::size_t numElements) override
+	{
+		UNREFERENCED_PARAMETER(numElements);
+
+		auto type = FrameType::Ignored;
+
+		if (!m_frames.empty() && m_frames.back().type == FrameType::Node
+			&& m_frames.back().key == "children")
+		{
+			type = FrameType::Children;
+		}
+
+		m_frames.push_back({ type });
+
+		return true;
+	}
+
+	bool end_array() override
+	{
+		m_frames.pop_back();
+
+		return true;
+	}
+
+	bool parse_error(std::size_t position, const std::string &lastToken,
+		const nlohmann::detail::exception &exception) override
+	{
+		UNREFERENCED_PARAMETER(position);
+		UNREFERENCED_PARAMETER(lastToken);
+		UNREFERENCED_PARAMETER(exception);
+
+		return false;
+	}
+
+	std::optional<BookmarkItems> GetResult()
+	{
+		if (!m_foundRoots)
+		{
+			return std::nullopt;
+		}
+
+		return std::move(m_topLevelItems);
+	}
+
+private:
+	enum class FrameType
+	{
+		Document,
+		Roots,
+		Node,
+		Children,
+		Ignored
+	};
+
+	struct Node
+	{
+		std::string type;
+		std::string name;
+		std::string url;
+		std::string dateAdded;
+		std::string dateModified;
+		BookmarkItems children;
+	};
+
+	struct Frame
+	{
+		FrameType type;
+
+		// The most recent key seen within this object.
+		std::string key;
+
+		// Only used for FrameType::Node.
+		Node node;
+	};
+
+	static std::unique_ptr<BookmarkItem> CreateBookmarkItem(Node node)
+	{
+		std::unique_ptr<BookmarkItem> bookmarkItem;
+
+		if (node.type == "url")
+		{
+			bookmarkItem = std::make_unique<BookmarkItem>(std::nullopt, utf8StrToWstr(node.name),
+				utf8StrToWstr(node.url));
+		}
+		else if (node.type == "folder")
+		{
+			bookmarkItem =
+				std::make_unique<BookmarkItem>(std::nullopt, utf8StrToWstr(node.name), std::nullopt);
+
+			for (auto &child : node.children)
+			{
+				bookmarkItem->AddChild(std::move(child));
+			}
+		}
+		else
+		{
+			return nullptr;
+		}
+
+		SetDates(bookmarkItem.get(), ParseChromiumTime(node.dateAdded),
+			ParseChromiumTime(node.dateModified));
+
+		return bookmarkItem;
+	}
+
+	std::vector<Frame> m_frames;
+	BookmarkItems m_topLevelItems;
+	bool m_foundRoots = false;
+};
+
+}
+
+}
+
+namespace BookmarkImporter
+{
+
+std::optional<BookmarkItems> ParseNetscapeHtml(std::istream &stream)
+{
+	try
+	{
+		NetscapeHtml::Parser parser;
+		return parser.Parse(stream);
+	}
+	catch (const std::range_error &)
+	{
+		// Thrown if the file contains invalid UTF-8.
+		return std::nullopt;
+	}
+}
+
+std::optional<BookmarkItems> ParseChromiumJson(std::istream &stream)
+{
+	ChromiumJson::Handler handler;
+	bool res = nlohmann::json::sax_parse(stream, &handler);
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	return handler.GetResult();
+}
+
+}
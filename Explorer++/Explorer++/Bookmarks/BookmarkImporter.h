@@ -0,0 +1,27 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Bookmarks/BookmarkItem.h"
+#include <istream>
+#include <optional>
+
+// Parses the bookmark files exported by other browsers. Each parser works in a single pass over the
+// input stream, without building an intermediate document, and returns the top-level items found
+// in the file. The returned items can then be added to a BookmarkTree in one operation, via
+// BookmarkTree::AddBookmarkItems().
+namespace BookmarkImporter
+{
+
+// Parses a file in the Netscape bookmark format. This is the HTML format used when exporting
+// bookmarks from most browsers. Returns std::nullopt if the file isn't in the expected format.
+std::optional<BookmarkItems> ParseNetscapeHtml(std::istream &stream);
+
+// Parses the JSON file that Chromium-based browsers use to store bookmarks. Each of the root
+// folders in the file (e.g. the bookmarks bar) that contains at least one item is returned as a
+// separate folder. Returns std::nullopt if the file isn't in the expected format.
+std::optional<BookmarkItems> ParseChromiumJson(std::istream &stream);
+
+}
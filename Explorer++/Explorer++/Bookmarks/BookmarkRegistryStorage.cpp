@@ -132,11 +132,7 @@ void LoadPermanentFolder(HKEY parentKey, BookmarkTree *bookmarkTree, BookmarkIte
 	}
 
 	auto children = LoadBookmarkChildren(childKey.get());
-
-	for (auto &child : children)
-	{
-		bookmarkTree->AddBookmarkItem(bookmarkItem, std::move(child));
-	}
+	bookmarkTree->AddBookmarkItems(bookmarkItem, std::move(children));
 }
 
 BookmarkItems LoadBookmarkChildren(HKEY parentKey)
@@ -0,0 +1,118 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
+#include "Bookmarks/BookmarkTree.h"
+
+BookmarkSearchIndex::BookmarkSearchIndex(BookmarkTree *bookmarkTree) :
+	m_bookmarkTree(bookmarkTree),
+	m_index({ NAME_WEIGHT, LOCATION_WEIGHT })
+{
+	m_connections.push_back(m_bookmarkTree->bookmarkItemAddedSignal.AddObserver(
+		std::bind_front(&BookmarkSearchIndex::OnBookmarkItemAdded, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemUpdatedSignal.AddObserver(
+		std::bind_front(&BookmarkSearchIndex::OnBookmarkItemUpdated, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemPreRemovalSignal.AddObserver(
+		std::bind_front(&BookmarkSearchIndex::OnBookmarkItemPreRemoval, this)));
+
+	AddItemRecursive(m_bookmarkTree->GetRoot());
+}
+
+void BookmarkSearchIndex::AddItemRecursive(BookmarkItem *bookmarkItem)
+{
+	bookmarkItem->VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			// The permanent folders can't be renamed or removed and aren't useful as search results.
+			if (m_bookmarkTree->IsPermanentNode(currentItem))
+			{
+				return;
+			}
+
+			AddItem(currentItem);
+		});
+}
+
+void BookmarkSearchIndex::AddItem(BookmarkItem *bookmarkItem)
+{
+	// Document IDs are never reused. That means that a stale ID can't accidentally refer to a
+	// different item.
+	auto documentId = m_nextDocumentId++;
+
+	auto [itr, didInsert] = m_itemToDocumentIdMap.insert({ bookmarkItem, documentId });
+	CHECK(didInsert);
+
+	m_documentIdToItemMap.insert({ documentId, bookmarkItem });
+
+	UpdateItem(bookmarkItem);
+}
+
+void BookmarkSearchIndex::UpdateItem(BookmarkItem *bookmarkItem)
+{
+	auto itr = m_itemToDocumentIdMap.find(bookmarkItem);
+	CHECK(itr != m_itemToDocumentIdMap.end());
+
+	m_index.SetDocument(itr->second, { bookmarkItem->GetName(), bookmarkItem->GetLocation() });
+}
+
+void BookmarkSearchIndex::RemoveItemRecursive(BookmarkItem *bookmarkItem)
+{
+	bookmarkItem->VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			auto itr = m_itemToDocumentIdMap.find(currentItem);
+
+			if (itr == m_itemToDocumentIdMap.end())
+			{
+				return;
+			}
+
+			m_index.RemoveDocument(itr->second);
+			m_documentIdToItemMap.erase(itr->second);
+			m_itemToDocumentIdMap.erase(itr);
+		});
+}
+
+void BookmarkSearchIndex::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index)
+{
+	UNREFERENCED_PARAMETER(index);
+
+	AddItemRecursive(&bookmarkItem);
+}
+
+void BookmarkSearchIndex::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
+	BookmarkItem::PropertyType propertyType)
+{
+	if (propertyType != BookmarkItem::PropertyType::Name
+		&& propertyType != BookmarkItem::PropertyType::Location)
+	{
+		return;
+	}
+
+	if (m_bookmarkTree->IsPermanentNode(&bookmarkItem))
+	{
+		return;
+	}
+
+	UpdateItem(&bookmarkItem);
+}
+
+void BookmarkSearchIndex::OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem)
+{
+	RemoveItemRecursive(&bookmarkItem);
+}
+
+std::vector<BookmarkSearchIndex::Result> BookmarkSearchIndex::Search(std::wstring_view query,
+	size_t maxResults) const
+{
+	std::vector<Result> results;
+
+	for (const auto &match : m_index.Search(query, maxResults))
+	{
+		results.push_back({ m_documentIdToItemMap.at(match.documentId), match.score });
+	}
+
+	return results;
+}
@@ -0,0 +1,54 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Bookmarks/BookmarkItem.h"
+#include "../Helper/TrigramIndex.h"
+#include <boost/signals2.hpp>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class BookmarkTree;
+
+// Maintains a search index over the names and locations of every bookmark and folder in a
+// BookmarkTree. The index is kept in sync with the tree as items are added, updated and removed, so
+// that searching doesn't require walking the tree.
+class BookmarkSearchIndex
+{
+public:
+	struct Result
+	{
+		BookmarkItem *bookmarkItem;
+		double score;
+	};
+
+	explicit BookmarkSearchIndex(BookmarkTree *bookmarkTree);
+
+	// Returns up to maxResults items that match the query, ordered from best to worst. Small typos
+	// in the query are tolerated, with exact matches being ranked first.
+	std::vector<Result> Search(std::wstring_view query, size_t maxResults) const;
+
+private:
+	// A match on the name of an item is considered more relevant than a match on its location.
+	static constexpr double NAME_WEIGHT = 2.0;
+	static constexpr double LOCATION_WEIGHT = 1.0;
+
+	void AddItemRecursive(BookmarkItem *bookmarkItem);
+	void AddItem(BookmarkItem *bookmarkItem);
+	void UpdateItem(BookmarkItem *bookmarkItem);
+	void RemoveItemRecursive(BookmarkItem *bookmarkItem);
+
+	void OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index);
+	void OnBookmarkItemUpdated(BookmarkItem &bookmarkItem, BookmarkItem::PropertyType propertyType);
+	void OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem);
+
+	BookmarkTree *const m_bookmarkTree;
+	TrigramIndex m_index;
+	TrigramIndex::DocumentId m_nextDocumentId = 0;
+	std::unordered_map<const BookmarkItem *, TrigramIndex::DocumentId> m_itemToDocumentIdMap;
+	std::unordered_map<TrigramIndex::DocumentId, BookmarkItem *> m_documentIdToItemMap;
+	std::vector<boost::signals2::scoped_connection> m_connections;
+};
@@ -85,16 +85,76 @@ BookmarkItem *BookmarkTree::AddBookmarkItem(BookmarkItem *parent,
 
 BookmarkItem *BookmarkTree::AddBookmarkItem(BookmarkItem *parent,
 	std::unique_ptr<BookmarkItem> bookmarkItem, size_t index)
+{
+	BookmarkItems bookmarkItems;
+	bookmarkItems.push_back(std::move(bookmarkItem));
+
+	auto addedItems = AddBookmarkItems(parent, std::move(bookmarkItems), index);
+
+	if (addedItems.empty())
+	{
+		return nullptr;
+	}
+
+	return addedItems[0];
+}
+
+std::vector<BookmarkItem *> BookmarkTree::AddBookmarkItems(BookmarkItem *parent,
+	BookmarkItems bookmarkItems)
+{
+	return AddBookmarkItems(parent, std::move(bookmarkItems), parent->GetChildren().size());
+}
+
+std::vector<BookmarkItem *> BookmarkTree::AddBookmarkItems(BookmarkItem *parent,
+	BookmarkItems bookmarkItems, size_t index)
 {
 	if (!CanAddChildren(parent))
 	{
 		DCHECK(false);
-		return nullptr;
+		return {};
 	}
 
 	// For an item to be added to the tree, the parent item should already be part of the tree.
 	CHECK(IsInTree(parent));
 
+	size_t numItems = 0;
+
+	for (auto &bookmarkItem : bookmarkItems)
+	{
+		bookmarkItem->VisitRecursively([&numItems](BookmarkItem *) { numItems++; });
+	}
+
+	// Without this, adding a large number of items would result in the map being rehashed a number
+	// of times.
+	m_idToBookmarkMap.reserve(m_idToBookmarkMap.size() + numItems);
+
+	for (auto &bookmarkItem : bookmarkItems)
+	{
+		RegisterItemRecursive(bookmarkItem.get());
+	}
+
+	if (index > parent->GetChildren().size())
+	{
+		index = parent->GetChildren().size();
+	}
+
+	std::vector<BookmarkItem *> addedItems;
+	addedItems.reserve(bookmarkItems.size());
+
+	for (auto &bookmarkItem : bookmarkItems)
+	{
+		BookmarkItem *rawBookmarkItem = parent->AddChild(std::move(bookmarkItem), index);
+		bookmarkItemAddedSignal.m_signal(*rawBookmarkItem, index);
+
+		addedItems.push_back(rawBookmarkItem);
+		index++;
+	}
+
+	return addedItems;
+}
+
+void BookmarkTree::RegisterItemRecursive(BookmarkItem *bookmarkItem)
+{
 	bookmarkItem->VisitRecursively(
 		[this](BookmarkItem *currentItem)
 		{
@@ -105,19 +165,11 @@ BookmarkItem *BookmarkTree::AddBookmarkItem(BookmarkItem *parent,
 			currentItem->updatedSignal.AddObserver(
 				std::bind_front(&BookmarkTree::OnBookmarkItemUpdated, this),
 				boost::signals2::at_front);
-		});
 
-	AddIdsRecursive(bookmarkItem.get());
-
-	if (index > parent->GetChildren().size())
-	{
-		index = parent->GetChildren().size();
-	}
-
-	BookmarkItem *rawBookmarkItem = parent->AddChild(std::move(bookmarkItem), index);
-	bookmarkItemAddedSignal.m_signal(*rawBookmarkItem, index);
-
-	return rawBookmarkItem;
+			auto [itr, didInsert] =
+				m_idToBookmarkMap.insert({ currentItem->GetGUID(), currentItem });
+			CHECK(didInsert);
+		});
 }
 
 void BookmarkTree::AddIdsRecursive(BookmarkItem *bookmarkItem)
@@ -9,6 +9,7 @@
 #include <tchar.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class BookmarkTree
 {
@@ -32,6 +33,14 @@ public:
 	BookmarkItem *AddBookmarkItem(BookmarkItem *parent, std::unique_ptr<BookmarkItem> bookmarkItem);
 	BookmarkItem *AddBookmarkItem(BookmarkItem *parent, std::unique_ptr<BookmarkItem> bookmarkItem,
 		size_t index);
+
+	// Adds a set of items (each of which may contain an arbitrary number of nested items) in a
+	// single operation. The ID map is only resized once and bookmarkItemAddedSignal is only
+	// triggered for each of the top-level items, so this is the preferred method for adding a large
+	// number of items (e.g. when importing bookmarks).
+	std::vector<BookmarkItem *> AddBookmarkItems(BookmarkItem *parent, BookmarkItems bookmarkItems);
+	std::vector<BookmarkItem *> AddBookmarkItems(BookmarkItem *parent, BookmarkItems bookmarkItems,
+		size_t index);
 	void MoveBookmarkItem(BookmarkItem *bookmarkItem, BookmarkItem *newParent, size_t index);
 	void RemoveBookmarkItem(BookmarkItem *bookmarkItem);
 
@@ -57,6 +66,7 @@ private:
 	static inline const TCHAR *OTHER_FOLDER_GUID = _T("00000000-0000-0000-0000-000000000004");
 
 	void AddIdsRecursive(BookmarkItem *bookmarkItem);
+	void RegisterItemRecursive(BookmarkItem *bookmarkItem);
 	bool IsInTree(const BookmarkItem *bookmarkItem) const;
 	void OnBookmarkItemUpdated(BookmarkItem &bookmarkItem, BookmarkItem::PropertyType propertyType);
 
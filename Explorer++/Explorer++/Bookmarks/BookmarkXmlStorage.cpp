@@ -131,11 +131,7 @@ void LoadPermanentFolder(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
 	bookmarkItem->SetDateModified(dateModified);
 
 	auto children = LoadBookmarkChildren(childNode.get());
-
-	for (auto &child : children)
-	{
-		bookmarkTree->AddBookmarkItem(bookmarkItem, std::move(child));
-	}
+	bookmarkTree->AddBookmarkItems(bookmarkItem, std::move(children));
 }
 
 BookmarkItems LoadBookmarkChildren(IXMLDOMNode *parentNode)
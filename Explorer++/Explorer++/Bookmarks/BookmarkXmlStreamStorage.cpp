@@ -0,0 +1,335 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Bookmarks/BookmarkXmlStreamStorage.h"
+#include "Bookmarks/BookmarkStorage.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
+#include <boost/lexical_cast.hpp>
+
+namespace
+{
+
+const wchar_t PERMANENT_ITEM_NODE_NAME[] = L"PermanentItem";
+const wchar_t BOOKMARK_NODE_NAME[] = L"Bookmark";
+
+template <typename T>
+std::optional<T> MaybeReadNumber(const XmlReader &reader, const std::wstring &attributeName)
+{
+	const auto *value = reader.MaybeGetAttribute(attributeName);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	try
+	{
+		return boost::lexical_cast<T>(*value);
+	}
+	catch (const boost::bad_lexical_cast &)
+	{
+		return std::nullopt;
+	}
+}
+
+std::optional<FILETIME> MaybeReadDateTime(const XmlReader &reader, const std::wstring &baseKeyName)
+{
+	auto lowDateTime = MaybeReadNumber<DWORD>(reader, baseKeyName + L"Low");
+	auto highDateTime = MaybeReadNumber<DWORD>(reader, baseKeyName + L"High");
+
+	if (!lowDateTime || !highDateTime)
+	{
+		return std::nullopt;
+	}
+
+	return FILETIME{ .dwLowDateTime = *lowDateTime, .dwHighDateTime = *highDateTime };
+}
+
+void WriteDateTime(XmlWriter &writer, const std::wstring &baseKeyName, const FILETIME &dateTime)
+{
+	writer.WriteAttribute(baseKeyName + L"Low", std::to_wstring(dateTime.dwLowDateTime));
+	writer.WriteAttribute(baseKeyName + L"High", std::to_wstring(dateTime.dwHighDateTime));
+}
+
+std::unique_ptr<BookmarkItem> LoadBookmarkItem(XmlReader &reader);
+
+// Loads the children of the element the reader is currently positioned on. Each child element has
+// an index, which determines its position. As with BookmarkXmlStorage, the indexes are expected to
+// be contiguous; any items after a gap are ignored.
+std::optional<BookmarkItems> LoadBookmarkChildren(XmlReader &reader)
+{
+	std::vector<std::pair<int, std::unique_ptr<BookmarkItem>>> indexedChildren;
+	size_t depth = reader.GetDepth();
+
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::EndElement && reader.GetDepth() == depth)
+		{
+			break;
+		}
+
+		if (reader.GetNodeType() != XmlReader::NodeType::StartElement)
+		{
+			continue;
+		}
+
+		if (reader.GetName() != BOOKMARK_NODE_NAME)
+		{
+			if (!reader.SkipElement())
+			{
+				return std::nullopt;
+			}
+
+			continue;
+		}
+
+		auto index = MaybeReadNumber<int>(reader, L"name");
+		auto bookmarkItem = LoadBookmarkItem(reader);
+
+		if (!bookmarkItem)
+		{
+			return std::nullopt;
+		}
+
+		if (index)
+		{
+			indexedChildren.emplace_back(*index, std::move(bookmarkItem));
+		}
+	}
+
+	if (reader.HasError())
+	{
+		return std::nullopt;
+	}
+
+	std::ranges::stable_sort(indexedChildren, {}, &decltype(indexedChildren)::value_type::first);
+
+	BookmarkItems children;
+
+	for (auto &[index, bookmarkItem] : indexedChildren)
+	{
+		if (index != static_cast<int>(children.size()))
+		{
+			break;
+		}
+
+		children.push_back(std::move(bookmarkItem));
+	}
+
+	return children;
+}
+
+std::unique_ptr<BookmarkItem> LoadBookmarkItem(XmlReader &reader)
+{
+	int type = MaybeReadNumber<int>(reader, L"Type").value_or(0);
+
+	const auto *guid = reader.MaybeGetAttribute(L"GUID");
+	const auto *name = reader.MaybeGetAttribute(L"ItemName");
+
+	std::optional<std::wstring> locationOptional;
+
+	if (type == static_cast<int>(BookmarkItem::Type::Bookmark))
+	{
+		const auto *location = reader.MaybeGetAttribute(L"Location");
+		locationOptional = location ? *location : std::wstring();
+	}
+
+	auto bookmarkItem = std::make_unique<BookmarkItem>(
+		guid ? std::make_optional(*guid) : std::nullopt, name ? *name : std::wstring(),
+		locationOptional);
+
+	if (auto dateCreated = MaybeReadDateTime(reader, L"DateCreated"))
+	{
+		bookmarkItem->SetDateCreated(*dateCreated);
+	}
+
+	if (auto dateModified = MaybeReadDateTime(reader, L"DateModified"))
+	{
+		bookmarkItem->SetDateModified(*dateModified);
+	}
+
+	if (type == static_cast<int>(BookmarkItem::Type::Folder))
+	{
+		auto children = LoadBookmarkChildren(reader);
+
+		if (!children)
+		{
+			return nullptr;
+		}
+
+		for (auto &child : *children)
+		{
+			bookmarkItem->AddChild(std::move(child));
+		}
+	}
+	else if (!reader.SkipElement())
+	{
+		return nullptr;
+	}
+
+	return bookmarkItem;
+}
+
+bool LoadPermanentFolder(XmlReader &reader, BookmarkXmlStreamStorage::PermanentFolderData &data)
+{
+	data.dateCreated = MaybeReadDateTime(reader, L"DateCreated");
+	data.dateModified = MaybeReadDateTime(reader, L"DateModified");
+
+	auto children = LoadBookmarkChildren(reader);
+
+	if (!children)
+	{
+		return false;
+	}
+
+	data.children = std::move(*children);
+	return true;
+}
+
+void AddPermanentFolderToTree(BookmarkXmlStreamStorage::PermanentFolderData &&data,
+	BookmarkTree *bookmarkTree, BookmarkItem *bookmarkItem)
+{
+	if (data.dateCreated)
+	{
+		bookmarkItem->SetDateCreated(*data.dateCreated);
+	}
+
+	if (data.dateModified)
+	{
+		bookmarkItem->SetDateModified(*data.dateModified);
+	}
+
+	bookmarkTree->AddBookmarkItems(bookmarkItem, std::move(data.children));
+}
+
+void SaveBookmarkItem(XmlWriter &writer, const BookmarkItem *bookmarkItem, size_t index);
+
+void SaveBookmarkChildren(XmlWriter &writer, const BookmarkItem *parentBookmarkItem)
+{
+	size_t index = 0;
+
+	for (auto &child : parentBookmarkItem->GetChildren())
+	{
+		SaveBookmarkItem(writer, child.get(), index);
+		index++;
+	}
+}
+
+void SaveBookmarkItem(XmlWriter &writer, const BookmarkItem *bookmarkItem, size_t index)
+{
+	writer.StartElement(BOOKMARK_NODE_NAME);
+	writer.WriteAttribute(L"name", std::to_wstring(index));
+	writer.WriteAttribute(L"Type", std::to_wstring(static_cast<int>(bookmarkItem->GetType())));
+	writer.WriteAttribute(L"GUID", bookmarkItem->GetGUID());
+	writer.WriteAttribute(L"ItemName", bookmarkItem->GetName());
+
+	if (bookmarkItem->IsBookmark())
+	{
+		writer.WriteAttribute(L"Location", bookmarkItem->GetLocation());
+	}
+
+	WriteDateTime(writer, L"DateCreated", bookmarkItem->GetDateCreated());
+	WriteDateTime(writer, L"DateModified", bookmarkItem->GetDateModified());
+
+	if (bookmarkItem->IsFolder())
+	{
+		SaveBookmarkChildren(writer, bookmarkItem);
+	}
+
+	writer.EndElement();
+}
+
+void SavePermanentFolder(XmlWriter &writer, const BookmarkItem *bookmarkItem,
+	const std::wstring &name)
+{
+	writer.StartElement(PERMANENT_ITEM_NODE_NAME);
+	writer.WriteAttribute(L"name", name);
+	WriteDateTime(writer, L"DateCreated", bookmarkItem->GetDateCreated());
+	WriteDateTime(writer, L"DateModified", bookmarkItem->GetDateModified());
+	SaveBookmarkChildren(writer, bookmarkItem);
+	writer.EndElement();
+}
+
+}
+
+namespace BookmarkXmlStreamStorage
+{
+
+std::optional<BookmarksData> Load(XmlReader &reader)
+{
+	DCHECK(reader.GetNodeType() == XmlReader::NodeType::StartElement);
+	DCHECK(reader.GetName() == BOOKMARKS_NODE_NAME);
+
+	BookmarksData bookmarksData;
+	size_t depth = reader.GetDepth();
+
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::EndElement && reader.GetDepth() == depth)
+		{
+			return bookmarksData;
+		}
+
+		if (reader.GetNodeType() != XmlReader::NodeType::StartElement)
+		{
+			continue;
+		}
+
+		const auto *name = reader.MaybeGetAttribute(L"name");
+		PermanentFolderData *permanentFolderData = nullptr;
+
+		if (reader.GetName() == PERMANENT_ITEM_NODE_NAME && name)
+		{
+			if (*name == BookmarkStorage::BOOKMARKS_TOOLBAR_NODE_NAME)
+			{
+				permanentFolderData = &bookmarksData.bookmarksToolbar;
+			}
+			else if (*name == BookmarkStorage::BOOKMARKS_MENU_NODE_NAME)
+			{
+				permanentFolderData = &bookmarksData.bookmarksMenu;
+			}
+			else if (*name == BookmarkStorage::OTHER_BOOKMARKS_NODE_NAME)
+			{
+				permanentFolderData = &bookmarksData.otherBookmarks;
+			}
+		}
+
+		bool success = permanentFolderData ? LoadPermanentFolder(reader, *permanentFolderData)
+										   : reader.SkipElement();
+
+		if (!success)
+		{
+			return std::nullopt;
+		}
+	}
+
+	return std::nullopt;
+}
+
+void AddToTree(BookmarksData &&bookmarksData, BookmarkTree *bookmarkTree)
+{
+	AddPermanentFolderToTree(std::move(bookmarksData.bookmarksToolbar), bookmarkTree,
+		bookmarkTree->GetBookmarksToolbarFolder());
+	AddPermanentFolderToTree(std::move(bookmarksData.bookmarksMenu), bookmarkTree,
+		bookmarkTree->GetBookmarksMenuFolder());
+	AddPermanentFolderToTree(std::move(bookmarksData.otherBookmarks), bookmarkTree,
+		bookmarkTree->GetOtherBookmarksFolder());
+}
+
+void Save(XmlWriter &writer, const BookmarkTree *bookmarkTree)
+{
+	writer.StartElement(BOOKMARKS_NODE_NAME);
+	SavePermanentFolder(writer, bookmarkTree->GetBookmarksToolbarFolder(),
+		BookmarkStorage::BOOKMARKS_TOOLBAR_NODE_NAME);
+	SavePermanentFolder(writer, bookmarkTree->GetBookmarksMenuFolder(),
+		BookmarkStorage::BOOKMARKS_MENU_NODE_NAME);
+	SavePermanentFolder(writer, bookmarkTree->GetOtherBookmarksFolder(),
+		BookmarkStorage::OTHER_BOOKMARKS_NODE_NAME);
+	writer.EndElement();
+}
+
+}
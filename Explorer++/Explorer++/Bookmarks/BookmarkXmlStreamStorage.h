@@ -0,0 +1,43 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Bookmarks/BookmarkItem.h"
+#include <optional>
+
+class BookmarkTree;
+class XmlReader;
+class XmlWriter;
+
+// Reads and writes the same (v2) bookmarks format as BookmarkXmlStorage, but does so using
+// XmlReader/XmlWriter, so no DOM is built. Loading the older v1 format isn't supported here; that's
+// still handled by BookmarkXmlStorage.
+namespace BookmarkXmlStreamStorage
+{
+
+static inline const wchar_t BOOKMARKS_NODE_NAME[] = L"Bookmarksv2";
+
+struct PermanentFolderData
+{
+	std::optional<FILETIME> dateCreated;
+	std::optional<FILETIME> dateModified;
+	BookmarkItems children;
+};
+
+struct BookmarksData
+{
+	PermanentFolderData bookmarksToolbar;
+	PermanentFolderData bookmarksMenu;
+	PermanentFolderData otherBookmarks;
+};
+
+// The reader should be positioned on the bookmarks start element. If the bookmarks are read
+// successfully, the reader will be positioned on the matching end element when this returns.
+std::optional<BookmarksData> Load(XmlReader &reader);
+
+void AddToTree(BookmarksData &&bookmarksData, BookmarkTree *bookmarkTree);
+void Save(XmlWriter &writer, const BookmarkTree *bookmarkTree);
+
+}
@@ -33,10 +33,15 @@ void BookmarkListViewModel::SetCurrentFolder(BookmarkItem *folder)
 
 	RemoveAllBookmarkItems();
 
+	std::vector<std::unique_ptr<ListViewItem>> items;
+	items.reserve(folder->GetChildren().size());
+
 	for (const auto &child : folder->GetChildren())
 	{
-		AddBookmarkItem(child.get());
+		items.push_back(CreateItemForBookmark(child.get()));
 	}
+
+	AddItems(std::move(items));
 }
 
 void BookmarkListViewModel::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index)
@@ -85,6 +90,12 @@ void BookmarkListViewModel::OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem)
 }
 
 void BookmarkListViewModel::AddBookmarkItem(BookmarkItem *bookmarkItem)
+{
+	AddItem(CreateItemForBookmark(bookmarkItem));
+}
+
+std::unique_ptr<ListViewItem> BookmarkListViewModel::CreateItemForBookmark(
+	BookmarkItem *bookmarkItem)
 {
 	auto item = std::make_unique<BookmarkListViewItem>(bookmarkItem, m_bookmarkTree,
 		m_bookmarkIconManager, m_config);
@@ -92,7 +103,7 @@ void BookmarkListViewModel::AddBookmarkItem(BookmarkItem *bookmarkItem)
 	auto [mapItr, didInsert] = m_bookmarkToItemMap.insert({ bookmarkItem, item.get() });
 	CHECK(didInsert);
 
-	AddItem(std::move(item));
+	return item;
 }
 
 void BookmarkListViewModel::RemoveBookmarkItem(BookmarkItem *bookmarkItem)
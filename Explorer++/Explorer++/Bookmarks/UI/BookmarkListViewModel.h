@@ -7,6 +7,7 @@
 #include "Bookmarks/UI/BookmarkColumnModel.h"
 #include "ListViewModel.h"
 #include <boost/signals2.hpp>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -42,6 +43,7 @@ private:
 	void OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem);
 
 	void AddBookmarkItem(BookmarkItem *bookmarkItem);
+	std::unique_ptr<ListViewItem> CreateItemForBookmark(BookmarkItem *bookmarkItem);
 	void RemoveBookmarkItem(BookmarkItem *bookmarkItem);
 
 	void RemoveAllBookmarkItems();
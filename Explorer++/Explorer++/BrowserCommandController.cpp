@@ -315,7 +315,7 @@ void BrowserCommandController::ExecuteCommand(int command, OpenFolderDisposition
 		break;
 
 	case IDM_VIEW_REFRESH:
-		GetActiveShellBrowser()->GetNavigationController()->Refresh();
+		GetActiveShellBrowser()->Refresh();
 		break;
 
 	case IDM_VIEW_AUTOSIZECOLUMNS:
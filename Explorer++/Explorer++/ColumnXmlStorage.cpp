@@ -7,7 +7,10 @@
 #include "ShellBrowser/FolderSettings.h"
 #include "../Helper/Helper.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <boost/bimap.hpp>
+#include <unordered_set>
 
 namespace ColumnXmlStorage
 {
@@ -23,8 +26,27 @@ const wchar_t PRINTERS_COLUMNS_NODE_NAME[] = L"Printers";
 const wchar_t NETWORK_COLUMNS_NODE_NAME[] = L"Network";
 const wchar_t NETWORK_PLACES_COLUMNS_NODE_NAME[] = L"NetworkPlaces";
 
+const wchar_t COLUMN_NODE_NAME[] = L"Column";
+const wchar_t SETTING_COLUMN_SET_NAME[] = L"name";
+
 const wchar_t WIDTH_SUFFIX[] = L"_Width";
 
+struct ColumnSetInfo
+{
+	const wchar_t *name;
+	std::vector<Column_t> FolderColumns::*columns;
+};
+
+const ColumnSetInfo COLUMN_SETS[] = {
+	{ REAL_FOLDER_COLUMNS_NODE_NAME, &FolderColumns::realFolderColumns },
+	{ MY_COMPUTER_COLUMNS_NODE_NAME, &FolderColumns::myComputerColumns },
+	{ CONTROL_PANEL_COLUMNS_NODE_NAME, &FolderColumns::controlPanelColumns },
+	{ RECYCLE_BIN_COLUMNS_NODE_NAME, &FolderColumns::recycleBinColumns },
+	{ PRINTERS_COLUMNS_NODE_NAME, &FolderColumns::printersColumns },
+	{ NETWORK_COLUMNS_NODE_NAME, &FolderColumns::networkConnectionsColumns },
+	{ NETWORK_PLACES_COLUMNS_NODE_NAME, &FolderColumns::myNetworkPlacesColumns }
+};
+
 // These names are used when loading and saving columns and shouldn't be changed.
 // clang-format off
 const boost::bimap<ColumnType, std::wstring> COLUMN_TYPE_NAME_MAPPINGS = MakeBimap<ColumnType,
@@ -173,7 +195,7 @@ void SaveColumnSetToXml(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode
 	const std::vector<Column_t> &columnSet, const std::wstring &columnSetName)
 {
 	wil::com_ptr_nothrow<IXMLDOMElement> columnNode;
-	XMLSettings::CreateElementNode(xmlDocument, &columnNode, parentNode, _T("Column"),
+	XMLSettings::CreateElementNode(xmlDocument, &columnNode, parentNode, COLUMN_NODE_NAME,
 		columnSetName.c_str());
 
 	for (const auto &column : columnSet)
@@ -188,42 +210,113 @@ void SaveColumnSetToXml(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode
 	}
 }
 
+std::vector<Column_t> ReadColumnSet(const XmlReader &reader)
+{
+	std::vector<Column_t> columns;
+
+	for (const auto &attribute : reader.GetAttributes())
+	{
+		auto itr = COLUMN_TYPE_NAME_MAPPINGS.right.find(attribute.name);
+
+		if (itr == COLUMN_TYPE_NAME_MAPPINGS.right.end())
+		{
+			continue;
+		}
+
+		Column_t column;
+		column.type = itr->second;
+		column.checked = XMLSettings::DecodeBoolValue(attribute.value);
+		column.width = XMLSettings::MaybeGetInt(reader, attribute.name + WIDTH_SUFFIX)
+						   .value_or(DEFAULT_COLUMN_WIDTH);
+		columns.push_back(column);
+	}
+
+	return columns;
+}
+
+void WriteColumnSet(XmlWriter &writer, const std::vector<Column_t> &columnSet,
+	const std::wstring &columnSetName)
+{
+	writer.StartElement(COLUMN_NODE_NAME);
+	writer.WriteAttribute(SETTING_COLUMN_SET_NAME, columnSetName);
+
+	for (const auto &column : columnSet)
+	{
+		const auto &columnName = COLUMN_TYPE_NAME_MAPPINGS.left.at(column.type);
+		writer.WriteAttribute(columnName, XMLSettings::EncodeBoolValue(column.checked));
+		writer.WriteAttribute(columnName + WIDTH_SUFFIX,
+			XMLSettings::EncodeIntValue(column.width));
+	}
+
+	writer.EndElement();
+}
+
 }
 
 void LoadAllColumnSets(IXMLDOMNode *parentNode, FolderColumns &folderColumns)
 {
-	LoadColumnSetFromXml(parentNode, REAL_FOLDER_COLUMNS_NODE_NAME,
-		folderColumns.realFolderColumns);
-	LoadColumnSetFromXml(parentNode, MY_COMPUTER_COLUMNS_NODE_NAME,
-		folderColumns.myComputerColumns);
-	LoadColumnSetFromXml(parentNode, CONTROL_PANEL_COLUMNS_NODE_NAME,
-		folderColumns.controlPanelColumns);
-	LoadColumnSetFromXml(parentNode, RECYCLE_BIN_COLUMNS_NODE_NAME,
-		folderColumns.recycleBinColumns);
-	LoadColumnSetFromXml(parentNode, PRINTERS_COLUMNS_NODE_NAME, folderColumns.printersColumns);
-	LoadColumnSetFromXml(parentNode, NETWORK_COLUMNS_NODE_NAME,
-		folderColumns.networkConnectionsColumns);
-	LoadColumnSetFromXml(parentNode, NETWORK_PLACES_COLUMNS_NODE_NAME,
-		folderColumns.myNetworkPlacesColumns);
+	for (const auto &columnSet : COLUMN_SETS)
+	{
+		LoadColumnSetFromXml(parentNode, columnSet.name, folderColumns.*columnSet.columns);
+	}
 }
 
 void SaveAllColumnSets(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
 	const FolderColumns &folderColumns)
 {
-	SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.realFolderColumns,
-		REAL_FOLDER_COLUMNS_NODE_NAME);
-	SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.myComputerColumns,
-		MY_COMPUTER_COLUMNS_NODE_NAME);
-	SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.controlPanelColumns,
-		CONTROL_PANEL_COLUMNS_NODE_NAME);
-	SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.recycleBinColumns,
-		RECYCLE_BIN_COLUMNS_NODE_NAME);
-	SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.printersColumns,
-		PRINTERS_COLUMNS_NODE_NAME);
-	SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.networkConnectionsColumns,
-		NETWORK_COLUMNS_NODE_NAME);
-	SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.myNetworkPlacesColumns,
-		NETWORK_PLACES_COLUMNS_NODE_NAME);
+	for (const auto &columnSet : COLUMN_SETS)
+	{
+		SaveColumnSetToXml(xmlDocument, parentNode, folderColumns.*columnSet.columns,
+			columnSet.name);
+	}
+}
+
+bool LoadAllColumnSets(XmlReader &reader, FolderColumns &folderColumns)
+{
+	// As with the DOM version above, only the first column set with a particular name is used.
+	std::unordered_set<std::wstring> seenColumnSets;
+
+	return XMLSettings::ReadChildElements(reader,
+		[&folderColumns, &seenColumnSets](XmlReader &reader)
+		{
+			if (reader.GetName() != COLUMN_NODE_NAME)
+			{
+				return true;
+			}
+
+			auto columnSetName = XMLSettings::MaybeGetString(reader, SETTING_COLUMN_SET_NAME);
+
+			if (!columnSetName)
+			{
+				return true;
+			}
+
+			auto itr = std::ranges::find_if(COLUMN_SETS,
+				[&columnSetName](const auto &columnSet)
+				{ return columnSet.name == *columnSetName; });
+
+			if (itr == std::end(COLUMN_SETS) || !seenColumnSets.insert(*columnSetName).second)
+			{
+				return true;
+			}
+
+			auto columns = ReadColumnSet(reader);
+
+			if (!columns.empty())
+			{
+				folderColumns.*itr->columns = columns;
+			}
+
+			return true;
+		});
+}
+
+void SaveAllColumnSets(XmlWriter &writer, const FolderColumns &folderColumns)
+{
+	for (const auto &columnSet : COLUMN_SETS)
+	{
+		WriteColumnSet(writer, folderColumns.*columnSet.columns, columnSet.name);
+	}
 }
 
 }
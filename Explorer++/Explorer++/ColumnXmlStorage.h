@@ -7,6 +7,8 @@
 #include <msxml.h>
 
 struct FolderColumns;
+class XmlReader;
+class XmlWriter;
 
 namespace ColumnXmlStorage
 {
@@ -15,4 +17,9 @@ void LoadAllColumnSets(IXMLDOMNode *parentNode, FolderColumns &folderColumns);
 void SaveAllColumnSets(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
 	const FolderColumns &folderColumns);
 
+// The reader should be positioned on the parent start element. When this returns, the reader will
+// be positioned on the matching end element.
+bool LoadAllColumnSets(XmlReader &reader, FolderColumns &folderColumns);
+void SaveAllColumnSets(XmlWriter &writer, const FolderColumns &folderColumns);
+
 }
@@ -4,21 +4,95 @@
 
 #include "stdafx.h"
 #include "ComStaThreadPoolExecutor.h"
+#include <algorithm>
 
-ComStaThreadPoolExecutor::ComStaThreadPoolExecutor(int numThreads) :
-	concurrencpp::derivable_executor<ComStaThreadPoolExecutor>("ComStaThreadPoolExecutor")
+namespace
 {
-	for (int i = 0; i < numThreads; i++)
+
+// Identifies the pool (and the worker within that pool) that the current thread belongs to, if
+// any. That allows tasks queued from a worker thread to be added to that thread's own queue.
+thread_local const ComStaThreadPoolExecutor *g_currentPool = nullptr;
+thread_local size_t g_currentWorkerIndex = 0;
+
+}
+
+// Queues tasks on the pool with a fixed priority. The pool owns the threads, so it's solely
+// responsible for shutting them down.
+class ComStaThreadPoolExecutor::PriorityExecutor :
+	public concurrencpp::derivable_executor<PriorityExecutor>
+{
+public:
+	PriorityExecutor(ComStaThreadPoolExecutor *pool, TaskPriority priority) :
+		concurrencpp::derivable_executor<PriorityExecutor>(
+			"ComStaThreadPoolExecutor::PriorityExecutor"),
+		m_pool(pool),
+		m_priority(priority)
+	{
+	}
+
+	void enqueue(concurrencpp::task task) override
+	{
+		std::span<concurrencpp::task> taskSpan(&task, 1);
+		enqueue(taskSpan);
+	}
+
+	void enqueue(std::span<concurrencpp::task> tasks) override
+	{
+		m_pool->Enqueue(tasks, m_priority);
+	}
+
+	int max_concurrency_level() const noexcept override
+	{
+		return m_pool->max_concurrency_level();
+	}
+
+	bool shutdown_requested() const noexcept override
+	{
+		return m_pool->shutdown_requested();
+	}
+
+	void shutdown() noexcept override
+	{
+	}
+
+private:
+	ComStaThreadPoolExecutor *const m_pool;
+	const TaskPriority m_priority;
+};
+
+ComStaThreadPoolExecutor::ComStaThreadPoolExecutor(int numThreads,
+	ThreadPriority threadPriority) :
+	concurrencpp::derivable_executor<ComStaThreadPoolExecutor>("ComStaThreadPoolExecutor"),
+	m_threadPriority(threadPriority)
+{
+	CHECK_GT(numThreads, 0);
+
+	for (size_t i = 0; i < NUM_TASK_PRIORITIES; i++)
 	{
-		auto thread = std::jthread(&ComStaThreadPoolExecutor::ThreadMain, this);
-		m_threads.push_back(std::move(thread));
+		m_priorityExecutors[i] =
+			std::make_shared<PriorityExecutor>(this, static_cast<TaskPriority>(i));
 	}
 
-	m_taskQueuedEvent.create(wil::EventOptions::None);
+	// Each queued task releases the semaphore once, up to the number of threads, which allows
+	// multiple idle threads to be woken when multiple tasks are queued at once.
+	m_workQueuedSemaphore.reset(CreateSemaphore(nullptr, 0, numThreads, nullptr));
+	CHECK(m_workQueuedSemaphore);
 
 	// This is set up as a manual reset event, since once shutdown is requested, this event should
 	// be left permanently set.
 	m_shutDownEvent.create(wil::EventOptions::ManualReset);
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		m_workers.push_back(std::make_unique<Worker>());
+	}
+
+	// The threads are only started once everything above has been set up, since each thread will
+	// immediately start looking for work.
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_threads.emplace_back(&ComStaThreadPoolExecutor::ThreadMain, this, i);
+	}
 }
 
 void ComStaThreadPoolExecutor::enqueue(concurrencpp::task task)
@@ -28,26 +102,66 @@ void ComStaThreadPoolExecutor::enqueue(concurrencpp::task task)
 }
 
 void ComStaThreadPoolExecutor::enqueue(std::span<concurrencpp::task> tasks)
+{
+	Enqueue(tasks, TaskPriority::Interactive);
+}
+
+void ComStaThreadPoolExecutor::Enqueue(std::span<concurrencpp::task> tasks, TaskPriority priority)
 {
 	if (m_shutdownRequested)
 	{
 		throw concurrencpp::errors::runtime_shutdown("COM STA executor already shut down");
 	}
 
-	std::unique_lock<std::mutex> lock(m_mutex);
+	if (tasks.empty())
+	{
+		return;
+	}
+
+	auto priorityIndex = static_cast<size_t>(priority);
+	auto &worker = *m_workers[GetWorkerIndexForEnqueue()];
+	auto queueTime = Clock::now();
+
+	std::unique_lock<std::mutex> lock(worker.mutex);
+
+	// The depth is updated while the lock is held, so that it can't be decremented (by a thread
+	// taking one of these tasks) before it's been incremented.
+	m_laneCounters[priorityIndex].queueDepth += tasks.size();
 
 	for (auto &task : tasks)
 	{
-		m_queue.emplace(std::move(task));
+		worker.queues[priorityIndex].push_back({ std::move(task), queueTime });
 	}
 
 	lock.unlock();
 
-	// Note that this will only wake a single thread, which is problematic if multiple tasks are
-	// being queued at once. In practice, that shouldn't be an issue, since the application really
-	// only needs to queue one task at a time. Although this overloaded version of enqueue() is
-	// present, it only exists to satisfy the interface declared by concurrencpp::executor.
-	m_taskQueuedEvent.SetEvent();
+	WakeWorkers(tasks.size());
+}
+
+size_t ComStaThreadPoolExecutor::GetWorkerIndexForEnqueue()
+{
+	// Work queued by a task that's running on one of the pool's threads is likely to be related to
+	// that task, so it's kept on the same thread, where possible.
+	if (g_currentPool == this)
+	{
+		return g_currentWorkerIndex;
+	}
+
+	return m_nextWorkerIndex++ % m_workers.size();
+}
+
+void ComStaThreadPoolExecutor::WakeWorkers(size_t numTasks)
+{
+	auto releaseCount = static_cast<LONG>(std::min(numTasks, m_workers.size()));
+
+	// This will fail if it would take the semaphore past its maximum count. In that case, there
+	// are already enough pending wake-ups for every thread, so a single additional release is
+	// attempted, which may also fail, which is fine. A thread that's woken will continue to run
+	// tasks until there are none left.
+	if (!ReleaseSemaphore(m_workQueuedSemaphore.get(), releaseCount, nullptr))
+	{
+		ReleaseSemaphore(m_workQueuedSemaphore.get(), 1, nullptr);
+	}
 }
 
 int ComStaThreadPoolExecutor::max_concurrency_level() const noexcept
@@ -69,9 +183,16 @@ void ComStaThreadPoolExecutor::shutdown() noexcept
 		return;
 	}
 
-	std::unique_lock<std::mutex> lock(m_mutex);
-	m_queue = {};
-	lock.unlock();
+	for (auto &worker : m_workers)
+	{
+		std::unique_lock<std::mutex> lock(worker->mutex);
+
+		for (size_t i = 0; i < NUM_TASK_PRIORITIES; i++)
+		{
+			m_laneCounters[i].queueDepth -= worker->queues[i].size();
+			worker->queues[i] = {};
+		}
+	}
 
 	m_shutDownEvent.SetEvent();
 
@@ -81,36 +202,70 @@ void ComStaThreadPoolExecutor::shutdown() noexcept
 	}
 }
 
-void ComStaThreadPoolExecutor::ThreadMain()
+std::shared_ptr<concurrencpp::executor> ComStaThreadPoolExecutor::GetExecutorForPriority(
+	TaskPriority priority) const
+{
+	return m_priorityExecutors[static_cast<size_t>(priority)];
+}
+
+ComStaThreadPoolExecutor::Stats ComStaThreadPoolExecutor::GetStats() const
 {
+	Stats stats;
+
+	for (size_t i = 0; i < NUM_TASK_PRIORITIES; i++)
+	{
+		const auto &counters = m_laneCounters[i];
+		auto &laneStats = stats.lanes[i];
+
+		laneStats.queueDepth = counters.queueDepth;
+		laneStats.numTasksStarted = counters.numTasksStarted;
+		laneStats.totalQueueLatency = std::chrono::nanoseconds(counters.totalQueueLatencyNs);
+		laneStats.maxQueueLatency = std::chrono::nanoseconds(counters.maxQueueLatencyNs);
+	}
+
+	stats.numTasksStolen = m_numTasksStolen;
+
+	return stats;
+}
+
+void ComStaThreadPoolExecutor::ThreadMain(size_t workerIndex)
+{
+	g_currentPool = this;
+	g_currentWorkerIndex = workerIndex;
+
+	if (m_threadPriority == ThreadPriority::Background)
+	{
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+	}
+
 	auto comInitialization = wil::CoInitializeEx_failfast(COINIT_APARTMENTTHREADED);
 
 	// This will force the system to create the message queue.
 	MSG msg;
 	PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
 
-	RunLoop();
+	RunLoop(workerIndex);
 }
 
-void ComStaThreadPoolExecutor::RunLoop()
+void ComStaThreadPoolExecutor::RunLoop(size_t workerIndex)
 {
 	while (!m_shutdownRequested)
 	{
-		while (PerformWork())
+		while (PerformWork(workerIndex))
 			;
 
 		WaitForWork();
 	}
 }
 
-bool ComStaThreadPoolExecutor::PerformWork()
+bool ComStaThreadPoolExecutor::PerformWork(size_t workerIndex)
 {
 	if (PumpMessageLoop())
 	{
 		return true;
 	}
 
-	if (RunTask())
+	if (RunTask(workerIndex))
 	{
 		return true;
 	}
@@ -134,27 +289,98 @@ bool ComStaThreadPoolExecutor::PumpMessageLoop()
 	return true;
 }
 
-bool ComStaThreadPoolExecutor::RunTask()
+bool ComStaThreadPoolExecutor::RunTask(size_t workerIndex)
 {
-	std::unique_lock<std::mutex> lock(m_mutex);
+	auto queuedTask = TakeTask(workerIndex);
 
-	if (m_queue.empty())
+	if (!queuedTask)
 	{
 		return false;
 	}
 
-	auto task = std::move(m_queue.front());
-	m_queue.pop();
+	queuedTask->task();
+
+	return true;
+}
+
+std::optional<ComStaThreadPoolExecutor::QueuedTask> ComStaThreadPoolExecutor::TakeTask(
+	size_t workerIndex)
+{
+	for (size_t priorityIndex = 0; priorityIndex < NUM_TASK_PRIORITIES; priorityIndex++)
+	{
+		// This is only a hint, but it allows empty lanes to be skipped without having to lock
+		// each worker in turn. If a task is queued just after this check, the semaphore will have
+		// been released, so this thread won't wait before checking again.
+		if (m_laneCounters[priorityIndex].queueDepth == 0)
+		{
+			continue;
+		}
+
+		if (auto queuedTask = TakeTaskFromWorker(workerIndex, priorityIndex))
+		{
+			return queuedTask;
+		}
+
+		for (size_t offset = 1; offset < m_workers.size(); offset++)
+		{
+			auto victimIndex = (workerIndex + offset) % m_workers.size();
+
+			if (auto queuedTask = TakeTaskFromWorker(victimIndex, priorityIndex))
+			{
+				m_numTasksStolen++;
+				return queuedTask;
+			}
+		}
+	}
+
+	return std::nullopt;
+}
+
+std::optional<ComStaThreadPoolExecutor::QueuedTask> ComStaThreadPoolExecutor::TakeTaskFromWorker(
+	size_t workerIndex, size_t priorityIndex)
+{
+	auto &worker = *m_workers[workerIndex];
+	std::unique_lock<std::mutex> lock(worker.mutex);
+	auto &queue = worker.queues[priorityIndex];
+
+	if (queue.empty())
+	{
+		return std::nullopt;
+	}
+
+	// Tasks are taken in the order they were queued, both by the owning thread and by any thread
+	// stealing work, so that tasks within a lane are started in roughly the order they were
+	// queued.
+	auto queuedTask = std::move(queue.front());
+	queue.pop_front();
+	m_laneCounters[priorityIndex].queueDepth--;
 
 	lock.unlock();
 
-	task();
+	RecordTaskStarted(priorityIndex, queuedTask);
 
-	return true;
+	return queuedTask;
+}
+
+void ComStaThreadPoolExecutor::RecordTaskStarted(size_t priorityIndex, const QueuedTask &queuedTask)
+{
+	auto &counters = m_laneCounters[priorityIndex];
+	auto latency = Clock::now() - queuedTask.queueTime;
+	auto latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+
+	counters.numTasksStarted++;
+	counters.totalQueueLatencyNs += latencyNs;
+
+	auto maxLatencyNs = counters.maxQueueLatencyNs.load();
+
+	while (latencyNs > maxLatencyNs
+		&& !counters.maxQueueLatencyNs.compare_exchange_weak(maxLatencyNs, latencyNs))
+	{
+	}
 }
 
 void ComStaThreadPoolExecutor::WaitForWork()
 {
-	HANDLE handles[] = { m_taskQueuedEvent.get(), m_shutDownEvent.get() };
+	HANDLE handles[] = { m_workQueuedSemaphore.get(), m_shutDownEvent.get() };
 	MsgWaitForMultipleObjectsEx(std::size(handles), handles, INFINITE, QS_ALLINPUT, 0);
 }
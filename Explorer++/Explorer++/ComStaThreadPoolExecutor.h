@@ -6,18 +6,77 @@
 
 #include <concurrencpp/concurrencpp.h>
 #include <wil/resource.h>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <thread>
 #include <vector>
 
 // Represents a pool of threads, where COM has been initialized on each thread with the
 // single-threaded apartment model. Each thread will both pump messages and run any queued tasks.
+//
+// Rather than having every thread contend on a single queue, each thread has its own set of
+// queues (one per task priority). A task queued from one of the pool's threads is added to that
+// thread's queue, while tasks queued from elsewhere are distributed between the threads. A thread
+// that has no work of its own will steal work from the other threads. Higher priority tasks are
+// always run ahead of lower priority tasks, regardless of which thread they were queued on.
 class ComStaThreadPoolExecutor : public concurrencpp::derivable_executor<ComStaThreadPoolExecutor>
 {
 public:
-	ComStaThreadPoolExecutor(int numThreads);
+	enum class ThreadPriority
+	{
+		Normal,
+
+		// Threads will run in background processing mode, which lowers their CPU, I/O and memory
+		// priority. This is appropriate for speculative work that shouldn't compete with work the
+		// user is waiting on.
+		Background
+	};
+
+	// Tasks queued directly on this executor are given the Interactive priority. Tasks can be
+	// queued with a different priority via the executor returned by GetExecutorForPriority().
+	enum class TaskPriority
+	{
+		// Work the user is directly waiting on (e.g. enumerating the folder being navigated to).
+		Interactive,
+
+		// Work for items that are currently visible (e.g. retrieving icons or column text).
+		Visible,
+
+		// Work that can be put off (e.g. work for items that aren't currently visible).
+		Background
+	};
+
+	static constexpr size_t NUM_TASK_PRIORITIES = 3;
+
+	struct LaneStats
+	{
+		// The number of tasks that are currently queued.
+		size_t queueDepth = 0;
+
+		uint64_t numTasksStarted = 0;
+
+		// The amount of time tasks spent queued, before being started.
+		std::chrono::nanoseconds totalQueueLatency = {};
+		std::chrono::nanoseconds maxQueueLatency = {};
+	};
+
+	struct Stats
+	{
+		// Indexed by TaskPriority.
+		std::array<LaneStats, NUM_TASK_PRIORITIES> lanes;
+
+		// The number of tasks that were run on a thread other than the one they were queued on.
+		uint64_t numTasksStolen = 0;
+	};
+
+	ComStaThreadPoolExecutor(int numThreads,
+		ThreadPriority threadPriority = ThreadPriority::Normal);
 
 	void enqueue(concurrencpp::task task) override;
 	void enqueue(std::span<concurrencpp::task> tasks) override;
@@ -25,18 +84,61 @@ public:
 	bool shutdown_requested() const noexcept override;
 	void shutdown() noexcept override;
 
+	void Enqueue(std::span<concurrencpp::task> tasks, TaskPriority priority);
+
+	// Returns an executor that queues tasks on this pool, with the specified priority. The returned
+	// executor shouldn't be used once this executor has been destroyed.
+	std::shared_ptr<concurrencpp::executor> GetExecutorForPriority(TaskPriority priority) const;
+
+	Stats GetStats() const;
+
 private:
-	void ThreadMain();
-	void RunLoop();
-	bool PerformWork();
+	class PriorityExecutor;
+
+	using Clock = std::chrono::steady_clock;
+
+	struct QueuedTask
+	{
+		concurrencpp::task task;
+		Clock::time_point queueTime;
+	};
+
+	struct Worker
+	{
+		std::mutex mutex;
+
+		// Indexed by TaskPriority.
+		std::array<std::deque<QueuedTask>, NUM_TASK_PRIORITIES> queues;
+	};
+
+	struct LaneCounters
+	{
+		std::atomic<size_t> queueDepth = 0;
+		std::atomic<uint64_t> numTasksStarted = 0;
+		std::atomic<int64_t> totalQueueLatencyNs = 0;
+		std::atomic<int64_t> maxQueueLatencyNs = 0;
+	};
+
+	void ThreadMain(size_t workerIndex);
+	void RunLoop(size_t workerIndex);
+	bool PerformWork(size_t workerIndex);
 	bool PumpMessageLoop();
-	bool RunTask();
+	bool RunTask(size_t workerIndex);
+	std::optional<QueuedTask> TakeTask(size_t workerIndex);
+	std::optional<QueuedTask> TakeTaskFromWorker(size_t workerIndex, size_t priorityIndex);
+	void RecordTaskStarted(size_t priorityIndex, const QueuedTask &queuedTask);
+	size_t GetWorkerIndexForEnqueue();
+	void WakeWorkers(size_t numTasks);
 	void WaitForWork();
 
-	std::vector<std::jthread> m_threads;
-	std::mutex m_mutex;
-	std::queue<concurrencpp::task> m_queue;
-	wil::unique_event_failfast m_taskQueuedEvent;
+	const ThreadPriority m_threadPriority;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::array<std::shared_ptr<PriorityExecutor>, NUM_TASK_PRIORITIES> m_priorityExecutors;
+	std::atomic<size_t> m_nextWorkerIndex = 0;
+	std::array<LaneCounters, NUM_TASK_PRIORITIES> m_laneCounters;
+	std::atomic<uint64_t> m_numTasksStolen = 0;
+	wil::unique_handle m_workQueuedSemaphore;
 	wil::unique_event_failfast m_shutDownEvent;
 	std::atomic_bool m_shutdownRequested = false;
+	std::vector<std::jthread> m_threads;
 };
@@ -103,8 +103,14 @@ struct Config
 	ValueWrapper<bool> extendTabControl = false;
 	bool openTabsInForeground = false;
 
+	// The maximum amount of memory (in MB) that the listings of all tabs can use in total. Once
+	// this is exceeded, the listings of the least recently used tabs will be discarded. A value of
+	// 0 means that there's no limit.
+	unsigned int tabMemoryBudgetMB = 0;
+
 	// Treeview
 	bool checkPinnedToNamespaceTreeProperty = false;
+
 	ValueWrapper<bool> showQuickAccessInTreeView = true;
 
 	// Display window
@@ -139,6 +139,8 @@ void LoadFromKey(HKEY settingsKey, Config &config)
 
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"OpenTabsInForeground",
 		config.openTabsInForeground);
+	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"TabMemoryBudget",
+		config.tabMemoryBudgetMB);
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"DisplayMixedFilesAndFolders",
 		config.globalFolderSettings.displayMixedFilesAndFolders);
 	RegistrySettings::Read32BitValueFromRegistry(settingsKey, L"UseNaturalSortOrder",
@@ -298,6 +300,7 @@ void SaveToKey(HKEY settingsKey, const Config &config)
 	RegistrySettings::SaveDword(settingsKey, L"IconTheme", config.iconSet);
 	RegistrySettings::SaveDword(settingsKey, L"Language", config.language);
 	RegistrySettings::SaveDword(settingsKey, L"OpenTabsInForeground", config.openTabsInForeground);
+	RegistrySettings::SaveDword(settingsKey, L"TabMemoryBudget", config.tabMemoryBudgetMB);
 	RegistrySettings::SaveDword(settingsKey, L"DisplayMixedFilesAndFolders",
 		config.globalFolderSettings.displayMixedFilesAndFolders);
 	RegistrySettings::SaveDword(settingsKey, L"UseNaturalSortOrder",
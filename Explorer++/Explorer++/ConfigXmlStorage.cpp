@@ -9,6 +9,8 @@
 #include "StartupFoldersXmlStorage.h"
 #include "Storage.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <wil/com.h>
 #include <format>
 
@@ -25,6 +27,7 @@ concept WrappedIntegralSetting = requires(T t) {
 };
 
 constexpr wchar_t SETTING_NODE_NAME[] = L"Setting";
+constexpr wchar_t SETTING_NAME_ATTRIBUTE_NAME[] = L"name";
 
 constexpr wchar_t MAIN_FONT_NODE_NAME[] = L"MainFont";
 constexpr wchar_t STARTUP_FOLDERS_NODE_NAME[] = L"StartupFolders";
@@ -61,12 +64,27 @@ HRESULT GetTextSetting(IXMLDOMNode *settingsNode, const std::wstring &settingNam
 	return hr;
 }
 
-template <typename T>
+HRESULT GetTextSetting(const ConfigXmlStorage::StreamedSettings &settings,
+	const std::wstring &settingName, std::wstring &outputText)
+{
+	auto itr = settings.settings.find(settingName);
+
+	if (itr == settings.settings.end())
+	{
+		return S_FALSE;
+	}
+
+	outputText = itr->second.text;
+
+	return S_OK;
+}
+
+template <typename Settings, typename T>
 	requires IntegralSetting<T> || WrappedIntegralSetting<T>
-HRESULT GetIntSetting(IXMLDOMNode *settingsNode, const std::wstring &settingName, T &outputValue)
+HRESULT GetIntSetting(const Settings &settings, const std::wstring &settingName, T &outputValue)
 {
 	std::wstring text;
-	HRESULT hr = GetTextSetting(settingsNode, settingName, text);
+	HRESULT hr = GetTextSetting(settings, settingName, text);
 
 	if (hr != S_OK)
 	{
@@ -78,12 +96,12 @@ HRESULT GetIntSetting(IXMLDOMNode *settingsNode, const std::wstring &settingName
 	return hr;
 }
 
-template <typename T>
+template <typename Settings, typename T>
 	requires std::same_as<T, bool> || std::same_as<T, ValueWrapper<bool>>
-HRESULT GetBoolSetting(IXMLDOMNode *settingsNode, const std::wstring &settingName, T &outputValue)
+HRESULT GetBoolSetting(const Settings &settings, const std::wstring &settingName, T &outputValue)
 {
 	std::wstring text;
-	HRESULT hr = GetTextSetting(settingsNode, settingName, text);
+	HRESULT hr = GetTextSetting(settings, settingName, text);
 
 	if (hr != S_OK)
 	{
@@ -95,12 +113,12 @@ HRESULT GetBoolSetting(IXMLDOMNode *settingsNode, const std::wstring &settingNam
 	return hr;
 }
 
-template <BetterEnum T>
-HRESULT GetBetterEnumSetting(IXMLDOMNode *settingsNode, const std::wstring &settingName,
+template <typename Settings, BetterEnum T>
+HRESULT GetBetterEnumSetting(const Settings &settings, const std::wstring &settingName,
 	T &outputValue)
 {
 	int value;
-	HRESULT hr = GetIntSetting(settingsNode, settingName, value);
+	HRESULT hr = GetIntSetting(settings, settingName, value);
 
 	if (hr != S_OK)
 	{
@@ -117,121 +135,214 @@ HRESULT GetBetterEnumSetting(IXMLDOMNode *settingsNode, const std::wstring &sett
 	return hr;
 }
 
-void LoadFromNode(IXMLDOMNode *settingsNode, Config &config)
+std::optional<COLORREF> MaybeGetColorSetting(IXMLDOMNode *settingsNode,
+	const std::wstring &settingName)
+{
+	wil::com_ptr_nothrow<IXMLDOMNode> node;
+
+	if (GetSettingNode(settingsNode, settingName, &node) != S_OK)
+	{
+		return std::nullopt;
+	}
+
+	return XMLSettings::ReadXMLColorData(node.get());
+}
+
+std::optional<COLORREF> MaybeGetColorSetting(const ConfigXmlStorage::StreamedSettings &settings,
+	const std::wstring &settingName)
+{
+	auto itr = settings.settings.find(settingName);
+
+	if (itr == settings.settings.end())
+	{
+		return std::nullopt;
+	}
+
+	return XMLSettings::ReadXMLColorData(itr->second.attributes);
+}
+
+std::optional<LOGFONT> MaybeGetFontSetting(IXMLDOMNode *settingsNode,
+	const std::wstring &settingName)
+{
+	wil::com_ptr_nothrow<IXMLDOMNode> node;
+
+	if (GetSettingNode(settingsNode, settingName, &node) != S_OK)
+	{
+		return std::nullopt;
+	}
+
+	return XMLSettings::ReadXMLFontData(node.get());
+}
+
+std::optional<LOGFONT> MaybeGetFontSetting(const ConfigXmlStorage::StreamedSettings &settings,
+	const std::wstring &settingName)
+{
+	auto itr = settings.settings.find(settingName);
+
+	if (itr == settings.settings.end())
+	{
+		return std::nullopt;
+	}
+
+	return XMLSettings::ReadXMLFontData(itr->second.attributes);
+}
+
+std::optional<CustomFont> MaybeGetMainFont(IXMLDOMNode *settingsNode)
 {
-	GetBoolSetting(settingsNode, L"AllowMultipleInstances", config.allowMultipleInstances);
-	GetBoolSetting(settingsNode, L"AlwaysOpenInNewTab", config.alwaysOpenNewTab);
-	GetBoolSetting(settingsNode, L"AlwaysShowTabBar", config.alwaysShowTabBar);
-	GetBoolSetting(settingsNode, L"AutoArrangeGlobal",
+	wil::com_ptr_nothrow<IXMLDOMNode> node;
+
+	if (GetSettingNode(settingsNode, MAIN_FONT_NODE_NAME, &node) != S_OK)
+	{
+		return std::nullopt;
+	}
+
+	auto mainFont = CustomFontStorage::LoadFromXml(node.get());
+
+	if (!mainFont)
+	{
+		return std::nullopt;
+	}
+
+	return *mainFont;
+}
+
+std::optional<CustomFont> MaybeGetMainFont(const ConfigXmlStorage::StreamedSettings &settings)
+{
+	return settings.mainFont;
+}
+
+std::optional<std::vector<std::wstring>> MaybeGetStartupFolders(IXMLDOMNode *settingsNode)
+{
+	wil::com_ptr_nothrow<IXMLDOMNode> node;
+
+	if (GetSettingNode(settingsNode, STARTUP_FOLDERS_NODE_NAME, &node) != S_OK)
+	{
+		return std::nullopt;
+	}
+
+	return StartupFoldersXmlStorage::Load(node.get());
+}
+
+std::optional<std::vector<std::wstring>> MaybeGetStartupFolders(
+	const ConfigXmlStorage::StreamedSettings &settings)
+{
+	return settings.startupFolders;
+}
+
+// Settings can be loaded either from an MSXML settings node, or from the settings read by
+// ReadSettings(). The same set of settings is loaded in both cases.
+template <typename Settings>
+void LoadSettings(const Settings &settings, Config &config)
+{
+	GetBoolSetting(settings, L"AllowMultipleInstances", config.allowMultipleInstances);
+	GetBoolSetting(settings, L"AlwaysOpenInNewTab", config.alwaysOpenNewTab);
+	GetBoolSetting(settings, L"AlwaysShowTabBar", config.alwaysShowTabBar);
+	GetBoolSetting(settings, L"AutoArrangeGlobal",
 		config.defaultFolderSettings.autoArrangeEnabled);
-	GetBoolSetting(settingsNode, L"CheckBoxSelection", config.checkBoxSelection);
-	GetBoolSetting(settingsNode, L"ConfirmCloseTabs", config.confirmCloseTabs);
-	GetBoolSetting(settingsNode, L"DisableFolderSizesNetworkRemovable",
+	GetBoolSetting(settings, L"CheckBoxSelection", config.checkBoxSelection);
+	GetBoolSetting(settings, L"ConfirmCloseTabs", config.confirmCloseTabs);
+	GetBoolSetting(settings, L"DisableFolderSizesNetworkRemovable",
 		config.globalFolderSettings.disableFolderSizesNetworkRemovable);
 
-	if (wil::com_ptr_nothrow<IXMLDOMNode> node;
-		GetSettingNode(settingsNode, L"DisplayCentreColor", &node) == S_OK)
+	if (auto color = MaybeGetColorSetting(settings, L"DisplayCentreColor"))
 	{
-		config.displayWindowCentreColor = XMLSettings::ReadXMLColorData(node.get());
+		config.displayWindowCentreColor = *color;
 	}
 
-	if (wil::com_ptr_nothrow<IXMLDOMNode> node;
-		GetSettingNode(settingsNode, L"DisplayFont", &node) == S_OK)
+	if (auto font = MaybeGetFontSetting(settings, L"DisplayFont"))
 	{
-		config.displayWindowFont = XMLSettings::ReadXMLFontData(node.get());
+		config.displayWindowFont = *font;
 	}
 
-	if (wil::com_ptr_nothrow<IXMLDOMNode> node;
-		GetSettingNode(settingsNode, L"DisplaySurroundColor", &node) == S_OK)
+	if (auto color = MaybeGetColorSetting(settings, L"DisplaySurroundColor"))
 	{
-		config.displayWindowSurroundColor = XMLSettings::ReadXMLColorData(node.get());
+		config.displayWindowSurroundColor = *color;
 	}
 
-	if (wil::com_ptr_nothrow<IXMLDOMNode> node;
-		GetSettingNode(settingsNode, L"DisplayTextColor", &node) == S_OK)
+	if (auto color = MaybeGetColorSetting(settings, L"DisplayTextColor"))
 	{
-		config.displayWindowTextColor = XMLSettings::ReadXMLColorData(node.get());
+		config.displayWindowTextColor = *color;
 	}
 
-	GetBoolSetting(settingsNode, L"DisplayWindowVertical", config.displayWindowVertical);
-	GetBoolSetting(settingsNode, L"DoubleClickTabClose", config.doubleClickTabClose);
-	GetBoolSetting(settingsNode, L"ExtendTabControl", config.extendTabControl);
-	GetBoolSetting(settingsNode, L"ForceSize", config.globalFolderSettings.forceSize);
+	GetBoolSetting(settings, L"DisplayWindowVertical", config.displayWindowVertical);
+	GetBoolSetting(settings, L"DoubleClickTabClose", config.doubleClickTabClose);
+	GetBoolSetting(settings, L"ExtendTabControl", config.extendTabControl);
+	GetBoolSetting(settings, L"ForceSize", config.globalFolderSettings.forceSize);
 
-	HRESULT hr = GetBoolSetting(settingsNode, L"OpenContainerFiles", config.openContainerFiles);
+	HRESULT hr = GetBoolSetting(settings, L"OpenContainerFiles", config.openContainerFiles);
 
 	if (hr != S_OK)
 	{
-		GetBoolSetting(settingsNode, L"HandleZipFiles", config.openContainerFiles);
+		GetBoolSetting(settings, L"HandleZipFiles", config.openContainerFiles);
 	}
 
-	GetBoolSetting(settingsNode, L"HideLinkExtensionGlobal",
+	GetBoolSetting(settings, L"HideLinkExtensionGlobal",
 		config.globalFolderSettings.hideLinkExtension);
-	GetBoolSetting(settingsNode, L"HideSystemFilesGlobal",
+	GetBoolSetting(settings, L"HideSystemFilesGlobal",
 		config.globalFolderSettings.hideSystemFiles);
-	GetBoolSetting(settingsNode, L"InsertSorted", config.globalFolderSettings.insertSorted);
+	GetBoolSetting(settings, L"InsertSorted", config.globalFolderSettings.insertSorted);
 
 	DWORD language;
-	hr = GetIntSetting(settingsNode, L"Language", language);
+	hr = GetIntSetting(settings, L"Language", language);
 
 	if (hr == S_OK)
 	{
 		config.language = static_cast<LANGID>(language);
 	}
 
-	GetBoolSetting(settingsNode, L"LargeToolbarIcons", config.useLargeToolbarIcons);
-	GetBoolSetting(settingsNode, L"LockToolbars", config.lockToolbars);
-	GetBoolSetting(settingsNode, L"NextToCurrent", config.openNewTabNextToCurrent);
-	GetBoolSetting(settingsNode, L"OneClickActivate", config.globalFolderSettings.oneClickActivate);
-	GetIntSetting(settingsNode, L"OneClickActivateHoverTime",
+	GetBoolSetting(settings, L"LargeToolbarIcons", config.useLargeToolbarIcons);
+	GetBoolSetting(settings, L"LockToolbars", config.lockToolbars);
+	GetBoolSetting(settings, L"NextToCurrent", config.openNewTabNextToCurrent);
+	GetBoolSetting(settings, L"OneClickActivate", config.globalFolderSettings.oneClickActivate);
+	GetIntSetting(settings, L"OneClickActivateHoverTime",
 		config.globalFolderSettings.oneClickActivateHoverTime);
-	GetBoolSetting(settingsNode, L"OverwriteExistingFilesConfirmation",
+	GetBoolSetting(settings, L"OverwriteExistingFilesConfirmation",
 		config.overwriteExistingFilesConfirmation);
-	GetBetterEnumSetting(settingsNode, L"ReplaceExplorerMode", config.replaceExplorerMode);
-	GetBoolSetting(settingsNode, L"ShowAddressBar", config.showAddressBar);
-	GetBoolSetting(settingsNode, L"ShowApplicationToolbar", config.showApplicationToolbar);
-	GetBoolSetting(settingsNode, L"ShowBookmarksToolbar", config.showBookmarksToolbar);
-	GetBoolSetting(settingsNode, L"ShowDrivesToolbar", config.showDrivesToolbar);
-	GetBoolSetting(settingsNode, L"ShowDisplayWindow", config.showDisplayWindow);
-	GetBoolSetting(settingsNode, L"ShowExtensions", config.globalFolderSettings.showExtensions);
-	GetBoolSetting(settingsNode, L"ShowFilePreviews", config.showFilePreviews);
-	GetBoolSetting(settingsNode, L"ShowFolders", config.showFolders);
-	GetBoolSetting(settingsNode, L"ShowFolderSizes", config.globalFolderSettings.showFolderSizes);
-	GetBoolSetting(settingsNode, L"ShowFriendlyDates",
+	GetBetterEnumSetting(settings, L"ReplaceExplorerMode", config.replaceExplorerMode);
+	GetBoolSetting(settings, L"ShowAddressBar", config.showAddressBar);
+	GetBoolSetting(settings, L"ShowApplicationToolbar", config.showApplicationToolbar);
+	GetBoolSetting(settings, L"ShowBookmarksToolbar", config.showBookmarksToolbar);
+	GetBoolSetting(settings, L"ShowDrivesToolbar", config.showDrivesToolbar);
+	GetBoolSetting(settings, L"ShowDisplayWindow", config.showDisplayWindow);
+	GetBoolSetting(settings, L"ShowExtensions", config.globalFolderSettings.showExtensions);
+	GetBoolSetting(settings, L"ShowFilePreviews", config.showFilePreviews);
+	GetBoolSetting(settings, L"ShowFolders", config.showFolders);
+	GetBoolSetting(settings, L"ShowFolderSizes", config.globalFolderSettings.showFolderSizes);
+	GetBoolSetting(settings, L"ShowFriendlyDates",
 		config.globalFolderSettings.showFriendlyDates);
-	GetBoolSetting(settingsNode, L"ShowFullTitlePath", config.showFullTitlePath);
-	GetBoolSetting(settingsNode, L"ShowGridlinesGlobal", config.globalFolderSettings.showGridlines);
-	GetBoolSetting(settingsNode, L"ShowHiddenGlobal", config.defaultFolderSettings.showHidden);
-	GetBoolSetting(settingsNode, L"ShowInfoTips", config.showInfoTips);
-	GetBoolSetting(settingsNode, L"ShowInGroupsGlobal", config.defaultFolderSettings.showInGroups);
-	GetBoolSetting(settingsNode, L"ShowPrivilegeLevelInTitleBar",
+	GetBoolSetting(settings, L"ShowFullTitlePath", config.showFullTitlePath);
+	GetBoolSetting(settings, L"ShowGridlinesGlobal", config.globalFolderSettings.showGridlines);
+	GetBoolSetting(settings, L"ShowHiddenGlobal", config.defaultFolderSettings.showHidden);
+	GetBoolSetting(settings, L"ShowInfoTips", config.showInfoTips);
+	GetBoolSetting(settings, L"ShowInGroupsGlobal", config.defaultFolderSettings.showInGroups);
+	GetBoolSetting(settings, L"ShowPrivilegeLevelInTitleBar",
 		config.showPrivilegeLevelInTitleBar);
-	GetBoolSetting(settingsNode, L"ShowStatusBar", config.showStatusBar);
-	GetBoolSetting(settingsNode, L"ShowTabBarAtBottom", config.showTabBarAtBottom);
-	GetBoolSetting(settingsNode, L"ShowTaskbarThumbnails", config.showTaskbarThumbnails);
-	GetBoolSetting(settingsNode, L"ShowToolbar", config.showMainToolbar);
-	GetBoolSetting(settingsNode, L"ShowUserNameTitleBar", config.showUserNameInTitleBar);
-	GetBetterEnumSetting(settingsNode, L"SizeDisplayFormat",
+	GetBoolSetting(settings, L"ShowStatusBar", config.showStatusBar);
+	GetBoolSetting(settings, L"ShowTabBarAtBottom", config.showTabBarAtBottom);
+	GetBoolSetting(settings, L"ShowTaskbarThumbnails", config.showTaskbarThumbnails);
+	GetBoolSetting(settings, L"ShowToolbar", config.showMainToolbar);
+	GetBoolSetting(settings, L"ShowUserNameTitleBar", config.showUserNameInTitleBar);
+	GetBetterEnumSetting(settings, L"SizeDisplayFormat",
 		config.globalFolderSettings.sizeDisplayFormat);
-	GetBetterEnumSetting(settingsNode, L"StartupMode", config.startupMode);
-	GetBoolSetting(settingsNode, L"SynchronizeTreeview", config.synchronizeTreeview);
-	GetBoolSetting(settingsNode, L"TVAutoExpandSelected", config.treeViewAutoExpandSelected);
-	GetBoolSetting(settingsNode, L"UseFullRowSelect", config.useFullRowSelect);
-	GetBoolSetting(settingsNode, L"TreeViewDelayEnabled", config.treeViewDelayEnabled);
-	GetBetterEnumSetting(settingsNode, L"ViewModeGlobal", config.defaultFolderSettings.viewMode);
-	GetTextSetting(settingsNode, L"NewTabDirectory", config.defaultTabDirectory);
-	GetBetterEnumSetting(settingsNode, L"InfoTipType", config.infoTipType);
-	GetBetterEnumSetting(settingsNode, L"IconTheme", config.iconSet);
-	GetBoolSetting(settingsNode, L"CheckPinnedToNamespaceTreeProperty",
+	GetBetterEnumSetting(settings, L"StartupMode", config.startupMode);
+	GetBoolSetting(settings, L"SynchronizeTreeview", config.synchronizeTreeview);
+	GetBoolSetting(settings, L"TVAutoExpandSelected", config.treeViewAutoExpandSelected);
+	GetBoolSetting(settings, L"UseFullRowSelect", config.useFullRowSelect);
+	GetBoolSetting(settings, L"TreeViewDelayEnabled", config.treeViewDelayEnabled);
+	GetBetterEnumSetting(settings, L"ViewModeGlobal", config.defaultFolderSettings.viewMode);
+	GetTextSetting(settings, L"NewTabDirectory", config.defaultTabDirectory);
+	GetBetterEnumSetting(settings, L"InfoTipType", config.infoTipType);
+	GetBetterEnumSetting(settings, L"IconTheme", config.iconSet);
+	GetBoolSetting(settings, L"CheckPinnedToNamespaceTreeProperty",
 		config.checkPinnedToNamespaceTreeProperty);
-	GetBoolSetting(settingsNode, L"ShowQuickAccessInTreeView", config.showQuickAccessInTreeView);
+	GetBoolSetting(settings, L"ShowQuickAccessInTreeView", config.showQuickAccessInTreeView);
 
 	auto theme = config.theme.get();
 
-	if (GetBetterEnumSetting(settingsNode, L"Theme", theme) != S_OK)
+	if (GetBetterEnumSetting(settings, L"Theme", theme) != S_OK)
 	{
 		if (bool enableDarkMode;
-			GetBoolSetting(settingsNode, L"EnableDarkMode", enableDarkMode) == S_OK)
+			GetBoolSetting(settings, L"EnableDarkMode", enableDarkMode) == S_OK)
 		{
 			theme = enableDarkMode ? Theme::Dark : Theme::Light;
 		}
@@ -239,14 +350,15 @@ void LoadFromNode(IXMLDOMNode *settingsNode, Config &config)
 
 	config.theme = theme;
 
-	GetBoolSetting(settingsNode, L"DisplayMixedFilesAndFolders",
+	GetBoolSetting(settings, L"DisplayMixedFilesAndFolders",
 		config.globalFolderSettings.displayMixedFilesAndFolders);
-	GetBoolSetting(settingsNode, L"UseNaturalSortOrder",
+	GetBoolSetting(settings, L"UseNaturalSortOrder",
 		config.globalFolderSettings.useNaturalSortOrder);
-	GetBoolSetting(settingsNode, L"OpenTabsInForeground", config.openTabsInForeground);
+	GetBoolSetting(settings, L"OpenTabsInForeground", config.openTabsInForeground);
+	GetIntSetting(settings, L"TabMemoryBudget", config.tabMemoryBudgetMB);
 
 	if (bool sortAscending;
-		GetBoolSetting(settingsNode, L"SortAscendingGlobal", sortAscending) == S_OK)
+		GetBoolSetting(settings, L"SortAscendingGlobal", sortAscending) == S_OK)
 	{
 		config.defaultFolderSettings.sortDirection =
 			sortAscending ? SortDirection::Ascending : SortDirection::Descending;
@@ -254,243 +366,303 @@ void LoadFromNode(IXMLDOMNode *settingsNode, Config &config)
 			sortAscending ? SortDirection::Ascending : SortDirection::Descending;
 	}
 
-	GetBetterEnumSetting(settingsNode, L"GroupSortDirectionGlobal",
+	GetBetterEnumSetting(settings, L"GroupSortDirectionGlobal",
 		config.defaultFolderSettings.groupSortDirection);
-	GetBoolSetting(settingsNode, L"GoUpOnDoubleClick", config.goUpOnDoubleClick);
+	GetBoolSetting(settings, L"GoUpOnDoubleClick", config.goUpOnDoubleClick);
+
+	if (auto mainFont = MaybeGetMainFont(settings))
+	{
+		config.mainFont = *mainFont;
+	}
 
-	if (wil::com_ptr_nothrow<IXMLDOMNode> node;
-		GetSettingNode(settingsNode, MAIN_FONT_NODE_NAME, &node) == S_OK)
+	if (auto startupFolders = MaybeGetStartupFolders(settings))
 	{
-		auto mainFont = CustomFontStorage::LoadFromXml(node.get());
+		config.startupFolders = *startupFolders;
+	}
+}
+
+std::vector<XmlReader::Attribute> EncodeColor(COLORREF color)
+{
+	return { { L"r", XMLSettings::EncodeIntValue(GetRValue(color)) },
+		{ L"g", XMLSettings::EncodeIntValue(GetGValue(color)) },
+		{ L"b", XMLSettings::EncodeIntValue(GetBValue(color)) } };
+}
 
-		if (mainFont)
+std::vector<XmlReader::Attribute> EncodeFont(const LOGFONT &font)
+{
+	return { { L"Height", XMLSettings::EncodeIntValue(font.lfHeight) },
+		{ L"Width", XMLSettings::EncodeIntValue(font.lfWidth) },
+		{ L"Weight", XMLSettings::EncodeIntValue(font.lfWeight) },
+		{ L"Italic", XMLSettings::EncodeBoolValue(font.lfItalic) },
+		{ L"Underline", XMLSettings::EncodeBoolValue(font.lfUnderline) },
+		{ L"Strikeout", XMLSettings::EncodeBoolValue(font.lfStrikeOut) },
+		{ L"Font", font.lfFaceName } };
+}
+
+class DomSettingsWriter
+{
+public:
+	DomSettingsWriter(IXMLDOMDocument *xmlDocument, IXMLDOMElement *settingsNode) :
+		m_xmlDocument(xmlDocument),
+		m_settingsNode(settingsNode)
+	{
+	}
+
+	void WriteSetting(const std::wstring &settingName, const std::wstring &value)
+	{
+		XMLSettings::WriteStandardSetting(m_xmlDocument, m_settingsNode, SETTING_NODE_NAME,
+			settingName, value);
+	}
+
+	void WriteColorSetting(const std::wstring &settingName, COLORREF color)
+	{
+		WriteAttributeSetting(settingName, EncodeColor(color));
+	}
+
+	void WriteFontSetting(const std::wstring &settingName, const LOGFONT &font)
+	{
+		WriteAttributeSetting(settingName, EncodeFont(font));
+	}
+
+	void WriteMainFont(const CustomFont &mainFont)
+	{
+		auto settingNode = CreateSettingNode(MAIN_FONT_NODE_NAME);
+		CustomFontStorage::SaveToXml(m_xmlDocument, settingNode.get(), mainFont);
+	}
+
+	void WriteStartupFolders(const std::vector<std::wstring> &startupFolders)
+	{
+		auto settingNode = CreateSettingNode(STARTUP_FOLDERS_NODE_NAME);
+		StartupFoldersXmlStorage::Save(m_xmlDocument, settingNode.get(), startupFolders);
+	}
+
+private:
+	void WriteAttributeSetting(const std::wstring &settingName,
+		const std::vector<XmlReader::Attribute> &attributes)
+	{
+		auto settingNode = CreateSettingNode(settingName);
+
+		for (const auto &attribute : attributes)
 		{
-			config.mainFont = *mainFont;
+			XMLSettings::AddAttributeToNode(m_xmlDocument, settingNode.get(), attribute.name,
+				attribute.value);
 		}
 	}
 
-	if (wil::com_ptr_nothrow<IXMLDOMNode> node;
-		GetSettingNode(settingsNode, STARTUP_FOLDERS_NODE_NAME, &node) == S_OK)
+	wil::com_ptr_nothrow<IXMLDOMElement> CreateSettingNode(const std::wstring &settingName)
 	{
-		config.startupFolders = StartupFoldersXmlStorage::Load(node.get());
+		wil::com_ptr_nothrow<IXMLDOMElement> settingNode;
+		XMLSettings::CreateElementNode(m_xmlDocument, &settingNode, m_settingsNode,
+			SETTING_NODE_NAME, settingName);
+		return settingNode;
 	}
-}
 
-void SaveToNode(IXMLDOMDocument *xmlDocument, IXMLDOMElement *settingsNode, const Config &config)
+	IXMLDOMDocument *const m_xmlDocument;
+	IXMLDOMElement *const m_settingsNode;
+};
+
+class StreamSettingsWriter
+{
+public:
+	explicit StreamSettingsWriter(XmlWriter &writer) : m_writer(writer)
+	{
+	}
+
+	void WriteSetting(const std::wstring &settingName, const std::wstring &value)
+	{
+		StartSetting(settingName);
+		m_writer.WriteText(value);
+		m_writer.EndElement();
+	}
+
+	void WriteColorSetting(const std::wstring &settingName, COLORREF color)
+	{
+		WriteAttributeSetting(settingName, EncodeColor(color));
+	}
+
+	void WriteFontSetting(const std::wstring &settingName, const LOGFONT &font)
+	{
+		WriteAttributeSetting(settingName, EncodeFont(font));
+	}
+
+	void WriteMainFont(const CustomFont &mainFont)
+	{
+		StartSetting(MAIN_FONT_NODE_NAME);
+		CustomFontStorage::SaveToXml(m_writer, mainFont);
+		m_writer.EndElement();
+	}
+
+	void WriteStartupFolders(const std::vector<std::wstring> &startupFolders)
+	{
+		StartSetting(STARTUP_FOLDERS_NODE_NAME);
+		StartupFoldersXmlStorage::Save(m_writer, startupFolders);
+		m_writer.EndElement();
+	}
+
+private:
+	void WriteAttributeSetting(const std::wstring &settingName,
+		const std::vector<XmlReader::Attribute> &attributes)
+	{
+		StartSetting(settingName);
+
+		for (const auto &attribute : attributes)
+		{
+			m_writer.WriteAttribute(attribute.name, attribute.value);
+		}
+
+		m_writer.EndElement();
+	}
+
+	void StartSetting(const std::wstring &settingName)
+	{
+		m_writer.StartElement(SETTING_NODE_NAME);
+		m_writer.WriteAttribute(SETTING_NAME_ATTRIBUTE_NAME, settingName);
+	}
+
+	XmlWriter &m_writer;
+};
+
+template <typename SettingsWriter>
+void SaveSettings(SettingsWriter &settingsWriter, const Config &config)
 {
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"AllowMultipleInstances", XMLSettings::EncodeBoolValue(config.allowMultipleInstances));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"AlwaysOpenInNewTab", XMLSettings::EncodeBoolValue(config.alwaysOpenNewTab));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"AlwaysShowTabBar", XMLSettings::EncodeBoolValue(config.alwaysShowTabBar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"AutoArrangeGlobal",
+	settingsWriter.WriteSetting(L"AllowMultipleInstances",
+		XMLSettings::EncodeBoolValue(config.allowMultipleInstances));
+	settingsWriter.WriteSetting(L"AlwaysOpenInNewTab",
+		XMLSettings::EncodeBoolValue(config.alwaysOpenNewTab));
+	settingsWriter.WriteSetting(L"AlwaysShowTabBar",
+		XMLSettings::EncodeBoolValue(config.alwaysShowTabBar.get()));
+	settingsWriter.WriteSetting(L"AutoArrangeGlobal",
 		XMLSettings::EncodeBoolValue(config.defaultFolderSettings.autoArrangeEnabled));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"CheckBoxSelection", XMLSettings::EncodeBoolValue(config.checkBoxSelection.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ConfirmCloseTabs", XMLSettings::EncodeBoolValue(config.confirmCloseTabs));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"DisableFolderSizesNetworkRemovable",
+	settingsWriter.WriteSetting(L"CheckBoxSelection",
+		XMLSettings::EncodeBoolValue(config.checkBoxSelection.get()));
+	settingsWriter.WriteSetting(L"ConfirmCloseTabs",
+		XMLSettings::EncodeBoolValue(config.confirmCloseTabs));
+	settingsWriter.WriteSetting(L"DisableFolderSizesNetworkRemovable",
 		XMLSettings::EncodeBoolValue(
 			config.globalFolderSettings.disableFolderSizesNetworkRemovable));
 
-	wil::com_ptr_nothrow<IXMLDOMElement> displayCentreColorNode;
-	XMLSettings::CreateElementNode(xmlDocument, &displayCentreColorNode, settingsNode,
-		SETTING_NODE_NAME, L"DisplayCentreColor");
-	XMLSettings::AddAttributeToNode(xmlDocument, displayCentreColorNode.get(), L"r",
-		XMLSettings::EncodeIntValue(GetRValue(config.displayWindowCentreColor.get())));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayCentreColorNode.get(), L"g",
-		XMLSettings::EncodeIntValue(GetGValue(config.displayWindowCentreColor.get())));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayCentreColorNode.get(), L"b",
-		XMLSettings::EncodeIntValue(GetBValue(config.displayWindowCentreColor.get())));
-
-	wil::com_ptr_nothrow<IXMLDOMElement> displayFontNode;
-	XMLSettings::CreateElementNode(xmlDocument, &displayFontNode, settingsNode, SETTING_NODE_NAME,
-		L"DisplayFont");
-	XMLSettings::AddAttributeToNode(xmlDocument, displayFontNode.get(), L"Height",
-		XMLSettings::EncodeIntValue(config.displayWindowFont.get().lfHeight));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayFontNode.get(), L"Width",
-		XMLSettings::EncodeIntValue(config.displayWindowFont.get().lfWidth));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayFontNode.get(), L"Weight",
-		XMLSettings::EncodeIntValue(config.displayWindowFont.get().lfWeight));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayFontNode.get(), L"Italic",
-		XMLSettings::EncodeBoolValue(config.displayWindowFont.get().lfItalic));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayFontNode.get(), L"Underline",
-		XMLSettings::EncodeBoolValue(config.displayWindowFont.get().lfUnderline));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayFontNode.get(), L"Strikeout",
-		XMLSettings::EncodeBoolValue(config.displayWindowFont.get().lfStrikeOut));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayFontNode.get(), L"Font",
-		config.displayWindowFont.get().lfFaceName);
-
-	wil::com_ptr_nothrow<IXMLDOMElement> displaySurroundColorNode;
-	XMLSettings::CreateElementNode(xmlDocument, &displaySurroundColorNode, settingsNode,
-		SETTING_NODE_NAME, L"DisplaySurroundColor");
-	XMLSettings::AddAttributeToNode(xmlDocument, displaySurroundColorNode.get(), L"r",
-		XMLSettings::EncodeIntValue(GetRValue(config.displayWindowSurroundColor.get())));
-	XMLSettings::AddAttributeToNode(xmlDocument, displaySurroundColorNode.get(), L"g",
-		XMLSettings::EncodeIntValue(GetGValue(config.displayWindowSurroundColor.get())));
-	XMLSettings::AddAttributeToNode(xmlDocument, displaySurroundColorNode.get(), L"b",
-		XMLSettings::EncodeIntValue(GetBValue(config.displayWindowSurroundColor.get())));
-
-	wil::com_ptr_nothrow<IXMLDOMElement> displayTextColorNode;
-	XMLSettings::CreateElementNode(xmlDocument, &displayTextColorNode, settingsNode,
-		SETTING_NODE_NAME, L"DisplayTextColor");
-	XMLSettings::AddAttributeToNode(xmlDocument, displayTextColorNode.get(), L"r",
-		XMLSettings::EncodeIntValue(GetRValue(config.displayWindowTextColor.get())));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayTextColorNode.get(), L"g",
-		XMLSettings::EncodeIntValue(GetGValue(config.displayWindowTextColor.get())));
-	XMLSettings::AddAttributeToNode(xmlDocument, displayTextColorNode.get(), L"b",
-		XMLSettings::EncodeIntValue(GetBValue(config.displayWindowTextColor.get())));
-
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"DisplayWindowVertical", XMLSettings::EncodeBoolValue(config.displayWindowVertical));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"DoubleClickTabClose", XMLSettings::EncodeBoolValue(config.doubleClickTabClose));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ExtendTabControl", XMLSettings::EncodeBoolValue(config.extendTabControl.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"ForceSize",
+	settingsWriter.WriteColorSetting(L"DisplayCentreColor", config.displayWindowCentreColor.get());
+	settingsWriter.WriteFontSetting(L"DisplayFont", config.displayWindowFont.get());
+	settingsWriter.WriteColorSetting(L"DisplaySurroundColor",
+		config.displayWindowSurroundColor.get());
+	settingsWriter.WriteColorSetting(L"DisplayTextColor", config.displayWindowTextColor.get());
+	settingsWriter.WriteSetting(L"DisplayWindowVertical",
+		XMLSettings::EncodeBoolValue(config.displayWindowVertical));
+	settingsWriter.WriteSetting(L"DoubleClickTabClose",
+		XMLSettings::EncodeBoolValue(config.doubleClickTabClose));
+	settingsWriter.WriteSetting(L"ExtendTabControl",
+		XMLSettings::EncodeBoolValue(config.extendTabControl.get()));
+	settingsWriter.WriteSetting(L"ForceSize",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.forceSize));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"OpenContainerFiles", XMLSettings::EncodeBoolValue(config.openContainerFiles));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"HideLinkExtensionGlobal",
+	settingsWriter.WriteSetting(L"OpenContainerFiles",
+		XMLSettings::EncodeBoolValue(config.openContainerFiles));
+	settingsWriter.WriteSetting(L"HideLinkExtensionGlobal",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.hideLinkExtension));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"HideSystemFilesGlobal",
+	settingsWriter.WriteSetting(L"HideSystemFilesGlobal",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.hideSystemFiles));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"InfoTipType",
-		XMLSettings::EncodeIntValue(config.infoTipType));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"InsertSorted",
+	settingsWriter.WriteSetting(L"InfoTipType", XMLSettings::EncodeIntValue(config.infoTipType));
+	settingsWriter.WriteSetting(L"InsertSorted",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.insertSorted));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"Language",
-		XMLSettings::EncodeIntValue(config.language));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"LargeToolbarIcons", XMLSettings::EncodeBoolValue(config.useLargeToolbarIcons.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"LockToolbars",
+	settingsWriter.WriteSetting(L"Language", XMLSettings::EncodeIntValue(config.language));
+	settingsWriter.WriteSetting(L"LargeToolbarIcons",
+		XMLSettings::EncodeBoolValue(config.useLargeToolbarIcons.get()));
+	settingsWriter.WriteSetting(L"LockToolbars",
 		XMLSettings::EncodeBoolValue(config.lockToolbars.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"NextToCurrent", XMLSettings::EncodeBoolValue(config.openNewTabNextToCurrent));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"NewTabDirectory", config.defaultTabDirectory.c_str());
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"OneClickActivate",
+	settingsWriter.WriteSetting(L"NextToCurrent",
+		XMLSettings::EncodeBoolValue(config.openNewTabNextToCurrent));
+	settingsWriter.WriteSetting(L"NewTabDirectory", config.defaultTabDirectory.c_str());
+	settingsWriter.WriteSetting(L"OneClickActivate",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.oneClickActivate.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"OneClickActivateHoverTime",
+	settingsWriter.WriteSetting(L"OneClickActivateHoverTime",
 		XMLSettings::EncodeIntValue(config.globalFolderSettings.oneClickActivateHoverTime.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"OverwriteExistingFilesConfirmation",
+	settingsWriter.WriteSetting(L"OverwriteExistingFilesConfirmation",
 		XMLSettings::EncodeBoolValue(config.overwriteExistingFilesConfirmation));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ReplaceExplorerMode", XMLSettings::EncodeIntValue(config.replaceExplorerMode));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowAddressBar", XMLSettings::EncodeBoolValue(config.showAddressBar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowApplicationToolbar",
+	settingsWriter.WriteSetting(L"ReplaceExplorerMode",
+		XMLSettings::EncodeIntValue(config.replaceExplorerMode));
+	settingsWriter.WriteSetting(L"ShowAddressBar",
+		XMLSettings::EncodeBoolValue(config.showAddressBar.get()));
+	settingsWriter.WriteSetting(L"ShowApplicationToolbar",
 		XMLSettings::EncodeBoolValue(config.showApplicationToolbar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowBookmarksToolbar", XMLSettings::EncodeBoolValue(config.showBookmarksToolbar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowDrivesToolbar", XMLSettings::EncodeBoolValue(config.showDrivesToolbar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowDisplayWindow", XMLSettings::EncodeBoolValue(config.showDisplayWindow.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowExtensions",
+	settingsWriter.WriteSetting(L"ShowBookmarksToolbar",
+		XMLSettings::EncodeBoolValue(config.showBookmarksToolbar.get()));
+	settingsWriter.WriteSetting(L"ShowDrivesToolbar",
+		XMLSettings::EncodeBoolValue(config.showDrivesToolbar.get()));
+	settingsWriter.WriteSetting(L"ShowDisplayWindow",
+		XMLSettings::EncodeBoolValue(config.showDisplayWindow.get()));
+	settingsWriter.WriteSetting(L"ShowExtensions",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.showExtensions));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowFilePreviews", XMLSettings::EncodeBoolValue(config.showFilePreviews));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"ShowFolders",
+	settingsWriter.WriteSetting(L"ShowFilePreviews",
+		XMLSettings::EncodeBoolValue(config.showFilePreviews));
+	settingsWriter.WriteSetting(L"ShowFolders",
 		XMLSettings::EncodeBoolValue(config.showFolders.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowFolderSizes",
+	settingsWriter.WriteSetting(L"ShowFolderSizes",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.showFolderSizes));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowFriendlyDates",
+	settingsWriter.WriteSetting(L"ShowFriendlyDates",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.showFriendlyDates));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowFullTitlePath", XMLSettings::EncodeBoolValue(config.showFullTitlePath.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowGridlinesGlobal",
+	settingsWriter.WriteSetting(L"ShowFullTitlePath",
+		XMLSettings::EncodeBoolValue(config.showFullTitlePath.get()));
+	settingsWriter.WriteSetting(L"ShowGridlinesGlobal",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.showGridlines.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowHiddenGlobal", XMLSettings::EncodeBoolValue(config.defaultFolderSettings.showHidden));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"ShowInfoTips",
-		XMLSettings::EncodeBoolValue(config.showInfoTips));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowInGroupsGlobal",
+	settingsWriter.WriteSetting(L"ShowHiddenGlobal",
+		XMLSettings::EncodeBoolValue(config.defaultFolderSettings.showHidden));
+	settingsWriter.WriteSetting(L"ShowInfoTips", XMLSettings::EncodeBoolValue(config.showInfoTips));
+	settingsWriter.WriteSetting(L"ShowInGroupsGlobal",
 		XMLSettings::EncodeBoolValue(config.defaultFolderSettings.showInGroups));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowPrivilegeLevelInTitleBar",
+	settingsWriter.WriteSetting(L"ShowPrivilegeLevelInTitleBar",
 		XMLSettings::EncodeBoolValue(config.showPrivilegeLevelInTitleBar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowStatusBar", XMLSettings::EncodeBoolValue(config.showStatusBar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowTabBarAtBottom", XMLSettings::EncodeBoolValue(config.showTabBarAtBottom.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowTaskbarThumbnails", XMLSettings::EncodeBoolValue(config.showTaskbarThumbnails));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"ShowToolbar",
+	settingsWriter.WriteSetting(L"ShowStatusBar",
+		XMLSettings::EncodeBoolValue(config.showStatusBar.get()));
+	settingsWriter.WriteSetting(L"ShowTabBarAtBottom",
+		XMLSettings::EncodeBoolValue(config.showTabBarAtBottom.get()));
+	settingsWriter.WriteSetting(L"ShowTaskbarThumbnails",
+		XMLSettings::EncodeBoolValue(config.showTaskbarThumbnails));
+	settingsWriter.WriteSetting(L"ShowToolbar",
 		XMLSettings::EncodeBoolValue(config.showMainToolbar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowUserNameTitleBar", XMLSettings::EncodeBoolValue(config.showUserNameInTitleBar.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"SizeDisplayFormat",
+	settingsWriter.WriteSetting(L"ShowUserNameTitleBar",
+		XMLSettings::EncodeBoolValue(config.showUserNameInTitleBar.get()));
+	settingsWriter.WriteSetting(L"SizeDisplayFormat",
 		XMLSettings::EncodeIntValue(config.globalFolderSettings.sizeDisplayFormat));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"SortAscendingGlobal",
+	settingsWriter.WriteSetting(L"SortAscendingGlobal",
 		XMLSettings::EncodeBoolValue(
 			config.defaultFolderSettings.sortDirection == +SortDirection::Ascending));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"StartupMode",
-		XMLSettings::EncodeIntValue(config.startupMode));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"SynchronizeTreeview", XMLSettings::EncodeBoolValue(config.synchronizeTreeview.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"TVAutoExpandSelected", XMLSettings::EncodeBoolValue(config.treeViewAutoExpandSelected));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"UseFullRowSelect", XMLSettings::EncodeBoolValue(config.useFullRowSelect.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"IconTheme",
-		XMLSettings::EncodeIntValue(config.iconSet));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"TreeViewDelayEnabled", XMLSettings::EncodeBoolValue(config.treeViewDelayEnabled));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ViewModeGlobal", XMLSettings::EncodeIntValue(config.defaultFolderSettings.viewMode));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"CheckPinnedToNamespaceTreeProperty",
+	settingsWriter.WriteSetting(L"StartupMode", XMLSettings::EncodeIntValue(config.startupMode));
+	settingsWriter.WriteSetting(L"SynchronizeTreeview",
+		XMLSettings::EncodeBoolValue(config.synchronizeTreeview.get()));
+	settingsWriter.WriteSetting(L"TVAutoExpandSelected",
+		XMLSettings::EncodeBoolValue(config.treeViewAutoExpandSelected));
+	settingsWriter.WriteSetting(L"UseFullRowSelect",
+		XMLSettings::EncodeBoolValue(config.useFullRowSelect.get()));
+	settingsWriter.WriteSetting(L"IconTheme", XMLSettings::EncodeIntValue(config.iconSet));
+	settingsWriter.WriteSetting(L"TreeViewDelayEnabled",
+		XMLSettings::EncodeBoolValue(config.treeViewDelayEnabled));
+	settingsWriter.WriteSetting(L"ViewModeGlobal",
+		XMLSettings::EncodeIntValue(config.defaultFolderSettings.viewMode));
+	settingsWriter.WriteSetting(L"CheckPinnedToNamespaceTreeProperty",
 		XMLSettings::EncodeBoolValue(config.checkPinnedToNamespaceTreeProperty));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"ShowQuickAccessInTreeView",
+	settingsWriter.WriteSetting(L"ShowQuickAccessInTreeView",
 		XMLSettings::EncodeBoolValue(config.showQuickAccessInTreeView.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME, L"Theme",
-		XMLSettings::EncodeIntValue(config.theme.get()));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"DisplayMixedFilesAndFolders",
+	settingsWriter.WriteSetting(L"Theme", XMLSettings::EncodeIntValue(config.theme.get()));
+	settingsWriter.WriteSetting(L"DisplayMixedFilesAndFolders",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.displayMixedFilesAndFolders));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"UseNaturalSortOrder",
+	settingsWriter.WriteSetting(L"UseNaturalSortOrder",
 		XMLSettings::EncodeBoolValue(config.globalFolderSettings.useNaturalSortOrder));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"OpenTabsInForeground", XMLSettings::EncodeBoolValue(config.openTabsInForeground));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"GroupSortDirectionGlobal",
+	settingsWriter.WriteSetting(L"OpenTabsInForeground",
+		XMLSettings::EncodeBoolValue(config.openTabsInForeground));
+	settingsWriter.WriteSetting(L"TabMemoryBudget",
+		XMLSettings::EncodeIntValue(config.tabMemoryBudgetMB));
+	settingsWriter.WriteSetting(L"GroupSortDirectionGlobal",
 		XMLSettings::EncodeIntValue(config.defaultFolderSettings.groupSortDirection));
-	XMLSettings::WriteStandardSetting(xmlDocument, settingsNode, SETTING_NODE_NAME,
-		L"GoUpOnDoubleClick", XMLSettings::EncodeBoolValue(config.goUpOnDoubleClick));
+	settingsWriter.WriteSetting(L"GoUpOnDoubleClick",
+		XMLSettings::EncodeBoolValue(config.goUpOnDoubleClick));
 
 	auto &mainFont = config.mainFont.get();
 
 	if (mainFont)
 	{
-		wil::com_ptr_nothrow<IXMLDOMElement> mainFontNode;
-		XMLSettings::CreateElementNode(xmlDocument, &mainFontNode, settingsNode, SETTING_NODE_NAME,
-			MAIN_FONT_NODE_NAME);
-		CustomFontStorage::SaveToXml(xmlDocument, mainFontNode.get(), *mainFont);
+		settingsWriter.WriteMainFont(*mainFont);
 	}
 
-	wil::com_ptr_nothrow<IXMLDOMElement> startupFoldersNode;
-	XMLSettings::CreateElementNode(xmlDocument, &startupFoldersNode, settingsNode,
-		SETTING_NODE_NAME, STARTUP_FOLDERS_NODE_NAME);
-	StartupFoldersXmlStorage::Save(xmlDocument, startupFoldersNode.get(), config.startupFolders);
+	settingsWriter.WriteStartupFolders(config.startupFolders);
 }
 
 }
@@ -509,7 +681,7 @@ void Load(IXMLDOMNode *rootNode, Config &config)
 		return;
 	}
 
-	LoadFromNode(settingsNode.get(), config);
+	LoadSettings(settingsNode.get(), config);
 }
 
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode, const Config &config)
@@ -523,9 +695,92 @@ void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode, const Config &con
 		return;
 	}
 
-	SaveToNode(xmlDocument, settingsNode.get(), config);
+	DomSettingsWriter settingsWriter(xmlDocument, settingsNode.get());
+	SaveSettings(settingsWriter, config);
 
 	XMLSettings::AppendChildToParent(settingsNode.get(), rootNode);
 }
 
+std::optional<StreamedSettings> ReadSettings(XmlReader &reader)
+{
+	StreamedSettings streamedSettings;
+
+	bool res = XMLSettings::ReadChildElements(reader,
+		[&streamedSettings](XmlReader &reader)
+		{
+			if (reader.GetName() != SETTING_NODE_NAME)
+			{
+				return true;
+			}
+
+			auto settingName = XMLSettings::MaybeGetString(reader, SETTING_NAME_ATTRIBUTE_NAME);
+
+			if (!settingName)
+			{
+				return true;
+			}
+
+			auto attributes = reader.GetAttributes();
+			auto [itr, inserted] = streamedSettings.settings.emplace(*settingName,
+				StreamedSettings::Setting{ { attributes.begin(), attributes.end() }, {} });
+
+			// As with the DOM lookup, only the first setting with a particular name is used.
+			if (!inserted)
+			{
+				return true;
+			}
+
+			if (*settingName == MAIN_FONT_NODE_NAME)
+			{
+				auto mainFont = CustomFontStorage::LoadFromXml(reader);
+
+				if (mainFont)
+				{
+					streamedSettings.mainFont = *mainFont;
+				}
+
+				return true;
+			}
+
+			if (*settingName == STARTUP_FOLDERS_NODE_NAME)
+			{
+				streamedSettings.startupFolders = StartupFoldersXmlStorage::Load(reader);
+				return streamedSettings.startupFolders.has_value();
+			}
+
+			auto text = XMLSettings::ReadElementText(reader);
+
+			if (!text)
+			{
+				return false;
+			}
+
+			itr->second.text = *text;
+
+			return true;
+		});
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	return streamedSettings;
+}
+
+void Load(const StreamedSettings &settings, Config &config)
+{
+	LoadSettings(settings, config);
+}
+
+void Save(XmlWriter &writer, const Config &config)
+{
+	writer.StartElement(Storage::CONFIG_FILE_SETTINGS_NODE_NAME);
+
+	StreamSettingsWriter settingsWriter(writer);
+	SaveSettings(settingsWriter, config);
+
+	writer.EndElement();
+}
+
 }
@@ -4,9 +4,16 @@
 
 #pragma once
 
+#include "CustomFont.h"
+#include "../Helper/XmlReader.h"
 #include <msxml.h>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 struct Config;
+class XmlWriter;
 
 namespace ConfigXmlStorage
 {
@@ -14,4 +21,26 @@ namespace ConfigXmlStorage
 void Load(IXMLDOMNode *rootNode, Config &config);
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode, const Config &config);
 
+// The contents of the settings element, as read by ReadSettings(). Individual settings are looked
+// up by name when the config is loaded, in the same way they are when using the DOM.
+struct StreamedSettings
+{
+	struct Setting
+	{
+		std::vector<XmlReader::Attribute> attributes;
+		std::wstring text;
+	};
+
+	std::unordered_map<std::wstring, Setting> settings;
+	std::optional<CustomFont> mainFont;
+	std::optional<std::vector<std::wstring>> startupFolders;
+};
+
+// The reader should be positioned on the settings start element. If the settings are read
+// successfully, the reader will be positioned on the matching end element when this returns.
+std::optional<StreamedSettings> ReadSettings(XmlReader &reader);
+
+void Load(const StreamedSettings &settings, Config &config);
+void Save(XmlWriter &writer, const Config &config);
+
 }
@@ -7,6 +7,8 @@
 #include "CustomFont.h"
 #include "../Helper/RegistrySettings.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <wil/com.h>
 
 namespace
@@ -84,4 +86,23 @@ void SaveToXml(IXMLDOMDocument *xmlDocument, IXMLDOMElement *fontNode, const Cus
 		XMLSettings::EncodeIntValue(customFont.GetSize()));
 }
 
+std::unique_ptr<CustomFont> LoadFromXml(const XmlReader &reader)
+{
+	auto name = XMLSettings::MaybeGetString(reader, SETTING_NAME);
+	auto size = XMLSettings::MaybeGetInt(reader, SETTING_SIZE);
+
+	if (!name || !size)
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<CustomFont>(*name, *size);
+}
+
+void SaveToXml(XmlWriter &writer, const CustomFont &customFont)
+{
+	writer.WriteAttribute(SETTING_NAME, customFont.GetName());
+	writer.WriteAttribute(SETTING_SIZE, XMLSettings::EncodeIntValue(customFont.GetSize()));
+}
+
 }
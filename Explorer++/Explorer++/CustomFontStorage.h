@@ -8,6 +8,8 @@
 #include <memory>
 
 class CustomFont;
+class XmlReader;
+class XmlWriter;
 
 namespace CustomFontStorage
 {
@@ -19,4 +21,8 @@ std::unique_ptr<CustomFont> LoadFromXml(IXMLDOMNode *fontNode);
 void SaveToXml(IXMLDOMDocument *xmlDocument, IXMLDOMElement *fontNode,
 	const CustomFont &customFont);
 
+// The font is read from (and written to) the attributes of the current element.
+std::unique_ptr<CustomFont> LoadFromXml(const XmlReader &reader);
+void SaveToXml(XmlWriter &writer, const CustomFont &customFont);
+
 }
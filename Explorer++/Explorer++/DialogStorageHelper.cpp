@@ -20,6 +20,7 @@
 #include "SetDefaultColumnsDialog.h"
 #include "SetFileAttributesDialog.h"
 #include "SplitFileDialog.h"
+#include "TabMemoryDialog.h"
 #include "UpdateCheckDialog.h"
 #include "WildcardSelectDialog.h"
 #include "../Helper/XMLSettings.h"
@@ -55,7 +56,8 @@ DialogSettings *const DIALOG_SETTINGS[] = {
 	&ManageBookmarksDialogPersistentSettings::GetInstance(),
 	&DisplayColoursDialogPersistentSettings::GetInstance(),
 	&UpdateCheckDialogPersistentSettings::GetInstance(),
-	&SearchTabsDialogPersistentSettings::GetInstance()
+	&SearchTabsDialogPersistentSettings::GetInstance(),
+	&TabMemoryDialogPersistentSettings::GetInstance()
 };
 // clang-format on
 
@@ -0,0 +1,278 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DirectoryChangeCoalescer.h"
+#include <unordered_set>
+
+void DirectoryChangeCoalescer::AddChange(DirectoryWatcher::Event event,
+	const PidlAbsolute &simplePidl1, const PidlAbsolute &simplePidl2)
+{
+	switch (event)
+	{
+	case DirectoryWatcher::Event::Added:
+		OnItemAdded(simplePidl1);
+		break;
+
+	case DirectoryWatcher::Event::Renamed:
+		OnItemRenamed(simplePidl1, simplePidl2);
+		break;
+
+	case DirectoryWatcher::Event::Modified:
+		OnItemModified(simplePidl1);
+		break;
+
+	case DirectoryWatcher::Event::Removed:
+		OnItemRemoved(simplePidl1);
+		break;
+
+	case DirectoryWatcher::Event::DirectoryContentsChanged:
+		FinalizeItemChanges();
+		m_finalizedChanges.push_back({ event, simplePidl1, simplePidl2 });
+		break;
+	}
+}
+
+void DirectoryChangeCoalescer::OnItemAdded(const PidlAbsolute &pidl)
+{
+	auto *item = MaybeGetItem(pidl);
+
+	if (!item)
+	{
+		AddItem(pidl, false, true);
+		return;
+	}
+
+	// If the item existed initially, it's been removed and re-added (or added twice). Either way,
+	// its details may have changed.
+	item->exists = true;
+	item->modified = item->existedInitially;
+}
+
+void DirectoryChangeCoalescer::OnItemModified(const PidlAbsolute &pidl)
+{
+	auto *item = MaybeGetItem(pidl);
+
+	if (!item)
+	{
+		AddItem(pidl, true, true).modified = true;
+		return;
+	}
+
+	// A modification of an item that's since been removed can be ignored. If the item was added
+	// after the first change, its details will be retrieved in full anyway.
+	if (item->exists && item->existedInitially)
+	{
+		item->modified = true;
+	}
+}
+
+void DirectoryChangeCoalescer::OnItemRenamed(const PidlAbsolute &oldPidl,
+	const PidlAbsolute &newPidl)
+{
+	if (oldPidl == newPidl)
+	{
+		OnItemModified(newPidl);
+		return;
+	}
+
+	auto *item = MaybeGetItem(oldPidl);
+
+	if (item && !item->exists)
+	{
+		// The item has already been removed, so there's nothing to rename. The item under the new
+		// name does exist, however.
+		OnItemAdded(newPidl);
+		return;
+	}
+
+	if (MaybeGetItem(newPidl))
+	{
+		// There have already been changes to an item with the new name. Rather than trying to
+		// combine the history of both items, the rename is treated as a removal of the original
+		// item, followed by an addition of the new item.
+		OnItemRemoved(oldPidl);
+		OnItemAdded(newPidl);
+		return;
+	}
+
+	if (!item)
+	{
+		AddItem(oldPidl, true, true);
+	}
+
+	auto itr = m_itemIndexes.find(oldPidl);
+	size_t index = itr->second;
+	m_itemIndexes.erase(itr);
+
+	m_items[index]->currentPidl = newPidl;
+	m_itemIndexes.emplace(newPidl, index);
+}
+
+void DirectoryChangeCoalescer::OnItemRemoved(const PidlAbsolute &pidl)
+{
+	auto *item = MaybeGetItem(pidl);
+
+	if (!item)
+	{
+		AddItem(pidl, true, false);
+		return;
+	}
+
+	if (!item->existedInitially)
+	{
+		// The item was added and then removed, so there's no net change.
+		RemoveItem(pidl);
+		return;
+	}
+
+	item->exists = false;
+	item->modified = false;
+}
+
+DirectoryChangeCoalescer::ItemState *DirectoryChangeCoalescer::MaybeGetItem(
+	const PidlAbsolute &pidl)
+{
+	auto itr = m_itemIndexes.find(pidl);
+
+	if (itr == m_itemIndexes.end())
+	{
+		return nullptr;
+	}
+
+	return &*m_items[itr->second];
+}
+
+DirectoryChangeCoalescer::ItemState &DirectoryChangeCoalescer::AddItem(const PidlAbsolute &pidl,
+	bool existedInitially, bool exists)
+{
+	auto &item = m_items.emplace_back(ItemState{ .existedInitially = existedInitially,
+		.exists = exists,
+		.originalPidl = pidl,
+		.currentPidl = pidl });
+	m_itemIndexes.emplace(pidl, m_items.size() - 1);
+	return *item;
+}
+
+void DirectoryChangeCoalescer::RemoveItem(const PidlAbsolute &pidl)
+{
+	auto itr = m_itemIndexes.find(pidl);
+	CHECK(itr != m_itemIndexes.end());
+
+	m_items[itr->second].reset();
+	m_itemIndexes.erase(itr);
+}
+
+void DirectoryChangeCoalescer::FinalizeItemChanges()
+{
+	// A name can be vacated by one item and taken by another. For example, when a file is saved
+	// safely (by writing a temporary file, renaming the original file to a backup name, renaming
+	// the temporary file to the original name, then removing the backup), or when two items swap
+	// names. Reporting those changes individually would either remove an item that still exists,
+	// or rename an item onto a name that's still in use. The net effect in each case is that the
+	// item with that name has changed, so it's reported as modified instead.
+	std::unordered_set<PidlAbsolute, boost::hash<PidlAbsolute>> vacatedPidls;
+	std::unordered_set<PidlAbsolute, boost::hash<PidlAbsolute>> takenPidls;
+
+	for (const auto &item : m_items)
+	{
+		if (!item)
+		{
+			continue;
+		}
+
+		bool renamed = item->originalPidl != item->currentPidl;
+
+		if (item->existedInitially && (!item->exists || renamed))
+		{
+			vacatedPidls.insert(item->originalPidl);
+		}
+
+		if (item->exists && (!item->existedInitially || renamed))
+		{
+			takenPidls.insert(item->currentPidl);
+		}
+	}
+
+	for (const auto &item : m_items)
+	{
+		if (!item)
+		{
+			continue;
+		}
+
+		bool renamed = item->originalPidl != item->currentPidl;
+		bool vacatesName = item->existedInitially && (!item->exists || renamed);
+		bool takesName = item->exists && (!item->existedInitially || renamed);
+
+		// If the original name has been taken by another item, the modification will be reported
+		// when that item is processed.
+		bool reportVacated = vacatesName && !takenPidls.contains(item->originalPidl);
+
+		if (takesName && vacatedPidls.contains(item->currentPidl))
+		{
+			m_finalizedChanges.push_back(
+				{ DirectoryWatcher::Event::Modified, item->currentPidl, PidlAbsolute() });
+
+			if (reportVacated)
+			{
+				m_finalizedChanges.push_back(
+					{ DirectoryWatcher::Event::Removed, item->originalPidl, PidlAbsolute() });
+			}
+		}
+		else if (takesName && renamed && !reportVacated)
+		{
+			m_finalizedChanges.push_back(
+				{ DirectoryWatcher::Event::Added, item->currentPidl, PidlAbsolute() });
+		}
+		else if (!item->existedInitially)
+		{
+			CHECK(item->exists);
+			m_finalizedChanges.push_back(
+				{ DirectoryWatcher::Event::Added, item->currentPidl, PidlAbsolute() });
+		}
+		else if (!item->exists)
+		{
+			// The item is removed using its original name, since that's the name it had before
+			// any of these changes were made.
+			if (reportVacated)
+			{
+				m_finalizedChanges.push_back(
+					{ DirectoryWatcher::Event::Removed, item->originalPidl, PidlAbsolute() });
+			}
+		}
+		else if (renamed)
+		{
+			// Renames are treated as updates, so there's no need to also report a modification.
+			m_finalizedChanges.push_back(
+				{ DirectoryWatcher::Event::Renamed, item->originalPidl, item->currentPidl });
+		}
+		else if (item->modified)
+		{
+			m_finalizedChanges.push_back(
+				{ DirectoryWatcher::Event::Modified, item->currentPidl, PidlAbsolute() });
+		}
+	}
+
+	m_items.clear();
+	m_itemIndexes.clear();
+}
+
+std::vector<DirectoryChangeCoalescer::Change> DirectoryChangeCoalescer::TakeChanges()
+{
+	FinalizeItemChanges();
+	return std::exchange(m_finalizedChanges, {});
+}
+
+bool DirectoryChangeCoalescer::HasChanges() const
+{
+	return !m_itemIndexes.empty() || !m_finalizedChanges.empty();
+}
+
+void DirectoryChangeCoalescer::Clear()
+{
+	m_items.clear();
+	m_itemIndexes.clear();
+	m_finalizedChanges.clear();
+}
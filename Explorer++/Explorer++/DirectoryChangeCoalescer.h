@@ -0,0 +1,89 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "DirectoryWatcher.h"
+#include "../Helper/PidlHelper.h"
+#include <boost/container_hash/hash.hpp>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// Merges a sequence of directory change notifications into the net set of changes. For example,
+// if an item is added, modified, then removed, there's no net change and nothing will be returned.
+// If an item is renamed several times, a single rename (from the original name to the final name)
+// will be returned. If one item's name is taken over by another item (e.g. when a file is saved via
+// a temporary file), the item with that name will be returned as modified.
+//
+// That allows a large number of changes (e.g. those made when a source control tool updates a
+// working copy) to be applied as a single batch, with each item only being updated once.
+//
+// This isn't part of the directory watchers (FileSystemWatcher and ShellWatcher), which continue to
+// deliver each notification as it arrives. Instead, each ShellBrowserImpl instance owns a coalescer
+// that buffers the notifications for its folder and applies the merged batch on a short timer. That
+// keeps the watchers independent of how (and whether) changes are batched by the consumer.
+//
+// Changes to individual items (additions, modifications, renames and removals) are merged. A
+// DirectoryContentsChanged notification isn't tied to an individual item, so it acts as a barrier:
+// item changes made before it are returned before it and item changes made after it are returned
+// after it.
+class DirectoryChangeCoalescer
+{
+public:
+	struct Change
+	{
+		DirectoryWatcher::Event event;
+		PidlAbsolute simplePidl1;
+		PidlAbsolute simplePidl2;
+
+		// This is only used in tests.
+		bool operator==(const Change &) const = default;
+	};
+
+	void AddChange(DirectoryWatcher::Event event, const PidlAbsolute &simplePidl1,
+		const PidlAbsolute &simplePidl2);
+
+	// Returns the net set of changes since the last call and resets the state of this instance.
+	std::vector<Change> TakeChanges();
+
+	bool HasChanges() const;
+	void Clear();
+
+private:
+	struct ItemState
+	{
+		// Indicates whether the item existed before the first change to it was seen. If it didn't,
+		// the item will be reported as added (if it still exists).
+		bool existedInitially;
+
+		bool exists;
+		bool modified = false;
+
+		// The pidl the item had before the first change to it was seen and the pidl it has now.
+		// These will only differ if the item was renamed.
+		PidlAbsolute originalPidl;
+		PidlAbsolute currentPidl;
+	};
+
+	void OnItemAdded(const PidlAbsolute &pidl);
+	void OnItemModified(const PidlAbsolute &pidl);
+	void OnItemRenamed(const PidlAbsolute &oldPidl, const PidlAbsolute &newPidl);
+	void OnItemRemoved(const PidlAbsolute &pidl);
+
+	ItemState *MaybeGetItem(const PidlAbsolute &pidl);
+	ItemState &AddItem(const PidlAbsolute &pidl, bool existedInitially, bool exists);
+	void RemoveItem(const PidlAbsolute &pidl);
+	void FinalizeItemChanges();
+
+	// Items are stored in the order in which they were first changed, so that the changes are
+	// returned in roughly the same order in which they were made. Items that end up with no net
+	// change are reset, rather than erased, so that the indexes below remain valid.
+	std::vector<std::optional<ItemState>> m_items;
+
+	// Maps the current pidl of each item to its index in the vector above.
+	std::unordered_map<PidlAbsolute, size_t, boost::hash<PidlAbsolute>> m_itemIndexes;
+
+	std::vector<Change> m_finalizedChanges;
+};
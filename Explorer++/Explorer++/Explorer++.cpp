@@ -55,7 +55,7 @@ Explorerplusplus::Explorerplusplus(App *app, const WindowStorageData *storageDat
 		ACCELERATOR_PLUGIN_END_ID),
 	m_shellBrowserFactory(app, this, &m_fileActionHandler),
 	m_config(app->GetConfig()),
-	m_iconFetcher(m_hContainer, m_app->GetCachedIcons()),
+	m_iconFetcher(m_hContainer, m_app->GetCachedIcons(), m_app->GetTaskScheduler()),
 	m_shellIconLoader(&m_iconFetcher),
 	m_applicationExecutor(this)
 {
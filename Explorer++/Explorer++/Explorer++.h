@@ -221,6 +221,7 @@ private:
 	void OnRunScript();
 	void OnShowOptions();
 	void OnSearchTabs();
+	void OnShowTabMemory();
 
 	void OnGoToOffset(int offset);
 
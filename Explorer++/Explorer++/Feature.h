@@ -20,6 +20,63 @@ BETTER_ENUM(Feature, int,
 
 	// When enabled, directory enumeration will be performed on a background thread, rather than the
 	// main thread.
-	BackgroundThreadEnumeration
+	BackgroundThreadEnumeration,
+
+	// When enabled, the config file will be read and written using a streaming parser, rather than
+	// by loading the entire file into an MSXML document.
+	StreamingXmlStorage,
+
+	// When enabled, a binary snapshot of the settings will be saved alongside the config file and
+	// loaded in preference to it on startup, provided the config file hasn't changed since.
+	BinarySnapshotStorage,
+
+	// When enabled, changes to settings will be written to the config file in the background,
+	// shortly after they're made. Only the sections of the file that have changed are
+	// re-serialized.
+	AsyncSettingsPersistence,
+
+	// When enabled, tabs restored from a previous session won't be navigated until they're first
+	// selected. Until then, each tab will only show the name and icon of its folder.
+	DeferredTabLoading,
+
+	// When enabled, tabs that aren't visible won't process directory changes or perform any
+	// background work (e.g. retrieving icons or column text). Instead, each tab will catch up once
+	// it's shown again.
+	SuspendBackgroundTabs,
+
+	// When enabled, the listings of recently visited folders will be cached. Navigating back to
+	// one of those folders will then show the cached listing immediately, with the folder being
+	// re-enumerated in the background to check for changes.
+	FolderListingCache,
+
+	// When enabled, folders the user is likely to navigate to next (the folder under the mouse,
+	// the parent folder, etc.) will be enumerated in the background, at a low priority. This
+	// feature has no effect unless FolderListingCache is also enabled.
+	FolderPrefetch,
+
+	// When enabled, expanding a folder in the treeview will enumerate its children on a background
+	// thread. For folders with a large number of children, the children that are initially visible
+	// will be shown first, with the remainder being added in batches.
+	AsyncTreeViewExpansion,
+
+	// When enabled, directory changes will be collected over a short period and merged, with the
+	// net set of changes then being applied to the listview as a single batch.
+	CoalescedDirectoryChanges,
+
+	// When enabled, refreshing a folder (either explicitly, or because changes to it were missed)
+	// will re-enumerate the folder and update only those items that were added, removed or
+	// modified. Otherwise, the folder will be reloaded, which resets the scroll position and
+	// selection.
+	IncrementalRefresh,
+
+	// When enabled, queued column, icon and thumbnail tasks will be re-prioritized each time the
+	// listview is scrolled, so that the items in view are processed first. Tasks for items that
+	// have scrolled a long way out of view will be cancelled.
+	ViewportTaskPrioritization,
+
+	// When enabled, the results of column, thumbnail, icon and info tip tasks will be collected and
+	// applied to the listview in batches, at most once per frame. Otherwise, each result will be
+	// applied individually, as soon as it's ready.
+	BatchedResultDelivery
 )
 // clang-format on
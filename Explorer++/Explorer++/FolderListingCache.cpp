@@ -0,0 +1,177 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderListingCache.h"
+#include <algorithm>
+#include <string_view>
+
+FolderListingCache::FolderListingCache(size_t maxListings, size_t maxTotalItems) :
+	m_maxListings(maxListings),
+	m_maxTotalItems(maxTotalItems)
+{
+	CHECK_GT(m_maxListings, 0u);
+}
+
+void FolderListingCache::Store(const PidlAbsolute &folder, SHCONTF enumFlags,
+	std::vector<PidlChild> items, std::optional<Clock::duration> lifetime)
+{
+	std::scoped_lock lock(m_mutex);
+
+	auto &keyIndex = m_listings.get<ByKey>();
+	auto existingItr = keyIndex.find(std::make_tuple(folder, enumFlags));
+
+	if (existingItr != keyIndex.end())
+	{
+		m_numItems -= existingItr->items->size();
+		keyIndex.erase(existingItr);
+	}
+
+	if (items.size() > m_maxTotalItems)
+	{
+		return;
+	}
+
+	m_numItems += items.size();
+
+	std::optional<Clock::time_point> expiryTime;
+
+	if (lifetime)
+	{
+		expiryTime = Clock::now() + *lifetime;
+	}
+
+	auto &recencyIndex = m_listings.get<ByRecency>();
+	recencyIndex.push_front({ folder, enumFlags,
+		std::make_shared<const std::vector<PidlChild>>(std::move(items)), expiryTime });
+
+	RemoveExpiredListings();
+	RemoveLeastRecentlyUsedListings();
+}
+
+FolderListingCache::Items FolderListingCache::MaybeGet(const PidlAbsolute &folder,
+	SHCONTF enumFlags)
+{
+	std::scoped_lock lock(m_mutex);
+
+	auto &keyIndex = m_listings.get<ByKey>();
+	auto itr = keyIndex.find(std::make_tuple(folder, enumFlags));
+
+	if (itr == keyIndex.end())
+	{
+		return nullptr;
+	}
+
+	if (itr->IsExpired(Clock::now()))
+	{
+		m_numItems -= itr->items->size();
+		keyIndex.erase(itr);
+		return nullptr;
+	}
+
+	auto &recencyIndex = m_listings.get<ByRecency>();
+	recencyIndex.relocate(recencyIndex.begin(), m_listings.project<ByRecency>(itr));
+
+	return itr->items;
+}
+
+bool FolderListingCache::Contains(const PidlAbsolute &folder, SHCONTF enumFlags) const
+{
+	std::scoped_lock lock(m_mutex);
+
+	const auto &keyIndex = m_listings.get<ByKey>();
+	auto itr = keyIndex.find(std::make_tuple(folder, enumFlags));
+	return itr != keyIndex.end() && !itr->IsExpired(Clock::now());
+}
+
+void FolderListingCache::Invalidate(const PidlAbsolute &folder)
+{
+	std::scoped_lock lock(m_mutex);
+
+	auto &folderIndex = m_listings.get<ByFolder>();
+	auto [begin, end] = folderIndex.equal_range(folder);
+
+	for (auto itr = begin; itr != end; ++itr)
+	{
+		m_numItems -= itr->items->size();
+	}
+
+	folderIndex.erase(begin, end);
+}
+
+void FolderListingCache::Clear()
+{
+	std::scoped_lock lock(m_mutex);
+
+	m_listings.clear();
+	m_numItems = 0;
+}
+
+size_t FolderListingCache::GetNumListings() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_listings.size();
+}
+
+size_t FolderListingCache::GetNumItems() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_numItems;
+}
+
+void FolderListingCache::RemoveExpiredListings()
+{
+	auto now = Clock::now();
+	auto &recencyIndex = m_listings.get<ByRecency>();
+
+	for (auto itr = recencyIndex.begin(); itr != recencyIndex.end();)
+	{
+		if (itr->IsExpired(now))
+		{
+			m_numItems -= itr->items->size();
+			itr = recencyIndex.erase(itr);
+		}
+		else
+		{
+			++itr;
+		}
+	}
+}
+
+void FolderListingCache::RemoveLeastRecentlyUsedListings()
+{
+	auto &recencyIndex = m_listings.get<ByRecency>();
+
+	while (recencyIndex.size() > m_maxListings || m_numItems > m_maxTotalItems)
+	{
+		m_numItems -= recencyIndex.back().items->size();
+		recencyIndex.pop_back();
+	}
+}
+
+bool FolderListingCache::AreListingsEqual(const std::vector<PidlChild> &items1,
+	const std::vector<PidlChild> &items2)
+{
+	if (items1.size() != items2.size())
+	{
+		return false;
+	}
+
+	auto getSortedItemData = [](const std::vector<PidlChild> &items)
+	{
+		std::vector<std::string_view> itemData;
+		itemData.reserve(items.size());
+
+		for (const auto &item : items)
+		{
+			itemData.emplace_back(reinterpret_cast<const char *>(item.Raw()),
+				ILGetSize(item.Raw()));
+		}
+
+		std::ranges::sort(itemData);
+		return itemData;
+	};
+
+	return getSortedItemData(items1) == getSortedItemData(items2);
+}
@@ -0,0 +1,130 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/PidlHelper.h"
+#include <boost/core/noncopyable.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <ShObjIdl.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// A bounded cache of recently enumerated folder listings. Once a folder has been enumerated, its
+// listing is stored here, which allows a later navigation to the same folder (e.g. going back or
+// forward) to show the folder immediately, without having to wait for it to be enumerated again.
+//
+// A cached listing can be out of date. Listings are removed when a change to the folder is
+// detected, but changes can also be made while a folder isn't being monitored. A listing that's
+// been used should therefore be verified in the background.
+//
+// Each listing is keyed on both the folder and the enumeration flags, since the flags (e.g. whether
+// hidden items are included) affect which items are returned. When the cache is full, the least
+// recently used listings are removed. This class is thread-safe.
+class FolderListingCache : private boost::noncopyable
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using Items = std::shared_ptr<const std::vector<PidlChild>>;
+
+	static constexpr size_t DEFAULT_MAX_LISTINGS = 32;
+	static constexpr size_t DEFAULT_MAX_TOTAL_ITEMS = 25'000;
+
+	FolderListingCache(size_t maxListings = DEFAULT_MAX_LISTINGS,
+		size_t maxTotalItems = DEFAULT_MAX_TOTAL_ITEMS);
+
+	// Adds the listing, replacing any existing listing for the same folder and flags. A listing
+	// that contains more than the maximum total number of items won't be stored. If a lifetime is
+	// provided, the listing will expire once that amount of time has passed. That's useful for
+	// speculatively fetched listings, which might never be used.
+	void Store(const PidlAbsolute &folder, SHCONTF enumFlags, std::vector<PidlChild> items,
+		std::optional<Clock::duration> lifetime = std::nullopt);
+
+	// Returns the cached listing, if there is one. This also marks the listing as the most recently
+	// used.
+	Items MaybeGet(const PidlAbsolute &folder, SHCONTF enumFlags);
+
+	// Returns true if there's an unexpired listing for the folder. Unlike MaybeGet(), this doesn't
+	// affect the order in which listings are removed.
+	bool Contains(const PidlAbsolute &folder, SHCONTF enumFlags) const;
+
+	// Removes all listings for the specified folder.
+	void Invalidate(const PidlAbsolute &folder);
+	void Clear();
+
+	size_t GetNumListings() const;
+	size_t GetNumItems() const;
+
+	// Returns true if both listings contain the same set of items, irrespective of order. Items are
+	// compared byte-for-byte, so a change to an item's data (e.g. its size or modification date)
+	// will be detected.
+	static bool AreListingsEqual(const std::vector<PidlChild> &items1,
+		const std::vector<PidlChild> &items2);
+
+private:
+	struct Listing
+	{
+		PidlAbsolute folder;
+		SHCONTF enumFlags;
+		Items items;
+		std::optional<Clock::time_point> expiryTime;
+
+		bool IsExpired(Clock::time_point now) const
+		{
+			return expiryTime && now >= *expiryTime;
+		}
+	};
+
+	struct ByRecency
+	{
+	};
+
+	struct ByKey
+	{
+	};
+
+	struct ByFolder
+	{
+	};
+
+	// clang-format off
+	using Listings = boost::multi_index_container<Listing,
+		boost::multi_index::indexed_by<
+			// Listings are ordered from most recently used to least recently used.
+			boost::multi_index::sequenced<
+				boost::multi_index::tag<ByRecency>
+			>,
+			boost::multi_index::hashed_unique<
+				boost::multi_index::tag<ByKey>,
+				boost::multi_index::composite_key<
+					Listing,
+					boost::multi_index::member<Listing, PidlAbsolute, &Listing::folder>,
+					boost::multi_index::member<Listing, SHCONTF, &Listing::enumFlags>
+				>
+			>,
+			boost::multi_index::hashed_non_unique<
+				boost::multi_index::tag<ByFolder>,
+				boost::multi_index::member<Listing, PidlAbsolute, &Listing::folder>
+			>
+		>
+	>;
+	// clang-format on
+
+	void RemoveExpiredListings();
+	void RemoveLeastRecentlyUsedListings();
+
+	const size_t m_maxListings;
+	const size_t m_maxTotalItems;
+
+	mutable std::mutex m_mutex;
+	Listings m_listings;
+	size_t m_numItems = 0;
+};
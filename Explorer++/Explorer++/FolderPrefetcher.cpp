@@ -0,0 +1,147 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderPrefetcher.h"
+#include "FolderListingCache.h"
+#include "ShellEnumerator.h"
+#include "../Helper/ShellHelper.h"
+#include <algorithm>
+
+FolderPrefetcher::FolderPrefetcher(std::shared_ptr<FolderListingCache> listingCache,
+	std::shared_ptr<concurrencpp::executor> executor, FolderFilter folderFilter) :
+	m_listingCache(listingCache),
+	m_executor(executor),
+	m_folderFilter(folderFilter)
+{
+}
+
+FolderPrefetcher::~FolderPrefetcher()
+{
+	CancelAll();
+
+	// This will wait for any in-progress request to finish (which should happen quickly, since
+	// the request has been stopped above), so that no task can still be running once this class
+	// has been destroyed.
+	m_executor->shutdown();
+}
+
+void FolderPrefetcher::Prefetch(const PidlAbsolute &folder,
+	std::shared_ptr<const ShellEnumerator> shellEnumerator)
+{
+	if (m_listingCache->Contains(folder, shellEnumerator->GetEnumerationFlags()))
+	{
+		return;
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	auto itr = std::ranges::find_if(m_queuedRequests,
+		[&folder](const auto &request) { return request.folder == folder; });
+
+	if (itr != m_queuedRequests.end())
+	{
+		m_queuedRequests.erase(itr);
+	}
+
+	// The most recent request is the one most likely to be relevant, so it's processed first.
+	m_queuedRequests.push_front({ folder, shellEnumerator });
+
+	if (m_queuedRequests.size() > MAX_QUEUED_REQUESTS)
+	{
+		m_queuedRequests.pop_back();
+	}
+
+	MaybeStartNextRequest();
+}
+
+void FolderPrefetcher::CancelAll()
+{
+	std::scoped_lock lock(m_mutex);
+
+	m_queuedRequests.clear();
+
+	// Any in-progress request will continue to reference the previous stop source, so will be
+	// stopped.
+	m_stopSource.request_stop();
+	m_stopSource = {};
+}
+
+// Enumerating a network or removable folder can be slow and could, for example, cause a drive to
+// spin up. That's not something that should happen speculatively.
+bool FolderPrefetcher::IsLocalFixedDriveFolder(const PidlAbsolute &folder)
+{
+	SFGAOF attributes = SFGAO_FOLDER | SFGAO_FILESYSTEM | SFGAO_STREAM;
+	HRESULT hr = GetItemAttributes(folder.Raw(), &attributes);
+
+	if (FAILED(hr) || WI_IsAnyFlagClear(attributes, SFGAO_FOLDER | SFGAO_FILESYSTEM)
+		|| WI_IsFlagSet(attributes, SFGAO_STREAM))
+	{
+		return false;
+	}
+
+	std::wstring path;
+	hr = GetDisplayName(folder.Raw(), SHGDN_FORPARSING, path);
+
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	TCHAR root[MAX_PATH];
+	StringCchCopy(root, std::size(root), path.c_str());
+
+	if (!PathStripToRoot(root))
+	{
+		return false;
+	}
+
+	return GetDriveType(root) == DRIVE_FIXED;
+}
+
+size_t FolderPrefetcher::GetNumQueuedRequests() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_queuedRequests.size();
+}
+
+// The mutex should be held when calling this method.
+void FolderPrefetcher::MaybeStartNextRequest()
+{
+	if (m_requestInProgress || m_queuedRequests.empty())
+	{
+		return;
+	}
+
+	auto request = std::move(m_queuedRequests.front());
+	m_queuedRequests.pop_front();
+
+	m_requestInProgress = true;
+
+	m_executor->post([this, request = std::move(request), stopToken = m_stopSource.get_token()]
+		{ ProcessRequest(request, stopToken); });
+}
+
+void FolderPrefetcher::ProcessRequest(const Request &request, std::stop_token stopToken)
+{
+	auto enumFlags = request.shellEnumerator->GetEnumerationFlags();
+
+	// The folder may have been navigated to (and therefore cached) since this request was queued.
+	if (!stopToken.stop_requested() && !m_listingCache->Contains(request.folder, enumFlags)
+		&& (!m_folderFilter || m_folderFilter(request.folder)))
+	{
+		std::vector<PidlChild> items;
+		HRESULT hr =
+			request.shellEnumerator->EnumerateDirectory(request.folder.Raw(), items, stopToken);
+
+		if (SUCCEEDED(hr) && !stopToken.stop_requested() && items.size() <= MAX_ITEMS_PER_LISTING)
+		{
+			m_listingCache->Store(request.folder, enumFlags, std::move(items), LISTING_LIFETIME);
+		}
+	}
+
+	std::scoped_lock lock(m_mutex);
+	m_requestInProgress = false;
+	MaybeStartNextRequest();
+}
@@ -0,0 +1,84 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/PidlHelper.h"
+#include <boost/core/noncopyable.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+
+class FolderListingCache;
+class ShellEnumerator;
+
+// Speculatively enumerates folders the user is likely to navigate to next (e.g. the folder under
+// the mouse, or the parent folder), storing the results in the listing cache. If the user then
+// navigates to one of those folders, the navigation can be completed without waiting for the
+// folder to be enumerated.
+//
+// Since the work here is speculative, it's strictly limited:
+//
+// - Only a single folder is enumerated at a time, on the provided executor (which is expected to
+//   run at a low priority).
+// - Only a small number of requests are queued. More recent requests are processed first, with
+//   the oldest requests being dropped once the queue is full.
+// - Large listings aren't stored and stored listings expire after a short period of time.
+// - All requests can be cancelled (e.g. when the user navigates elsewhere), which will also stop
+//   any enumeration currently in progress.
+//
+// The methods here should all be called from the same thread.
+class FolderPrefetcher : private boost::noncopyable
+{
+public:
+	// Determines whether a folder can be prefetched. This is invoked on the executor, immediately
+	// before the folder would be enumerated, so it's fine for the check to be relatively slow
+	// (e.g. if it needs to query the folder's attributes).
+	using FolderFilter = std::function<bool(const PidlAbsolute &folder)>;
+
+	static constexpr size_t MAX_QUEUED_REQUESTS = 8;
+	static constexpr size_t MAX_ITEMS_PER_LISTING = 5'000;
+	static constexpr std::chrono::seconds LISTING_LIFETIME = std::chrono::seconds(60);
+
+	// The executor will be shut down when this instance is destroyed.
+	FolderPrefetcher(std::shared_ptr<FolderListingCache> listingCache,
+		std::shared_ptr<concurrencpp::executor> executor, FolderFilter folderFilter = nullptr);
+	~FolderPrefetcher();
+
+	// A filter that only allows folders on local, fixed drives to be prefetched.
+	static bool IsLocalFixedDriveFolder(const PidlAbsolute &folder);
+
+	// Queues the folder to be enumerated, using the provided enumerator. Folders that already have
+	// a listing in the cache are ignored.
+	void Prefetch(const PidlAbsolute &folder,
+		std::shared_ptr<const ShellEnumerator> shellEnumerator);
+
+	// Removes all queued requests and stops any enumeration that's in progress.
+	void CancelAll();
+
+	size_t GetNumQueuedRequests() const;
+
+private:
+	struct Request
+	{
+		PidlAbsolute folder;
+		std::shared_ptr<const ShellEnumerator> shellEnumerator;
+	};
+
+	void MaybeStartNextRequest();
+	void ProcessRequest(const Request &request, std::stop_token stopToken);
+
+	const std::shared_ptr<FolderListingCache> m_listingCache;
+	const std::shared_ptr<concurrencpp::executor> m_executor;
+	const FolderFilter m_folderFilter;
+
+	mutable std::mutex m_mutex;
+	std::deque<Request> m_queuedRequests;
+	bool m_requestInProgress = false;
+	std::stop_source m_stopSource;
+};
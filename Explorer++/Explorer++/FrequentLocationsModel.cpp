@@ -5,15 +5,25 @@
 #include "stdafx.h"
 #include "FrequentLocationsModel.h"
 
-FrequentLocationsModel::FrequentLocationsModel(SystemClock *systemClock) :
-	m_systemClock(systemClock)
+FrequentLocationsModel::FrequentLocationsModel(SystemClock *systemClock, size_t maxLocations) :
+	m_systemClock(systemClock),
+	m_maxLocations(maxLocations)
 {
+	CHECK_GT(m_maxLocations, 0u);
 }
 
 void FrequentLocationsModel::SetLocationVisits(const std::vector<LocationVisitInfo> &locationVisits)
 {
 	m_locationVisits.clear();
 	m_locationVisits.insert(locationVisits.begin(), locationVisits.end());
+
+	auto &frecencyIndex = m_locationVisits.get<ByFrecency>();
+
+	while (frecencyIndex.size() > m_maxLocations)
+	{
+		frecencyIndex.erase(std::prev(frecencyIndex.end()));
+	}
+
 	m_locationsChangedSignal();
 }
 
@@ -25,6 +35,7 @@ void FrequentLocationsModel::RegisterLocationVisit(const PidlAbsolute &pidl)
 	if (itr == locationIndex.end())
 	{
 		locationIndex.emplace(pidl, 1, m_systemClock->Now());
+		RemoveLowestRankedLocations(pidl);
 	}
 	else
 	{
@@ -35,9 +46,29 @@ void FrequentLocationsModel::RegisterLocationVisit(const PidlAbsolute &pidl)
 	m_locationsChangedSignal();
 }
 
-const FrequentLocationsModel::ByVisitsIndex &FrequentLocationsModel::GetVisits() const
+void FrequentLocationsModel::RemoveLowestRankedLocations(const PidlAbsolute &locationToKeep)
+{
+	auto &frecencyIndex = m_locationVisits.get<ByFrecency>();
+
+	while (frecencyIndex.size() > m_maxLocations)
+	{
+		auto itr = std::prev(frecencyIndex.end());
+
+		// A location that's just been visited for the first time could have the lowest frecency.
+		// It's not removed, since that would prevent any new location from ever being added once
+		// the model is full.
+		if (itr->GetLocation() == locationToKeep)
+		{
+			itr = std::prev(itr);
+		}
+
+		frecencyIndex.erase(itr);
+	}
+}
+
+const FrequentLocationsModel::ByFrecencyIndex &FrequentLocationsModel::GetVisits() const
 {
-	return m_locationVisits.get<ByVisits>();
+	return m_locationVisits.get<ByFrecency>();
 }
 
 boost::signals2::connection FrequentLocationsModel::AddLocationsChangedObserver(
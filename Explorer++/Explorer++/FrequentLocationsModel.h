@@ -13,7 +13,10 @@
 #include <boost/signals2.hpp>
 
 // Stores information about how often locations are visited. A sorted set of frequently visited
-// locations can be retrieved.
+// locations can be retrieved, with locations ranked by frecency (see LocationVisitInfo).
+//
+// The number of locations is bounded. Once the limit is reached, the location with the lowest
+// frecency is removed whenever a new location is added.
 class FrequentLocationsModel
 {
 public:
@@ -22,7 +25,7 @@ public:
 	// This struct and the one below are used as tags with the multi_index_container. That is, they
 	// allow specific indices to be accessed in a more descriptive way (rather than by the index
 	// order number).
-	struct ByVisits
+	struct ByFrecency
 	{
 	};
 
@@ -33,20 +36,22 @@ public:
 	// clang-format off
 	using LocationVisits = boost::multi_index_container<LocationVisitInfo,
 		boost::multi_index::indexed_by<
-			// An index of visits, sorted by visit count and then last visit time (when the visit
-			// counts are the same).
+			// An index of visits, sorted by frecency and then last visit time (when the frecency
+			// values are the same). Since the frecency key of a location only changes when it's
+			// visited, a visit only requires that single location to be repositioned.
 			boost::multi_index::ordered_non_unique<
-				boost::multi_index::tag<ByVisits>,
+				boost::multi_index::tag<ByFrecency>,
 				boost::multi_index::composite_key<
 					LocationVisitInfo,
-					boost::multi_index::const_mem_fun<LocationVisitInfo, int, &LocationVisitInfo::GetNumVisits>,
+					boost::multi_index::const_mem_fun<LocationVisitInfo, double,
+						&LocationVisitInfo::GetFrecencyKey>,
 					boost::multi_index::const_mem_fun<LocationVisitInfo, SystemClock::TimePoint,
 						&LocationVisitInfo::GetLastVisitTime>
 				>,
-				// Items are sorted in descending order of visit count (i.e. most visited first) and
-				// descending order of last visit time (i.e. most recently visited items first).
+				// Items are sorted in descending order of frecency and descending order of last
+				// visit time (i.e. most recently visited items first).
 				boost::multi_index::composite_key_compare<
-					std::greater<int>,
+					std::greater<double>,
 					std::greater<SystemClock::TimePoint>
 				>
 			>,
@@ -59,18 +64,26 @@ public:
 	>;
 	// clang-format on
 
-	using ByVisitsIndex = LocationVisits::index<ByVisits>::type;
+	using ByFrecencyIndex = LocationVisits::index<ByFrecency>::type;
 
-	FrequentLocationsModel(SystemClock *systemClock);
+	static constexpr size_t DEFAULT_MAX_LOCATIONS = 200;
+
+	FrequentLocationsModel(SystemClock *systemClock, size_t maxLocations = DEFAULT_MAX_LOCATIONS);
 
 	void SetLocationVisits(const std::vector<LocationVisitInfo> &locationVisits);
 	void RegisterLocationVisit(const PidlAbsolute &pidl);
-	const ByVisitsIndex &GetVisits() const;
+
+	// Returns the set of visits, ordered from highest to lowest frecency.
+	const ByFrecencyIndex &GetVisits() const;
+
 	boost::signals2::connection AddLocationsChangedObserver(
 		const LocationsChangedSignal::slot_type &observer);
 
 private:
+	void RemoveLowestRankedLocations(const PidlAbsolute &locationToKeep);
+
 	SystemClock *const m_systemClock;
+	const size_t m_maxLocations;
 	LocationVisits m_locationVisits;
 	LocationsChangedSignal m_locationsChangedSignal;
 };
@@ -9,6 +9,7 @@
 #include "LocationVisitInfo.h"
 #include "../Helper/RegistrySettings.h"
 #include <wil/registry.h>
+#include <bit>
 #include <optional>
 #include <vector>
 
@@ -20,6 +21,7 @@ constexpr wchar_t FREQUENT_LOCATIONS_KEY_PATH[] = L"FrequentLocations";
 constexpr wchar_t SETTING_LOCATION[] = L"Location";
 constexpr wchar_t SETTING_NUM_VISITS[] = L"NumVisits";
 constexpr wchar_t SETTING_LAST_VISIT_TIME[] = L"LastVisitTime";
+constexpr wchar_t SETTING_FRECENCY[] = L"Frecency";
 
 std::optional<LocationVisitInfo> LoadFrequentLocation(HKEY frequentLocationsKey)
 {
@@ -49,9 +51,22 @@ std::optional<LocationVisitInfo> LoadFrequentLocation(HKEY frequentLocationsKey)
 		return std::nullopt;
 	}
 
-	return LocationVisitInfo{ pidl, numVisits,
-		SystemClock::TimePoint(
-			FrequentLocationsStorageHelper::StorageDurationType(timeSinceEpoch)) };
+	SystemClock::TimePoint lastVisitTime(
+		FrequentLocationsStorageHelper::StorageDurationType(timeSinceEpoch));
+
+	// The frecency value is stored as the raw bits of the double. It won't be present in data
+	// saved by older versions, in which case it will be derived from the visit count and time.
+	uint64_t frecencyBits;
+	res = RegistrySettings::Read64BitValueFromRegistry(frequentLocationsKey, SETTING_FRECENCY,
+		frecencyBits);
+
+	if (res != ERROR_SUCCESS)
+	{
+		return LocationVisitInfo{ pidl, numVisits, lastVisitTime };
+	}
+
+	return LocationVisitInfo{ pidl, numVisits, lastVisitTime,
+		std::bit_cast<double>(frecencyBits) };
 };
 
 void LoadFromKey(HKEY frequentLocationsKey, FrequentLocationsModel *model)
@@ -86,6 +101,8 @@ void SaveFrequentLocation(HKEY frequentLocationKey, const LocationVisitInfo &fre
 		std::chrono::duration_cast<FrequentLocationsStorageHelper::StorageDurationType>(
 			frequentLocation.GetLastVisitTime().time_since_epoch())
 			.count());
+	RegistrySettings::SaveQword(frequentLocationKey, SETTING_FRECENCY,
+		std::bit_cast<uint64_t>(frequentLocation.GetFrecencyKey()));
 }
 
 void SaveToKey(HKEY frequentLocationsKey, const FrequentLocationsModel *model)
@@ -15,6 +15,8 @@ namespace FrequentLocationsStorageHelper
 // As this value is used when saving/loading visit time data, it shouldn't be changed.
 using StorageDurationType = std::chrono::microseconds;
 
-inline constexpr int MAX_ITEMS_TO_STORE = 50;
+// Matches the default size of FrequentLocationsModel, so that the frecency of every location is
+// retained between sessions.
+inline constexpr int MAX_ITEMS_TO_STORE = 200;
 
 }
@@ -12,6 +12,7 @@
 #include "../Helper/XMLSettings.h"
 #include <boost/lexical_cast.hpp>
 #include <wil/com.h>
+#include <format>
 #include <optional>
 #include <vector>
 
@@ -24,6 +25,7 @@ constexpr wchar_t FREQUENT_LOCATION_NODE_NAME[] = L"FrequentLocation";
 constexpr wchar_t SETTING_LOCATION[] = L"Location";
 constexpr wchar_t SETTING_NUM_VISITS[] = L"NumVisits";
 constexpr wchar_t SETTING_LAST_VISIT_TIME[] = L"LastVisitTime";
+constexpr wchar_t SETTING_FRECENCY[] = L"Frecency";
 
 std::optional<LocationVisitInfo> LoadFrequentLocation(IXMLDOMNode *frequentLocationNode)
 {
@@ -87,9 +89,27 @@ std::optional<LocationVisitInfo> LoadFrequentLocation(IXMLDOMNode *frequentLocat
 		return std::nullopt;
 	}
 
-	return LocationVisitInfo{ pidl, numVisits,
-		SystemClock::TimePoint(
-			FrequentLocationsStorageHelper::StorageDurationType(timeSinceEpoch)) };
+	SystemClock::TimePoint lastVisitTime(
+		FrequentLocationsStorageHelper::StorageDurationType(timeSinceEpoch));
+
+	// The frecency value won't be present in older config files. In that case, it will be derived
+	// from the visit count and time.
+	std::wstring frecencyText;
+	hr = XMLSettings::GetStringFromMap(attributeMap.get(), SETTING_FRECENCY, frecencyText);
+
+	if (hr == S_OK)
+	{
+		try
+		{
+			return LocationVisitInfo{ pidl, numVisits, lastVisitTime,
+				boost::lexical_cast<double>(frecencyText) };
+		}
+		catch (const boost::bad_lexical_cast &)
+		{
+		}
+	}
+
+	return LocationVisitInfo{ pidl, numVisits, lastVisitTime };
 }
 
 void LoadFromNode(IXMLDOMNode *frequentLocationsNode, FrequentLocationsModel *model)
@@ -139,6 +159,10 @@ void SaveFrequentLocation(IXMLDOMDocument *xmlDocument, IXMLDOMElement *frequent
 			std::chrono::duration_cast<FrequentLocationsStorageHelper::StorageDurationType>(
 				frequentLocation.GetLastVisitTime().time_since_epoch())
 				.count()));
+
+	// This format is the shortest representation that will produce the same value when read back.
+	XMLSettings::AddAttributeToNode(xmlDocument, frequentLocationNode, SETTING_FRECENCY,
+		std::format(L"{}", frequentLocation.GetFrecencyKey()));
 }
 
 void SaveToNode(IXMLDOMDocument *xmlDocument, IXMLDOMElement *frequentLocationsNode,
@@ -5,26 +5,103 @@
 #include "stdafx.h"
 #include "HistoryMenu.h"
 #include "HistoryModel.h"
+#include <algorithm>
 
 HistoryMenu::HistoryMenu(MenuView *menuView, const AcceleratorManager *acceleratorManager,
 	HistoryModel *historyModel, BrowserWindow *browserWindow, ShellIconLoader *shellIconLoader,
 	UINT startId, UINT endId) :
-	ShellItemsMenu(menuView, acceleratorManager, GetHistoryItems(historyModel), browserWindow,
-		shellIconLoader, startId, endId),
+	ShellItemsMenu(menuView, acceleratorManager, {}, browserWindow, shellIconLoader, startId,
+		endId),
 	m_historyModel(historyModel)
 {
-	m_connections.push_back(m_historyModel->AddHistoryChangedObserver(
-		std::bind_front(&HistoryMenu::OnHistoryChanged, this)));
+	RebuildFromHistory();
+
+	m_connections.push_back(m_historyModel->AddItemAddedObserver(
+		std::bind_front(&HistoryMenu::OnItemAdded, this)));
+	m_connections.push_back(m_historyModel->AddItemMovedToFrontObserver(
+		std::bind_front(&HistoryMenu::OnItemMovedToFront, this)));
+	m_connections.push_back(m_historyModel->AddItemRemovedObserver(
+		std::bind_front(&HistoryMenu::OnItemRemoved, this)));
+	m_connections.push_back(m_historyModel->AddHistoryReplacedObserver(
+		std::bind_front(&HistoryMenu::RebuildFromHistory, this)));
+}
+
+void HistoryMenu::RebuildFromHistory()
+{
+	RebuildMenu({});
+	m_entries.clear();
+
+	const auto &historyItems = m_historyModel->GetHistoryItems();
+	auto end = std::next(historyItems.begin(),
+		std::min(historyItems.size(), MAX_MENU_ITEMS));
+
+	// Items are prepended, so the least recent item needs to be added first.
+	for (auto itr = end; itr != historyItems.begin();)
+	{
+		--itr;
+		PrependEntry(*itr);
+	}
+}
+
+void HistoryMenu::OnItemAdded(const PidlAbsolute &item)
+{
+	PrependEntry(item);
+}
+
+void HistoryMenu::OnItemMovedToFront(const PidlAbsolute &item)
+{
+	auto itr = FindEntry(item);
+
+	if (itr != m_entries.end())
+	{
+		RemoveEntry(itr);
+	}
+
+	PrependEntry(item);
+}
+
+void HistoryMenu::OnItemRemoved(const PidlAbsolute &item)
+{
+	// Only the least recent item in the history is removed, so in most cases, it won't be shown
+	// in the menu.
+	auto itr = FindEntry(item);
+
+	if (itr != m_entries.end())
+	{
+		RemoveEntry(itr);
+	}
+}
+
+void HistoryMenu::PrependEntry(const PidlAbsolute &item)
+{
+	// The oldest item is removed first, so that its ID can be reused.
+	TrimEntries(MAX_MENU_ITEMS - 1);
+
+	auto id = PrependItem(item);
+
+	if (!id)
+	{
+		return;
+	}
+
+	m_entries.push_front({ &item, *id });
+}
+
+void HistoryMenu::RemoveEntry(std::deque<Entry>::iterator itr)
+{
+	RemoveItem(itr->id);
+	m_entries.erase(itr);
 }
 
-void HistoryMenu::OnHistoryChanged()
+void HistoryMenu::TrimEntries(size_t maxEntries)
 {
-	RebuildMenu(GetHistoryItems(m_historyModel));
+	while (m_entries.size() > maxEntries)
+	{
+		RemoveEntry(std::prev(m_entries.end()));
+	}
 }
 
-std::vector<PidlAbsolute> HistoryMenu::GetHistoryItems(const HistoryModel *historyModel)
+std::deque<HistoryMenu::Entry>::iterator HistoryMenu::FindEntry(const PidlAbsolute &item)
 {
-	const auto &history = historyModel->GetHistoryItems();
-	std::vector<PidlAbsolute> historyVector({ history.begin(), history.end() });
-	return historyVector;
+	return std::ranges::find(m_entries, &item, &Entry::item);
 }
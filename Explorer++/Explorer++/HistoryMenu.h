@@ -5,10 +5,11 @@
 #pragma once
 
 #include "ShellItemsMenu.h"
+#include <deque>
 
 class HistoryModel;
 
-// Displays the set of global history entries.
+// Displays the most recent global history entries.
 class HistoryMenu : public ShellItemsMenu
 {
 public:
@@ -17,9 +18,30 @@ public:
 		UINT startId = DEFAULT_START_ID, UINT endId = DEFAULT_END_ID);
 
 private:
-	void OnHistoryChanged();
-	static std::vector<PidlAbsolute> GetHistoryItems(const HistoryModel *historyModel);
+	// The full history can be very large, so only the most recent items are shown.
+	static constexpr size_t MAX_MENU_ITEMS = 20;
+
+	struct Entry
+	{
+		// The item stored in the history model, which remains valid until it's removed.
+		const PidlAbsolute *item;
+		UINT id;
+	};
+
+	void RebuildFromHistory();
+	void OnItemAdded(const PidlAbsolute &item);
+	void OnItemMovedToFront(const PidlAbsolute &item);
+	void OnItemRemoved(const PidlAbsolute &item);
+	void PrependEntry(const PidlAbsolute &item);
+	void RemoveEntry(std::deque<Entry>::iterator itr);
+	void TrimEntries(size_t maxEntries);
+	std::deque<Entry>::iterator FindEntry(const PidlAbsolute &item);
 
 	HistoryModel *const m_historyModel;
+
+	// The items shown in the menu, most recent first. The menu is updated one item at a time as the
+	// history changes, rather than being rebuilt each time an item is added.
+	std::deque<Entry> m_entries;
+
 	std::vector<boost::signals2::scoped_connection> m_connections;
 };
@@ -6,21 +6,89 @@
 #include "HistoryModel.h"
 #include "../Helper/ShellHelper.h"
 
+HistoryModel::HistoryModel(size_t maxItems) : m_maxItems(maxItems)
+{
+	CHECK_GT(m_maxItems, 0u);
+}
+
 void HistoryModel::AddHistoryItem(const PidlAbsolute &pidl)
 {
-	if (!m_historyItems.empty() && (pidl == m_historyItems.front()))
+	auto &recencyIndex = m_historyItems.get<ByRecency>();
+
+	if (!recencyIndex.empty() && (pidl == recencyIndex.front()))
 	{
 		// This item is the same as the most recent history item.
 		return;
 	}
 
-	m_historyItems.push_front(pidl);
+	auto &locationIndex = m_historyItems.get<ByLocation>();
+	auto existingItr = locationIndex.find(pidl);
+
+	if (existingItr != locationIndex.end())
+	{
+		// The item is already in the history, so it only needs to be moved to the front.
+		recencyIndex.relocate(recencyIndex.begin(), m_historyItems.project<ByRecency>(existingItr));
+		m_itemMovedToFrontSignal(*existingItr);
+	}
+	else
+	{
+		auto [itr, inserted] = recencyIndex.push_front(pidl);
+		DCHECK(inserted);
+
+		m_itemAddedSignal(*itr);
+
+		RemoveLeastRecentItems();
+	}
+
 	m_historyChangedSignal();
 }
 
-const std::deque<PidlAbsolute> &HistoryModel::GetHistoryItems() const
+void HistoryModel::SetHistoryItems(const std::vector<PidlAbsolute> &pidls)
+{
+	m_historyItems.clear();
+
+	auto &recencyIndex = m_historyItems.get<ByRecency>();
+
+	for (const auto &pidl : pidls)
+	{
+		if (recencyIndex.size() == m_maxItems)
+		{
+			break;
+		}
+
+		// Any duplicate items will be ignored, since the earlier (i.e. more recent) entry takes
+		// precedence.
+		recencyIndex.push_back(pidl);
+	}
+
+	m_historyReplacedSignal();
+	m_historyChangedSignal();
+}
+
+const HistoryModel::ByRecencyIndex &HistoryModel::GetHistoryItems() const
+{
+	return m_historyItems.get<ByRecency>();
+}
+
+size_t HistoryModel::GetMaxItems() const
+{
+	return m_maxItems;
+}
+
+void HistoryModel::RemoveLeastRecentItems()
+{
+	auto &recencyIndex = m_historyItems.get<ByRecency>();
+
+	while (recencyIndex.size() > m_maxItems)
+	{
+		RemoveItem(std::prev(recencyIndex.end()));
+	}
+}
+
+void HistoryModel::RemoveItem(ByRecencyIndex::iterator itr)
 {
-	return m_historyItems;
+	m_itemRemovedSignal(*itr);
+	m_historyItems.get<ByRecency>().erase(itr);
 }
 
 boost::signals2::connection HistoryModel::AddHistoryChangedObserver(
@@ -28,3 +96,27 @@ boost::signals2::connection HistoryModel::AddHistoryChangedObserver(
 {
 	return m_historyChangedSignal.connect(observer);
 }
+
+boost::signals2::connection HistoryModel::AddItemAddedObserver(
+	const ItemAddedSignal::slot_type &observer)
+{
+	return m_itemAddedSignal.connect(observer);
+}
+
+boost::signals2::connection HistoryModel::AddItemMovedToFrontObserver(
+	const ItemMovedToFrontSignal::slot_type &observer)
+{
+	return m_itemMovedToFrontSignal.connect(observer);
+}
+
+boost::signals2::connection HistoryModel::AddItemRemovedObserver(
+	const ItemRemovedSignal::slot_type &observer)
+{
+	return m_itemRemovedSignal.connect(observer);
+}
+
+boost::signals2::connection HistoryModel::AddHistoryReplacedObserver(
+	const HistoryReplacedSignal::slot_type &observer)
+{
+	return m_historyReplacedSignal.connect(observer);
+}
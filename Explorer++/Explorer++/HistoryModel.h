@@ -5,24 +5,102 @@
 #pragma once
 
 #include "../Helper/PidlHelper.h"
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/random_access_index.hpp>
+#include <boost/multi_index_container.hpp>
 #include <boost/signals2.hpp>
-#include <deque>
+#include <vector>
 
 // Stores global history (i.e. the history of navigations across all tabs).
+//
+// The history is bounded; once it's full, the least recently visited item is dropped whenever a new
+// item is added. Each location appears at most once, so navigating to a location that's already in
+// the history simply moves it to the front.
 class HistoryModel
 {
 public:
 	using HistoryChangedSignal = boost::signals2::signal<void()>;
 
+	// The item passed to each of these signals is the one stored in the history. Its address
+	// remains valid until the item is removed, so observers can use it to identify the item.
+	using ItemAddedSignal = boost::signals2::signal<void(const PidlAbsolute &item)>;
+	using ItemMovedToFrontSignal = boost::signals2::signal<void(const PidlAbsolute &item)>;
+	using ItemRemovedSignal = boost::signals2::signal<void(const PidlAbsolute &item)>;
+	using HistoryReplacedSignal = boost::signals2::signal<void()>;
+
+	// These structs are used as tags with the multi_index_container below.
+	struct ByRecency
+	{
+	};
+
+	struct ByLocation
+	{
+	};
+
+	// clang-format off
+	using HistoryItems = boost::multi_index_container<PidlAbsolute,
+		boost::multi_index::indexed_by<
+			// The items, ordered from most to least recent. Random access allows the position of
+			// any item to be determined in constant time.
+			boost::multi_index::random_access<
+				boost::multi_index::tag<ByRecency>
+			>,
+			boost::multi_index::hashed_unique<
+				boost::multi_index::tag<ByLocation>,
+				boost::multi_index::identity<PidlAbsolute>
+			>
+		>
+	>;
+	// clang-format on
+
+	using ByRecencyIndex = HistoryItems::index<ByRecency>::type;
+
+	static constexpr size_t DEFAULT_MAX_ITEMS = 2000;
+
+	explicit HistoryModel(size_t maxItems = DEFAULT_MAX_ITEMS);
+
 	void AddHistoryItem(const PidlAbsolute &pidl);
 
+	// Replaces the existing history. The items should be ordered from most to least recent.
+	void SetHistoryItems(const std::vector<PidlAbsolute> &pidls);
+
 	// Returns the set of history items, with more recent items appearing first.
-	const std::deque<PidlAbsolute> &GetHistoryItems() const;
+	const ByRecencyIndex &GetHistoryItems() const;
 
+	size_t GetMaxItems() const;
+
+	// Triggered after any change to the history.
 	boost::signals2::connection AddHistoryChangedObserver(
 		const HistoryChangedSignal::slot_type &observer);
 
+	// The signals below describe individual changes, so that observers can update incrementally.
+	// Each is triggered before the history changed signal for the same change.
+
+	// Triggered when a new item is added to the front of the history.
+	boost::signals2::connection AddItemAddedObserver(const ItemAddedSignal::slot_type &observer);
+
+	// Triggered when an item that's already in the history is moved to the front.
+	boost::signals2::connection AddItemMovedToFrontObserver(
+		const ItemMovedToFrontSignal::slot_type &observer);
+
+	// Triggered immediately before an item is removed, once the history is full.
+	boost::signals2::connection AddItemRemovedObserver(
+		const ItemRemovedSignal::slot_type &observer);
+
+	// Triggered when the entire history is replaced.
+	boost::signals2::connection AddHistoryReplacedObserver(
+		const HistoryReplacedSignal::slot_type &observer);
+
 private:
-	std::deque<PidlAbsolute> m_historyItems;
+	void RemoveLeastRecentItems();
+	void RemoveItem(ByRecencyIndex::iterator itr);
+
+	const size_t m_maxItems;
+	HistoryItems m_historyItems;
 	HistoryChangedSignal m_historyChangedSignal;
+	ItemAddedSignal m_itemAddedSignal;
+	ItemMovedToFrontSignal m_itemMovedToFrontSignal;
+	ItemRemovedSignal m_itemRemovedSignal;
+	HistoryReplacedSignal m_historyReplacedSignal;
 };
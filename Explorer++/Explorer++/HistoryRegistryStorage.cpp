@@ -0,0 +1,94 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "HistoryRegistryStorage.h"
+#include "HistoryModel.h"
+#include "../Helper/RegistrySettings.h"
+#include <wil/registry.h>
+#include <vector>
+
+namespace
+{
+
+constexpr wchar_t HISTORY_KEY_PATH[] = L"History";
+
+constexpr wchar_t SETTING_LOCATION[] = L"Location";
+
+void LoadFromKey(HKEY historyKey, HistoryModel *model)
+{
+	std::vector<PidlAbsolute> historyItems;
+	wil::unique_hkey childKey;
+	int index = 0;
+
+	while (SUCCEEDED(wil::reg::open_unique_key_nothrow(historyKey, std::to_wstring(index).c_str(),
+		childKey)))
+	{
+		PidlAbsolute pidl;
+		auto res = RegistrySettings::ReadPidl(childKey.get(), SETTING_LOCATION, pidl);
+
+		if (res == ERROR_SUCCESS)
+		{
+			historyItems.push_back(pidl);
+		}
+
+		index++;
+	}
+
+	model->SetHistoryItems(historyItems);
+}
+
+void SaveToKey(HKEY historyKey, const HistoryModel *model)
+{
+	size_t index = 0;
+
+	for (const auto &pidl : model->GetHistoryItems())
+	{
+		wil::unique_hkey childKey;
+		HRESULT hr = wil::reg::create_unique_key_nothrow(historyKey,
+			std::to_wstring(index).c_str(), childKey, wil::reg::key_access::readwrite);
+
+		if (SUCCEEDED(hr))
+		{
+			RegistrySettings::SavePidl(childKey.get(), SETTING_LOCATION, pidl.Raw());
+
+			index++;
+		}
+	}
+}
+
+}
+
+namespace HistoryRegistryStorage
+{
+
+void Load(HKEY applicationKey, HistoryModel *model)
+{
+	wil::unique_hkey historyKey;
+	HRESULT hr = wil::reg::open_unique_key_nothrow(applicationKey, HISTORY_KEY_PATH, historyKey,
+		wil::reg::key_access::read);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	LoadFromKey(historyKey.get(), model);
+}
+
+void Save(HKEY applicationKey, const HistoryModel *model)
+{
+	wil::unique_hkey historyKey;
+	HRESULT hr = wil::reg::create_unique_key_nothrow(applicationKey, HISTORY_KEY_PATH, historyKey,
+		wil::reg::key_access::readwrite);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	SaveToKey(historyKey.get(), model);
+}
+
+}
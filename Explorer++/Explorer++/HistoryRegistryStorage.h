@@ -0,0 +1,15 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+class HistoryModel;
+
+namespace HistoryRegistryStorage
+{
+
+void Load(HKEY applicationKey, HistoryModel *model);
+void Save(HKEY applicationKey, const HistoryModel *model);
+
+}
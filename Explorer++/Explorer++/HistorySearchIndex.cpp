@@ -0,0 +1,208 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "HistorySearchIndex.h"
+#include "HistoryModel.h"
+#include "../Helper/ShellHelper.h"
+#include <algorithm>
+#include <ranges>
+
+HistorySearchIndex::HistorySearchIndex(HistoryModel *historyModel, TaskScheduler *taskScheduler,
+	std::shared_ptr<concurrencpp::executor> uiThreadExecutor) :
+	m_historyModel(historyModel),
+	m_taskScheduler(taskScheduler),
+	m_uiThreadExecutor(uiThreadExecutor),
+	m_taskGroup(taskScheduler->CreateGroup()),
+	m_index({ NAME_WEIGHT, PATH_WEIGHT })
+{
+	// Moving an item to the front of the history doesn't change its names, so there's nothing
+	// that needs to be done in that case.
+	m_connections.push_back(m_historyModel->AddItemAddedObserver(
+		std::bind_front(&HistorySearchIndex::QueueItem, this)));
+	m_connections.push_back(m_historyModel->AddItemRemovedObserver(
+		std::bind_front(&HistorySearchIndex::RemoveItem, this)));
+	m_connections.push_back(m_historyModel->AddHistoryReplacedObserver(
+		std::bind_front(&HistorySearchIndex::IndexAllItems, this)));
+
+	IndexAllItems();
+}
+
+HistorySearchIndex::~HistorySearchIndex()
+{
+	m_taskScheduler->CancelGroup(m_taskGroup);
+}
+
+void HistorySearchIndex::IndexAllItems()
+{
+	// Any results that are still outstanding are for the previous set of items, so there's no need
+	// to retrieve them.
+	m_taskGroup = m_taskScheduler->ReplaceGroup(m_taskGroup);
+
+	m_index.Clear();
+	m_itemToDocumentIdMap.clear();
+	m_documentIdToItemMap.clear();
+	m_queuedItems.clear();
+
+	for (const auto &item : m_historyModel->GetHistoryItems())
+	{
+		QueueItem(item);
+	}
+}
+
+void HistorySearchIndex::QueueItem(const PidlAbsolute &item)
+{
+	// Document IDs are never reused. That means that a result for an item that's since been
+	// removed can't accidentally be applied to a different item.
+	auto documentId = m_nextDocumentId++;
+
+	auto [itr, didInsert] = m_itemToDocumentIdMap.insert({ &item, documentId });
+	CHECK(didInsert);
+
+	m_documentIdToItemMap.insert({ documentId, &item });
+
+	m_queuedItems.push_back({ documentId, item });
+	ScheduleQueuedItemsSubmission();
+}
+
+void HistorySearchIndex::RemoveItem(const PidlAbsolute &item)
+{
+	auto itr = m_itemToDocumentIdMap.find(&item);
+	CHECK(itr != m_itemToDocumentIdMap.end());
+
+	// If the names for this item are still being retrieved, the result will be ignored once it
+	// arrives, since the document ID will no longer be mapped.
+	m_index.RemoveDocument(itr->second);
+	m_documentIdToItemMap.erase(itr->second);
+	m_itemToDocumentIdMap.erase(itr);
+}
+
+void HistorySearchIndex::ScheduleQueuedItemsSubmission()
+{
+	if (m_queuedItemsSubmissionScheduled)
+	{
+		return;
+	}
+
+	m_queuedItemsSubmissionScheduled = true;
+
+	m_uiThreadExecutor->post(
+		[weakSelf = m_weakPtrFactory.GetWeakPtr()]
+		{
+			if (weakSelf)
+			{
+				weakSelf->SubmitQueuedItems();
+			}
+		});
+}
+
+void HistorySearchIndex::SubmitQueuedItems()
+{
+	m_queuedItemsSubmissionScheduled = false;
+
+	auto queuedItems = std::exchange(m_queuedItems, {});
+
+	for (size_t i = 0; i < queuedItems.size(); i += BATCH_SIZE)
+	{
+		auto batchStart = queuedItems.begin() + i;
+		auto batchEnd = queuedItems.begin() + std::min(i + BATCH_SIZE, queuedItems.size());
+
+		m_taskScheduler->Push(m_taskGroup, TaskScheduler::Priority::Background,
+			[items = std::vector<PendingItem>(batchStart, batchEnd),
+				uiThreadExecutor = m_uiThreadExecutor, weakSelf = m_weakPtrFactory.GetWeakPtr()]
+			{
+				uiThreadExecutor->post(
+					[retrievedItems = RetrieveItems(items), weakSelf]
+					{
+						if (weakSelf)
+						{
+							weakSelf->OnItemsRetrieved(retrievedItems);
+						}
+					});
+			});
+	}
+}
+
+std::vector<HistorySearchIndex::RetrievedItem> HistorySearchIndex::RetrieveItems(
+	const std::vector<PendingItem> &items)
+{
+	std::vector<RetrievedItem> retrievedItems;
+	retrievedItems.reserve(items.size());
+
+	for (const auto &item : items)
+	{
+		retrievedItems.push_back({ item.documentId,
+			GetDisplayNameWithFallback(item.pidl.Raw(), SHGDN_INFOLDER),
+			GetDisplayNameWithFallback(item.pidl.Raw(), SHGDN_FORPARSING) });
+	}
+
+	return retrievedItems;
+}
+
+void HistorySearchIndex::OnItemsRetrieved(const std::vector<RetrievedItem> &retrievedItems)
+{
+	for (const auto &retrievedItem : retrievedItems)
+	{
+		if (!m_documentIdToItemMap.contains(retrievedItem.documentId))
+		{
+			// The item was removed while its names were being retrieved.
+			continue;
+		}
+
+		m_index.SetDocument(retrievedItem.documentId, { retrievedItem.name, retrievedItem.path });
+	}
+}
+
+std::vector<PidlAbsolute> HistorySearchIndex::Search(std::wstring_view query,
+	size_t maxResults) const
+{
+	// The index orders matches with equal scores by document ID. Since items are ranked by recency
+	// here, all the matches are retrieved, so that they can be reordered.
+	auto matches = m_index.Search(query, m_index.GetNumDocuments());
+
+	struct RankedItem
+	{
+		const PidlAbsolute *item;
+		double score;
+		size_t position;
+	};
+
+	const auto &historyItems = m_historyModel->GetHistoryItems();
+	std::vector<RankedItem> rankedItems;
+	rankedItems.reserve(matches.size());
+
+	for (const auto &match : matches)
+	{
+		const auto *item = m_documentIdToItemMap.at(match.documentId);
+		auto position = static_cast<size_t>(historyItems.iterator_to(*item) - historyItems.begin());
+		rankedItems.push_back({ item, match.score, position });
+	}
+
+	size_t numResults = std::min(maxResults, rankedItems.size());
+	std::partial_sort(rankedItems.begin(), rankedItems.begin() + numResults, rankedItems.end(),
+		[](const RankedItem &first, const RankedItem &second)
+		{
+			if (first.score != second.score)
+			{
+				return first.score > second.score;
+			}
+
+			return first.position < second.position;
+		});
+
+	std::vector<PidlAbsolute> results;
+	results.reserve(numResults);
+
+	for (const auto &rankedItem : rankedItems | std::views::take(numResults))
+	{
+		results.push_back(*rankedItem.item);
+	}
+
+	return results;
+}
+
+size_t HistorySearchIndex::GetNumPendingItems() const
+{
+	return m_itemToDocumentIdMap.size() - m_index.GetNumDocuments();
+}
@@ -0,0 +1,93 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "TaskScheduler.h"
+#include "../Helper/PidlHelper.h"
+#include "../Helper/TrigramIndex.h"
+#include "../Helper/WeakPtrFactory.h"
+#include <boost/core/noncopyable.hpp>
+#include <boost/signals2.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class HistoryModel;
+
+// Maintains a search index over the names and paths of the items in a HistoryModel.
+//
+// Indexing an item requires its display names, which can be slow to retrieve (e.g. for an item on a
+// network share). So the names are retrieved in the background, via the TaskScheduler, and the
+// results are then added to the index on the UI thread. An item won't appear in search results
+// until its names have been retrieved.
+//
+// This class should be used from the UI thread.
+class HistorySearchIndex : private boost::noncopyable
+{
+public:
+	HistorySearchIndex(HistoryModel *historyModel, TaskScheduler *taskScheduler,
+		std::shared_ptr<concurrencpp::executor> uiThreadExecutor);
+	~HistorySearchIndex();
+
+	// Returns up to maxResults items whose name or path matches the query. Small typos are
+	// tolerated. Better matches are ranked first, with more recent items ranked ahead of older
+	// items that match equally well.
+	std::vector<PidlAbsolute> Search(std::wstring_view query, size_t maxResults) const;
+
+	// Returns the number of items whose names are still being retrieved.
+	size_t GetNumPendingItems() const;
+
+private:
+	// A match on the name of an item is considered more relevant than a match on its path.
+	static constexpr double NAME_WEIGHT = 2.0;
+	static constexpr double PATH_WEIGHT = 1.0;
+
+	// Items are processed in batches, so that indexing a large history doesn't require a separate
+	// task (and a separate result posted back to the UI thread) for every item.
+	static constexpr size_t BATCH_SIZE = 64;
+
+	struct PendingItem
+	{
+		TrigramIndex::DocumentId documentId;
+		PidlAbsolute pidl;
+	};
+
+	struct RetrievedItem
+	{
+		TrigramIndex::DocumentId documentId;
+		std::wstring name;
+		std::wstring path;
+	};
+
+	void IndexAllItems();
+	void QueueItem(const PidlAbsolute &item);
+	void RemoveItem(const PidlAbsolute &item);
+	void ScheduleQueuedItemsSubmission();
+	void SubmitQueuedItems();
+	static std::vector<RetrievedItem> RetrieveItems(const std::vector<PendingItem> &items);
+	void OnItemsRetrieved(const std::vector<RetrievedItem> &retrievedItems);
+
+	HistoryModel *const m_historyModel;
+	TaskScheduler *const m_taskScheduler;
+	const std::shared_ptr<concurrencpp::executor> m_uiThreadExecutor;
+	std::shared_ptr<TaskScheduler::Group> m_taskGroup;
+
+	// The items in the history are never moved, so they can be referred to by address.
+	TrigramIndex m_index;
+	TrigramIndex::DocumentId m_nextDocumentId = 0;
+	std::unordered_map<const PidlAbsolute *, TrigramIndex::DocumentId> m_itemToDocumentIdMap;
+	std::unordered_map<TrigramIndex::DocumentId, const PidlAbsolute *> m_documentIdToItemMap;
+
+	// Items that have been added, but not yet submitted to the TaskScheduler. Items added in quick
+	// succession (e.g. while the history is being built) are submitted together.
+	std::vector<PendingItem> m_queuedItems;
+	bool m_queuedItemsSubmissionScheduled = false;
+
+	std::vector<boost::signals2::scoped_connection> m_connections;
+	WeakPtrFactory<HistorySearchIndex> m_weakPtrFactory{ this };
+};
@@ -0,0 +1,138 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "HistoryXmlStorage.h"
+#include "HistoryModel.h"
+#include "../Helper/PidlHelper.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/XMLSettings.h"
+#include <wil/com.h>
+#include <vector>
+
+namespace
+{
+
+constexpr wchar_t HISTORY_NODE_NAME[] = L"History";
+constexpr wchar_t HISTORY_ITEM_NODE_NAME[] = L"HistoryItem";
+
+constexpr wchar_t SETTING_LOCATION[] = L"Location";
+
+PidlAbsolute LoadHistoryItem(IXMLDOMNode *historyItemNode)
+{
+	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> attributeMap;
+	HRESULT hr = historyItemNode->get_attributes(&attributeMap);
+
+	if (hr != S_OK)
+	{
+		return {};
+	}
+
+	std::wstring encodedPidl;
+	hr = XMLSettings::GetStringFromMap(attributeMap.get(), SETTING_LOCATION, encodedPidl);
+
+	if (hr != S_OK)
+	{
+		return {};
+	}
+
+	auto encodedPidlNarrow = WstrToStr(encodedPidl);
+
+	if (!encodedPidlNarrow)
+	{
+		return {};
+	}
+
+	return DecodePidlFromBase64(*encodedPidlNarrow);
+}
+
+void LoadFromNode(IXMLDOMNode *historyNode, HistoryModel *model)
+{
+	wil::com_ptr_nothrow<IXMLDOMNodeList> historyItemNodes;
+	auto queryString = wil::make_bstr_nothrow(HISTORY_ITEM_NODE_NAME);
+	HRESULT hr = historyNode->selectNodes(queryString.get(), &historyItemNodes);
+
+	if (hr != S_OK)
+	{
+		return;
+	}
+
+	std::vector<PidlAbsolute> historyItems;
+	wil::com_ptr_nothrow<IXMLDOMNode> childNode;
+
+	while (historyItemNodes->nextNode(&childNode) == S_OK)
+	{
+		auto pidl = LoadHistoryItem(childNode.get());
+
+		if (pidl.HasValue())
+		{
+			historyItems.push_back(pidl);
+		}
+	}
+
+	model->SetHistoryItems(historyItems);
+}
+
+void SaveToNode(IXMLDOMDocument *xmlDocument, IXMLDOMElement *historyNode,
+	const HistoryModel *model)
+{
+	for (const auto &pidl : model->GetHistoryItems())
+	{
+		auto encodedPidl = EncodePidlToBase64(pidl.Raw());
+		auto encodedPidlWide = StrToWstr(encodedPidl);
+
+		if (!encodedPidlWide)
+		{
+			continue;
+		}
+
+		wil::com_ptr_nothrow<IXMLDOMElement> historyItemNode;
+		auto historyItemNodeName = wil::make_bstr_nothrow(HISTORY_ITEM_NODE_NAME);
+		HRESULT hr = xmlDocument->createElement(historyItemNodeName.get(), &historyItemNode);
+
+		if (hr == S_OK)
+		{
+			XMLSettings::AddAttributeToNode(xmlDocument, historyItemNode.get(), SETTING_LOCATION,
+				*encodedPidlWide);
+			XMLSettings::AppendChildToParent(historyItemNode.get(), historyNode);
+		}
+	}
+}
+
+}
+
+namespace HistoryXmlStorage
+{
+
+void Load(IXMLDOMNode *rootNode, HistoryModel *model)
+{
+	wil::com_ptr_nothrow<IXMLDOMNode> historyNode;
+	auto queryString = wil::make_bstr_nothrow(HISTORY_NODE_NAME);
+	HRESULT hr = rootNode->selectSingleNode(queryString.get(), &historyNode);
+
+	if (hr != S_OK)
+	{
+		return;
+	}
+
+	LoadFromNode(historyNode.get(), model);
+}
+
+void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode, const HistoryModel *model)
+{
+	wil::com_ptr_nothrow<IXMLDOMElement> historyNode;
+	auto nodeName = wil::make_bstr_nothrow(HISTORY_NODE_NAME);
+	HRESULT hr = xmlDocument->createElement(nodeName.get(), &historyNode);
+
+	if (hr != S_OK)
+	{
+		return;
+	}
+
+	SaveToNode(xmlDocument, historyNode.get(), model);
+
+	XMLSettings::AppendChildToParent(historyNode.get(), rootNode);
+}
+
+}
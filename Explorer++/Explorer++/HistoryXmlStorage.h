@@ -0,0 +1,17 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <msxml.h>
+
+class HistoryModel;
+
+namespace HistoryXmlStorage
+{
+
+void Load(IXMLDOMNode *rootNode, HistoryModel *model);
+void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode, const HistoryModel *model);
+
+}
@@ -0,0 +1,104 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "HistoryXmlStreamStorage.h"
+#include "HistoryModel.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
+
+namespace
+{
+
+const wchar_t HISTORY_ITEM_NODE_NAME[] = L"HistoryItem";
+
+const wchar_t SETTING_LOCATION[] = L"Location";
+
+PidlAbsolute LoadHistoryItem(const XmlReader &reader)
+{
+	const auto *encodedPidl = reader.MaybeGetAttribute(SETTING_LOCATION);
+
+	if (!encodedPidl)
+	{
+		return {};
+	}
+
+	auto encodedPidlNarrow = WstrToStr(*encodedPidl);
+
+	if (!encodedPidlNarrow)
+	{
+		return {};
+	}
+
+	return DecodePidlFromBase64(*encodedPidlNarrow);
+}
+
+}
+
+namespace HistoryXmlStreamStorage
+{
+
+std::optional<std::vector<PidlAbsolute>> Load(XmlReader &reader)
+{
+	DCHECK(reader.GetNodeType() == XmlReader::NodeType::StartElement);
+	DCHECK(reader.GetName() == HISTORY_NODE_NAME);
+
+	std::vector<PidlAbsolute> historyItems;
+	size_t depth = reader.GetDepth();
+
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::EndElement && reader.GetDepth() == depth)
+		{
+			return historyItems;
+		}
+
+		if (reader.GetNodeType() != XmlReader::NodeType::StartElement)
+		{
+			continue;
+		}
+
+		if (reader.GetName() == HISTORY_ITEM_NODE_NAME)
+		{
+			auto pidl = LoadHistoryItem(reader);
+
+			if (pidl.HasValue())
+			{
+				historyItems.push_back(std::move(pidl));
+			}
+		}
+
+		if (!reader.SkipElement())
+		{
+			return std::nullopt;
+		}
+	}
+
+	return std::nullopt;
+}
+
+void Save(XmlWriter &writer, const HistoryModel *model)
+{
+	writer.StartElement(HISTORY_NODE_NAME);
+
+	for (const auto &pidl : model->GetHistoryItems())
+	{
+		auto encodedPidl = EncodePidlToBase64(pidl.Raw());
+		auto encodedPidlWide = StrToWstr(encodedPidl);
+
+		if (!encodedPidlWide)
+		{
+			continue;
+		}
+
+		writer.StartElement(HISTORY_ITEM_NODE_NAME);
+		writer.WriteAttribute(SETTING_LOCATION, *encodedPidlWide);
+		writer.EndElement();
+	}
+
+	writer.EndElement();
+}
+
+}
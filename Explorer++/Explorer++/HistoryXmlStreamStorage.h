@@ -0,0 +1,28 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/PidlHelper.h"
+#include <optional>
+#include <vector>
+
+class HistoryModel;
+class XmlReader;
+class XmlWriter;
+
+// Reads and writes the same history format as HistoryXmlStorage, using XmlReader/XmlWriter. The
+// history can contain thousands of entries, so this avoids building a DOM node for each of them.
+namespace HistoryXmlStreamStorage
+{
+
+static inline const wchar_t HISTORY_NODE_NAME[] = L"History";
+
+// The reader should be positioned on the history start element. If the history is read
+// successfully, the reader will be positioned on the matching end element when this returns.
+std::optional<std::vector<PidlAbsolute>> Load(XmlReader &reader);
+
+void Save(XmlWriter &writer, const HistoryModel *model);
+
+}
@@ -7,12 +7,16 @@
 #include "../Helper/CachedIcons.h"
 #include "../Helper/WindowSubclass.h"
 
-IconFetcherImpl::IconFetcherImpl(HWND hwnd, CachedIcons *cachedIcons) :
+IconFetcherImpl::IconFetcherImpl(HWND hwnd, CachedIcons *cachedIcons,
+	TaskScheduler *taskScheduler, std::shared_ptr<TaskScheduler::Group> parentTaskGroup,
+	const UiResultSink *resultSink) :
 	m_hwnd(hwnd),
 	m_cachedIcons(cachedIcons),
-	m_iconThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
-	m_iconResultIDCounter(0)
+	m_taskScheduler(taskScheduler),
+	m_taskGroup(taskScheduler->CreateGroup(parentTaskGroup)),
+	m_iconResultIDCounter(0),
+	m_resultSinkHandle(resultSink ? std::make_optional(resultSink->GetHandle()) : std::nullopt),
+	m_weakPtrFactory(this)
 {
 	FAIL_FAST_IF_FAILED(GetDefaultFileIconIndex(m_defaultFileIconIndex));
 	FAIL_FAST_IF_FAILED(GetDefaultFolderIconIndex(m_defaultFolderIconIndex));
@@ -23,7 +27,7 @@ IconFetcherImpl::IconFetcherImpl(HWND hwnd, CachedIcons *cachedIcons) :
 
 IconFetcherImpl::~IconFetcherImpl()
 {
-	m_iconThreadPool.clear_queue();
+	m_taskScheduler->CancelGroup(m_taskGroup);
 }
 
 LRESULT IconFetcherImpl::OwnerWindowSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
@@ -43,10 +47,15 @@ void IconFetcherImpl::QueueIconTask(std::wstring_view path, Callback callback)
 {
 	int iconResultID = m_iconResultIDCounter++;
 
-	auto iconResult = m_iconThreadPool.push(
-		[this, iconResultID, copiedPath = std::wstring(path)](int id) -> std::optional<IconResult>
+	// Unlike a dedicated thread pool, the scheduler won't wait for a running task to finish when
+	// this instance is destroyed, so the task can't reference this instance.
+	auto iconResult = m_taskScheduler->Push(m_taskGroup, TaskScheduler::Priority::Visible,
+		[notifyReady = MakeResultReadyNotifier(iconResultID),
+			copiedPath = std::wstring(path)]() -> std::optional<IconResult>
 		{
-			UNREFERENCED_PARAMETER(id);
+			// The result is processed even if the icon can't be found, so that the task is always
+			// marked as complete.
+			auto notifyOnExit = wil::scope_exit(notifyReady);
 
 			// SHGetFileInfo will fail for non-filesystem paths that are passed in
 			// as strings. For example, attempting to retrieve the icon for the
@@ -75,8 +84,6 @@ void IconFetcherImpl::QueueIconTask(std::wstring_view path, Callback callback)
 			result.overlayIndex = iconInfo->overlayIndex;
 			result.path = copiedPath;
 
-			PostMessage(m_hwnd, WM_APP_ICON_RESULT_READY, iconResultID, 0);
-
 			return result;
 		});
 
@@ -87,16 +94,29 @@ void IconFetcherImpl::QueueIconTask(std::wstring_view path, Callback callback)
 }
 
 void IconFetcherImpl::QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback)
+{
+	QueueIconTaskInternal(pidl, callback, std::nullopt);
+}
+
+void IconFetcherImpl::QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback,
+	TaskScheduler::TaskTag tag)
+{
+	QueueIconTaskInternal(pidl, callback, tag);
+}
+
+void IconFetcherImpl::QueueIconTaskInternal(PCIDLIST_ABSOLUTE pidl, Callback callback,
+	std::optional<TaskScheduler::TaskTag> tag)
 {
 	int iconResultID = m_iconResultIDCounter++;
 
 	BasicItemInfo basicItemInfo;
 	basicItemInfo.pidl.reset(ILCloneFull(pidl));
 
-	auto iconResult = m_iconThreadPool.push(
-		[this, iconResultID, basicItemInfo](int id) -> std::optional<IconResult>
+	auto iconResult = m_taskScheduler->Push(m_taskGroup, TaskScheduler::Priority::Visible,
+		[notifyReady = MakeResultReadyNotifier(iconResultID),
+			basicItemInfo]() -> std::optional<IconResult>
 		{
-			UNREFERENCED_PARAMETER(id);
+			auto notifyOnExit = wil::scope_exit(notifyReady);
 
 			// It's important that pidl is updated. Otherwise, the icon that's retrieved may be the
 			// original icon.
@@ -133,17 +153,66 @@ void IconFetcherImpl::QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback)
 				result.path = filePath;
 			}
 
-			PostMessage(m_hwnd, WM_APP_ICON_RESULT_READY, iconResultID, 0);
-
 			return result;
-		});
+		},
+		// Within the scheduler, tagged tasks are identified by their result ID, which can then be
+		// mapped back to the caller's tag.
+		tag ? std::make_optional<TaskScheduler::TaskTag>(iconResultID) : std::nullopt);
 
 	FutureResult futureResult;
 	futureResult.callback = callback;
 	futureResult.iconResult = std::move(iconResult);
+	futureResult.tag = tag;
 	m_iconResults.insert({ iconResultID, std::move(futureResult) });
 }
 
+std::vector<TaskScheduler::TaskTag> IconFetcherImpl::ReprioritizeTasks(
+	const TaskScheduler::GetPriorityCallback &getPriority)
+{
+	auto cancelledResultIds = m_taskScheduler->Reprioritize(m_taskGroup,
+		[this, &getPriority](TaskScheduler::TaskTag iconResultId)
+		{
+			const auto &futureResult = m_iconResults.at(static_cast<int>(iconResultId));
+			return getPriority(*futureResult.tag);
+		});
+
+	std::vector<TaskScheduler::TaskTag> cancelledTags;
+
+	for (auto iconResultId : cancelledResultIds)
+	{
+		auto itr = m_iconResults.find(static_cast<int>(iconResultId));
+		cancelledTags.push_back(*itr->second.tag);
+		m_iconResults.erase(itr);
+	}
+
+	return cancelledTags;
+}
+
+// Returns a function that a task can call (from any thread) to indicate that its result is ready.
+// The result will then be processed on the UI thread.
+std::function<void()> IconFetcherImpl::MakeResultReadyNotifier(int iconResultId)
+{
+	if (m_resultSinkHandle)
+	{
+		auto weakSelf = m_weakPtrFactory.GetWeakPtr();
+
+		return [handle = *m_resultSinkHandle, weakSelf, iconResultId]
+		{
+			handle.Post(
+				[weakSelf, iconResultId]
+				{
+					if (weakSelf)
+					{
+						weakSelf->ProcessIconResult(iconResultId);
+					}
+				});
+		};
+	}
+
+	return [hwnd = m_hwnd, iconResultId]
+	{ PostMessage(hwnd, WM_APP_ICON_RESULT_READY, iconResultId, 0); };
+}
+
 std::optional<ShellIconInfo> IconFetcherImpl::FindIconAsync(PCIDLIST_ABSOLUTE pidl)
 {
 	// Must use SHGFI_ICON here, rather than SHGFO_SYSICONINDEX, or else
@@ -171,7 +240,9 @@ void IconFetcherImpl::ProcessIconResult(int iconResultId)
 		return;
 	}
 
-	auto &futureResult = itr->second;
+	auto futureResult = std::move(itr->second);
+	m_iconResults.erase(itr);
+
 	auto result = futureResult.iconResult.get();
 
 	if (!result)
@@ -190,10 +261,15 @@ void IconFetcherImpl::ProcessIconResult(int iconResultId)
 
 void IconFetcherImpl::ClearQueue()
 {
-	m_iconThreadPool.clear_queue();
+	m_taskGroup = m_taskScheduler->ReplaceGroup(m_taskGroup);
 	m_iconResults.clear();
 }
 
+bool IconFetcherImpl::HasPendingTasks() const
+{
+	return !m_iconResults.empty();
+}
+
 int IconFetcherImpl::GetCachedIconIndexOrDefault(const std::wstring &itemPath,
 	DefaultIconType defaultIconType) const
 {
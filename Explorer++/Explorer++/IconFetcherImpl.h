@@ -5,10 +5,16 @@
 #pragma once
 
 #include "IconFetcher.h"
+#include "TaskScheduler.h"
+#include "UiResultSink.h"
 #include "../Helper/ShellHelper.h"
-#include "../ThirdParty/CTPL/cpl_stl.h"
+#include "../Helper/WeakPtrFactory.h"
+#include <functional>
 #include <future>
+#include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 class CachedIcons;
 class WindowSubclass;
@@ -16,12 +22,33 @@ class WindowSubclass;
 class IconFetcherImpl : public IconFetcher
 {
 public:
-	IconFetcherImpl(HWND hwnd, CachedIcons *cachedIcons);
+	// Icon tasks are queued on the TaskScheduler. If a parent group is provided, the tasks will be
+	// placed in a nested group, allowing them to be cancelled or deprioritized along with the rest
+	// of the work for that group. If a result sink is provided, results will be delivered through
+	// it, rather than by posting a message to the window.
+	IconFetcherImpl(HWND hwnd, CachedIcons *cachedIcons, TaskScheduler *taskScheduler,
+		std::shared_ptr<TaskScheduler::Group> parentTaskGroup = nullptr,
+		const UiResultSink *resultSink = nullptr);
 	~IconFetcherImpl();
 
 	void QueueIconTask(std::wstring_view path, Callback callback) override;
 	void QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback) override;
+
+	// Queues a task that's tagged by the caller (e.g. with the index of the item the icon is for),
+	// which allows the task to be re-prioritized, or cancelled, via ReprioritizeTasks().
+	void QueueIconTask(PCIDLIST_ABSOLUTE pidl, Callback callback, TaskScheduler::TaskTag tag);
+
+	// Updates the priority of each tagged task that hasn't yet started. The callbacks for any tasks
+	// that are cancelled won't be invoked. Returns the tags of the cancelled tasks.
+	std::vector<TaskScheduler::TaskTag> ReprioritizeTasks(
+		const TaskScheduler::GetPriorityCallback &getPriority);
 	void ClearQueue() override;
+
+	// Returns true if there are any tasks whose results haven't been processed yet. A task is
+	// complete once its result has been processed (whether or not the icon was found), or once it
+	// has been cancelled or cleared.
+	bool HasPendingTasks() const;
+
 	int GetCachedIconIndexOrDefault(const std::wstring &itemPath,
 		DefaultIconType defaultIconType) const override;
 	std::optional<int> GetCachedIconIndex(const std::wstring &itemPath) const override;
@@ -56,10 +83,14 @@ private:
 	{
 		Callback callback;
 		std::future<std::optional<IconResult>> iconResult;
+		std::optional<TaskScheduler::TaskTag> tag;
 	};
 
 	LRESULT OwnerWindowSubclass(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+	void QueueIconTaskInternal(PCIDLIST_ABSOLUTE pidl, Callback callback,
+		std::optional<TaskScheduler::TaskTag> tag);
+	std::function<void()> MakeResultReadyNotifier(int iconResultId);
 	static std::optional<ShellIconInfo> FindIconAsync(PCIDLIST_ABSOLUTE pidl);
 	void ProcessIconResult(int iconResultId);
 
@@ -69,8 +100,12 @@ private:
 	int m_defaultFileIconIndex;
 	int m_defaultFolderIconIndex;
 
-	ctpl::thread_pool m_iconThreadPool;
+	TaskScheduler *const m_taskScheduler;
+	std::shared_ptr<TaskScheduler::Group> m_taskGroup;
 	std::unordered_map<int, FutureResult> m_iconResults;
 	int m_iconResultIDCounter;
 	std::function<void(int data)> m_callback;
+	const std::optional<UiResultSink::Handle> m_resultSinkHandle;
+
+	WeakPtrFactory<IconFetcherImpl> m_weakPtrFactory;
 };
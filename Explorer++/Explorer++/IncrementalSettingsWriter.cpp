@@ -0,0 +1,214 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "IncrementalSettingsWriter.h"
+#include "Runtime.h"
+#include "Storage.h"
+#include "XmlAppStorage.h"
+#include "../Helper/AtomicFile.h"
+#include "../Helper/MemoryStreamBuf.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
+#include <sstream>
+
+IncrementalSettingsWriter::IncrementalSettingsWriter(const Runtime *runtime,
+	const std::wstring &configFilePath, SectionSaver sectionSaver) :
+	m_runtime(runtime),
+	m_configFilePath(configFilePath),
+	m_sectionSaver(sectionSaver)
+{
+	m_dirtySections.set();
+}
+
+IncrementalSettingsWriter::~IncrementalSettingsWriter()
+{
+	m_flushTimer.cancel();
+	WaitForPendingWrites();
+}
+
+void IncrementalSettingsWriter::MarkDirty(Section section)
+{
+	m_dirtySections.set(static_cast<size_t>(section));
+
+	if (m_flushScheduled)
+	{
+		return;
+	}
+
+	// Internally, concurrencpp converts the duration to size_t, which triggers a warning in the
+	// 32-bit build. The duration here is small, so the conversion is fine.
+#pragma warning(push)
+#pragma warning(                                                                                   \
+	disable : 4244) // 'argument': conversion from '_Rep' to 'size_t', possible loss of data
+	m_flushTimer = m_runtime->GetTimerQueue()->make_one_shot_timer(FLUSH_DELAY,
+		m_runtime->GetUiThreadExecutor(),
+		[self = m_weakPtrFactory.GetWeakPtr()]
+		{
+			if (!self)
+			{
+				return;
+			}
+
+			self->Flush();
+		});
+#pragma warning(pop)
+
+	m_flushScheduled = true;
+}
+
+bool IncrementalSettingsWriter::IsDirty(Section section) const
+{
+	return m_dirtySections.test(static_cast<size_t>(section));
+}
+
+void IncrementalSettingsWriter::Flush()
+{
+	m_flushTimer.cancel();
+	m_flushScheduled = false;
+
+	bool changed = false;
+
+	for (size_t i = 0; i < NUM_SECTIONS; i++)
+	{
+		if (!m_dirtySections.test(i))
+		{
+			continue;
+		}
+
+		auto serializedSection = MaybeSerializeSection(static_cast<Section>(i));
+
+		if (!serializedSection)
+		{
+			continue;
+		}
+
+		if (!m_serializedSections[i] || *m_serializedSections[i] != *serializedSection)
+		{
+			m_serializedSections[i] =
+				std::make_shared<const std::string>(std::move(*serializedSection));
+			changed = true;
+		}
+
+		m_dirtySections.reset(i);
+	}
+
+	// Writing out the file when a section is missing would result in that section being lost.
+	bool allSectionsSerialized = std::ranges::all_of(m_serializedSections,
+		[](const auto &serializedSection) { return serializedSection != nullptr; });
+
+	if (!changed || !allSectionsSerialized)
+	{
+		return;
+	}
+
+	m_generation++;
+
+	// The sections are captured by value. Since each section is immutable and shared, that only
+	// involves copying pointers.
+	m_latestWrite = m_runtime->GetComStaExecutor()->submit(
+		[writeState = m_writeState, configFilePath = m_configFilePath,
+			sections = m_serializedSections, generation = m_generation]
+		{ WriteInBackground(writeState, configFilePath, sections, generation); });
+}
+
+void IncrementalSettingsWriter::WaitForPendingWrites()
+{
+	// Earlier writes either finish before the latest write starts (since they hold the mutex), or
+	// are skipped entirely, so only the latest write needs to be waited on.
+	if (m_latestWrite)
+	{
+		m_latestWrite.wait();
+		m_latestWrite = {};
+	}
+}
+
+std::optional<std::string> IncrementalSettingsWriter::MaybeSerializeSection(Section section)
+{
+	auto xmlDocument = XMLSettings::CreateXmlDocument();
+
+	if (!xmlDocument)
+	{
+		return std::nullopt;
+	}
+
+	auto rootTag = wil::make_bstr_nothrow(Storage::CONFIG_FILE_ROOT_NODE_NAME);
+	wil::com_ptr_nothrow<IXMLDOMElement> rootNode;
+	HRESULT hr = xmlDocument->createElement(rootTag.get(), &rootNode);
+
+	if (hr != S_OK)
+	{
+		return std::nullopt;
+	}
+
+	XMLSettings::AppendChildToParent(rootNode.get(), xmlDocument.get());
+
+	XmlAppStorage appStorage(xmlDocument, rootNode, m_configFilePath,
+		Storage::OperationType::Save);
+	m_sectionSaver(&appStorage, section);
+
+	wil::unique_bstr xml;
+	hr = xmlDocument->get_xml(&xml);
+
+	if (FAILED(hr))
+	{
+		return std::nullopt;
+	}
+
+	return wstrToUtf8Str(xml.get());
+}
+
+void IncrementalSettingsWriter::WriteInBackground(std::shared_ptr<WriteState> writeState,
+	const std::wstring &configFilePath, const SerializedSections &sections, uint64_t generation)
+{
+	std::scoped_lock lock(writeState->mutex);
+
+	if (generation < writeState->lastWrittenGeneration)
+	{
+		return;
+	}
+
+	if (WriteConfigFile(configFilePath, sections))
+	{
+		writeState->lastWrittenGeneration = generation;
+	}
+}
+
+bool IncrementalSettingsWriter::WriteConfigFile(const std::wstring &configFilePath,
+	const SerializedSections &sections)
+{
+	std::ostringstream outputStream;
+
+	{
+		XmlWriter writer(outputStream);
+		writer.WriteDeclaration();
+		writer.WriteComment(L" Preference file for Explorer++ ");
+		writer.StartElement(Storage::CONFIG_FILE_ROOT_NODE_NAME);
+
+		// Each section is a complete document, with its content nested within a root element.
+		// Only that content is copied.
+		for (const auto &section : sections)
+		{
+			MemoryStreamBuf streamBuf(*section);
+			std::istream sectionStream(&streamBuf);
+			XmlReader reader(sectionStream);
+
+			while (reader.Read())
+			{
+				if (reader.GetDepth() > 0)
+				{
+					writer.WriteNode(reader);
+				}
+			}
+
+			DCHECK(!reader.HasError());
+		}
+
+		writer.EndElement();
+	}
+
+	return AtomicFile::Write(configFilePath, std::move(outputStream).str());
+}
@@ -0,0 +1,107 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/WeakPtrFactory.h"
+#include <boost/core/noncopyable.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+class AppStorage;
+class Runtime;
+
+// Writes the config file in the background, re-serializing only those sections that have changed
+// since the last write.
+//
+// Each section is saved (on the UI thread) into its own small XML document and the resulting XML is
+// cached. The cached XML for every section is then combined into a complete config file on a
+// background thread. The file is written to a temporary location first and moved into place once
+// complete, so the existing config file is never left partially written.
+//
+// Changes are coalesced. Marking a section as dirty schedules a flush FLUSH_DELAY later (if one
+// isn't already scheduled) and any other changes made before then are included in that same flush.
+// That bounds the amount of state that can be lost in a crash to roughly FLUSH_DELAY.
+class IncrementalSettingsWriter : private boost::noncopyable
+{
+public:
+	// Sections are written to the config file in this order.
+	enum class Section
+	{
+		Config,
+		Windows,
+		Bookmarks,
+		ColorRules,
+		Applications,
+		DialogStates,
+		DefaultColumns,
+		FrequentLocations,
+		History,
+
+		Count
+	};
+
+	static constexpr std::chrono::seconds FLUSH_DELAY{ 2 };
+
+	// Saves a single section into the provided storage. This is always invoked on the UI thread.
+	using SectionSaver = std::function<void(AppStorage *appStorage, Section section)>;
+
+	// All sections are initially considered dirty.
+	IncrementalSettingsWriter(const Runtime *runtime, const std::wstring &configFilePath,
+		SectionSaver sectionSaver);
+	~IncrementalSettingsWriter();
+
+	void MarkDirty(Section section);
+	bool IsDirty(Section section) const;
+
+	// Serializes each dirty section immediately. If the content of any section has changed, a
+	// background write of the config file is then started.
+	void Flush();
+
+	// Blocks until all background writes have finished.
+	void WaitForPendingWrites();
+
+private:
+	static constexpr size_t NUM_SECTIONS = static_cast<size_t>(Section::Count);
+
+	using SerializedSections = std::array<std::shared_ptr<const std::string>, NUM_SECTIONS>;
+
+	// Background writes can complete out of order. This state ensures that the file is never
+	// replaced with older content once a newer write has finished.
+	struct WriteState
+	{
+		std::mutex mutex;
+		uint64_t lastWrittenGeneration = 0;
+	};
+
+	std::optional<std::string> MaybeSerializeSection(Section section);
+	static void WriteInBackground(std::shared_ptr<WriteState> writeState,
+		const std::wstring &configFilePath, const SerializedSections &sections,
+		uint64_t generation);
+	static bool WriteConfigFile(const std::wstring &configFilePath,
+		const SerializedSections &sections);
+
+	const Runtime *const m_runtime;
+	const std::wstring m_configFilePath;
+	const SectionSaver m_sectionSaver;
+
+	std::bitset<NUM_SECTIONS> m_dirtySections;
+	SerializedSections m_serializedSections;
+
+	concurrencpp::timer m_flushTimer;
+	bool m_flushScheduled = false;
+
+	const std::shared_ptr<WriteState> m_writeState = std::make_shared<WriteState>();
+	uint64_t m_generation = 0;
+	concurrencpp::result<void> m_latestWrite;
+
+	WeakPtrFactory<IncrementalSettingsWriter> m_weakPtrFactory{ this };
+};
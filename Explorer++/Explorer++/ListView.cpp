@@ -11,8 +11,13 @@
 #include "TestHelper.h"
 #include "../Helper/KeyboardState.h"
 #include "../Helper/ListViewHelper.h"
+#include "../Helper/ScopedRedrawDisabler.h"
 #include "../Helper/WindowSubclass.h"
 #include <wil/common.h>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 ListView::ListView(HWND hwnd, const KeyboardState *keyboardState,
 	LabelEditHandlerFactory labelEditHandlerFactory, const ResourceLoader *resourceLoader) :
@@ -43,12 +48,16 @@ void ListView::SetModel(ListViewModel *model)
 
 	m_connections.push_back(
 		m_model->itemAddedSignal.AddObserver(std::bind_front(&ListView::AddItem, this)));
+	m_connections.push_back(
+		m_model->itemsAddedSignal.AddObserver(std::bind_front(&ListView::OnItemsAdded, this)));
 	m_connections.push_back(
 		m_model->itemUpdatedSignal.AddObserver(std::bind_front(&ListView::OnItemUpdated, this)));
 	m_connections.push_back(
 		m_model->itemMovedSignal.AddObserver(std::bind_front(&ListView::OnItemMoved, this)));
 	m_connections.push_back(
 		m_model->itemRemovedSignal.AddObserver(std::bind_front(&ListView::RemoveItem, this)));
+	m_connections.push_back(m_model->itemsRemovedSignal.AddObserver(
+		std::bind_front(&ListView::OnItemsRemoved, this)));
 	m_connections.push_back(m_model->allItemsRemovedSignal.AddObserver(
 		std::bind_front(&ListView::RemoveAllItems, this)));
 	m_connections.push_back(m_model->sortOrderChangedSignal.AddObserver(
@@ -156,6 +165,14 @@ void ListView::UpdateColumnOrdering()
 
 void ListView::AddItems()
 {
+	ScopedRedrawDisabler redrawDisabler(m_hwnd);
+	InsertModelItems();
+}
+
+void ListView::InsertModelItems()
+{
+	ListView_SetItemCountEx(m_hwnd, m_model->GetNumItems(), LVSICF_NOINVALIDATEALL);
+
 	int index = 0;
 
 	for (auto *item : m_model->GetItems())
@@ -178,6 +195,107 @@ void ListView::AddItem(ListViewItem *item, int index)
 	CHECK_EQ(insertedIndex, index);
 }
 
+void ListView::OnItemsAdded(const std::vector<ListViewItem *> &items)
+{
+	if (items.size() * REBUILD_BATCH_DIVISOR >= static_cast<size_t>(m_model->GetNumItems()))
+	{
+		RebuildItems();
+		return;
+	}
+
+	ScopedRedrawDisabler redrawDisabler(m_hwnd);
+	ListView_SetItemCountEx(m_hwnd, m_model->GetNumItems(), LVSICF_NOINVALIDATEALL);
+
+	std::unordered_set<const ListViewItem *> addedItems(items.begin(), items.end());
+
+	// The model has already merged the new items into place. Walking the model in order means
+	// that, by the time an item is inserted, every item before it is already in its final
+	// position, so the model index can be used directly.
+	int index = 0;
+
+	for (auto *item : m_model->GetItems())
+	{
+		if (addedItems.contains(item))
+		{
+			AddItem(item, index);
+		}
+
+		index++;
+	}
+}
+
+void ListView::RebuildItems()
+{
+	ScopedRedrawDisabler redrawDisabler(m_hwnd);
+
+	// Item state (e.g. selection) and the scroll position are held by the control, so they're
+	// recorded here and restored for the items that are still present once the rebuild is
+	// complete. The model has already been updated at this point.
+	std::unordered_map<const ListViewItem *, UINT> itemStates;
+	const ListViewItem *selectionMarkItem = nullptr;
+	const ListViewItem *topItem = nullptr;
+
+	int numItems = ListView_GetItemCount(m_hwnd);
+
+	if (numItems > 0)
+	{
+		for (int i = 0; i < numItems; i++)
+		{
+			UINT state = ListView_GetItemState(m_hwnd, i, REBUILD_PRESERVED_ITEM_STATES);
+
+			if (state != 0)
+			{
+				itemStates.emplace(GetItemAtIndex(i), state);
+			}
+		}
+
+		int selectionMark = ListView_GetSelectionMark(m_hwnd);
+
+		if (selectionMark != -1)
+		{
+			selectionMarkItem = GetItemAtIndex(selectionMark);
+		}
+
+		topItem = GetItemAtIndex(ListView_GetTopIndex(m_hwnd));
+	}
+
+	auto res = ListView_DeleteAllItems(m_hwnd);
+	CHECK(res);
+
+	InsertModelItems();
+
+	int index = 0;
+	int topIndex = -1;
+
+	for (const auto *item : m_model->GetItems())
+	{
+		if (auto itr = itemStates.find(item); itr != itemStates.end())
+		{
+			ListView_SetItemState(m_hwnd, index, itr->second, REBUILD_PRESERVED_ITEM_STATES);
+		}
+
+		if (item == selectionMarkItem)
+		{
+			ListView_SetSelectionMark(m_hwnd, index);
+		}
+
+		if (item == topItem)
+		{
+			topIndex = index;
+		}
+
+		index++;
+	}
+
+	if (topIndex > 0)
+	{
+		// Scrolling to the last item and then back to the item that was previously at the top of
+		// the view leaves that item at the top again.
+		ListView_EnsureVisible(m_hwnd, m_model->GetNumItems() - 1, false);
+		ListView_EnsureVisible(m_hwnd, topIndex, false);
+	}
+}
+
 void ListView::OnItemUpdated(const ListViewItem *item)
 {
 	ResetItemImage(item);
@@ -231,6 +349,37 @@ void ListView::RemoveItem(const ListViewItem *item)
 	CHECK(res);
 }
 
+void ListView::OnItemsRemoved(const std::vector<const ListViewItem *> &items)
+{
+	// The items are still present in the listview at this point (though they've already been
+	// removed from the model).
+	if (items.size() * REBUILD_BATCH_DIVISOR >= static_cast<size_t>(ListView_GetItemCount(m_hwnd)))
+	{
+		RebuildItems();
+		return;
+	}
+
+	ScopedRedrawDisabler redrawDisabler(m_hwnd);
+
+	std::vector<int> indexes;
+	indexes.reserve(items.size());
+
+	for (const auto *item : items)
+	{
+		indexes.push_back(GetItemIndex(item));
+	}
+
+	// Items are removed from the end, so that the indexes of the items yet to be removed don't
+	// change.
+	std::ranges::sort(indexes, std::greater<>());
+
+	for (int index : indexes)
+	{
+		auto res = ListView_DeleteItem(m_hwnd, index);
+		CHECK(res);
+	}
+}
+
 void ListView::RemoveAllItems()
 {
 	auto res = ListView_DeleteAllItems(m_hwnd);
@@ -75,6 +75,15 @@ public:
 	int GetItemCountForTesting() const;
 
 private:
+	// A batch of added or removed items is applied by rebuilding the listview once the batch
+	// covers at least 1 in this many items. Inserting or deleting a single row shifts every row
+	// after it, so past that point, re-inserting every item in order is cheaper.
+	static constexpr size_t REBUILD_BATCH_DIVISOR = 4;
+
+	// The item states that are carried over when the listview is rebuilt.
+	static constexpr UINT REBUILD_PRESERVED_ITEM_STATES =
+		LVIS_SELECTED | LVIS_FOCUSED | LVIS_CUT | LVIS_DROPHILITED;
+
 	enum class ViewType
 	{
 		Icon,
@@ -126,13 +135,17 @@ private:
 	void AddColumn(ListViewColumnId columnId);
 	void UpdateColumnOrdering();
 	void AddItems();
+	void InsertModelItems();
 	void AddItem(ListViewItem *item, int index);
+	void OnItemsAdded(const std::vector<ListViewItem *> &items);
+	void RebuildItems();
 
 	void OnItemUpdated(const ListViewItem *item);
 	void OnItemMoved(ListViewItem *item, int newIndex);
 	void ResetItemImage(const ListViewItem *item);
 	void ResetItemColumns(const ListViewItem *item);
 	void RemoveItem(const ListViewItem *item);
+	void OnItemsRemoved(const std::vector<const ListViewItem *> &items);
 	void RemoveAllItems();
 
 	void OnColumnVisibilityChanged(ListViewColumnId columnId, bool visible);
@@ -5,8 +5,8 @@
 #pragma once
 
 #include "ListViewColumn.h"
+#include "../Helper/IntrusiveSignal.h"
 #include <boost/core/noncopyable.hpp>
-#include <boost/signals2.hpp>
 #include <optional>
 #include <string>
 
@@ -14,7 +14,9 @@
 class ListViewItem : private boost::noncopyable
 {
 public:
-	using UpdatedSignal = boost::signals2::signal<void()>;
+	// There can be a large number of items, each of which is only accessed on the UI thread, so a
+	// lightweight signal is used here.
+	using UpdatedSignal = IntrusiveSignal<void()>;
 
 	virtual ~ListViewItem() = default;
 
@@ -30,10 +32,10 @@ public:
 	// For any other type of item, pressing F2 while editing will have no effect.
 	virtual bool IsFile() const = 0;
 
-	[[nodiscard]] boost::signals2::connection AddUpdatedObserver(
-		const typename UpdatedSignal::slot_type &observer)
+	template <typename Observer>
+	[[nodiscard]] UpdatedSignal::Connection AddUpdatedObserver(Observer &&observer)
 	{
-		return m_updatedSignal.connect(observer);
+		return m_updatedSignal.AddObserver(std::forward<Observer>(observer));
 	}
 
 protected:
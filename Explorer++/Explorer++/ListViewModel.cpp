@@ -6,6 +6,8 @@
 #include "ListViewModel.h"
 #include "ListViewItem.h"
 #include <algorithm>
+#include <iterator>
+#include <unordered_set>
 
 ListViewModel::ListViewModel(SortPolicy sortPolicy) : m_sortPolicy(sortPolicy)
 {
@@ -15,14 +17,49 @@ ListViewModel::~ListViewModel() = default;
 
 void ListViewModel::AddItem(std::unique_ptr<ListViewItem> item)
 {
-	// The observer here doesn't need to be removed, since this class owns the item.
-	std::ignore =
-		item->AddUpdatedObserver(std::bind_front(&ListViewModel::OnItemUpdated, this, item.get()));
-
 	int index = GetItemSortedIndex(item.get());
-	auto itr = m_items.insert(m_items.begin() + index, std::move(item));
+	auto itr = m_items.insert(m_items.begin() + index, MakeItemEntry(std::move(item)));
 
-	itemAddedSignal.m_signal(itr->get(), index);
+	itemAddedSignal.m_signal(itr->item.get(), index);
+}
+
+void ListViewModel::AddItems(std::vector<std::unique_ptr<ListViewItem>> items)
+{
+	if (items.empty())
+	{
+		return;
+	}
+
+	std::vector<ItemEntry> newEntries;
+	newEntries.reserve(items.size());
+
+	for (auto &item : items)
+	{
+		newEntries.push_back(MakeItemEntry(std::move(item)));
+	}
+
+	auto compareEntries = [this](const ItemEntry &first, const ItemEntry &second)
+	{
+		return CompareItemsWrapper(first.item.get(), second.item.get());
+	};
+
+	// A stable sort, followed by a merge in which existing items take precedence, results in the
+	// same ordering that would be produced by adding each item individually.
+	std::ranges::stable_sort(newEntries, compareEntries);
+
+	std::vector<ListViewItem *> addedItems;
+	addedItems.reserve(newEntries.size());
+	std::ranges::transform(newEntries, std::back_inserter(addedItems),
+		[](const auto &entry) { return entry.item.get(); });
+
+	std::vector<ItemEntry> mergedEntries;
+	mergedEntries.reserve(m_items.size() + newEntries.size());
+	std::merge(std::make_move_iterator(m_items.begin()), std::make_move_iterator(m_items.end()),
+		std::make_move_iterator(newEntries.begin()), std::make_move_iterator(newEntries.end()),
+		std::back_inserter(mergedEntries), compareEntries);
+	m_items = std::move(mergedEntries);
+
+	itemsAddedSignal.m_signal(addedItems);
 }
 
 void ListViewModel::MaybeRepositionItem(ListViewItem *item)
@@ -30,11 +67,11 @@ void ListViewModel::MaybeRepositionItem(ListViewItem *item)
 	int originalIndex = GetItemIndex(item);
 
 	auto itr = m_items.begin() + originalIndex;
-	auto ownedItem = std::move(*itr);
+	auto entry = std::move(*itr);
 	m_items.erase(itr);
 
 	int updatedIndex = GetItemSortedIndex(item);
-	m_items.insert(m_items.begin() + updatedIndex, std::move(ownedItem));
+	m_items.insert(m_items.begin() + updatedIndex, std::move(entry));
 
 	if (updatedIndex != originalIndex)
 	{
@@ -44,14 +81,44 @@ void ListViewModel::MaybeRepositionItem(ListViewItem *item)
 
 void ListViewModel::RemoveItem(ListViewItem *item)
 {
-	auto itr = std::ranges::find_if(m_items,
-		[item](const auto &currentItem) { return currentItem.get() == item; });
+	auto itr = std::ranges::find(m_items, item, &ItemEntry::GetItem);
 	CHECK(itr != m_items.end());
 
-	auto ownedItem = std::move(*itr);
+	auto entry = std::move(*itr);
 	m_items.erase(itr);
 
-	itemRemovedSignal.m_signal(ownedItem.get());
+	itemRemovedSignal.m_signal(entry.item.get());
+}
+
+void ListViewModel::RemoveItems(const std::vector<ListViewItem *> &items)
+{
+	if (items.empty())
+	{
+		return;
+	}
+
+	std::unordered_set<const ListViewItem *> itemsToRemove(items.begin(), items.end());
+
+	std::vector<ItemEntry> removedEntries;
+	removedEntries.reserve(itemsToRemove.size());
+
+	std::vector<const ListViewItem *> removedItems;
+	removedItems.reserve(itemsToRemove.size());
+
+	for (auto &entry : m_items)
+	{
+		if (itemsToRemove.contains(entry.item.get()))
+		{
+			removedItems.push_back(entry.item.get());
+			removedEntries.push_back(std::move(entry));
+		}
+	}
+
+	CHECK_EQ(removedEntries.size(), itemsToRemove.size());
+
+	std::erase_if(m_items, [](const auto &entry) { return !entry.item; });
+
+	itemsRemovedSignal.m_signal(removedItems);
 }
 
 void ListViewModel::RemoveAllItems()
@@ -61,6 +128,15 @@ void ListViewModel::RemoveAllItems()
 	allItemsRemovedSignal.m_signal();
 }
 
+ListViewModel::ItemEntry ListViewModel::MakeItemEntry(std::unique_ptr<ListViewItem> item)
+{
+	ItemEntry entry;
+	entry.updatedConnection =
+		item->AddUpdatedObserver(std::bind_front(&ListViewModel::OnItemUpdated, this, item.get()));
+	entry.item = std::move(item);
+	return entry;
+}
+
 void ListViewModel::OnItemUpdated(ListViewItem *item)
 {
 	itemUpdatedSignal.m_signal(item);
@@ -70,9 +146,9 @@ void ListViewModel::OnItemUpdated(ListViewItem *item)
 
 concurrencpp::generator<ListViewItem *> ListViewModel::GetItems()
 {
-	for (const auto &item : m_items)
+	for (const auto &entry : m_items)
 	{
-		co_yield item.get();
+		co_yield entry.item.get();
 	}
 }
 
@@ -83,8 +159,7 @@ int ListViewModel::GetNumItems() const
 
 int ListViewModel::GetItemIndex(const ListViewItem *item) const
 {
-	auto itr = std::ranges::find_if(m_items,
-		[item](const auto &currentItem) { return currentItem.get() == item; });
+	auto itr = std::ranges::find(m_items, item, &ItemEntry::GetItem);
 	CHECK(itr != m_items.end());
 	return static_cast<int>(std::distance(m_items.begin(), itr));
 }
@@ -97,7 +172,7 @@ ListViewItem *ListViewModel::GetItemAtIndex(int index)
 const ListViewItem *ListViewModel::GetItemAtIndex(int index) const
 {
 	CHECK(index >= 0 && index < GetNumItems());
-	return m_items[index].get();
+	return m_items[index].item.get();
 }
 
 bool ListViewModel::HasDefaultSortOrder() const
@@ -131,8 +206,8 @@ void ListViewModel::SetSortDetails(std::optional<ListViewColumnId> columnId,
 
 void ListViewModel::SortItems()
 {
-	std::ranges::sort(m_items, [this](const auto &first, const auto &second)
-		{ return CompareItemsWrapper(first.get(), second.get()); });
+	std::ranges::sort(m_items, std::bind_front(&ListViewModel::CompareItemsWrapper, this),
+		&ItemEntry::GetItem);
 
 	sortOrderChangedSignal.m_signal();
 }
@@ -142,16 +217,14 @@ int ListViewModel::GetItemSortedIndex(const ListViewItem *item) const
 	DCHECK(!IsItemInSet(item));
 
 	auto itr = std::ranges::upper_bound(m_items, item,
-		std::bind_front(&ListViewModel::CompareItemsWrapper, this),
-		[](const auto &currentItem) { return currentItem.get(); });
+		std::bind_front(&ListViewModel::CompareItemsWrapper, this), &ItemEntry::GetItem);
 	auto index = std::distance(m_items.begin(), itr);
 	return static_cast<int>(index);
 }
 
 bool ListViewModel::IsItemInSet(const ListViewItem *item) const
 {
-	auto itr = std::ranges::find_if(m_items,
-		[item](const auto &currentItem) { return currentItem.get() == item; });
+	auto itr = std::ranges::find(m_items, item, &ItemEntry::GetItem);
 	return itr != m_items.end();
 }
 
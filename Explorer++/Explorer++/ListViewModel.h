@@ -5,6 +5,7 @@
 #pragma once
 
 #include "ListViewColumn.h"
+#include "ListViewItem.h"
 #include "../Helper/SignalWrapper.h"
 #include "../Helper/SortDirection.h"
 #include <concurrencpp/concurrencpp.h>
@@ -14,7 +15,6 @@
 #include <vector>
 
 class ListViewColumnModel;
-class ListViewItem;
 
 // Represents the set of items displayed in a ListView.
 class ListViewModel
@@ -49,9 +49,20 @@ public:
 
 	// Signals
 	SignalWrapper<ListViewModel, void(ListViewItem *item, int index)> itemAddedSignal;
+
+	// Emitted once for a batch of items added via AddItems(). The items are provided in the order
+	// they now appear in the model.
+	SignalWrapper<ListViewModel, void(const std::vector<ListViewItem *> &items)> itemsAddedSignal;
+
 	SignalWrapper<ListViewModel, void(ListViewItem *item)> itemUpdatedSignal;
 	SignalWrapper<ListViewModel, void(ListViewItem *item, int newIndex)> itemMovedSignal;
 	SignalWrapper<ListViewModel, void(const ListViewItem *item)> itemRemovedSignal;
+
+	// Emitted once for a batch of items removed via RemoveItems(). The items are still valid when
+	// this signal is emitted, but are destroyed immediately afterwards.
+	SignalWrapper<ListViewModel, void(const std::vector<const ListViewItem *> &items)>
+		itemsRemovedSignal;
+
 	SignalWrapper<ListViewModel, void()> allItemsRemovedSignal;
 	SignalWrapper<ListViewModel, void()> sortOrderChangedSignal;
 
@@ -60,16 +71,34 @@ protected:
 
 	void AddItem(std::unique_ptr<ListViewItem> item);
 
+	// Adds a set of items in a single operation. The items will be sorted once and merged into the
+	// existing set, with a single itemsAddedSignal emitted, rather than one itemAddedSignal per
+	// item. This should be preferred when adding a large number of items.
+	void AddItems(std::vector<std::unique_ptr<ListViewItem>> items);
+
 	// Called when an item's sorted position may have changed.
 	void MaybeRepositionItem(ListViewItem *item);
 
 	void RemoveItem(ListViewItem *item);
+	void RemoveItems(const std::vector<ListViewItem *> &items);
 	void RemoveAllItems();
 
 	virtual std::weak_ordering CompareItems(const ListViewItem *first,
 		const ListViewItem *second) const = 0;
 
 private:
+	struct ItemEntry
+	{
+		std::unique_ptr<ListViewItem> item;
+		ListViewItem::UpdatedSignal::Connection updatedConnection;
+
+		const ListViewItem *GetItem() const
+		{
+			return item.get();
+		}
+	};
+
+	ItemEntry MakeItemEntry(std::unique_ptr<ListViewItem> item);
 	void OnItemUpdated(ListViewItem *item);
 
 	void SortItems();
@@ -77,7 +106,7 @@ private:
 	bool IsItemInSet(const ListViewItem *item) const;
 	bool CompareItemsWrapper(const ListViewItem *first, const ListViewItem *second) const;
 
-	std::vector<std::unique_ptr<ListViewItem>> m_items;
+	std::vector<ItemEntry> m_items;
 	const SortPolicy m_sortPolicy;
 
 	// If this is empty, it means that there is no explicit sort order. Items should either revert
@@ -0,0 +1,83 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ListingDiff.h"
+#include <algorithm>
+#include <cstring>
+
+size_t ListingDiff::Delta::GetNumChanges() const
+{
+	return added.size() + removed.size() + modified.size();
+}
+
+bool ListingDiff::Delta::IsEmpty() const
+{
+	return GetNumChanges() == 0;
+}
+
+void ListingDiff::SortEntries(std::vector<Entry> &entries)
+{
+	std::ranges::sort(entries, &ListingDiff::IsKeyLess);
+}
+
+ListingDiff::Delta ListingDiff::Compute(std::span<const Entry> oldEntries,
+	std::span<const Entry> newEntries)
+{
+	DCHECK(std::ranges::is_sorted(oldEntries, &ListingDiff::IsKeyLess));
+	DCHECK(std::ranges::is_sorted(newEntries, &ListingDiff::IsKeyLess));
+
+	Delta delta;
+	size_t oldIndex = 0;
+	size_t newIndex = 0;
+
+	while (oldIndex < oldEntries.size() && newIndex < newEntries.size())
+	{
+		const auto &oldEntry = oldEntries[oldIndex];
+		const auto &newEntry = newEntries[newIndex];
+
+		if (IsKeyLess(oldEntry, newEntry))
+		{
+			delta.removed.push_back(oldIndex++);
+		}
+		else if (IsKeyLess(newEntry, oldEntry))
+		{
+			delta.added.push_back(newIndex++);
+		}
+		else
+		{
+			if (!ArePidlsIdentical(oldEntry.pidl, newEntry.pidl))
+			{
+				delta.modified.emplace_back(oldIndex, newIndex);
+			}
+
+			oldIndex++;
+			newIndex++;
+		}
+	}
+
+	for (; oldIndex < oldEntries.size(); oldIndex++)
+	{
+		delta.removed.push_back(oldIndex);
+	}
+
+	for (; newIndex < newEntries.size(); newIndex++)
+	{
+		delta.added.push_back(newIndex);
+	}
+
+	return delta;
+}
+
+bool ListingDiff::IsKeyLess(const Entry &entry1, const Entry &entry2)
+{
+	return entry1.key < entry2.key;
+}
+
+bool ListingDiff::ArePidlsIdentical(PCITEMID_CHILD pidl1, PCITEMID_CHILD pidl2)
+{
+	UINT size1 = ILGetSize(pidl1);
+	UINT size2 = ILGetSize(pidl2);
+	return size1 == size2 && std::memcmp(pidl1, pidl2, size1) == 0;
+}
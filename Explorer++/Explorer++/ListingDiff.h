@@ -0,0 +1,57 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <ShObjIdl.h>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Computes the difference between two listings of the same folder. That allows a folder that's
+// been re-enumerated to be updated in place, by applying only the items that were added, removed or
+// modified, rather than by reloading every item.
+//
+// Each item is identified by its key (typically its parsing name). An item that's present in both
+// listings is considered to be modified if its pidl has changed, since the pidl for an item embeds
+// details like its size and modification date. Both listings need to be sorted via SortEntries()
+// before being compared, which allows them to be compared with a single merge pass.
+class ListingDiff
+{
+public:
+	// Entries don't own any of their data. The caller needs to ensure the keys and pidls remain
+	// valid for as long as the entries are in use.
+	struct Entry
+	{
+		std::wstring_view key;
+		PCITEMID_CHILD pidl;
+
+		// An arbitrary value the caller can use to map the entry back to the item it represents.
+		size_t itemId = 0;
+	};
+
+	// Each value is an index into one of the sorted listings passed to Compute().
+	struct Delta
+	{
+		// Indexes into the new listing.
+		std::vector<size_t> added;
+
+		// Indexes into the old listing.
+		std::vector<size_t> removed;
+
+		// Pairs of (old index, new index).
+		std::vector<std::pair<size_t, size_t>> modified;
+
+		size_t GetNumChanges() const;
+		bool IsEmpty() const;
+	};
+
+	static void SortEntries(std::vector<Entry> &entries);
+	static Delta Compute(std::span<const Entry> oldEntries, std::span<const Entry> newEntries);
+
+private:
+	static bool IsKeyLess(const Entry &entry1, const Entry &entry2);
+	static bool ArePidlsIdentical(PCITEMID_CHILD pidl1, PCITEMID_CHILD pidl2);
+};
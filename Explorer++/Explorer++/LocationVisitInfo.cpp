@@ -4,12 +4,41 @@
 
 #include "stdafx.h"
 #include "LocationVisitInfo.h"
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+
+// Frecency values are stored relative to this point in time. This value is used when saving and
+// loading frecency data, so it shouldn't be changed.
+constexpr auto DECAY_EPOCH = std::chrono::sys_days{ std::chrono::January / 1 / 2024 };
+
+// Returns log(exp(first) + exp(second)), without the risk of overflow.
+double AddLogValues(double first, double second)
+{
+	double larger = std::max(first, second);
+	double smaller = std::min(first, second);
+	return larger + std::log1p(std::exp(smaller - larger));
+}
+
+}
 
 LocationVisitInfo::LocationVisitInfo(const PidlAbsolute &pidl, int numVisits,
 	const SystemClock::TimePoint &lastVisitTime) :
 	m_pidl(pidl),
 	m_numVisits(std::max(numVisits, 1)),
-	m_lastVisitTime(lastVisitTime)
+	m_lastVisitTime(lastVisitTime),
+	m_frecencyKey(std::log(static_cast<double>(m_numVisits)) + GetDecayExponent(lastVisitTime))
+{
+}
+
+LocationVisitInfo::LocationVisitInfo(const PidlAbsolute &pidl, int numVisits,
+	const SystemClock::TimePoint &lastVisitTime, double frecencyKey) :
+	m_pidl(pidl),
+	m_numVisits(std::max(numVisits, 1)),
+	m_lastVisitTime(lastVisitTime),
+	m_frecencyKey(frecencyKey)
 {
 }
 
@@ -17,6 +46,7 @@ void LocationVisitInfo::AddVisit(const SystemClock::TimePoint &currentTime)
 {
 	m_numVisits++;
 	m_lastVisitTime = currentTime;
+	m_frecencyKey = AddLogValues(m_frecencyKey, GetDecayExponent(currentTime));
 }
 
 PidlAbsolute LocationVisitInfo::GetLocation() const
@@ -33,3 +63,22 @@ SystemClock::TimePoint LocationVisitInfo::GetLastVisitTime() const
 {
 	return m_lastVisitTime;
 }
+
+double LocationVisitInfo::GetFrecencyKey() const
+{
+	return m_frecencyKey;
+}
+
+double LocationVisitInfo::GetFrecency(const SystemClock::TimePoint &currentTime) const
+{
+	return std::exp(m_frecencyKey - GetDecayExponent(currentTime));
+}
+
+double LocationVisitInfo::GetDecayExponent(const SystemClock::TimePoint &timePoint)
+{
+	using Seconds = std::chrono::duration<double>;
+
+	// A score of 1 at timePoint is equivalent to a score of exp(exponent) at the epoch.
+	constexpr double decayRate = std::numbers::ln2 / Seconds(FRECENCY_HALF_LIFE).count();
+	return decayRate * Seconds(timePoint - DECAY_EPOCH).count();
+}
@@ -6,24 +6,50 @@
 
 #include "../Helper/PidlHelper.h"
 #include "../Helper/SystemClock.h"
+#include <chrono>
 
 // Holds information about visits to a particular location (identified by its pidl).
+//
+// Locations are ranked by frecency (a combination of frequency and recency). Each visit contributes
+// a score of 1, which then decays exponentially, halving every FRECENCY_HALF_LIFE. The frecency of
+// a location at a particular point in time is the sum of the decayed scores of all its visits.
+//
+// Since every score decays at the same rate, the relative order of two locations never changes
+// unless one of them is visited. So, rather than storing the frecency itself (which would need to
+// be updated over time), the value stored is the frecency relative to a fixed epoch (in log space,
+// so that it can't overflow). That value only changes when a location is visited and can be
+// compared directly to rank locations.
 class LocationVisitInfo
 {
 public:
+	static constexpr std::chrono::days FRECENCY_HALF_LIFE{ 30 };
+
+	// The frecency value is derived from the number of visits and last visit time, as if every
+	// visit occurred at that time.
 	LocationVisitInfo(const PidlAbsolute &pidl, int numVisits,
 		const SystemClock::TimePoint &lastVisitTime);
+	LocationVisitInfo(const PidlAbsolute &pidl, int numVisits,
+		const SystemClock::TimePoint &lastVisitTime, double frecencyKey);
 
 	void AddVisit(const SystemClock::TimePoint &currentTime);
 	PidlAbsolute GetLocation() const;
 	int GetNumVisits() const;
 	SystemClock::TimePoint GetLastVisitTime() const;
 
+	// The value used to rank locations. A higher value indicates a higher frecency.
+	double GetFrecencyKey() const;
+
+	// Returns the decayed frecency at the specified time.
+	double GetFrecency(const SystemClock::TimePoint &currentTime) const;
+
 	// This is only used in tests.
 	bool operator==(const LocationVisitInfo &) const = default;
 
 private:
+	static double GetDecayExponent(const SystemClock::TimePoint &timePoint);
+
 	PidlAbsolute m_pidl;
 	int m_numVisits;
 	SystemClock::TimePoint m_lastVisitTime;
+	double m_frecencyKey;
 };
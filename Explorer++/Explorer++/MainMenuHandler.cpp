@@ -21,6 +21,7 @@
 #include "ShellBrowser/ShellBrowserImpl.h"
 #include "ShellBrowser/ShellNavigationController.h"
 #include "TabContainer.h"
+#include "TabMemoryDialog.h"
 #include "../Helper/Helper.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/ProcessHelper.h"
@@ -91,6 +92,16 @@ void Explorerplusplus::OnSearchTabs()
 		});
 }
 
+void Explorerplusplus::OnShowTabMemory()
+{
+	CreateOrSwitchToModelessDialog(m_app->GetModelessDialogList(), L"TabMemoryDialog",
+		[this]
+		{
+			return TabMemoryDialog::Create(m_hContainer, m_app->GetTabList(), m_config,
+				m_app->GetResourceLoader());
+		});
+}
+
 void Explorerplusplus::OnResolveLink()
 {
 	TCHAR szFullFileName[MAX_PATH];
@@ -6,6 +6,8 @@
 #include "MainRebarXmlStorage.h"
 #include "MainRebarStorage.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <optional>
 
 namespace
@@ -69,6 +71,31 @@ void SaveRebarBandInfo(IXMLDOMDocument *xmlDocument, IXMLDOMElement *toolbarNode
 		XMLSettings::EncodeIntValue(bandInfo.length));
 }
 
+std::optional<RebarBandStorageInfo> ReadRebarBandInfo(const XmlReader &reader)
+{
+	auto id = XMLSettings::MaybeGetInt(reader, SETTING_ID);
+	auto style = XMLSettings::MaybeGetInt(reader, SETTING_STYLE);
+	auto length = XMLSettings::MaybeGetInt(reader, SETTING_LENGTH);
+
+	if (!id || !style || !length)
+	{
+		return std::nullopt;
+	}
+
+	RebarBandStorageInfo bandInfo;
+	bandInfo.id = *id;
+	bandInfo.style = *style;
+	bandInfo.length = *length;
+	return bandInfo;
+}
+
+void WriteRebarBandInfo(XmlWriter &writer, const RebarBandStorageInfo &bandInfo)
+{
+	writer.WriteAttribute(SETTING_ID, XMLSettings::EncodeIntValue(bandInfo.id));
+	writer.WriteAttribute(SETTING_STYLE, XMLSettings::EncodeIntValue(bandInfo.style));
+	writer.WriteAttribute(SETTING_LENGTH, XMLSettings::EncodeIntValue(bandInfo.length));
+}
+
 }
 
 namespace MainRebarXmlStorage
@@ -87,4 +114,16 @@ void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *mainRebarNode,
 		TOOLBAR_NODE_NAME, SaveRebarBandInfo);
 }
 
+std::optional<std::vector<RebarBandStorageInfo>> Load(XmlReader &reader)
+{
+	return XMLSettings::ReadItemList<RebarBandStorageInfo>(reader, TOOLBAR_NODE_NAME,
+		ReadRebarBandInfo);
+}
+
+void Save(XmlWriter &writer, const std::vector<RebarBandStorageInfo> &rebarStorageInfo)
+{
+	XMLSettings::SaveItemList<RebarBandStorageInfo>(writer, rebarStorageInfo, TOOLBAR_NODE_NAME,
+		WriteRebarBandInfo);
+}
+
 }
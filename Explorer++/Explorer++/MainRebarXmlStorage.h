@@ -5,9 +5,12 @@
 #pragma once
 
 #include <msxml.h>
+#include <optional>
 #include <vector>
 
 struct RebarBandStorageInfo;
+class XmlReader;
+class XmlWriter;
 
 namespace MainRebarXmlStorage
 {
@@ -16,4 +19,9 @@ std::vector<RebarBandStorageInfo> Load(IXMLDOMNode *mainRebarNode);
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *mainRebarNode,
 	const std::vector<RebarBandStorageInfo> &rebarStorageInfo);
 
+// The reader should be positioned on the main rebar start element. When this returns, the reader
+// will be positioned on the matching end element.
+std::optional<std::vector<RebarBandStorageInfo>> Load(XmlReader &reader);
+void Save(XmlWriter &writer, const std::vector<RebarBandStorageInfo> &rebarStorageInfo);
+
 }
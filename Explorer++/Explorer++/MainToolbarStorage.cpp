@@ -6,6 +6,8 @@
 #include "MainToolbarStorage.h"
 #include "../Helper/RegistrySettings.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <boost/bimap.hpp>
 #include <wil/com.h>
 #include <format>
@@ -190,4 +192,44 @@ void SaveToXml(IXMLDOMDocument *xmlDocument, IXMLDOMElement *toolbarNode,
 	}
 }
 
+MainToolbarButtons LoadFromXml(const XmlReader &reader)
+{
+	MainToolbarButtons buttons;
+
+	for (int index = 0;; index++)
+	{
+		const auto *buttonName =
+			reader.MaybeGetAttribute(std::format(XM_BUTTON_ATTRIBUTE_TEMPLATE, index));
+
+		if (!buttonName)
+		{
+			break;
+		}
+
+		auto itr = XML_BUTTON_NAME_MAPPINGS.right.find(*buttonName);
+
+		if (itr == XML_BUTTON_NAME_MAPPINGS.right.end())
+		{
+			continue;
+		}
+
+		buttons.AddButton(itr->second);
+	}
+
+	return buttons;
+}
+
+void SaveToXml(XmlWriter &writer, const MainToolbarButtons &buttons)
+{
+	int index = 0;
+
+	for (auto button : buttons.GetButtons())
+	{
+		writer.WriteAttribute(std::format(XM_BUTTON_ATTRIBUTE_TEMPLATE, index),
+			XML_BUTTON_NAME_MAPPINGS.left.at(button));
+
+		index++;
+	}
+}
+
 }
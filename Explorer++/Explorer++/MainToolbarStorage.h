@@ -10,6 +10,9 @@
 #include <string>
 #include <vector>
 
+class XmlReader;
+class XmlWriter;
+
 namespace MainToolbarStorage
 {
 
@@ -38,4 +41,8 @@ std::optional<MainToolbarButtons> LoadFromXml(IXMLDOMNode *toolbarNode);
 void SaveToXml(IXMLDOMDocument *xmlDocument, IXMLDOMElement *toolbarNode,
 	const MainToolbarButtons &buttons);
 
+// The buttons are read from (and written to) the attributes of the current element.
+MainToolbarButtons LoadFromXml(const XmlReader &reader);
+void SaveToXml(XmlWriter &writer, const MainToolbarButtons &buttons);
+
 }
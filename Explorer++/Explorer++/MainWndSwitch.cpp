@@ -913,6 +913,10 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, UINT
 		OnSearchTabs();
 		break;
 
+	case IDM_WINDOW_TAB_MEMORY:
+		OnShowTabMemory();
+		break;
+
 	case IDM_HELP_ONLINE_DOCUMENTATION:
 	case IDM_HELP_CHECKFORUPDATES:
 	case IDM_HELP_ABOUT:
@@ -22,10 +22,6 @@ void MenuView::AppendItem(UINT id, const std::wstring &text,
 	std::unique_ptr<const IconModel> iconModel, const std::wstring &helpText,
 	const std::optional<std::wstring> &acceleratorText)
 {
-	// The value 0 shouldn't be used as an item ID. That's because a call like TrackPopupMenu() will
-	// use a return value of 0 to indicate the menu was canceled, or an error occurred.
-	DCHECK_NE(id, 0U);
-
 	std::wstring finalText = text;
 
 	if (acceleratorText)
@@ -33,16 +29,35 @@ void MenuView::AppendItem(UINT id, const std::wstring &text,
 		finalText += L"\t" + *acceleratorText;
 	}
 
+	InsertItem(GetMenuItemCount(GetMenu()), id, finalText, std::move(iconModel), helpText);
+}
+
+void MenuView::PrependItem(UINT id, const std::wstring &text,
+	std::unique_ptr<const IconModel> iconModel, const std::wstring &helpText)
+{
+	InsertItem(0, id, text, std::move(iconModel), helpText);
+}
+
+void MenuView::InsertItem(UINT position, UINT id, const std::wstring &text,
+	std::unique_ptr<const IconModel> iconModel, const std::wstring &helpText)
+{
+	// The value 0 shouldn't be used as an item ID. That's because a call like TrackPopupMenu() will
+	// use a return value of 0 to indicate the menu was canceled, or an error occurred.
+	DCHECK_NE(id, 0U);
+
+	std::wstring finalText = text;
+
 	MENUITEMINFO menuItemInfo = {};
 	menuItemInfo.cbSize = sizeof(menuItemInfo);
 	menuItemInfo.fMask = MIIM_ID | MIIM_STRING;
 	menuItemInfo.wID = id;
 	menuItemInfo.dwTypeData = finalText.data();
 
-	auto res = InsertMenuItem(GetMenu(), GetMenuItemCount(GetMenu()), true, &menuItemInfo);
+	auto res = InsertMenuItem(GetMenu(), position, true, &menuItemInfo);
 	CHECK(res);
 
-	auto [itr, didInsert] = m_idToItemMap.try_emplace(id, std::move(iconModel), helpText);
+	auto [itr, didInsert] =
+		m_idToItemMap.try_emplace(id, std::move(iconModel), helpText, m_itemSerialCounter++);
 	CHECK(didInsert);
 
 	// It's only possible to add images to the menu when the DPI is known (so that the appropriate
@@ -65,7 +80,8 @@ void MenuView::SetItemImage(UINT id)
 	}
 
 	auto bitmap = item->iconModel->GetBitmap(GetCurrentDpi(),
-		[id, self = m_weakPtrFactory.GetWeakPtr()](wil::unique_hbitmap updatedBitmap)
+		[id, serial = item->serial, self = m_weakPtrFactory.GetWeakPtr()](
+			wil::unique_hbitmap updatedBitmap)
 		{
 			if (!self)
 			{
@@ -74,10 +90,19 @@ void MenuView::SetItemImage(UINT id)
 				return;
 			}
 
+			auto itr = self->m_idToItemMap.find(id);
+
+			if (itr == self->m_idToItemMap.end() || itr->second.serial != serial)
+			{
+				// The item has since been removed.
+				return;
+			}
+
 			self->UpdateItemBitmap(id, std::move(updatedBitmap));
 		});
 
 	UpdateItemBitmap(id, std::move(bitmap));
+	GetItem(id)->imageAdded = true;
 }
 
 void MenuView::UpdateItemBitmap(UINT id, wil::unique_hbitmap bitmap)
@@ -96,6 +121,15 @@ void MenuView::UpdateItemBitmap(UINT id, wil::unique_hbitmap bitmap)
 	}
 }
 
+void MenuView::RemoveItem(UINT id)
+{
+	auto res = DeleteMenu(GetMenu(), id, MF_BYCOMMAND);
+	CHECK(res);
+
+	auto numErased = m_idToItemMap.erase(id);
+	CHECK_EQ(numErased, 1u);
+}
+
 void MenuView::AppendSeparator()
 {
 	MenuHelper::AddSeparator(GetMenu());
@@ -166,16 +200,16 @@ std::optional<std::wstring> MenuView::OnHelpTextRequested(HMENU menu, int id)
 
 void MenuView::MaybeAddImagesToMenu()
 {
-	if (GetCurrentDpi() == m_lastRenderedImageDpi)
-	{
-		// The DPI hasn't changed since the images were last added, so there's nothing that needs to
-		// be done.
-		return;
-	}
+	// If the DPI hasn't changed since the images were last added, only the items that have been
+	// inserted since then need to have their images added.
+	bool dpiChanged = GetCurrentDpi() != m_lastRenderedImageDpi;
 
-	for (UINT id : m_idToItemMap | std::views::keys)
+	for (auto &[id, item] : m_idToItemMap)
 	{
-		SetItemImage(id);
+		if (dpiChanged || !item.imageAdded)
+		{
+			SetItemImage(id);
+		}
 	}
 
 	m_lastRenderedImageDpi = GetCurrentDpi();
@@ -29,6 +29,9 @@ public:
 	void AppendItem(UINT id, const std::wstring &text,
 		std::unique_ptr<const IconModel> iconModel = {}, const std::wstring &helpText = L"",
 		const std::optional<std::wstring> &acceleratorText = std::nullopt);
+	void PrependItem(UINT id, const std::wstring &text,
+		std::unique_ptr<const IconModel> iconModel = {}, const std::wstring &helpText = L"");
+	void RemoveItem(UINT id);
 	void AppendSeparator();
 	void EnableItem(UINT id, bool enable);
 	void CheckItem(UINT id, bool check);
@@ -59,17 +62,27 @@ protected:
 private:
 	struct Item
 	{
-		Item(std::unique_ptr<const IconModel> iconModel, const std::wstring &helpText) :
+		Item(std::unique_ptr<const IconModel> iconModel, const std::wstring &helpText,
+			int serial) :
 			iconModel(std::move(iconModel)),
-			helpText(helpText)
+			helpText(helpText),
+			serial(serial)
 		{
 		}
 
 		const std::unique_ptr<const IconModel> iconModel;
 		wil::unique_hbitmap bitmap;
 		const std::wstring helpText;
+
+		// IDs can be reused once an item has been removed, so this is used to determine whether an
+		// updated image is still for the same item.
+		const int serial;
+
+		bool imageAdded = false;
 	};
 
+	void InsertItem(UINT position, UINT id, const std::wstring &text,
+		std::unique_ptr<const IconModel> iconModel, const std::wstring &helpText);
 	void SetItemImage(UINT id);
 	void UpdateItemBitmap(UINT id, wil::unique_hbitmap bitmap);
 	std::optional<std::wstring> OnHelpTextRequested(HMENU menu, int id);
@@ -81,6 +94,7 @@ private:
 	boost::signals2::scoped_connection m_helpTextConnection;
 
 	std::unordered_map<UINT, Item> m_idToItemMap;
+	int m_itemSerialCounter = 0;
 
 	// This will only be set whilst the menu is being shown.
 	std::optional<UINT> m_currentDpi;
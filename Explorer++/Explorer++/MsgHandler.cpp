@@ -804,7 +804,7 @@ void Explorerplusplus::OnShowHiddenFiles()
 {
 	Tab &tab = GetActivePane()->GetTabContainer()->GetSelectedTab();
 	tab.GetShellBrowserImpl()->SetShowHidden(!tab.GetShellBrowserImpl()->GetShowHidden());
-	tab.GetShellBrowserImpl()->GetNavigationController()->Refresh();
+	tab.GetShellBrowserImpl()->Refresh();
 }
 
 void Explorerplusplus::FocusActiveTab()
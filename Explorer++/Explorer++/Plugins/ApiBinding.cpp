@@ -52,6 +52,7 @@ void BindTabsAPI(sol::state &state, TabEvents *tabEvents, TabContainer *tabConta
 	tabsMetaTable.set_function("create", &Plugins::TabsApi::create, tabsApi);
 	tabsMetaTable.set_function("update", &Plugins::TabsApi::update, tabsApi);
 	tabsMetaTable.set_function("refresh", &Plugins::TabsApi::refresh, tabsApi);
+	tabsMetaTable.set_function("getMemoryUsage", &Plugins::TabsApi::getMemoryUsage, tabsApi);
 	tabsMetaTable.set_function("move", &Plugins::TabsApi::move, tabsApi);
 	tabsMetaTable.set_function("close", &Plugins::TabsApi::close, tabsApi);
 
@@ -83,6 +84,15 @@ void BindTabsAPI(sol::state &state, TabEvents *tabEvents, TabContainer *tabConta
 		"addressLocked", &Plugins::TabsApi::Tab::addressLocked,
 		"folderSettings", &Plugins::TabsApi::Tab::folderSettings,
 		"__tostring", &Plugins::TabsApi::Tab::toString);
+
+	tabsMetaTable.new_usertype<Plugins::TabsApi::MemoryUsage>("MemoryUsage",
+		"items", &Plugins::TabsApi::MemoryUsage::items,
+		"thumbnails", &Plugins::TabsApi::MemoryUsage::thumbnails,
+		"history", &Plugins::TabsApi::MemoryUsage::history,
+		"pendingResults", &Plugins::TabsApi::MemoryUsage::pendingResults,
+		"total", &Plugins::TabsApi::MemoryUsage::total,
+		"contentsDiscarded", &Plugins::TabsApi::MemoryUsage::contentsDiscarded,
+		"__tostring", &Plugins::TabsApi::MemoryUsage::toString);
 	// clang-format on
 
 	AddEnum<ViewMode>(state, tabsMetaTable, "ViewMode");
@@ -62,6 +62,29 @@ std::wstring Plugins::TabsApi::Tab::toString()
 	// clang-format on
 }
 
+Plugins::TabsApi::MemoryUsage::MemoryUsage(const ShellBrowser &shellBrowser)
+{
+	auto memoryUsage = shellBrowser.GetMemoryUsage();
+	items = memoryUsage.items;
+	thumbnails = memoryUsage.thumbnails;
+	history = memoryUsage.history;
+	pendingResults = memoryUsage.pendingResults;
+	total = memoryUsage.GetTotal();
+	contentsDiscarded = shellBrowser.AreContentsDiscarded();
+}
+
+std::wstring Plugins::TabsApi::MemoryUsage::toString()
+{
+	// clang-format off
+	return _T("items = ") + std::to_wstring(items)
+		+ _T(", thumbnails = ") + std::to_wstring(thumbnails)
+		+ _T(", history = ") + std::to_wstring(history)
+		+ _T(", pendingResults = ") + std::to_wstring(pendingResults)
+		+ _T(", total = ") + std::to_wstring(total)
+		+ _T(", contentsDiscarded = ") + std::to_wstring(contentsDiscarded);
+	// clang-format on
+}
+
 Plugins::TabsApi::TabsApi(TabContainer *tabContainer, const Config *config) :
 	m_tabContainer(tabContainer),
 	m_config(config)
@@ -291,9 +314,28 @@ void Plugins::TabsApi::refresh(int tabId)
 		return;
 	}
 
+	if (!m_tabContainer->IsTabLoaded(*tabInternal))
+	{
+		// There's nothing to refresh yet, since the folder hasn't been enumerated.
+		m_tabContainer->LoadTab(*tabInternal);
+		return;
+	}
+
 	tabInternal->GetShellBrowserImpl()->GetNavigationController()->Refresh();
 }
 
+std::optional<Plugins::TabsApi::MemoryUsage> Plugins::TabsApi::getMemoryUsage(int tabId)
+{
+	auto tabInternal = m_tabContainer->MaybeGetTab(tabId);
+
+	if (!tabInternal)
+	{
+		return std::nullopt;
+	}
+
+	return MemoryUsage(*tabInternal->GetShellBrowser());
+}
+
 int Plugins::TabsApi::move(int tabId, int newIndex)
 {
 	auto tabInternal = m_tabContainer->MaybeGetTab(tabId);
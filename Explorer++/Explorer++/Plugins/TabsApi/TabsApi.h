@@ -13,6 +13,7 @@
 
 struct Config;
 struct FolderSettings;
+class ShellBrowser;
 class ShellBrowserImpl;
 class TabContainer;
 struct TabSettings;
@@ -53,6 +54,20 @@ public:
 		std::wstring toString();
 	};
 
+	// All sizes are estimates, in bytes.
+	struct MemoryUsage
+	{
+		size_t items;
+		size_t thumbnails;
+		size_t history;
+		size_t pendingResults;
+		size_t total;
+		bool contentsDiscarded;
+
+		MemoryUsage(const ShellBrowser &shellBrowser);
+		std::wstring toString();
+	};
+
 	TabsApi(TabContainer *tabContainer, const Config *config);
 
 	std::vector<Tab> getAll();
@@ -60,6 +75,7 @@ public:
 	int create(sol::table createProperties);
 	void update(int tabId, sol::table properties);
 	void refresh(int tabId);
+	std::optional<MemoryUsage> getMemoryUsage(int tabId);
 	int move(int tabId, int newIndex);
 	bool close(int tabId);
 
@@ -11,6 +11,7 @@
 #include "DefaultColumnRegistryStorage.h"
 #include "DialogStorageHelper.h"
 #include "FrequentLocationsRegistryStorage.h"
+#include "HistoryRegistryStorage.h"
 #include "MainRebarStorage.h"
 #include "TabStorage.h"
 #include "WindowRegistryStorage.h"
@@ -61,6 +62,11 @@ void RegistryAppStorage::LoadFrequentLocations(FrequentLocationsModel *frequentL
 	FrequentLocationsRegistryStorage::Load(m_applicationKey.get(), frequentLocationsModel);
 }
 
+void RegistryAppStorage::LoadHistory(HistoryModel *historyModel)
+{
+	HistoryRegistryStorage::Load(m_applicationKey.get(), historyModel);
+}
+
 void RegistryAppStorage::SaveConfig(const Config &config)
 {
 	ConfigRegistryStorage::Save(m_applicationKey.get(), config);
@@ -101,6 +107,11 @@ void RegistryAppStorage::SaveFrequentLocations(const FrequentLocationsModel *fre
 	FrequentLocationsRegistryStorage::Save(m_applicationKey.get(), frequentLocationsModel);
 }
 
+void RegistryAppStorage::SaveHistory(const HistoryModel *historyModel)
+{
+	HistoryRegistryStorage::Save(m_applicationKey.get(), historyModel);
+}
+
 void RegistryAppStorage::Commit()
 {
 }
@@ -5,6 +5,8 @@
 #include "stdafx.h"
 #include "SearchTabsDialog.h"
 #include "MainResource.h"
+#include "OneShotTimer.h"
+#include "OneShotTimerManager.h"
 #include "ResourceLoader.h"
 #include "SearchTabsModel.h"
 #include "ShellBrowser/ShellBrowserImpl.h"
@@ -31,12 +33,22 @@ SearchTabsDialog::SearchTabsDialog(HWND parent, std::unique_ptr<SearchTabsModel>
 	m_model->SetSearchTerm(m_persistentSettings->m_searchTerm);
 }
 
+SearchTabsDialog::~SearchTabsDialog() = default;
+
 INT_PTR SearchTabsDialog::OnInitDialog()
 {
+	m_timerManager = std::make_unique<OneShotTimerManager>(m_hDlg);
+	m_refreshTimer = std::make_unique<OneShotTimer>(m_timerManager.get());
+
 	SetupListView();
 	SetupEditControl();
 
-	m_model->updatedSignal.AddObserver(std::bind_front(&SearchTabsDialog::RefreshTabList, this));
+	m_model->updatedSignal.AddObserver(std::bind_front(&SearchTabsDialog::OnModelUpdated, this));
+
+	// The list view items reference the tabs directly, so the list can't wait to be refreshed
+	// once a tab has been removed.
+	m_model->tabRemovedSignal.AddObserver(
+		std::bind_front(&SearchTabsDialog::RefreshTabList, this));
 
 	SendMessage(m_hDlg, WM_NEXTDLGCTL,
 		reinterpret_cast<WPARAM>(GetDlgItem(m_hDlg, IDC_SEARCH_TABS_SEARCH_TERM)), true);
@@ -126,8 +138,33 @@ std::wstring SearchTabsDialog::GetColumnText(ColumnType columnType)
 	return m_resourceLoader->LoadString(stringId);
 }
 
+void SearchTabsDialog::OnModelUpdated()
+{
+	// Changes to the search term are applied immediately, so that the results keep up with what's
+	// being typed. Other changes (e.g. tabs being selected or navigated) can arrive in rapid
+	// bursts, with each one requiring the entire list to be rebuilt, so they're coalesced.
+	if (m_model->GetSearchTerm() != m_displayedSearchTerm)
+	{
+		RefreshTabList();
+		return;
+	}
+
+	if (m_refreshPending)
+	{
+		return;
+	}
+
+	m_refreshTimer->Start(REFRESH_DELAY, std::bind_front(&SearchTabsDialog::RefreshTabList, this));
+	m_refreshPending = true;
+}
+
 void SearchTabsDialog::RefreshTabList()
 {
+	// If a delayed refresh is pending, it's no longer needed, since the list is being refreshed
+	// now.
+	m_refreshTimer->Stop();
+	m_refreshPending = false;
+
 	HWND listView = GetDlgItem(m_hDlg, IDC_SEARCH_TABS_TAB_LIST);
 
 	ScopedRedrawDisabler redrawDisabler(listView);
@@ -140,6 +177,8 @@ void SearchTabsDialog::AddTabs()
 	HWND listView = GetDlgItem(m_hDlg, IDC_SEARCH_TABS_TAB_LIST);
 	int index = 0;
 
+	m_displayedSearchTerm = m_model->GetSearchTerm();
+
 	for (auto *tab : m_model->GetResults())
 	{
 		AddTab(tab, index);
@@ -7,9 +7,13 @@
 #include "BaseDialog.h"
 #include "../Helper/DialogSettings.h"
 #include <boost/signals2.hpp>
+#include <chrono>
 #include <memory>
+#include <string>
 #include <vector>
 
+class OneShotTimer;
+class OneShotTimerManager;
 class ResourceLoader;
 class SearchTabsDialog;
 class SearchTabsModel;
@@ -59,9 +63,13 @@ private:
 	static inline const Column COLUMNS[] = { { ColumnType::TabName, 0.3f },
 		{ ColumnType::Path, 0.7f } };
 
+	// Updates that aren't the result of the search term changing are delayed by this amount, so
+	// that a burst of updates only results in a single refresh.
+	static constexpr std::chrono::milliseconds REFRESH_DELAY{ 100 };
+
 	SearchTabsDialog(HWND parent, std::unique_ptr<SearchTabsModel> model,
 		const ResourceLoader *resourceLoader);
-	~SearchTabsDialog() = default;
+	~SearchTabsDialog();
 
 	INT_PTR OnInitDialog() override;
 	wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
@@ -70,6 +78,7 @@ private:
 	void InsertColumns();
 	void InsertColumn(const Column &column, int index);
 	std::wstring GetColumnText(ColumnType columnType);
+	void OnModelUpdated();
 	void RefreshTabList();
 	void AddTabs();
 	void AddTab(const Tab *tab, int index);
@@ -90,6 +99,10 @@ private:
 	void SaveState() override;
 
 	const std::unique_ptr<SearchTabsModel> m_model;
+	std::unique_ptr<OneShotTimerManager> m_timerManager;
+	std::unique_ptr<OneShotTimer> m_refreshTimer;
+	bool m_refreshPending = false;
+	std::wstring m_displayedSearchTerm;
 	std::unique_ptr<WindowSubclass> m_editSubclass;
 	std::vector<boost::signals2::scoped_connection> m_connections;
 	SearchTabsDialogPersistentSettings *m_persistentSettings;
@@ -5,6 +5,7 @@
 #include "stdafx.h"
 #include "SearchTabsModel.h"
 #include "ShellBrowser/NavigationEvents.h"
+#include "ShellBrowser/NavigationRequest.h"
 #include "ShellBrowser/ShellBrowser.h"
 #include "ShellBrowser/ShellBrowserEvents.h"
 #include "ShellBrowser/ShellNavigationController.h"
@@ -12,7 +13,7 @@
 #include "TabEvents.h"
 #include "TabList.h"
 #include "../Helper/ShellHelper.h"
-#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
 #include <ranges>
 
 SearchTabsModel::SearchTabsModel(const TabList *tabList, TabEvents *tabEvents,
@@ -20,21 +21,24 @@ SearchTabsModel::SearchTabsModel(const TabList *tabList, TabEvents *tabEvents,
 	m_tabList(tabList)
 {
 	m_connections.push_back(tabEvents->AddCreatedObserver(
-		std::bind(&SearchTabsModel::OnTabsChanged, this), TabEventScope::Global()));
+		std::bind(&SearchTabsModel::OnTabCreated, this), TabEventScope::Global()));
 	m_connections.push_back(tabEvents->AddSelectedObserver(
-		std::bind(&SearchTabsModel::OnTabsChanged, this), TabEventScope::Global()));
+		std::bind(&SearchTabsModel::OnTabSelectedOrMoved, this), TabEventScope::Global()));
 	m_connections.push_back(tabEvents->AddUpdatedObserver(
-		std::bind(&SearchTabsModel::OnTabsChanged, this), TabEventScope::Global()));
+		std::bind(&SearchTabsModel::OnTabUpdated, this, std::placeholders::_1),
+		TabEventScope::Global()));
 	m_connections.push_back(tabEvents->AddMovedObserver(
-		std::bind(&SearchTabsModel::OnTabsChanged, this), TabEventScope::Global()));
+		std::bind(&SearchTabsModel::OnTabSelectedOrMoved, this), TabEventScope::Global()));
 	m_connections.push_back(tabEvents->AddRemovedObserver(
-		std::bind(&SearchTabsModel::OnTabsChanged, this), TabEventScope::Global()));
+		std::bind_front(&SearchTabsModel::OnTabRemoved, this), TabEventScope::Global()));
 
 	m_connections.push_back(shellBrowserEvents->AddDirectoryPropertiesChangedObserver(
-		std::bind(&SearchTabsModel::OnTabsChanged, this), ShellBrowserEventScope::Global()));
+		std::bind_front(&SearchTabsModel::OnDirectoryPropertiesChanged, this),
+		ShellBrowserEventScope::Global()));
 
 	m_connections.push_back(navigationEvents->AddCommittedObserver(
-		std::bind(&SearchTabsModel::OnTabsChanged, this), NavigationEventScope::Global()));
+		std::bind_front(&SearchTabsModel::OnNavigationCommitted, this),
+		NavigationEventScope::Global()));
 }
 
 void SearchTabsModel::SetSearchTerm(const std::wstring &searchTerm)
@@ -59,35 +63,145 @@ concurrencpp::generator<Tab *> SearchTabsModel::GetResults() const
 {
 	auto tabs = m_tabList->GetAllByLastActiveTime();
 
-	for (auto *tab : tabs | std::views::filter(std::bind_front(&SearchTabsModel::TabFilter, this)))
+	if (m_searchTerm.empty())
+	{
+		for (auto *tab : tabs)
+		{
+			co_yield tab;
+		}
+
+		co_return;
+	}
+
+	FuzzyMatcher matcher(m_searchTerm);
+
+	// If the search term has only been extended since the last search, only the tabs that matched
+	// previously can match now.
+	const std::unordered_set<int> *candidateTabIds = nullptr;
+
+	if (m_previousMatches && matcher.Refines(m_previousMatches->matcher))
 	{
-		co_yield tab;
+		candidateTabIds = &m_previousMatches->tabIds;
 	}
+
+	struct ScoredTab
+	{
+		Tab *tab;
+		int score;
+	};
+
+	std::vector<ScoredTab> matches;
+	std::unordered_set<int> matchedTabIds;
+
+	for (auto *tab : tabs)
+	{
+		if (candidateTabIds && !candidateTabIds->contains(tab->GetId()))
+		{
+			continue;
+		}
+
+		auto score = GetMatchScore(tab, matcher);
+
+		if (!score)
+		{
+			continue;
+		}
+
+		matches.push_back({ tab, *score });
+		matchedTabIds.insert(tab->GetId());
+	}
+
+	m_previousMatches.emplace(std::move(matcher), std::move(matchedTabIds));
+
+	// The sort is stable, so tabs with the same score remain ordered by last active time.
+	std::ranges::stable_sort(matches, std::ranges::greater(), &ScoredTab::score);
+
+	for (const auto &match : matches)
+	{
+		co_yield match.tab;
+	}
+}
+
+void SearchTabsModel::OnTabCreated()
+{
+	// The new tab may match the current search term, so the previous results can't be narrowed.
+	m_previousMatches.reset();
+
+	updatedSignal.m_signal();
 }
 
-void SearchTabsModel::OnTabsChanged()
+void SearchTabsModel::OnTabSelectedOrMoved()
 {
+	// Neither of these changes affect which tabs match, only the order in which they're returned.
 	updatedSignal.m_signal();
 }
 
-bool SearchTabsModel::TabFilter(const Tab *tab) const
+void SearchTabsModel::OnTabUpdated(const Tab &tab)
 {
-	if (m_searchTerm.empty())
-	{
-		return true;
-	}
+	InvalidateTab(tab.GetId());
 
-	if (boost::icontains(tab->GetName(), m_searchTerm))
+	updatedSignal.m_signal();
+}
+
+void SearchTabsModel::OnTabRemoved(const Tab &tab)
+{
+	// There's no need to invalidate the previous matches here. The tab will no longer be returned
+	// by the tab list and so won't be considered.
+	m_tabTextCache.erase(tab.GetId());
+
+	updatedSignal.m_signal();
+	tabRemovedSignal.m_signal();
+}
+
+void SearchTabsModel::OnDirectoryPropertiesChanged(const ShellBrowser *shellBrowser)
+{
+	InvalidateTab(shellBrowser->GetTab()->GetId());
+
+	updatedSignal.m_signal();
+}
+
+void SearchTabsModel::OnNavigationCommitted(const NavigationRequest *request)
+{
+	InvalidateTab(request->GetShellBrowser()->GetTab()->GetId());
+
+	updatedSignal.m_signal();
+}
+
+void SearchTabsModel::InvalidateTab(int tabId)
+{
+	m_tabTextCache.erase(tabId);
+
+	// The tab may now match the search term, when it didn't previously.
+	m_previousMatches.reset();
+}
+
+std::optional<int> SearchTabsModel::GetMatchScore(const Tab *tab,
+	const FuzzyMatcher &matcher) const
+{
+	const auto &tabText = GetTabText(tab);
+	auto nameScore = matcher.Match(tabText.name);
+	auto directoryScore = matcher.Match(tabText.directory);
+
+	if (nameScore && directoryScore)
 	{
-		return true;
+		return std::max(*nameScore, *directoryScore);
 	}
 
-	if (boost::icontains(GetTabDirectory(tab), m_searchTerm))
+	return nameScore ? nameScore : directoryScore;
+}
+
+const SearchTabsModel::TabText &SearchTabsModel::GetTabText(const Tab *tab) const
+{
+	auto itr = m_tabTextCache.find(tab->GetId());
+
+	if (itr == m_tabTextCache.end())
 	{
-		return true;
+		TabText tabText = { .name = FuzzyMatcher::NormalizeText(tab->GetName()),
+			.directory = FuzzyMatcher::NormalizeText(GetTabDirectory(tab)) };
+		itr = m_tabTextCache.emplace(tab->GetId(), std::move(tabText)).first;
 	}
 
-	return false;
+	return itr->second;
 }
 
 std::wstring SearchTabsModel::GetTabDirectory(const Tab *tab)
@@ -4,42 +4,84 @@
 
 #pragma once
 
+#include "../Helper/FuzzyMatcher.h"
 #include "../Helper/SignalWrapper.h"
 #include <boost/signals2.hpp>
 #include <concurrencpp/concurrencpp.h>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class NavigationEvents;
+class NavigationRequest;
+class ShellBrowser;
 class ShellBrowserEvents;
 class Tab;
 class TabEvents;
 class TabList;
 
 // Represents the set of all tabs, optionally filtered by a search term.
+//
+// Matching is designed to stay fast with a large number of tabs. The lowercased name and directory
+// of each tab are cached, and only recalculated when the tab changes. When the search term is
+// extended (which is what happens as the user types), only the tabs that matched the previous
+// search term are considered, since no other tab can match the new term.
 class SearchTabsModel
 {
 public:
 	// Signals
 	SignalWrapper<SearchTabsModel, void()> updatedSignal;
 
+	// Triggered after updatedSignal when a tab is removed. Observers that hold on to tab pointers
+	// returned by `GetResults` need to drop them at this point, even if they otherwise delay
+	// processing updates.
+	SignalWrapper<SearchTabsModel, void()> tabRemovedSignal;
+
 	SearchTabsModel(const TabList *tabList, TabEvents *tabEvents,
 		ShellBrowserEvents *shellBrowserEvents, NavigationEvents *navigationEvents);
 
 	// When the search term is empty, no filtering will be applied. Otherwise, the search term will
-	// be matched against each tab's name and directory, with only matching tabs being returned by
-	// `GetResults`.
+	// be fuzzy matched against each tab's name and directory, with only matching tabs being
+	// returned by `GetResults`.
 	void SetSearchTerm(const std::wstring &searchTerm);
 	const std::wstring &GetSearchTerm() const;
 
+	// Results are ordered from best match to worst match. Tabs that match equally well (or all
+	// tabs, if there's no search term) are ordered by last active time.
 	concurrencpp::generator<Tab *> GetResults() const;
 
 private:
-	void OnTabsChanged();
-	bool TabFilter(const Tab *tab) const;
+	// The normalized text for a tab that's used for matching.
+	struct TabText
+	{
+		std::wstring name;
+		std::wstring directory;
+	};
+
+	// The set of tabs that matched the most recent search.
+	struct PreviousMatches
+	{
+		FuzzyMatcher matcher;
+		std::unordered_set<int> tabIds;
+	};
+
+	void OnTabCreated();
+	void OnTabSelectedOrMoved();
+	void OnTabUpdated(const Tab &tab);
+	void OnTabRemoved(const Tab &tab);
+	void OnDirectoryPropertiesChanged(const ShellBrowser *shellBrowser);
+	void OnNavigationCommitted(const NavigationRequest *request);
+	void InvalidateTab(int tabId);
+
+	std::optional<int> GetMatchScore(const Tab *tab, const FuzzyMatcher &matcher) const;
+	const TabText &GetTabText(const Tab *tab) const;
 	static std::wstring GetTabDirectory(const Tab *tab);
 
 	const TabList *const m_tabList;
 	std::wstring m_searchTerm;
+	mutable std::unordered_map<int, TabText> m_tabTextCache;
+	mutable std::optional<PreviousMatches> m_previousMatches;
 	std::vector<boost::signals2::scoped_connection> m_connections;
 };
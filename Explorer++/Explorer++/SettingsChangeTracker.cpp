@@ -0,0 +1,70 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "SettingsChangeTracker.h"
+#include "ApplicationModel.h"
+#include "ColorRuleModel.h"
+#include "FrequentLocationsModel.h"
+#include "HistoryModel.h"
+#include "TabEvents.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "ShellBrowser/NavigationEvents.h"
+
+using Section = IncrementalSettingsWriter::Section;
+
+SettingsChangeTracker::SettingsChangeTracker(IncrementalSettingsWriter *writer,
+	BookmarkTree *bookmarkTree, ColorRuleModel *colorRuleModel,
+	Applications::ApplicationModel *applicationModel,
+	FrequentLocationsModel *frequentLocationsModel, HistoryModel *historyModel,
+	TabEvents *tabEvents, NavigationEvents *navigationEvents) :
+	m_writer(writer)
+{
+	// Note that std::bind() is used here, since it discards the arguments passed by each signal.
+	auto markBookmarksDirty =
+		std::bind(&SettingsChangeTracker::MarkDirty, this, Section::Bookmarks);
+	m_connections.push_back(bookmarkTree->bookmarkItemAddedSignal.AddObserver(markBookmarksDirty));
+	m_connections.push_back(
+		bookmarkTree->bookmarkItemUpdatedSignal.AddObserver(markBookmarksDirty));
+	m_connections.push_back(bookmarkTree->bookmarkItemMovedSignal.AddObserver(markBookmarksDirty));
+	m_connections.push_back(
+		bookmarkTree->bookmarkItemRemovedSignal.AddObserver(markBookmarksDirty));
+
+	ObserveMovableModel(colorRuleModel, Section::ColorRules);
+	ObserveMovableModel(applicationModel, Section::Applications);
+
+	m_connections.push_back(frequentLocationsModel->AddLocationsChangedObserver(
+		std::bind(&SettingsChangeTracker::MarkDirty, this, Section::FrequentLocations)));
+	m_connections.push_back(historyModel->AddHistoryChangedObserver(
+		std::bind(&SettingsChangeTracker::MarkDirty, this, Section::History)));
+
+	auto markWindowsDirty = std::bind(&SettingsChangeTracker::MarkDirty, this, Section::Windows);
+	m_connections.push_back(
+		tabEvents->AddCreatedObserver(markWindowsDirty, TabEventScope::Global()));
+	m_connections.push_back(
+		tabEvents->AddSelectedObserver(markWindowsDirty, TabEventScope::Global()));
+	m_connections.push_back(tabEvents->AddMovedObserver(markWindowsDirty, TabEventScope::Global()));
+	m_connections.push_back(
+		tabEvents->AddRemovedObserver(markWindowsDirty, TabEventScope::Global()));
+	m_connections.push_back(
+		tabEvents->AddUpdatedObserver(markWindowsDirty, TabEventScope::Global()));
+	m_connections.push_back(
+		navigationEvents->AddCommittedObserver(markWindowsDirty, NavigationEventScope::Global()));
+}
+
+template <typename Model>
+void SettingsChangeTracker::ObserveMovableModel(Model *model, Section section)
+{
+	auto markDirty = std::bind(&SettingsChangeTracker::MarkDirty, this, section);
+	m_connections.push_back(model->AddItemAddedObserver(markDirty));
+	m_connections.push_back(model->AddItemUpdatedObserver(markDirty));
+	m_connections.push_back(model->AddItemMovedObserver(markDirty));
+	m_connections.push_back(model->AddItemRemovedObserver(markDirty));
+	m_connections.push_back(model->AddAllItemsRemovedObserver(markDirty));
+}
+
+void SettingsChangeTracker::MarkDirty(Section section)
+{
+	m_writer->MarkDirty(section);
+}
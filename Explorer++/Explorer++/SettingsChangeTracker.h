@@ -0,0 +1,42 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "IncrementalSettingsWriter.h"
+#include <boost/signals2.hpp>
+#include <vector>
+
+class BookmarkTree;
+class ColorRuleModel;
+class FrequentLocationsModel;
+class HistoryModel;
+class NavigationEvents;
+class TabEvents;
+
+namespace Applications
+{
+class ApplicationModel;
+}
+
+// Marks sections of the config file as dirty when the data they contain changes. Not every section
+// has change notifications (e.g. the window layout and most of the config don't), so the owner is
+// also expected to periodically mark those sections as dirty.
+class SettingsChangeTracker
+{
+public:
+	SettingsChangeTracker(IncrementalSettingsWriter *writer, BookmarkTree *bookmarkTree,
+		ColorRuleModel *colorRuleModel, Applications::ApplicationModel *applicationModel,
+		FrequentLocationsModel *frequentLocationsModel, HistoryModel *historyModel,
+		TabEvents *tabEvents, NavigationEvents *navigationEvents);
+
+private:
+	template <typename Model>
+	void ObserveMovableModel(Model *model, IncrementalSettingsWriter::Section section);
+
+	void MarkDirty(IncrementalSettingsWriter::Section section);
+
+	IncrementalSettingsWriter *const m_writer;
+	std::vector<boost::signals2::scoped_connection> m_connections;
+};
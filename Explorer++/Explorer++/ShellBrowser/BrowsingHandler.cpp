@@ -5,15 +5,19 @@
 #include "stdafx.h"
 #include "ShellBrowserImpl.h"
 #include "App.h"
+#include "BrowserWindow.h"
 #include "ColumnDataRetrieval.h"
 #include "Config.h"
 #include "DocumentServiceProvider.h"
 #include "FeatureList.h"
+#include "FolderListingCache.h"
+#include "FolderPrefetcher.h"
 #include "HistoryEntry.h"
-#include "IconFetcher.h"
+#include "IconFetcherImpl.h"
 #include "ItemData.h"
 #include "MainResource.h"
 #include "NavigationRequest.h"
+#include "Runtime.h"
 #include "RuntimeHelper.h"
 #include "ShellEnumeratorImpl.h"
 #include "ShellNavigationController.h"
@@ -29,12 +33,20 @@
 #include <propkey.h>
 #include <propvarutil.h>
 #include <list>
+#include <ranges>
 
 void ShellBrowserImpl::OnNavigationStarted(const NavigationRequest *request)
 {
 	CHECK(request->GetShellBrowser() == this);
 
 	RecalcWindowCursor(m_listView);
+
+	// Any folders that were being prefetched were chosen based on the folder that was being
+	// shown, so are unlikely to be relevant once the user has navigated elsewhere.
+	if (IsFolderPrefetchEnabled())
+	{
+		m_app->GetFolderPrefetcher()->CancelAll();
+	}
 }
 
 void ShellBrowserImpl::ChangeFolders(const PidlAbsolute &directory)
@@ -80,20 +92,38 @@ void ShellBrowserImpl::PrepareToChangeFolders()
 
 void ShellBrowserImpl::ClearPendingResults()
 {
-	m_columnThreadPool.clear_queue();
+	ResetNavigationTaskGroups();
+
 	m_columnResults.clear();
 
 	m_iconFetcher->ClearQueue();
 
-	m_thumbnailThreadPool.clear_queue();
 	m_thumbnailResults.clear();
-
-	m_infoTipsThreadPool.clear_queue();
 	m_infoTipResults.clear();
 }
 
+void ShellBrowserImpl::ResetNavigationTaskGroups()
+{
+	if (m_navigationTaskGroup)
+	{
+		m_taskScheduler->CancelGroup(m_navigationTaskGroup);
+	}
+
+	m_navigationTaskGroup = m_taskScheduler->CreateGroup(m_taskGroup);
+	m_columnTaskGroup = m_taskScheduler->CreateGroup(m_navigationTaskGroup);
+	m_thumbnailTaskGroup = m_taskScheduler->CreateGroup(m_navigationTaskGroup);
+	m_infoTipTaskGroup = m_taskScheduler->CreateGroup(m_navigationTaskGroup);
+}
+
 void ShellBrowserImpl::StoreCurrentlySelectedItems()
 {
+	if (m_contentsDiscarded)
+	{
+		// The selection was saved when the contents were discarded. The listview is empty now, so
+		// the selection shouldn't be updated.
+		return;
+	}
+
 	auto *entry = m_navigationController->GetCurrentEntry();
 	auto selectedItems = GetSelectedItemPidls();
 	entry->SetSelectedItems(selectedItems);
@@ -454,6 +484,8 @@ void ShellBrowserImpl::OnNavigationComitted(const NavigationRequest *request)
 {
 	CHECK(request->GetShellBrowser() == this);
 
+	m_contentsDiscarded = false;
+
 	ChangeFolders(request->GetNavigateParams().pidl);
 
 	NotifyShellOfNavigation(request->GetNavigateParams().pidl.Raw());
@@ -465,6 +497,118 @@ void ShellBrowserImpl::OnNavigationComitted(const NavigationRequest *request)
 	AddNavigationItems(request, request->GetItems());
 
 	SetNavigationState(NavigationState::Committed);
+
+	if (request->IsListingFromCache())
+	{
+		VerifyCachedListing(m_weakPtrFactory.GetWeakPtr(), m_shellEnumerator,
+			m_app->GetFolderListingCache(), request->GetNavigateParams().pidl,
+			request->GetItems(), m_app->GetRuntime());
+	}
+
+	PrefetchLikelyNavigationTargets();
+}
+
+// A navigation that was served from the listing cache may show out of date items (e.g. if items
+// were added or modified while the folder wasn't being monitored). This enumerates the folder in
+// the background and, if the contents differ, updates the folder to match the new listing.
+concurrencpp::null_result ShellBrowserImpl::VerifyCachedListing(WeakPtr<ShellBrowserImpl> weakSelf,
+	std::shared_ptr<const ShellEnumerator> shellEnumerator,
+	std::shared_ptr<FolderListingCache> listingCache, PidlAbsolute directory,
+	std::vector<PidlChild> cachedItems, Runtime *runtime)
+{
+	// This is called on the UI thread, so the sequence number can be read before switching threads.
+	uint64_t directoryChangeSequenceNumber = weakSelf->m_directoryChangeSequenceNumber;
+
+	co_await ResumeOnComStaThread(runtime);
+
+	std::vector<PidlChild> items;
+	HRESULT hr = shellEnumerator->EnumerateDirectory(directory.Raw(), items, {});
+
+	if (FAILED(hr) || FolderListingCache::AreListingsEqual(items, cachedItems))
+	{
+		co_return;
+	}
+
+	listingCache->Store(directory, shellEnumerator->GetEnumerationFlags(), items);
+
+	co_await concurrencpp::resume_on(runtime->GetUiThreadExecutor());
+
+	// Navigating away from the folder will invalidate this WeakPtr, so if it's still valid, the
+	// folder being verified is still the current folder.
+	if (!weakSelf)
+	{
+		co_return;
+	}
+
+	if (weakSelf->m_inBackgroundState)
+	{
+		weakSelf->m_changedInBackgroundState = true;
+		co_return;
+	}
+
+	if (weakSelf->m_directoryChangeSequenceNumber != directoryChangeSequenceNumber)
+	{
+		// The folder changed while it was being enumerated, so the listing retrieved above may
+		// already be out of date and the folder needs to be enumerated again.
+		weakSelf->RefreshFromListing(std::nullopt);
+		co_return;
+	}
+
+	weakSelf->RefreshFromListing(std::move(items));
+}
+
+bool ShellBrowserImpl::IsFolderPrefetchEnabled() const
+{
+	// The prefetcher is only created when the feature is enabled.
+	return m_app->GetFolderPrefetcher() != nullptr;
+}
+
+void ShellBrowserImpl::PrefetchFolder(const PidlAbsolute &folder)
+{
+	if (!IsFolderPrefetchEnabled())
+	{
+		return;
+	}
+
+	m_app->GetFolderPrefetcher()->Prefetch(folder, m_shellEnumerator);
+}
+
+void ShellBrowserImpl::PrefetchLikelyNavigationTargets()
+{
+	// Only the tab the user is currently interacting with is relevant here. Tabs that are loaded
+	// in the background (e.g. when restoring tabs on startup) shouldn't queue any work.
+	if (!IsFolderPrefetchEnabled()
+		|| m_browser->GetLifecycleState() != BrowserWindow::LifecycleState::Main
+		|| m_browser->GetActiveShellBrowser() != this)
+	{
+		return;
+	}
+
+	std::vector<PidlAbsolute> frequentLocations;
+
+	for (const auto &visit : m_app->GetFrequentLocationsModel()->GetVisits()
+			| std::views::take(NUM_FREQUENT_LOCATIONS_TO_PREFETCH))
+	{
+		if (visit.GetLocation() != m_directoryState.pidlDirectory)
+		{
+			frequentLocations.push_back(visit.GetLocation());
+		}
+	}
+
+	// More recent requests are processed first, so the requests here are queued in reverse order
+	// of likelihood.
+	for (const auto &location : frequentLocations | std::views::reverse)
+	{
+		PrefetchFolder(location);
+	}
+
+	unique_pidl_absolute parent;
+	HRESULT hr = GetVirtualParentPath(m_directoryState.pidlDirectory.Raw(), wil::out_param(parent));
+
+	if (SUCCEEDED(hr))
+	{
+		PrefetchFolder(parent.get());
+	}
 }
 
 void ShellBrowserImpl::AddNavigationItems(const NavigationRequest *request,
@@ -19,38 +19,45 @@
 
 void ShellBrowserImpl::QueueColumnTask(int itemInternalIndex, ColumnType columnType)
 {
+	if (m_inBackgroundState)
+	{
+		m_workDroppedInBackgroundState = true;
+		return;
+	}
+
 	int columnResultID = m_columnResultIDCounter++;
 
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(itemInternalIndex);
 	GlobalFolderSettings globalFolderSettings = m_config->globalFolderSettings;
 
-	auto result = m_columnThreadPool.push(
-		[listView = m_listView, columnResultID, columnType, itemInternalIndex, basicItemInfo,
-			globalFolderSettings](int id)
+	auto result = m_taskScheduler->Push(
+		m_columnTaskGroup, TaskScheduler::Priority::Visible,
+		[notifyReady = MakeResultReadyNotifier(WM_APP_COLUMN_RESULT_READY, columnResultID),
+			columnType, itemInternalIndex, basicItemInfo, globalFolderSettings]
 		{
-			UNREFERENCED_PARAMETER(id);
-
-			return GetColumnTextAsync(listView, columnResultID, columnType, itemInternalIndex,
-				basicItemInfo, globalFolderSettings);
-		});
+			return GetColumnTextAsync(notifyReady, columnType, itemInternalIndex, basicItemInfo,
+				globalFolderSettings);
+		},
+		columnResultID);
 
 	// The function call above might finish before this line runs,
 	// but that doesn't matter, as the results won't be processed
-	// until a message posted to the main thread has been handled
-	// (which can only occur after this function has returned).
-	m_columnResults.insert({ columnResultID, std::move(result) });
+	// until the main thread has been notified (which can only be
+	// handled after this function has returned).
+	m_columnResults.insert(
+		{ columnResultID, { itemInternalIndex, columnType, std::move(result) } });
 }
 
-ShellBrowserImpl::ColumnResult_t ShellBrowserImpl::GetColumnTextAsync(HWND listView,
-	int columnResultId, ColumnType columnType, int internalIndex,
+ShellBrowserImpl::ColumnResult_t ShellBrowserImpl::GetColumnTextAsync(
+	const std::function<void()> &notifyReady, ColumnType columnType, int internalIndex,
 	const BasicItemInfo_t &basicItemInfo, const GlobalFolderSettings &globalFolderSettings)
 {
 	std::wstring columnText = GetColumnText(columnType, basicItemInfo, globalFolderSettings);
 
-	// This message may be delivered before this function has returned.
-	// That doesn't actually matter, since the message handler will
-	// simply wait for the result to be returned.
-	PostMessage(listView, WM_APP_COLUMN_RESULT_READY, columnResultId, 0);
+	// The notification may be handled before this function has returned.
+	// That doesn't actually matter, since the handler will simply wait
+	// for the result to be returned.
+	notifyReady();
 
 	ColumnResult_t result;
 	result.itemInternalIndex = internalIndex;
@@ -75,7 +82,7 @@ void ShellBrowserImpl::ProcessColumnResult(int columnResultId)
 		return;
 	}
 
-	auto result = itr->second.get();
+	auto result = itr->second.result.get();
 
 	auto index = LocateItemByInternalIndex(result.itemInternalIndex);
 
@@ -7,12 +7,16 @@
 #include "App.h"
 #include "ColumnDataRetrieval.h"
 #include "Config.h"
+#include "FeatureList.h"
+#include "FolderListingCache.h"
 #include "ItemData.h"
 #include "NavigateParams.h"
 #include "Runtime.h"
 #include "RuntimeHelper.h"
+#include "ShellEnumeratorImpl.h"
 #include "ShellNavigationController.h"
 #include "ViewModes.h"
+#include "../Helper/AutoReset.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/ScopedRedrawDisabler.h"
 #include "../Helper/ShellHelper.h"
@@ -20,6 +24,11 @@
 
 void ShellBrowserImpl::StartDirectoryMonitoring()
 {
+	// Any changes that haven't been applied yet relate to the previous listing, so can be
+	// discarded.
+	m_directoryChangeTimer.cancel();
+	m_directoryChangeCoalescer.Clear();
+
 	m_directoryState.directoryWatcher = m_app->GetDirectoryWatcherFactory()->MaybeCreate(
 		m_directoryState.pidlDirectory, DirectoryWatcher::Filters::All,
 		std::bind_front(&ShellBrowserImpl::ProcessDirectoryChangeNotification, this),
@@ -44,6 +53,152 @@ void ShellBrowserImpl::StartDirectoryMonitoring()
 void ShellBrowserImpl::ProcessDirectoryChangeNotification(DirectoryWatcher::Event event,
 	const PidlAbsolute &simplePidl1, const PidlAbsolute &simplePidl2)
 {
+	m_directoryChangeSequenceNumber++;
+
+	if (m_app->GetFeatureList()->IsEnabled(Feature::FolderListingCache)
+		&& (ILIsParent(m_directoryState.pidlDirectory.Raw(), simplePidl1.Raw(), TRUE)
+			|| ArePidlsEquivalent(m_directoryState.pidlDirectory.Raw(), simplePidl1.Raw())
+			|| (simplePidl2.HasValue()
+				&& ILIsParent(m_directoryState.pidlDirectory.Raw(), simplePidl2.Raw(), TRUE))))
+	{
+		// The contents of the folder have changed, so any cached listing is now out of date.
+		m_app->GetFolderListingCache()->Invalidate(m_directoryState.pidlDirectory);
+	}
+
+	if (m_app->GetFeatureList()->IsEnabled(Feature::CoalescedDirectoryChanges))
+	{
+		m_directoryChangeCoalescer.AddChange(event, simplePidl1, simplePidl2);
+		ScheduleCoalescedDirectoryChanges();
+		return;
+	}
+
+	ApplyDirectoryChange(event, simplePidl1, simplePidl2);
+
+	m_app->GetShellBrowserEvents()->NotifyItemsChanged(this);
+}
+
+void ShellBrowserImpl::ScheduleCoalescedDirectoryChanges()
+{
+	if (m_directoryChangeTimer)
+	{
+		// The changes will be applied once the current window ends.
+		return;
+	}
+
+#pragma warning(push)
+#pragma warning(                                                                                   \
+	disable : 4244) // 'argument': conversion from '_Rep' to 'size_t', possible loss of data
+	m_directoryChangeTimer = m_app->GetRuntime()->GetTimerQueue()->make_one_shot_timer(
+		DIRECTORY_CHANGE_COALESCING_WINDOW, m_app->GetRuntime()->GetUiThreadExecutor(),
+		[weakSelf = m_weakPtrFactory.GetWeakPtr()]
+		{
+			if (weakSelf)
+			{
+				weakSelf->ApplyCoalescedDirectoryChanges();
+			}
+		});
+#pragma warning(pop)
+}
+
+void ShellBrowserImpl::ApplyCoalescedDirectoryChanges()
+{
+	m_directoryChangeTimer.cancel();
+
+	auto changes = m_directoryChangeCoalescer.TakeChanges();
+
+	if (changes.empty())
+	{
+		return;
+	}
+
+	ApplyItemChangesAsBatch(changes.size(),
+		[this, &changes]
+		{
+			for (const auto &change : changes)
+			{
+				if (change.event == DirectoryWatcher::Event::DirectoryContentsChanged
+					&& !m_directoryState.awaitingAddList.empty())
+				{
+					// Changes on either side of this event may refer to the same item, so any items
+					// added before this point need to be in the listview before processing
+					// continues.
+					InsertAwaitingItems();
+				}
+
+				ApplyDirectoryChange(change.event, change.simplePidl1, change.simplePidl2);
+			}
+		});
+}
+
+// Applies a set of changes to the items in the listview. Redrawing is disabled while the changes
+// are applied and the listview is sorted (if necessary) only once, after all the changes have been
+// made.
+void ShellBrowserImpl::ApplyItemChangesAsBatch(size_t numChanges,
+	const std::function<void()> &applyChanges)
+{
+	{
+		ScopedRedrawDisabler redrawDisabler(m_listView);
+		AutoReset applyingDirectoryChanges(&m_applyingDirectoryChanges, true);
+
+		if (numChanges >= ITEM_LOOKUP_INDEX_THRESHOLD)
+		{
+			BuildItemLookupIndex();
+		}
+
+		applyChanges();
+
+		if (!m_directoryState.awaitingAddList.empty())
+		{
+			InsertAwaitingItems();
+		}
+
+		if (m_sortAfterDirectoryChanges)
+		{
+			ListView_SortItems(m_listView, SortStub, this);
+			m_sortAfterDirectoryChanges = false;
+		}
+
+		m_itemLookupIndex.reset();
+	}
+
+	m_app->GetShellBrowserEvents()->NotifyItemsChanged(this);
+}
+
+void ShellBrowserImpl::BuildItemLookupIndex()
+{
+	m_itemLookupIndex.emplace();
+	m_itemLookupIndex->reserve(m_itemInfoMap.size());
+
+	for (const auto &[internalIndex, itemInfo] : m_itemInfoMap)
+	{
+		m_itemLookupIndex->emplace(itemInfo.parsingName, internalIndex);
+	}
+}
+
+void ShellBrowserImpl::ApplyDirectoryChange(DirectoryWatcher::Event event,
+	const PidlAbsolute &simplePidl1, const PidlAbsolute &simplePidl2)
+{
+	// If the contents have been discarded, there are no items to update. The folder will be
+	// reloaded when the tab is next selected.
+	bool deferChanges = m_inBackgroundState || m_contentsDiscarded;
+
+	if (deferChanges && ILIsParent(m_directoryState.pidlDirectory.Raw(), simplePidl1.Raw(), TRUE))
+	{
+		// Changes to items within the folder are only recorded while in the background. They'll be
+		// picked up when the folder is refreshed, once the listview is shown again. Changes to the
+		// folder itself (or one of its parents) are still processed below, since they can affect
+		// the tab (e.g. if the folder is renamed or removed).
+		m_changedInBackgroundState = true;
+		return;
+	}
+
+	if (deferChanges && event == DirectoryWatcher::Event::DirectoryContentsChanged
+		&& ArePidlsEquivalent(m_directoryState.pidlDirectory.Raw(), simplePidl1.Raw()))
+	{
+		m_changedInBackgroundState = true;
+		return;
+	}
+
 	switch (event)
 	{
 	case DirectoryWatcher::Event::Added:
@@ -121,8 +276,6 @@ void ShellBrowserImpl::ProcessDirectoryChangeNotification(DirectoryWatcher::Even
 		}
 		break;
 	}
-
-	m_app->GetShellBrowserEvents()->NotifyItemsChanged(this);
 }
 
 void ShellBrowserImpl::OnItemAdded(PCIDLIST_ABSOLUTE simplePidl)
@@ -183,6 +336,11 @@ void ShellBrowserImpl::AddItem(PCIDLIST_ABSOLUTE pidl)
 		return;
 	}
 
+	if (m_itemLookupIndex)
+	{
+		m_itemLookupIndex->emplace(m_itemInfoMap.at(*itemId).parsingName, *itemId);
+	}
+
 	if (m_config->globalFolderSettings.insertSorted)
 	{
 		// TODO: It would be better to pass the items details to this function directly
@@ -202,6 +360,14 @@ void ShellBrowserImpl::AddItem(PCIDLIST_ABSOLUTE pidl)
 		itr->iAfter = sortedPosition - 1;
 	}
 
+	// When a batch of changes is being applied, new items are inserted together, once the batch
+	// is complete. The sorted position above is based on the current contents of the listview,
+	// however, so in that case, the item needs to be inserted immediately.
+	if (m_applyingDirectoryChanges && !m_config->globalFolderSettings.insertSorted)
+	{
+		return;
+	}
+
 	InsertAwaitingItems();
 }
 
@@ -286,6 +452,11 @@ void ShellBrowserImpl::UpdateItem(PCIDLIST_ABSOLUTE pidl, PCIDLIST_ABSOLUTE upda
 	m_itemInfoMap[*internalIndex] = *itemInfo;
 	const ItemInfo_t &updatedItemInfo = m_itemInfoMap[*internalIndex];
 
+	if (m_itemLookupIndex && updatedPidl)
+	{
+		m_itemLookupIndex->emplace(updatedItemInfo.parsingName, *internalIndex);
+	}
+
 	auto itemIndex = LocateItemByInternalIndex(*internalIndex);
 
 	// Items may be filtered out of the listview, so it's valid for an item not to be found.
@@ -342,6 +513,12 @@ void ShellBrowserImpl::UpdateItem(PCIDLIST_ABSOLUTE pidl, PCIDLIST_ABSOLUTE upda
 		InsertItemIntoGroup(*itemIndex, groupId);
 	}
 
+	if (m_applyingDirectoryChanges)
+	{
+		m_sortAfterDirectoryChanges = true;
+		return;
+	}
+
 	// It's not safe to use itemIndex past this point.
 	ListView_SortItems(m_listView, SortStub, this);
 	itemIndex.reset();
@@ -472,7 +649,190 @@ concurrencpp::null_result ShellBrowserImpl::RefreshDirectoryAfterUpdate(
 		co_return;
 	}
 
-	weakSelf->m_navigationController->Refresh();
+	weakSelf->Refresh();
+}
+
+void ShellBrowserImpl::Refresh()
+{
+	RefreshFromListing(std::nullopt);
+}
+
+bool ShellBrowserImpl::CanRefreshInPlace() const
+{
+	// An in-place refresh updates the items that are currently in the listview, so isn't possible
+	// if there are no items (e.g. because the contents have been discarded) or if the items aren't
+	// currently being kept up to date.
+	return m_app->GetFeatureList()->IsEnabled(Feature::IncrementalRefresh)
+		&& m_navigationState == NavigationState::Committed && !m_inBackgroundState
+		&& !m_contentsDiscarded;
+}
+
+// Updates the current folder to match the provided listing. If no listing is provided, the folder
+// will be re-enumerated. If an in-place update isn't possible, the folder will be reloaded.
+void ShellBrowserImpl::RefreshFromListing(std::optional<std::vector<PidlChild>> items, int attempt)
+{
+	if (!CanRefreshInPlace())
+	{
+		m_navigationController->Refresh();
+		return;
+	}
+
+	RefreshInPlace(m_weakPtrFactory.GetWeakPtr(), m_shellEnumerator,
+		m_directoryState.pidlDirectory, std::move(items), m_directoryChangeSequenceNumber, attempt,
+		m_app->GetRuntime());
+}
+
+concurrencpp::null_result ShellBrowserImpl::RefreshInPlace(WeakPtr<ShellBrowserImpl> weakSelf,
+	std::shared_ptr<const ShellEnumerator> shellEnumerator, PidlAbsolute directory,
+	std::optional<std::vector<PidlChild>> items, uint64_t directoryChangeSequenceNumber,
+	int attempt, Runtime *runtime)
+{
+	co_await ResumeOnComStaThread(runtime);
+
+	HRESULT hr = S_OK;
+
+	if (!items)
+	{
+		items.emplace();
+		hr = shellEnumerator->EnumerateDirectory(directory.Raw(), *items, {});
+	}
+
+	wil::com_ptr_nothrow<IShellFolder> shellFolder;
+
+	if (SUCCEEDED(hr))
+	{
+		hr = SHBindToObject(nullptr, directory.Raw(), nullptr, IID_PPV_ARGS(&shellFolder));
+	}
+
+	// Items are matched up with the existing items using their parsing names, which are retrieved
+	// here, rather than on the UI thread. The entries refer to the names, so the names vector
+	// needs to be fully built (and not resized) before the entries are created.
+	std::vector<std::wstring> parsingNames;
+	std::vector<ListingDiff::Entry> newEntries;
+
+	if (SUCCEEDED(hr))
+	{
+		parsingNames.resize(items->size());
+
+		for (size_t i = 0; i < items->size(); i++)
+		{
+			// An item without a parsing name can't be shown (see GetItemInformation()), so it's
+			// left out of the listing.
+			if (FAILED(GetDisplayName(shellFolder.get(), (*items)[i].Raw(), SHGDN_FORPARSING,
+					parsingNames[i])))
+			{
+				parsingNames[i].clear();
+			}
+		}
+
+		newEntries.reserve(items->size());
+
+		for (size_t i = 0; i < items->size(); i++)
+		{
+			if (!parsingNames[i].empty())
+			{
+				newEntries.push_back({ parsingNames[i], (*items)[i].Raw(), i });
+			}
+		}
+
+		ListingDiff::SortEntries(newEntries);
+	}
+
+	co_await ResumeOnUiThread(runtime);
+
+	// Navigating away from the folder will invalidate this WeakPtr, so if it's still valid, the
+	// folder that was enumerated is still the current folder.
+	if (!weakSelf)
+	{
+		co_return;
+	}
+
+	if (weakSelf->m_inBackgroundState || weakSelf->m_contentsDiscarded)
+	{
+		// The folder will be refreshed once it's shown again.
+		weakSelf->m_changedInBackgroundState = true;
+		co_return;
+	}
+
+	if (FAILED(hr))
+	{
+		// Reloading the folder means that any error will be handled in the same way it would be
+		// during a regular navigation.
+		weakSelf->m_navigationController->Refresh();
+		co_return;
+	}
+
+	if (weakSelf->m_directoryChangeSequenceNumber != directoryChangeSequenceNumber)
+	{
+		// The folder changed while it was being enumerated, so the listing may be older than the
+		// changes that have been (or are about to be) applied to the listview. Diffing against the
+		// listing could then revert those changes. The listing is discarded instead and the folder
+		// enumerated again. If the folder is changing continuously, the changes themselves will
+		// keep the listview up to date, so the refresh is eventually abandoned.
+		if (attempt < MAX_REFRESH_IN_PLACE_ATTEMPTS)
+		{
+			weakSelf->RefreshFromListing(std::nullopt, attempt + 1);
+		}
+
+		co_return;
+	}
+
+	weakSelf->ApplyRefreshedListing(directory, newEntries);
+}
+
+// Compares the items in the listview against the refreshed listing and applies only the
+// differences. Items that haven't changed are left untouched, so the scroll position, selection
+// and any previously retrieved column data are all retained.
+void ShellBrowserImpl::ApplyRefreshedListing(const PidlAbsolute &directory,
+	const std::vector<ListingDiff::Entry> &newEntries)
+{
+	// No changes have been received since the enumeration started, so any changes that are still
+	// pending were made before the listing was retrieved and are already reflected in it. Applying
+	// them on top of the refreshed listing could result in an attempt to add an item that already
+	// exists, so they're discarded.
+	m_directoryChangeTimer.cancel();
+	m_directoryChangeCoalescer.Clear();
+
+	std::vector<ListingDiff::Entry> oldEntries;
+	oldEntries.reserve(m_itemInfoMap.size());
+
+	for (const auto &[internalIndex, itemInfo] : m_itemInfoMap)
+	{
+		oldEntries.push_back(
+			{ itemInfo.parsingName, itemInfo.pridl.Raw(), static_cast<size_t>(internalIndex) });
+	}
+
+	ListingDiff::SortEntries(oldEntries);
+
+	auto delta = ListingDiff::Compute(oldEntries, newEntries);
+
+	if (delta.IsEmpty())
+	{
+		return;
+	}
+
+	// Note that the old entries refer to data owned by m_itemInfoMap. Removing or updating an item
+	// invalidates the entry for that item, so each entry is only accessed before its item changes.
+	ApplyItemChangesAsBatch(delta.GetNumChanges(),
+		[this, &directory, &oldEntries, &newEntries, &delta]
+		{
+			for (auto index : delta.removed)
+			{
+				RemoveItem(static_cast<int>(oldEntries[index].itemId));
+			}
+
+			for (auto [oldIndex, newIndex] : delta.modified)
+			{
+				PidlAbsolute currentPidl =
+					m_itemInfoMap.at(static_cast<int>(oldEntries[oldIndex].itemId)).pidlComplete;
+				UpdateItem(currentPidl.Raw(), (directory + newEntries[newIndex].pidl).Raw());
+			}
+
+			for (auto index : delta.added)
+			{
+				AddItem((directory + newEntries[index].pidl).Raw());
+			}
+		});
 }
 
 // Navigates to the closest ancestor of this item that exists. If this item itself exists, no
@@ -31,7 +31,7 @@ void ShellBrowserImpl::SetupThumbnailsView(int shellImageListType)
 
 void ShellBrowserImpl::RemoveThumbnailsView()
 {
-	m_thumbnailThreadPool.clear_queue();
+	m_thumbnailTaskGroup = m_taskScheduler->ReplaceGroup(m_thumbnailTaskGroup);
 	m_thumbnailResults.clear();
 
 	InvalidateAllItemImages();
@@ -48,27 +48,40 @@ void ShellBrowserImpl::InvalidateAllItemImages()
 
 	for (int i = 0; i < numItems; i++)
 	{
-		LVITEM lvItem;
-		lvItem.mask = LVIF_IMAGE;
-		lvItem.iItem = i;
-		lvItem.iSubItem = 0;
-		lvItem.iImage = I_IMAGECALLBACK;
-		ListView_SetItem(m_listView, &lvItem);
+		InvalidateItemImage(i);
 	}
 }
 
+// Resets the item's image, so that the listview will request it again the next time the item is
+// shown.
+void ShellBrowserImpl::InvalidateItemImage(int index)
+{
+	LVITEM lvItem;
+	lvItem.mask = LVIF_IMAGE;
+	lvItem.iItem = index;
+	lvItem.iSubItem = 0;
+	lvItem.iImage = I_IMAGECALLBACK;
+	ListView_SetItem(m_listView, &lvItem);
+}
+
 void ShellBrowserImpl::QueueThumbnailTask(int internalIndex)
 {
+	if (m_inBackgroundState)
+	{
+		m_workDroppedInBackgroundState = true;
+		return;
+	}
+
 	int thumbnailResultID = m_thumbnailResultIDCounter++;
 
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(internalIndex);
 
-	auto result = m_thumbnailThreadPool.push(
-		[listView = m_listView, thumbnailResultID, internalIndex, basicItemInfo,
-			thumbnailSize = m_thumbnailItemWidth](int id) -> std::optional<ThumbnailResult_t>
+	auto result = m_taskScheduler->Push(
+		m_thumbnailTaskGroup, TaskScheduler::Priority::Visible,
+		[notifyReady = MakeResultReadyNotifier(WM_APP_THUMBNAIL_RESULT_READY, thumbnailResultID),
+			internalIndex, basicItemInfo,
+			thumbnailSize = m_thumbnailItemWidth]() -> std::optional<ThumbnailResult_t>
 		{
-			UNREFERENCED_PARAMETER(id);
-
 			auto bitmap = GetThumbnail(basicItemInfo.pidlComplete.get(), thumbnailSize,
 				WTS_EXTRACT | WTS_SCALETOREQUESTEDSIZE);
 
@@ -77,16 +90,17 @@ void ShellBrowserImpl::QueueThumbnailTask(int internalIndex)
 				return std::nullopt;
 			}
 
-			PostMessage(listView, WM_APP_THUMBNAIL_RESULT_READY, thumbnailResultID, 0);
+			notifyReady();
 
 			ThumbnailResult_t result;
 			result.itemInternalIndex = internalIndex;
 			result.bitmap = std::move(bitmap);
 
 			return result;
-		});
+		},
+		thumbnailResultID);
 
-	m_thumbnailResults.insert({ thumbnailResultID, std::move(result) });
+	m_thumbnailResults.insert({ thumbnailResultID, { internalIndex, std::move(result) } });
 }
 
 std::optional<int> ShellBrowserImpl::GetCachedThumbnailIndex(const ItemInfo_t &itemInfo)
@@ -159,7 +173,7 @@ void ShellBrowserImpl::ProcessThumbnailResult(int thumbnailResultId)
 		return;
 	}
 
-	auto result = itr->second.get();
+	auto result = itr->second.result.get();
 
 	if (!result)
 	{
@@ -7,7 +7,7 @@
 
 HistoryEntry::HistoryEntry(const PidlAbsolute &pidl, InitialNavigationType type) :
 	m_id(idCounter++),
-	m_pidl(pidl),
+	m_pidl(PidlStore::GetDefault().Intern(pidl)),
 	m_type(type)
 {
 }
@@ -17,9 +17,9 @@ int HistoryEntry::GetId() const
 	return m_id;
 }
 
-const PidlAbsolute &HistoryEntry::GetPidl() const
+PidlAbsolute HistoryEntry::GetPidl() const
 {
-	return m_pidl;
+	return m_pidl.ToPidl();
 }
 
 bool HistoryEntry::IsInitialEntry() const
@@ -32,12 +32,33 @@ HistoryEntry::InitialNavigationType HistoryEntry::GetInitialNavigationType() con
 	return m_type;
 }
 
-const std::vector<PidlAbsolute> &HistoryEntry::GetSelectedItems() const
+std::vector<PidlAbsolute> HistoryEntry::GetSelectedItems() const
 {
-	return m_selectedItems;
+	std::vector<PidlAbsolute> selectedItems;
+	selectedItems.reserve(m_selectedItems.size());
+
+	for (const auto &selectedItem : m_selectedItems)
+	{
+		selectedItems.push_back(selectedItem.ToPidl());
+	}
+
+	return selectedItems;
 }
 
 void HistoryEntry::SetSelectedItems(const std::vector<PidlAbsolute> &pidls)
 {
-	m_selectedItems = pidls;
+	auto &store = PidlStore::GetDefault();
+
+	m_selectedItems.clear();
+	m_selectedItems.reserve(pidls.size());
+
+	for (const auto &pidl : pidls)
+	{
+		m_selectedItems.push_back(store.Intern(pidl));
+	}
+}
+
+size_t HistoryEntry::GetMemoryUsage() const
+{
+	return sizeof(*this) + (m_selectedItems.capacity() * sizeof(InternedPidl));
 }
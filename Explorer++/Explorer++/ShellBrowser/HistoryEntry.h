@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "../Helper/InternedPidl.h"
 #include "../Helper/PidlHelper.h"
 #include <boost/core/noncopyable.hpp>
 #include <vector>
@@ -29,17 +30,23 @@ public:
 		InitialNavigationType type = InitialNavigationType::NonInitial);
 
 	int GetId() const;
-	const PidlAbsolute &GetPidl() const;
+	PidlAbsolute GetPidl() const;
 	bool IsInitialEntry() const;
 	InitialNavigationType GetInitialNavigationType() const;
-	const std::vector<PidlAbsolute> &GetSelectedItems() const;
+	std::vector<PidlAbsolute> GetSelectedItems() const;
 	void SetSelectedItems(const std::vector<PidlAbsolute> &pidls);
 
+	// Returns the approximate number of bytes used by this entry. The pidls themselves are held
+	// in the shared PidlStore, so aren't included here.
+	size_t GetMemoryUsage() const;
+
 private:
 	static inline int idCounter = 0;
 	const int m_id;
 
-	const PidlAbsolute m_pidl;
+	// Entries in a tab's history (as well as the history of closed tabs) typically contain many
+	// pidls that are identical or share a common parent, so the pidls are stored in interned form.
+	const InternedPidl m_pidl;
 	const InitialNavigationType m_type;
-	std::vector<PidlAbsolute> m_selectedItems;
+	std::vector<InternedPidl> m_selectedItems;
 };
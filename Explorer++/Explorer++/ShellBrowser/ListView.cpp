@@ -10,8 +10,9 @@
 #include "ColorRuleModel.h"
 #include "ColumnHelper.h"
 #include "Config.h"
+#include "FeatureList.h"
 #include "FolderView.h"
-#include "IconFetcher.h"
+#include "IconFetcherImpl.h"
 #include "ItemData.h"
 #include "LabelEditHandler.h"
 #include "MainResource.h"
@@ -20,6 +21,7 @@
 #include "OpenItemsContextMenuDelegate.h"
 #include "ResourceHelper.h"
 #include "ResourceLoader.h"
+#include "Runtime.h"
 #include "SelectColumnsDialog.h"
 #include "ServiceProvider.h"
 #include "ShellBrowserContextMenuDelegate.h"
@@ -30,6 +32,7 @@
 #include "../Helper/FileActionHandler.h"
 #include "../Helper/Helper.h"
 #include "../Helper/ListViewHelper.h"
+#include "../Helper/ScopedRedrawDisabler.h"
 #include "../Helper/ShellBackgroundContextMenu.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/ShellItemContextMenu.h"
@@ -38,7 +41,11 @@
 #include <boost/range/iterator_range.hpp>
 #include <glog/logging.h>
 #include <wil/common.h>
+#include <algorithm>
 #include <format>
+#include <ranges>
+#include <set>
+#include <unordered_map>
 
 const std::vector<ColumnType> COMMON_REAL_FOLDER_COLUMNS = { ColumnType::Name, ColumnType::Type,
 	ColumnType::Size, ColumnType::DateModified, ColumnType::Authors, ColumnType::Title };
@@ -150,15 +157,9 @@ LRESULT ShellBrowserImpl::ListViewProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPAR
 		break;
 
 	case WM_APP_COLUMN_RESULT_READY:
-		ProcessColumnResult(static_cast<int>(wParam));
-		break;
-
 	case WM_APP_THUMBNAIL_RESULT_READY:
-		ProcessThumbnailResult(static_cast<int>(wParam));
-		break;
-
 	case WM_APP_INFO_TIP_READY:
-		ProcessInfoTipResult(static_cast<int>(wParam));
+		ProcessResult(uMsg, static_cast<int>(wParam));
 		break;
 	}
 
@@ -194,6 +195,16 @@ LRESULT ShellBrowserImpl::ListViewParentProc(HWND hwnd, UINT uMsg, WPARAM wParam
 				OnListViewGetDisplayInfo(lParam);
 				break;
 
+			case LVN_ENDSCROLL:
+				OnListViewEndScroll();
+				break;
+
+			case LVN_HOTTRACK:
+				// Returning 0 here allows the listview to continue with its own hot-tracking (e.g.
+				// the hover selection used in one-click activation mode).
+				OnListViewHotTrack(reinterpret_cast<NMLISTVIEW *>(lParam));
+				return 0;
+
 			case LVN_GETINFOTIP:
 				return OnListViewGetInfoTip(reinterpret_cast<NMLVGETINFOTIP *>(lParam));
 
@@ -366,6 +377,59 @@ void ShellBrowserImpl::OnListViewMButtonUp(const POINT *pt, UINT keysDown)
 			WI_IsFlagSet(keysDown, MK_SHIFT)));
 }
 
+// The listview already tracks the item under the mouse (via LVN_HOTTRACK), so that's used here,
+// rather than a separate hover tracking request, which would interfere with the listview's own
+// hover handling.
+void ShellBrowserImpl::OnListViewHotTrack(const NMLISTVIEW *info)
+{
+	if (!IsFolderPrefetchEnabled() || info->iItem == m_prefetchHotItem)
+	{
+		return;
+	}
+
+	m_prefetchHotItem = info->iItem;
+	m_prefetchHoverTimer.cancel();
+
+	if (m_prefetchHotItem == -1)
+	{
+		return;
+	}
+
+	const ItemInfo_t &itemInfo = GetItemByIndex(m_prefetchHotItem);
+
+	if (WI_IsFlagClear(itemInfo.wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY))
+	{
+		return;
+	}
+
+#pragma warning(push)
+#pragma warning(                                                                                   \
+	disable : 4244) // 'argument': conversion from '_Rep' to 'size_t', possible loss of data
+	m_prefetchHoverTimer = m_app->GetRuntime()->GetTimerQueue()->make_one_shot_timer(
+		PREFETCH_HOVER_DELAY, m_app->GetRuntime()->GetUiThreadExecutor(),
+		[weakSelf = m_weakPtrFactory.GetWeakPtr(), item = m_prefetchHotItem,
+			folder = itemInfo.pidlComplete]
+		{
+			if (weakSelf)
+			{
+				weakSelf->OnPrefetchHoverTimer(item, folder);
+			}
+		});
+#pragma warning(pop)
+}
+
+void ShellBrowserImpl::OnPrefetchHoverTimer(int item, const PidlAbsolute &folder)
+{
+	// The mouse may have left the listview since the timer was started, in which case the item
+	// will no longer be hot.
+	if (item != m_prefetchHotItem || ListView_GetHotItem(m_listView) != item)
+	{
+		return;
+	}
+
+	PrefetchFolder(folder);
+}
+
 void ShellBrowserImpl::OnRButtonDown(HWND hwnd, BOOL doubleClick, int x, int y, UINT keyFlags)
 {
 	UNREFERENCED_PARAMETER(hwnd);
@@ -614,14 +678,363 @@ void ShellBrowserImpl::OnListViewGetDisplayInfo(LPARAM lParam)
 			}
 		}
 
-		m_iconFetcher->QueueIconTask(itemInfo.pidlComplete.Raw(),
-			[this, internalIndex](int iconIndex, int overlayIndex)
-			{ ProcessIconResult(internalIndex, iconIndex, overlayIndex); });
+		if (m_inBackgroundState)
+		{
+			m_workDroppedInBackgroundState = true;
+		}
+		else
+		{
+			m_iconFetcher->QueueIconTask(
+				itemInfo.pidlComplete.Raw(),
+				[this, internalIndex](int iconIndex, int overlayIndex)
+				{ ProcessIconResult(internalIndex, iconIndex, overlayIndex); },
+				internalIndex);
+		}
 	}
 
 	plvItem->mask |= LVIF_DI_SETITEM;
 }
 
+void ShellBrowserImpl::OnListViewEndScroll()
+{
+	if (!m_app->GetFeatureList()->IsEnabled(Feature::ViewportTaskPrioritization))
+	{
+		return;
+	}
+
+	ReprioritizeQueuedTasks();
+}
+
+// Tasks are queued as the listview requests information for each item. When the listview is
+// scrolled quickly, that can result in a large number of tasks being queued for items that are no
+// longer in view. Those tasks would then delay the tasks for the items that are in view, so the
+// tasks are re-prioritized here, based on the current position of each item.
+void ShellBrowserImpl::ReprioritizeQueuedTasks()
+{
+	auto viewportItems = GetViewportItems();
+
+	auto getPriority = [&viewportItems](int internalIndex) -> std::optional<TaskScheduler::Priority>
+	{
+		if (viewportItems.visibleItems.contains(internalIndex))
+		{
+			return TaskScheduler::Priority::Visible;
+		}
+		else if (viewportItems.nearbyItems.contains(internalIndex))
+		{
+			return TaskScheduler::Priority::Background;
+		}
+
+		return std::nullopt;
+	};
+
+	auto cancelledColumnResultIds = m_taskScheduler->Reprioritize(m_columnTaskGroup,
+		[this, &getPriority](TaskScheduler::TaskTag columnResultId)
+		{
+			const auto &pendingResult = m_columnResults.at(static_cast<int>(columnResultId));
+			return getPriority(pendingResult.itemInternalIndex);
+		});
+
+	auto cancelledThumbnailResultIds = m_taskScheduler->Reprioritize(m_thumbnailTaskGroup,
+		[this, &getPriority](TaskScheduler::TaskTag thumbnailResultId)
+		{
+			const auto &pendingResult = m_thumbnailResults.at(static_cast<int>(thumbnailResultId));
+			return getPriority(pendingResult.itemInternalIndex);
+		});
+
+	auto cancelledIconItems = m_iconFetcher->ReprioritizeTasks(
+		[&getPriority](TaskScheduler::TaskTag internalIndex)
+		{ return getPriority(static_cast<int>(internalIndex)); });
+
+	if (cancelledColumnResultIds.empty() && cancelledThumbnailResultIds.empty()
+		&& cancelledIconItems.empty())
+	{
+		return;
+	}
+
+	// Because the listview has already been given a value for each of the items that were
+	// cancelled, it won't request the values again. So, the values are reset here, which means
+	// they'll be requested again if the items are scrolled back into view. Only the cancelled
+	// items are looked up, unless there are enough of them that a single map of every item is
+	// cheaper.
+	size_t numCancelled = cancelledColumnResultIds.size() + cancelledThumbnailResultIds.size()
+		+ cancelledIconItems.size();
+
+	if (ShouldBuildItemIndexMap(numCancelled))
+	{
+		m_itemIndexesByInternalIndex = BuildItemIndexesByInternalIndex();
+	}
+
+	auto resetItemIndexes = wil::scope_exit([this] { m_itemIndexesByInternalIndex.reset(); });
+
+	for (auto columnResultId : cancelledColumnResultIds)
+	{
+		auto itr = m_columnResults.find(static_cast<int>(columnResultId));
+		auto index = LocateItemByInternalIndex(itr->second.itemInternalIndex);
+		auto columnIndex = GetColumnIndexByType(itr->second.columnType);
+
+		if (index && columnIndex)
+		{
+			ListView_SetItemText(m_listView, *index, *columnIndex, LPSTR_TEXTCALLBACK);
+		}
+
+		m_columnResults.erase(itr);
+	}
+
+	auto invalidateImage = [this](int internalIndex)
+	{
+		auto index = LocateItemByInternalIndex(internalIndex);
+
+		if (index)
+		{
+			InvalidateItemImage(*index);
+		}
+	};
+
+	for (auto thumbnailResultId : cancelledThumbnailResultIds)
+	{
+		auto itr = m_thumbnailResults.find(static_cast<int>(thumbnailResultId));
+		invalidateImage(itr->second.itemInternalIndex);
+		m_thumbnailResults.erase(itr);
+	}
+
+	for (auto internalIndex : cancelledIconItems)
+	{
+		invalidateImage(static_cast<int>(internalIndex));
+	}
+}
+
+ShellBrowserImpl::ViewportItems ShellBrowserImpl::GetViewportItems() const
+{
+	ViewportItems viewportItems;
+	auto visibleItems = GetVisibleItems();
+
+	if (visibleItems.empty())
+	{
+		return viewportItems;
+	}
+
+	for (int index : visibleItems)
+	{
+		viewportItems.visibleItems.insert(GetItemInternalIndex(index));
+	}
+
+	// Items are generally laid out in index order (within each group, if items are grouped), so
+	// the items either side of the visible items are the ones closest to coming into view.
+	int firstVisible = visibleItems.front();
+	int lastVisible = visibleItems.back();
+	int margin = static_cast<int>(visibleItems.size()) * NUM_NEARBY_VIEWPORT_PAGES;
+	int first = std::max(firstVisible - margin, 0);
+	int last = std::min(lastVisible + margin, ListView_GetItemCount(m_listView) - 1);
+
+	for (int i = first; i < firstVisible; i++)
+	{
+		viewportItems.nearbyItems.insert(GetItemInternalIndex(i));
+	}
+
+	for (int i = lastVisible + 1; i <= last; i++)
+	{
+		viewportItems.nearbyItems.insert(GetItemInternalIndex(i));
+	}
+
+	return viewportItems;
+}
+
+// Returns the indexes of the items that are in view, in ascending order. Only the items in view
+// (and at most a logarithmic number of other items) are queried, so this remains cheap in large
+// folders.
+std::vector<int> ShellBrowserImpl::GetVisibleItems() const
+{
+	int numItems = ListView_GetItemCount(m_listView);
+
+	if (numItems == 0)
+	{
+		return {};
+	}
+
+	if (m_folderSettings.showInGroups)
+	{
+		return GetVisibleItemsByHitTest();
+	}
+
+	// In details and list modes, the items are laid out in order, so the range can be determined
+	// directly.
+	if (m_folderSettings.viewMode == +ViewMode::Details
+		|| m_folderSettings.viewMode == +ViewMode::List)
+	{
+		int firstVisible = ListView_GetTopIndex(m_listView);
+		int lastVisible =
+			std::min(firstVisible + ListView_GetCountPerPage(m_listView), numItems - 1);
+
+		auto indexes = std::views::iota(firstVisible, lastVisible + 1);
+		return { indexes.begin(), indexes.end() };
+	}
+
+	if (!m_folderSettings.autoArrangeEnabled)
+	{
+		return GetVisibleItemsByHitTest();
+	}
+
+	// The remaining view modes arrange items in rows, from the top down, in index order. The
+	// position of each item is therefore non-decreasing, so the items in view can be found with a
+	// binary search.
+	RECT clientRect;
+	GetClientRect(m_listView, &clientRect);
+
+	auto getItemRect = [this](int index)
+	{
+		RECT itemRect = {};
+		ListView_GetItemRect(m_listView, index, &itemRect, LVIR_BOUNDS);
+		return itemRect;
+	};
+
+	auto indexes = std::views::iota(0, numItems);
+	auto firstItr = std::ranges::partition_point(indexes,
+		[&clientRect, &getItemRect](int index)
+		{ return getItemRect(index).bottom <= clientRect.top; });
+	auto endItr = std::ranges::partition_point(firstItr, indexes.end(),
+		[&clientRect, &getItemRect](int index)
+		{ return getItemRect(index).top < clientRect.bottom; });
+	return { firstItr, endItr };
+}
+
+// When items are grouped, or can be freely positioned, the index of an item says nothing about
+// where it appears. In that case, the items in view are found by hit-testing points across the
+// client area. The points are spaced at half the size of an item, so each item in view should be
+// hit at least once. If an item is missed, its tasks may be cancelled, but because it's in view,
+// the listview will immediately request its details again.
+std::vector<int> ShellBrowserImpl::GetVisibleItemsByHitTest() const
+{
+	RECT clientRect;
+	GetClientRect(m_listView, &clientRect);
+
+	RECT itemRect;
+
+	if (!ListView_GetItemRect(m_listView, 0, &itemRect, LVIR_BOUNDS))
+	{
+		return {};
+	}
+
+	int stepX = std::max((itemRect.right - itemRect.left) / 2, 1L);
+	int stepY = std::max((itemRect.bottom - itemRect.top) / 2, 1L);
+	std::set<int> visibleItems;
+
+	for (int y = clientRect.top + (stepY / 2); y < clientRect.bottom; y += stepY)
+	{
+		for (int x = clientRect.left + (stepX / 2); x < clientRect.right; x += stepX)
+		{
+			// In details mode, this will also detect an item when the point is over one of its
+			// subitems.
+			LVHITTESTINFO hitTestInfo = {};
+			hitTestInfo.pt = { x, y };
+			int index = ListView_SubItemHitTest(m_listView, &hitTestInfo);
+
+			if (index != -1 && WI_IsAnyFlagSet(hitTestInfo.flags, LVHT_ONITEM))
+			{
+				visibleItems.insert(index);
+			}
+		}
+	}
+
+	return { visibleItems.begin(), visibleItems.end() };
+}
+
+// Returns a function that a task can call (from any thread) to indicate that its result is ready.
+// The result will then be processed on the UI thread, either individually, or as part of a batch.
+std::function<void()> ShellBrowserImpl::MakeResultReadyNotifier(UINT resultMessage, int resultId)
+{
+	if (m_resultSink)
+	{
+		auto weakSelf = m_weakPtrFactory.GetWeakPtr();
+
+		return [handle = m_resultSink->GetHandle(), weakSelf, resultMessage, resultId]
+		{
+			handle.Post(
+				[weakSelf, resultMessage, resultId]
+				{
+					if (weakSelf)
+					{
+						weakSelf->ProcessResult(resultMessage, resultId);
+					}
+				});
+		};
+	}
+
+	return [listView = m_listView, resultMessage, resultId]
+	{ PostMessage(listView, resultMessage, resultId, 0); };
+}
+
+void ShellBrowserImpl::ProcessResult(UINT resultMessage, int resultId)
+{
+	switch (resultMessage)
+	{
+	case WM_APP_COLUMN_RESULT_READY:
+		ProcessColumnResult(resultId);
+		break;
+
+	case WM_APP_THUMBNAIL_RESULT_READY:
+		ProcessThumbnailResult(resultId);
+		break;
+
+	case WM_APP_INFO_TIP_READY:
+		ProcessInfoTipResult(resultId);
+		break;
+
+	default:
+		DCHECK(false);
+		break;
+	}
+}
+
+// Each result that's applied invalidates part of the listview and, without a lookup, requires a
+// search for the item the result is for. So, for a large batch, redrawing is disabled until the
+// entire batch has been applied. If the batch covers a meaningful fraction of the items, the
+// position of each item is also looked up once, upfront. Applying a result doesn't add, remove or
+// move any items, so the lookup remains valid for the duration of the batch.
+void ShellBrowserImpl::ApplyResultBatch(size_t numResults,
+	const std::function<void()> &applyResults)
+{
+	if (numResults < LARGE_RESULT_BATCH_THRESHOLD)
+	{
+		applyResults();
+		return;
+	}
+
+	ScopedRedrawDisabler redrawDisabler(m_listView);
+
+	if (!ShouldBuildItemIndexMap(numResults))
+	{
+		applyResults();
+		return;
+	}
+
+	m_itemIndexesByInternalIndex = BuildItemIndexesByInternalIndex();
+	applyResults();
+	m_itemIndexesByInternalIndex.reset();
+}
+
+// Looking up an item without a map searches the listview internally, which is cheap compared to
+// retrieving every item to build a map. So, a map is only worthwhile when the number of lookups is
+// a meaningful fraction of the number of items.
+bool ShellBrowserImpl::ShouldBuildItemIndexMap(size_t numLookups) const
+{
+	auto numItems = static_cast<size_t>(ListView_GetItemCount(m_listView));
+	return numLookups * ITEM_INDEX_MAP_ITEMS_PER_LOOKUP >= numItems;
+}
+
+std::unordered_map<int, int> ShellBrowserImpl::BuildItemIndexesByInternalIndex() const
+{
+	std::unordered_map<int, int> indexesByInternalIndex;
+	int numItems = ListView_GetItemCount(m_listView);
+	indexesByInternalIndex.reserve(numItems);
+
+	for (int i = 0; i < numItems; i++)
+	{
+		indexesByInternalIndex.emplace(GetItemInternalIndex(i), i);
+	}
+
+	return indexesByInternalIndex;
+}
+
 void ShellBrowserImpl::ProcessIconResult(int internalIndex, int iconIndex, int overlayIndex)
 {
 	auto index = LocateItemByInternalIndex(internalIndex);
@@ -666,20 +1079,26 @@ BOOL ShellBrowserImpl::OnListViewGetEmptyMarkup(NMLVEMPTYMARKUP *emptyMarkup)
 
 void ShellBrowserImpl::QueueInfoTipTask(int internalIndex, const std::wstring &existingInfoTip)
 {
+	if (m_inBackgroundState)
+	{
+		// Info tips are only requested on demand, so there's no need to record anything here.
+		return;
+	}
+
 	int infoTipResultId = m_infoTipResultIDCounter++;
 
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(internalIndex);
 	Config configCopy = *m_config;
 	bool virtualFolder = InVirtualFolder();
 
-	auto result = m_infoTipsThreadPool.push(
-		[this, infoTipResultId, internalIndex, basicItemInfo, configCopy, virtualFolder,
-			existingInfoTip](int id)
+	// Info tips are requested as the user hovers over an item, so they're treated as interactive.
+	auto result = m_taskScheduler->Push(m_infoTipTaskGroup, TaskScheduler::Priority::Interactive,
+		[notifyReady = MakeResultReadyNotifier(WM_APP_INFO_TIP_READY, infoTipResultId),
+			resourceInstance = m_resourceInstance, internalIndex, basicItemInfo, configCopy,
+			virtualFolder, existingInfoTip]
 		{
-			UNREFERENCED_PARAMETER(id);
-
-			auto result = GetInfoTipAsync(m_listView, infoTipResultId, internalIndex, basicItemInfo,
-				configCopy, m_resourceInstance, virtualFolder);
+			auto result = GetInfoTipAsync(notifyReady, internalIndex, basicItemInfo, configCopy,
+				resourceInstance, virtualFolder);
 
 			// If the item name is truncated in the listview,
 			// existingInfoTip will contain that value. Therefore, it's
@@ -696,9 +1115,10 @@ void ShellBrowserImpl::QueueInfoTipTask(int internalIndex, const std::wstring &e
 	m_infoTipResults.insert({ infoTipResultId, std::move(result) });
 }
 
-std::optional<ShellBrowserImpl::InfoTipResult> ShellBrowserImpl::GetInfoTipAsync(HWND listView,
-	int infoTipResultId, int internalIndex, const BasicItemInfo_t &basicItemInfo,
-	const Config &config, HINSTANCE resourceInstance, bool virtualFolder)
+std::optional<ShellBrowserImpl::InfoTipResult> ShellBrowserImpl::GetInfoTipAsync(
+	const std::function<void()> &notifyReady, int internalIndex,
+	const BasicItemInfo_t &basicItemInfo, const Config &config, HINSTANCE resourceInstance,
+	bool virtualFolder)
 {
 	std::wstring infoTip;
 
@@ -733,7 +1153,7 @@ std::optional<ShellBrowserImpl::InfoTipResult> ShellBrowserImpl::GetInfoTipAsync
 		infoTip = std::format(L"{}: {}", dateModified, fileModificationText);
 	}
 
-	PostMessage(listView, WM_APP_INFO_TIP_READY, infoTipResultId, 0);
+	notifyReady();
 
 	InfoTipResult result;
 	result.itemInternalIndex = internalIndex;
@@ -60,6 +60,11 @@ public:
 	// When navigating up, this will store the pidl of the previous item.
 	PidlAbsolute originalPidl;
 
+	// Indicates whether a cached listing of the folder can be used, instead of enumerating the
+	// folder. A refresh should always show the current contents of the folder, so this is cleared
+	// in that case.
+	bool allowCachedListing = true;
+
 	static NavigateParams Normal(PCIDLIST_ABSOLUTE pidl,
 		HistoryEntryType historyEntryType = HistoryEntryType::AddEntry)
 	{
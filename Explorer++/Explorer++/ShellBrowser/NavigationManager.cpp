@@ -14,12 +14,14 @@
 NavigationManager::NavigationManager(const ShellBrowser *shellBrowser,
 	NavigationEvents *navigationEvents, std::shared_ptr<const ShellEnumerator> shellEnumerator,
 	std::shared_ptr<concurrencpp::executor> enumerationExecutor,
-	std::shared_ptr<concurrencpp::executor> originalExecutor) :
+	std::shared_ptr<concurrencpp::executor> originalExecutor,
+	std::shared_ptr<FolderListingCache> listingCache) :
 	m_shellBrowser(shellBrowser),
 	m_navigationEvents(navigationEvents),
 	m_shellEnumerator(shellEnumerator),
 	m_enumerationExecutor(enumerationExecutor),
 	m_originalExecutor(originalExecutor),
+	m_listingCache(listingCache),
 	m_scopedStopSource(std::make_unique<ScopedStopSource>())
 {
 }
@@ -30,7 +32,7 @@ void NavigationManager::StartNavigation(const NavigateParams &navigateParams)
 {
 	auto navigationRequest = std::make_unique<NavigationRequest>(m_shellBrowser, m_navigationEvents,
 		static_cast<NavigationRequestDelegate *>(this), m_shellEnumerator, m_enumerationExecutor,
-		m_originalExecutor, navigateParams, m_scopedStopSource->GetToken());
+		m_originalExecutor, navigateParams, m_scopedStopSource->GetToken(), m_listingCache);
 	auto *rawNavigationRequest = navigationRequest.get();
 	m_pendingNavigations.push_back(std::move(navigationRequest));
 
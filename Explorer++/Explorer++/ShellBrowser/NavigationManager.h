@@ -10,6 +10,7 @@
 #include <concurrencpp/concurrencpp.h>
 #include <memory>
 
+class FolderListingCache;
 struct NavigateParams;
 class NavigationEvents;
 class NavigationRequest;
@@ -25,7 +26,8 @@ public:
 	NavigationManager(const ShellBrowser *shellBrowser, NavigationEvents *navigationEvents,
 		std::shared_ptr<const ShellEnumerator> shellEnumerator,
 		std::shared_ptr<concurrencpp::executor> enumerationExecutor,
-		std::shared_ptr<concurrencpp::executor> originalExecutor);
+		std::shared_ptr<concurrencpp::executor> originalExecutor,
+		std::shared_ptr<FolderListingCache> listingCache = nullptr);
 	~NavigationManager();
 
 	void StartNavigation(const NavigateParams &navigateParams);
@@ -74,6 +76,9 @@ private:
 	const std::shared_ptr<concurrencpp::executor> m_enumerationExecutor;
 	const std::shared_ptr<concurrencpp::executor> m_originalExecutor;
 
+	// If set, folder listings will be retrieved from and added to this cache.
+	const std::shared_ptr<FolderListingCache> m_listingCache;
+
 	bool m_anyNavigationsCommitted = false;
 	std::vector<std::unique_ptr<NavigationRequest>> m_pendingNavigations;
 
@@ -4,6 +4,7 @@
 
 #include "stdafx.h"
 #include "NavigationRequest.h"
+#include "FolderListingCache.h"
 #include "NavigationEvents.h"
 #include "NavigationRequestDelegate.h"
 #include "ShellEnumerator.h"
@@ -14,13 +15,14 @@ NavigationRequest::NavigationRequest(const ShellBrowser *shellBrowser,
 	std::shared_ptr<const ShellEnumerator> shellEnumerator,
 	std::shared_ptr<concurrencpp::executor> enumerationExecutor,
 	std::shared_ptr<concurrencpp::executor> originalExecutor, const NavigateParams &navigateParams,
-	std::stop_token stopToken) :
+	std::stop_token stopToken, std::shared_ptr<FolderListingCache> listingCache) :
 	m_shellBrowser(shellBrowser),
 	m_navigationEvents(navigationEvents),
 	m_delegate(delegate),
 	m_shellEnumerator(shellEnumerator),
 	m_enumerationExecutor(enumerationExecutor),
 	m_originalExecutor(originalExecutor),
+	m_listingCache(listingCache),
 	m_navigateParams(navigateParams),
 	m_stopToken(stopToken)
 {
@@ -82,6 +84,11 @@ const std::vector<PidlChild> &NavigationRequest::GetItems() const
 	return m_items;
 }
 
+bool NavigationRequest::IsListingFromCache() const
+{
+	return m_listingFromCache;
+}
+
 bool NavigationRequest::Stopped() const
 {
 	return m_stopToken.stop_requested();
@@ -94,6 +101,7 @@ concurrencpp::null_result NavigationRequest::StartInternal(WeakPtr<NavigationReq
 	auto shellEnumerator = weakSelf->m_shellEnumerator;
 	auto enumerationExecutor = weakSelf->m_enumerationExecutor;
 	auto originalExecutor = weakSelf->m_originalExecutor;
+	auto listingCache = weakSelf->m_listingCache;
 	auto navigateParams = weakSelf->m_navigateParams;
 	auto stopToken = weakSelf->m_stopToken;
 
@@ -123,7 +131,32 @@ concurrencpp::null_result NavigationRequest::StartInternal(WeakPtr<NavigationReq
 	}
 
 	std::vector<PidlChild> items;
-	hr = shellEnumerator->EnumerateDirectory(navigateParams.pidl.Raw(), items, stopToken);
+	bool listingFromCache = false;
+	auto enumFlags = shellEnumerator->GetEnumerationFlags();
+
+	FolderListingCache::Items cachedItems;
+
+	if (listingCache && navigateParams.allowCachedListing)
+	{
+		cachedItems = listingCache->MaybeGet(navigateParams.pidl, enumFlags);
+	}
+
+	if (cachedItems)
+	{
+		items = *cachedItems;
+		listingFromCache = true;
+		hr = S_OK;
+	}
+	else
+	{
+		hr = shellEnumerator->EnumerateDirectory(navigateParams.pidl.Raw(), items, stopToken);
+
+		// A partial listing (i.e. one where the enumeration was stopped) can't be reused.
+		if (listingCache && SUCCEEDED(hr) && !stopToken.stop_requested())
+		{
+			listingCache->Store(navigateParams.pidl, enumFlags, items);
+		}
+	}
 
 	co_await concurrencpp::resume_on(originalExecutor);
 
@@ -134,6 +167,7 @@ concurrencpp::null_result NavigationRequest::StartInternal(WeakPtr<NavigationReq
 
 	weakSelf->m_navigateParams = navigateParams;
 	weakSelf->m_items = items;
+	weakSelf->m_listingFromCache = listingFromCache;
 	weakSelf->SetState(State::EnumerationFinished);
 
 	if (stopToken.stop_requested())
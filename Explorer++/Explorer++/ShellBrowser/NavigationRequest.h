@@ -12,6 +12,7 @@
 #include <concurrencpp/concurrencpp.h>
 #include <vector>
 
+class FolderListingCache;
 class NavigationEvents;
 class NavigationRequestDelegate;
 class ShellBrowser;
@@ -37,7 +38,8 @@ public:
 		NavigationRequestDelegate *delegate, std::shared_ptr<const ShellEnumerator> shellEnumerator,
 		std::shared_ptr<concurrencpp::executor> enumerationExecutor,
 		std::shared_ptr<concurrencpp::executor> originalExecutor,
-		const NavigateParams &navigateParams, std::stop_token stopToken);
+		const NavigateParams &navigateParams, std::stop_token stopToken,
+		std::shared_ptr<FolderListingCache> listingCache = nullptr);
 
 	void Start();
 	void Commit();
@@ -52,6 +54,10 @@ public:
 	// `WillCommit` or `Committed` state.
 	const std::vector<PidlChild> &GetItems() const;
 
+	// Indicates whether the items were retrieved from the listing cache, rather than by enumerating
+	// the folder. In that case, the items may be out of date.
+	bool IsListingFromCache() const;
+
 	// Indicates whether the enumeration process was stopped early. Note that this is independent of
 	// whether the navigation is ultimately committed or cancelled. That is, it's up to the caller
 	// to decide whether a stopped enumeration should result in a cancellation or not.
@@ -68,6 +74,7 @@ private:
 	const std::shared_ptr<const ShellEnumerator> m_shellEnumerator;
 	const std::shared_ptr<concurrencpp::executor> m_enumerationExecutor;
 	const std::shared_ptr<concurrencpp::executor> m_originalExecutor;
+	const std::shared_ptr<FolderListingCache> m_listingCache;
 
 	// The target pidl can be updated during the navigation (e.g. if the target is a symlink), so
 	// the values in this struct can change during the lifetime of the request.
@@ -77,6 +84,7 @@ private:
 
 	State m_state = State::NotStarted;
 	std::vector<PidlChild> m_items;
+	bool m_listingFromCache = false;
 
 	WeakPtrFactory<NavigationRequest> m_weakPtrFactory{ this };
 };
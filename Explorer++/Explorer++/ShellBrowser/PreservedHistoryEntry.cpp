@@ -5,11 +5,12 @@
 #include "stdafx.h"
 #include "PreservedHistoryEntry.h"
 
-PreservedHistoryEntry::PreservedHistoryEntry(const PidlAbsolute &pidl) : m_pidl(pidl)
+PreservedHistoryEntry::PreservedHistoryEntry(const PidlAbsolute &pidl) :
+	m_pidl(PidlStore::GetDefault().Intern(pidl))
 {
 }
 
-const PidlAbsolute &PreservedHistoryEntry::GetPidl() const
+PidlAbsolute PreservedHistoryEntry::GetPidl() const
 {
-	return m_pidl;
+	return m_pidl.ToPidl();
 }
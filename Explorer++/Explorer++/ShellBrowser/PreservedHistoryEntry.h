@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "../Helper/InternedPidl.h"
 #include "../Helper/PidlHelper.h"
 
 class PreservedHistoryEntry
@@ -11,8 +12,8 @@ class PreservedHistoryEntry
 public:
 	PreservedHistoryEntry(const PidlAbsolute &pidl);
 
-	const PidlAbsolute &GetPidl() const;
+	PidlAbsolute GetPidl() const;
 
 private:
-	const PidlAbsolute m_pidl;
+	const InternedPidl m_pidl;
 };
@@ -28,7 +28,7 @@ void ShellBrowser::SetTab(const Tab *tab)
 	m_tab = tab;
 }
 
-const PidlAbsolute &ShellBrowser::GetDirectory() const
+PidlAbsolute ShellBrowser::GetDirectory() const
 {
 	const auto *currentEntry = GetNavigationController()->GetCurrentEntry();
 	return currentEntry->GetPidl();
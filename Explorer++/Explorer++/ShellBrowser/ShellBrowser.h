@@ -5,6 +5,7 @@
 #pragma once
 
 #include "SelectionType.h"
+#include "ShellBrowserMemoryUsage.h"
 #include "SortModes.h"
 #include "ViewModes.h"
 #include "../Helper/PidlHelper.h"
@@ -31,7 +32,7 @@ public:
 	const Tab *GetTab() const;
 	void SetTab(const Tab *tab);
 
-	const PidlAbsolute &GetDirectory() const;
+	PidlAbsolute GetDirectory() const;
 	const NavigationRequest *MaybeGetLatestActiveNavigation() const;
 
 	virtual const FolderSettings &GetFolderSettings() const = 0;
@@ -77,9 +78,23 @@ public:
 	virtual void SetFilterEnabled(bool enabled) = 0;
 	virtual void EditFilterSettings() = 0;
 
+	// Reloads the contents of the current folder. Where possible, the folder will be updated in
+	// place, with only those items that have changed being updated.
+	virtual void Refresh() = 0;
+
 	virtual bool CanSaveDirectoryListing() const = 0;
 	virtual void SaveDirectoryListing() = 0;
 
+	// Returns an estimate of the memory currently used by this browser. Used to decide which tabs
+	// should be discarded when the configured memory budget is exceeded.
+	virtual ShellBrowserMemoryUsage GetMemoryUsage() const = 0;
+
+	// Releases the current listing, along with any associated caches. The listing will be rebuilt
+	// the next time the browser is shown. Discarding isn't possible while the browser is visible,
+	// or while a navigation is in progress; false will be returned in that case.
+	virtual bool DiscardContents() = 0;
+	virtual bool AreContentsDiscarded() const = 0;
+
 	virtual boost::signals2::connection AddDestroyedObserver(
 		const DestroyedSignal::slot_type &observer) = 0;
 
@@ -27,6 +27,8 @@
 #include "ShellNavigationController.h"
 #include "SortModes.h"
 #include "SplitFileDialog.h"
+#include "Tab.h"
+#include "TabEvents.h"
 #include "ThemeManager.h"
 #include "ViewModeHelper.h"
 #include "ViewModes.h"
@@ -81,23 +83,23 @@ ShellBrowserImpl::ShellBrowserImpl(HWND owner, App *app, BrowserWindow *browser,
 			: app->GetRuntime()->GetInlineExecutor(),
 		app->GetFeatureList()->IsEnabled(Feature::BackgroundThreadEnumeration)
 			? app->GetRuntime()->GetUiThreadExecutor()
-			: app->GetRuntime()->GetInlineExecutor()),
+			: app->GetRuntime()->GetInlineExecutor(),
+		app->GetFeatureList()->IsEnabled(Feature::FolderListingCache)
+			? app->GetFolderListingCache()
+			: nullptr),
 	m_progressCursor(LoadCursor(nullptr, IDC_APPSTARTING)),
 	m_commandTarget(browser->GetCommandTargetManager(), this),
 	m_fileActionHandler(fileActionHandler),
 	m_fontSetter(GetHWND(), app->GetConfig()),
 	m_tooltipFontSetter(reinterpret_cast<HWND>(SendMessage(GetHWND(), LVM_GETTOOLTIPS, 0, 0)),
 		app->GetConfig()),
-	m_columnThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
+	m_taskScheduler(app->GetTaskScheduler()),
+	m_taskGroup(m_taskScheduler->CreateGroup()),
 	m_columnResultIDCounter(0),
 	m_cachedIcons(app->GetCachedIcons()),
-	m_thumbnailThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
 	m_thumbnailResultIDCounter(0),
-	m_infoTipsThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
 	m_infoTipResultIDCounter(0),
+	m_backgroundStateEnabled(app->GetFeatureList()->IsEnabled(Feature::SuspendBackgroundTabs)),
 	m_resourceInstance(app->GetResourceInstance()),
 	m_acceleratorManager(app->GetAcceleratorManager()),
 	m_config(app->GetConfig()),
@@ -108,7 +110,20 @@ ShellBrowserImpl::ShellBrowserImpl(HWND owner, App *app, BrowserWindow *browser,
 	m_weakPtrFactory(this)
 {
 	InitializeListView();
-	m_iconFetcher = std::make_unique<IconFetcherImpl>(m_listView, m_cachedIcons);
+
+	// Tasks for this tab are run at a lower priority until the tab is selected.
+	m_taskScheduler->SetGroupVisible(m_taskGroup, false);
+	ResetNavigationTaskGroups();
+
+	if (m_app->GetFeatureList()->IsEnabled(Feature::BatchedResultDelivery))
+	{
+		m_resultSink = std::make_unique<UiResultSink>(m_app->GetRuntime()->GetUiThreadExecutor(),
+			m_app->GetRuntime()->GetTimerQueue(),
+			std::bind_front(&ShellBrowserImpl::ApplyResultBatch, this));
+	}
+
+	m_iconFetcher = std::make_unique<IconFetcherImpl>(m_listView, m_cachedIcons, m_taskScheduler,
+		m_taskGroup, m_resultSink.get());
 
 	m_connections.push_back(m_app->GetNavigationEvents()->AddStartedObserver(
 		std::bind_front(&ShellBrowserImpl::OnNavigationStarted, this),
@@ -122,6 +137,10 @@ ShellBrowserImpl::ShellBrowserImpl(HWND owner, App *app, BrowserWindow *browser,
 		NavigationEventScope::ForShellBrowser(*this), boost::signals2::at_front,
 		SlotGroup::HighPriority));
 
+	m_connections.push_back(m_app->GetTabEvents()->AddSelectedObserver(
+		std::bind_front(&ShellBrowserImpl::OnTabSelected, this),
+		TabEventScope::ForBrowser(*m_browser)));
+
 	m_connections.push_back(m_app->GetClipboardWatcher()->updateSignal.AddObserver(
 		std::bind_front(&ShellBrowserImpl::OnClipboardUpdate, this)));
 
@@ -139,6 +158,9 @@ ShellBrowserImpl::ShellBrowserImpl(HWND owner, App *app, BrowserWindow *browser,
 	FAIL_FAST_IF_FAILED(GetDefaultFileIconIndex(m_iFileIcon));
 
 	m_shellWindows = winrt::try_create_instance<IShellWindows>(CLSID_ShellWindows, CLSCTX_ALL);
+
+	// The listview is created hidden and will only be shown once the tab is selected.
+	m_inBackgroundState = m_backgroundStateEnabled;
 }
 
 ShellBrowserImpl::~ShellBrowserImpl()
@@ -159,9 +181,7 @@ ShellBrowserImpl::~ShellBrowserImpl()
 
 	DestroyWindow(m_listView);
 
-	m_columnThreadPool.clear_queue();
-	m_thumbnailThreadPool.clear_queue();
-	m_infoTipsThreadPool.clear_queue();
+	m_taskScheduler->CancelGroup(m_taskGroup);
 }
 
 HWND ShellBrowserImpl::CreateListView(HWND parent)
@@ -238,6 +258,99 @@ void ShellBrowserImpl::InitializeListView()
 	}
 }
 
+void ShellBrowserImpl::OnTabSelected(const Tab &tab)
+{
+	m_selected = (tab.GetShellBrowserImpl() == this);
+
+	// This has no effect if the visibility of the group hasn't changed, so the queued tasks are
+	// only re-evaluated when this tab is selected or deselected.
+	m_taskScheduler->SetGroupVisible(m_taskGroup, m_selected);
+
+	// Restoring the contents also takes the tab out of the background state.
+	if (m_selected && m_contentsDiscarded)
+	{
+		RestoreDiscardedContents();
+		return;
+	}
+
+	if (!m_backgroundStateEnabled)
+	{
+		return;
+	}
+
+	if (m_selected)
+	{
+		LeaveBackgroundState();
+	}
+	else
+	{
+		EnterBackgroundState();
+	}
+}
+
+void ShellBrowserImpl::EnterBackgroundState()
+{
+	if (m_inBackgroundState)
+	{
+		return;
+	}
+
+	m_inBackgroundState = true;
+
+	if (!m_columnResults.empty() || !m_thumbnailResults.empty()
+		|| m_iconFetcher->HasPendingTasks())
+	{
+		m_workDroppedInBackgroundState = true;
+	}
+
+	ClearPendingResults();
+}
+
+void ShellBrowserImpl::LeaveBackgroundState()
+{
+	if (!m_inBackgroundState)
+	{
+		return;
+	}
+
+	m_inBackgroundState = false;
+
+	bool changed = std::exchange(m_changedInBackgroundState, false);
+	bool workDropped = std::exchange(m_workDroppedInBackgroundState, false);
+
+	if (m_navigationState != NavigationState::Committed)
+	{
+		return;
+	}
+
+	if (changed)
+	{
+		// The individual changes weren't recorded, so the folder needs to be refreshed.
+		if (!CanRefreshInPlace())
+		{
+			// Reloading the folder will also requeue any work that was dropped.
+			m_navigationController->Refresh();
+			return;
+		}
+
+		Refresh();
+	}
+
+	if (workDropped)
+	{
+		// Resetting the items to use callbacks means that work will be requested again, but only
+		// for those items that are actually displayed.
+		InvalidateAllItemImages();
+
+		int numItems = ListView_GetItemCount(m_listView);
+
+		for (int i = 0; i < numItems; i++)
+		{
+			InvalidateAllColumnsForItem(i);
+		}
+	}
+}
+
 void ShellBrowserImpl::ChangeToInitialFolder()
 {
 	// This class always needs to represent a folder. Therefore, it's necessary to immediately
@@ -424,7 +537,7 @@ void ShellBrowserImpl::SetViewModeInternal(ViewMode viewMode)
 
 	if (viewMode != +ViewMode::Details)
 	{
-		m_columnThreadPool.clear_queue();
+		m_columnTaskGroup = m_taskScheduler->ReplaceGroup(m_columnTaskGroup);
 		m_columnResults.clear();
 	}
 
@@ -682,6 +795,36 @@ std::optional<int> ShellBrowserImpl::GetItemIndexForPidl(PCIDLIST_ABSOLUTE pidl)
 
 std::optional<int> ShellBrowserImpl::GetItemInternalIndexForPidl(PCIDLIST_ABSOLUTE pidl) const
 {
+	if (m_itemLookupIndex)
+	{
+		std::wstring parsingName;
+		HRESULT hr = GetDisplayName(pidl, SHGDN_FORPARSING, parsingName);
+
+		if (FAILED(hr))
+		{
+			return std::nullopt;
+		}
+
+		// Entries in the index aren't removed when an item is removed or renamed and distinct
+		// items can share a parsing name, so the item each entry refers to needs to be checked. If
+		// none of the entries match, the pidl doesn't refer to any item, since items added during
+		// the batch are added to the index.
+		auto [first, last] = m_itemLookupIndex->equal_range(parsingName);
+
+		for (auto indexItr = first; indexItr != last; ++indexItr)
+		{
+			auto itemItr = m_itemInfoMap.find(indexItr->second);
+
+			if (itemItr != m_itemInfoMap.end()
+				&& ArePidlsEquivalent(pidl, itemItr->second.pidlComplete.Raw()))
+			{
+				return indexItr->second;
+			}
+		}
+
+		return std::nullopt;
+	}
+
 	auto itr = std::find_if(m_itemInfoMap.begin(), m_itemInfoMap.end(), [pidl](const auto &pair)
 		{ return ArePidlsEquivalent(pidl, pair.second.pidlComplete.Raw()); });
 
@@ -695,6 +838,18 @@ std::optional<int> ShellBrowserImpl::GetItemInternalIndexForPidl(PCIDLIST_ABSOLU
 
 std::optional<int> ShellBrowserImpl::LocateItemByInternalIndex(int internalIndex) const
 {
+	if (m_itemIndexesByInternalIndex)
+	{
+		auto itr = m_itemIndexesByInternalIndex->find(internalIndex);
+
+		if (itr == m_itemIndexesByInternalIndex->end())
+		{
+			return std::nullopt;
+		}
+
+		return itr->second;
+	}
+
 	LVFINDINFO lvfi;
 	lvfi.flags = LVFI_PARAM;
 	lvfi.lParam = internalIndex;
@@ -1521,6 +1676,94 @@ void ShellBrowserImpl::SaveDirectoryListing()
 	FileOperations::SaveDirectoryListing(m_directoryState.directory, filePath);
 }
 
+ShellBrowserMemoryUsage ShellBrowserImpl::GetMemoryUsage() const
+{
+	ShellBrowserMemoryUsage usage;
+
+	for (const auto &[internalIndex, itemInfo] : m_itemInfoMap)
+	{
+		usage.items += sizeof(internalIndex) + sizeof(itemInfo)
+			+ ILGetSize(itemInfo.pidlComplete.Raw()) + ILGetSize(itemInfo.pridl.Raw())
+			+ ((itemInfo.parsingName.capacity() + itemInfo.displayName.capacity()
+				   + itemInfo.editingName.capacity())
+				* sizeof(wchar_t));
+	}
+
+	if (m_directoryState.thumbnailsImageList)
+	{
+		int width;
+		int height;
+		ImageList_GetIconSize(m_directoryState.thumbnailsImageList.get(), &width, &height);
+
+		// Thumbnails are stored as 32-bit images.
+		usage.thumbnails = ImageList_GetImageCount(m_directoryState.thumbnailsImageList.get())
+			* static_cast<size_t>(width) * height * 4;
+	}
+
+	usage.history = m_navigationController->GetHistoryMemoryUsage();
+
+	usage.pendingResults = (m_columnResults.size() * sizeof(ColumnResult_t))
+		+ (m_thumbnailResults.size() * sizeof(ThumbnailResult_t))
+		+ (m_infoTipResults.size() * sizeof(InfoTipResult))
+		+ (m_directoryState.awaitingAddList.capacity() * sizeof(AwaitingAdd_t))
+		+ (m_directoryState.filteredItemsList.size() * sizeof(int))
+		+ (m_directoryState.cachedFolderSizes.size() * (sizeof(int) + sizeof(ULONGLONG)));
+
+	return usage;
+}
+
+bool ShellBrowserImpl::DiscardContents()
+{
+	if (m_contentsDiscarded)
+	{
+		return true;
+	}
+
+	if (m_selected || m_navigationState != NavigationState::Committed
+		|| MaybeGetLatestActiveNavigation())
+	{
+		return false;
+	}
+
+	// The selection is restored from the history entry when the folder is reloaded, so it needs to
+	// be saved now, while the items still exist.
+	StoreCurrentlySelectedItems();
+
+	ClearPendingResults();
+
+	ListView_DeleteAllItems(m_listView);
+
+	if (m_directoryState.thumbnailsImageList)
+	{
+		ImageList_RemoveAll(m_directoryState.thumbnailsImageList.get());
+	}
+
+	m_directoryState.awaitingAddList = {};
+	m_directoryState.filteredItemsList = {};
+	m_directoryState.cachedFolderSizes = {};
+	m_itemInfoMap = {};
+
+	m_contentsDiscarded = true;
+
+	return true;
+}
+
+bool ShellBrowserImpl::AreContentsDiscarded() const
+{
+	return m_contentsDiscarded;
+}
+
+void ShellBrowserImpl::RestoreDiscardedContents()
+{
+	// Reloading the folder will also pick up any changes that were made while the tab was in the
+	// background, so there's no need to track them separately.
+	m_inBackgroundState = false;
+	m_changedInBackgroundState = false;
+	m_workDroppedInBackgroundState = false;
+
+	m_navigationController->Refresh();
+}
+
 boost::signals2::connection ShellBrowserImpl::AddDestroyedObserver(
 	const DestroyedSignal::slot_type &observer)
 {
@@ -7,14 +7,18 @@
 #include "BrowserCommandTarget.h"
 #include "ClipboardOperations.h"
 #include "Columns.h"
+#include "DirectoryChangeCoalescer.h"
 #include "DirectoryWatcher.h"
 #include "FolderSettings.h"
+#include "ListingDiff.h"
 #include "MainFontSetter.h"
 #include "NavigationManager.h"
 #include "ScopedBrowserCommandTarget.h"
 #include "ServiceProvider.h"
 #include "ShellBrowser.h"
 #include "SortModes.h"
+#include "TaskScheduler.h"
+#include "UiResultSink.h"
 #include "ViewModes.h"
 #include "../Helper/ClipboardHelper.h"
 #include "../Helper/FileOperations.h"
@@ -23,7 +27,6 @@
 #include "../Helper/WeakPtr.h"
 #include "../Helper/WeakPtrFactory.h"
 #include "../Helper/WinRTBaseWrapper.h"
-#include "../ThirdParty/CTPL/cpl_stl.h"
 #include <boost/core/noncopyable.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
@@ -33,11 +36,15 @@
 #include <wil/com.h>
 #include <wil/resource.h>
 #include <thumbcache.h>
+#include <chrono>
+#include <functional>
 #include <future>
 #include <memory>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 class AcceleratorManager;
 class App;
@@ -46,12 +53,15 @@ class BrowserWindow;
 class CachedIcons;
 struct Config;
 class FileActionHandler;
-class IconFetcher;
+class FolderListingCache;
+class IconFetcherImpl;
 class NavigationRequest;
 struct PreservedShellBrowser;
 class Runtime;
+class ShellEnumerator;
 class ShellEnumeratorImpl;
 class ShellNavigationController;
+class Tab;
 class WindowSubclass;
 
 typedef struct
@@ -112,8 +122,12 @@ public:
 	bool IsFilterEnabled() const override;
 	void SetFilterEnabled(bool enabled) override;
 	void EditFilterSettings() override;
+	void Refresh() override;
 	bool CanSaveDirectoryListing() const override;
 	void SaveDirectoryListing() override;
+	ShellBrowserMemoryUsage GetMemoryUsage() const override;
+	bool DiscardContents() override;
+	bool AreContentsDiscarded() const override;
 	boost::signals2::connection AddDestroyedObserver(
 		const DestroyedSignal::slot_type &observer) override;
 
@@ -168,6 +182,10 @@ public:
 	std::vector<SortMode> GetAvailableSortModes() const;
 	void QueueRename(PCIDLIST_ABSOLUTE pidlItem);
 
+	// Speculatively enumerates the folder in the background (if folder prefetching is enabled), so
+	// that a subsequent navigation to the folder can be completed immediately.
+	void PrefetchFolder(const PidlAbsolute &folder);
+
 	// BrowserCommandTarget
 	bool IsCommandEnabled(int command) const override;
 	void ExecuteCommand(int command) override;
@@ -236,6 +254,29 @@ private:
 		wil::unique_hbitmap bitmap;
 	};
 
+	// The item a result is for is stored alongside the result, so that the associated task can be
+	// re-prioritized based on the item's position.
+	struct PendingColumnResult
+	{
+		int itemInternalIndex;
+		ColumnType columnType;
+		std::future<ColumnResult_t> result;
+	};
+
+	struct PendingThumbnailResult
+	{
+		int itemInternalIndex;
+		std::future<std::optional<ThumbnailResult_t>> result;
+	};
+
+	// The internal indexes of the items that are in view, as well as the items that are close to
+	// being in view.
+	struct ViewportItems
+	{
+		std::unordered_set<int> visibleItems;
+		std::unordered_set<int> nearbyItems;
+	};
+
 	struct InfoTipResult
 	{
 		int itemInternalIndex;
@@ -358,6 +399,39 @@ private:
 	static const UINT WM_APP_THUMBNAIL_RESULT_READY = WM_APP + 151;
 	static const UINT WM_APP_INFO_TIP_READY = WM_APP + 152;
 
+	// The amount of time the mouse needs to rest over a folder before the folder is prefetched.
+	static constexpr std::chrono::milliseconds PREFETCH_HOVER_DELAY =
+		std::chrono::milliseconds(400);
+
+	static constexpr size_t NUM_FREQUENT_LOCATIONS_TO_PREFETCH = 3;
+
+	// Directory changes are collected over this period, then applied as a single batch.
+	static constexpr std::chrono::milliseconds DIRECTORY_CHANGE_COALESCING_WINDOW =
+		std::chrono::milliseconds(50);
+
+	// If the folder keeps changing while an in-place refresh is enumerating it, the refresh will be
+	// restarted at most this many times before being abandoned.
+	static constexpr int MAX_REFRESH_IN_PLACE_ATTEMPTS = 3;
+
+	// When a batch contains at least this many changes, an index of the items in the folder will
+	// be built, so that each change doesn't require a linear search for the item it refers to.
+	static constexpr size_t ITEM_LOOKUP_INDEX_THRESHOLD = 64;
+
+	// When the listview is scrolled, queued tasks for items within this many pages of the items in
+	// view will be kept (at a lower priority). Tasks for any other items will be cancelled.
+	static constexpr int NUM_NEARBY_VIEWPORT_PAGES = 2;
+
+	// When a batch of task results contains at least this many results, redrawing will be disabled
+	// while the batch is applied. If the batch is also large relative to the number of items (see
+	// ITEM_INDEX_MAP_ITEMS_PER_LOOKUP), the position of each item will be looked up once, rather
+	// than once per result.
+	static constexpr size_t LARGE_RESULT_BATCH_THRESHOLD = 16;
+
+	// Finding a single item searches the listview internally, whereas building a map of item
+	// positions requires every item to be retrieved individually. So, a map is only built when
+	// there's at least one lookup for every this many items.
+	static constexpr size_t ITEM_INDEX_MAP_ITEMS_PER_LOOKUP = 32;
+
 	ShellBrowserImpl(HWND owner, App *app, BrowserWindow *browser,
 		FileActionHandler *fileActionHandler, const FolderSettings &folderSettings,
 		const FolderColumns *initialColumns);
@@ -376,12 +450,19 @@ private:
 	void ChangeFolders(const PidlAbsolute &directory);
 	void PrepareToChangeFolders();
 	void ClearPendingResults();
+	void ResetNavigationTaskGroups();
 	void StoreCurrentlySelectedItems();
 	void ResetFolderState();
 	void OnNavigationWillCommit(const NavigationRequest *request);
 	void OnNavigationComitted(const NavigationRequest *request);
 	void AddNavigationItems(const NavigationRequest *request,
 		const std::vector<PidlChild> &itemPidls);
+	static concurrencpp::null_result VerifyCachedListing(WeakPtr<ShellBrowserImpl> weakSelf,
+		std::shared_ptr<const ShellEnumerator> shellEnumerator,
+		std::shared_ptr<FolderListingCache> listingCache, PidlAbsolute directory,
+		std::vector<PidlChild> cachedItems, Runtime *runtime);
+	bool IsFolderPrefetchEnabled() const;
+	void PrefetchLikelyNavigationTargets();
 	std::vector<ItemInfo_t> GetItemInformationFromPidls(const NavigationRequest *request,
 		const std::vector<PidlChild> &itemPidls);
 	void InsertAwaitingItems();
@@ -396,6 +477,12 @@ private:
 	void SetFirstColumnTextToFilename();
 	void SetNavigationState(NavigationState navigationState);
 
+	// Background state
+	void OnTabSelected(const Tab &tab);
+	void EnterBackgroundState();
+	void LeaveBackgroundState();
+	void RestoreDiscardedContents();
+
 	// Shell window integration
 	void NotifyShellOfNavigation(PCIDLIST_ABSOLUTE pidl);
 	HRESULT RegisterShellWindowIfNecessary(PCIDLIST_ABSOLUTE pidl);
@@ -415,6 +502,8 @@ private:
 	bool OnListViewLeftButtonDoubleClick(const POINT *pt);
 	void OnListViewMButtonDown(const POINT *pt);
 	void OnListViewMButtonUp(const POINT *pt, UINT keysDown);
+	void OnListViewHotTrack(const NMLISTVIEW *info);
+	void OnPrefetchHoverTimer(int item, const PidlAbsolute &folder);
 	void OnRButtonDown(HWND hwnd, BOOL doubleClick, int x, int y, UINT keyFlags);
 	bool OnMouseWheel(int xPos, int yPos, int delta, UINT keys);
 	void OnShowListViewContextMenu(const POINT &ptScreen);
@@ -422,10 +511,20 @@ private:
 	void ShowItemContextMenu(const POINT &pt);
 	bool OnSetCursor(HWND target);
 	void OnListViewGetDisplayInfo(LPARAM lParam);
+	void OnListViewEndScroll();
+	void ReprioritizeQueuedTasks();
+	ViewportItems GetViewportItems() const;
+	std::vector<int> GetVisibleItems() const;
+	std::vector<int> GetVisibleItemsByHitTest() const;
+	std::function<void()> MakeResultReadyNotifier(UINT resultMessage, int resultId);
+	void ProcessResult(UINT resultMessage, int resultId);
+	void ApplyResultBatch(size_t numResults, const std::function<void()> &applyResults);
+	bool ShouldBuildItemIndexMap(size_t numLookups) const;
+	std::unordered_map<int, int> BuildItemIndexesByInternalIndex() const;
 	LRESULT OnListViewGetInfoTip(NMLVGETINFOTIP *getInfoTip);
 	BOOL OnListViewGetEmptyMarkup(NMLVEMPTYMARKUP *emptyMarkup);
 	void QueueInfoTipTask(int internalIndex, const std::wstring &existingInfoTip);
-	static std::optional<InfoTipResult> GetInfoTipAsync(HWND listView, int infoTipResultId,
+	static std::optional<InfoTipResult> GetInfoTipAsync(const std::function<void()> &notifyReady,
 		int internalIndex, const BasicItemInfo_t &basicItemInfo, const Config &config,
 		HINSTANCE resourceInstance, bool virtualFolder);
 	void ProcessInfoTipResult(int infoTipResultId);
@@ -489,7 +588,7 @@ private:
 	void SetUpListViewColumns();
 	void DeleteAllColumns();
 	void QueueColumnTask(int itemInternalIndex, ColumnType columnType);
-	static ColumnResult_t GetColumnTextAsync(HWND listView, int columnResultId,
+	static ColumnResult_t GetColumnTextAsync(const std::function<void()> &notifyReady,
 		ColumnType columnType, int internalIndex, const BasicItemInfo_t &basicItemInfo,
 		const GlobalFolderSettings &globalFolderSettings);
 	void InsertColumn(ColumnType columnType, int columnIndex, int width);
@@ -505,6 +604,12 @@ private:
 	void StartDirectoryMonitoring();
 	void ProcessDirectoryChangeNotification(DirectoryWatcher::Event event,
 		const PidlAbsolute &simplePidl1, const PidlAbsolute &simplePidl2);
+	void ScheduleCoalescedDirectoryChanges();
+	void ApplyCoalescedDirectoryChanges();
+	void ApplyItemChangesAsBatch(size_t numChanges, const std::function<void()> &applyChanges);
+	void ApplyDirectoryChange(DirectoryWatcher::Event event, const PidlAbsolute &simplePidl1,
+		const PidlAbsolute &simplePidl2);
+	void BuildItemLookupIndex();
 	void OnItemAdded(PCIDLIST_ABSOLUTE simplePidl);
 	void AddItem(PCIDLIST_ABSOLUTE pidl);
 	void RemoveItem(int iItemInternal);
@@ -521,6 +626,14 @@ private:
 		WeakPtr<ShellBrowserImpl> weakSelf, PidlAbsolute currentDirectory, Runtime *runtime);
 	static concurrencpp::null_result RefreshDirectoryAfterUpdate(WeakPtr<ShellBrowserImpl> weakSelf,
 		Runtime *runtime);
+	bool CanRefreshInPlace() const;
+	void RefreshFromListing(std::optional<std::vector<PidlChild>> items, int attempt = 1);
+	static concurrencpp::null_result RefreshInPlace(WeakPtr<ShellBrowserImpl> weakSelf,
+		std::shared_ptr<const ShellEnumerator> shellEnumerator, PidlAbsolute directory,
+		std::optional<std::vector<PidlChild>> items, uint64_t directoryChangeSequenceNumber,
+		int attempt, Runtime *runtime);
+	void ApplyRefreshedListing(const PidlAbsolute &directory,
+		const std::vector<ListingDiff::Entry> &newEntries);
 	static concurrencpp::null_result NavigateUpToClosestExistingItemIfNecessary(
 		WeakPtr<ShellBrowserImpl> weakSelf, PidlAbsolute currentDirectory, Runtime *runtime);
 
@@ -584,6 +697,7 @@ private:
 	void SetupThumbnailsView(int shellImageListType);
 	void RemoveThumbnailsView();
 	void InvalidateAllItemImages();
+	void InvalidateItemImage(int index);
 	int GetIconThumbnail(int iInternalIndex) const;
 	int GetExtractedThumbnail(HBITMAP hThumbnailBitmap) const;
 	int GetThumbnailInternal(int iType, int iInternalIndex, HBITMAP hThumbnailBitmap) const;
@@ -652,21 +766,89 @@ private:
 	as display name. */
 	std::unordered_map<int, ItemInfo_t> m_itemInfoMap;
 
-	ctpl::thread_pool m_columnThreadPool;
-	std::unordered_map<int, std::future<ColumnResult_t>> m_columnResults;
+	TaskScheduler *const m_taskScheduler;
+
+	// All background work for this tab is placed within this group, which is hidden whenever the
+	// tab is hidden.
+	const std::shared_ptr<TaskScheduler::Group> m_taskGroup;
+
+	// Contains the work for the current folder. This group is replaced whenever the folder changes,
+	// which cancels any outstanding work for the previous folder.
+	std::shared_ptr<TaskScheduler::Group> m_navigationTaskGroup;
+
+	std::shared_ptr<TaskScheduler::Group> m_columnTaskGroup;
+	std::unordered_map<int, PendingColumnResult> m_columnResults;
 	int m_columnResultIDCounter;
 
-	std::unique_ptr<IconFetcher> m_iconFetcher;
+	// Only set when results are delivered in batches. In that case, the results of the column,
+	// thumbnail, info tip and icon tasks are all delivered through this sink.
+	std::unique_ptr<UiResultSink> m_resultSink;
+
+	// Only set while a large batch of task results is being applied. Maps the internal index of
+	// each item to its index in the listview.
+	std::optional<std::unordered_map<int, int>> m_itemIndexesByInternalIndex;
+
+	std::unique_ptr<IconFetcherImpl> m_iconFetcher;
 	CachedIcons *m_cachedIcons;
 
-	ctpl::thread_pool m_thumbnailThreadPool;
-	std::unordered_map<int, std::future<std::optional<ThumbnailResult_t>>> m_thumbnailResults;
+	std::shared_ptr<TaskScheduler::Group> m_thumbnailTaskGroup;
+	std::unordered_map<int, PendingThumbnailResult> m_thumbnailResults;
 	int m_thumbnailResultIDCounter;
 
-	ctpl::thread_pool m_infoTipsThreadPool;
+	std::shared_ptr<TaskScheduler::Group> m_infoTipTaskGroup;
 	std::unordered_map<int, std::future<std::optional<InfoTipResult>>> m_infoTipResults;
 	int m_infoTipResultIDCounter;
 
+	// While the tab isn't selected, directory changes are only recorded, rather than processed, and
+	// any icon, thumbnail or column work that's requested is dropped. The listview is brought up to
+	// date once the tab is selected again. This is based on tab selection, rather than the
+	// visibility of the listview, since the listview can be briefly shown and hidden while the
+	// tab remains in the background (e.g. to capture a taskbar thumbnail).
+	const bool m_backgroundStateEnabled;
+	bool m_inBackgroundState = false;
+	bool m_changedInBackgroundState = false;
+	bool m_workDroppedInBackgroundState = false;
+
+	// Whether this is the selected tab in its browser window. Contents are only discarded while the
+	// tab isn't selected.
+	bool m_selected = false;
+
+	// Set when the listing has been released to save memory. The folder will be reloaded when the
+	// tab is next selected. That's independent of the listview's visibility, since the listview of
+	// a background tab can be shown briefly (e.g. to capture a taskbar thumbnail), which shouldn't
+	// cause the folder to be reloaded.
+	bool m_contentsDiscarded = false;
+
+	// The item currently under the mouse in the listview and the timer that will prefetch it, if
+	// it's a folder and the mouse stays over it.
+	int m_prefetchHotItem = -1;
+	concurrencpp::timer m_prefetchHoverTimer;
+
+	// Directory changes that have been received, but not yet applied. Each tab owns its own
+	// coalescer, fed from ProcessDirectoryChangeNotification() once a notification has been
+	// delivered by one of the tab's directory watchers.
+	DirectoryChangeCoalescer m_directoryChangeCoalescer;
+	concurrencpp::timer m_directoryChangeTimer;
+
+	// Incremented each time a directory change notification is received. An in-place refresh
+	// records this when it starts, so that it can detect whether the folder changed while it was
+	// being enumerated.
+	uint64_t m_directoryChangeSequenceNumber = 0;
+
+	// While a batch of directory changes is being applied, new items are inserted into the
+	// listview and the listview is re-sorted once, at the end of the batch, rather than once per
+	// change.
+	bool m_applyingDirectoryChanges = false;
+	bool m_sortAfterDirectoryChanges = false;
+
+	// Only set while a large batch of directory changes is being applied. Maps the parsing name of
+	// each item to its internal index. The parsing name is already stored for each item, so
+	// building the index doesn't require any calls into the shell. Keying the index by pidl would
+	// instead retrieve the parsing name each time a key was hashed (including whenever the map
+	// rehashed). Distinct items can share a parsing name, so the index can contain multiple entries
+	// for a single name.
+	std::optional<std::unordered_multimap<std::wstring, int>> m_itemLookupIndex;
+
 	/* Internal state. */
 	const HINSTANCE m_resourceInstance;
 	AcceleratorManager *const m_acceleratorManager;
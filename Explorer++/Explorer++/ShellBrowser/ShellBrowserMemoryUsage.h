@@ -0,0 +1,30 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+// An estimate of the memory held by a single ShellBrowser instance, in bytes. The figures only
+// cover the data that's directly owned by the browser and are intended to give an indication of
+// which tabs are the most expensive to keep around, rather than being exact.
+struct ShellBrowserMemoryUsage
+{
+	// The information stored for each item in the current listing.
+	size_t items = 0;
+
+	// Thumbnails that have been generated for items in the current listing.
+	size_t thumbnails = 0;
+
+	// The pidls stored in the navigation history, including the selected items for each entry.
+	size_t history = 0;
+
+	// Column, thumbnail and info tip results that are outstanding, along with cached folder sizes.
+	size_t pendingResults = 0;
+
+	size_t GetTotal() const
+	{
+		return items + thumbnails + history + pendingResults;
+	}
+
+	bool operator==(const ShellBrowserMemoryUsage &) const = default;
+};
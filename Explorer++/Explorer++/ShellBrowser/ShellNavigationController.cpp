@@ -185,6 +185,7 @@ void ShellNavigationController::Navigate(NavigateParams &navigateParams)
 	{
 		navigateParams.historyEntryType = HistoryEntryType::ReplaceCurrentEntry;
 		navigateParams.overrideNavigationTargetMode = true;
+		navigateParams.allowCachedListing = false;
 	}
 
 	if (m_navigationTargetMode == NavigationTargetMode::ForceNewTab
@@ -221,3 +222,15 @@ HistoryEntry *ShellNavigationController::GetEntryById(int id)
 
 	return nullptr;
 }
+
+size_t ShellNavigationController::GetHistoryMemoryUsage() const
+{
+	size_t usage = 0;
+
+	for (int i = 0; i < GetNumHistoryEntries(); i++)
+	{
+		usage += GetEntryAtIndex(i)->GetMemoryUsage();
+	}
+
+	return usage;
+}
@@ -53,6 +53,9 @@ public:
 
 	HistoryEntry *GetEntryById(int id);
 
+	// Returns the approximate number of bytes used by all the entries in the history.
+	size_t GetHistoryMemoryUsage() const;
+
 private:
 	void Initialize(const ShellBrowser *shellBrowser, NavigationEvents *navigationEvents);
 
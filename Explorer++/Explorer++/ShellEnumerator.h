@@ -15,4 +15,8 @@ public:
 
 	virtual HRESULT EnumerateDirectory(PCIDLIST_ABSOLUTE pidlDirectory,
 		std::vector<PidlChild> &outputItems, std::stop_token stopToken) const = 0;
+
+	// Returns the flags that are currently used when enumerating a directory. Two enumerations of
+	// the same directory with the same flags will return the same set of items.
+	virtual SHCONTF GetEnumerationFlags() const = 0;
 };
@@ -21,17 +21,7 @@ HRESULT ShellEnumeratorImpl::EnumerateDirectory(PCIDLIST_ABSOLUTE pidlDirectory,
 	wil::com_ptr_nothrow<IShellFolder> shellFolder;
 	RETURN_IF_FAILED(SHBindToObject(nullptr, pidlDirectory, nullptr, IID_PPV_ARGS(&shellFolder)));
 
-	SHCONTF enumFlags = SHCONTF_FOLDERS;
-
-	if (m_enumerationScope == EnumerationScope::FoldersAndFiles)
-	{
-		WI_SetFlag(enumFlags, SHCONTF_NONFOLDERS);
-	}
-
-	if (m_hiddenItemsPolicy == HiddenItemsPolicy::IncludeHidden)
-	{
-		WI_SetAllFlags(enumFlags, SHCONTF_INCLUDEHIDDEN | SHCONTF_INCLUDESUPERHIDDEN);
-	}
+	SHCONTF enumFlags = GetEnumerationFlags();
 
 	// Note that if this function operates asynchronously, the `m_embedder` window handle passed in
 	// here could be invalidated at any time. Unfortunately, there doesn't seem to be any way to
@@ -59,6 +49,23 @@ HRESULT ShellEnumeratorImpl::EnumerateDirectory(PCIDLIST_ABSOLUTE pidlDirectory,
 	return S_OK;
 }
 
+SHCONTF ShellEnumeratorImpl::GetEnumerationFlags() const
+{
+	SHCONTF enumFlags = SHCONTF_FOLDERS;
+
+	if (m_enumerationScope == EnumerationScope::FoldersAndFiles)
+	{
+		WI_SetFlag(enumFlags, SHCONTF_NONFOLDERS);
+	}
+
+	if (m_hiddenItemsPolicy == HiddenItemsPolicy::IncludeHidden)
+	{
+		WI_SetAllFlags(enumFlags, SHCONTF_INCLUDEHIDDEN | SHCONTF_INCLUDESUPERHIDDEN);
+	}
+
+	return enumFlags;
+}
+
 void ShellEnumeratorImpl::SetHiddenItemsPolicy(HiddenItemsPolicy hiddenItemsPolicy)
 {
 	m_hiddenItemsPolicy = hiddenItemsPolicy;
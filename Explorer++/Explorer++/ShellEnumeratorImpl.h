@@ -29,6 +29,7 @@ public:
 
 	HRESULT EnumerateDirectory(PCIDLIST_ABSOLUTE pidlDirectory, std::vector<PidlChild> &outputItems,
 		std::stop_token stopToken) const override;
+	SHCONTF GetEnumerationFlags() const override;
 
 	// It's safe to call this method on one thread while `EnumerateDirectory` is being run on a
 	// different thread.
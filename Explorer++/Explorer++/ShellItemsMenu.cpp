@@ -31,6 +31,7 @@ void ShellItemsMenu::RebuildMenu(const std::vector<PidlAbsolute> &pidls)
 {
 	m_menuView->ClearMenu();
 	m_idCounter = GetIdRange().startId;
+	m_freeIds.clear();
 	m_idPidlMap.clear();
 
 	for (const auto &pidl : pidls)
@@ -41,21 +42,66 @@ void ShellItemsMenu::RebuildMenu(const std::vector<PidlAbsolute> &pidls)
 
 void ShellItemsMenu::AddMenuItemForPidl(PCIDLIST_ABSOLUTE pidl)
 {
-	auto id = m_idCounter++;
+	auto id = MaybeAllocateId();
 
-	if (id >= GetIdRange().endId)
+	if (!id)
 	{
 		return;
 	}
 
-	m_menuView->AppendItem(id, GetDisplayNameWithFallback(pidl, SHGDN_NORMAL),
+	m_menuView->AppendItem(*id, GetDisplayNameWithFallback(pidl, SHGDN_NORMAL),
 		std::make_unique<ShellIconModel>(m_shellIconLoader, pidl),
 		GetFolderPathForDisplayWithFallback(pidl));
 
-	auto [itr, didInsert] = m_idPidlMap.insert({ id, pidl });
+	auto [itr, didInsert] = m_idPidlMap.insert({ *id, pidl });
 	DCHECK(didInsert);
 }
 
+std::optional<UINT> ShellItemsMenu::PrependItem(const PidlAbsolute &pidl)
+{
+	auto id = MaybeAllocateId();
+
+	if (!id)
+	{
+		return std::nullopt;
+	}
+
+	m_menuView->PrependItem(*id, GetDisplayNameWithFallback(pidl.Raw(), SHGDN_NORMAL),
+		std::make_unique<ShellIconModel>(m_shellIconLoader, pidl.Raw()),
+		GetFolderPathForDisplayWithFallback(pidl.Raw()));
+
+	auto [itr, didInsert] = m_idPidlMap.insert({ *id, pidl });
+	DCHECK(didInsert);
+
+	return id;
+}
+
+void ShellItemsMenu::RemoveItem(UINT id)
+{
+	auto numErased = m_idPidlMap.erase(id);
+	DCHECK_EQ(numErased, 1u);
+
+	m_menuView->RemoveItem(id);
+	m_freeIds.push_back(id);
+}
+
+std::optional<UINT> ShellItemsMenu::MaybeAllocateId()
+{
+	if (!m_freeIds.empty())
+	{
+		auto id = m_freeIds.back();
+		m_freeIds.pop_back();
+		return id;
+	}
+
+	if (m_idCounter >= GetIdRange().endId)
+	{
+		return std::nullopt;
+	}
+
+	return m_idCounter++;
+}
+
 void ShellItemsMenu::OnMenuItemSelected(UINT menuItemId, bool isCtrlKeyDown, bool isShiftKeyDown)
 {
 	OpenSelectedItem(menuItemId, false, isCtrlKeyDown, isShiftKeyDown);
@@ -23,8 +23,16 @@ public:
 
 	void RebuildMenu(const std::vector<PidlAbsolute> &pidls);
 
+	// Inserts an item at the start of the menu. Returns the ID of the new item, or std::nullopt if
+	// there are no IDs left.
+	std::optional<UINT> PrependItem(const PidlAbsolute &pidl);
+
+	// The ID of the removed item may be reused for an item that's added later.
+	void RemoveItem(UINT id);
+
 private:
 	void AddMenuItemForPidl(PCIDLIST_ABSOLUTE pidl);
+	std::optional<UINT> MaybeAllocateId();
 
 	void OnMenuItemSelected(UINT menuItemId, bool isCtrlKeyDown, bool isShiftKeyDown);
 	void OnMenuItemMiddleClicked(UINT menuItemId, bool isCtrlKeyDown, bool isShiftKeyDown);
@@ -34,6 +42,7 @@ private:
 	BrowserWindow *const m_browserWindow;
 	ShellIconLoader *const m_shellIconLoader;
 	UINT m_idCounter;
+	std::vector<UINT> m_freeIds;
 	std::unordered_map<UINT, PidlAbsolute> m_idPidlMap;
 
 	std::vector<boost::signals2::scoped_connection> m_connections;
@@ -142,6 +142,7 @@ void ShellTreeView::OnItemAdded(PCIDLIST_ABSOLUTE simplePidl)
 		pidl = simplePidl;
 	}
 
+	FinishPendingChildInsertions(parentItem);
 	AddItem(parentItem, pidl);
 	SortChildren(parentItem);
 }
@@ -213,6 +214,7 @@ void ShellTreeView::OnItemUpdated(PCIDLIST_ABSOLUTE simplePidl, PCIDLIST_ABSOLUT
 	// the items should be sorted.
 	if (parent)
 	{
+		FinishPendingChildInsertions(parent);
 		SortChildren(parent);
 	}
 }
@@ -237,6 +239,8 @@ void ShellTreeView::RemoveItem(HTREEITEM item)
 	[[maybe_unused]] bool deleted = TreeView_DeleteItem(m_hTreeView, item);
 	assert(deleted);
 
+	UnregisterNodeAndChildren(node);
+
 	if (parent)
 	{
 		auto *parentNode = node->GetParent();
@@ -304,13 +308,12 @@ void ShellTreeView::OnDirectoryUpdated(PCIDLIST_ABSOLUTE simplePidl)
 	}
 
 	StopDirectoryMonitoringForNodeAndChildren(quickAccessRootNode);
-	quickAccessRootNode->RemoveAllChildren();
+	RemoveChildNodes(quickAccessRootNode);
 
 	SendMessage(m_hTreeView, TVM_EXPAND, TVE_COLLAPSE | TVE_COLLAPSERESET,
 		reinterpret_cast<LPARAM>(m_quickAccessRootItem));
 
-	SendMessage(m_hTreeView, TVM_EXPAND, TVE_EXPAND,
-		reinterpret_cast<LPARAM>(m_quickAccessRootItem));
+	ExpandItemSynchronously(m_quickAccessRootItem);
 
 	if (selectedItemPidl)
 	{
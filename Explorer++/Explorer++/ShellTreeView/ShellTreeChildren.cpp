@@ -0,0 +1,227 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ShellTreeChildren.h"
+#include "../Helper/ShellHelper.h"
+#include <wil/common.h>
+#include <propkey.h>
+#include <algorithm>
+
+namespace ShellTreeChildren
+{
+
+PendingInsertion::PendingInsertion(std::vector<ChildNodeInfo> children, size_t numInserted) :
+	m_children(std::move(children)),
+	m_nextIndex(numInserted)
+{
+	DCHECK(m_nextIndex <= m_children.size());
+}
+
+std::span<const ChildNodeInfo> PendingInsertion::TakeNextBatch()
+{
+	size_t numToTake =
+		std::min(m_children.size() - m_nextIndex, INCREMENTAL_INSERTION_BATCH_SIZE);
+	std::span<const ChildNodeInfo> batch(m_children.data() + m_nextIndex, numToTake);
+	m_nextIndex += numToTake;
+	return batch;
+}
+
+std::span<const ChildNodeInfo> PendingInsertion::TakeRemaining()
+{
+	std::span<const ChildNodeInfo> remaining(m_children.data() + m_nextIndex,
+		m_children.size() - m_nextIndex);
+	m_nextIndex = m_children.size();
+	return remaining;
+}
+
+bool PendingInsertion::IsComplete() const
+{
+	return m_nextIndex == m_children.size();
+}
+
+HRESULT EnumerateChildNodes(PCIDLIST_ABSOLUTE pidlDirectory, const EnumerationOptions &options,
+	std::vector<ChildNodeInfo> &outputChildren)
+{
+	wil::com_ptr_nothrow<IShellFolder2> shellFolder2;
+	HRESULT hr = SHBindToObject(nullptr, pidlDirectory, nullptr, IID_PPV_ARGS(&shellFolder2));
+
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	SHCONTF enumFlags = SHCONTF_FOLDERS;
+
+	if (options.showHidden)
+	{
+		enumFlags |= SHCONTF_INCLUDEHIDDEN | SHCONTF_INCLUDESUPERHIDDEN;
+	}
+
+	wil::com_ptr_nothrow<IEnumIDList> pEnumIDList;
+	hr = shellFolder2->EnumObjects(nullptr, enumFlags, &pEnumIDList);
+
+	if (FAILED(hr) || !pEnumIDList)
+	{
+		return hr;
+	}
+
+	unique_pidl_child pidlItem;
+	ULONG uFetched = 1;
+
+	while (pEnumIDList->Next(1, wil::out_param(pidlItem), &uFetched) == S_OK && (uFetched == 1))
+	{
+		if (options.checkPinnedToNamespaceTree)
+		{
+			BOOL showItem = GetBooleanVariant(shellFolder2.get(), pidlItem.get(),
+				&PKEY_IsPinnedToNameSpaceTree, TRUE);
+
+			if (!showItem)
+			{
+				continue;
+			}
+		}
+
+		if (options.hideSystemFiles)
+		{
+			PCITEMID_CHILD child = pidlItem.get();
+			SFGAOF attributes = SFGAO_SYSTEM;
+			hr = shellFolder2->GetAttributesOf(1, &child, &attributes);
+
+			if (FAILED(hr) || (WI_IsFlagSet(attributes, SFGAO_SYSTEM)))
+			{
+				continue;
+			}
+		}
+
+		unique_pidl_absolute pidlComplete(ILCombine(pidlDirectory, pidlItem.get()));
+		auto nodeInfo = GetNodeInfo(pidlComplete.get(), options.retainShellItems);
+
+		if (!nodeInfo)
+		{
+			continue;
+		}
+
+		outputChildren.push_back({ std::move(*nodeInfo), BuildSortKey(pidlComplete.get()) });
+	}
+
+	// The sort keys are retrieved once per item above, so sorting here is cheap. That's in
+	// contrast to sorting the items once they've been inserted into the treeview, where the keys
+	// would be retrieved for every comparison.
+	std::ranges::stable_sort(outputChildren,
+		[useNaturalSortOrder = options.useNaturalSortOrder](const auto &child1, const auto &child2)
+		{ return CompareSortKeys(child1.sortKey, child2.sortKey, useNaturalSortOrder) < 0; });
+
+	return S_OK;
+}
+
+std::optional<NodeInfo> GetNodeInfo(PCIDLIST_ABSOLUTE pidl, bool retainShellItem)
+{
+	wil::com_ptr_nothrow<IShellItem2> shellItem;
+	HRESULT hr = SHCreateItemFromIDList(pidl, IID_PPV_ARGS(&shellItem));
+
+	if (FAILED(hr))
+	{
+		// It's not expected for the SHCreateItemFromIDList() call to fail, so it would be useful to
+		// know if it does.
+		DCHECK(false);
+		return std::nullopt;
+	}
+
+	SFGAOF attributes = SFGAO_FOLDER | SFGAO_HIDDEN;
+	hr = shellItem->GetAttributes(attributes, &attributes);
+
+	if (FAILED(hr))
+	{
+		DCHECK(false);
+		return std::nullopt;
+	}
+
+	if (WI_IsFlagClear(attributes, SFGAO_FOLDER))
+	{
+		return std::nullopt;
+	}
+
+	wil::unique_cotaskmem_string displayName;
+	hr = shellItem->GetDisplayName(DISPLAY_NAME_TYPE, &displayName);
+
+	if (FAILED(hr))
+	{
+		DCHECK(false);
+		return std::nullopt;
+	}
+
+	NodeInfo nodeInfo;
+	nodeInfo.pidl = pidl;
+	nodeInfo.displayName = displayName.get();
+	nodeInfo.hidden = WI_IsFlagSet(attributes, SFGAO_HIDDEN);
+
+	if (retainShellItem)
+	{
+		nodeInfo.shellItem = std::move(shellItem);
+	}
+
+	return nodeInfo;
+}
+
+SortKey BuildSortKey(PCIDLIST_ABSOLUTE pidl)
+{
+	SortKey sortKey;
+	GetDisplayName(pidl, SHGDN_FORPARSING, sortKey.parsingName);
+	sortKey.isRoot = PathIsRoot(sortKey.parsingName.c_str());
+
+	TCHAR path[MAX_PATH];
+	sortKey.hasFileSystemPath = SHGetPathFromIDList(pidl, path);
+
+	sortKey.inFolderName = sortKey.parsingName;
+	GetDisplayName(pidl, SHGDN_INFOLDER, sortKey.inFolderName);
+
+	return sortKey;
+}
+
+int CompareSortKeys(const SortKey &sortKey1, const SortKey &sortKey2, bool useNaturalSortOrder)
+{
+	if (sortKey1.isRoot && !sortKey2.isRoot)
+	{
+		return -1;
+	}
+	else if (!sortKey1.isRoot && sortKey2.isRoot)
+	{
+		return 1;
+	}
+	else if (sortKey1.isRoot && sortKey2.isRoot)
+	{
+		return lstrcmpi(sortKey1.parsingName.c_str(), sortKey2.parsingName.c_str());
+	}
+	else if (!sortKey1.hasFileSystemPath && sortKey2.hasFileSystemPath)
+	{
+		return -1;
+	}
+	else if (sortKey1.hasFileSystemPath && !sortKey2.hasFileSystemPath)
+	{
+		return 1;
+	}
+	else if (useNaturalSortOrder)
+	{
+		return StrCmpLogicalW(sortKey1.inFolderName.c_str(), sortKey2.inFolderName.c_str());
+	}
+	else
+	{
+		return StrCmpIW(sortKey1.inFolderName.c_str(), sortKey2.inFolderName.c_str());
+	}
+}
+
+size_t GetNumChildrenToInsertInitially(size_t numChildren, size_t numVisibleItems)
+{
+	if (numChildren <= INCREMENTAL_INSERTION_THRESHOLD)
+	{
+		return numChildren;
+	}
+
+	// Note that the visible count is the number of items that can fit in the client area, so it's
+	// an upper bound on the number of children that can be visible once the parent is expanded.
+	return std::min(numChildren, numVisibleItems + 1);
+}
+
+}
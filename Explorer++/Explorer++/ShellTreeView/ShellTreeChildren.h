@@ -0,0 +1,105 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/PidlHelper.h"
+#include <wil/com.h>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Enumerates and sorts the children of a folder shown in the treeview. None of the functions here
+// interact with the treeview, so the enumeration can be performed on a background thread.
+namespace ShellTreeChildren
+{
+
+inline constexpr SIGDN DISPLAY_NAME_TYPE = SIGDN_NORMALDISPLAY;
+
+// When a folder has more children than this, only the children that are initially visible will be
+// inserted when the folder is expanded. The remaining children will then be inserted in batches.
+inline constexpr size_t INCREMENTAL_INSERTION_THRESHOLD = 2'000;
+inline constexpr size_t INCREMENTAL_INSERTION_BATCH_SIZE = 1'000;
+
+// The details needed to insert a node into the treeview.
+struct NodeInfo
+{
+	PidlAbsolute pidl;
+	std::wstring displayName;
+	bool hidden = false;
+
+	// The shell item used to retrieve the details above. This is only set if the details were
+	// retrieved with retainShellItem set, since shell items are apartment-bound and can't be used
+	// on a different thread to the one that created them.
+	wil::com_ptr_nothrow<IShellItem2> shellItem;
+};
+
+// The values that CompareSortKeys() uses to order two items. Retrieving these values requires a
+// number of calls into the shell, so when sorting a complete set of children, the values are
+// retrieved once per item, rather than once per comparison.
+struct SortKey
+{
+	bool isRoot = false;
+	bool hasFileSystemPath = false;
+	std::wstring parsingName;
+	std::wstring inFolderName;
+};
+
+struct ChildNodeInfo
+{
+	NodeInfo nodeInfo;
+	SortKey sortKey;
+};
+
+// A snapshot of the settings that affect which children are shown when a folder is expanded, and
+// the order they're shown in.
+struct EnumerationOptions
+{
+	bool showHidden = true;
+	bool checkPinnedToNamespaceTree = false;
+	bool hideSystemFiles = false;
+	bool useNaturalSortOrder = true;
+
+	// This should only be set when the children will be inserted on the same thread that
+	// enumerates them. In that case, the shell item created for each child can be reused when the
+	// child is inserted.
+	bool retainShellItems = false;
+};
+
+// The children of an expanded folder that are still waiting to be inserted into the treeview.
+class PendingInsertion
+{
+public:
+	PendingInsertion(std::vector<ChildNodeInfo> children, size_t numInserted);
+
+	// Returns the next INCREMENTAL_INSERTION_BATCH_SIZE children (or fewer, if there aren't that
+	// many left).
+	std::span<const ChildNodeInfo> TakeNextBatch();
+
+	std::span<const ChildNodeInfo> TakeRemaining();
+	bool IsComplete() const;
+
+private:
+	std::vector<ChildNodeInfo> m_children;
+	size_t m_nextIndex;
+};
+
+// Returns the child folders of the specified directory, in sorted order.
+HRESULT EnumerateChildNodes(PCIDLIST_ABSOLUTE pidlDirectory, const EnumerationOptions &options,
+	std::vector<ChildNodeInfo> &outputChildren);
+
+// Returns the details for the item, or std::nullopt if the item isn't a folder (or its details
+// can't be retrieved).
+std::optional<NodeInfo> GetNodeInfo(PCIDLIST_ABSOLUTE pidl, bool retainShellItem);
+
+SortKey BuildSortKey(PCIDLIST_ABSOLUTE pidl);
+int CompareSortKeys(const SortKey &sortKey1, const SortKey &sortKey2, bool useNaturalSortOrder);
+
+// Returns the number of children that should be inserted as soon as the parent is expanded, given
+// the number of items that can fit in the treeview. Any other children will be inserted in
+// batches.
+size_t GetNumChildrenToInsertInitially(size_t numChildren, size_t numVisibleItems);
+
+}
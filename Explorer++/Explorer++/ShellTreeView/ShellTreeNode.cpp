@@ -17,6 +17,28 @@ ShellTreeNode::ShellTreeNode(ShellTreeNodeType type, PCIDLIST_ABSOLUTE pidl,
 
 ShellTreeNode::~ShellTreeNode() = default;
 
+void *ShellTreeNode::operator new(size_t size)
+{
+	CHECK_EQ(size, sizeof(ShellTreeNode));
+	return GetMutablePool().Allocate();
+}
+
+void ShellTreeNode::operator delete(void *node)
+{
+	GetMutablePool().Deallocate(node);
+}
+
+const ShellTreeNode::Pool &ShellTreeNode::GetPool()
+{
+	return GetMutablePool();
+}
+
+ShellTreeNode::Pool &ShellTreeNode::GetMutablePool()
+{
+	static Pool pool;
+	return pool;
+}
+
 int ShellTreeNode::GetId() const
 {
 	return m_id;
@@ -176,6 +198,13 @@ std::unique_ptr<ShellTreeNode> ShellTreeNode::RemoveChild(ShellTreeNode *child)
 	return erasedNode;
 }
 
+// Allows space for the specified number of children to be allocated up front, when the number of
+// children that are going to be added is known in advance.
+void ShellTreeNode::ReserveChildren(size_t numChildren)
+{
+	m_children.reserve(numChildren);
+}
+
 void ShellTreeNode::RemoveAllChildren()
 {
 	m_children.clear();
@@ -21,17 +21,21 @@
 #include "BrowserWindow.h"
 #include "Config.h"
 #include "DialogHelper.h"
+#include "FeatureList.h"
 #include "FileOperations.h"
 #include "LabelEditHandler.h"
 #include "MainResource.h"
 #include "OpenItemsContextMenuDelegate.h"
 #include "ResourceLoader.h"
+#include "Runtime.h"
+#include "RuntimeHelper.h"
 #include "ShellBrowser/NavigateParams.h"
 #include "ShellBrowser/ShellBrowserImpl.h"
 #include "ShellBrowser/ShellNavigationController.h"
 #include "ShellTreeNode.h"
 #include "ShellTreeViewContextMenuDelegate.h"
 #include "TabContainer.h"
+#include "../Helper/AutoReset.h"
 #include "../Helper/CachedIcons.h"
 #include "../Helper/Controls.h"
 #include "../Helper/DragDropHelper.h"
@@ -43,7 +47,8 @@
 #include "../Helper/ShellHelper.h"
 #include "../Helper/ShellItemContextMenu.h"
 #include <wil/common.h>
-#include <propkey.h>
+#include <algorithm>
+#include <map>
 
 ShellTreeView *ShellTreeView::Create(HWND hParent, App *app, BrowserWindow *browser,
 	FileActionHandler *fileActionHandler)
@@ -61,11 +66,9 @@ ShellTreeView::ShellTreeView(HWND hParent, App *app, BrowserWindow *browser,
 	m_fileActionHandler(fileActionHandler),
 	m_commandTarget(browser->GetCommandTargetManager(), this),
 	m_fontSetter(GetHWND(), app->GetConfig()),
-	m_iconThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
+	m_taskScheduler(app->GetTaskScheduler()),
+	m_taskGroup(m_taskScheduler->CreateGroup()),
 	m_iconResultIDCounter(0),
-	m_subfoldersThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
-		CoUninitialize),
 	m_subfoldersResultIDCounter(0),
 	m_cachedIcons(app->GetCachedIcons()),
 	m_dropExpandItem(nullptr)
@@ -147,7 +150,7 @@ ShellTreeView::~ShellTreeView()
 		clipboardStore->FlushDataObject();
 	}
 
-	m_iconThreadPool.clear_queue();
+	m_taskScheduler->CancelGroup(m_taskGroup);
 }
 
 LRESULT ShellTreeView::TreeViewProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
@@ -231,7 +234,10 @@ LRESULT ShellTreeView::ParentWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM
 				break;
 
 			case TVN_ITEMEXPANDING:
-				OnItemExpanding(reinterpret_cast<NMTREEVIEW *>(lParam));
+				if (OnItemExpanding(reinterpret_cast<NMTREEVIEW *>(lParam)))
+				{
+					return TRUE;
+				}
 				break;
 
 			case TVN_KEYDOWN:
@@ -323,7 +329,7 @@ HTREEITEM ShellTreeView::AddRootItem(PCIDLIST_ABSOLUTE pidl, HTREEITEM insertAft
 {
 	auto rootItem = AddItem(nullptr, pidl, insertAfter);
 	assert(rootItem);
-	SendMessage(m_hTreeView, TVM_EXPAND, TVE_EXPAND, reinterpret_cast<LPARAM>(rootItem));
+	ExpandItemSynchronously(rootItem);
 
 	return rootItem;
 }
@@ -392,23 +398,8 @@ std::optional<int> ShellTreeView::GetCachedIconIndex(const ShellTreeNode *node)
 
 void ShellTreeView::QueueIconTask(HTREEITEM treeItem)
 {
-	ShellTreeNode *node = GetNodeFromTreeViewItem(treeItem);
-
-	BasicItemInfo basicItemInfo;
-	basicItemInfo.pidl = node->GetFullPidl();
-
-	int iconResultID = m_iconResultIDCounter++;
-
-	auto result = m_iconThreadPool.push(
-		[this, iconResultID, nodeId = node->GetId(), treeItem, basicItemInfo](int id)
-		{
-			UNREFERENCED_PARAMETER(id);
-
-			return FindIconAsync(m_hTreeView, iconResultID, nodeId, treeItem,
-				basicItemInfo.pidl.get());
-		});
-
-	m_iconResults.insert({ iconResultID, std::move(result) });
+	m_queuedIconItems.push_back(MakeQueuedItem(treeItem));
+	ScheduleQueuedTasks();
 }
 
 std::optional<ShellTreeView::IconResult> ShellTreeView::FindIconAsync(HWND treeView,
@@ -485,50 +476,91 @@ void ShellTreeView::ProcessIconResult(int iconResultId)
 
 void ShellTreeView::QueueSubfoldersTask(HTREEITEM item)
 {
-	BasicItemInfo basicItemInfo;
-	basicItemInfo.pidl = GetNodePidl(item);
+	m_queuedSubfoldersItems.push_back(MakeQueuedItem(item));
+	ScheduleQueuedTasks();
+}
+
+// Groups the items by parent, so that each background task can check the subfolders of multiple
+// items, while only binding to the parent folder once.
+void ShellTreeView::SubmitSubfoldersTasks(std::span<const QueuedItem> queuedItems,
+	TaskScheduler::Priority priority)
+{
+	std::vector<std::vector<QueuedItem>> batches;
+	std::map<std::optional<int>, size_t> openBatchIndexes;
 
-	int subfoldersResultID = m_subfoldersResultIDCounter++;
+	for (const auto &queuedItem : queuedItems)
+	{
+		auto itr = openBatchIndexes.find(queuedItem.parentNodeId);
 
-	auto result = m_subfoldersThreadPool.push(
-		[this, subfoldersResultID, item, basicItemInfo](int id)
+		if (itr == openBatchIndexes.end() || batches[itr->second].size() >= SUBFOLDERS_BATCH_SIZE)
 		{
-			UNREFERENCED_PARAMETER(id);
+			batches.emplace_back();
+			std::tie(itr, std::ignore) =
+				openBatchIndexes.insert_or_assign(queuedItem.parentNodeId, batches.size() - 1);
+		}
 
-			return CheckSubfoldersAsync(m_hTreeView, subfoldersResultID, item,
-				basicItemInfo.pidl.get());
-		});
+		batches[itr->second].push_back(queuedItem);
+	}
 
-	m_subfoldersResults.insert({ subfoldersResultID, std::move(result) });
+	for (auto &batch : batches)
+	{
+		int subfoldersResultID = m_subfoldersResultIDCounter++;
+		auto parentNodeId = batch[0].parentNodeId;
+
+		auto result = m_taskScheduler->Push(m_taskGroup, priority,
+			[treeView = m_hTreeView, subfoldersResultID, parentNodeId, batch = std::move(batch)]
+			{
+				return CheckSubfoldersAsync(treeView, subfoldersResultID, parentNodeId, batch);
+			});
+
+		m_subfoldersResults.insert({ subfoldersResultID, std::move(result) });
+	}
 }
 
-std::optional<ShellTreeView::SubfoldersResult> ShellTreeView::CheckSubfoldersAsync(HWND treeView,
-	int subfoldersResultId, HTREEITEM item, PCIDLIST_ABSOLUTE pidl)
+ShellTreeView::SubfoldersBatchResult ShellTreeView::CheckSubfoldersAsync(HWND treeView,
+	int subfoldersResultId, std::optional<int> parentNodeId,
+	const std::vector<QueuedItem> &queuedItems)
 {
-	wil::com_ptr_nothrow<IShellFolder> pShellFolder;
-	PCITEMID_CHILD pidlRelative;
-	HRESULT hr = SHBindToParent(pidl, IID_PPV_ARGS(&pShellFolder), &pidlRelative);
+	SubfoldersBatchResult batchResult;
+	batchResult.parentNodeId = parentNodeId;
 
-	if (FAILED(hr))
+	wil::com_ptr_nothrow<IShellFolder> parentFolder;
+
+	for (const auto &queuedItem : queuedItems)
 	{
-		return std::nullopt;
-	}
+		PCITEMID_CHILD pidlRelative;
 
-	ULONG attributes = SFGAO_HASSUBFOLDER;
-	hr = pShellFolder->GetAttributesOf(1, &pidlRelative, &attributes);
+		// Root items don't necessarily share a parent, so each one has to be bound to separately.
+		if (!parentNodeId || !parentFolder)
+		{
+			HRESULT hr = SHBindToParent(queuedItem.pidl.Raw(), IID_PPV_ARGS(&parentFolder),
+				&pidlRelative);
 
-	if (FAILED(hr))
-	{
-		return std::nullopt;
+			if (FAILED(hr))
+			{
+				continue;
+			}
+		}
+		else
+		{
+			pidlRelative = ILFindLastID(queuedItem.pidl.Raw());
+		}
+
+		ULONG attributes = SFGAO_HASSUBFOLDER;
+		HRESULT hr = parentFolder->GetAttributesOf(1, &pidlRelative, &attributes);
+
+		if (FAILED(hr))
+		{
+			continue;
+		}
+
+		batchResult.results.push_back({ queuedItem.nodeId, queuedItem.item,
+			WI_IsFlagSet(attributes, SFGAO_HASSUBFOLDER) });
 	}
 
 	PostMessage(treeView, WM_APP_SUBFOLDERS_RESULT_READY, subfoldersResultId, 0);
 
-	SubfoldersResult result;
-	result.item = item;
-	result.hasSubfolder = WI_IsFlagSet(attributes, SFGAO_HASSUBFOLDER);
-
-	return result;
+	return batchResult;
 }
 
 void ShellTreeView::ProcessSubfoldersResult(int subfoldersResultId)
@@ -542,25 +574,116 @@ void ShellTreeView::ProcessSubfoldersResult(int subfoldersResultId)
 
 	auto cleanup = wil::scope_exit([this, itr]() { m_subfoldersResults.erase(itr); });
 
-	auto result = itr->second.get();
+	auto batchResult = itr->second.get();
 
-	if (!result)
+	for (const auto &result : batchResult.results)
 	{
-		return;
+		// By default it's assumed that an item has subfolders, so if it does
+		// actually have subfolders, there's nothing else that needs to be done. Items may also have
+		// been removed while the check was in progress (e.g. if the parent was collapsed), in
+		// which case their HTREEITEM values will no longer be valid.
+		if (result.hasSubfolder || !GetNodeById(result.nodeId))
+		{
+			continue;
+		}
+
+		TVITEM tvItem;
+		tvItem.mask = TVIF_HANDLE | TVIF_CHILDREN;
+		tvItem.hItem = result.item;
+		tvItem.cChildren = 0;
+		TreeView_SetItem(m_hTreeView, &tvItem);
 	}
+}
+
+ShellTreeView::QueuedItem ShellTreeView::MakeQueuedItem(HTREEITEM item) const
+{
+	auto *node = GetNodeFromTreeViewItem(item);
+	auto *parentNode = node->GetParent();
 
-	if (result->hasSubfolder)
+	QueuedItem queuedItem;
+	queuedItem.nodeId = node->GetId();
+	queuedItem.parentNodeId = parentNode ? std::optional(parentNode->GetId()) : std::nullopt;
+	queuedItem.item = item;
+	queuedItem.pidl = node->GetFullPidl().get();
+	return queuedItem;
+}
+
+// Items are queued as the treeview requests their details, which typically happens while the
+// treeview is being painted. Submitting the queued items once that's finished means that all the
+// items requested during a paint can be ordered and grouped together.
+void ShellTreeView::ScheduleQueuedTasks()
+{
+	if (m_queuedTasksSubmissionScheduled)
 	{
-		// By default it's assumed that an item has subfolders, so if it does
-		// actually have subfolders, there's nothing else that needs to be done.
 		return;
 	}
 
-	TVITEM tvItem;
-	tvItem.mask = TVIF_HANDLE | TVIF_CHILDREN;
-	tvItem.hItem = result->item;
-	tvItem.cChildren = 0;
-	TreeView_SetItem(m_hTreeView, &tvItem);
+	m_queuedTasksSubmissionScheduled = true;
+
+	m_app->GetRuntime()->GetUiThreadExecutor()->post(
+		[weakSelf = m_weakPtrFactory.GetWeakPtr()]
+		{
+			if (weakSelf)
+			{
+				weakSelf->SubmitQueuedTasks();
+			}
+		});
+}
+
+void ShellTreeView::SubmitQueuedTasks()
+{
+	m_queuedTasksSubmissionScheduled = false;
+
+	auto iconItems = std::exchange(m_queuedIconItems, {});
+	auto subfoldersItems = std::exchange(m_queuedSubfoldersItems, {});
+
+	auto isRemoved = [this](const QueuedItem &queuedItem)
+	{ return GetNodeById(queuedItem.nodeId) == nullptr; };
+
+	std::erase_if(iconItems, isRemoved);
+	std::erase_if(subfoldersItems, isRemoved);
+
+	auto isInView = [this](const QueuedItem &queuedItem) { return IsItemInView(queuedItem.item); };
+
+	// Items that are in view are given a higher priority, so that they'll be updated first.
+	for (const auto &queuedItem : iconItems)
+	{
+		int iconResultID = m_iconResultIDCounter++;
+		auto priority = isInView(queuedItem) ? TaskScheduler::Priority::Visible
+											 : TaskScheduler::Priority::Background;
+
+		auto result = m_taskScheduler->Push(m_taskGroup, priority,
+			[treeView = m_hTreeView, iconResultID, queuedItem]
+			{
+				return FindIconAsync(treeView, iconResultID, queuedItem.nodeId, queuedItem.item,
+					queuedItem.pidl.Raw());
+			});
+
+		m_iconResults.insert({ iconResultID, std::move(result) });
+	}
+
+	auto outOfViewItems = std::ranges::stable_partition(subfoldersItems, isInView);
+	SubmitSubfoldersTasks({ subfoldersItems.begin(), outOfViewItems.begin() },
+		TaskScheduler::Priority::Visible);
+	SubmitSubfoldersTasks(outOfViewItems, TaskScheduler::Priority::Background);
+}
+
+bool ShellTreeView::IsItemInView(HTREEITEM item) const
+{
+	RECT itemRect;
+	BOOL res = TreeView_GetItemRect(m_hTreeView, item, &itemRect, FALSE);
+
+	// This will fail if the item isn't visible (i.e. one of its ancestors is collapsed).
+	if (!res)
+	{
+		return false;
+	}
+
+	RECT clientRect;
+	GetClientRect(m_hTreeView, &clientRect);
+
+	RECT intersection;
+	return IntersectRect(&intersection, &itemRect, &clientRect);
 }
 
 void ShellTreeView::OnSelectionChanged(const NMTREEVIEW *eventInfo)
@@ -595,6 +718,11 @@ void ShellTreeView::OnSelectionChanged(const NMTREEVIEW *eventInfo)
 			m_app->GetRuntime()->GetUiThreadExecutor(),
 			std::bind_front(&ShellTreeView::OnSelectionChangedTimer, this));
 #pragma warning(pop)
+
+		// The navigation won't start until the timer fires, so the selected folder can be
+		// enumerated in the meantime.
+		auto pidlDirectory = GetNodePidl(eventInfo->itemNew.hItem);
+		GetSelectedShellBrowser()->PrefetchFolder(pidlDirectory.get());
 	}
 	else
 	{
@@ -632,13 +760,40 @@ void ShellTreeView::HandleSelectionChanged(const NMTREEVIEW *eventInfo)
 	}
 }
 
-void ShellTreeView::OnItemExpanding(const NMTREEVIEW *nmtv)
+// Returns true if the expansion should be prevented.
+bool ShellTreeView::OnItemExpanding(const NMTREEVIEW *nmtv)
 {
 	HTREEITEM parentItem = nmtv->itemNew.hItem;
 
 	if (nmtv->action == TVE_EXPAND)
 	{
-		ExpandDirectory(parentItem);
+		auto *parentNode = GetNodeFromTreeViewItem(parentItem);
+
+		// When the children are enumerated asynchronously, they're inserted before the item is
+		// expanded, so there's nothing else that needs to be done here.
+		if (!parentNode->GetChildren().empty())
+		{
+			return false;
+		}
+
+		if (m_expandSynchronously
+			|| !m_app->GetFeatureList()->IsEnabled(Feature::AsyncTreeViewExpansion))
+		{
+			ExpandDirectory(parentItem);
+			return false;
+		}
+
+		// The expansion is blocked until the children have been enumerated. At that point, the
+		// item will be expanded again.
+		auto [itr, inserted] = m_nodesBeingExpanded.insert(parentNode->GetId());
+
+		if (inserted)
+		{
+			ExpandDirectoryAsync(m_weakPtrFactory.GetWeakPtr(), parentItem, parentNode->GetId(),
+				parentNode->GetFullPidl().get(), GetEnumerationOptions(), m_app->GetRuntime());
+		}
+
+		return true;
 	}
 	else
 	{
@@ -663,11 +818,14 @@ void ShellTreeView::OnItemExpanding(const NMTREEVIEW *nmtv)
 
 		ShellTreeNode *parentNode = GetNodeFromTreeViewItem(parentItem);
 		StopDirectoryMonitoringForNodeAndChildren(parentNode);
-		parentNode->RemoveAllChildren();
+		RemoveChildNodes(parentNode);
+		m_pendingChildInsertions.erase(parentNode->GetId());
 
 		SendMessage(m_hTreeView, TVM_EXPAND, TVE_COLLAPSE | TVE_COLLAPSERESET,
 			reinterpret_cast<LPARAM>(parentItem));
 	}
+
+	return false;
 }
 
 LRESULT ShellTreeView::OnKeyDown(const NMTVKEYDOWN *keyDown)
@@ -743,176 +901,262 @@ int CALLBACK ShellTreeView::CompareItemsStub(LPARAM lParam1, LPARAM lParam2, LPA
 
 int CALLBACK ShellTreeView::CompareItems(LPARAM lParam1, LPARAM lParam2)
 {
-	TCHAR szTemp[MAX_PATH];
-
 	const ShellTreeNode *node1 = reinterpret_cast<ShellTreeNode *>(lParam1);
 	const ShellTreeNode *node2 = reinterpret_cast<ShellTreeNode *>(lParam2);
 
-	auto pidl1 = node1->GetFullPidl();
-	auto pidl2 = node2->GetFullPidl();
-
-	std::wstring displayName1;
-	GetDisplayName(pidl1.get(), SHGDN_FORPARSING, displayName1);
-
-	std::wstring displayName2;
-	GetDisplayName(pidl2.get(), SHGDN_FORPARSING, displayName2);
-
-	if (PathIsRoot(displayName1.c_str()) && !PathIsRoot(displayName2.c_str()))
-	{
-		return -1;
-	}
-	else if (!PathIsRoot(displayName1.c_str()) && PathIsRoot(displayName2.c_str()))
-	{
-		return 1;
-	}
-	else if (PathIsRoot(displayName1.c_str()) && PathIsRoot(displayName2.c_str()))
-	{
-		return lstrcmpi(displayName1.c_str(), displayName2.c_str());
-	}
-	else
-	{
-		if (!SHGetPathFromIDList(pidl1.get(), szTemp) && SHGetPathFromIDList(pidl2.get(), szTemp))
-		{
-			return -1;
-		}
-		else if (SHGetPathFromIDList(pidl1.get(), szTemp)
-			&& !SHGetPathFromIDList(pidl2.get(), szTemp))
-		{
-			return 1;
-		}
-		else
-		{
-			GetDisplayName(pidl1.get(), SHGDN_INFOLDER, displayName1);
-			GetDisplayName(pidl2.get(), SHGDN_INFOLDER, displayName2);
+	return ShellTreeChildren::CompareSortKeys(
+		ShellTreeChildren::BuildSortKey(node1->GetFullPidl().get()),
+		ShellTreeChildren::BuildSortKey(node2->GetFullPidl().get()),
+		m_config->globalFolderSettings.useNaturalSortOrder);
+}
 
-			if (m_config->globalFolderSettings.useNaturalSortOrder)
-			{
-				return StrCmpLogicalW(displayName1.c_str(), displayName2.c_str());
-			}
-			else
-			{
-				return StrCmpIW(displayName1.c_str(), displayName2.c_str());
-			}
-		}
-	}
+void ShellTreeView::ExpandItemSynchronously(HTREEITEM item)
+{
+	AutoReset autoReset(&m_expandSynchronously, true);
+	SendMessage(m_hTreeView, TVM_EXPAND, TVE_EXPAND, reinterpret_cast<LPARAM>(item));
 }
 
 HRESULT ShellTreeView::ExpandDirectory(HTREEITEM hParent)
 {
 	auto pidlDirectory = GetNodePidl(hParent);
 
-	wil::com_ptr_nothrow<IShellFolder2> shellFolder2;
-	HRESULT hr = SHBindToObject(nullptr, pidlDirectory.get(), nullptr, IID_PPV_ARGS(&shellFolder2));
+	// Since the children are inserted on this thread, the shell item created for each child
+	// during the enumeration can be reused when inserting the child.
+	auto options = GetEnumerationOptions();
+	options.retainShellItems = true;
+
+	std::vector<ChildNodeInfo> children;
+	HRESULT hr = ShellTreeChildren::EnumerateChildNodes(pidlDirectory.get(), options, children);
 
 	if (FAILED(hr))
 	{
+		RemoveExpandButton(hParent);
 		return hr;
 	}
 
-	SHCONTF enumFlags = SHCONTF_FOLDERS;
+	InsertChildNodes(hParent, std::move(children));
+
+	ShellTreeNode *parentNode = GetNodeFromTreeViewItem(hParent);
+	StartDirectoryMonitoringForNode(parentNode);
 
-	if (m_bShowHidden)
+	return hr;
+}
+
+concurrencpp::null_result ShellTreeView::ExpandDirectoryAsync(WeakPtr<ShellTreeView> weakSelf,
+	HTREEITEM parentItem, int parentNodeId, PidlAbsolute pidlDirectory,
+	EnumerationOptions options, Runtime *runtime)
+{
+	co_await ResumeOnComStaThread(runtime);
+
+	std::vector<ChildNodeInfo> children;
+	HRESULT hr = ShellTreeChildren::EnumerateChildNodes(pidlDirectory.Raw(), options, children);
+
+	co_await concurrencpp::resume_on(runtime->GetUiThreadExecutor());
+
+	if (!weakSelf)
 	{
-		enumFlags |= SHCONTF_INCLUDEHIDDEN | SHCONTF_INCLUDESUPERHIDDEN;
+		co_return;
 	}
 
-	wil::com_ptr_nothrow<IEnumIDList> pEnumIDList;
-	hr = shellFolder2->EnumObjects(nullptr, enumFlags, &pEnumIDList);
+	weakSelf->m_nodesBeingExpanded.erase(parentNodeId);
+
+	auto *parentNode = weakSelf->GetNodeById(parentNodeId);
 
-	if (FAILED(hr) || !pEnumIDList)
+	// The item may have been removed while the enumeration was in progress. It's also possible
+	// that the item was expanded synchronously in the meantime (e.g. as part of a navigation), in
+	// which case the children have already been added.
+	if (!parentNode || !parentNode->GetChildren().empty())
 	{
-		return hr;
+		co_return;
 	}
 
-	ScopedRedrawDisabler redrawDisabler(m_hTreeView);
+	// Since the expansion was blocked, there's nothing to show if the enumeration failed. Leaving
+	// the expand button in place would imply that the item can still be expanded.
+	if (FAILED(hr) || children.empty())
+	{
+		weakSelf->RemoveExpandButton(parentItem);
+		co_return;
+	}
 
-	std::vector<unique_pidl_absolute> items;
+	weakSelf->InsertChildNodes(parentItem, std::move(children));
+	weakSelf->StartDirectoryMonitoringForNode(parentNode);
 
-	unique_pidl_child pidlItem;
-	ULONG uFetched = 1;
+	TreeView_Expand(weakSelf->m_hTreeView, parentItem, TVE_EXPAND);
+}
 
-	while (pEnumIDList->Next(1, wil::out_param(pidlItem), &uFetched) == S_OK && (uFetched == 1))
+ShellTreeView::EnumerationOptions ShellTreeView::GetEnumerationOptions() const
+{
+	EnumerationOptions options;
+	options.showHidden = m_bShowHidden;
+	options.checkPinnedToNamespaceTree = m_config->checkPinnedToNamespaceTreeProperty;
+	options.hideSystemFiles = m_config->globalFolderSettings.hideSystemFiles;
+	options.useNaturalSortOrder = m_config->globalFolderSettings.useNaturalSortOrder;
+	return options;
+}
+
+void ShellTreeView::RemoveExpandButton(HTREEITEM item)
+{
+	TVITEM tvItem = {};
+	tvItem.mask = TVIF_HANDLE | TVIF_CHILDREN;
+	tvItem.hItem = item;
+	tvItem.cChildren = 0;
+	TreeView_SetItem(m_hTreeView, &tvItem);
+}
+
+// Inserts the children (which are expected to already be in sorted order) in a single batch. For
+// a folder with a large number of children, only the children that will initially be visible are
+// inserted here. The rest are inserted incrementally, so that the UI thread isn't blocked while
+// tens of thousands of items are added.
+void ShellTreeView::InsertChildNodes(HTREEITEM parent, std::vector<ChildNodeInfo> children)
+{
+	auto *parentNode = GetNodeFromTreeViewItem(parent);
+	size_t numToInsert = children.size();
+
+	if (m_app->GetFeatureList()->IsEnabled(Feature::AsyncTreeViewExpansion))
 	{
-		if (m_config->checkPinnedToNamespaceTreeProperty)
-		{
-			BOOL showItem = GetBooleanVariant(shellFolder2.get(), pidlItem.get(),
-				&PKEY_IsPinnedToNameSpaceTree, TRUE);
+		numToInsert = ShellTreeChildren::GetNumChildrenToInsertInitially(children.size(),
+			TreeView_GetVisibleCount(m_hTreeView));
+	}
 
-			if (!showItem)
-			{
-				continue;
-			}
-		}
+	parentNode->ReserveChildren(children.size());
+
+	{
+		ScopedRedrawDisabler redrawDisabler(m_hTreeView);
 
-		if (m_config->globalFolderSettings.hideSystemFiles)
+		for (size_t i = 0; i < numToInsert; i++)
 		{
-			PCITEMID_CHILD child = pidlItem.get();
-			SFGAOF attributes = SFGAO_SYSTEM;
-			hr = shellFolder2->GetAttributesOf(1, &child, &attributes);
+			InsertNode(parent, children[i].nodeInfo, TVI_LAST);
+		}
+	}
+
+	if (numToInsert == children.size())
+	{
+		return;
+	}
+
+	m_pendingChildInsertions.insert_or_assign(parentNode->GetId(),
+		PendingChildInsertion{ parent, { std::move(children), numToInsert } });
 
-			if (FAILED(hr) || (WI_IsFlagSet(attributes, SFGAO_SYSTEM)))
+	m_app->GetRuntime()->GetUiThreadExecutor()->post(
+		[weakSelf = m_weakPtrFactory.GetWeakPtr(), parentNodeId = parentNode->GetId()]
+		{
+			if (weakSelf)
 			{
-				continue;
+				weakSelf->InsertPendingChildNodes(parentNodeId);
 			}
-		}
+		});
+}
+
+void ShellTreeView::InsertPendingChildNodes(int parentNodeId)
+{
+	auto itr = m_pendingChildInsertions.find(parentNodeId);
 
-		items.emplace_back(ILCombine(pidlDirectory.get(), pidlItem.get()));
+	// The remaining children may have already been inserted, or the parent may have been
+	// collapsed.
+	if (itr == m_pendingChildInsertions.end())
+	{
+		return;
 	}
 
-	for (const auto &item : items)
+	if (!GetNodeById(parentNodeId))
 	{
-		AddItem(hParent, item.get());
+		m_pendingChildInsertions.erase(itr);
+		return;
 	}
 
-	SortChildren(hParent);
+	auto &pendingInsertion = itr->second;
 
-	ShellTreeNode *parentNode = GetNodeFromTreeViewItem(hParent);
-	StartDirectoryMonitoringForNode(parentNode);
+	{
+		ScopedRedrawDisabler redrawDisabler(m_hTreeView);
 
-	return hr;
+		for (const auto &child : pendingInsertion.children.TakeNextBatch())
+		{
+			InsertNode(pendingInsertion.parentItem, child.nodeInfo, TVI_LAST);
+		}
+	}
+
+	if (pendingInsertion.children.IsComplete())
+	{
+		m_pendingChildInsertions.erase(itr);
+		return;
+	}
+
+	m_app->GetRuntime()->GetUiThreadExecutor()->post(
+		[weakSelf = m_weakPtrFactory.GetWeakPtr(), parentNodeId]
+		{
+			if (weakSelf)
+			{
+				weakSelf->InsertPendingChildNodes(parentNodeId);
+			}
+		});
 }
 
-HTREEITEM ShellTreeView::AddItem(HTREEITEM parent, PCIDLIST_ABSOLUTE pidl, HTREEITEM insertAfter)
+// Immediately inserts any children of the item that are still waiting to be inserted. This should
+// be called before any operation that depends on the full set of children being present (e.g.
+// searching for a child, or re-sorting the children).
+void ShellTreeView::FinishPendingChildInsertions(HTREEITEM parent)
 {
-	wil::com_ptr_nothrow<IShellItem2> shellItem;
-	HRESULT hr = SHCreateItemFromIDList(pidl, IID_PPV_ARGS(&shellItem));
+	if (m_pendingChildInsertions.empty())
+	{
+		return;
+	}
 
-	if (FAILED(hr))
+	auto *parentNode = GetNodeFromTreeViewItem(parent);
+	auto itr = m_pendingChildInsertions.find(parentNode->GetId());
+
+	if (itr == m_pendingChildInsertions.end())
 	{
-		// It's not expected for the SHCreateItemFromIDList() call to fail, so it would be useful to
-		// know if it does.
-		DCHECK(false);
-		return nullptr;
+		return;
 	}
 
-	SFGAOF attributes = SFGAO_FOLDER;
-	hr = shellItem->GetAttributes(attributes, &attributes);
+	auto pendingInsertion = std::move(itr->second);
+	m_pendingChildInsertions.erase(itr);
 
-	if (FAILED(hr))
+	ScopedRedrawDisabler redrawDisabler(m_hTreeView);
+
+	for (const auto &child : pendingInsertion.children.TakeRemaining())
 	{
-		DCHECK(false);
-		return nullptr;
+		InsertNode(parent, child.nodeInfo, TVI_LAST);
 	}
+}
 
-	if (WI_IsFlagClear(attributes, SFGAO_FOLDER))
+HTREEITEM ShellTreeView::AddItem(HTREEITEM parent, PCIDLIST_ABSOLUTE pidl, HTREEITEM insertAfter)
+{
+	auto nodeInfo = ShellTreeChildren::GetNodeInfo(pidl, true);
+
+	if (!nodeInfo)
 	{
 		return nullptr;
 	}
 
-	ShellTreeNodeType nodeType = parent ? ShellTreeNodeType::Child : ShellTreeNodeType::Root;
-	auto node = std::make_unique<ShellTreeNode>(nodeType, pidl, shellItem.get());
+	return InsertNode(parent, *nodeInfo, insertAfter);
+}
 
-	wil::unique_cotaskmem_string displayName;
-	hr = node->GetShellItem()->GetDisplayName(DISPLAY_NAME_TYPE, &displayName);
+HTREEITEM ShellTreeView::InsertNode(HTREEITEM parent, const NodeInfo &nodeInfo,
+	HTREEITEM insertAfter)
+{
+	wil::com_ptr_nothrow<IShellItem2> shellItem = nodeInfo.shellItem;
 
-	if (FAILED(hr))
+	// Shell items are apartment-bound, so if the node details were retrieved on a background
+	// thread, the item needs to be created again here.
+	if (!shellItem)
 	{
-		DCHECK(false);
-		return nullptr;
+		HRESULT hr = SHCreateItemFromIDList(nodeInfo.pidl.Raw(), IID_PPV_ARGS(&shellItem));
+
+		if (FAILED(hr))
+		{
+			DCHECK(false);
+			return nullptr;
+		}
 	}
 
+	ShellTreeNodeType nodeType = parent ? ShellTreeNodeType::Child : ShellTreeNodeType::Root;
+	auto node = std::make_unique<ShellTreeNode>(nodeType, nodeInfo.pidl.Raw(), shellItem.get());
 	auto *rawNode = node.get();
 
+	auto [itr, didInsert] = m_nodesById.insert({ rawNode->GetId(), rawNode });
+	DCHECK(didInsert);
+
 	if (parent)
 	{
 		auto *parentNode = GetNodeFromTreeViewItem(parent);
@@ -926,13 +1170,13 @@ HTREEITEM ShellTreeView::AddItem(HTREEITEM parent, PCIDLIST_ABSOLUTE pidl, HTREE
 	TVITEMEX tvItem = {};
 	tvItem.mask =
 		TVIF_TEXT | TVIF_IMAGE | TVIF_SELECTEDIMAGE | TVIF_PARAM | TVIF_CHILDREN | TVIF_STATE;
-	tvItem.pszText = displayName.get();
+	tvItem.pszText = const_cast<LPWSTR>(nodeInfo.displayName.c_str());
 	tvItem.iImage = I_IMAGECALLBACK;
 	tvItem.iSelectedImage = I_IMAGECALLBACK;
 	tvItem.lParam = reinterpret_cast<LPARAM>(rawNode);
 	tvItem.cChildren = I_CHILDRENCALLBACK;
 	tvItem.stateMask = TVIS_CUT;
-	tvItem.state = TestItemAttributes(rawNode, SFGAO_HIDDEN) ? TVIS_CUT : 0;
+	tvItem.state = nodeInfo.hidden ? TVIS_CUT : 0;
 
 	TVINSERTSTRUCT tvInsertData = {};
 	tvInsertData.hInsertAfter = insertAfter;
@@ -985,37 +1229,36 @@ ShellTreeNode *ShellTreeView::GetNodeFromTreeViewItem(HTREEITEM item) const
 
 ShellTreeNode *ShellTreeView::GetNodeById(int id) const
 {
-	for (auto &rootNode : m_nodes)
-	{
-		auto *foundNode = GetNodeByIdRecursive(rootNode.get(), id);
+	auto itr = m_nodesById.find(id);
 
-		if (foundNode)
-		{
-			return foundNode;
-		}
+	if (itr == m_nodesById.end())
+	{
+		return nullptr;
 	}
 
-	return nullptr;
+	return itr->second;
 }
 
-ShellTreeNode *ShellTreeView::GetNodeByIdRecursive(ShellTreeNode *node, int id) const
+// This should be called before the node is destroyed, so that its ID (and the IDs of its children)
+// can no longer be used to look it up.
+void ShellTreeView::UnregisterNodeAndChildren(const ShellTreeNode *node)
 {
-	if (node->GetId() == id)
+	m_nodesById.erase(node->GetId());
+
+	for (const auto &child : node->GetChildren())
 	{
-		return node;
+		UnregisterNodeAndChildren(child.get());
 	}
+}
 
-	for (auto &childNode : node->GetChildren())
+void ShellTreeView::RemoveChildNodes(ShellTreeNode *parentNode)
+{
+	for (const auto &child : parentNode->GetChildren())
 	{
-		auto *foundNode = GetNodeByIdRecursive(childNode.get(), id);
-
-		if (foundNode)
-		{
-			return foundNode;
-		}
+		UnregisterNodeAndChildren(child.get());
 	}
 
-	return nullptr;
+	parentNode->RemoveAllChildren();
 }
 
 HTREEITEM ShellTreeView::LocateItem(PCIDLIST_ABSOLUTE pidlDirectory)
@@ -1064,6 +1307,8 @@ HTREEITEM ShellTreeView::LocateItemInternal(PCIDLIST_ABSOLUTE pidlDirectory,
 
 		if (ILIsParent(currentPidl.get(), pidlDirectory, FALSE))
 		{
+			FinishPendingChildInsertions(hItem);
+
 			if ((TreeView_GetChild(m_hTreeView, hItem)) == nullptr)
 			{
 				if (bOnlyLocateExistingItem)
@@ -1072,7 +1317,7 @@ HTREEITEM ShellTreeView::LocateItemInternal(PCIDLIST_ABSOLUTE pidlDirectory,
 				}
 				else
 				{
-					SendMessage(m_hTreeView, TVM_EXPAND, TVE_EXPAND, (LPARAM) hItem);
+					ExpandItemSynchronously(hItem);
 				}
 			}
 
@@ -8,24 +8,30 @@
 #include "DirectoryWatcher.h"
 #include "MainFontSetter.h"
 #include "ScopedBrowserCommandTarget.h"
+#include "ShellTreeChildren.h"
+#include "TaskScheduler.h"
 #include "../Helper/ClipboardHelper.h"
 #include "../Helper/DropHandler.h"
 #include "../Helper/FileOperations.h"
 #include "../Helper/ShellDropTargetWindow.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/SignalWrapper.h"
+#include "../Helper/WeakPtrFactory.h"
 #include "../Helper/WindowSubclass.h"
-#include "../ThirdParty/CTPL/cpl_stl.h"
 #include <boost/signals2.hpp>
 #include <concurrencpp/concurrencpp.h>
 #include <wil/com.h>
 #include <optional>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
 
 class App;
 class BrowserWindow;
 class CachedIcons;
 struct Config;
 class FileActionHandler;
+class Runtime;
 class ShellBrowserImpl;
 class ShellTreeNode;
 
@@ -58,18 +64,20 @@ private:
 	static const LONG DROP_SCROLL_MARGIN_X_96DPI = 10;
 	static const LONG DROP_SCROLL_MARGIN_Y_96DPI = 10;
 
-	static const SIGDN DISPLAY_NAME_TYPE = SIGDN_NORMALDISPLAY;
+	static const SIGDN DISPLAY_NAME_TYPE = ShellTreeChildren::DISPLAY_NAME_TYPE;
 
-	struct BasicItemInfo
-	{
-		BasicItemInfo() = default;
+	// The maximum number of items whose subfolders will be checked within a single background
+	// task. Each task binds to the parent folder once and reuses it for every item in the task.
+	static constexpr size_t SUBFOLDERS_BATCH_SIZE = 64;
 
-		BasicItemInfo(const BasicItemInfo &other)
-		{
-			pidl.reset(ILCloneFull(other.pidl.get()));
-		}
+	using NodeInfo = ShellTreeChildren::NodeInfo;
+	using ChildNodeInfo = ShellTreeChildren::ChildNodeInfo;
+	using EnumerationOptions = ShellTreeChildren::EnumerationOptions;
 
-		unique_pidl_absolute pidl;
+	struct PendingChildInsertion
+	{
+		HTREEITEM parentItem;
+		ShellTreeChildren::PendingInsertion children;
 	};
 
 	struct IconResult
@@ -80,12 +88,31 @@ private:
 		int overlayIndex;
 	};
 
+	// An item that's waiting for its icon to be retrieved, or its subfolders to be checked.
+	struct QueuedItem
+	{
+		int nodeId;
+
+		// Only set for child nodes. Items with the same parent can be processed together.
+		std::optional<int> parentNodeId;
+
+		HTREEITEM item;
+		PidlAbsolute pidl;
+	};
+
 	struct SubfoldersResult
 	{
+		int nodeId;
 		HTREEITEM item;
 		bool hasSubfolder;
 	};
 
+	struct SubfoldersBatchResult
+	{
+		std::optional<int> parentNodeId;
+		std::vector<SubfoldersResult> results;
+	};
+
 	// Maintains information about an item that was cut or copied within the treeview.
 	class CutCopiedItemManager
 	{
@@ -127,14 +154,24 @@ private:
 	void AddShellNamespaceRootItem();
 	HTREEITEM AddRootItem(PCIDLIST_ABSOLUTE pidl, HTREEITEM insertAfter = TVI_LAST);
 	void OnShowQuickAccessUpdated(bool newValue);
+	void ExpandItemSynchronously(HTREEITEM item);
 	HRESULT ExpandDirectory(HTREEITEM hParent);
+	static concurrencpp::null_result ExpandDirectoryAsync(WeakPtr<ShellTreeView> weakSelf,
+		HTREEITEM parentItem, int parentNodeId, PidlAbsolute pidlDirectory,
+		EnumerationOptions options, Runtime *runtime);
+	EnumerationOptions GetEnumerationOptions() const;
+	void RemoveExpandButton(HTREEITEM item);
+	void InsertChildNodes(HTREEITEM parent, std::vector<ChildNodeInfo> children);
+	void InsertPendingChildNodes(int parentNodeId);
+	void FinishPendingChildInsertions(HTREEITEM parent);
 	HTREEITEM AddItem(HTREEITEM parent, PCIDLIST_ABSOLUTE pidl, HTREEITEM insertAfter = TVI_LAST);
+	HTREEITEM InsertNode(HTREEITEM parent, const NodeInfo &nodeInfo, HTREEITEM insertAfter);
 	void SortChildren(HTREEITEM parent);
 	void OnGetDisplayInfo(NMTVDISPINFO *pnmtvdi);
 	void OnSelectionChanged(const NMTREEVIEW *eventInfo);
 	void OnSelectionChangedTimer();
 	void HandleSelectionChanged(const NMTREEVIEW *eventInfo);
-	void OnItemExpanding(const NMTREEVIEW *nmtv);
+	bool OnItemExpanding(const NMTREEVIEW *nmtv);
 	LRESULT OnKeyDown(const NMTVKEYDOWN *keyDown);
 	void OnMiddleButtonDown(const POINT *pt);
 	void OnMiddleButtonUp(const POINT *pt, UINT keysDown);
@@ -178,14 +215,22 @@ private:
 	std::optional<int> GetCachedIconIndex(const ShellTreeNode *node);
 
 	void QueueSubfoldersTask(HTREEITEM item);
-	static std::optional<SubfoldersResult> CheckSubfoldersAsync(HWND treeView,
-		int subfoldersResultId, HTREEITEM item, PCIDLIST_ABSOLUTE pidl);
+	void SubmitSubfoldersTasks(std::span<const QueuedItem> queuedItems,
+		TaskScheduler::Priority priority);
+	static SubfoldersBatchResult CheckSubfoldersAsync(HWND treeView, int subfoldersResultId,
+		std::optional<int> parentNodeId, const std::vector<QueuedItem> &queuedItems);
 	void ProcessSubfoldersResult(int subfoldersResultId);
 
+	QueuedItem MakeQueuedItem(HTREEITEM item) const;
+	void ScheduleQueuedTasks();
+	void SubmitQueuedTasks();
+	bool IsItemInView(HTREEITEM item) const;
+
 	ShellTreeNode *GetSelectedNode() const;
 	ShellTreeNode *GetNodeFromTreeViewItem(HTREEITEM item) const;
 	ShellTreeNode *GetNodeById(int id) const;
-	ShellTreeNode *GetNodeByIdRecursive(ShellTreeNode *node, int id) const;
+	void UnregisterNodeAndChildren(const ShellTreeNode *node);
+	void RemoveChildNodes(ShellTreeNode *parentNode);
 
 	// ShellDropTargetWindow
 	HTREEITEM GetDropTargetItem(const POINT &pt) override;
@@ -229,18 +274,31 @@ private:
 	// be set. Once the treeview font is set, the same font will be applied to the tooltip control.
 	MainFontSetter m_fontSetter;
 
-	ctpl::thread_pool m_iconThreadPool;
+	TaskScheduler *const m_taskScheduler;
+	const std::shared_ptr<TaskScheduler::Group> m_taskGroup;
+
 	std::unordered_map<int, std::future<std::optional<IconResult>>> m_iconResults;
 	int m_iconResultIDCounter;
 
-	ctpl::thread_pool m_subfoldersThreadPool;
-	std::unordered_map<int, std::future<std::optional<SubfoldersResult>>> m_subfoldersResults;
+	std::unordered_map<int, std::future<SubfoldersBatchResult>> m_subfoldersResults;
 	int m_subfoldersResultIDCounter;
 
+	// Icon and subfolder requests are queued, then submitted together, so that the items that are
+	// currently in view can be given a higher priority and items with the same parent can be
+	// grouped.
+	std::vector<QueuedItem> m_queuedIconItems;
+	std::vector<QueuedItem> m_queuedSubfoldersItems;
+	bool m_queuedTasksSubmissionScheduled = false;
+
 	// Contains information about each node stored in the tree. Only root nodes are stored directly
 	// in this vector; child nodes are stored underneath their parent node.
 	std::vector<std::unique_ptr<ShellTreeNode>> m_nodes;
 
+	// Allows a node to be looked up by its ID, without having to search the entire tree. Results
+	// from background tasks refer to nodes by ID, so this is also used to check whether a node
+	// still exists.
+	std::unordered_map<int, ShellTreeNode *> m_nodesById;
+
 	CachedIcons *m_cachedIcons;
 
 	int m_iFolderIcon;
@@ -255,4 +313,11 @@ private:
 	concurrencpp::timer m_dropExpandTimer;
 
 	CutCopiedItemManager m_cutCopiedItemManager;
+
+	// Expansion
+	bool m_expandSynchronously = false;
+	std::unordered_set<int> m_nodesBeingExpanded;
+	std::unordered_map<int, PendingChildInsertion> m_pendingChildInsertions;
+
+	WeakPtrFactory<ShellTreeView> m_weakPtrFactory{ this };
 };
@@ -5,6 +5,8 @@
 #include "stdafx.h"
 #include "StartupFoldersXmlStorage.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 
 namespace
 {
@@ -41,6 +43,23 @@ void SaveStartupFolder(IXMLDOMDocument *xmlDocument, IXMLDOMElement *startupFold
 		startupFolder);
 }
 
+std::optional<std::wstring> ReadStartupFolder(const XmlReader &reader)
+{
+	auto path = XMLSettings::MaybeGetString(reader, SETTING_STARTUP_FOLDER_PATH);
+
+	if (!path || path->empty())
+	{
+		return std::nullopt;
+	}
+
+	return path;
+}
+
+void WriteStartupFolder(XmlWriter &writer, const std::wstring &startupFolder)
+{
+	writer.WriteAttribute(SETTING_STARTUP_FOLDER_PATH, startupFolder);
+}
+
 }
 
 namespace StartupFoldersXmlStorage
@@ -59,4 +78,16 @@ void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *startupFoldersNode,
 		STARTUP_FOLDER_NODE_NAME, SaveStartupFolder);
 }
 
+std::optional<std::vector<std::wstring>> Load(XmlReader &reader)
+{
+	return XMLSettings::ReadItemList<std::wstring>(reader, STARTUP_FOLDER_NODE_NAME,
+		ReadStartupFolder);
+}
+
+void Save(XmlWriter &writer, const std::vector<std::wstring> &startupFolders)
+{
+	XMLSettings::SaveItemList<std::wstring>(writer, startupFolders, STARTUP_FOLDER_NODE_NAME,
+		WriteStartupFolder);
+}
+
 }
@@ -5,9 +5,13 @@
 #pragma once
 
 #include <msxml.h>
+#include <optional>
 #include <string>
 #include <vector>
 
+class XmlReader;
+class XmlWriter;
+
 namespace StartupFoldersXmlStorage
 {
 
@@ -15,4 +19,9 @@ std::vector<std::wstring> Load(IXMLDOMNode *startupFoldersNode);
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *startupFoldersNode,
 	const std::vector<std::wstring> &startupFolders);
 
+// The reader should be positioned on the startup folders start element. When this returns, the
+// reader will be positioned on the matching end element.
+std::optional<std::vector<std::wstring>> Load(XmlReader &reader);
+void Save(XmlWriter &writer, const std::vector<std::wstring> &startupFolders);
+
 }
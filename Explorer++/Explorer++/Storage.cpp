@@ -28,4 +28,11 @@ std::wstring GetConfigFilePath()
 	return configFilePath.c_str();
 }
 
+std::wstring GetConfigSnapshotFilePath()
+{
+	std::filesystem::path snapshotFilePath(GetConfigFilePath());
+	snapshotFilePath.replace_extension(CONFIG_SNAPSHOT_FILE_EXTENSION);
+	return snapshotFilePath.c_str();
+}
+
 }
@@ -26,6 +26,11 @@ inline const wchar_t CONFIG_FILE_ROOT_NODE_NAME[] = L"ExplorerPlusPlus";
 inline const wchar_t CONFIG_FILE_SETTINGS_NODE_NAME[] = L"Settings";
 inline const wchar_t CONFIG_FILE_ENV_VAR_NAME[] = L"EXPLORERPP_CONFIG";
 
+// The binary snapshot of the config file (see BinaryAppStorage) is stored next to the config file,
+// with this extension.
+inline const wchar_t CONFIG_SNAPSHOT_FILE_EXTENSION[] = L".snapshot";
+
 std::wstring GetConfigFilePath();
+std::wstring GetConfigSnapshotFilePath();
 
 }
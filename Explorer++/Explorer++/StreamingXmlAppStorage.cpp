@@ -0,0 +1,253 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "StreamingXmlAppStorage.h"
+#include "HistoryModel.h"
+#include "HistoryXmlStreamStorage.h"
+#include "WindowXmlStorage.h"
+#include "../Helper/AtomicFile.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
+#include <sstream>
+
+StreamingXmlAppStorage::StreamingXmlAppStorage(wil::com_ptr_nothrow<IXMLDOMDocument> xmlDocument,
+	wil::com_ptr_nothrow<IXMLDOMNode> rootNode, const std::wstring &configFilePath,
+	Storage::OperationType operationType,
+	std::optional<ConfigXmlStorage::StreamedSettings> settings,
+	std::optional<std::vector<WindowStorageData>> windows,
+	std::optional<BookmarkXmlStreamStorage::BookmarksData> bookmarksData,
+	std::optional<std::vector<PidlAbsolute>> historyItems) :
+	m_xmlDocument(xmlDocument),
+	m_xmlAppStorage(xmlDocument, rootNode, configFilePath, operationType),
+	m_configFilePath(configFilePath),
+	m_operationType(operationType),
+	m_settings(std::move(settings)),
+	m_windows(std::move(windows)),
+	m_bookmarksData(std::move(bookmarksData)),
+	m_historyItems(std::move(historyItems))
+{
+}
+
+void StreamingXmlAppStorage::LoadConfig(Config &config)
+{
+	if (!m_settings)
+	{
+		m_xmlAppStorage.LoadConfig(config);
+		return;
+	}
+
+	ConfigXmlStorage::Load(*m_settings, config);
+}
+
+std::vector<WindowStorageData> StreamingXmlAppStorage::LoadWindows()
+{
+	if (!m_windows)
+	{
+		return m_xmlAppStorage.LoadWindows();
+	}
+
+	return std::move(*m_windows);
+}
+
+void StreamingXmlAppStorage::LoadBookmarks(BookmarkTree *bookmarkTree)
+{
+	if (!m_bookmarksData)
+	{
+		m_xmlAppStorage.LoadBookmarks(bookmarkTree);
+		return;
+	}
+
+	BookmarkXmlStreamStorage::AddToTree(std::move(*m_bookmarksData), bookmarkTree);
+	m_bookmarksData.reset();
+}
+
+void StreamingXmlAppStorage::LoadColorRules(ColorRuleModel *model)
+{
+	m_xmlAppStorage.LoadColorRules(model);
+}
+
+void StreamingXmlAppStorage::LoadApplications(Applications::ApplicationModel *model)
+{
+	m_xmlAppStorage.LoadApplications(model);
+}
+
+void StreamingXmlAppStorage::LoadDialogStates()
+{
+	m_xmlAppStorage.LoadDialogStates();
+}
+
+void StreamingXmlAppStorage::LoadDefaultColumns(FolderColumns &defaultColumns)
+{
+	m_xmlAppStorage.LoadDefaultColumns(defaultColumns);
+}
+
+void StreamingXmlAppStorage::LoadFrequentLocations(FrequentLocationsModel *frequentLocationsModel)
+{
+	m_xmlAppStorage.LoadFrequentLocations(frequentLocationsModel);
+}
+
+void StreamingXmlAppStorage::LoadHistory(HistoryModel *historyModel)
+{
+	if (!m_historyItems)
+	{
+		return;
+	}
+
+	historyModel->SetHistoryItems(*m_historyItems);
+	m_historyItems.reset();
+}
+
+void StreamingXmlAppStorage::SaveConfig(const Config &config)
+{
+	std::ostringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		ConfigXmlStorage::Save(writer, config);
+	}
+
+	m_configXml = std::move(stream).str();
+}
+
+void StreamingXmlAppStorage::SaveWindows(const std::vector<WindowStorageData> &windows)
+{
+	std::ostringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		WindowXmlStorage::Save(writer, windows);
+	}
+
+	m_windowsXml = std::move(stream).str();
+}
+
+void StreamingXmlAppStorage::SaveBookmarks(const BookmarkTree *bookmarkTree)
+{
+	std::ostringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		BookmarkXmlStreamStorage::Save(writer, bookmarkTree);
+	}
+
+	m_bookmarksXml = std::move(stream).str();
+}
+
+void StreamingXmlAppStorage::SaveColorRules(const ColorRuleModel *model)
+{
+	m_xmlAppStorage.SaveColorRules(model);
+}
+
+void StreamingXmlAppStorage::SaveApplications(const Applications::ApplicationModel *model)
+{
+	m_xmlAppStorage.SaveApplications(model);
+}
+
+void StreamingXmlAppStorage::SaveDialogStates()
+{
+	m_xmlAppStorage.SaveDialogStates();
+}
+
+void StreamingXmlAppStorage::SaveDefaultColumns(const FolderColumns &defaultColumns)
+{
+	m_xmlAppStorage.SaveDefaultColumns(defaultColumns);
+}
+
+void StreamingXmlAppStorage::SaveFrequentLocations(
+	const FrequentLocationsModel *frequentLocationsModel)
+{
+	m_xmlAppStorage.SaveFrequentLocations(frequentLocationsModel);
+}
+
+void StreamingXmlAppStorage::SaveHistory(const HistoryModel *historyModel)
+{
+	std::ostringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		HistoryXmlStreamStorage::Save(writer, historyModel);
+	}
+
+	m_historyXml = std::move(stream).str();
+}
+
+void StreamingXmlAppStorage::Commit()
+{
+	if (m_operationType != Storage::OperationType::Save)
+	{
+		DCHECK(false);
+		return;
+	}
+
+	wil::unique_bstr xml;
+	HRESULT hr = m_xmlDocument->get_xml(&xml);
+
+	if (FAILED(hr))
+	{
+		DCHECK(false);
+		return;
+	}
+
+	// The MSXML document only contains the sections that aren't streamed. Those sections are copied
+	// over node-by-node (which also formats them). The settings and windows are inserted at the
+	// start of the root element (which is where XmlAppStorage saves them), with the bookmarks and
+	// history inserted at the end.
+	std::istringstream documentStream(wstrToUtf8Str(xml.get()));
+	XmlReader documentReader(documentStream);
+
+	std::ostringstream outputStream;
+
+	{
+		XmlWriter writer(outputStream);
+		writer.WriteDeclaration();
+		writer.WriteComment(L" Preference file for Explorer++ ");
+
+		while (documentReader.Read())
+		{
+			if (documentReader.GetNodeType() == XmlReader::NodeType::EndElement
+				&& documentReader.GetDepth() == 0)
+			{
+				WriteSection(writer, m_bookmarksXml);
+				WriteSection(writer, m_historyXml);
+			}
+
+			writer.WriteNode(documentReader);
+
+			if (documentReader.GetNodeType() == XmlReader::NodeType::StartElement
+				&& documentReader.GetDepth() == 0)
+			{
+				WriteSection(writer, m_configXml);
+				WriteSection(writer, m_windowsXml);
+			}
+		}
+	}
+
+	if (documentReader.HasError())
+	{
+		DCHECK(false);
+		return;
+	}
+
+	AtomicFile::Write(m_configFilePath, std::move(outputStream).str());
+}
+
+void StreamingXmlAppStorage::WriteSection(XmlWriter &writer, const std::string &sectionXml)
+{
+	if (sectionXml.empty())
+	{
+		return;
+	}
+
+	std::istringstream sectionStream(sectionXml);
+	XmlReader sectionReader(sectionStream);
+
+	while (sectionReader.Read())
+	{
+		writer.WriteNode(sectionReader);
+	}
+
+	DCHECK(!sectionReader.HasError());
+}
@@ -0,0 +1,86 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "AppStorage.h"
+#include "ConfigXmlStorage.h"
+#include "Storage.h"
+#include "WindowStorage.h"
+#include "XmlAppStorage.h"
+#include "Bookmarks/BookmarkXmlStreamStorage.h"
+#include "../Helper/PidlHelper.h"
+#include <wil/com.h>
+#include <MsXml2.h>
+#include <optional>
+#include <string>
+#include <vector>
+
+class XmlWriter;
+
+// An alternative to XmlAppStorage that reads and writes the config file using XmlReader/XmlWriter.
+// The settings, windows (including their tabs), bookmarks and history are handled directly by the
+// corresponding stream storage functions, without any DOM being built. The remaining sections
+// (color rules, applications, dialog states, default columns and frequent locations) are small and
+// are delegated to XmlAppStorage, using an MSXML document that contains only those sections.
+//
+// When saving, the file is replaced atomically, so an interrupted save can't leave behind a
+// truncated config file.
+class StreamingXmlAppStorage : public AppStorage
+{
+public:
+	StreamingXmlAppStorage(wil::com_ptr_nothrow<IXMLDOMDocument> xmlDocument,
+		wil::com_ptr_nothrow<IXMLDOMNode> rootNode, const std::wstring &configFilePath,
+		Storage::OperationType operationType,
+		std::optional<ConfigXmlStorage::StreamedSettings> settings,
+		std::optional<std::vector<WindowStorageData>> windows,
+		std::optional<BookmarkXmlStreamStorage::BookmarksData> bookmarksData,
+		std::optional<std::vector<PidlAbsolute>> historyItems);
+
+	void LoadConfig(Config &config) override;
+	[[nodiscard]] std::vector<WindowStorageData> LoadWindows() override;
+	void LoadBookmarks(BookmarkTree *bookmarkTree) override;
+	void LoadColorRules(ColorRuleModel *model) override;
+	void LoadApplications(Applications::ApplicationModel *model) override;
+	void LoadDialogStates() override;
+	void LoadDefaultColumns(FolderColumns &defaultColumns) override;
+	void LoadFrequentLocations(FrequentLocationsModel *frequentLocationsModel) override;
+	void LoadHistory(HistoryModel *historyModel) override;
+
+	void SaveConfig(const Config &config) override;
+	void SaveWindows(const std::vector<WindowStorageData> &windows) override;
+	void SaveBookmarks(const BookmarkTree *bookmarkTree) override;
+	void SaveColorRules(const ColorRuleModel *model) override;
+	void SaveApplications(const Applications::ApplicationModel *model) override;
+	void SaveDialogStates() override;
+	void SaveDefaultColumns(const FolderColumns &defaultColumns) override;
+	void SaveFrequentLocations(const FrequentLocationsModel *frequentLocationsModel) override;
+	void SaveHistory(const HistoryModel *historyModel) override;
+	void Commit() override;
+
+private:
+	static void WriteSection(XmlWriter &writer, const std::string &sectionXml);
+
+	const wil::com_ptr_nothrow<IXMLDOMDocument> m_xmlDocument;
+	XmlAppStorage m_xmlAppStorage;
+	const std::wstring m_configFilePath;
+	const Storage::OperationType m_operationType;
+
+	// The settings and windows read from the config file, if the file contained those sections.
+	std::optional<ConfigXmlStorage::StreamedSettings> m_settings;
+	std::optional<std::vector<WindowStorageData>> m_windows;
+
+	// The bookmarks read from the config file. If the file contained no v2 bookmarks, this will be
+	// empty and loading will fall back to XmlAppStorage (which also handles the v1 format).
+	std::optional<BookmarkXmlStreamStorage::BookmarksData> m_bookmarksData;
+
+	// The history items read from the config file, if the file contained a history section.
+	std::optional<std::vector<PidlAbsolute>> m_historyItems;
+
+	// The serialized sections, to be inserted into the file when it's committed.
+	std::string m_configXml;
+	std::string m_windowsXml;
+	std::string m_bookmarksXml;
+	std::string m_historyXml;
+};
@@ -182,21 +182,23 @@ private:
 TabContainer *TabContainer::Create(MainTabView *view, BrowserWindow *browser,
 	ShellBrowserFactory *shellBrowserFactory, TabEvents *tabEvents,
 	ShellBrowserEvents *shellBrowserEvents, NavigationEvents *navigationEvents,
-	TabRestorer *tabRestorer, CachedIcons *cachedIcons, BookmarkTree *bookmarkTree,
-	const AcceleratorManager *acceleratorManager, const Config *config,
-	const ResourceLoader *resourceLoader, PlatformContext *platformContext)
+	TabRestorer *tabRestorer, CachedIcons *cachedIcons, TaskScheduler *taskScheduler,
+	BookmarkTree *bookmarkTree, const AcceleratorManager *acceleratorManager,
+	const Config *config, const ResourceLoader *resourceLoader,
+	PlatformContext *platformContext)
 {
 	return new TabContainer(view, browser, shellBrowserFactory, tabEvents, shellBrowserEvents,
-		navigationEvents, tabRestorer, cachedIcons, bookmarkTree, acceleratorManager, config,
-		resourceLoader, platformContext);
+		navigationEvents, tabRestorer, cachedIcons, taskScheduler, bookmarkTree, acceleratorManager,
+		config, resourceLoader, platformContext);
 }
 
 TabContainer::TabContainer(MainTabView *view, BrowserWindow *browser,
 	ShellBrowserFactory *shellBrowserFactory, TabEvents *tabEvents,
 	ShellBrowserEvents *shellBrowserEvents, NavigationEvents *navigationEvents,
-	TabRestorer *tabRestorer, CachedIcons *cachedIcons, BookmarkTree *bookmarkTree,
-	const AcceleratorManager *acceleratorManager, const Config *config,
-	const ResourceLoader *resourceLoader, PlatformContext *platformContext) :
+	TabRestorer *tabRestorer, CachedIcons *cachedIcons, TaskScheduler *taskScheduler,
+	BookmarkTree *bookmarkTree, const AcceleratorManager *acceleratorManager,
+	const Config *config, const ResourceLoader *resourceLoader,
+	PlatformContext *platformContext) :
 	ShellDropTargetWindow(view->GetHWND()),
 	m_view(view),
 	m_browser(browser),
@@ -206,7 +208,7 @@ TabContainer::TabContainer(MainTabView *view, BrowserWindow *browser,
 	m_navigationEvents(navigationEvents),
 	m_tabRestorer(tabRestorer),
 	m_timerManager(m_hwnd),
-	m_iconFetcher(m_hwnd, cachedIcons),
+	m_iconFetcher(m_hwnd, cachedIcons, taskScheduler),
 	m_cachedIcons(cachedIcons),
 	m_bookmarkTree(bookmarkTree),
 	m_acceleratorManager(acceleratorManager),
@@ -226,6 +228,10 @@ void TabContainer::Initialize(HWND parent)
 
 	m_windowSubclasses.push_back(std::make_unique<WindowSubclass>(parent,
 		std::bind_front(&TabContainer::ParentWndProc, this)));
+
+	m_connections.push_back(m_navigationEvents->AddStartedObserver(
+		std::bind_front(&TabContainer::OnNavigationStarted, this),
+		NavigationEventScope::ForBrowser(*m_browser)));
 }
 
 void TabContainer::OnTabDoubleClicked(Tab *tab, const MouseEvent &event)
@@ -296,9 +302,25 @@ void TabContainer::OnTabSelected(const Tab &tab)
 
 	m_iPreviousTabSelectionId = tab.GetId();
 
+	LoadTab(tab);
+
 	m_tabEvents->NotifySelected(tab);
 }
 
+void TabContainer::OnNavigationStarted(const NavigationRequest *request)
+{
+	const auto *tab = request->GetShellBrowser()->GetTab();
+
+	if (!tab)
+	{
+		return;
+	}
+
+	// If a tab whose navigation was deferred is navigated some other way (e.g. by a plugin), the
+	// deferred navigation is no longer relevant.
+	m_deferredNavigations.erase(tab->GetId());
+}
+
 MainTabView *TabContainer::GetView()
 {
 	return m_view;
@@ -464,11 +486,46 @@ Tab &TabContainer::SetUpNewTab(Tab &tab, NavigateParams &navigateParams,
 		OnTabSelected(tab);
 	}
 
+	bool deferNavigation = false;
+
+	if (tabSettings.deferNavigation)
+	{
+		deferNavigation = *tabSettings.deferNavigation;
+	}
+
+	if (deferNavigation && !IsTabSelected(tab))
+	{
+		// The shell browser is already showing the folder, it just hasn't been enumerated. The
+		// navigation will be started once the tab is selected.
+		m_deferredNavigations.insert({ tab.GetId(), navigateParams });
+		return tab;
+	}
+
 	tab.GetShellBrowser()->GetNavigationController()->Navigate(navigateParams);
 
 	return tab;
 }
 
+bool TabContainer::IsTabLoaded(const Tab &tab) const
+{
+	return !m_deferredNavigations.contains(tab.GetId());
+}
+
+void TabContainer::LoadTab(const Tab &tab)
+{
+	auto itr = m_deferredNavigations.find(tab.GetId());
+
+	if (itr == m_deferredNavigations.end())
+	{
+		return;
+	}
+
+	auto navigateParams = std::move(itr->second);
+	m_deferredNavigations.erase(itr);
+
+	tab.GetShellBrowser()->GetNavigationController()->Navigate(navigateParams);
+}
+
 void TabContainer::CloseAllTabs()
 {
 	int numTabs = GetNumTabs();
@@ -505,6 +562,7 @@ bool TabContainer::CloseTab(const Tab &tab, CloseMode closeMode)
 	auto ownedTab = std::move(*itr);
 
 	m_tabs.erase(itr);
+	m_deferredNavigations.erase(tab.GetId());
 
 	m_tabEvents->NotifyRemoved(tab);
 
@@ -9,14 +9,17 @@
 #include "OneShotTimer.h"
 #include "OneShotTimerManager.h"
 #include "ShellBrowser/FolderSettings.h"
+#include "ShellBrowser/NavigateParams.h"
 #include "Tab.h"
 #include "TabView.h"
 #include "TabViewDelegate.h"
 #include "../Helper/ShellDropTargetWindow.h"
 #include "../Helper/WindowSubclass.h"
+#include <boost/signals2.hpp>
 #include <functional>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 class AcceleratorManager;
 class BookmarkTree;
@@ -24,7 +27,6 @@ class BrowserWindow;
 class CachedIcons;
 struct Config;
 class MainTabView;
-struct NavigateParams;
 class NavigationEvents;
 class NavigationRequest;
 class PlatformContext;
@@ -33,6 +35,7 @@ class ResourceLoader;
 class ShellBrowserEvents;
 class ShellBrowserFactory;
 class TabRestorer;
+class TaskScheduler;
 
 // Used when creating a tab.
 struct TabSettings
@@ -42,6 +45,12 @@ struct TabSettings
 	std::optional<int> index;
 	std::optional<bool> selected;
 
+	// If set, a tab that's created in the background won't be navigated until it's first selected,
+	// or until TabContainer::LoadTab() is called. Until then, the tab will show the name and icon
+	// of the folder it was created in. This avoids enumerating every folder up front when a large
+	// number of tabs are restored at once.
+	std::optional<bool> deferNavigation;
+
 	// This is only used in tests.
 	bool operator==(const TabSettings &) const = default;
 };
@@ -60,9 +69,10 @@ public:
 	static TabContainer *Create(MainTabView *view, BrowserWindow *browser,
 		ShellBrowserFactory *shellBrowserFactory, TabEvents *tabEvents,
 		ShellBrowserEvents *shellBrowserEvents, NavigationEvents *navigationEvents,
-		TabRestorer *tabRestorer, CachedIcons *cachedIcons, BookmarkTree *bookmarkTree,
-		const AcceleratorManager *acceleratorManager, const Config *config,
-		const ResourceLoader *resourceLoader, PlatformContext *platformContext);
+		TabRestorer *tabRestorer, CachedIcons *cachedIcons, TaskScheduler *taskScheduler,
+		BookmarkTree *bookmarkTree, const AcceleratorManager *acceleratorManager,
+		const Config *config, const ResourceLoader *resourceLoader,
+		PlatformContext *platformContext);
 
 	MainTabView *GetView();
 
@@ -89,6 +99,13 @@ public:
 	int MoveTab(const Tab &tab, int newIndex);
 	Tab &DuplicateTab(const Tab &tab);
 
+	// Returns false if the tab was created with deferred navigation and hasn't been navigated yet.
+	bool IsTabLoaded(const Tab &tab) const;
+
+	// Starts the deferred navigation for the tab, if there is one. Does nothing if the tab has
+	// already been loaded.
+	void LoadTab(const Tab &tab);
+
 	// Unlike CloseTab(), which will only close tabs that aren't locked, this will close all tabs,
 	// regardless of the lock state of any individual tab. This is needed when the parent window is
 	// being closed.
@@ -130,9 +147,10 @@ private:
 	TabContainer(MainTabView *view, BrowserWindow *browser,
 		ShellBrowserFactory *shellBrowserFactory, TabEvents *tabEvents,
 		ShellBrowserEvents *shellBrowserEvents, NavigationEvents *navigationEvents,
-		TabRestorer *tabRestorer, CachedIcons *cachedIcons, BookmarkTree *bookmarkTree,
-		const AcceleratorManager *acceleratorManager, const Config *config,
-		const ResourceLoader *resourceLoader, PlatformContext *platformContext);
+		TabRestorer *tabRestorer, CachedIcons *cachedIcons, TaskScheduler *taskScheduler,
+		BookmarkTree *bookmarkTree, const AcceleratorManager *acceleratorManager,
+		const Config *config, const ResourceLoader *resourceLoader,
+		PlatformContext *platformContext);
 
 	LRESULT ParentWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
@@ -147,6 +165,7 @@ private:
 	void ShowBackgroundContextMenu(const POINT &ptClient);
 
 	void OnTabSelected(const Tab &tab);
+	void OnNavigationStarted(const NavigationRequest *request);
 
 	bool CloseTab(const Tab &tab, CloseMode closeMode);
 	void RemoveTabFromControl(const Tab &tab);
@@ -180,6 +199,7 @@ private:
 	TabRestorer *const m_tabRestorer;
 	OneShotTimerManager m_timerManager;
 	std::unordered_map<int, std::unique_ptr<Tab>> m_tabs;
+	std::unordered_map<int, NavigateParams> m_deferredNavigations;
 	IconFetcherImpl m_iconFetcher;
 	CachedIcons *const m_cachedIcons;
 	BookmarkTree *const m_bookmarkTree;
@@ -188,6 +208,7 @@ private:
 	const ResourceLoader *const m_resourceLoader;
 	PlatformContext *const m_platformContext;
 	std::vector<std::unique_ptr<WindowSubclass>> m_windowSubclasses;
+	std::vector<boost::signals2::scoped_connection> m_connections;
 
 	std::vector<int> m_tabSelectionHistory;
 	int m_iPreviousTabSelectionId;
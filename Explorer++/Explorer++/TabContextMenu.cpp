@@ -129,7 +129,7 @@ void TabContextMenu::OnMenuItemSelected(UINT menuItemId)
 		break;
 
 	case IDM_TAB_CONTEXT_MENU_REFRESH:
-		m_tab->GetShellBrowser()->GetNavigationController()->Refresh();
+		m_tab->GetShellBrowser()->Refresh();
 		break;
 
 	case IDM_TAB_CONTEXT_MENU_REFRESH_ALL:
@@ -184,7 +184,7 @@ void TabContextMenu::OnRefreshAllTabs()
 {
 	for (auto &tab : m_tabContainer->GetAllTabs() | std::views::values)
 	{
-		tab->GetShellBrowser()->GetNavigationController()->Refresh();
+		tab->GetShellBrowser()->Refresh();
 	}
 }
 
@@ -7,6 +7,7 @@
 #include "App.h"
 #include "ColumnStorage.h"
 #include "Config.h"
+#include "FeatureList.h"
 #include "MainTabView.h"
 #include "ShellBrowser/NavigateParams.h"
 #include "ShellBrowser/ShellBrowserImpl.h"
@@ -26,8 +27,9 @@ void Explorerplusplus::InitializeTabs()
 	auto *tabContainer =
 		TabContainer::Create(mainTabView, this, &m_shellBrowserFactory, m_app->GetTabEvents(),
 			m_app->GetShellBrowserEvents(), m_app->GetNavigationEvents(), m_app->GetTabRestorer(),
-			m_app->GetCachedIcons(), m_app->GetBookmarkTree(), m_app->GetAcceleratorManager(),
-			m_config, m_app->GetResourceLoader(), m_app->GetPlatformContext());
+			m_app->GetCachedIcons(), m_app->GetTaskScheduler(), m_app->GetBookmarkTree(),
+			m_app->GetAcceleratorManager(), m_config, m_app->GetResourceLoader(),
+			m_app->GetPlatformContext());
 	m_browserPane = std::make_unique<BrowserPane>(tabContainer);
 
 	m_connections.push_back(m_config->alwaysShowTabBar.addObserver(
@@ -166,6 +168,11 @@ void Explorerplusplus::CreateTabsFromStorageData(const WindowStorageData &storag
 		auto tabSettings = loadedTab.tabSettings;
 		tabSettings.index = index;
 
+		if (m_app->GetFeatureList()->IsEnabled(Feature::DeferredTabLoading))
+		{
+			tabSettings.deferNavigation = true;
+		}
+
 		auto validatedColumns = loadedTab.columns;
 		ValidateColumns(validatedColumns);
 
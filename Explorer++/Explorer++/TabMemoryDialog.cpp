@@ -0,0 +1,344 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TabMemoryDialog.h"
+#include "Config.h"
+#include "MainResource.h"
+#include "ResourceLoader.h"
+#include "ShellBrowser/ShellBrowser.h"
+#include "Tab.h"
+#include "TabContainer.h"
+#include "TabList.h"
+#include "../Helper/ScopedRedrawDisabler.h"
+#include "../Helper/ShellHelper.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/WindowHelper.h"
+#include <fmt/format.h>
+#include <fmt/xchar.h>
+#include <glog/logging.h>
+
+TabMemoryDialog *TabMemoryDialog::Create(HWND parent, const TabList *tabList,
+	const Config *config, const ResourceLoader *resourceLoader)
+{
+	return new TabMemoryDialog(parent, tabList, config, resourceLoader);
+}
+
+TabMemoryDialog::TabMemoryDialog(HWND parent, const TabList *tabList, const Config *config,
+	const ResourceLoader *resourceLoader) :
+	BaseDialog(resourceLoader, IDD_TAB_MEMORY, parent, BaseDialog::DialogSizingType::Both),
+	m_tabList(tabList),
+	m_config(config),
+	m_persistentSettings(&TabMemoryDialogPersistentSettings::GetInstance())
+{
+}
+
+INT_PTR TabMemoryDialog::OnInitDialog()
+{
+	SetupListView();
+
+	m_persistentSettings->RestoreDialogPosition(m_hDlg, true);
+
+	return TRUE;
+}
+
+wil::unique_hicon TabMemoryDialog::GetDialogIcon(int iconWidth, int iconHeight) const
+{
+	UNREFERENCED_PARAMETER(iconWidth);
+	UNREFERENCED_PARAMETER(iconHeight);
+
+	return wil::unique_hicon(LoadIcon(GetModuleHandle(nullptr), MAKEINTRESOURCE(IDI_MAIN)));
+}
+
+std::vector<ResizableDialogControl> TabMemoryDialog::GetResizableControls()
+{
+	std::vector<ResizableDialogControl> controls;
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_TAB_MEMORY_TAB_LIST), MovingType::None,
+		SizingType::Both);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_TAB_MEMORY_SUMMARY), MovingType::Vertical,
+		SizingType::Horizontal);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDC_TAB_MEMORY_REFRESH), MovingType::Both,
+		SizingType::None);
+	controls.emplace_back(GetDlgItem(m_hDlg, IDCANCEL), MovingType::Both, SizingType::None);
+	return controls;
+}
+
+void TabMemoryDialog::SetupListView()
+{
+	HWND listView = GetDlgItem(m_hDlg, IDC_TAB_MEMORY_TAB_LIST);
+	ListView_SetExtendedListViewStyle(listView,
+		LVS_EX_LABELTIP | LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
+
+	InsertColumns();
+	RefreshTabList();
+}
+
+void TabMemoryDialog::InsertColumns()
+{
+	int index = 0;
+
+	for (auto column : COLUMNS)
+	{
+		InsertColumn(column, index);
+		index++;
+	}
+}
+
+void TabMemoryDialog::InsertColumn(const Column &column, int index)
+{
+	std::wstring columnText = GetColumnText(column.type);
+
+	RECT listViewRect;
+	HWND listView = GetDlgItem(m_hDlg, IDC_TAB_MEMORY_TAB_LIST);
+	auto res = GetClientRect(listView, &listViewRect);
+	CHECK(res);
+
+	LVCOLUMN lvColumn = {};
+	lvColumn.mask = LVCF_TEXT | LVCF_WIDTH;
+	lvColumn.pszText = columnText.data();
+	lvColumn.cx = static_cast<int>(column.percentageWidth * GetRectWidth(&listViewRect));
+	int insertedIndex = ListView_InsertColumn(listView, index, &lvColumn);
+	CHECK(insertedIndex == index);
+}
+
+std::wstring TabMemoryDialog::GetColumnText(ColumnType columnType)
+{
+	UINT stringId;
+
+	switch (columnType)
+	{
+	case ColumnType::TabName:
+		stringId = IDS_TAB_MEMORY_COLUMN_TAB_NAME;
+		break;
+
+	case ColumnType::Path:
+		stringId = IDS_TAB_MEMORY_COLUMN_PATH;
+		break;
+
+	case ColumnType::Items:
+		stringId = IDS_TAB_MEMORY_COLUMN_ITEMS;
+		break;
+
+	case ColumnType::Thumbnails:
+		stringId = IDS_TAB_MEMORY_COLUMN_THUMBNAILS;
+		break;
+
+	case ColumnType::History:
+		stringId = IDS_TAB_MEMORY_COLUMN_HISTORY;
+		break;
+
+	case ColumnType::PendingResults:
+		stringId = IDS_TAB_MEMORY_COLUMN_PENDING_RESULTS;
+		break;
+
+	case ColumnType::Total:
+		stringId = IDS_TAB_MEMORY_COLUMN_TOTAL;
+		break;
+
+	case ColumnType::Status:
+		stringId = IDS_TAB_MEMORY_COLUMN_STATUS;
+		break;
+
+	default:
+		LOG(FATAL) << "Tab memory column type not found";
+		__assume(0);
+	}
+
+	return m_resourceLoader->LoadString(stringId);
+}
+
+void TabMemoryDialog::RefreshTabList()
+{
+	m_tabs.clear();
+
+	size_t totalUsage = 0;
+
+	for (const auto *tab : m_tabList->GetAllByLastActiveTime())
+	{
+		const auto *shellBrowser = tab->GetShellBrowser();
+
+		TabMemoryInfo tabInfo;
+		tabInfo.tabId = tab->GetId();
+		tabInfo.name = tab->GetName();
+		tabInfo.path =
+			GetDisplayNameWithFallback(shellBrowser->GetDirectory().Raw(), SHGDN_FORPARSING);
+		tabInfo.memoryUsage = shellBrowser->GetMemoryUsage();
+		tabInfo.contentsDiscarded = shellBrowser->AreContentsDiscarded();
+		m_tabs.push_back(tabInfo);
+
+		totalUsage += tabInfo.memoryUsage.GetTotal();
+	}
+
+	HWND listView = GetDlgItem(m_hDlg, IDC_TAB_MEMORY_TAB_LIST);
+
+	ScopedRedrawDisabler redrawDisabler(listView);
+	ListView_DeleteAllItems(listView);
+
+	for (int i = 0; i < std::ssize(m_tabs); i++)
+	{
+		LVITEM item = {};
+		item.mask = LVIF_TEXT | LVIF_PARAM;
+		item.iItem = i;
+		item.iSubItem = 0;
+		item.pszText = LPSTR_TEXTCALLBACK;
+		item.lParam = i;
+		int finalIndex = ListView_InsertItem(listView, &item);
+		CHECK(finalIndex == i);
+	}
+
+	UpdateSummary(totalUsage);
+}
+
+void TabMemoryDialog::UpdateSummary(size_t totalUsage)
+{
+	std::wstring budgetText;
+
+	if (m_config->tabMemoryBudgetMB == 0)
+	{
+		budgetText = m_resourceLoader->LoadString(IDS_TAB_MEMORY_NO_BUDGET);
+	}
+	else
+	{
+		budgetText = FormatSizeString(static_cast<uint64_t>(m_config->tabMemoryBudgetMB) * 1024
+			* 1024);
+	}
+
+	std::wstring summary =
+		fmt::format(fmt::runtime(m_resourceLoader->LoadString(IDS_TAB_MEMORY_SUMMARY)),
+			fmt::arg(L"total", FormatSizeString(totalUsage)), fmt::arg(L"budget", budgetText));
+	SetDlgItemText(m_hDlg, IDC_TAB_MEMORY_SUMMARY, summary.c_str());
+}
+
+INT_PTR TabMemoryDialog::OnCommand(WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (LOWORD(wParam))
+	{
+	case IDC_TAB_MEMORY_REFRESH:
+		RefreshTabList();
+		break;
+
+	case IDCANCEL:
+		DestroyWindow(m_hDlg);
+		break;
+	}
+
+	return 0;
+}
+
+INT_PTR TabMemoryDialog::OnNotify(NMHDR *nmhdr)
+{
+	if (nmhdr->idFrom == IDC_TAB_MEMORY_TAB_LIST)
+	{
+		switch (nmhdr->code)
+		{
+		case NM_DBLCLK:
+			OnListViewDoubleClick(reinterpret_cast<NMITEMACTIVATE *>(nmhdr));
+			break;
+
+		case LVN_GETDISPINFO:
+			OnGetDispInfo(reinterpret_cast<NMLVDISPINFO *>(nmhdr));
+			break;
+		}
+	}
+
+	return 0;
+}
+
+void TabMemoryDialog::OnListViewDoubleClick(const NMITEMACTIVATE *itemActivate)
+{
+	if (itemActivate->iItem == -1)
+	{
+		return;
+	}
+
+	// The list is only a snapshot, so the tab may have been closed since it was added.
+	const auto *tab = m_tabList->GetById(m_tabs[itemActivate->iItem].tabId);
+
+	if (!tab)
+	{
+		return;
+	}
+
+	tab->GetTabContainer()->SelectTab(*tab);
+}
+
+void TabMemoryDialog::OnGetDispInfo(NMLVDISPINFO *dispInfo)
+{
+	if (WI_IsFlagSet(dispInfo->item.mask, LVIF_TEXT))
+	{
+		CHECK(dispInfo->item.lParam >= 0 && dispInfo->item.lParam < std::ssize(m_tabs));
+		const auto &tabInfo = m_tabs[dispInfo->item.lParam];
+
+		CHECK(dispInfo->item.iSubItem >= 0 && dispInfo->item.iSubItem < std::ssize(COLUMNS));
+		auto columnType = COLUMNS[dispInfo->item.iSubItem].type;
+
+		auto text = GetTabColumnText(tabInfo, columnType);
+		StringCchCopy(dispInfo->item.pszText, dispInfo->item.cchTextMax, text.c_str());
+
+		WI_SetFlag(dispInfo->item.mask, LVIF_DI_SETITEM);
+	}
+}
+
+std::wstring TabMemoryDialog::GetTabColumnText(const TabMemoryInfo &tabInfo,
+	ColumnType columnType)
+{
+	switch (columnType)
+	{
+	case ColumnType::TabName:
+		return tabInfo.name;
+
+	case ColumnType::Path:
+		return tabInfo.path;
+
+	case ColumnType::Items:
+		return FormatSizeString(tabInfo.memoryUsage.items);
+
+	case ColumnType::Thumbnails:
+		return FormatSizeString(tabInfo.memoryUsage.thumbnails);
+
+	case ColumnType::History:
+		return FormatSizeString(tabInfo.memoryUsage.history);
+
+	case ColumnType::PendingResults:
+		return FormatSizeString(tabInfo.memoryUsage.pendingResults);
+
+	case ColumnType::Total:
+		return FormatSizeString(tabInfo.memoryUsage.GetTotal());
+
+	case ColumnType::Status:
+		return m_resourceLoader->LoadString(tabInfo.contentsDiscarded
+				? IDS_TAB_MEMORY_STATUS_DISCARDED
+				: IDS_TAB_MEMORY_STATUS_LOADED);
+
+	default:
+		LOG(FATAL) << "Tab memory column type not found";
+		__assume(0);
+	}
+}
+
+INT_PTR TabMemoryDialog::OnClose()
+{
+	DestroyWindow(m_hDlg);
+	return 0;
+}
+
+void TabMemoryDialog::SaveState()
+{
+	m_persistentSettings->SaveDialogPosition(m_hDlg);
+
+	m_persistentSettings->m_bStateSaved = TRUE;
+}
+
+TabMemoryDialogPersistentSettings::TabMemoryDialogPersistentSettings() :
+	DialogSettings(SETTINGS_KEY.c_str())
+{
+}
+
+TabMemoryDialogPersistentSettings &TabMemoryDialogPersistentSettings::GetInstance()
+{
+	static TabMemoryDialogPersistentSettings persistentSettings;
+	return persistentSettings;
+}
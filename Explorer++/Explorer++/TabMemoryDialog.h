@@ -0,0 +1,101 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "BaseDialog.h"
+#include "ShellBrowser/ShellBrowserMemoryUsage.h"
+#include "../Helper/DialogSettings.h"
+#include <string>
+#include <vector>
+
+struct Config;
+class ResourceLoader;
+class TabList;
+class TabMemoryDialog;
+
+class TabMemoryDialogPersistentSettings : public DialogSettings
+{
+public:
+	static TabMemoryDialogPersistentSettings &GetInstance();
+
+private:
+	friend TabMemoryDialog;
+
+	static const inline std::wstring SETTINGS_KEY = L"TabMemory";
+
+	TabMemoryDialogPersistentSettings();
+};
+
+// Displays the estimated memory usage of each tab, along with the total usage and the configured
+// budget. The figures are a snapshot, taken when the dialog is opened, or when the list is
+// explicitly refreshed.
+class TabMemoryDialog : public BaseDialog
+{
+public:
+	static TabMemoryDialog *Create(HWND parent, const TabList *tabList, const Config *config,
+		const ResourceLoader *resourceLoader);
+
+private:
+	enum class ColumnType
+	{
+		TabName,
+		Path,
+		Items,
+		Thumbnails,
+		History,
+		PendingResults,
+		Total,
+		Status
+	};
+
+	struct Column
+	{
+		ColumnType type;
+		float percentageWidth;
+	};
+
+	struct TabMemoryInfo
+	{
+		int tabId;
+		std::wstring name;
+		std::wstring path;
+		ShellBrowserMemoryUsage memoryUsage;
+		bool contentsDiscarded;
+	};
+
+	static inline const Column COLUMNS[] = { { ColumnType::TabName, 0.17f },
+		{ ColumnType::Path, 0.28f }, { ColumnType::Items, 0.09f },
+		{ ColumnType::Thumbnails, 0.09f }, { ColumnType::History, 0.09f },
+		{ ColumnType::PendingResults, 0.09f }, { ColumnType::Total, 0.09f },
+		{ ColumnType::Status, 0.09f } };
+
+	TabMemoryDialog(HWND parent, const TabList *tabList, const Config *config,
+		const ResourceLoader *resourceLoader);
+	~TabMemoryDialog() = default;
+
+	INT_PTR OnInitDialog() override;
+	wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
+	std::vector<ResizableDialogControl> GetResizableControls() override;
+	void SetupListView();
+	void InsertColumns();
+	void InsertColumn(const Column &column, int index);
+	std::wstring GetColumnText(ColumnType columnType);
+	void RefreshTabList();
+	void UpdateSummary(size_t totalUsage);
+
+	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
+	INT_PTR OnNotify(NMHDR *nmhdr) override;
+	void OnListViewDoubleClick(const NMITEMACTIVATE *itemActivate);
+	void OnGetDispInfo(NMLVDISPINFO *dispInfo);
+	std::wstring GetTabColumnText(const TabMemoryInfo &tabInfo, ColumnType columnType);
+
+	INT_PTR OnClose() override;
+	void SaveState() override;
+
+	const TabList *const m_tabList;
+	const Config *const m_config;
+	std::vector<TabMemoryInfo> m_tabs;
+	TabMemoryDialogPersistentSettings *m_persistentSettings;
+};
@@ -0,0 +1,87 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TabMemoryManager.h"
+#include "Config.h"
+#include "ShellBrowser/ShellBrowser.h"
+#include "Tab.h"
+#include "TabContainer.h"
+#include "TabList.h"
+#include <ranges>
+#include <vector>
+
+TabMemoryManager::TabMemoryManager(const TabList *tabList, const Config *config) :
+	m_tabList(tabList),
+	m_config(config)
+{
+}
+
+void TabMemoryManager::EnforceBudget()
+{
+	if (m_config->tabMemoryBudgetMB == 0)
+	{
+		return;
+	}
+
+	const size_t budget = static_cast<size_t>(m_config->tabMemoryBudgetMB) * 1024 * 1024;
+	size_t totalUsage = GetTotalMemoryUsage();
+
+	if (totalUsage <= budget)
+	{
+		return;
+	}
+
+	// Tabs are returned in order of most recently used, so the list needs to be reversed, in order
+	// to consider the least recently used tabs first.
+	std::vector<Tab *> tabs;
+
+	for (auto *tab : m_tabList->GetAllByLastActiveTime())
+	{
+		tabs.push_back(tab);
+	}
+
+	for (auto *tab : tabs | std::views::reverse)
+	{
+		if (totalUsage <= budget)
+		{
+			break;
+		}
+
+		// The selected tab in each window is visible, so its contents can't be discarded.
+		if (tab->GetTabContainer()->IsTabSelected(*tab))
+		{
+			continue;
+		}
+
+		auto *shellBrowser = tab->GetShellBrowser();
+
+		if (shellBrowser->AreContentsDiscarded())
+		{
+			continue;
+		}
+
+		size_t previousUsage = shellBrowser->GetMemoryUsage().GetTotal();
+
+		if (!shellBrowser->DiscardContents())
+		{
+			continue;
+		}
+
+		totalUsage -= previousUsage;
+		totalUsage += shellBrowser->GetMemoryUsage().GetTotal();
+	}
+}
+
+size_t TabMemoryManager::GetTotalMemoryUsage() const
+{
+	size_t totalUsage = 0;
+
+	for (const auto *tab : m_tabList->GetAll())
+	{
+		totalUsage += tab->GetShellBrowser()->GetMemoryUsage().GetTotal();
+	}
+
+	return totalUsage;
+}
@@ -0,0 +1,26 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+
+struct Config;
+class TabList;
+
+// Keeps the combined memory usage of all tabs within the budget set in the config. When the budget
+// is exceeded, the contents of the least recently used tabs will be discarded, until the total
+// usage falls below the budget again. Discarded tabs will be reloaded once they're shown again.
+class TabMemoryManager : private boost::noncopyable
+{
+public:
+	TabMemoryManager(const TabList *tabList, const Config *config);
+
+	void EnforceBudget();
+	size_t GetTotalMemoryUsage() const;
+
+private:
+	const TabList *const m_tabList;
+	const Config *const m_config;
+};
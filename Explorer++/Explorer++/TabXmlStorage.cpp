@@ -7,6 +7,8 @@
 #include "ColumnXmlStorage.h"
 #include "TabStorage.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <wil/com.h>
 #include <msxml.h>
 #include <optional>
@@ -258,6 +260,152 @@ void SaveTabInfo(IXMLDOMDocument *xmlDocument, IXMLDOMElement *tabNode, const Ta
 	SaveTabSettings(xmlDocument, tabNode, tab.tabSettings);
 }
 
+void ReadBooleanSortDirection(const XmlReader &reader, const std::wstring &valueName,
+	SortDirection &output)
+{
+	auto sortAscending = XMLSettings::MaybeGetBool(reader, valueName);
+
+	if (!sortAscending)
+	{
+		return;
+	}
+
+	output = *sortAscending ? SortDirection::Ascending : SortDirection::Descending;
+}
+
+FolderSettings ReadFolderSettings(const XmlReader &reader)
+{
+	FolderSettings folderSettings;
+
+	XMLSettings::LoadBetterEnumValue(reader, SETTING_VIEW_MODE, folderSettings.viewMode);
+	XMLSettings::LoadBetterEnumValue(reader, SETTING_SORT_MODE, folderSettings.sortMode);
+	folderSettings.groupMode = folderSettings.sortMode;
+	ReadBooleanSortDirection(reader, SETTING_SORT_ASCENDING, folderSettings.sortDirection);
+	folderSettings.groupSortDirection = folderSettings.sortDirection;
+	XMLSettings::LoadBetterEnumValue(reader, SETTING_GROUP_MODE, folderSettings.groupMode);
+	XMLSettings::LoadBetterEnumValue(reader, SETTING_GROUP_SORT_DIRECTION,
+		folderSettings.groupSortDirection);
+	folderSettings.showInGroups = XMLSettings::MaybeGetBool(reader, SETTING_SHOW_IN_GROUPS)
+									  .value_or(folderSettings.showInGroups);
+	folderSettings.filterEnabled = XMLSettings::MaybeGetBool(reader, SETTING_APPLY_FILTER)
+									   .value_or(folderSettings.filterEnabled);
+	folderSettings.filterCaseSensitive =
+		XMLSettings::MaybeGetBool(reader, SETTING_FILTER_CASE_SENSITIVE)
+			.value_or(folderSettings.filterCaseSensitive);
+	folderSettings.showHidden =
+		XMLSettings::MaybeGetBool(reader, SETTING_SHOW_HIDDEN).value_or(folderSettings.showHidden);
+	folderSettings.autoArrangeEnabled = XMLSettings::MaybeGetBool(reader, SETTING_AUTO_ARRANGE)
+											.value_or(folderSettings.autoArrangeEnabled);
+	folderSettings.filter =
+		XMLSettings::MaybeGetString(reader, SETTING_FILTER).value_or(folderSettings.filter);
+
+	return folderSettings;
+}
+
+TabSettings ReadTabSettings(const XmlReader &reader)
+{
+	TabSettings tabSettings;
+
+	bool locked = XMLSettings::MaybeGetBool(reader, SETTING_TAB_LOCKED).value_or(false);
+	bool addressLocked =
+		XMLSettings::MaybeGetBool(reader, SETTING_TAB_ADDRESS_LOCKED).value_or(false);
+
+	if (addressLocked)
+	{
+		tabSettings.lockState = Tab::LockState::AddressLocked;
+	}
+	else if (locked)
+	{
+		tabSettings.lockState = Tab::LockState::Locked;
+	}
+
+	auto customName = XMLSettings::MaybeGetString(reader, SETTING_TAB_CUSTOM_NAME);
+
+	if (customName && !customName->empty())
+	{
+		tabSettings.name = *customName;
+	}
+
+	return tabSettings;
+}
+
+std::optional<TabStorageData> ReadTabInfo(XmlReader &reader)
+{
+	auto directory = XMLSettings::MaybeGetString(reader, SETTING_DIRECTORY);
+
+	if (!directory)
+	{
+		return std::nullopt;
+	}
+
+	// The attributes are only available while the reader is positioned on the start element, so
+	// they need to be read before the child elements are.
+	TabStorageData tabStorageData;
+	tabStorageData.directory = *directory;
+	tabStorageData.folderSettings = ReadFolderSettings(reader);
+	tabStorageData.tabSettings = ReadTabSettings(reader);
+
+	bool columnsRead = false;
+	bool res = XMLSettings::ReadChildElements(reader,
+		[&tabStorageData, &columnsRead](XmlReader &reader)
+		{
+			if (columnsRead || reader.GetName() != SETTING_COLUMNS)
+			{
+				return true;
+			}
+
+			columnsRead = true;
+			return ColumnXmlStorage::LoadAllColumnSets(reader, tabStorageData.columns);
+		});
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	return tabStorageData;
+}
+
+void WriteTabInfo(XmlWriter &writer, const TabStorageData &tab)
+{
+	const auto &folderSettings = tab.folderSettings;
+	writer.WriteAttribute(SETTING_DIRECTORY, tab.directory);
+	writer.WriteAttribute(SETTING_VIEW_MODE, XMLSettings::EncodeIntValue(folderSettings.viewMode));
+	writer.WriteAttribute(SETTING_SORT_MODE, XMLSettings::EncodeIntValue(folderSettings.sortMode));
+
+	// For backwards compatibility, the value saved here is a bool.
+	writer.WriteAttribute(SETTING_SORT_ASCENDING,
+		XMLSettings::EncodeBoolValue(folderSettings.sortDirection == +SortDirection::Ascending));
+
+	writer.WriteAttribute(SETTING_GROUP_MODE,
+		XMLSettings::EncodeIntValue(folderSettings.groupMode));
+	writer.WriteAttribute(SETTING_GROUP_SORT_DIRECTION,
+		XMLSettings::EncodeIntValue(folderSettings.groupSortDirection));
+	writer.WriteAttribute(SETTING_SHOW_IN_GROUPS,
+		XMLSettings::EncodeBoolValue(folderSettings.showInGroups));
+	writer.WriteAttribute(SETTING_APPLY_FILTER,
+		XMLSettings::EncodeBoolValue(folderSettings.filterEnabled));
+	writer.WriteAttribute(SETTING_FILTER_CASE_SENSITIVE,
+		XMLSettings::EncodeBoolValue(folderSettings.filterCaseSensitive));
+	writer.WriteAttribute(SETTING_SHOW_HIDDEN,
+		XMLSettings::EncodeBoolValue(folderSettings.showHidden));
+	writer.WriteAttribute(SETTING_AUTO_ARRANGE,
+		XMLSettings::EncodeBoolValue(folderSettings.autoArrangeEnabled));
+	writer.WriteAttribute(SETTING_FILTER, folderSettings.filter);
+
+	writer.WriteAttribute(SETTING_TAB_LOCKED,
+		XMLSettings::EncodeBoolValue(tab.tabSettings.lockState == Tab::LockState::Locked));
+	writer.WriteAttribute(SETTING_TAB_ADDRESS_LOCKED,
+		XMLSettings::EncodeBoolValue(tab.tabSettings.lockState == Tab::LockState::AddressLocked));
+	writer.WriteAttribute(SETTING_TAB_CUSTOM_NAME,
+		tab.tabSettings.name ? *tab.tabSettings.name : L"");
+
+	// Attributes have to be written before any child elements.
+	writer.StartElement(SETTING_COLUMNS);
+	ColumnXmlStorage::SaveAllColumnSets(writer, tab.columns);
+	writer.EndElement();
+}
+
 }
 
 std::vector<TabStorageData> Load(IXMLDOMNode *tabsNode)
@@ -272,4 +420,14 @@ void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *tabsNode,
 		SaveTabInfo);
 }
 
+std::optional<std::vector<TabStorageData>> Load(XmlReader &reader)
+{
+	return XMLSettings::ReadItemList<TabStorageData>(reader, TAB_NODE_NAME, ReadTabInfo);
+}
+
+void Save(XmlWriter &writer, const std::vector<TabStorageData> &tabs)
+{
+	XMLSettings::SaveItemList<TabStorageData>(writer, tabs, TAB_NODE_NAME, WriteTabInfo);
+}
+
 }
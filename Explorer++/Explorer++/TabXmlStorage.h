@@ -5,9 +5,12 @@
 #pragma once
 
 #include <msxml.h>
+#include <optional>
 #include <vector>
 
 struct TabStorageData;
+class XmlReader;
+class XmlWriter;
 
 namespace TabXmlStorage
 {
@@ -16,4 +19,9 @@ std::vector<TabStorageData> Load(IXMLDOMNode *tabsNode);
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *tabsNode,
 	const std::vector<TabStorageData> &tabs);
 
+// The reader should be positioned on the tabs start element. When this returns, the reader will be
+// positioned on the matching end element.
+std::optional<std::vector<TabStorageData>> Load(XmlReader &reader);
+void Save(XmlWriter &writer, const std::vector<TabStorageData> &tabs);
+
 }
@@ -0,0 +1,400 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TaskScheduler.h"
+#include <wil/resource.h>
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+struct TaskScheduler::QueuedTask
+{
+	std::shared_ptr<Group> group;
+	Priority requestedPriority;
+	std::function<void()> func;
+	std::optional<TaskTag> tag;
+
+	// Used to retain the order in which tasks were queued when tasks are moved between queues.
+	uint64_t sequence;
+};
+
+struct TaskScheduler::State
+{
+	State(Executors executors, int maxConcurrency) :
+		executors(std::move(executors)),
+		maxConcurrency(maxConcurrency)
+	{
+	}
+
+	std::optional<QueuedTask> TakeNextTask()
+	{
+		for (auto &queue : queues)
+		{
+			while (!queue.empty())
+			{
+				auto task = std::move(queue.front());
+				queue.pop_front();
+
+				if (!task.group->IsCancelled())
+				{
+					return task;
+				}
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	// Each queue is ordered by sequence, so tasks that are moved between queues need to be merged
+	// back in, rather than simply appended.
+	void MergeMovedTasks(std::array<std::vector<QueuedTask>, NUM_PRIORITIES> &movedTasks)
+	{
+		for (size_t i = 0; i < NUM_PRIORITIES; i++)
+		{
+			if (movedTasks[i].empty())
+			{
+				continue;
+			}
+
+			std::ranges::sort(movedTasks[i], {}, &QueuedTask::sequence);
+
+			auto &queue = queues[i];
+			std::deque<QueuedTask> mergedQueue;
+			std::merge(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()),
+				std::make_move_iterator(movedTasks[i].begin()),
+				std::make_move_iterator(movedTasks[i].end()), std::back_inserter(mergedQueue),
+				[](const QueuedTask &task1, const QueuedTask &task2)
+				{ return task1.sequence < task2.sequence; });
+			queue = std::move(mergedQueue);
+		}
+	}
+
+	const Executors executors;
+	const int maxConcurrency;
+
+	mutable std::mutex mutex;
+
+	// Indexed by the effective priority of each task.
+	std::array<std::deque<QueuedTask>, NUM_PRIORITIES> queues;
+
+	uint64_t nextSequence = 0;
+	int numRunning = 0;
+	bool shutDown = false;
+};
+
+TaskScheduler::Group::Group(std::shared_ptr<Group> parent, bool visible) :
+	m_parent(std::move(parent)),
+	m_visible(visible)
+{
+}
+
+bool TaskScheduler::Group::IsCancelled() const
+{
+	for (auto *group = this; group; group = group->m_parent.get())
+	{
+		if (group->m_cancelled)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TaskScheduler::Group::IsVisible() const
+{
+	for (auto *group = this; group; group = group->m_parent.get())
+	{
+		if (!group->m_visible)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TaskScheduler::TaskScheduler(Executors executors, int maxConcurrency) :
+	m_state(std::make_shared<State>(std::move(executors), maxConcurrency))
+{
+	CHECK_GT(maxConcurrency, 0);
+
+	for (const auto &executor : m_state->executors)
+	{
+		CHECK(executor);
+	}
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	std::array<std::deque<QueuedTask>, NUM_PRIORITIES> queues;
+
+	{
+		std::scoped_lock lock(m_state->mutex);
+		m_state->shutDown = true;
+		queues = std::move(m_state->queues);
+	}
+
+	// The queued tasks are destroyed here, outside the lock, since destroying a task will destroy
+	// anything it captured.
+}
+
+std::shared_ptr<TaskScheduler::Group> TaskScheduler::CreateGroup(std::shared_ptr<Group> parent)
+{
+	// Group's constructor is private, so std::make_shared can't be used.
+	return std::shared_ptr<Group>(new Group(std::move(parent), true));
+}
+
+void TaskScheduler::CancelGroup(const std::shared_ptr<Group> &group)
+{
+	group->m_cancelled = true;
+
+	std::vector<QueuedTask> cancelledTasks;
+
+	{
+		std::scoped_lock lock(m_state->mutex);
+
+		for (auto &queue : m_state->queues)
+		{
+			auto itr = std::stable_partition(queue.begin(), queue.end(),
+				[](const QueuedTask &task) { return !task.group->IsCancelled(); });
+			std::move(itr, queue.end(), std::back_inserter(cancelledTasks));
+			queue.erase(itr, queue.end());
+		}
+	}
+
+	// As in the destructor, the cancelled tasks are only destroyed once the lock has been released.
+}
+
+std::shared_ptr<TaskScheduler::Group> TaskScheduler::ReplaceGroup(
+	const std::shared_ptr<Group> &group)
+{
+	CancelGroup(group);
+	return std::shared_ptr<Group>(new Group(group->m_parent, group->m_visible));
+}
+
+void TaskScheduler::SetGroupVisible(const std::shared_ptr<Group> &group, bool visible)
+{
+	if (group->m_visible == visible)
+	{
+		return;
+	}
+
+	group->m_visible = visible;
+
+	{
+		std::scoped_lock lock(m_state->mutex);
+
+		// Changing the visibility of a group can only change the effective priority of tasks in
+		// that group, or one of its descendants. Only those tasks whose effective priority actually
+		// changes are moved; every other task is left where it is.
+		std::array<std::vector<QueuedTask>, NUM_PRIORITIES> movedTasks;
+
+		for (size_t i = 0; i < NUM_PRIORITIES; i++)
+		{
+			auto &queue = m_state->queues[i];
+			auto itr = std::stable_partition(queue.begin(), queue.end(),
+				[&group, i](const QueuedTask &task)
+				{
+					if (!IsWithinGroup(*task.group, *group))
+					{
+						return true;
+					}
+
+					auto priority = GetEffectivePriority(*task.group, task.requestedPriority);
+					return static_cast<size_t>(priority) == i;
+				});
+
+			for (auto movedItr = itr; movedItr != queue.end(); ++movedItr)
+			{
+				auto priority = GetEffectivePriority(*movedItr->group, movedItr->requestedPriority);
+				movedTasks[static_cast<size_t>(priority)].push_back(std::move(*movedItr));
+			}
+
+			queue.erase(itr, queue.end());
+		}
+
+		m_state->MergeMovedTasks(movedTasks);
+	}
+
+	DispatchTasks(m_state);
+}
+
+std::vector<TaskScheduler::TaskTag> TaskScheduler::Reprioritize(
+	const std::shared_ptr<Group> &group, const GetPriorityCallback &getPriority)
+{
+	std::vector<TaskTag> cancelledTags;
+	std::vector<QueuedTask> cancelledTasks;
+
+	{
+		std::scoped_lock lock(m_state->mutex);
+
+		std::array<std::vector<QueuedTask>, NUM_PRIORITIES> movedTasks;
+
+		for (auto &queue : m_state->queues)
+		{
+			std::deque<QueuedTask> remainingTasks;
+
+			for (auto &task : queue)
+			{
+				if (task.group != group || !task.tag)
+				{
+					remainingTasks.push_back(std::move(task));
+					continue;
+				}
+
+				auto updatedPriority = getPriority(*task.tag);
+
+				if (!updatedPriority)
+				{
+					cancelledTags.push_back(*task.tag);
+					cancelledTasks.push_back(std::move(task));
+					continue;
+				}
+
+				task.requestedPriority = *updatedPriority;
+				auto effectivePriority = GetEffectivePriority(*task.group, *updatedPriority);
+				movedTasks[static_cast<size_t>(effectivePriority)].push_back(std::move(task));
+			}
+
+			queue = std::move(remainingTasks);
+		}
+
+		m_state->MergeMovedTasks(movedTasks);
+	}
+
+	return cancelledTags;
+}
+
+void TaskScheduler::QueueTask(std::shared_ptr<Group> group, Priority priority,
+	std::function<void()> func, std::optional<TaskTag> tag)
+{
+	CHECK(group);
+
+	if (group->IsCancelled())
+	{
+		return;
+	}
+
+	{
+		std::scoped_lock lock(m_state->mutex);
+
+		if (m_state->shutDown)
+		{
+			return;
+		}
+
+		auto effectivePriority = GetEffectivePriority(*group, priority);
+		m_state->queues[static_cast<size_t>(effectivePriority)].push_back(
+			{ std::move(group), priority, std::move(func), tag, m_state->nextSequence++ });
+	}
+
+	DispatchTasks(m_state);
+}
+
+bool TaskScheduler::IsWithinGroup(const Group &group, const Group &ancestor)
+{
+	for (auto *currentGroup = &group; currentGroup; currentGroup = currentGroup->m_parent.get())
+	{
+		if (currentGroup == &ancestor)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TaskScheduler::Priority TaskScheduler::GetEffectivePriority(const Group &group,
+	Priority requestedPriority)
+{
+	if (requestedPriority != Priority::Interactive && !group.IsVisible())
+	{
+		return Priority::Background;
+	}
+
+	return requestedPriority;
+}
+
+void TaskScheduler::DispatchTasks(const std::shared_ptr<State> &state)
+{
+	std::vector<QueuedTask> tasksToStart;
+
+	{
+		std::scoped_lock lock(state->mutex);
+
+		while (!state->shutDown && state->numRunning < state->maxConcurrency)
+		{
+			auto task = state->TakeNextTask();
+
+			if (!task)
+			{
+				break;
+			}
+
+			state->numRunning++;
+			tasksToStart.push_back(std::move(*task));
+		}
+	}
+
+	// Tasks are posted outside the lock, since an executor might run a task inline.
+	for (auto &task : tasksToStart)
+	{
+		auto priority = GetEffectivePriority(*task.group, task.requestedPriority);
+
+		try
+		{
+			state->executors[static_cast<size_t>(priority)]->post(
+				[state, task = std::move(task)]
+				{
+					auto finished = wil::scope_exit([&state] { OnTaskFinished(state); });
+
+					if (!task.group->IsCancelled())
+					{
+						task.func();
+					}
+				});
+		}
+		catch (const concurrencpp::errors::runtime_shutdown &)
+		{
+			std::scoped_lock lock(state->mutex);
+			state->numRunning--;
+		}
+	}
+}
+
+void TaskScheduler::OnTaskFinished(const std::shared_ptr<State> &state)
+{
+	{
+		std::scoped_lock lock(state->mutex);
+		state->numRunning--;
+	}
+
+	DispatchTasks(state);
+}
+
+size_t TaskScheduler::GetNumQueuedTasks() const
+{
+	std::scoped_lock lock(m_state->mutex);
+
+	size_t numQueuedTasks = 0;
+
+	for (const auto &queue : m_state->queues)
+	{
+		numQueuedTasks += queue.size();
+	}
+
+	return numQueuedTasks;
+}
+
+int TaskScheduler::GetNumRunningTasks() const
+{
+	std::scoped_lock lock(m_state->mutex);
+	return m_state->numRunning;
+}
@@ -0,0 +1,130 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "ComStaThreadPoolExecutor.h"
+#include <boost/core/noncopyable.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Schedules background work (e.g. retrieving column text, thumbnails and icons) on behalf of the
+// entire application. All work is run on a shared set of executors, with the total number of tasks
+// running at any one time being capped. That ensures that a large number of tabs can't result in a
+// large number of threads all competing with each other.
+//
+// Every task belongs to a group. Groups can be nested (e.g. a group for a tab, containing a group
+// for the current navigation in that tab) and cancelling a group will cancel all the tasks in that
+// group, as well as any tasks in descendant groups. Tasks that are cancelled before they start will
+// never be run.
+//
+// Tasks are started in priority order. The priority of a task is set by the caller (e.g. based on
+// whether the item the task is for is in view), but a task that belongs to a hidden group (e.g. a
+// group for a background tab) will always be run at the lowest priority, unless it's interactive.
+//
+// Tasks can also be tagged by the caller (e.g. with the index of the item the task is for). That
+// allows queued tasks to be re-prioritized later (e.g. when the set of items in view changes).
+//
+// This class should be used from the UI thread, though tasks can finish on any thread.
+class TaskScheduler : private boost::noncopyable
+{
+public:
+	using Priority = ComStaThreadPoolExecutor::TaskPriority;
+	static constexpr size_t NUM_PRIORITIES = ComStaThreadPoolExecutor::NUM_TASK_PRIORITIES;
+
+	// The executors that tasks will be run on, indexed by Priority.
+	using Executors = std::array<std::shared_ptr<concurrencpp::executor>, NUM_PRIORITIES>;
+
+	using TaskTag = int64_t;
+
+	// Returns the new priority for the task with the specified tag, or std::nullopt, if the task
+	// should be cancelled.
+	using GetPriorityCallback = std::function<std::optional<Priority>(TaskTag tag)>;
+
+	class Group : private boost::noncopyable
+	{
+	public:
+		// Returns true if this group, or any of its ancestors, has been cancelled. Long-running
+		// tasks can check this to determine whether they should stop early.
+		bool IsCancelled() const;
+
+		// Returns true if this group and all of its ancestors are visible.
+		bool IsVisible() const;
+
+	private:
+		friend class TaskScheduler;
+
+		Group(std::shared_ptr<Group> parent, bool visible);
+
+		const std::shared_ptr<Group> m_parent;
+		std::atomic_bool m_cancelled = false;
+		std::atomic_bool m_visible;
+	};
+
+	TaskScheduler(Executors executors, int maxConcurrency);
+	~TaskScheduler();
+
+	// Groups are initially visible.
+	std::shared_ptr<Group> CreateGroup(std::shared_ptr<Group> parent = nullptr);
+
+	// Cancels the group and removes any queued tasks that belong to it (or to one of its
+	// descendants). Tasks that have already started will continue to run.
+	void CancelGroup(const std::shared_ptr<Group> &group);
+
+	// Cancels the group and returns a new group with the same parent and visibility. This is useful
+	// when the existing work for something needs to be thrown away (e.g. when navigating to a new
+	// folder).
+	std::shared_ptr<Group> ReplaceGroup(const std::shared_ptr<Group> &group);
+
+	void SetGroupVisible(const std::shared_ptr<Group> &group, bool visible);
+
+	// Queues the function and returns a future that will contain the result. If the group is
+	// cancelled before the function runs, the function will be destroyed without being run.
+	template <typename Func>
+	auto Push(std::shared_ptr<Group> group, Priority priority, Func &&func,
+		std::optional<TaskTag> tag = std::nullopt)
+		-> std::future<std::invoke_result_t<std::decay_t<Func>>>
+	{
+		using Result = std::invoke_result_t<std::decay_t<Func>>;
+
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+		auto future = task->get_future();
+		QueueTask(std::move(group), priority, [task] { (*task)(); }, tag);
+		return future;
+	}
+
+	// Updates the priority of each tagged task in the group that hasn't yet started. Tasks in
+	// descendant groups aren't affected. The callback is invoked while an internal lock is held, so
+	// it shouldn't call back into this class. Returns the tags of the tasks that were cancelled.
+	std::vector<TaskTag> Reprioritize(const std::shared_ptr<Group> &group,
+		const GetPriorityCallback &getPriority);
+
+	size_t GetNumQueuedTasks() const;
+	int GetNumRunningTasks() const;
+
+private:
+	struct QueuedTask;
+	struct State;
+
+	void QueueTask(std::shared_ptr<Group> group, Priority priority, std::function<void()> func,
+		std::optional<TaskTag> tag);
+
+	// Returns true if the group is the ancestor group, or one of its descendants.
+	static bool IsWithinGroup(const Group &group, const Group &ancestor);
+	static Priority GetEffectivePriority(const Group &group, Priority requestedPriority);
+	static void DispatchTasks(const std::shared_ptr<State> &state);
+	static void OnTaskFinished(const std::shared_ptr<State> &state);
+
+	// Running tasks hold a reference to this state, which means that it will remain valid until
+	// those tasks finish, even if this instance has been destroyed.
+	const std::shared_ptr<State> m_state;
+};
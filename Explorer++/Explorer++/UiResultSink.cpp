@@ -0,0 +1,190 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "UiResultSink.h"
+
+UiResultSink::UiResultSink(std::shared_ptr<concurrencpp::executor> uiThreadExecutor,
+	std::shared_ptr<concurrencpp::timer_queue> timerQueue, BatchRunner batchRunner,
+	Clock::duration frameInterval, Clock::duration timeBudget) :
+	m_state(std::make_shared<State>(uiThreadExecutor, timerQueue, frameInterval)),
+	m_batchRunner(batchRunner),
+	m_timeBudget(timeBudget)
+{
+	m_state->sink = this;
+}
+
+UiResultSink::~UiResultSink()
+{
+	m_state->sink = nullptr;
+	m_state->shutDown = true;
+
+	std::scoped_lock lock(m_state->timerMutex);
+	m_state->timer.cancel();
+}
+
+UiResultSink::Handle UiResultSink::GetHandle() const
+{
+	return Handle(m_state);
+}
+
+UiResultSink::Handle::Handle(std::shared_ptr<State> state) : m_state(state)
+{
+}
+
+void UiResultSink::Handle::Post(Completion completion) const
+{
+	if (m_state->shutDown)
+	{
+		return;
+	}
+
+	auto *node = new Node{ std::move(completion) };
+	node->next = m_state->head.load(std::memory_order_relaxed);
+
+	while (!m_state->head.compare_exchange_weak(node->next, node, std::memory_order_release,
+		std::memory_order_relaxed))
+	{
+	}
+
+	// Only the first completion posted after a drain needs to schedule the next drain. Every other
+	// completion will be picked up by that drain.
+	if (!m_state->drainScheduled.exchange(true))
+	{
+		ScheduleDrain(m_state);
+	}
+}
+
+void UiResultSink::ScheduleDrain(const std::shared_ptr<State> &state)
+{
+	auto delay = Clock::duration(state->nextDrainTime - Clock::now().time_since_epoch().count());
+	std::weak_ptr<State> weakState = state;
+
+	try
+	{
+		if (delay <= Clock::duration::zero())
+		{
+			state->uiThreadExecutor->post([weakState] { OnDrainDue(weakState); });
+			return;
+		}
+
+		std::scoped_lock lock(state->timerMutex);
+
+#pragma warning(push)
+#pragma warning(                                                                                   \
+	disable : 4244) // 'argument': conversion from '_Rep' to 'size_t', possible loss of data
+		state->timer = state->timerQueue->make_one_shot_timer(
+			std::chrono::ceil<std::chrono::milliseconds>(delay), state->uiThreadExecutor,
+			[weakState] { OnDrainDue(weakState); });
+#pragma warning(pop)
+	}
+	catch (const concurrencpp::errors::runtime_shutdown &)
+	{
+		// The application is shutting down, so there's no need to apply any further results.
+	}
+}
+
+void UiResultSink::OnDrainDue(std::weak_ptr<State> weakState)
+{
+	auto state = weakState.lock();
+
+	if (!state || !state->sink)
+	{
+		return;
+	}
+
+	state->sink->Drain();
+}
+
+void UiResultSink::Drain()
+{
+	auto now = Clock::now();
+	m_state->nextDrainTime = (now + m_state->frameInterval).time_since_epoch().count();
+
+	// This is reset before the stack is taken, so that any completion posted after that point will
+	// schedule another drain.
+	m_state->drainScheduled = false;
+
+	TakePostedCompletions();
+
+	if (m_pendingCompletions.empty())
+	{
+		return;
+	}
+
+	auto deadline = now + m_timeBudget;
+
+	if (m_batchRunner)
+	{
+		m_batchRunner(m_pendingCompletions.size(), [this, deadline] { RunBatch(deadline); });
+	}
+	else
+	{
+		RunBatch(deadline);
+	}
+
+	// If the time budget was exhausted, the remaining completions will be run in the next frame.
+	if (!m_pendingCompletions.empty() && !m_state->drainScheduled.exchange(true))
+	{
+		ScheduleDrain(m_state);
+	}
+}
+
+void UiResultSink::TakePostedCompletions()
+{
+	Node *node = m_state->head.exchange(nullptr, std::memory_order_acquire);
+
+	// The stack is ordered from the most recently posted completion to the least recently posted
+	// completion. Completions should be run in the order they were posted, so the stack is reversed
+	// here.
+	Node *reversedNode = nullptr;
+
+	while (node)
+	{
+		Node *next = node->next;
+		node->next = reversedNode;
+		reversedNode = node;
+		node = next;
+	}
+
+	while (reversedNode)
+	{
+		std::unique_ptr<Node> ownedNode(reversedNode);
+		m_pendingCompletions.push_back(std::move(ownedNode->completion));
+		reversedNode = ownedNode->next;
+	}
+}
+
+void UiResultSink::RunBatch(Clock::time_point deadline)
+{
+	// At least one completion is always run, to guarantee that progress is made, even if the time
+	// budget is very small.
+	do
+	{
+		auto completion = std::move(m_pendingCompletions.front());
+		m_pendingCompletions.pop_front();
+		completion();
+	} while (!m_pendingCompletions.empty() && Clock::now() < deadline);
+}
+
+UiResultSink::State::State(std::shared_ptr<concurrencpp::executor> uiThreadExecutor,
+	std::shared_ptr<concurrencpp::timer_queue> timerQueue, Clock::duration frameInterval) :
+	uiThreadExecutor(uiThreadExecutor),
+	timerQueue(timerQueue),
+	frameInterval(frameInterval)
+{
+}
+
+UiResultSink::State::~State()
+{
+	// Completions that were posted after the last drain (or after the sink was destroyed) are never
+	// run, but still need to be freed.
+	Node *node = head.load();
+
+	while (node)
+	{
+		std::unique_ptr<Node> ownedNode(node);
+		node = ownedNode->next;
+	}
+}
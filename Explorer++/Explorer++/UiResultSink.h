@@ -0,0 +1,121 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// Collects the completions of background tasks (e.g. a function that applies a piece of column
+// text to the listview) and runs them on the UI thread in batches. Posting a completion is
+// lock-free, so it's cheap for a background task to do, no matter how many other tasks are
+// finishing at the same time.
+//
+// The queued completions are drained at most once per frame. Each drain runs completions until the
+// time budget is exhausted, with any remaining completions being left for the next frame. That
+// ensures that a large number of results arriving at once can't prevent input from being processed.
+// Because each batch is run as a unit, the caller can also perform work once per batch (e.g.
+// disabling redraw while the batch runs), rather than once per completion.
+//
+// Aside from UiResultSink::Handle, this class should only be used from the UI thread. Note that a
+// completion shouldn't destroy the sink that's running it.
+class UiResultSink : private boost::noncopyable
+{
+private:
+	struct State;
+
+public:
+	using Clock = std::chrono::steady_clock;
+	using Completion = std::function<void()>;
+
+	// Invoked on the UI thread to run each batch of completions. numCompletions is the number of
+	// completions that are pending. Since the batch will stop once the time budget is exhausted,
+	// not all of those completions will necessarily be run as part of the batch.
+	using BatchRunner =
+		std::function<void(size_t numCompletions, const std::function<void()> &runBatch)>;
+
+	static constexpr Clock::duration DEFAULT_FRAME_INTERVAL = std::chrono::milliseconds(16);
+	static constexpr Clock::duration DEFAULT_TIME_BUDGET = std::chrono::milliseconds(8);
+
+	// Allows completions to be posted. Unlike the sink itself, a handle can be copied and used from
+	// any thread. A handle can also outlive the sink it came from. Any completions posted once the
+	// sink has been destroyed will simply be dropped.
+	class Handle
+	{
+	public:
+		void Post(Completion completion) const;
+
+	private:
+		friend class UiResultSink;
+
+		explicit Handle(std::shared_ptr<State> state);
+
+		std::shared_ptr<State> m_state;
+	};
+
+	UiResultSink(std::shared_ptr<concurrencpp::executor> uiThreadExecutor,
+		std::shared_ptr<concurrencpp::timer_queue> timerQueue, BatchRunner batchRunner = nullptr,
+		Clock::duration frameInterval = DEFAULT_FRAME_INTERVAL,
+		Clock::duration timeBudget = DEFAULT_TIME_BUDGET);
+	~UiResultSink();
+
+	Handle GetHandle() const;
+
+private:
+	// Completions are pushed onto an intrusive, singly-linked stack. Any number of threads can push
+	// onto the stack, while the UI thread takes the entire stack at once.
+	struct Node
+	{
+		Completion completion;
+		Node *next = nullptr;
+	};
+
+	struct State
+	{
+		State(std::shared_ptr<concurrencpp::executor> uiThreadExecutor,
+			std::shared_ptr<concurrencpp::timer_queue> timerQueue, Clock::duration frameInterval);
+		~State();
+
+		const std::shared_ptr<concurrencpp::executor> uiThreadExecutor;
+		const std::shared_ptr<concurrencpp::timer_queue> timerQueue;
+		const Clock::duration frameInterval;
+
+		std::atomic<Node *> head = nullptr;
+		std::atomic_bool drainScheduled = false;
+		std::atomic_bool shutDown = false;
+
+		// The earliest time at which the next drain should take place, stored as a count of clock
+		// ticks.
+		std::atomic<Clock::rep> nextDrainTime = 0;
+
+		// The timer is only used to delay a drain until the next frame. It's only accessed when
+		// scheduling a drain, which is rare compared to posting a completion.
+		std::mutex timerMutex;
+		concurrencpp::timer timer;
+
+		// This is only accessed on the UI thread.
+		UiResultSink *sink = nullptr;
+	};
+
+	static void ScheduleDrain(const std::shared_ptr<State> &state);
+	static void OnDrainDue(std::weak_ptr<State> weakState);
+
+	void Drain();
+	void TakePostedCompletions();
+	void RunBatch(Clock::time_point deadline);
+
+	const std::shared_ptr<State> m_state;
+	const BatchRunner m_batchRunner;
+	const Clock::duration m_timeBudget;
+
+	// Completions that have been taken from the stack, but not yet run. This is only accessed on
+	// the UI thread.
+	std::deque<Completion> m_pendingCompletions;
+};
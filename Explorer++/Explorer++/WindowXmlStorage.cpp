@@ -13,6 +13,8 @@
 #include "WindowStorage.h"
 #include "../Helper/WindowHelper.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <wil/com.h>
 #include <wil/resource.h>
 #include <format>
@@ -208,7 +210,6 @@ std::optional<WindowStorageData> Load(IXMLDOMNode *rootNode, IXMLDOMNode *window
 namespace V2
 {
 
-const wchar_t WINDOWS_NODE_NAME[] = L"Windows";
 const wchar_t WINDOW_NODE_NAME[] = L"Window";
 
 const wchar_t SETTING_X[] = L"X";
@@ -479,6 +480,108 @@ void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *windowsNode,
 	}
 }
 
+// If any of the optional values (which the DOM version can retrieve from the v1 format) are
+// missing, complete will be set to false.
+std::optional<WindowStorageData> ReadWindow(XmlReader &reader, bool &complete)
+{
+	auto x = XMLSettings::MaybeGetInt(reader, SETTING_X);
+	auto y = XMLSettings::MaybeGetInt(reader, SETTING_Y);
+	auto width = XMLSettings::MaybeGetInt(reader, SETTING_WIDTH);
+	auto height = XMLSettings::MaybeGetInt(reader, SETTING_HEIGHT);
+
+	if (!x || !y || !width || !height)
+	{
+		return std::nullopt;
+	}
+
+	WindowShowState showState = WindowShowState::Normal;
+	XMLSettings::LoadBetterEnumValue(reader, SETTING_SHOW_STATE, showState);
+
+	auto selectedTab = XMLSettings::MaybeGetInt(reader, SETTING_SELECTED_TAB);
+	auto treeViewWidth = XMLSettings::MaybeGetInt(reader, SETTING_TREEVIEW_WIDTH);
+	auto displayWindowWidth = XMLSettings::MaybeGetInt(reader, SETTING_DISPLAY_WINDOW_WIDTH);
+	auto displayWindowHeight = XMLSettings::MaybeGetInt(reader, SETTING_DISPLAY_WINDOW_HEIGHT);
+
+	std::optional<std::vector<TabStorageData>> tabs;
+	std::optional<std::vector<RebarBandStorageInfo>> mainRebarInfo;
+	std::optional<MainToolbarStorage::MainToolbarButtons> mainToolbarButtons;
+
+	bool res = XMLSettings::ReadChildElements(reader,
+		[&tabs, &mainRebarInfo, &mainToolbarButtons](XmlReader &reader)
+		{
+			if (!tabs && reader.GetName() == TABS_NODE_NAME)
+			{
+				tabs = TabXmlStorage::Load(reader);
+				return tabs.has_value();
+			}
+			else if (!mainRebarInfo && reader.GetName() == MAIN_REBAR_NODE_NAME)
+			{
+				mainRebarInfo = MainRebarXmlStorage::Load(reader);
+				return mainRebarInfo.has_value();
+			}
+			else if (!mainToolbarButtons && reader.GetName() == MAIN_TOOLBAR_NODE_NAME)
+			{
+				mainToolbarButtons = MainToolbarStorage::LoadFromXml(reader);
+			}
+
+			return true;
+		});
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	complete = selectedTab && treeViewWidth && displayWindowWidth && displayWindowHeight && tabs
+		&& mainRebarInfo && mainToolbarButtons;
+
+	return WindowStorageData{ .bounds = { *x, *y, *x + *width, *y + *height },
+		.showState = showState,
+		.tabs = tabs.value_or(std::vector<TabStorageData>()),
+		.selectedTab = selectedTab.value_or(0),
+		.mainRebarInfo = mainRebarInfo.value_or(std::vector<RebarBandStorageInfo>()),
+		.mainToolbarButtons = mainToolbarButtons,
+		.treeViewWidth = treeViewWidth.value_or(LayoutDefaults::DEFAULT_TREEVIEW_WIDTH),
+		.displayWindowWidth =
+			displayWindowWidth.value_or(LayoutDefaults::DEFAULT_DISPLAY_WINDOW_WIDTH),
+		.displayWindowHeight =
+			displayWindowHeight.value_or(LayoutDefaults::DEFAULT_DISPLAY_WINDOW_HEIGHT) };
+}
+
+void WriteWindow(XmlWriter &writer, const WindowStorageData &window)
+{
+	writer.StartElement(WINDOW_NODE_NAME);
+	writer.WriteAttribute(SETTING_X, XMLSettings::EncodeIntValue(window.bounds.left));
+	writer.WriteAttribute(SETTING_Y, XMLSettings::EncodeIntValue(window.bounds.top));
+	writer.WriteAttribute(SETTING_WIDTH,
+		XMLSettings::EncodeIntValue(GetRectWidth(&window.bounds)));
+	writer.WriteAttribute(SETTING_HEIGHT,
+		XMLSettings::EncodeIntValue(GetRectHeight(&window.bounds)));
+	writer.WriteAttribute(SETTING_SHOW_STATE, XMLSettings::EncodeIntValue(window.showState));
+	writer.WriteAttribute(SETTING_SELECTED_TAB, XMLSettings::EncodeIntValue(window.selectedTab));
+	writer.WriteAttribute(SETTING_TREEVIEW_WIDTH,
+		XMLSettings::EncodeIntValue(window.treeViewWidth));
+	writer.WriteAttribute(SETTING_DISPLAY_WINDOW_WIDTH,
+		XMLSettings::EncodeIntValue(window.displayWindowWidth));
+	writer.WriteAttribute(SETTING_DISPLAY_WINDOW_HEIGHT,
+		XMLSettings::EncodeIntValue(window.displayWindowHeight));
+
+	writer.StartElement(TABS_NODE_NAME);
+	TabXmlStorage::Save(writer, window.tabs);
+	writer.EndElement();
+
+	writer.StartElement(MAIN_REBAR_NODE_NAME);
+	MainRebarXmlStorage::Save(writer, window.mainRebarInfo);
+	writer.EndElement();
+
+	CHECK(window.mainToolbarButtons);
+	writer.StartElement(MAIN_TOOLBAR_NODE_NAME);
+	MainToolbarStorage::SaveToXml(writer, *window.mainToolbarButtons);
+	writer.EndElement();
+
+	writer.EndElement();
+}
+
 }
 
 }
@@ -489,7 +592,7 @@ namespace WindowXmlStorage
 std::vector<WindowStorageData> Load(IXMLDOMNode *rootNode)
 {
 	wil::com_ptr_nothrow<IXMLDOMNode> windowsNode;
-	auto query = wil::make_bstr_nothrow(V2::WINDOWS_NODE_NAME);
+	auto query = wil::make_bstr_nothrow(WINDOWS_NODE_NAME);
 	HRESULT hr = rootNode->selectSingleNode(query.get(), &windowsNode);
 
 	if (hr == S_OK)
@@ -518,7 +621,7 @@ void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode,
 	const std::vector<WindowStorageData> &windows)
 {
 	wil::com_ptr_nothrow<IXMLDOMElement> windowsNode;
-	auto windowsNodeName = wil::make_bstr_nothrow(V2::WINDOWS_NODE_NAME);
+	auto windowsNodeName = wil::make_bstr_nothrow(WINDOWS_NODE_NAME);
 	HRESULT hr = xmlDocument->createElement(windowsNodeName.get(), &windowsNode);
 
 	if (hr != S_OK)
@@ -531,4 +634,56 @@ void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode,
 	XMLSettings::AppendChildToParent(windowsNode.get(), rootNode);
 }
 
+std::optional<std::vector<WindowStorageData>> Load(XmlReader &reader)
+{
+	DCHECK(reader.GetNodeType() == XmlReader::NodeType::StartElement);
+	DCHECK(reader.GetName() == WINDOWS_NODE_NAME);
+
+	std::vector<WindowStorageData> windows;
+	bool firstWindow = true;
+
+	bool res = XMLSettings::ReadChildElements(reader,
+		[&windows, &firstWindow](XmlReader &reader)
+		{
+			if (reader.GetName() != V2::WINDOW_NODE_NAME)
+			{
+				return true;
+			}
+
+			bool complete = true;
+			auto window = V2::ReadWindow(reader, complete);
+
+			if (std::exchange(firstWindow, false) && window && !complete)
+			{
+				return false;
+			}
+
+			if (window)
+			{
+				windows.push_back(std::move(*window));
+			}
+
+			return true;
+		});
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	return windows;
+}
+
+void Save(XmlWriter &writer, const std::vector<WindowStorageData> &windows)
+{
+	writer.StartElement(WINDOWS_NODE_NAME);
+
+	for (const auto &window : windows)
+	{
+		V2::WriteWindow(writer, window);
+	}
+
+	writer.EndElement();
+}
+
 }
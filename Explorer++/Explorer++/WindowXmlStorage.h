@@ -5,15 +5,29 @@
 #pragma once
 
 #include <msxml.h>
+#include <optional>
 #include <vector>
 
 struct WindowStorageData;
+class XmlReader;
+class XmlWriter;
 
 namespace WindowXmlStorage
 {
 
+static inline const wchar_t WINDOWS_NODE_NAME[] = L"Windows";
+
 std::vector<WindowStorageData> Load(IXMLDOMNode *rootNode);
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMNode *rootNode,
 	const std::vector<WindowStorageData> &windows);
 
+// The reader should be positioned on the windows start element. If the windows are read
+// successfully, the reader will be positioned on the matching end element when this returns.
+//
+// In older versions of the config file, some of the data for the first window was stored outside
+// the windows element. That data can't be retrieved here, so if the first window depends on it,
+// std::nullopt will be returned and the DOM version of Load() above should be used instead.
+std::optional<std::vector<WindowStorageData>> Load(XmlReader &reader);
+void Save(XmlWriter &writer, const std::vector<WindowStorageData> &windows);
+
 }
@@ -11,6 +11,7 @@
 #include "DefaultColumnXmlStorage.h"
 #include "DialogStorageHelper.h"
 #include "FrequentLocationsXmlStorage.h"
+#include "HistoryXmlStorage.h"
 #include "MainRebarStorage.h"
 #include "TabStorage.h"
 #include "WindowStorage.h"
@@ -67,6 +68,11 @@ void XmlAppStorage::LoadFrequentLocations(FrequentLocationsModel *frequentLocati
 	FrequentLocationsXmlStorage::Load(m_rootNode.get(), frequentLocationsModel);
 }
 
+void XmlAppStorage::LoadHistory(HistoryModel *historyModel)
+{
+	HistoryXmlStorage::Load(m_rootNode.get(), historyModel);
+}
+
 void XmlAppStorage::SaveConfig(const Config &config)
 {
 	ConfigXmlStorage::Save(m_xmlDocument.get(), m_rootNode.get(), config);
@@ -108,6 +114,11 @@ void XmlAppStorage::SaveFrequentLocations(const FrequentLocationsModel *frequent
 		frequentLocationsModel);
 }
 
+void XmlAppStorage::SaveHistory(const HistoryModel *historyModel)
+{
+	HistoryXmlStorage::Save(m_xmlDocument.get(), m_rootNode.get(), historyModel);
+}
+
 void XmlAppStorage::Commit()
 {
 	if (m_operationType != Storage::OperationType::Save)
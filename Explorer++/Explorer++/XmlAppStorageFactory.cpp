@@ -4,24 +4,38 @@
 
 #include "stdafx.h"
 #include "XmlAppStorageFactory.h"
+#include "ConfigXmlStorage.h"
+#include "HistoryXmlStreamStorage.h"
+#include "StreamingXmlAppStorage.h"
+#include "WindowXmlStorage.h"
 #include "XmlAppStorage.h"
+#include "Bookmarks/BookmarkXmlStreamStorage.h"
+#include "../Helper/StringHelper.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
+#include <fstream>
+#include <sstream>
 
-std::unique_ptr<XmlAppStorage> XmlAppStorageFactory::MaybeCreate(const std::wstring &configFilePath,
-	Storage::OperationType operationType)
+std::unique_ptr<AppStorage> XmlAppStorageFactory::MaybeCreate(const std::wstring &configFilePath,
+	Storage::OperationType operationType, Backend backend)
 {
 	if (operationType == Storage::OperationType::Load)
 	{
+		if (backend == Backend::Streaming)
+		{
+			return BuildStreamingForLoad(configFilePath);
+		}
+
 		return BuildForLoad(configFilePath);
 	}
 	else
 	{
-		return BuildForSave(configFilePath);
+		return BuildForSave(configFilePath, backend);
 	}
 }
 
-std::unique_ptr<XmlAppStorage> XmlAppStorageFactory::BuildForLoad(
-	const std::wstring &configFilePath)
+std::unique_ptr<AppStorage> XmlAppStorageFactory::BuildForLoad(const std::wstring &configFilePath)
 {
 	auto xmlDocument = XMLSettings::CreateXmlDocument();
 
@@ -39,11 +53,9 @@ std::unique_ptr<XmlAppStorage> XmlAppStorageFactory::BuildForLoad(
 		return nullptr;
 	}
 
-	wil::com_ptr_nothrow<IXMLDOMNode> rootNode;
-	auto query = wil::make_bstr_failfast(Storage::CONFIG_FILE_ROOT_NODE_NAME);
-	HRESULT hr = xmlDocument->selectSingleNode(query.get(), &rootNode);
+	auto rootNode = MaybeGetRootNode(xmlDocument.get());
 
-	if (hr != S_OK)
+	if (!rootNode)
 	{
 		return nullptr;
 	}
@@ -52,8 +64,142 @@ std::unique_ptr<XmlAppStorage> XmlAppStorageFactory::BuildForLoad(
 		Storage::OperationType::Load);
 }
 
-std::unique_ptr<XmlAppStorage> XmlAppStorageFactory::BuildForSave(
+std::unique_ptr<AppStorage> XmlAppStorageFactory::BuildStreamingForLoad(
 	const std::wstring &configFilePath)
+{
+	std::ifstream inputStream(configFilePath, std::ios::binary);
+
+	if (!inputStream)
+	{
+		return nullptr;
+	}
+
+	XmlReader reader(inputStream);
+
+	if (!reader.Read() || reader.GetName() != Storage::CONFIG_FILE_ROOT_NODE_NAME)
+	{
+		return nullptr;
+	}
+
+	// The settings, windows, bookmarks and history are parsed directly from the file. Every other
+	// section is copied into a separate (much smaller) document, which is then loaded by MSXML.
+	std::optional<ConfigXmlStorage::StreamedSettings> settings;
+	std::optional<std::vector<WindowStorageData>> windows;
+	std::optional<BookmarkXmlStreamStorage::BookmarksData> bookmarksData;
+	std::optional<std::vector<PidlAbsolute>> historyItems;
+	std::ostringstream remainingSectionsStream;
+
+	{
+		XmlWriter writer(remainingSectionsStream);
+		writer.WriteNode(reader);
+
+		while (reader.Read())
+		{
+			if (!settings && reader.GetNodeType() == XmlReader::NodeType::StartElement
+				&& reader.GetDepth() == 1
+				&& reader.GetName() == Storage::CONFIG_FILE_SETTINGS_NODE_NAME)
+			{
+				settings = ConfigXmlStorage::ReadSettings(reader);
+
+				if (!settings)
+				{
+					return nullptr;
+				}
+
+				continue;
+			}
+
+			if (!windows && reader.GetNodeType() == XmlReader::NodeType::StartElement
+				&& reader.GetDepth() == 1
+				&& reader.GetName() == WindowXmlStorage::WINDOWS_NODE_NAME)
+			{
+				windows = WindowXmlStorage::Load(reader);
+
+				if (!windows)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			if (!bookmarksData && reader.GetNodeType() == XmlReader::NodeType::StartElement
+				&& reader.GetDepth() == 1
+				&& reader.GetName() == BookmarkXmlStreamStorage::BOOKMARKS_NODE_NAME)
+			{
+				bookmarksData = BookmarkXmlStreamStorage::Load(reader);
+
+				if (!bookmarksData)
+				{
+					return nullptr;
+				}
+
+				continue;
+			}
+
+			if (!historyItems && reader.GetNodeType() == XmlReader::NodeType::StartElement
+				&& reader.GetDepth() == 1
+				&& reader.GetName() == HistoryXmlStreamStorage::HISTORY_NODE_NAME)
+			{
+				historyItems = HistoryXmlStreamStorage::Load(reader);
+
+				if (!historyItems)
+				{
+					return nullptr;
+				}
+
+				continue;
+			}
+
+			writer.WriteNode(reader);
+		}
+
+		if (reader.HasError())
+		{
+			return nullptr;
+		}
+	}
+
+	// If there's no windows section, the file may be using the v1 format, in which tabs are stored
+	// separately. A windows section may also be incomplete, in which case some of the data needs to
+	// be loaded from the v1 sections. Both cases are rare and are handled by the DOM-based loading
+	// code, so the entire file is loaded that way instead.
+	if (!windows)
+	{
+		return BuildForLoad(configFilePath);
+	}
+
+	auto xmlDocument = XMLSettings::CreateXmlDocument();
+
+	if (!xmlDocument)
+	{
+		return nullptr;
+	}
+
+	auto remainingSections =
+		wil::make_bstr_failfast(utf8StrToWstr(remainingSectionsStream.str()).c_str());
+	VARIANT_BOOL status;
+	xmlDocument->loadXML(remainingSections.get(), &status);
+
+	if (status != VARIANT_TRUE)
+	{
+		return nullptr;
+	}
+
+	auto rootNode = MaybeGetRootNode(xmlDocument.get());
+
+	if (!rootNode)
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<StreamingXmlAppStorage>(xmlDocument, rootNode, configFilePath,
+		Storage::OperationType::Load, std::move(settings), std::move(windows),
+		std::move(bookmarksData), std::move(historyItems));
+}
+
+std::unique_ptr<AppStorage> XmlAppStorageFactory::BuildForSave(const std::wstring &configFilePath,
+	Backend backend)
 {
 	auto xmlDocument = XMLSettings::CreateXmlDocument();
 
@@ -84,6 +230,27 @@ std::unique_ptr<XmlAppStorage> XmlAppStorageFactory::BuildForSave(
 
 	XMLSettings::AppendChildToParent(rootNode.get(), xmlDocument.get());
 
+	if (backend == Backend::Streaming)
+	{
+		return std::make_unique<StreamingXmlAppStorage>(xmlDocument, rootNode, configFilePath,
+			Storage::OperationType::Save, std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+	}
+
 	return std::make_unique<XmlAppStorage>(xmlDocument, rootNode, configFilePath,
 		Storage::OperationType::Save);
 }
+
+wil::com_ptr_nothrow<IXMLDOMNode> XmlAppStorageFactory::MaybeGetRootNode(
+	IXMLDOMDocument *xmlDocument)
+{
+	wil::com_ptr_nothrow<IXMLDOMNode> rootNode;
+	auto query = wil::make_bstr_failfast(Storage::CONFIG_FILE_ROOT_NODE_NAME);
+	HRESULT hr = xmlDocument->selectSingleNode(query.get(), &rootNode);
+
+	if (hr != S_OK)
+	{
+		return nullptr;
+	}
+
+	return rootNode;
+}
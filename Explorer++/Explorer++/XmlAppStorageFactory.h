@@ -5,17 +5,34 @@
 #pragma once
 
 #include "Storage.h"
+#include <wil/com.h>
+#include <MsXml2.h>
 #include <memory>
 
-class XmlAppStorage;
+class AppStorage;
 
 class XmlAppStorageFactory
 {
 public:
-	static std::unique_ptr<XmlAppStorage> MaybeCreate(const std::wstring &configFilePath,
-		Storage::OperationType operationType);
+	enum class Backend
+	{
+		// The entire config file is loaded into (and saved from) an MSXML document.
+		MsXml,
+
+		// The config file is read and written using XmlReader/XmlWriter. The settings, windows,
+		// bookmarks and history are handled without building a DOM at all. See
+		// StreamingXmlAppStorage.
+		Streaming
+	};
+
+	static std::unique_ptr<AppStorage> MaybeCreate(const std::wstring &configFilePath,
+		Storage::OperationType operationType, Backend backend = Backend::MsXml);
 
 private:
-	static std::unique_ptr<XmlAppStorage> BuildForLoad(const std::wstring &configFilePath);
-	static std::unique_ptr<XmlAppStorage> BuildForSave(const std::wstring &configFilePath);
+	static std::unique_ptr<AppStorage> BuildForLoad(const std::wstring &configFilePath);
+	static std::unique_ptr<AppStorage> BuildStreamingForLoad(const std::wstring &configFilePath);
+	static std::unique_ptr<AppStorage> BuildForSave(const std::wstring &configFilePath,
+		Backend backend);
+
+	static wil::com_ptr_nothrow<IXMLDOMNode> MaybeGetRootNode(IXMLDOMDocument *xmlDocument);
 };
@@ -269,6 +269,19 @@
 #define IDS_ORGANIZE_BOOKMARKS_CXMENU_PASTE 471
 #define IDS_ORGANIZE_BOOKMARKS_CXMENU_DELETE 472
 #define IDS_ORGANIZE_BOOKMARKS_CXMENU_SELECT_ALL 473
+#define IDD_TAB_MEMORY                  474
+#define IDS_TAB_MEMORY_COLUMN_TAB_NAME  475
+#define IDS_TAB_MEMORY_COLUMN_PATH      476
+#define IDS_TAB_MEMORY_COLUMN_ITEMS     477
+#define IDS_TAB_MEMORY_COLUMN_THUMBNAILS 478
+#define IDS_TAB_MEMORY_COLUMN_HISTORY   479
+#define IDS_TAB_MEMORY_COLUMN_PENDING_RESULTS 480
+#define IDS_TAB_MEMORY_COLUMN_TOTAL     481
+#define IDS_TAB_MEMORY_COLUMN_STATUS    482
+#define IDS_TAB_MEMORY_STATUS_LOADED    483
+#define IDS_TAB_MEMORY_STATUS_DISCARDED 484
+#define IDS_TAB_MEMORY_SUMMARY          485
+#define IDS_TAB_MEMORY_NO_BUDGET        486
 #define IDC_DEFAULTCOLUMNS_DESCRIPTION  1001
 #define IDC_COLUMNS_DESCRIPTION         1001
 #define IDC_SETTINGS_CHECK_EXTENSIONS   1002
@@ -493,6 +506,9 @@
 #define IDC_OPTIONS_MAIN_FONT           1373
 #define IDC_STARTUP_CUSTOM_FOLDERS      1374
 #define IDC_STARTUP_CUSTOM_FOLDERS_LIST 1375
+#define IDC_TAB_MEMORY_TAB_LIST         1376
+#define IDC_TAB_MEMORY_SUMMARY          1377
+#define IDC_TAB_MEMORY_REFRESH          1378
 #define IDS_COLUMN_DESCRIPTION_NAME     2000
 #define IDS_COLUMN_DESCRIPTION_TYPE     2001
 #define IDS_COLUMN_DESCRIPTION_SIZE     2002
@@ -908,6 +924,7 @@
 #define IDM_ORGANIZE_BOOKMARKS_CXMENU_PASTE 40600
 #define IDM_ORGANIZE_BOOKMARKS_CXMENU_DELETE 40601
 #define IDM_ORGANIZE_BOOKMARKS_CXMENU_SELECT_ALL 40602
+#define IDM_WINDOW_TAB_MEMORY           40603
 #define IDM_SORTBY_NAME                 50000
 #define IDM_SORTBY_SIZE                 50001
 #define IDM_SORTBY_TYPE                 50002
@@ -1054,9 +1071,9 @@
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
-#define _APS_NEXT_RESOURCE_VALUE        474
-#define _APS_NEXT_COMMAND_VALUE         40603
-#define _APS_NEXT_CONTROL_VALUE         1376
+#define _APS_NEXT_RESOURCE_VALUE        487
+#define _APS_NEXT_COMMAND_VALUE         40604
+#define _APS_NEXT_CONTROL_VALUE         1379
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -26,7 +26,6 @@
 #include "../Helper/DisableUnaligned.h"
 
 // Third-party Header Files:
-#include "../ThirdParty/CTPL/cpl_stl.h"
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/memory.hpp>
 #include <cereal/types/string.hpp>
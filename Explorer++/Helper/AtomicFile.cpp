@@ -0,0 +1,78 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "AtomicFile.h"
+#include <wil/resource.h>
+#include <algorithm>
+
+namespace AtomicFile
+{
+
+namespace
+{
+
+bool WriteAll(HANDLE file, std::string_view data)
+{
+	while (!data.empty())
+	{
+		auto chunkSize = static_cast<DWORD>(std::min<size_t>(data.size(), 64 * 1024 * 1024));
+		DWORD numBytesWritten;
+		BOOL res = WriteFile(file, data.data(), chunkSize, &numBytesWritten, nullptr);
+
+		if (!res || numBytesWritten != chunkSize)
+		{
+			return false;
+		}
+
+		data.remove_prefix(chunkSize);
+	}
+
+	return true;
+}
+
+}
+
+bool Write(const std::wstring &path, std::span<const std::string_view> chunks)
+{
+	std::wstring temporaryPath = path + L".tmp";
+
+	{
+		wil::unique_hfile file(CreateFile(temporaryPath.c_str(), GENERIC_WRITE, 0, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+		if (!file)
+		{
+			return false;
+		}
+
+		bool success = std::ranges::all_of(chunks,
+			[&file](std::string_view chunk) { return WriteAll(file.get(), chunk); });
+
+		// The data has to reach the disk before the file is moved into place. Otherwise, a crash
+		// shortly after the move could leave behind an empty or partially written file.
+		if (!success || !FlushFileBuffers(file.get()))
+		{
+			file.reset();
+			DeleteFile(temporaryPath.c_str());
+			return false;
+		}
+	}
+
+	if (!MoveFileEx(temporaryPath.c_str(), path.c_str(),
+			MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DeleteFile(temporaryPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool Write(const std::wstring &path, std::string_view contents)
+{
+	return Write(path, std::span(&contents, 1));
+}
+
+}
@@ -0,0 +1,22 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+
+// Replaces the contents of a file. The new contents are written to a temporary file, which is
+// flushed to disk and then moved into place. That means the existing file is only ever replaced by
+// a complete copy of the new contents, even if the process (or system) stops part way through.
+namespace AtomicFile
+{
+
+// The chunks are written one after the other, so that data that's held in separate buffers (e.g.
+// a header and a payload) doesn't have to be concatenated first.
+bool Write(const std::wstring &path, std::span<const std::string_view> chunks);
+bool Write(const std::wstring &path, std::string_view contents);
+
+}
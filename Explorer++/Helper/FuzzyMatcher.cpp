@@ -0,0 +1,147 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FuzzyMatcher.h"
+#include <algorithm>
+
+FuzzyMatcher::FuzzyMatcher(std::wstring_view query) : m_query(NormalizeText(query))
+{
+}
+
+const std::wstring &FuzzyMatcher::GetQuery() const
+{
+	return m_query;
+}
+
+std::optional<int> FuzzyMatcher::Match(std::wstring_view normalizedText) const
+{
+	if (m_query.empty())
+	{
+		return 0;
+	}
+
+	if (m_query.size() > normalizedText.size())
+	{
+		return std::nullopt;
+	}
+
+	int score = 0;
+
+	// A contiguous match is always preferred. Matching greedily from the left would otherwise
+	// produce a scattered match in a case like "doc" in "c:\windows\documents".
+	if (auto substringIndex = FindSubstring(normalizedText))
+	{
+		score = SUBSTRING_BONUS + static_cast<int>(m_query.size()) * CHARACTER_SCORE
+			+ static_cast<int>(m_query.size() - 1) * CONSECUTIVE_BONUS;
+
+		if (IsWordStart(normalizedText, *substringIndex))
+		{
+			score += WORD_START_BONUS;
+		}
+
+		return score;
+	}
+
+	std::optional<size_t> previousIndex;
+	size_t textIndex = 0;
+
+	for (auto queryChar : m_query)
+	{
+		auto index = normalizedText.find(queryChar, textIndex);
+
+		if (index == std::wstring_view::npos)
+		{
+			return std::nullopt;
+		}
+
+		score += CHARACTER_SCORE;
+
+		if (IsWordStart(normalizedText, index))
+		{
+			score += WORD_START_BONUS;
+		}
+
+		if (previousIndex)
+		{
+			size_t gap = index - *previousIndex - 1;
+
+			if (gap == 0)
+			{
+				score += CONSECUTIVE_BONUS;
+			}
+			else
+			{
+				score -= static_cast<int>(std::min(gap, static_cast<size_t>(MAX_GAP_PENALTY)));
+			}
+		}
+
+		previousIndex = index;
+		textIndex = index + 1;
+	}
+
+	return score;
+}
+
+std::optional<size_t> FuzzyMatcher::FindSubstring(std::wstring_view normalizedText) const
+{
+	std::optional<size_t> firstIndex;
+
+	for (auto index = normalizedText.find(m_query); index != std::wstring_view::npos;
+		index = normalizedText.find(m_query, index + 1))
+	{
+		// An occurrence at the start of a word is the best possible match, so there's no need to
+		// continue searching once one is found.
+		if (IsWordStart(normalizedText, index))
+		{
+			return index;
+		}
+
+		if (!firstIndex)
+		{
+			firstIndex = index;
+		}
+	}
+
+	return firstIndex;
+}
+
+bool FuzzyMatcher::IsWordStart(std::wstring_view text, size_t index)
+{
+	if (index == 0)
+	{
+		return true;
+	}
+
+	switch (text[index - 1])
+	{
+	case L' ':
+	case L'\\':
+	case L'/':
+	case L'_':
+	case L'-':
+	case L'.':
+	case L':':
+		return true;
+	}
+
+	return false;
+}
+
+bool FuzzyMatcher::Refines(const FuzzyMatcher &other) const
+{
+	return m_query.starts_with(other.m_query);
+}
+
+std::wstring FuzzyMatcher::NormalizeText(std::wstring_view text)
+{
+	std::wstring normalizedText(text);
+
+	if (!normalizedText.empty())
+	{
+		CharLowerBuff(normalizedText.data(), static_cast<DWORD>(normalizedText.size()));
+	}
+
+	return normalizedText;
+}
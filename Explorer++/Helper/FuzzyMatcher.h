@@ -0,0 +1,51 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Performs ranked, case-insensitive fuzzy matching of a query against a piece of text. The text
+// matches if every character in the query appears in the text, in the same order (though not
+// necessarily contiguously). For example, "dcmnts" will match "c:\users\documents".
+//
+// Each match is given a score, with higher scores indicating better matches. Contiguous matches
+// score highest, followed by matches where the query characters appear at the start of words.
+//
+// To avoid repeatedly lowercasing the same text, the text passed to Match() is expected to have
+// already been normalized, via NormalizeText(). Callers can cache the normalized text and reuse it
+// across queries.
+class FuzzyMatcher
+{
+public:
+	explicit FuzzyMatcher(std::wstring_view query);
+
+	// Returns the normalized query.
+	const std::wstring &GetQuery() const;
+
+	// Returns the score for the text, if it matches, or std::nullopt, if it doesn't. An empty query
+	// matches everything, with a score of 0.
+	std::optional<int> Match(std::wstring_view normalizedText) const;
+
+	// Returns true if any text matched by this matcher is guaranteed to also be matched by the
+	// other matcher. That's the case when this query extends the other query. Callers can use that
+	// to narrow a previous set of results, rather than re-matching everything.
+	bool Refines(const FuzzyMatcher &other) const;
+
+	static std::wstring NormalizeText(std::wstring_view text);
+
+private:
+	static constexpr int CHARACTER_SCORE = 1;
+	static constexpr int CONSECUTIVE_BONUS = 4;
+	static constexpr int WORD_START_BONUS = 8;
+	static constexpr int SUBSTRING_BONUS = 32;
+	static constexpr int MAX_GAP_PENALTY = 8;
+
+	std::optional<size_t> FindSubstring(std::wstring_view normalizedText) const;
+	static bool IsWordStart(std::wstring_view text, size_t index);
+
+	const std::wstring m_query;
+};
@@ -0,0 +1,208 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "InternedPidl.h"
+#include <boost/container_hash/hash.hpp>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+struct InternedPidl::Node
+{
+	std::shared_ptr<const Node> parent;
+
+	// The raw SHITEMID for this item, including the leading size field.
+	std::string item;
+};
+
+struct PidlStore::Impl : public std::enable_shared_from_this<Impl>
+{
+	using Node = InternedPidl::Node;
+
+	// The item data in the key refers to the string held by the node itself, so that the data
+	// isn't stored twice.
+	struct Key
+	{
+		const Node *parent;
+		std::string_view item;
+
+		bool operator==(const Key &) const = default;
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key &key) const
+		{
+			size_t seed = 0;
+			boost::hash_combine(seed, key.parent);
+			boost::hash_combine(seed, std::hash<std::string_view>{}(key.item));
+			return seed;
+		}
+	};
+
+	struct Entry
+	{
+		const Node *node;
+		std::weak_ptr<const Node> weakNode;
+	};
+
+	// An estimate of the fixed cost of each node: the node itself, the shared_ptr control block
+	// and the hash table entry.
+	static constexpr size_t PER_NODE_OVERHEAD =
+		sizeof(Node) + (4 * sizeof(void *)) + sizeof(Key) + sizeof(Entry) + (2 * sizeof(void *));
+
+	std::shared_ptr<const Node> GetOrCreateNode(std::shared_ptr<const Node> parent,
+		std::string_view item);
+	void RemoveNode(const Node *node);
+
+	mutable std::mutex mutex;
+	std::unordered_map<Key, Entry, KeyHash> nodes;
+	size_t itemBytes = 0;
+};
+
+std::shared_ptr<const InternedPidl::Node> PidlStore::Impl::GetOrCreateNode(
+	std::shared_ptr<const Node> parent, std::string_view item)
+{
+	std::scoped_lock lock(mutex);
+
+	auto itr = nodes.find({ parent.get(), item });
+
+	if (itr != nodes.end())
+	{
+		if (auto existingNode = itr->second.weakNode.lock())
+		{
+			return existingNode;
+		}
+
+		// The last reference to the node has been released, but the node hasn't been removed yet.
+		// When it is, the entry won't match and will be left alone.
+		nodes.erase(itr);
+	}
+
+	auto *rawNode = new Node{ std::move(parent), std::string(item) };
+
+	// The node is removed from the map before it's deleted. The node is deleted outside the lock,
+	// since that may release the last reference to the parent node, which will then need to be
+	// removed as well.
+	std::shared_ptr<const Node> node(rawNode,
+		[weakImpl = weak_from_this()](const Node *nodeToDelete)
+		{
+			if (auto impl = weakImpl.lock())
+			{
+				impl->RemoveNode(nodeToDelete);
+			}
+
+			delete nodeToDelete;
+		});
+
+	nodes.insert({ { rawNode->parent.get(), rawNode->item }, { rawNode, node } });
+	itemBytes += rawNode->item.size();
+
+	return node;
+}
+
+void PidlStore::Impl::RemoveNode(const Node *node)
+{
+	std::scoped_lock lock(mutex);
+
+	auto itr = nodes.find({ node->parent.get(), node->item });
+
+	if (itr != nodes.end() && itr->second.node == node)
+	{
+		nodes.erase(itr);
+	}
+
+	itemBytes -= node->item.size();
+}
+
+PidlStore::PidlStore() : m_impl(std::make_shared<Impl>())
+{
+}
+
+PidlStore &PidlStore::GetDefault()
+{
+	static PidlStore store;
+	return store;
+}
+
+InternedPidl PidlStore::Intern(PCIDLIST_ABSOLUTE pidl)
+{
+	if (!pidl)
+	{
+		return {};
+	}
+
+	std::shared_ptr<const InternedPidl::Node> node;
+
+	for (auto *item = pidl; !ILIsEmpty(item); item = ILNext(item))
+	{
+		std::string_view itemData(reinterpret_cast<const char *>(item), item->mkid.cb);
+		node = m_impl->GetOrCreateNode(std::move(node), itemData);
+	}
+
+	// Note that the desktop pidl contains no items, so will be represented by an empty node.
+	return InternedPidl(std::move(node));
+}
+
+InternedPidl PidlStore::Intern(const PidlAbsolute &pidl)
+{
+	return Intern(pidl.Raw());
+}
+
+size_t PidlStore::GetNumNodes() const
+{
+	std::scoped_lock lock(m_impl->mutex);
+	return m_impl->nodes.size();
+}
+
+size_t PidlStore::GetMemoryUsage() const
+{
+	std::scoped_lock lock(m_impl->mutex);
+	return (m_impl->nodes.size() * Impl::PER_NODE_OVERHEAD) + m_impl->itemBytes;
+}
+
+InternedPidl::InternedPidl(std::shared_ptr<const Node> node) :
+	m_node(std::move(node)),
+	m_hasValue(true)
+{
+}
+
+bool InternedPidl::HasValue() const
+{
+	return m_hasValue;
+}
+
+PidlAbsolute InternedPidl::ToPidl() const
+{
+	if (!m_hasValue)
+	{
+		return {};
+	}
+
+	std::vector<const Node *> items;
+	size_t size = sizeof(USHORT);
+
+	for (const auto *node = m_node.get(); node; node = node->parent.get())
+	{
+		items.push_back(node);
+		size += node->item.size();
+	}
+
+	auto *data = static_cast<BYTE *>(CoTaskMemAlloc(size));
+	CHECK(data);
+
+	BYTE *current = data;
+
+	for (auto itr = items.rbegin(); itr != items.rend(); ++itr)
+	{
+		memcpy(current, (*itr)->item.data(), (*itr)->item.size());
+		current += (*itr)->item.size();
+	}
+
+	// The list is terminated by an item with a size of 0.
+	memset(current, 0, sizeof(USHORT));
+
+	return PidlAbsolute(reinterpret_cast<PIDLIST_ABSOLUTE>(data), Pidl::takeOwnership);
+}
@@ -0,0 +1,68 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "PidlHelper.h"
+#include <boost/core/noncopyable.hpp>
+#include <memory>
+
+class PidlStore;
+
+// A compact, immutable reference to a pidl held in a PidlStore. Copying an instance only copies a
+// reference, so the same pidl can be retained in many places (e.g. in navigation history) without
+// the underlying data being duplicated.
+class InternedPidl
+{
+public:
+	InternedPidl() = default;
+
+	bool HasValue() const;
+
+	// Reconstructs a full copy of the pidl.
+	PidlAbsolute ToPidl() const;
+
+	// Two pidls interned in the same store are equal if and only if their contents are equal, so
+	// this is a simple reference comparison.
+	bool operator==(const InternedPidl &other) const = default;
+
+private:
+	friend class PidlStore;
+
+	struct Node;
+
+	explicit InternedPidl(std::shared_ptr<const Node> node);
+
+	std::shared_ptr<const Node> m_node;
+	bool m_hasValue = false;
+};
+
+// Stores pidls in a deduplicated form. Each pidl is split into its individual items, with each
+// item stored as a node that references the node for its parent. Nodes are shared, so pidls that
+// have a common prefix (e.g. items within the same folder) will share the storage for that prefix,
+// while interning an identical pidl more than once will return a reference to the same node.
+//
+// Nodes are reference-counted and are removed from the store once the last InternedPidl that
+// refers to them is destroyed. This class can be used from multiple threads.
+class PidlStore : private boost::noncopyable
+{
+public:
+	PidlStore();
+
+	// Returns the store that's shared across the application.
+	static PidlStore &GetDefault();
+
+	InternedPidl Intern(PCIDLIST_ABSOLUTE pidl);
+	InternedPidl Intern(const PidlAbsolute &pidl);
+
+	size_t GetNumNodes() const;
+
+	// Returns the approximate number of bytes currently used to hold all interned pidls.
+	size_t GetMemoryUsage() const;
+
+private:
+	struct Impl;
+
+	std::shared_ptr<Impl> m_impl;
+};
@@ -0,0 +1,364 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature>
+class IntrusiveSignal;
+
+// A lightweight, single-threaded alternative to boost::signals2::signal.
+//
+// boost::signals2 is thread-safe, which means that each signal carries a mutex and a heap-allocated
+// slot list, each connection is separately heap-allocated and every emission takes a lock. That's
+// a significant amount of overhead for signals that are embedded in large numbers of small objects
+// (e.g. one signal per item in a model) and which are only ever used on the UI thread.
+//
+// In this class, each observer owns the storage for its own connection (the returned Connection
+// object) and the signal simply links those connections together. That means:
+//
+// - Connecting and emitting never allocate.
+// - The signal itself is three pointers in size.
+// - There's no locking.
+//
+// The trade-offs are:
+//
+// - The signal must only be used on a single thread.
+// - Only void signatures are supported; there are no combiners.
+// - The observer callback is stored inline within the connection, so it needs to be small (e.g. a
+//   lambda or std::bind_front() call capturing a few pointers).
+// - The returned Connection must be kept alive for as long as the observer should remain
+//   connected. That's equivalent to using boost::signals2::scoped_connection.
+//
+// It's safe for an observer to connect or disconnect any observer (including itself) during an
+// emission, as well as to emit the signal recursively. Observers connected during an emission won't
+// be notified until the next emission. The signal must not be destroyed while it's being emitted.
+// A connection can also be moved while its own observer is running (e.g. because the observer
+// reorders the container the connection is stored in), provided the observer doesn't access any of
+// its captured state after the move.
+//
+// Migrating an existing signal:
+//
+// 1. Replace the boost::signals2::signal member (or SignalWrapper) with IntrusiveSignal (or
+//    IntrusiveSignalWrapper). Emission syntax is unchanged.
+// 2. Change the return type of the relevant AddObserver() method to IntrusiveSignal::Connection.
+// 3. Store the returned connection in the observer, in place of the
+//    boost::signals2::scoped_connection it would previously have used. Any observer that previously
+//    discarded the connection (relying on the signal being destroyed first) now needs to retain
+//    it.
+template <typename... Args>
+class IntrusiveSignal<void(Args...)>
+{
+public:
+	class Connection
+	{
+	public:
+		Connection() = default;
+
+		Connection(Connection &&other) noexcept
+		{
+			MoveFrom(other);
+		}
+
+		Connection &operator=(Connection &&other) noexcept
+		{
+			if (this != &other)
+			{
+				Disconnect();
+				MoveFrom(other);
+			}
+
+			return *this;
+		}
+
+		Connection(const Connection &) = delete;
+		Connection &operator=(const Connection &) = delete;
+
+		~Connection()
+		{
+			Disconnect();
+		}
+
+		void Disconnect()
+		{
+			if (m_signal)
+			{
+				m_signal->Unlink(this);
+				m_signal = nullptr;
+			}
+
+			if (m_operations)
+			{
+				m_operations->destroy(m_storage);
+				m_operations = nullptr;
+			}
+		}
+
+		bool IsConnected() const
+		{
+			return m_signal != nullptr;
+		}
+
+	private:
+		friend IntrusiveSignal;
+
+		static constexpr size_t STORAGE_SIZE = 4 * sizeof(void *);
+
+		struct Operations
+		{
+			void (*invoke)(void *storage, Args... args);
+			void (*relocate)(void *destination, void *source);
+			void (*destroy)(void *storage);
+		};
+
+		template <typename Callback>
+		static constexpr Operations OPERATIONS = {
+			[](void *storage, Args... args)
+			{ (*static_cast<Callback *>(storage))(std::forward<Args>(args)...); },
+			[](void *destination, void *source)
+			{
+				auto *sourceCallback = static_cast<Callback *>(source);
+				new (destination) Callback(std::move(*sourceCallback));
+				sourceCallback->~Callback();
+			},
+			[](void *storage) { static_cast<Callback *>(storage)->~Callback(); }
+		};
+
+		template <typename Callback>
+		Connection(IntrusiveSignal *signal, Callback &&callback)
+		{
+			using StoredCallback = std::decay_t<Callback>;
+
+			static_assert(sizeof(StoredCallback) <= STORAGE_SIZE,
+				"The callback is too large to be stored inline. Capture less state.");
+			static_assert(alignof(StoredCallback) <= alignof(void *),
+				"The callback has an unsupported alignment.");
+			static_assert(std::is_nothrow_move_constructible_v<StoredCallback>,
+				"The callback must be nothrow move constructible.");
+
+			new (m_storage) StoredCallback(std::forward<Callback>(callback));
+			m_operations = &OPERATIONS<StoredCallback>;
+
+			m_signal = signal;
+			m_signal->Link(this);
+		}
+
+		void MoveFrom(Connection &other)
+		{
+			if (other.m_operations)
+			{
+				other.m_operations->relocate(m_storage, other.m_storage);
+				m_operations = std::exchange(other.m_operations, nullptr);
+			}
+
+			if (other.m_signal)
+			{
+				m_signal = std::exchange(other.m_signal, nullptr);
+				m_signal->Replace(&other, this);
+			}
+		}
+
+		void Invoke(Args... args)
+		{
+			m_operations->invoke(m_storage, std::forward<Args>(args)...);
+		}
+
+		IntrusiveSignal *m_signal = nullptr;
+		Connection *m_previous = nullptr;
+		Connection *m_next = nullptr;
+		const Operations *m_operations = nullptr;
+		alignas(void *) std::byte m_storage[STORAGE_SIZE];
+	};
+
+	IntrusiveSignal() = default;
+
+	IntrusiveSignal(const IntrusiveSignal &) = delete;
+	IntrusiveSignal(IntrusiveSignal &&) = delete;
+	IntrusiveSignal &operator=(const IntrusiveSignal &) = delete;
+	IntrusiveSignal &operator=(IntrusiveSignal &&) = delete;
+
+	~IntrusiveSignal()
+	{
+		DCHECK(!m_emissions);
+
+		DisconnectAll();
+	}
+
+	template <typename Callback>
+	[[nodiscard]] Connection AddObserver(Callback &&callback)
+	{
+		return Connection(this, std::forward<Callback>(callback));
+	}
+
+	void DisconnectAll()
+	{
+		while (m_head)
+		{
+			m_head->Disconnect();
+		}
+	}
+
+	bool HasObservers() const
+	{
+		return m_head != nullptr;
+	}
+
+	void operator()(Args... args)
+	{
+		if (!m_head)
+		{
+			return;
+		}
+
+		// Observers that are connected during the emission are added after the current tail and
+		// so won't be visited here.
+		Emission emission = { m_head, m_tail, m_emissions };
+		m_emissions = &emission;
+
+		while (emission.next)
+		{
+			Connection *current = emission.next;
+			emission.next = (current == emission.last) ? nullptr : current->m_next;
+
+			// Arguments are deliberately not forwarded as rvalues here, since they're passed to
+			// each observer in turn.
+			current->Invoke(static_cast<Args>(args)...);
+		}
+
+		m_emissions = emission.outer;
+	}
+
+private:
+	// Tracks the position of an in-progress emission, so that the connection list can be modified
+	// while the signal is being emitted. Instances are stack allocated.
+	struct Emission
+	{
+		Connection *next;
+		Connection *last;
+		Emission *outer;
+	};
+
+	void Link(Connection *connection)
+	{
+		connection->m_previous = m_tail;
+		connection->m_next = nullptr;
+
+		if (m_tail)
+		{
+			m_tail->m_next = connection;
+		}
+		else
+		{
+			m_head = connection;
+		}
+
+		m_tail = connection;
+	}
+
+	void Unlink(Connection *connection)
+	{
+		for (auto *emission = m_emissions; emission; emission = emission->outer)
+		{
+			if (emission->next == connection)
+			{
+				emission->next = (connection == emission->last) ? nullptr : connection->m_next;
+			}
+
+			if (emission->last == connection)
+			{
+				emission->last = connection->m_previous;
+			}
+		}
+
+		if (connection->m_previous)
+		{
+			connection->m_previous->m_next = connection->m_next;
+		}
+		else
+		{
+			m_head = connection->m_next;
+		}
+
+		if (connection->m_next)
+		{
+			connection->m_next->m_previous = connection->m_previous;
+		}
+		else
+		{
+			m_tail = connection->m_previous;
+		}
+
+		connection->m_previous = nullptr;
+		connection->m_next = nullptr;
+	}
+
+	void Replace(Connection *oldConnection, Connection *newConnection)
+	{
+		for (auto *emission = m_emissions; emission; emission = emission->outer)
+		{
+			if (emission->next == oldConnection)
+			{
+				emission->next = newConnection;
+			}
+
+			if (emission->last == oldConnection)
+			{
+				emission->last = newConnection;
+			}
+		}
+
+		newConnection->m_previous = std::exchange(oldConnection->m_previous, nullptr);
+		newConnection->m_next = std::exchange(oldConnection->m_next, nullptr);
+
+		if (newConnection->m_previous)
+		{
+			newConnection->m_previous->m_next = newConnection;
+		}
+		else
+		{
+			m_head = newConnection;
+		}
+
+		if (newConnection->m_next)
+		{
+			newConnection->m_next->m_previous = newConnection;
+		}
+		else
+		{
+			m_tail = newConnection;
+		}
+	}
+
+	Connection *m_head = nullptr;
+	Connection *m_tail = nullptr;
+	Emission *m_emissions = nullptr;
+};
+
+// The equivalent of SignalWrapper, for an IntrusiveSignal.
+template <class EmbeddingClassType, typename SignalSignature>
+class IntrusiveSignalWrapper
+{
+	friend EmbeddingClassType;
+
+public:
+	using Signal = IntrusiveSignal<SignalSignature>;
+
+	IntrusiveSignalWrapper() = default;
+
+	template <typename Callback>
+	[[nodiscard]] typename Signal::Connection AddObserver(Callback &&callback)
+	{
+		return m_signal.AddObserver(std::forward<Callback>(callback));
+	}
+
+private:
+	IntrusiveSignalWrapper &operator=(const IntrusiveSignalWrapper &) = delete;
+	IntrusiveSignalWrapper(const IntrusiveSignalWrapper &) = delete;
+
+	Signal m_signal;
+};
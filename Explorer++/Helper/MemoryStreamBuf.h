@@ -0,0 +1,21 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <streambuf>
+#include <string_view>
+
+// A read-only stream buffer over an existing block of memory. This allows data (e.g. from a
+// memory-mapped file) to be read through a std::istream without first being copied.
+class MemoryStreamBuf : public std::streambuf
+{
+public:
+	explicit MemoryStreamBuf(std::string_view data)
+	{
+		// The buffer is never written to; setg() simply requires a non-const pointer.
+		auto *begin = const_cast<char *>(data.data());
+		setg(begin, begin, begin + data.size());
+	}
+};
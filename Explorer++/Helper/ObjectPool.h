@@ -0,0 +1,178 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/core/noncopyable.hpp>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+
+// A pool allocator for objects of a single type. Memory is allocated in slabs, each of which holds
+// a fixed number of objects. Freed objects are added to their slab's free list and their memory is
+// reused by subsequent allocations. That means that creating and destroying a large number of
+// objects (e.g. when expanding and collapsing a large folder in a tree) doesn't result in a call to
+// the general purpose allocator for each object.
+//
+// Allocations are made from the lowest addressed slab that has space, so that the objects that are
+// alive tend to be concentrated in a small number of slabs. A slab is released as soon as all of
+// its objects have been freed, except that a single empty slab is retained, so that repeatedly
+// allocating and freeing an object at a slab boundary doesn't allocate and release a slab each
+// time.
+//
+// Note that this class only manages memory; constructing and destroying the objects is up to the
+// caller. This class isn't thread-safe.
+template <typename T, size_t ObjectsPerSlab = 1024>
+class ObjectPool : private boost::noncopyable
+{
+public:
+	static_assert(ObjectsPerSlab > 0);
+
+	void *Allocate()
+	{
+		if (m_slabsWithFreeSlots.empty())
+		{
+			AddSlab();
+		}
+
+		Slab *slab = *m_slabsWithFreeSlots.begin();
+
+		if (slab == m_emptySlab)
+		{
+			m_emptySlab = nullptr;
+		}
+
+		Slot *slot = slab->freeList;
+		slab->freeList = slot->next;
+		slab->numAllocatedObjects++;
+
+		if (!slab->freeList)
+		{
+			m_slabsWithFreeSlots.erase(slab);
+		}
+
+		m_numAllocatedObjects++;
+
+		return slot->storage;
+	}
+
+	void Deallocate(void *object)
+	{
+		CHECK_GT(m_numAllocatedObjects, 0u);
+
+		auto *slot = reinterpret_cast<Slot *>(object);
+		Slab *slab = FindSlab(slot);
+
+		if (!slab->freeList)
+		{
+			m_slabsWithFreeSlots.insert(slab);
+		}
+
+		slot->next = slab->freeList;
+		slab->freeList = slot;
+		slab->numAllocatedObjects--;
+		m_numAllocatedObjects--;
+
+		if (slab->numAllocatedObjects == 0)
+		{
+			OnSlabEmpty(slab);
+		}
+	}
+
+	size_t GetNumAllocatedObjects() const
+	{
+		return m_numAllocatedObjects;
+	}
+
+	size_t GetNumSlabs() const
+	{
+		return m_slabs.size();
+	}
+
+private:
+	union Slot
+	{
+		Slot *next;
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+	struct Slab
+	{
+		std::unique_ptr<Slot[]> slots;
+		Slot *freeList = nullptr;
+		size_t numAllocatedObjects = 0;
+	};
+
+	struct SlabAddressComparator
+	{
+		bool operator()(const Slab *slab1, const Slab *slab2) const
+		{
+			return std::less<const Slot *>()(slab1->slots.get(), slab2->slots.get());
+		}
+	};
+
+	void AddSlab()
+	{
+		auto slab = std::make_unique<Slab>();
+		slab->slots = std::make_unique_for_overwrite<Slot[]>(ObjectsPerSlab);
+
+		for (size_t i = 0; i < ObjectsPerSlab; i++)
+		{
+			slab->slots[i].next = (i + 1 < ObjectsPerSlab) ? &slab->slots[i + 1] : nullptr;
+		}
+
+		slab->freeList = &slab->slots[0];
+
+		auto [itr, didInsert] = m_slabs.emplace(slab->slots.get(), std::move(slab));
+		DCHECK(didInsert);
+
+		m_slabsWithFreeSlots.insert(itr->second.get());
+	}
+
+	Slab *FindSlab(const Slot *slot) const
+	{
+		// The slabs are keyed by the address of their first slot, so the slab containing this slot
+		// is the last one that starts at, or before, the slot.
+		auto itr = m_slabs.upper_bound(slot);
+		CHECK(itr != m_slabs.begin());
+		--itr;
+
+		CHECK(std::less<const Slot *>()(slot, itr->first + ObjectsPerSlab));
+
+		return itr->second.get();
+	}
+
+	void OnSlabEmpty(Slab *slab)
+	{
+		if (!m_emptySlab)
+		{
+			m_emptySlab = slab;
+			return;
+		}
+
+		// There's already an empty slab being retained, so this one can be released. The retained
+		// slab is swapped for this one if this one has a lower address, since allocations are made
+		// from the lowest addressed slab first.
+		Slab *slabToRelease = slab;
+
+		if (SlabAddressComparator()(slab, m_emptySlab))
+		{
+			slabToRelease = std::exchange(m_emptySlab, slab);
+		}
+
+		m_slabsWithFreeSlots.erase(slabToRelease);
+		m_slabs.erase(slabToRelease->slots.get());
+	}
+
+	// Slabs, keyed by the address of their first slot. That allows the slab that an object belongs
+	// to to be found when the object is freed.
+	std::map<const Slot *, std::unique_ptr<Slab>> m_slabs;
+
+	std::set<Slab *, SlabAddressComparator> m_slabsWithFreeSlots;
+	Slab *m_emptySlab = nullptr;
+	size_t m_numAllocatedObjects = 0;
+};
@@ -257,8 +257,11 @@ PidlAbsolute DecodePidlFromBase64(const std::string &encodedPidl)
 		return {};
 	}
 
-	auto size = decodedContent.size();
+	return CreatePidlFromBytes(decodedContent.data(), decodedContent.size());
+}
 
+PidlAbsolute CreatePidlFromBytes(const void *data, size_t size)
+{
 	if (size == 0)
 	{
 		return {};
@@ -271,7 +274,7 @@ PidlAbsolute DecodePidlFromBase64(const std::string &encodedPidl)
 		return {};
 	}
 
-	std::memcpy(pidl.get(), decodedContent.data(), size);
+	std::memcpy(pidl.get(), data, size);
 
 	if (!IDListContainerIsConsistent(pidl.get(), CheckedNumericCast<UINT>(size)))
 	{
@@ -156,3 +156,7 @@ PidlOutParamType<T> PidlOutParam(T &p)
 
 std::string EncodePidlToBase64(PCIDLIST_ABSOLUTE pidl);
 PidlAbsolute DecodePidlFromBase64(const std::string &encodedPidl);
+
+// Creates a pidl from its raw (serialized) representation. The data is validated, with an empty
+// pidl being returned if it's not consistent.
+PidlAbsolute CreatePidlFromBytes(const void *data, size_t size);
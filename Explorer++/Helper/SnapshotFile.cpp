@@ -0,0 +1,145 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "SnapshotFile.h"
+#include "AtomicFile.h"
+#include <array>
+
+namespace SnapshotFile
+{
+
+namespace
+{
+
+constexpr std::array<char, 8> SNAPSHOT_MAGIC = { 'E', 'X', 'P', 'P', 'S', 'N', 'A', 'P' };
+
+struct Header
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t crc32;
+	uint64_t payloadSize;
+};
+
+static_assert(sizeof(Header) == 24);
+
+constexpr auto CRC32_TABLE = []
+{
+	std::array<uint32_t, 256> table = {};
+
+	for (uint32_t i = 0; i < table.size(); i++)
+	{
+		uint32_t value = i;
+
+		for (int j = 0; j < 8; j++)
+		{
+			value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+		}
+
+		table[i] = value;
+	}
+
+	return table;
+}();
+
+}
+
+std::unique_ptr<MappedSnapshot> MappedSnapshot::MaybeOpen(const std::wstring &path,
+	uint32_t expectedVersion)
+{
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+
+	if (!file)
+	{
+		return nullptr;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file.get(), &fileSize)
+		|| static_cast<uint64_t>(fileSize.QuadPart) < sizeof(Header))
+	{
+		return nullptr;
+	}
+
+	wil::unique_handle mapping(
+		CreateFileMapping(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+
+	if (!mapping)
+	{
+		return nullptr;
+	}
+
+	wil::unique_mapview_ptr<void> view(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0));
+
+	if (!view)
+	{
+		return nullptr;
+	}
+
+	Header header;
+	std::memcpy(&header, view.get(), sizeof(header));
+
+	if (header.magic != SNAPSHOT_MAGIC || header.version != expectedVersion
+		|| header.payloadSize != static_cast<uint64_t>(fileSize.QuadPart) - sizeof(Header))
+	{
+		return nullptr;
+	}
+
+	std::string_view payload(static_cast<const char *>(view.get()) + sizeof(Header),
+		static_cast<size_t>(header.payloadSize));
+
+	if (CalculateCrc32(payload) != header.crc32)
+	{
+		return nullptr;
+	}
+
+	// The mapping keeps the file open, so the file handle itself can be closed here.
+	return std::unique_ptr<MappedSnapshot>(
+		new MappedSnapshot(std::move(mapping), std::move(view), payload));
+}
+
+MappedSnapshot::MappedSnapshot(wil::unique_handle mapping, wil::unique_mapview_ptr<void> view,
+	std::string_view payload) :
+	m_mapping(std::move(mapping)),
+	m_view(std::move(view)),
+	m_payload(payload)
+{
+}
+
+std::string_view MappedSnapshot::GetPayload() const
+{
+	return m_payload;
+}
+
+bool Write(const std::wstring &path, uint32_t version, std::string_view payload)
+{
+	Header header;
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = version;
+	header.crc32 = CalculateCrc32(payload);
+	header.payloadSize = payload.size();
+
+	std::string_view chunks[] = {
+		std::string_view(reinterpret_cast<const char *>(&header), sizeof(header)), payload
+	};
+
+	return AtomicFile::Write(path, chunks);
+}
+
+uint32_t CalculateCrc32(std::string_view data)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (char c : data)
+	{
+		crc = CRC32_TABLE[(crc ^ static_cast<unsigned char>(c)) & 0xFF] ^ (crc >> 8);
+	}
+
+	return crc ^ 0xFFFFFFFF;
+}
+
+}
@@ -0,0 +1,45 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <wil/resource.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Reads and writes binary snapshot files. Each file consists of a small header, followed by an
+// arbitrary payload. The header contains a format version, as well as a checksum of the payload,
+// so that files written by an incompatible version (or files that have been truncated or
+// otherwise corrupted) are rejected, rather than being partially read.
+namespace SnapshotFile
+{
+
+// Maps a snapshot file into memory. The payload is validated when the file is opened and is then
+// read directly from the mapped view, without being copied.
+class MappedSnapshot
+{
+public:
+	static std::unique_ptr<MappedSnapshot> MaybeOpen(const std::wstring &path,
+		uint32_t expectedVersion);
+
+	std::string_view GetPayload() const;
+
+private:
+	MappedSnapshot(wil::unique_handle mapping, wil::unique_mapview_ptr<void> view,
+		std::string_view payload);
+
+	const wil::unique_handle m_mapping;
+	const wil::unique_mapview_ptr<void> m_view;
+	const std::string_view m_payload;
+};
+
+// The file is written to a temporary location first, then moved into place, so the existing file
+// is only ever replaced by a complete snapshot.
+bool Write(const std::wstring &path, uint32_t version, std::string_view payload);
+
+uint32_t CalculateCrc32(std::string_view data);
+
+}
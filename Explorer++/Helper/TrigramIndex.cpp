@@ -0,0 +1,424 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <optional>
+
+TrigramIndex::TrigramIndex(std::vector<double> fieldWeights) :
+	m_fieldWeights(std::move(fieldWeights))
+{
+	CHECK(!m_fieldWeights.empty() && m_fieldWeights.size() <= MAX_FIELDS);
+}
+
+void TrigramIndex::SetDocument(DocumentId documentId, const std::vector<std::wstring_view> &fields)
+{
+	CHECK_EQ(fields.size(), m_fieldWeights.size());
+
+	RemoveDocument(documentId);
+
+	CHECK_LE(m_documents.size(), MAX_SLOT);
+	auto slot = static_cast<Slot>(m_documents.size());
+
+	Document document;
+	document.id = documentId;
+
+	for (auto field : fields)
+	{
+		document.fields.push_back(NormalizeText(field));
+	}
+
+	AddPostings(slot, document);
+	m_documents.push_back(std::move(document));
+	m_documentIdToSlotMap.emplace(documentId, slot);
+}
+
+void TrigramIndex::RemoveDocument(DocumentId documentId)
+{
+	auto itr = m_documentIdToSlotMap.find(documentId);
+
+	if (itr == m_documentIdToSlotMap.end())
+	{
+		return;
+	}
+
+	auto &document = m_documents[itr->second];
+	RemovePostings(itr->second, document);
+	document.removed = true;
+	document.fields = {};
+	m_numRemovedDocuments++;
+
+	m_documentIdToSlotMap.erase(itr);
+
+	MaybeCompact();
+}
+
+void TrigramIndex::Clear()
+{
+	m_documents.clear();
+	m_documentIdToSlotMap.clear();
+	m_postings.clear();
+	m_numRemovedDocuments = 0;
+}
+
+bool TrigramIndex::HasDocument(DocumentId documentId) const
+{
+	return m_documentIdToSlotMap.contains(documentId);
+}
+
+size_t TrigramIndex::GetNumDocuments() const
+{
+	return m_documentIdToSlotMap.size();
+}
+
+void TrigramIndex::MaybeCompact()
+{
+	// Slots aren't reused, since that would mean postings could no longer simply be appended when a
+	// document is added. Instead, once enough documents have been removed, the remaining documents
+	// are renumbered and the postings rebuilt.
+	if (m_numRemovedDocuments < MIN_REMOVED_DOCUMENTS_BEFORE_COMPACTION
+		|| m_numRemovedDocuments < m_documentIdToSlotMap.size())
+	{
+		return;
+	}
+
+	std::vector<Document> documents;
+	documents.reserve(m_documentIdToSlotMap.size());
+
+	for (auto &document : m_documents)
+	{
+		if (!document.removed)
+		{
+			documents.push_back(std::move(document));
+		}
+	}
+
+	Clear();
+
+	for (auto &document : documents)
+	{
+		auto slot = static_cast<Slot>(m_documents.size());
+		AddPostings(slot, document);
+		m_documentIdToSlotMap.emplace(document.id, slot);
+		m_documents.push_back(std::move(document));
+	}
+}
+
+void TrigramIndex::AddPostings(Slot slot, const Document &document)
+{
+	for (size_t i = 0; i < document.fields.size(); i++)
+	{
+		auto posting = MakePosting(slot, i);
+
+		for (auto trigram : GetUniqueTrigrams(document.fields[i]))
+		{
+			auto &postings = m_postings[trigram];
+
+			// Slots are allocated in increasing order, so the posting can always be appended.
+			DCHECK(postings.empty() || postings.back() < posting);
+			postings.push_back(posting);
+		}
+	}
+}
+
+void TrigramIndex::RemovePostings(Slot slot, const Document &document)
+{
+	for (size_t i = 0; i < document.fields.size(); i++)
+	{
+		auto posting = MakePosting(slot, i);
+
+		for (auto trigram : GetUniqueTrigrams(document.fields[i]))
+		{
+			auto mapItr = m_postings.find(trigram);
+			CHECK(mapItr != m_postings.end());
+
+			auto &postings = mapItr->second;
+			auto itr = std::ranges::lower_bound(postings, posting);
+			CHECK(itr != postings.end() && *itr == posting);
+			postings.erase(itr);
+
+			if (postings.empty())
+			{
+				m_postings.erase(mapItr);
+			}
+		}
+	}
+}
+
+std::vector<TrigramIndex::Match> TrigramIndex::Search(std::wstring_view query,
+	size_t maxResults) const
+{
+	auto normalizedQuery = NormalizeText(query);
+
+	if (normalizedQuery.empty() || maxResults == 0)
+	{
+		return {};
+	}
+
+	std::vector<Match> matches;
+
+	if (normalizedQuery.size() < 3)
+	{
+		matches = SearchWithScan(normalizedQuery);
+	}
+	else
+	{
+		matches = SearchWithIndex(normalizedQuery);
+	}
+
+	return TakeBestMatches(std::move(matches), maxResults);
+}
+
+std::vector<TrigramIndex::Match> TrigramIndex::SearchWithIndex(
+	const std::wstring &normalizedQuery) const
+{
+	auto queryTrigrams = GetUniqueTrigrams(normalizedQuery);
+	size_t numTrigrams = queryTrigrams.size();
+	size_t minMatchingTrigrams = (numTrigrams + 1) / 2;
+
+	static const std::vector<Posting> emptyPostings;
+	std::vector<const std::vector<Posting> *> postingLists;
+
+	for (auto trigram : queryTrigrams)
+	{
+		auto itr = m_postings.find(trigram);
+		postingLists.push_back(itr != m_postings.end() ? &itr->second : &emptyPostings);
+	}
+
+	std::ranges::sort(postingLists, {}, [](const auto *postings) { return postings->size(); });
+
+	// A field has to appear in at least minMatchingTrigrams lists to be considered a match. So, any
+	// matching field must appear in at least one of the (numTrigrams - minMatchingTrigrams + 1)
+	// shortest lists. Candidates are gathered from those lists, then checked against the remaining
+	// (longer) lists using a binary search, which avoids having to walk through those lists in
+	// full.
+	size_t numCandidateLists = numTrigrams - minMatchingTrigrams + 1;
+	std::vector<Candidate> candidates;
+
+	for (size_t i = 0; i < numCandidateLists; i++)
+	{
+		candidates = MergeCandidates(candidates, *postingLists[i]);
+	}
+
+	for (size_t i = numCandidateLists; i < numTrigrams; i++)
+	{
+		const auto &postings = *postingLists[i];
+		auto itr = postings.begin();
+
+		// Both the candidates and the postings are sorted, so each search can start from where the
+		// previous one finished.
+		for (auto &candidate : candidates)
+		{
+			itr = std::lower_bound(itr, postings.end(), candidate.posting);
+
+			if (itr == postings.end())
+			{
+				break;
+			}
+
+			if (*itr == candidate.posting)
+			{
+				candidate.numMatchingTrigrams++;
+			}
+		}
+	}
+
+	// Since the field index is stored in the low bits of each posting, all the candidates for a
+	// single document will be adjacent.
+	std::vector<Match> matches;
+	std::optional<Slot> previousSlot;
+
+	for (const auto &candidate : candidates)
+	{
+		if (candidate.numMatchingTrigrams < minMatchingTrigrams)
+		{
+			continue;
+		}
+
+		auto slot = GetPostingSlot(candidate.posting);
+		auto fieldIndex = GetPostingFieldIndex(candidate.posting);
+		const auto &document = m_documents[slot];
+
+		double score = GetFieldScore(document.fields[fieldIndex], fieldIndex, normalizedQuery,
+			static_cast<double>(candidate.numMatchingTrigrams) / static_cast<double>(numTrigrams));
+
+		if (previousSlot == slot)
+		{
+			matches.back().score = std::max(matches.back().score, score);
+		}
+		else
+		{
+			matches.push_back({ document.id, score });
+			previousSlot = slot;
+		}
+	}
+
+	return matches;
+}
+
+std::vector<TrigramIndex::Candidate> TrigramIndex::MergeCandidates(
+	const std::vector<Candidate> &candidates, const std::vector<Posting> &postings)
+{
+	std::vector<Candidate> mergedCandidates;
+	mergedCandidates.reserve(candidates.size() + postings.size());
+
+	auto candidateItr = candidates.begin();
+	auto postingItr = postings.begin();
+
+	while (candidateItr != candidates.end() || postingItr != postings.end())
+	{
+		if (postingItr == postings.end()
+			|| (candidateItr != candidates.end() && candidateItr->posting < *postingItr))
+		{
+			mergedCandidates.push_back(*candidateItr);
+			++candidateItr;
+		}
+		else if (candidateItr == candidates.end() || *postingItr < candidateItr->posting)
+		{
+			mergedCandidates.push_back({ *postingItr, 1 });
+			++postingItr;
+		}
+		else
+		{
+			mergedCandidates.push_back({ *postingItr, candidateItr->numMatchingTrigrams + 1 });
+			++candidateItr;
+			++postingItr;
+		}
+	}
+
+	return mergedCandidates;
+}
+
+std::vector<TrigramIndex::Match> TrigramIndex::SearchWithScan(
+	const std::wstring &normalizedQuery) const
+{
+	std::vector<Match> matches;
+
+	for (const auto &document : m_documents)
+	{
+		if (document.removed)
+		{
+			continue;
+		}
+
+		double documentScore = 0;
+
+		for (size_t i = 0; i < document.fields.size(); i++)
+		{
+			if (document.fields[i].find(normalizedQuery) == std::wstring::npos)
+			{
+				continue;
+			}
+
+			documentScore =
+				std::max(documentScore, GetFieldScore(document.fields[i], i, normalizedQuery, 1));
+		}
+
+		if (documentScore > 0)
+		{
+			matches.push_back({ document.id, documentScore });
+		}
+	}
+
+	return matches;
+}
+
+double TrigramIndex::GetFieldScore(const std::wstring &field, size_t fieldIndex,
+	const std::wstring &normalizedQuery, double trigramMatchRatio) const
+{
+	// An exact substring match is always ranked above an approximate match, with a further boost if
+	// the match occurs at the start of the field.
+	double score = trigramMatchRatio;
+	auto position = field.find(normalizedQuery);
+
+	if (position == 0)
+	{
+		score += 1.5;
+	}
+	else if (position != std::wstring::npos)
+	{
+		score += 1;
+	}
+
+	return score * m_fieldWeights[fieldIndex];
+}
+
+std::vector<TrigramIndex::Match> TrigramIndex::TakeBestMatches(std::vector<Match> matches,
+	size_t maxResults)
+{
+	auto compareMatches = [](const Match &first, const Match &second)
+	{
+		if (first.score != second.score)
+		{
+			return first.score > second.score;
+		}
+
+		return first.documentId < second.documentId;
+	};
+
+	if (matches.size() > maxResults)
+	{
+		std::ranges::partial_sort(matches, matches.begin() + maxResults, compareMatches);
+		matches.resize(maxResults);
+	}
+	else
+	{
+		std::ranges::sort(matches, compareMatches);
+	}
+
+	return matches;
+}
+
+std::wstring TrigramIndex::NormalizeText(std::wstring_view text)
+{
+	std::wstring normalizedText(text);
+
+	if (!normalizedText.empty())
+	{
+		CharLowerBuff(normalizedText.data(), static_cast<DWORD>(normalizedText.size()));
+	}
+
+	return normalizedText;
+}
+
+TrigramIndex::Posting TrigramIndex::MakePosting(Slot slot, size_t fieldIndex)
+{
+	return (slot << FIELD_BITS) | static_cast<Posting>(fieldIndex);
+}
+
+TrigramIndex::Slot TrigramIndex::GetPostingSlot(Posting posting)
+{
+	return posting >> FIELD_BITS;
+}
+
+size_t TrigramIndex::GetPostingFieldIndex(Posting posting)
+{
+	return posting & ((1u << FIELD_BITS) - 1);
+}
+
+std::vector<TrigramIndex::Trigram> TrigramIndex::GetUniqueTrigrams(std::wstring_view text)
+{
+	std::vector<Trigram> trigrams;
+
+	if (text.size() < 3)
+	{
+		return trigrams;
+	}
+
+	trigrams.reserve(text.size() - 2);
+
+	for (size_t i = 0; i + 2 < text.size(); i++)
+	{
+		trigrams.push_back((static_cast<Trigram>(static_cast<uint16_t>(text[i])) << 32)
+			| (static_cast<Trigram>(static_cast<uint16_t>(text[i + 1])) << 16)
+			| static_cast<Trigram>(static_cast<uint16_t>(text[i + 2])));
+	}
+
+	std::ranges::sort(trigrams);
+	auto duplicates = std::ranges::unique(trigrams);
+	trigrams.erase(duplicates.begin(), duplicates.end());
+
+	return trigrams;
+}
@@ -0,0 +1,108 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// An in-memory index that supports ranked substring and approximate matching over a set of
+// documents. Each document consists of one or more text fields (e.g. a name and a path), with each
+// field having its own weight.
+//
+// Every field is broken up into overlapping three-character sequences (trigrams) and, for each
+// trigram, a sorted list of the fields containing it is maintained. A query is then matched by
+// intersecting the lists for the trigrams in the query. A field is considered to match if it
+// contains at least half of the query's trigrams, which means that small typos (e.g. a missing or
+// transposed character) will still produce a match.
+//
+// Matching is case-insensitive. Queries shorter than a trigram can't use the index and are matched
+// with a linear scan instead.
+class TrigramIndex
+{
+public:
+	using DocumentId = uint32_t;
+
+	struct Match
+	{
+		DocumentId documentId;
+		double score;
+	};
+
+	// The maximum number of fields each document can have.
+	static constexpr size_t MAX_FIELDS = 4;
+
+	// The number of weights determines the number of fields each document has.
+	explicit TrigramIndex(std::vector<double> fieldWeights);
+
+	// Adds the document, or replaces it, if a document with the same ID already exists. The number
+	// of fields should match the number of field weights provided to the constructor.
+	void SetDocument(DocumentId documentId, const std::vector<std::wstring_view> &fields);
+	void RemoveDocument(DocumentId documentId);
+	void Clear();
+
+	bool HasDocument(DocumentId documentId) const;
+	size_t GetNumDocuments() const;
+
+	// Returns up to maxResults matches, ordered from best to worst. Matches with an equal score are
+	// ordered by document ID.
+	std::vector<Match> Search(std::wstring_view query, size_t maxResults) const;
+
+	static std::wstring NormalizeText(std::wstring_view text);
+
+private:
+	using Trigram = uint64_t;
+
+	// Documents are stored densely, with each document being assigned a slot when it's added.
+	using Slot = uint32_t;
+
+	// Each posting identifies a single field within a single document. The field index is stored in
+	// the low bits, so that the postings for a document are adjacent when sorted.
+	using Posting = uint32_t;
+	static constexpr int FIELD_BITS = 2;
+	static constexpr Slot MAX_SLOT = (1u << (32 - FIELD_BITS)) - 1;
+
+	static constexpr size_t MIN_REMOVED_DOCUMENTS_BEFORE_COMPACTION = 1024;
+
+	struct Document
+	{
+		DocumentId id;
+		bool removed = false;
+
+		// Each field is stored in its normalized form.
+		std::vector<std::wstring> fields;
+	};
+
+	struct Candidate
+	{
+		Posting posting;
+		size_t numMatchingTrigrams;
+	};
+
+	static Posting MakePosting(Slot slot, size_t fieldIndex);
+	static Slot GetPostingSlot(Posting posting);
+	static size_t GetPostingFieldIndex(Posting posting);
+	static std::vector<Trigram> GetUniqueTrigrams(std::wstring_view text);
+
+	void AddPostings(Slot slot, const Document &document);
+	void RemovePostings(Slot slot, const Document &document);
+	void MaybeCompact();
+
+	std::vector<Match> SearchWithIndex(const std::wstring &normalizedQuery) const;
+	static std::vector<Candidate> MergeCandidates(const std::vector<Candidate> &candidates,
+		const std::vector<Posting> &postings);
+	std::vector<Match> SearchWithScan(const std::wstring &normalizedQuery) const;
+	double GetFieldScore(const std::wstring &field, size_t fieldIndex,
+		const std::wstring &normalizedQuery, double trigramMatchRatio) const;
+	static std::vector<Match> TakeBestMatches(std::vector<Match> matches, size_t maxResults);
+
+	const std::vector<double> m_fieldWeights;
+	std::vector<Document> m_documents;
+	std::unordered_map<DocumentId, Slot> m_documentIdToSlotMap;
+	size_t m_numRemovedDocuments = 0;
+	std::unordered_map<Trigram, std::vector<Posting>> m_postings;
+};
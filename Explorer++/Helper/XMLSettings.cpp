@@ -22,6 +22,38 @@ namespace
 constexpr wchar_t BOOL_YES[] = L"yes";
 constexpr wchar_t BOOL_NO[] = L"no";
 
+// Returns every attribute of the node, other than the first (which, for the nodes these functions
+// are used with, is the name attribute).
+std::vector<XmlReader::Attribute> GetNodeAttributes(IXMLDOMNode *pNode)
+{
+	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
+	pNode->get_attributes(&am);
+
+	long lChildNodes;
+	am->get_length(&lChildNodes);
+
+	std::vector<XmlReader::Attribute> attributes;
+
+	for (long i = 1; i < lChildNodes; i++)
+	{
+		wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
+		am->get_item(i, &pChildNode);
+
+		/* Element name. */
+		wil::unique_bstr bstrName;
+		pChildNode->get_nodeName(&bstrName);
+
+		/* Element value. */
+		wil::unique_bstr bstrValue;
+		pChildNode->get_text(&bstrValue);
+
+		attributes.push_back(
+			{ bstrName ? bstrName.get() : L"", bstrValue ? bstrValue.get() : L"" });
+	}
+
+	return attributes;
+}
+
 }
 
 namespace XMLSettings
@@ -233,14 +265,12 @@ int DecodeIntValue(const std::wstring &value)
 
 COLORREF ReadXMLColorData(IXMLDOMNode *pNode)
 {
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	pNode->get_attributes(&am);
-
-	long lChildNodes;
-	am->get_length(&lChildNodes);
+	return ReadXMLColorData(GetNodeAttributes(pNode));
+}
 
+COLORREF ReadXMLColorData(std::span<const XmlReader::Attribute> attributes)
+{
 	/* RGB data requires three attributes (R,G,B). */
-	/*if(lChildNodes != 3)*/
 
 	BYTE r = 0;
 	BYTE g = 0;
@@ -253,30 +283,19 @@ COLORREF ReadXMLColorData(IXMLDOMNode *pNode)
 	not need to be checked for, as each color
 	value is a byte, and can only hold values
 	between 0x00 and 0xFF. */
-	for (long i = 1; i < lChildNodes; i++)
+	for (const auto &attribute : attributes)
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-		am->get_item(i, &pChildNode);
-
-		/* Element name. */
-		wil::unique_bstr bstrName;
-		pChildNode->get_nodeName(&bstrName);
-
-		/* Element value. */
-		wil::unique_bstr bstrValue;
-		pChildNode->get_text(&bstrValue);
-
-		if (lstrcmp(bstrName.get(), L"r") == 0)
+		if (attribute.name == L"r")
 		{
-			r = (BYTE) DecodeIntValue(bstrValue.get());
+			r = (BYTE) DecodeIntValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"g") == 0)
+		else if (attribute.name == L"g")
 		{
-			g = (BYTE) DecodeIntValue(bstrValue.get());
+			g = (BYTE) DecodeIntValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"b") == 0)
+		else if (attribute.name == L"b")
 		{
-			b = (BYTE) DecodeIntValue(bstrValue.get());
+			b = (BYTE) DecodeIntValue(attribute.value);
 		}
 	}
 
@@ -285,52 +304,43 @@ COLORREF ReadXMLColorData(IXMLDOMNode *pNode)
 
 LOGFONT ReadXMLFontData(IXMLDOMNode *pNode)
 {
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	pNode->get_attributes(&am);
-
-	long lChildNodes;
-	am->get_length(&lChildNodes);
+	return ReadXMLFontData(GetNodeAttributes(pNode));
+}
 
-	LOGFONT fontInfo;
+LOGFONT ReadXMLFontData(std::span<const XmlReader::Attribute> attributes)
+{
+	LOGFONT fontInfo = {};
 
-	for (long i = 1; i < lChildNodes; i++)
+	for (const auto &attribute : attributes)
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-		am->get_item(i, &pChildNode);
-
-		wil::unique_bstr bstrName;
-		pChildNode->get_nodeName(&bstrName);
-
-		wil::unique_bstr bstrValue;
-		pChildNode->get_text(&bstrValue);
-
-		if (lstrcmp(bstrName.get(), L"Height") == 0)
+		if (attribute.name == L"Height")
 		{
-			fontInfo.lfHeight = DecodeIntValue(bstrValue.get());
+			fontInfo.lfHeight = DecodeIntValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"Width") == 0)
+		else if (attribute.name == L"Width")
 		{
-			fontInfo.lfWidth = DecodeIntValue(bstrValue.get());
+			fontInfo.lfWidth = DecodeIntValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"Weight") == 0)
+		else if (attribute.name == L"Weight")
 		{
-			fontInfo.lfWeight = DecodeIntValue(bstrValue.get());
+			fontInfo.lfWeight = DecodeIntValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"Italic") == 0)
+		else if (attribute.name == L"Italic")
 		{
-			fontInfo.lfItalic = (BYTE) DecodeBoolValue(bstrValue.get());
+			fontInfo.lfItalic = (BYTE) DecodeBoolValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"Underline") == 0)
+		else if (attribute.name == L"Underline")
 		{
-			fontInfo.lfUnderline = (BYTE) DecodeBoolValue(bstrValue.get());
+			fontInfo.lfUnderline = (BYTE) DecodeBoolValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"Strikeout") == 0)
+		else if (attribute.name == L"Strikeout")
 		{
-			fontInfo.lfStrikeOut = (BYTE) DecodeBoolValue(bstrValue.get());
+			fontInfo.lfStrikeOut = (BYTE) DecodeBoolValue(attribute.value);
 		}
-		else if (lstrcmp(bstrName.get(), L"Font") == 0)
+		else if (attribute.name == L"Font")
 		{
-			StringCchCopy(fontInfo.lfFaceName, std::size(fontInfo.lfFaceName), bstrValue.get());
+			StringCchCopy(fontInfo.lfFaceName, std::size(fontInfo.lfFaceName),
+				attribute.value.c_str());
 		}
 	}
 
@@ -461,4 +471,102 @@ HRESULT GetStringFromMap(IXMLDOMNamedNodeMap *attributeMap, const std::wstring &
 	return hr;
 }
 
+std::optional<std::wstring> MaybeGetString(const XmlReader &reader, const std::wstring &name)
+{
+	const auto *value = reader.MaybeGetAttribute(name);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return *value;
+}
+
+std::optional<int> MaybeGetInt(const XmlReader &reader, const std::wstring &name)
+{
+	const auto *value = reader.MaybeGetAttribute(name);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return DecodeIntValue(*value);
+}
+
+std::optional<bool> MaybeGetBool(const XmlReader &reader, const std::wstring &name)
+{
+	const auto *value = reader.MaybeGetAttribute(name);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return DecodeBoolValue(*value);
+}
+
+bool ReadChildElements(XmlReader &reader, std::function<bool(XmlReader &reader)> readChild)
+{
+	if (reader.GetNodeType() != XmlReader::NodeType::StartElement)
+	{
+		return false;
+	}
+
+	size_t depth = reader.GetDepth();
+
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::EndElement && reader.GetDepth() == depth)
+		{
+			return true;
+		}
+
+		if (reader.GetNodeType() != XmlReader::NodeType::StartElement)
+		{
+			continue;
+		}
+
+		if (!readChild(reader))
+		{
+			return false;
+		}
+
+		if (reader.GetNodeType() == XmlReader::NodeType::StartElement
+			&& reader.GetDepth() == depth + 1 && !reader.SkipElement())
+		{
+			return false;
+		}
+	}
+
+	return false;
+}
+
+std::optional<std::wstring> ReadElementText(XmlReader &reader)
+{
+	if (reader.GetNodeType() != XmlReader::NodeType::StartElement)
+	{
+		return std::nullopt;
+	}
+
+	size_t depth = reader.GetDepth();
+	std::wstring text;
+
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::EndElement && reader.GetDepth() == depth)
+		{
+			return text;
+		}
+
+		if (reader.GetNodeType() == XmlReader::NodeType::Text)
+		{
+			text += reader.GetText();
+		}
+	}
+
+	return std::nullopt;
+}
+
 }
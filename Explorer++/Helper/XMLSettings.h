@@ -5,6 +5,8 @@
 #pragma once
 
 #include "BetterEnumsWrapper.h"
+#include "XmlReader.h"
+#include "XmlWriter.h"
 #include <wil/com.h>
 #include <MsXml2.h>
 #include <gdiplus.h>
@@ -12,6 +14,7 @@
 #include <functional>
 #include <list>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace XMLSettings
@@ -36,7 +39,9 @@ BOOL DecodeBoolValue(const std::wstring &value);
 std::wstring EncodeIntValue(int value);
 int DecodeIntValue(const std::wstring &value);
 COLORREF ReadXMLColorData(IXMLDOMNode *pNode);
+COLORREF ReadXMLColorData(std::span<const XmlReader::Attribute> attributes);
 LOGFONT ReadXMLFontData(IXMLDOMNode *pNode);
+LOGFONT ReadXMLFontData(std::span<const XmlReader::Attribute> attributes);
 
 bool ReadDateTime(IXMLDOMNamedNodeMap *attributeMap, const std::wstring &baseKeyName,
 	FILETIME &dateTime);
@@ -116,4 +121,79 @@ void SaveItemList(IXMLDOMDocument *xmlDocument, IXMLDOMElement *node, const std:
 	}
 }
 
+// The functions below are the XmlReader/XmlWriter equivalents of the functions above. Values are
+// encoded and decoded in exactly the same way, so the output of one can be read by the other.
+// Attribute values are read from the start element the reader is currently positioned on.
+std::optional<std::wstring> MaybeGetString(const XmlReader &reader, const std::wstring &name);
+std::optional<int> MaybeGetInt(const XmlReader &reader, const std::wstring &name);
+std::optional<bool> MaybeGetBool(const XmlReader &reader, const std::wstring &name);
+
+template <BetterEnum T>
+void LoadBetterEnumValue(const XmlReader &reader, const std::wstring &valueName, T &output)
+{
+	auto value = MaybeGetInt(reader, valueName);
+
+	if (!value || !T::_is_valid(*value))
+	{
+		return;
+	}
+
+	output = T::_from_integral(*value);
+}
+
+// Calls readChild for each child element of the start element the reader is positioned on. When
+// readChild is called, the reader will be positioned on the child's start element. It can either
+// leave the reader there (in which case the child element will be skipped), or advance it to the
+// child's end element. When this function returns, the reader will be positioned on the end element
+// of the parent. Returns false if the document is malformed, or if readChild returns false.
+bool ReadChildElements(XmlReader &reader, std::function<bool(XmlReader &reader)> readChild);
+
+// Returns the text content of the start element the reader is positioned on, leaving the reader
+// positioned on the matching end element. Returns std::nullopt if the document is malformed.
+std::optional<std::wstring> ReadElementText(XmlReader &reader);
+
+template <class T>
+std::optional<std::vector<T>> ReadItemList(XmlReader &reader, const std::wstring &childNodeName,
+	std::function<std::optional<T>(XmlReader &reader)> loadItem)
+{
+	std::vector<T> items;
+	bool res = ReadChildElements(reader,
+		[&items, &childNodeName, &loadItem](XmlReader &reader)
+		{
+			if (reader.GetName() != childNodeName)
+			{
+				return true;
+			}
+
+			auto item = loadItem(reader);
+
+			if (item)
+			{
+				items.push_back(std::move(*item));
+			}
+
+			return true;
+		});
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	return items;
+}
+
+template <class T>
+void SaveItemList(XmlWriter &writer, const std::vector<T> &items,
+	const std::wstring &childNodeName,
+	std::function<void(XmlWriter &writer, const T &item)> saveItem)
+{
+	for (const auto &item : items)
+	{
+		writer.StartElement(childNodeName);
+		saveItem(writer, item);
+		writer.EndElement();
+	}
+}
+
 }
@@ -0,0 +1,691 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "XmlReader.h"
+#include <algorithm>
+#include <charconv>
+
+namespace
+{
+
+bool IsWhitespace(int c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool IsNameTerminator(int c)
+{
+	return IsWhitespace(c) || c == '/' || c == '>' || c == '=' || c == '<';
+}
+
+void AppendCodePoint(std::wstring &output, char32_t codePoint)
+{
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		if (codePoint >= 0x10000)
+		{
+			codePoint -= 0x10000;
+			output += static_cast<wchar_t>(0xD800 + (codePoint >> 10));
+			output += static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF));
+			return;
+		}
+	}
+
+	output += static_cast<wchar_t>(codePoint);
+}
+
+// Decodes the UTF-8 text in the range [begin, end) and appends it to the output. Returns false if
+// the text isn't valid UTF-8.
+bool AppendUtf8(std::wstring &output, const char *begin, const char *end)
+{
+	while (begin != end)
+	{
+		// Most of the text in a config file is ASCII, so runs of ASCII characters are copied
+		// directly.
+		const char *asciiEnd =
+			std::find_if(begin, end, [](char c) { return static_cast<unsigned char>(c) >= 0x80; });
+		size_t existingSize = output.size();
+		output.resize(existingSize + (asciiEnd - begin));
+		std::copy(begin, asciiEnd, output.begin() + existingSize);
+		begin = asciiEnd;
+
+		if (begin == end)
+		{
+			break;
+		}
+
+		auto byte = static_cast<unsigned char>(*begin++);
+
+		int numContinuationBytes;
+		char32_t codePoint;
+
+		if ((byte & 0xE0) == 0xC0)
+		{
+			numContinuationBytes = 1;
+			codePoint = byte & 0x1F;
+		}
+		else if ((byte & 0xF0) == 0xE0)
+		{
+			numContinuationBytes = 2;
+			codePoint = byte & 0x0F;
+		}
+		else if ((byte & 0xF8) == 0xF0)
+		{
+			numContinuationBytes = 3;
+			codePoint = byte & 0x07;
+		}
+		else
+		{
+			return false;
+		}
+
+		if (end - begin < numContinuationBytes)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < numContinuationBytes; i++)
+		{
+			auto continuationByte = static_cast<unsigned char>(*begin++);
+
+			if ((continuationByte & 0xC0) != 0x80)
+			{
+				return false;
+			}
+
+			codePoint = (codePoint << 6) | (continuationByte & 0x3F);
+		}
+
+		if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+		{
+			return false;
+		}
+
+		AppendCodePoint(output, codePoint);
+	}
+
+	return true;
+}
+
+bool DecodeEntity(std::string_view entity, std::wstring &output)
+{
+	if (entity == "lt")
+	{
+		output += L'<';
+	}
+	else if (entity == "gt")
+	{
+		output += L'>';
+	}
+	else if (entity == "amp")
+	{
+		output += L'&';
+	}
+	else if (entity == "quot")
+	{
+		output += L'"';
+	}
+	else if (entity == "apos")
+	{
+		output += L'\'';
+	}
+	else if (entity.size() >= 2 && entity[0] == '#')
+	{
+		int base = 10;
+		entity.remove_prefix(1);
+
+		if (entity[0] == 'x')
+		{
+			base = 16;
+			entity.remove_prefix(1);
+		}
+
+		uint32_t codePoint;
+		auto [ptr, ec] =
+			std::from_chars(entity.data(), entity.data() + entity.size(), codePoint, base);
+
+		if (ec != std::errc() || ptr != entity.data() + entity.size() || codePoint == 0
+			|| codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+		{
+			return false;
+		}
+
+		AppendCodePoint(output, static_cast<char32_t>(codePoint));
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+XmlReader::XmlReader(std::istream &stream) : m_stream(stream)
+{
+	// Skip the byte order mark, if there is one.
+	Consume("\xEF\xBB\xBF");
+}
+
+bool XmlReader::Read()
+{
+	if (m_error || m_finished)
+	{
+		return false;
+	}
+
+	if (m_nodeType == NodeType::EndElement)
+	{
+		m_openElements.pop_back();
+	}
+
+	if (m_pendingEndElement)
+	{
+		m_pendingEndElement = false;
+		m_nodeType = NodeType::EndElement;
+		return true;
+	}
+
+	while (true)
+	{
+		int c = Peek();
+
+		if (c == EOF)
+		{
+			if (!m_openElements.empty() || !m_seenRootElement)
+			{
+				return SetError();
+			}
+
+			m_finished = true;
+			m_nodeType = NodeType::None;
+			return false;
+		}
+
+		if (c != '<')
+		{
+			if (!ReadText())
+			{
+				return SetError();
+			}
+
+			if (m_nodeType == NodeType::Text)
+			{
+				return true;
+			}
+
+			continue;
+		}
+
+		Get();
+
+		if (Consume("?"))
+		{
+			if (!SkipPast("?>"))
+			{
+				return SetError();
+			}
+		}
+		else if (Consume("!--"))
+		{
+			if (!SkipPast("-->"))
+			{
+				return SetError();
+			}
+		}
+		else if (Consume("![CDATA["))
+		{
+			if (m_openElements.empty())
+			{
+				return SetError();
+			}
+
+			m_rawValue.clear();
+
+			while (!Consume("]]>"))
+			{
+				c = Get();
+
+				if (c == EOF)
+				{
+					return SetError();
+				}
+
+				m_rawValue += static_cast<char>(c);
+			}
+
+			m_text.clear();
+
+			if (!AppendUtf8(m_text, m_rawValue.data(), m_rawValue.data() + m_rawValue.size()))
+			{
+				return SetError();
+			}
+
+			m_nodeType = NodeType::Text;
+			m_depth = m_openElements.size();
+			return true;
+		}
+		else if (Consume("!"))
+		{
+			// A DOCTYPE declaration. Internal subsets aren't supported.
+			if (!SkipPast(">"))
+			{
+				return SetError();
+			}
+		}
+		else if (Consume("/"))
+		{
+			return ReadEndElement() || SetError();
+		}
+		else
+		{
+			return ReadStartElement() || SetError();
+		}
+	}
+}
+
+bool XmlReader::ReadStartElement()
+{
+	if (m_openElements.empty() && m_seenRootElement)
+	{
+		// Only a single root element is allowed.
+		return false;
+	}
+
+	if (!ReadName(m_rawName))
+	{
+		return false;
+	}
+
+	m_name.clear();
+
+	if (!AppendUtf8(m_name, m_rawName.data(), m_rawName.data() + m_rawName.size()))
+	{
+		return false;
+	}
+
+	m_numAttributes = 0;
+
+	bool isEmptyElement = false;
+
+	while (true)
+	{
+		SkipWhitespace();
+
+		if (Consume("/>"))
+		{
+			isEmptyElement = true;
+			break;
+		}
+		else if (Consume(">"))
+		{
+			break;
+		}
+
+		// The attribute objects (and the strings they contain) are reused between elements, to
+		// avoid allocating memory for each attribute that's read.
+		if (m_numAttributes == m_attributes.size())
+		{
+			m_attributes.emplace_back();
+		}
+
+		Attribute &attribute = m_attributes[m_numAttributes];
+		attribute.name.clear();
+
+		if (!ReadName(m_rawValue)
+			|| !AppendUtf8(attribute.name, m_rawValue.data(),
+				m_rawValue.data() + m_rawValue.size()))
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+
+		if (!Consume("="))
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+
+		int quote = Get();
+
+		if (quote != '"' && quote != '\'')
+		{
+			return false;
+		}
+
+		if (!ReadUntil(static_cast<char>(quote), m_rawValue))
+		{
+			return false;
+		}
+
+		// Literal whitespace characters within an attribute value are normalized to spaces (only
+		// character references are preserved as-is).
+		std::ranges::replace_if(m_rawValue, IsWhitespace, ' ');
+
+		if (!DecodeEntities(m_rawValue, attribute.value))
+		{
+			return false;
+		}
+
+		m_numAttributes++;
+	}
+
+	m_seenRootElement = true;
+	m_depth = m_openElements.size();
+	m_openElements.push_back(m_rawName);
+	m_pendingEndElement = isEmptyElement;
+	m_nodeType = NodeType::StartElement;
+
+	return true;
+}
+
+bool XmlReader::ReadEndElement()
+{
+	if (!ReadName(m_rawName))
+	{
+		return false;
+	}
+
+	SkipWhitespace();
+
+	if (!Consume(">"))
+	{
+		return false;
+	}
+
+	if (m_openElements.empty() || m_openElements.back() != m_rawName)
+	{
+		return false;
+	}
+
+	m_name.clear();
+	AppendUtf8(m_name, m_rawName.data(), m_rawName.data() + m_rawName.size());
+
+	m_depth = m_openElements.size() - 1;
+	m_nodeType = NodeType::EndElement;
+
+	return true;
+}
+
+bool XmlReader::ReadText()
+{
+	if (!ReadUntil('<', m_rawValue))
+	{
+		// Text at the end of the document. That's only valid if it's whitespace.
+		if (!std::ranges::all_of(m_rawValue, IsWhitespace))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// The '<' is part of the next node.
+		m_position--;
+	}
+
+	if (std::ranges::all_of(m_rawValue, IsWhitespace))
+	{
+		// Whitespace is only significant if it makes up the entire content of an element (e.g.
+		// <Element> </Element>). Everything else is indentation.
+		bool isElementContent = false;
+
+		if (m_nodeType == NodeType::StartElement && !m_rawValue.empty() && Consume("</"))
+		{
+			m_position -= 2;
+			isElementContent = true;
+		}
+
+		if (!isElementContent)
+		{
+			m_nodeType = NodeType::None;
+			return true;
+		}
+	}
+
+	if (m_openElements.empty())
+	{
+		// Text isn't allowed outside the root element.
+		return false;
+	}
+
+	if (!DecodeEntities(m_rawValue, m_text))
+	{
+		return false;
+	}
+
+	m_depth = m_openElements.size();
+	m_nodeType = NodeType::Text;
+
+	return true;
+}
+
+bool XmlReader::SkipElement()
+{
+	if (m_nodeType != NodeType::StartElement)
+	{
+		return false;
+	}
+
+	size_t depth = m_depth;
+
+	while (Read())
+	{
+		if (m_nodeType == NodeType::EndElement && m_depth == depth)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool XmlReader::HasError() const
+{
+	return m_error;
+}
+
+XmlReader::NodeType XmlReader::GetNodeType() const
+{
+	return m_nodeType;
+}
+
+const std::wstring &XmlReader::GetName() const
+{
+	return m_name;
+}
+
+size_t XmlReader::GetDepth() const
+{
+	return m_depth;
+}
+
+std::span<const XmlReader::Attribute> XmlReader::GetAttributes() const
+{
+	return { m_attributes.data(), m_numAttributes };
+}
+
+const std::wstring *XmlReader::MaybeGetAttribute(std::wstring_view name) const
+{
+	auto attributes = GetAttributes();
+	auto itr = std::ranges::find(attributes, name, &Attribute::name);
+
+	if (itr == attributes.end())
+	{
+		return nullptr;
+	}
+
+	return &itr->value;
+}
+
+const std::wstring &XmlReader::GetText() const
+{
+	return m_text;
+}
+
+int XmlReader::Peek()
+{
+	if (m_position == m_buffer.size())
+	{
+		m_buffer.resize(BUFFER_SIZE);
+		m_stream.read(m_buffer.data(), BUFFER_SIZE);
+		m_buffer.resize(static_cast<size_t>(m_stream.gcount()));
+		m_position = 0;
+
+		if (m_buffer.empty())
+		{
+			return EOF;
+		}
+	}
+
+	return static_cast<unsigned char>(m_buffer[m_position]);
+}
+
+int XmlReader::Get()
+{
+	int c = Peek();
+
+	if (c != EOF)
+	{
+		m_position++;
+	}
+
+	return c;
+}
+
+bool XmlReader::Consume(std::string_view text)
+{
+	// The text to be consumed may straddle the end of the buffer, so any data that's still to be
+	// processed is moved to the start of the buffer and more data read in.
+	if (m_buffer.size() - m_position < text.size())
+	{
+		m_buffer.erase(0, m_position);
+		m_position = 0;
+
+		size_t existingSize = m_buffer.size();
+		m_buffer.resize(existingSize + BUFFER_SIZE);
+		m_stream.read(m_buffer.data() + existingSize, BUFFER_SIZE);
+		m_buffer.resize(existingSize + static_cast<size_t>(m_stream.gcount()));
+	}
+
+	if (std::string_view(m_buffer).substr(m_position).starts_with(text))
+	{
+		m_position += text.size();
+		return true;
+	}
+
+	return false;
+}
+
+bool XmlReader::SkipPast(std::string_view terminator)
+{
+	while (!Consume(terminator))
+	{
+		if (Get() == EOF)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void XmlReader::SkipWhitespace()
+{
+	while (IsWhitespace(Peek()))
+	{
+		m_position++;
+	}
+}
+
+bool XmlReader::ReadName(std::string &output)
+{
+	output.clear();
+
+	while (Peek() != EOF)
+	{
+		auto start = m_buffer.begin() + m_position;
+		auto end = std::find_if(start, m_buffer.end(), IsNameTerminator);
+		output.append(start, end);
+		m_position = end - m_buffer.begin();
+
+		if (end != m_buffer.end())
+		{
+			break;
+		}
+	}
+
+	return !output.empty();
+}
+
+bool XmlReader::ReadUntil(char terminator, std::string &output)
+{
+	output.clear();
+
+	while (true)
+	{
+		if (Peek() == EOF)
+		{
+			return false;
+		}
+
+		// Copy everything up to the terminator (or the end of the buffer) in one go.
+		auto start = m_buffer.begin() + m_position;
+		auto end = std::find(start, m_buffer.end(), terminator);
+		output.append(start, end);
+		m_position = end - m_buffer.begin();
+
+		if (end != m_buffer.end())
+		{
+			m_position++;
+			return true;
+		}
+	}
+}
+
+bool XmlReader::DecodeEntities(const std::string &input, std::wstring &output)
+{
+	output.clear();
+	output.reserve(input.size());
+
+	const char *current = input.data();
+	const char *end = input.data() + input.size();
+
+	while (current != end)
+	{
+		const char *ampersand = std::find(current, end, '&');
+
+		if (!AppendUtf8(output, current, ampersand))
+		{
+			return false;
+		}
+
+		if (ampersand == end)
+		{
+			break;
+		}
+
+		const char *semicolon = std::find(ampersand, end, ';');
+
+		if (semicolon == end
+			|| !DecodeEntity(std::string_view(ampersand + 1, semicolon), output))
+		{
+			return false;
+		}
+
+		current = semicolon + 1;
+	}
+
+	return true;
+}
+
+bool XmlReader::SetError()
+{
+	m_error = true;
+	m_nodeType = NodeType::None;
+	return false;
+}
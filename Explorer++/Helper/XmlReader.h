@@ -0,0 +1,103 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <istream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A forward-only (pull) parser for UTF-8 encoded XML. Unlike MSXML, no document is built in memory;
+// each call to Read() advances to the next node and the caller extracts whatever it needs from that
+// node. That makes this class suitable for reading large documents quickly. It has no dependency
+// on COM, or any other platform API.
+//
+// Only the subset of XML used in configuration files is supported. Comments, processing
+// instructions and DOCTYPE declarations are skipped. Text that consists entirely of whitespace is
+// only reported if it's the sole content of an element; whitespace between elements is treated as
+// indentation and ignored.
+class XmlReader
+{
+public:
+	enum class NodeType
+	{
+		None,
+		StartElement,
+		EndElement,
+		Text
+	};
+
+	struct Attribute
+	{
+		std::wstring name;
+		std::wstring value;
+	};
+
+	explicit XmlReader(std::istream &stream);
+
+	// Advances to the next node. Returns false once the end of the document has been reached, or
+	// if the document is malformed (in which case HasError() will return true).
+	bool Read();
+	bool HasError() const;
+
+	NodeType GetNodeType() const;
+
+	// The name of the current element. Valid for both StartElement and EndElement nodes.
+	const std::wstring &GetName() const;
+
+	// The number of elements that enclose the current node. The root element is at depth 0.
+	size_t GetDepth() const;
+
+	// These are only valid for StartElement nodes. An EndElement node is always reported, even for
+	// an element that's empty (e.g. <Element />).
+	std::span<const Attribute> GetAttributes() const;
+	const std::wstring *MaybeGetAttribute(std::wstring_view name) const;
+
+	// Only valid for Text nodes.
+	const std::wstring &GetText() const;
+
+	// When positioned on a StartElement node, advances to the matching EndElement node, skipping
+	// all the children of the element.
+	bool SkipElement();
+
+private:
+	static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+	int Peek();
+	int Get();
+	bool Consume(std::string_view text);
+	bool SkipPast(std::string_view terminator);
+	void SkipWhitespace();
+	bool ReadName(std::string &output);
+	bool ReadUntil(char terminator, std::string &output);
+	bool DecodeEntities(const std::string &input, std::wstring &output);
+
+	bool ReadStartElement();
+	bool ReadEndElement();
+	bool ReadText();
+	bool SetError();
+
+	std::istream &m_stream;
+	std::string m_buffer;
+	size_t m_position = 0;
+
+	bool m_error = false;
+	bool m_finished = false;
+	bool m_seenRootElement = false;
+	bool m_pendingEndElement = false;
+
+	NodeType m_nodeType = NodeType::None;
+	std::wstring m_name;
+	std::wstring m_text;
+	size_t m_depth = 0;
+	std::vector<Attribute> m_attributes;
+	size_t m_numAttributes = 0;
+	std::vector<std::string> m_openElements;
+
+	// Scratch space, retained between calls to avoid repeated allocations.
+	std::string m_rawName;
+	std::string m_rawValue;
+};
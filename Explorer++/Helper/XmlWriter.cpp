@@ -0,0 +1,268 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "XmlWriter.h"
+#include "XmlReader.h"
+
+XmlWriter::XmlWriter(std::ostream &stream) : m_stream(stream)
+{
+}
+
+XmlWriter::~XmlWriter()
+{
+	Flush();
+}
+
+void XmlWriter::WriteDeclaration()
+{
+	DCHECK(!m_hasOutput);
+
+	m_buffer += R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)";
+	m_hasOutput = true;
+}
+
+void XmlWriter::WriteComment(std::wstring_view comment)
+{
+	CloseStartTag();
+	StartLine();
+
+	if (!m_openElements.empty())
+	{
+		m_openElements.back().hasChildElements = true;
+	}
+
+	m_buffer += "<!--";
+	AppendUtf8(comment);
+	m_buffer += "-->";
+
+	MaybeFlush();
+}
+
+void XmlWriter::StartElement(std::wstring_view name)
+{
+	CloseStartTag();
+
+	if (!m_openElements.empty())
+	{
+		DCHECK(!m_openElements.back().hasText);
+		m_openElements.back().hasChildElements = true;
+	}
+
+	StartLine();
+
+	m_buffer += '<';
+
+	// The encoded name is retained, so that it can be reused when the element is closed.
+	size_t nameStart = m_buffer.size();
+	AppendUtf8(name);
+
+	OpenElement element;
+	element.name = m_buffer.substr(nameStart);
+	m_openElements.push_back(std::move(element));
+	m_startTagOpen = true;
+}
+
+void XmlWriter::WriteAttribute(std::wstring_view name, std::wstring_view value)
+{
+	DCHECK(m_startTagOpen);
+
+	m_buffer += ' ';
+	AppendUtf8(name);
+	m_buffer += "=\"";
+	AppendEscaped(value, true);
+	m_buffer += '"';
+}
+
+void XmlWriter::WriteText(std::wstring_view text)
+{
+	DCHECK(!m_openElements.empty());
+	DCHECK(!m_openElements.back().hasChildElements);
+
+	CloseStartTag();
+	AppendEscaped(text, false);
+	m_openElements.back().hasText = true;
+
+	MaybeFlush();
+}
+
+void XmlWriter::EndElement()
+{
+	CHECK(!m_openElements.empty());
+
+	OpenElement element = std::move(m_openElements.back());
+	m_openElements.pop_back();
+
+	if (m_startTagOpen)
+	{
+		m_buffer += "/>";
+		m_startTagOpen = false;
+	}
+	else
+	{
+		if (element.hasChildElements)
+		{
+			StartLine();
+		}
+
+		m_buffer += "</";
+		m_buffer += element.name;
+		m_buffer += '>';
+	}
+
+	MaybeFlush();
+}
+
+void XmlWriter::WriteNode(const XmlReader &reader)
+{
+	switch (reader.GetNodeType())
+	{
+	case XmlReader::NodeType::StartElement:
+		StartElement(reader.GetName());
+
+		for (const auto &attribute : reader.GetAttributes())
+		{
+			WriteAttribute(attribute.name, attribute.value);
+		}
+		break;
+
+	case XmlReader::NodeType::EndElement:
+		EndElement();
+		break;
+
+	case XmlReader::NodeType::Text:
+		WriteText(reader.GetText());
+		break;
+
+	case XmlReader::NodeType::None:
+		break;
+	}
+}
+
+void XmlWriter::Flush()
+{
+	m_stream.write(m_buffer.data(), m_buffer.size());
+	m_buffer.clear();
+}
+
+void XmlWriter::CloseStartTag()
+{
+	if (m_startTagOpen)
+	{
+		m_buffer += '>';
+		m_startTagOpen = false;
+	}
+}
+
+void XmlWriter::StartLine()
+{
+	if (m_hasOutput)
+	{
+		m_buffer += "\r\n";
+	}
+
+	m_buffer.append(m_openElements.size(), '\t');
+	m_hasOutput = true;
+}
+
+void XmlWriter::AppendEscaped(std::wstring_view text, bool isAttributeValue)
+{
+	size_t start = 0;
+
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		const char *replacement = nullptr;
+
+		switch (text[i])
+		{
+		case L'&':
+			replacement = "&amp;";
+			break;
+
+		case L'<':
+			replacement = "&lt;";
+			break;
+
+		case L'>':
+			replacement = "&gt;";
+			break;
+
+		case L'"':
+			replacement = isAttributeValue ? "&quot;" : nullptr;
+			break;
+
+		// Whitespace within an attribute value would otherwise be normalized to a space when the
+		// value is read back.
+		case L'\t':
+			replacement = isAttributeValue ? "&#9;" : nullptr;
+			break;
+
+		case L'\n':
+			replacement = isAttributeValue ? "&#10;" : nullptr;
+			break;
+
+		case L'\r':
+			replacement = "&#13;";
+			break;
+		}
+
+		if (replacement)
+		{
+			AppendUtf8(text.substr(start, i - start));
+			m_buffer += replacement;
+			start = i + 1;
+		}
+	}
+
+	AppendUtf8(text.substr(start));
+}
+
+void XmlWriter::AppendUtf8(std::wstring_view text)
+{
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		auto codePoint = static_cast<char32_t>(text[i]);
+
+		if constexpr (sizeof(wchar_t) == 2)
+		{
+			if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 1 < text.size()
+				&& text[i + 1] >= 0xDC00 && text[i + 1] <= 0xDFFF)
+			{
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (text[i + 1] - 0xDC00);
+				i++;
+			}
+		}
+
+		if (codePoint < 0x80)
+		{
+			m_buffer += static_cast<char>(codePoint);
+		}
+		else if (codePoint < 0x800)
+		{
+			m_buffer += static_cast<char>(0xC0 | (codePoint >> 6));
+			m_buffer += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else if (codePoint < 0x10000)
+		{
+			m_buffer += static_cast<char>(0xE0 | (codePoint >> 12));
+			m_buffer += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			m_buffer += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			m_buffer += static_cast<char>(0xF0 | (codePoint >> 18));
+			m_buffer += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			m_buffer += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			m_buffer += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+	}
+}
+
+void XmlWriter::MaybeFlush()
+{
+	if (m_buffer.size() >= FLUSH_THRESHOLD)
+	{
+		Flush();
+	}
+}
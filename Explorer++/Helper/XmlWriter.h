@@ -0,0 +1,65 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes UTF-8 encoded XML directly to a stream, as the counterpart to XmlReader. Output is
+// indented with tabs, with each element on its own line. Elements that contain only text are
+// written on a single line and elements without any content are self-closed.
+//
+// Attributes must be written immediately after the element is started, before any text or child
+// elements.
+class XmlReader;
+
+class XmlWriter
+{
+public:
+	explicit XmlWriter(std::ostream &stream);
+	~XmlWriter();
+
+	XmlWriter(const XmlWriter &) = delete;
+	XmlWriter &operator=(const XmlWriter &) = delete;
+
+	void WriteDeclaration();
+	void WriteComment(std::wstring_view comment);
+	void StartElement(std::wstring_view name);
+	void WriteAttribute(std::wstring_view name, std::wstring_view value);
+	void WriteText(std::wstring_view text);
+	void EndElement();
+
+	// Writes out the node the reader is currently positioned on. Calling this for each node that's
+	// read will copy a document (or a subset of a document) from the reader to this writer.
+	void WriteNode(const XmlReader &reader);
+
+	// Writes any buffered output to the stream. This is also done automatically when the writer is
+	// destroyed.
+	void Flush();
+
+private:
+	static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+	struct OpenElement
+	{
+		std::string name;
+		bool hasChildElements = false;
+		bool hasText = false;
+	};
+
+	void CloseStartTag();
+	void StartLine();
+	void AppendEscaped(std::wstring_view text, bool isAttributeValue);
+	void AppendUtf8(std::wstring_view text);
+	void MaybeFlush();
+
+	std::ostream &m_stream;
+	std::string m_buffer;
+	std::vector<OpenElement> m_openElements;
+	bool m_startTagOpen = false;
+	bool m_hasOutput = false;
+};
@@ -0,0 +1,55 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/AtomicFile.h"
+#include "ScopedTestDir.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace testing;
+
+class AtomicFileTest : public Test
+{
+protected:
+	std::wstring GetFilePath() const
+	{
+		return m_scopedTestDir.GetPath() / L"test.txt";
+	}
+
+	std::string ReadFile() const
+	{
+		std::ifstream stream(GetFilePath(), std::ios::binary);
+		std::stringstream contents;
+		contents << stream.rdbuf();
+		return contents.str();
+	}
+
+	ScopedTestDir m_scopedTestDir;
+};
+
+TEST_F(AtomicFileTest, Write)
+{
+	ASSERT_TRUE(AtomicFile::Write(GetFilePath(), "contents"));
+	EXPECT_EQ(ReadFile(), "contents");
+
+	// The temporary file should have been moved into place.
+	EXPECT_FALSE(std::filesystem::exists(GetFilePath() + L".tmp"));
+}
+
+TEST_F(AtomicFileTest, WriteChunks)
+{
+	std::string_view chunks[] = { "first", "", "second" };
+	ASSERT_TRUE(AtomicFile::Write(GetFilePath(), chunks));
+	EXPECT_EQ(ReadFile(), "firstsecond");
+}
+
+TEST_F(AtomicFileTest, Overwrite)
+{
+	ASSERT_TRUE(AtomicFile::Write(GetFilePath(), "a longer first version"));
+	ASSERT_TRUE(AtomicFile::Write(GetFilePath(), "second"));
+	EXPECT_EQ(ReadFile(), "second");
+}
@@ -0,0 +1,133 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "BinaryAppStorage.h"
+#include "BinaryAppStorageFactory.h"
+#include "BookmarkStorageTestHelper.h"
+#include "FrequentLocationsModel.h"
+#include "FrequentLocationsStorageTestHelper.h"
+#include "HistoryModel.h"
+#include "HistoryStorageTestHelper.h"
+#include "MainRebarStorage.h"
+#include "ScopedTestDir.h"
+#include "TabStorage.h"
+#include "WindowStorage.h"
+#include "WindowStorageTestHelper.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "../Helper/SystemClockImpl.h"
+#include <gtest/gtest.h>
+#include <fstream>
+
+using namespace testing;
+
+class BinaryAppStorageTest : public Test
+{
+protected:
+	BinaryAppStorageTest() :
+		m_configFilePath(m_scopedTestDir.GetPath() / L"config.xml"),
+		m_snapshotFilePath(m_scopedTestDir.GetPath() / L"config.snapshot")
+	{
+		WriteConfigFile("<ExplorerPlusPlus />");
+	}
+
+	void WriteConfigFile(const std::string &contents)
+	{
+		std::ofstream stream(m_configFilePath, std::ios::binary | std::ios::trunc);
+		stream << contents;
+	}
+
+	ScopedTestDir m_scopedTestDir;
+	const std::wstring m_configFilePath;
+	const std::wstring m_snapshotFilePath;
+	SystemClockImpl m_systemClock;
+};
+
+TEST_F(BinaryAppStorageTest, SaveLoad)
+{
+	auto referenceWindows =
+		WindowStorageTestHelper::BuildV2ReferenceWindows(TestStorageType::Registry);
+
+	BookmarkTree referenceBookmarkTree;
+	BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+
+	FrequentLocationsModel referenceFrequentLocationsModel(&m_systemClock);
+	FrequentLocationsStorageTestHelper::BuildReferenceModel(&referenceFrequentLocationsModel);
+
+	HistoryModel referenceHistoryModel;
+	HistoryStorageTestHelper::BuildReferenceModel(&referenceHistoryModel);
+
+	auto saveStorage = BinaryAppStorageFactory::MaybeCreate(m_snapshotFilePath, m_configFilePath,
+		Storage::OperationType::Save);
+	ASSERT_NE(saveStorage, nullptr);
+
+	saveStorage->SaveWindows(referenceWindows);
+	saveStorage->SaveBookmarks(&referenceBookmarkTree);
+	saveStorage->SaveFrequentLocations(&referenceFrequentLocationsModel);
+	saveStorage->SaveHistory(&referenceHistoryModel);
+	saveStorage->Commit();
+
+	auto loadStorage = BinaryAppStorageFactory::MaybeCreate(m_snapshotFilePath, m_configFilePath,
+		Storage::OperationType::Load);
+	ASSERT_NE(loadStorage, nullptr);
+
+	EXPECT_EQ(loadStorage->LoadWindows(), referenceWindows);
+
+	BookmarkTree loadedBookmarkTree;
+	loadStorage->LoadBookmarks(&loadedBookmarkTree);
+	CompareBookmarkTrees(&loadedBookmarkTree, &referenceBookmarkTree, true);
+
+	FrequentLocationsModel loadedFrequentLocationsModel(&m_systemClock);
+	loadStorage->LoadFrequentLocations(&loadedFrequentLocationsModel);
+	EXPECT_EQ(loadedFrequentLocationsModel, referenceFrequentLocationsModel);
+
+	HistoryModel loadedHistoryModel;
+	loadStorage->LoadHistory(&loadedHistoryModel);
+	EXPECT_EQ(loadedHistoryModel, referenceHistoryModel);
+}
+
+TEST_F(BinaryAppStorageTest, ConfigFileChanged)
+{
+	auto saveStorage = BinaryAppStorageFactory::MaybeCreate(m_snapshotFilePath, m_configFilePath,
+		Storage::OperationType::Save);
+	ASSERT_NE(saveStorage, nullptr);
+	saveStorage->Commit();
+
+	EXPECT_NE(BinaryAppStorageFactory::MaybeCreate(m_snapshotFilePath, m_configFilePath,
+				  Storage::OperationType::Load),
+		nullptr);
+
+	// The config file has been edited since the snapshot was saved, so the snapshot should be
+	// ignored.
+	WriteConfigFile("<ExplorerPlusPlus><Settings /></ExplorerPlusPlus>");
+
+	EXPECT_EQ(BinaryAppStorageFactory::MaybeCreate(m_snapshotFilePath, m_configFilePath,
+				  Storage::OperationType::Load),
+		nullptr);
+}
+
+TEST(BinaryAppStorageSectionsTest, ParseSections)
+{
+	std::string payload;
+
+	auto appendSection = [&payload](uint32_t id, std::string_view data)
+	{
+		uint64_t size = data.size();
+		payload.append(reinterpret_cast<const char *>(&id), sizeof(id));
+		payload.append(reinterpret_cast<const char *>(&size), sizeof(size));
+		payload += data;
+	};
+
+	appendSection(static_cast<uint32_t>(BinaryAppStorage::SectionId::Windows), "windows");
+	appendSection(1000, "unknown");
+	appendSection(static_cast<uint32_t>(BinaryAppStorage::SectionId::Bookmarks), "");
+
+	auto sections = BinaryAppStorage::MaybeParseSections(payload);
+	ASSERT_TRUE(sections.has_value());
+	EXPECT_EQ(sections->at(BinaryAppStorage::SectionId::Windows), "windows");
+	EXPECT_EQ(sections->at(BinaryAppStorage::SectionId::Bookmarks), "");
+
+	payload.pop_back();
+	EXPECT_FALSE(BinaryAppStorage::MaybeParseSections(payload).has_value());
+}
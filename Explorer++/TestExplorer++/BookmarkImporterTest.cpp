@@ -0,0 +1,192 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Bookmarks/BookmarkImporter.h"
+#include "Bookmarks/BookmarkTree.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace testing;
+
+namespace
+{
+
+uint64_t FileTimeToUint64(const FILETIME &fileTime)
+{
+	return (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+}
+
+}
+
+TEST(BookmarkImporterTest, NetscapeHtml)
+{
+	std::istringstream stream(R"(<!DOCTYPE NETSCAPE-Bookmark-file-1>
+<!-- This is an automatically generated file.
+     It will be read and overwritten.
+     DO NOT EDIT! -->
+<META HTTP-EQUIV="Content-Type" CONTENT="text/html; charset=UTF-8">
+<TITLE>Bookmarks</TITLE>
+<H1>Bookmarks</H1>
+<DL><p>
+    <DT><H3 ADD_DATE="1600000000" PERSONAL_TOOLBAR_FOLDER="true">Bookmarks bar</H3>
+    <DL><p>
+        <DT><A HREF="https://example.com/?a=1&amp;b=2" ADD_DATE="1600000000">Example &lt;1&gt;</A>
+        <DT><H3>Empty folder</H3>
+        <DT><H3>Nested folder</H3>
+        <DL><p>
+            <DT><A HREF="https://example.org">Nested bookmark</A>
+        </DL><p>
+    </DL><p>
+    <DT><a href="https://example.net">Lowercase tags</a>
+</DL><p>
+)");
+
+	auto bookmarkItems = BookmarkImporter::ParseNetscapeHtml(stream);
+	ASSERT_TRUE(bookmarkItems.has_value());
+	ASSERT_EQ(bookmarkItems->size(), 2U);
+
+	const auto *toolbarFolder = (*bookmarkItems)[0].get();
+	EXPECT_TRUE(toolbarFolder->IsFolder());
+	EXPECT_EQ(toolbarFolder->GetName(), L"Bookmarks bar");
+	ASSERT_EQ(toolbarFolder->GetChildren().size(), 3U);
+
+	const auto *bookmark = toolbarFolder->GetChildAtIndex(0);
+	EXPECT_TRUE(bookmark->IsBookmark());
+	EXPECT_EQ(bookmark->GetName(), L"Example <1>");
+	EXPECT_EQ(bookmark->GetLocation(), L"https://example.com/?a=1&b=2");
+
+	// 1600000000 seconds after the Unix epoch.
+	EXPECT_EQ(FileTimeToUint64(bookmark->GetDateCreated()), 132444736000000000U);
+
+	const auto *emptyFolder = toolbarFolder->GetChildAtIndex(1);
+	EXPECT_TRUE(emptyFolder->IsFolder());
+	EXPECT_EQ(emptyFolder->GetName(), L"Empty folder");
+	EXPECT_TRUE(emptyFolder->GetChildren().empty());
+
+	const auto *nestedFolder = toolbarFolder->GetChildAtIndex(2);
+	ASSERT_EQ(nestedFolder->GetChildren().size(), 1U);
+	EXPECT_EQ(nestedFolder->GetChildAtIndex(0)->GetName(), L"Nested bookmark");
+	EXPECT_EQ(nestedFolder->GetChildAtIndex(0)->GetLocation(), L"https://example.org");
+
+	const auto *topLevelBookmark = (*bookmarkItems)[1].get();
+	EXPECT_EQ(topLevelBookmark->GetName(), L"Lowercase tags");
+	EXPECT_EQ(topLevelBookmark->GetLocation(), L"https://example.net");
+}
+
+TEST(BookmarkImporterTest, NetscapeHtmlInvalid)
+{
+	std::istringstream stream("This isn't a bookmarks file");
+	EXPECT_FALSE(BookmarkImporter::ParseNetscapeHtml(stream).has_value());
+}
+
+TEST(BookmarkImporterTest, ChromiumJson)
+{
+	std::istringstream stream(R"({
+   "checksum": "00000000000000000000000000000000",
+   "roots": {
+      "bookmark_bar": {
+         "children": [ {
+            "date_added": "13250000000000000",
+            "guid": "00000000-0000-4000-a000-000000000001",
+            "id": "2",
+            "meta_info": { "last_visited": "13250000000000000" },
+            "name": "Example",
+            "type": "url",
+            "url": "https://example.com/"
+         }, {
+            "children": [ {
+               "name": "Nested bookmark",
+               "type": "url",
+               "url": "https://example.org/"
+            } ],
+            "name": "Nested folder",
+            "type": "folder"
+         } ],
+         "name": "Bookmarks bar",
+         "type": "folder"
+      },
+      "other": {
+         "children": [ ],
+         "name": "Other bookmarks",
+         "type": "folder"
+      }
+   },
+   "version": 1
+})");
+
+	auto bookmarkItems = BookmarkImporter::ParseChromiumJson(stream);
+	ASSERT_TRUE(bookmarkItems.has_value());
+
+	// The "other" folder is empty, so it shouldn't be returned.
+	ASSERT_EQ(bookmarkItems->size(), 1U);
+
+	const auto *toolbarFolder = (*bookmarkItems)[0].get();
+	EXPECT_EQ(toolbarFolder->GetName(), L"Bookmarks bar");
+	ASSERT_EQ(toolbarFolder->GetChildren().size(), 2U);
+
+	const auto *bookmark = toolbarFolder->GetChildAtIndex(0);
+	EXPECT_TRUE(bookmark->IsBookmark());
+	EXPECT_EQ(bookmark->GetName(), L"Example");
+	EXPECT_EQ(bookmark->GetLocation(), L"https://example.com/");
+
+	// Chromium stores dates as microseconds, rather than 100-nanosecond intervals.
+	EXPECT_EQ(FileTimeToUint64(bookmark->GetDateCreated()), 132500000000000000U);
+
+	const auto *nestedFolder = toolbarFolder->GetChildAtIndex(1);
+	EXPECT_TRUE(nestedFolder->IsFolder());
+	ASSERT_EQ(nestedFolder->GetChildren().size(), 1U);
+	EXPECT_EQ(nestedFolder->GetChildAtIndex(0)->GetName(), L"Nested bookmark");
+}
+
+TEST(BookmarkImporterTest, ChromiumJsonInvalid)
+{
+	std::istringstream truncatedStream(R"({ "roots": { "bookmark_bar": {)");
+	EXPECT_FALSE(BookmarkImporter::ParseChromiumJson(truncatedStream).has_value());
+
+	std::istringstream otherJsonStream(R"({ "name": "value" })");
+	EXPECT_FALSE(BookmarkImporter::ParseChromiumJson(otherJsonStream).has_value());
+}
+
+// Exercises the full import path (parsing, followed by a single bulk insertion) with a large
+// number of bookmarks.
+TEST(BookmarkImporterTest, LargeImport)
+{
+	const int numFolders = 50;
+	const int numBookmarksPerFolder = 1000;
+
+	std::string html = "<!DOCTYPE NETSCAPE-Bookmark-file-1>\n<DL><p>\n";
+
+	for (int i = 0; i < numFolders; i++)
+	{
+		html += "<DT><H3>Folder " + std::to_string(i) + "</H3>\n<DL><p>\n";
+
+		for (int j = 0; j < numBookmarksPerFolder; j++)
+		{
+			html += "<DT><A HREF=\"https://example.com/" + std::to_string(j)
+				+ "\" ADD_DATE=\"1600000000\">Bookmark " + std::to_string(j) + "</A>\n";
+		}
+
+		html += "</DL><p>\n";
+	}
+
+	html += "</DL><p>\n";
+
+	std::istringstream stream(html);
+	auto bookmarkItems = BookmarkImporter::ParseNetscapeHtml(stream);
+	ASSERT_TRUE(bookmarkItems.has_value());
+
+	BookmarkTree bookmarkTree;
+	auto addedItems = bookmarkTree.AddBookmarkItems(bookmarkTree.GetOtherBookmarksFolder(),
+		std::move(*bookmarkItems));
+	ASSERT_EQ(addedItems.size(), static_cast<size_t>(numFolders));
+
+	for (const auto *folder : addedItems)
+	{
+		EXPECT_EQ(folder->GetChildren().size(), static_cast<size_t>(numBookmarksPerFolder));
+	}
+
+	const auto *lastBookmark = addedItems.back()->GetChildren().back().get();
+	EXPECT_EQ(bookmarkTree.MaybeGetBookmarkItemById(lastBookmark->GetGUID()), lastBookmark);
+}
@@ -0,0 +1,133 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
+#include "Bookmarks/BookmarkTree.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iterator>
+
+using namespace testing;
+
+class BookmarkSearchIndexTest : public Test
+{
+protected:
+	std::vector<BookmarkItem *> Search(const BookmarkSearchIndex &index, std::wstring_view query)
+	{
+		std::vector<BookmarkItem *> bookmarkItems;
+		std::ranges::transform(index.Search(query, 10), std::back_inserter(bookmarkItems),
+			&BookmarkSearchIndex::Result::bookmarkItem);
+		return bookmarkItems;
+	}
+
+	BookmarkItem *AddBookmark(BookmarkItem *parent, const std::wstring &name,
+		const std::wstring &location)
+	{
+		return m_bookmarkTree.AddBookmarkItem(parent,
+			std::make_unique<BookmarkItem>(std::nullopt, name, location));
+	}
+
+	BookmarkTree m_bookmarkTree;
+};
+
+TEST_F(BookmarkSearchIndexTest, ExistingItems)
+{
+	auto *bookmark = AddBookmark(m_bookmarkTree.GetBookmarksToolbarFolder(), L"Explorer++",
+		L"https://explorerplusplus.com");
+
+	BookmarkSearchIndex index(&m_bookmarkTree);
+	EXPECT_THAT(Search(index, L"explorer"), ElementsAre(bookmark));
+
+	// The permanent folders shouldn't be returned.
+	EXPECT_THAT(Search(index, L"bookmarks"), IsEmpty());
+}
+
+TEST_F(BookmarkSearchIndexTest, AddItems)
+{
+	BookmarkSearchIndex index(&m_bookmarkTree);
+
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Music", std::nullopt);
+	auto *bookmark = folder->AddChild(std::make_unique<BookmarkItem>(std::nullopt, L"Playlist",
+		L"https://example.com/music"));
+	auto *rawFolder = m_bookmarkTree.AddBookmarkItem(m_bookmarkTree.GetBookmarksMenuFolder(),
+		std::move(folder));
+
+	// The name of the folder should be ranked above the location of the bookmark.
+	EXPECT_THAT(Search(index, L"music"), ElementsAre(rawFolder, bookmark));
+}
+
+TEST_F(BookmarkSearchIndexTest, UpdateItem)
+{
+	BookmarkSearchIndex index(&m_bookmarkTree);
+
+	auto *bookmark =
+		AddBookmark(m_bookmarkTree.GetOtherBookmarksFolder(), L"Old name", L"C:\\Old location");
+
+	bookmark->SetName(L"New name");
+	EXPECT_THAT(Search(index, L"new name"), ElementsAre(bookmark));
+
+	bookmark->SetLocation(L"D:\\Archive");
+	EXPECT_THAT(Search(index, L"archive"), ElementsAre(bookmark));
+	EXPECT_THAT(Search(index, L"old"), IsEmpty());
+}
+
+TEST_F(BookmarkSearchIndexTest, RemoveItems)
+{
+	BookmarkSearchIndex index(&m_bookmarkTree);
+
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Photos folder", std::nullopt);
+	folder->AddChild(
+		std::make_unique<BookmarkItem>(std::nullopt, L"Photos", L"C:\\Users\\Photos"));
+	auto *rawFolder = m_bookmarkTree.AddBookmarkItem(m_bookmarkTree.GetBookmarksMenuFolder(),
+		std::move(folder));
+	auto *otherBookmark =
+		AddBookmark(m_bookmarkTree.GetOtherBookmarksFolder(), L"More photos", L"D:\\Photos");
+
+	m_bookmarkTree.RemoveBookmarkItem(rawFolder);
+	EXPECT_THAT(Search(index, L"photos"), ElementsAre(otherBookmark));
+}
+
+// Records how long it takes to index, then search, a large collection of bookmarks.
+TEST_F(BookmarkSearchIndexTest, LargeCollection)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int NUM_BOOKMARKS = 100'000;
+
+	BookmarkItems bookmarkItems;
+	bookmarkItems.reserve(NUM_BOOKMARKS);
+
+	for (int i = 0; i < NUM_BOOKMARKS; i++)
+	{
+		bookmarkItems.push_back(std::make_unique<BookmarkItem>(std::nullopt,
+			std::format(L"Bookmark {}", i),
+			std::format(L"https://example{}.com/page{}", i % 1000, i)));
+	}
+
+	m_bookmarkTree.AddBookmarkItems(m_bookmarkTree.GetOtherBookmarksFolder(),
+		std::move(bookmarkItems));
+
+	auto indexStart = Clock::now();
+	BookmarkSearchIndex index(&m_bookmarkTree);
+	auto indexDuration = Clock::now() - indexStart;
+
+	auto searchStart = Clock::now();
+	auto results = index.Search(L"12345", 10);
+	auto searchDuration = Clock::now() - searchStart;
+
+	ASSERT_FALSE(results.empty());
+	EXPECT_EQ(results[0].bookmarkItem->GetName(), L"Bookmark 12345");
+
+	RecordProperty("NumBookmarks", std::to_string(NUM_BOOKMARKS));
+	RecordProperty("IndexMilliseconds",
+		std::to_string(
+			std::chrono::duration_cast<std::chrono::milliseconds>(indexDuration).count()));
+	RecordProperty("SearchMicroseconds",
+		std::to_string(
+			std::chrono::duration_cast<std::chrono::microseconds>(searchDuration).count()));
+}
@@ -104,6 +104,31 @@ TEST_F(BookmarkTreeTest, AddChildrenAtEnd)
 		addedItems));
 }
 
+TEST_F(BookmarkTreeTest, AddMultipleItems)
+{
+	auto *parentFolder = m_bookmarkTree.GetOtherBookmarksFolder();
+	auto *existingItem = m_bookmarkTree.AddBookmarkItem(parentFolder,
+		std::make_unique<BookmarkItem>(std::nullopt, L"Existing item", L"C:\\"));
+
+	BookmarkItems bookmarkItems;
+	bookmarkItems.push_back(std::make_unique<BookmarkItem>(std::nullopt, L"Item 1", L"D:\\"));
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Item 2", std::nullopt);
+	auto *nestedBookmark = folder->AddChild(
+		std::make_unique<BookmarkItem>(std::nullopt, L"Nested item", L"E:\\"));
+	bookmarkItems.push_back(std::move(folder));
+
+	auto addedItems = m_bookmarkTree.AddBookmarkItems(parentFolder, std::move(bookmarkItems), 0);
+	ASSERT_EQ(addedItems.size(), 2U);
+
+	EXPECT_EQ(parentFolder->GetChildren().size(), 3U);
+	EXPECT_EQ(parentFolder->GetChildIndex(addedItems[0]), 0U);
+	EXPECT_EQ(parentFolder->GetChildIndex(addedItems[1]), 1U);
+	EXPECT_EQ(parentFolder->GetChildIndex(existingItem), 2U);
+
+	// Nested items should be registered as well.
+	EXPECT_EQ(m_bookmarkTree.MaybeGetBookmarkItemById(nestedBookmark->GetGUID()), nestedBookmark);
+}
+
 TEST_F(BookmarkTreeTest, MoveChildren)
 {
 	auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, L"Test bookmark", L"C:\\");
@@ -252,6 +277,27 @@ TEST_F(BookmarkTreeObserverTest, Add)
 	m_bookmarkTree.AddBookmarkItem(rawFolder, std::move(bookmark), 0);
 }
 
+TEST_F(BookmarkTreeObserverTest, AddMultiple)
+{
+	m_bookmarkTree.bookmarkItemAddedSignal.AddObserver(
+		std::bind_front(&BookmarkTreeObserver::OnBookmarkItemAdded, &m_observer));
+
+	BookmarkItems bookmarkItems;
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Folder", std::nullopt);
+	folder->AddChild(std::make_unique<BookmarkItem>(std::nullopt, L"Nested item", L"C:\\"));
+	auto *rawFolder = folder.get();
+	bookmarkItems.push_back(std::move(folder));
+	bookmarkItems.push_back(std::make_unique<BookmarkItem>(std::nullopt, L"Bookmark", L"D:\\"));
+	auto *rawBookmark = bookmarkItems.back().get();
+
+	// A notification should only be sent for each of the top-level items.
+	InSequence seq;
+	EXPECT_CALL(m_observer, OnBookmarkItemAdded(Ref(*rawFolder), 1));
+	EXPECT_CALL(m_observer, OnBookmarkItemAdded(Ref(*rawBookmark), 2));
+	m_bookmarkTree.AddBookmarkItems(m_bookmarkTree.GetBookmarksMenuFolder(),
+		std::move(bookmarkItems));
+}
+
 TEST_F(BookmarkTreeObserverTest, Update)
 {
 	m_bookmarkTree.bookmarkItemUpdatedSignal.AddObserver(
@@ -0,0 +1,105 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Bookmarks/BookmarkXmlStreamStorage.h"
+#include "BookmarkStorageTestHelper.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "ResourceTestHelper.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+
+using namespace testing;
+
+namespace
+{
+
+bool MoveToBookmarksNode(XmlReader &reader)
+{
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::StartElement
+			&& reader.GetName() == BookmarkXmlStreamStorage::BOOKMARKS_NODE_NAME)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
+
+TEST(BookmarkXmlStreamStorageTest, V2Load)
+{
+	BookmarkTree referenceBookmarkTree;
+	BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+
+	std::ifstream stream(GetResourcePath(L"bookmarks-v2.xml"), std::ios::binary);
+	XmlReader reader(stream);
+	ASSERT_TRUE(MoveToBookmarksNode(reader));
+
+	auto bookmarksData = BookmarkXmlStreamStorage::Load(reader);
+	ASSERT_TRUE(bookmarksData.has_value());
+
+	BookmarkTree loadedBookmarkTree;
+	BookmarkXmlStreamStorage::AddToTree(std::move(*bookmarksData), &loadedBookmarkTree);
+
+	CompareBookmarkTrees(&loadedBookmarkTree, &referenceBookmarkTree, true);
+}
+
+TEST(BookmarkXmlStreamStorageTest, V2LoadUpdateObserverInvokedOnce)
+{
+	std::ifstream stream(GetResourcePath(L"bookmarks-v2.xml"), std::ios::binary);
+	XmlReader reader(stream);
+	ASSERT_TRUE(MoveToBookmarksNode(reader));
+
+	auto bookmarksData = BookmarkXmlStreamStorage::Load(reader);
+	ASSERT_TRUE(bookmarksData.has_value());
+
+	BookmarkTree loadedBookmarkTree;
+	BookmarkXmlStreamStorage::AddToTree(std::move(*bookmarksData), &loadedBookmarkTree);
+
+	PerformV2UpdateObserverInvokedOnceTest(&loadedBookmarkTree);
+}
+
+TEST(BookmarkXmlStreamStorageTest, V2Save)
+{
+	BookmarkTree referenceBookmarkTree;
+	BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+
+	std::stringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		BookmarkXmlStreamStorage::Save(writer, &referenceBookmarkTree);
+	}
+
+	XmlReader reader(stream);
+	ASSERT_TRUE(MoveToBookmarksNode(reader));
+
+	auto bookmarksData = BookmarkXmlStreamStorage::Load(reader);
+	ASSERT_TRUE(bookmarksData.has_value());
+
+	BookmarkTree loadedBookmarkTree;
+	BookmarkXmlStreamStorage::AddToTree(std::move(*bookmarksData), &loadedBookmarkTree);
+
+	CompareBookmarkTrees(&loadedBookmarkTree, &referenceBookmarkTree, true);
+}
+
+TEST(BookmarkXmlStreamStorageTest, LoadMalformed)
+{
+	std::istringstream stream(R"(<Bookmarksv2>
+	<PermanentItem name="BookmarksToolbar">
+		<Bookmark name="0" Type="0" ItemName="Folder">
+	</PermanentItem>
+</Bookmarksv2>)");
+	XmlReader reader(stream);
+	ASSERT_TRUE(MoveToBookmarksNode(reader));
+
+	EXPECT_FALSE(BookmarkXmlStreamStorage::Load(reader).has_value());
+}
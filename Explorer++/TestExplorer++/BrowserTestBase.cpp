@@ -12,7 +12,9 @@
 
 BrowserTestBase::BrowserTestBase() :
 	m_cachedIcons(10),
-	m_resourceLoader(GetModuleHandle(nullptr), IconSet::Color, nullptr, nullptr)
+	m_resourceLoader(GetModuleHandle(nullptr), IconSet::Color, nullptr, nullptr),
+	m_taskExecutor(std::make_shared<concurrencpp::manual_executor>()),
+	m_taskScheduler({ m_taskExecutor, m_taskExecutor, m_taskExecutor }, 1)
 {
 }
 
@@ -21,8 +23,8 @@ BrowserTestBase::~BrowserTestBase() = default;
 BrowserWindowFake *BrowserTestBase::AddBrowser()
 {
 	auto browser = std::make_unique<BrowserWindowFake>(&m_config, &m_tabEvents,
-		&m_shellBrowserEvents, &m_navigationEvents, &m_cachedIcons, &m_bookmarkTree,
-		&m_acceleratorManager, &m_resourceLoader, &m_platformContext);
+		&m_shellBrowserEvents, &m_navigationEvents, &m_cachedIcons, &m_taskScheduler,
+		&m_bookmarkTree, &m_acceleratorManager, &m_resourceLoader, &m_platformContext);
 	auto *rawBrowser = browser.get();
 
 	m_browsers.push_back(std::move(browser));
@@ -12,9 +12,11 @@
 #include "ShellBrowser/NavigationEvents.h"
 #include "ShellBrowser/ShellBrowserEvents.h"
 #include "TabEvents.h"
+#include "TaskScheduler.h"
 #include "Win32ResourceLoader.h"
 #include "../Helper/CachedIcons.h"
 #include "../Helper/PidlHelper.h"
+#include <concurrencpp/concurrencpp.h>
 #include <gtest/gtest.h>
 #include <memory>
 #include <string>
@@ -42,6 +44,10 @@ protected:
 	CachedIcons m_cachedIcons;
 	Win32ResourceLoader m_resourceLoader;
 
+	// Tasks queued on this scheduler are never run.
+	const std::shared_ptr<concurrencpp::manual_executor> m_taskExecutor;
+	TaskScheduler m_taskScheduler;
+
 	TabEvents m_tabEvents;
 	ShellBrowserEvents m_shellBrowserEvents;
 	NavigationEvents m_navigationEvents;
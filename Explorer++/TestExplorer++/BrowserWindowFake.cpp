@@ -17,7 +17,7 @@
 
 BrowserWindowFake::BrowserWindowFake(const Config *config, TabEvents *tabEvents,
 	ShellBrowserEvents *shellBrowserEvents, NavigationEvents *navigationEvents,
-	CachedIcons *cachedIcons, BookmarkTree *bookmarkTree,
+	CachedIcons *cachedIcons, TaskScheduler *taskScheduler, BookmarkTree *bookmarkTree,
 	const AcceleratorManager *acceleratorManager, const ResourceLoader *resourceLoader,
 	PlatformContext *platformContext) :
 	m_config(config),
@@ -25,7 +25,8 @@ BrowserWindowFake::BrowserWindowFake(const Config *config, TabEvents *tabEvents,
 	m_shellBrowserFactory(this, navigationEvents),
 	m_tabContainer(TabContainer::Create(MainTabView::Create(m_window.get(), config, resourceLoader),
 		this, &m_shellBrowserFactory, tabEvents, shellBrowserEvents, navigationEvents, nullptr,
-		cachedIcons, bookmarkTree, acceleratorManager, config, resourceLoader, platformContext))
+		cachedIcons, taskScheduler, bookmarkTree, acceleratorManager, config, resourceLoader,
+		platformContext))
 {
 }
 
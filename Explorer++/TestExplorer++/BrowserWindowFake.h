@@ -20,13 +20,14 @@ class ResourceLoader;
 class ShellBrowserEvents;
 class Tab;
 class TabEvents;
+class TaskScheduler;
 
 class BrowserWindowFake : public BrowserWindow
 {
 public:
 	BrowserWindowFake(const Config *config, TabEvents *tabEvents,
 		ShellBrowserEvents *shellBrowserEvents, NavigationEvents *navigationEvents,
-		CachedIcons *cachedIcons, BookmarkTree *bookmarkTree,
+		CachedIcons *cachedIcons, TaskScheduler *taskScheduler, BookmarkTree *bookmarkTree,
 		const AcceleratorManager *acceleratorManager, const ResourceLoader *resourceLoader,
 		PlatformContext *platformContext);
 
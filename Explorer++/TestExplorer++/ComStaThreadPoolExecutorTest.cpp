@@ -8,7 +8,14 @@
 #include "ExecutorTestHelper.h"
 #include "../Helper/MessageWindowHelper.h"
 #include "../Helper/WindowHelper.h"
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
 
 using namespace testing;
 
@@ -19,6 +26,31 @@ protected:
 	{
 	}
 
+	ComStaThreadPoolExecutor *GetPool()
+	{
+		return static_cast<ComStaThreadPoolExecutor *>(m_executor.get());
+	}
+
+	// Queues a task that blocks the (single) worker thread until the returned promise is
+	// fulfilled. This function only returns once the task has started.
+	std::shared_ptr<std::promise<void>> BlockWorkerThread()
+	{
+		auto releasePromise = std::make_shared<std::promise<void>>();
+		auto startedPromise = std::make_shared<std::promise<void>>();
+		auto startedFuture = startedPromise->get_future();
+
+		m_executor->post(
+			[releaseFuture = releasePromise->get_future().share(), startedPromise]
+			{
+				startedPromise->set_value();
+				releaseFuture.wait();
+			});
+
+		EXPECT_EQ(startedFuture.wait_for(TASK_TIMEOUT_DURATION), std::future_status::ready);
+
+		return releasePromise;
+	}
+
 	void QueueMessage(HWND hwnd)
 	{
 		std::chrono::milliseconds durationMs = TASK_TIMEOUT_DURATION;
@@ -84,3 +116,160 @@ TEST_F(ComStaThreadPoolExecutorTest, ShutdownRequested)
 	m_executor->shutdown();
 	EXPECT_TRUE(m_executor->shutdown_requested());
 }
+
+TEST_F(ComStaThreadPoolExecutorTest, PriorityOrdering)
+{
+	using TaskPriority = ComStaThreadPoolExecutor::TaskPriority;
+
+	auto releasePromise = BlockWorkerThread();
+
+	// The order is only updated on the worker thread, so doesn't need to be synchronized.
+	std::vector<TaskPriority> order;
+	auto finishedPromise = std::make_shared<std::promise<void>>();
+	auto finishedFuture = finishedPromise->get_future();
+
+	GetPool()->GetExecutorForPriority(TaskPriority::Background)->post(
+		[&order, finishedPromise]
+		{
+			order.push_back(TaskPriority::Background);
+			finishedPromise->set_value();
+		});
+	GetPool()->GetExecutorForPriority(TaskPriority::Visible)->post(
+		[&order] { order.push_back(TaskPriority::Visible); });
+	m_executor->post([&order] { order.push_back(TaskPriority::Interactive); });
+
+	releasePromise->set_value();
+	ASSERT_EQ(finishedFuture.wait_for(TASK_TIMEOUT_DURATION), std::future_status::ready);
+
+	// Although the tasks were queued in the opposite order, they should have been run in priority
+	// order.
+	EXPECT_THAT(order,
+		ElementsAre(TaskPriority::Interactive, TaskPriority::Visible, TaskPriority::Background));
+}
+
+TEST_F(ComStaThreadPoolExecutorTest, Stats)
+{
+	using TaskPriority = ComStaThreadPoolExecutor::TaskPriority;
+
+	auto releasePromise = BlockWorkerThread();
+
+	auto visibleExecutor = GetPool()->GetExecutorForPriority(TaskPriority::Visible);
+	auto backgroundExecutor = GetPool()->GetExecutorForPriority(TaskPriority::Background);
+
+	visibleExecutor->post([] {});
+	visibleExecutor->post([] {});
+	backgroundExecutor->post([] {});
+	backgroundExecutor->post([] {});
+
+	auto finishedPromise = std::make_shared<std::promise<void>>();
+	auto finishedFuture = finishedPromise->get_future();
+	backgroundExecutor->post([finishedPromise] { finishedPromise->set_value(); });
+
+	auto stats = GetPool()->GetStats();
+	EXPECT_EQ(stats.lanes[static_cast<size_t>(TaskPriority::Interactive)].queueDepth, 0u);
+	EXPECT_EQ(stats.lanes[static_cast<size_t>(TaskPriority::Visible)].queueDepth, 2u);
+	EXPECT_EQ(stats.lanes[static_cast<size_t>(TaskPriority::Background)].queueDepth, 3u);
+
+	releasePromise->set_value();
+	ASSERT_EQ(finishedFuture.wait_for(TASK_TIMEOUT_DURATION), std::future_status::ready);
+
+	stats = GetPool()->GetStats();
+
+	for (const auto &lane : stats.lanes)
+	{
+		EXPECT_EQ(lane.queueDepth, 0u);
+		EXPECT_LE(lane.maxQueueLatency, lane.totalQueueLatency);
+	}
+
+	EXPECT_EQ(stats.lanes[static_cast<size_t>(TaskPriority::Interactive)].numTasksStarted, 1u);
+	EXPECT_EQ(stats.lanes[static_cast<size_t>(TaskPriority::Visible)].numTasksStarted, 2u);
+	EXPECT_EQ(stats.lanes[static_cast<size_t>(TaskPriority::Background)].numTasksStarted, 3u);
+
+	// There's only a single thread, so there's nothing to steal from.
+	EXPECT_EQ(stats.numTasksStolen, 0u);
+}
+
+// Runs a large number of tiny tasks, queued from several threads at once (as well as from the
+// pool's own threads), to check that every task is run and to measure the throughput.
+TEST(ComStaThreadPoolExecutorStressTest, ManySmallTasks)
+{
+	using TaskPriority = ComStaThreadPoolExecutor::TaskPriority;
+
+	constexpr int NUM_THREADS = 4;
+	constexpr int NUM_PRODUCERS = 4;
+	constexpr int NUM_TASKS_PER_PRODUCER = 5000;
+
+	// Every tenth task queues a child task, from the worker thread it's running on.
+	constexpr int NUM_CHILD_TASKS_PER_PRODUCER = NUM_TASKS_PER_PRODUCER / 10;
+	constexpr int TOTAL_TASKS =
+		NUM_PRODUCERS * (NUM_TASKS_PER_PRODUCER + NUM_CHILD_TASKS_PER_PRODUCER);
+
+	auto pool = std::make_shared<ComStaThreadPoolExecutor>(NUM_THREADS);
+
+	std::atomic<int> numTasksRun = 0;
+	std::promise<void> finishedPromise;
+	auto finishedFuture = finishedPromise.get_future();
+
+	auto onTaskRun = [&]
+	{
+		if (++numTasksRun == TOTAL_TASKS)
+		{
+			finishedPromise.set_value();
+		}
+	};
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	std::vector<std::jthread> producers;
+
+	for (int i = 0; i < NUM_PRODUCERS; i++)
+	{
+		producers.emplace_back(
+			[&]
+			{
+				for (int j = 0; j < NUM_TASKS_PER_PRODUCER; j++)
+				{
+					auto priority = static_cast<TaskPriority>(j % 3);
+
+					pool->GetExecutorForPriority(priority)->post(
+						[&, priority, queueChild = (j % 10 == 0)]
+						{
+							if (queueChild)
+							{
+								pool->GetExecutorForPriority(priority)->post(onTaskRun);
+							}
+
+							onTaskRun();
+						});
+				}
+			});
+	}
+
+	producers.clear();
+
+	ASSERT_EQ(finishedFuture.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - startTime);
+
+	auto stats = pool->GetStats();
+	pool->shutdown();
+
+	uint64_t numTasksStarted = 0;
+	std::chrono::nanoseconds maxQueueLatency = {};
+
+	for (const auto &lane : stats.lanes)
+	{
+		numTasksStarted += lane.numTasksStarted;
+		maxQueueLatency = std::max(maxQueueLatency, lane.maxQueueLatency);
+	}
+
+	EXPECT_EQ(numTasksStarted, static_cast<uint64_t>(TOTAL_TASKS));
+
+	RecordProperty("TotalTasks", std::to_string(TOTAL_TASKS));
+	RecordProperty("ElapsedMicroseconds", std::to_string(elapsed.count()));
+	RecordProperty("TasksStolen", std::to_string(stats.numTasksStolen));
+	RecordProperty("MaxQueueLatencyMicroseconds",
+		std::to_string(
+			std::chrono::duration_cast<std::chrono::microseconds>(maxQueueLatency).count()));
+}
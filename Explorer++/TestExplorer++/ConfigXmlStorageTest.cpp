@@ -7,8 +7,32 @@
 #include "Config.h"
 #include "ConfigStorageTestHelper.h"
 #include "ResourceTestHelper.h"
+#include "Storage.h"
 #include "XmlStorageTestHelper.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+bool MoveToSettingsNode(XmlReader &reader)
+{
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::StartElement
+			&& reader.GetName() == Storage::CONFIG_FILE_SETTINGS_NODE_NAME)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
 
 class ConfigXmlStorageTest : public XmlStorageTest
 {
@@ -37,3 +61,41 @@ TEST_F(ConfigXmlStorageTest, OpenZipFilesSettingMigration)
 
 	EXPECT_TRUE(loadedConfig.openContainerFiles);
 }
+
+TEST(ConfigXmlStreamStorageTest, SaveLoad)
+{
+	auto referenceConfig = ConfigStorageTestHelper::BuildReference();
+
+	std::stringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		ConfigXmlStorage::Save(writer, referenceConfig);
+	}
+
+	XmlReader reader(stream);
+	ASSERT_TRUE(reader.Read());
+
+	auto settings = ConfigXmlStorage::ReadSettings(reader);
+	ASSERT_TRUE(settings.has_value());
+
+	Config loadedConfig;
+	ConfigXmlStorage::Load(*settings, loadedConfig);
+
+	EXPECT_EQ(loadedConfig, referenceConfig);
+}
+
+TEST(ConfigXmlStreamStorageTest, OpenZipFilesSettingMigration)
+{
+	std::ifstream stream(GetResourcePath(L"config-migration.xml"), std::ios::binary);
+	XmlReader reader(stream);
+	ASSERT_TRUE(MoveToSettingsNode(reader));
+
+	auto settings = ConfigXmlStorage::ReadSettings(reader);
+	ASSERT_TRUE(settings.has_value());
+
+	Config loadedConfig;
+	ConfigXmlStorage::Load(*settings, loadedConfig);
+
+	EXPECT_TRUE(loadedConfig.openContainerFiles);
+}
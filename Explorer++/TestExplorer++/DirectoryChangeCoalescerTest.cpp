@@ -0,0 +1,213 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "DirectoryChangeCoalescer.h"
+#include "ShellTestHelper.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+using Event = DirectoryWatcher::Event;
+using Change = DirectoryChangeCoalescer::Change;
+
+class DirectoryChangeCoalescerTest : public Test
+{
+protected:
+	DirectoryChangeCoalescerTest() :
+		m_directory(CreateSimplePidlForTest(L"C:\\Fake")),
+		m_item1(CreateSimplePidlForTest(L"C:\\Fake\\Item1")),
+		m_item2(CreateSimplePidlForTest(L"C:\\Fake\\Item2")),
+		m_item3(CreateSimplePidlForTest(L"C:\\Fake\\Item3"))
+	{
+	}
+
+	void AddChange(Event event, const PidlAbsolute &pidl1, const PidlAbsolute &pidl2 = {})
+	{
+		m_coalescer.AddChange(event, pidl1, pidl2);
+	}
+
+	DirectoryChangeCoalescer m_coalescer;
+
+	const PidlAbsolute m_directory;
+	const PidlAbsolute m_item1;
+	const PidlAbsolute m_item2;
+	const PidlAbsolute m_item3;
+};
+
+TEST_F(DirectoryChangeCoalescerTest, NoChanges)
+{
+	EXPECT_FALSE(m_coalescer.HasChanges());
+	EXPECT_THAT(m_coalescer.TakeChanges(), IsEmpty());
+}
+
+TEST_F(DirectoryChangeCoalescerTest, IndividualChanges)
+{
+	AddChange(Event::Added, m_item1);
+	AddChange(Event::Modified, m_item2);
+	AddChange(Event::Removed, m_item3);
+	EXPECT_TRUE(m_coalescer.HasChanges());
+
+	EXPECT_THAT(m_coalescer.TakeChanges(),
+		ElementsAre(Change{ Event::Added, m_item1, {} }, Change{ Event::Modified, m_item2, {} },
+			Change{ Event::Removed, m_item3, {} }));
+
+	// Taking the changes should reset the state.
+	EXPECT_FALSE(m_coalescer.HasChanges());
+	EXPECT_THAT(m_coalescer.TakeChanges(), IsEmpty());
+}
+
+TEST_F(DirectoryChangeCoalescerTest, AddedThenRemoved)
+{
+	AddChange(Event::Added, m_item1);
+	AddChange(Event::Modified, m_item1);
+	AddChange(Event::Removed, m_item1);
+
+	EXPECT_FALSE(m_coalescer.HasChanges());
+	EXPECT_THAT(m_coalescer.TakeChanges(), IsEmpty());
+}
+
+TEST_F(DirectoryChangeCoalescerTest, AddedThenModified)
+{
+	AddChange(Event::Added, m_item1);
+	AddChange(Event::Modified, m_item1);
+	AddChange(Event::Modified, m_item1);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(), ElementsAre(Change{ Event::Added, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, ModifiedMultipleTimes)
+{
+	AddChange(Event::Modified, m_item1);
+	AddChange(Event::Modified, m_item1);
+	AddChange(Event::Modified, m_item1);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(), ElementsAre(Change{ Event::Modified, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, RemovedThenAdded)
+{
+	// This is what happens when a file is replaced (e.g. by a source control tool).
+	AddChange(Event::Removed, m_item1);
+	AddChange(Event::Added, m_item1);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(), ElementsAre(Change{ Event::Modified, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, ModifiedThenRemoved)
+{
+	AddChange(Event::Modified, m_item1);
+	AddChange(Event::Removed, m_item1);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(), ElementsAre(Change{ Event::Removed, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, RenamedMultipleTimes)
+{
+	AddChange(Event::Renamed, m_item1, m_item2);
+	AddChange(Event::Modified, m_item2);
+	AddChange(Event::Renamed, m_item2, m_item3);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(),
+		ElementsAre(Change{ Event::Renamed, m_item1, m_item3 }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, RenamedBackToOriginalName)
+{
+	AddChange(Event::Renamed, m_item1, m_item2);
+	AddChange(Event::Renamed, m_item2, m_item1);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(), IsEmpty());
+}
+
+TEST_F(DirectoryChangeCoalescerTest, AddedThenRenamed)
+{
+	AddChange(Event::Added, m_item1);
+	AddChange(Event::Renamed, m_item1, m_item2);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(), ElementsAre(Change{ Event::Added, m_item2, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, RenamedThenRemoved)
+{
+	AddChange(Event::Renamed, m_item1, m_item2);
+	AddChange(Event::Removed, m_item2);
+
+	// The item should be removed using the name it had originally.
+	EXPECT_THAT(m_coalescer.TakeChanges(), ElementsAre(Change{ Event::Removed, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, RenamedOntoChangedItem)
+{
+	AddChange(Event::Removed, m_item2);
+	AddChange(Event::Renamed, m_item1, m_item2);
+
+	EXPECT_THAT(m_coalescer.TakeChanges(),
+		ElementsAre(Change{ Event::Modified, m_item2, {} }, Change{ Event::Removed, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, SafeSave)
+{
+	// This is the sequence of changes generated when an application saves a file by writing to a
+	// temporary file, moving the original file to a backup, moving the temporary file into place,
+	// then deleting the backup.
+	auto tempFile = CreateSimplePidlForTest(L"C:\\Fake\\Item1.tmp");
+	auto backupFile = CreateSimplePidlForTest(L"C:\\Fake\\Item1.bak");
+
+	AddChange(Event::Added, tempFile);
+	AddChange(Event::Renamed, m_item1, backupFile);
+	AddChange(Event::Renamed, tempFile, m_item1);
+	AddChange(Event::Removed, backupFile);
+
+	// The file still exists, so shouldn't be removed.
+	EXPECT_THAT(m_coalescer.TakeChanges(), ElementsAre(Change{ Event::Modified, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, Swap)
+{
+	AddChange(Event::Renamed, m_item1, m_item3);
+	AddChange(Event::Renamed, m_item2, m_item1);
+	AddChange(Event::Renamed, m_item3, m_item2);
+
+	// Both names are still in use, so the items shouldn't be renamed onto each other.
+	EXPECT_THAT(m_coalescer.TakeChanges(),
+		ElementsAre(Change{ Event::Modified, m_item2, {} },
+			Change{ Event::Modified, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, RenamedOntoVacatedName)
+{
+	AddChange(Event::Renamed, m_item2, m_item3);
+	AddChange(Event::Renamed, m_item1, m_item2);
+
+	// The item now called item2 is a different item, so its details need to be updated.
+	EXPECT_THAT(m_coalescer.TakeChanges(),
+		ElementsAre(Change{ Event::Added, m_item3, {} }, Change{ Event::Modified, m_item2, {} },
+			Change{ Event::Removed, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, DirectoryContentsChanged)
+{
+	AddChange(Event::Added, m_item1);
+	AddChange(Event::DirectoryContentsChanged, m_directory);
+	AddChange(Event::Removed, m_item1);
+
+	// Changes shouldn't be merged across the directory change.
+	EXPECT_THAT(m_coalescer.TakeChanges(),
+		ElementsAre(Change{ Event::Added, m_item1, {} },
+			Change{ Event::DirectoryContentsChanged, m_directory, {} },
+			Change{ Event::Removed, m_item1, {} }));
+}
+
+TEST_F(DirectoryChangeCoalescerTest, Clear)
+{
+	AddChange(Event::Added, m_item1);
+	AddChange(Event::DirectoryContentsChanged, m_directory);
+	EXPECT_TRUE(m_coalescer.HasChanges());
+
+	m_coalescer.Clear();
+	EXPECT_FALSE(m_coalescer.HasChanges());
+	EXPECT_THAT(m_coalescer.TakeChanges(), IsEmpty());
+}
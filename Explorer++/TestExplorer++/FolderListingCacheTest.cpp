@@ -0,0 +1,170 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "FolderListingCache.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+namespace
+{
+
+std::vector<PidlChild> BuildListing(const std::wstring &folder,
+	const std::vector<std::wstring> &names)
+{
+	std::vector<PidlChild> items;
+
+	for (const auto &name : names)
+	{
+		items.push_back(CreateSimplePidlForTest(folder + L"\\" + name).GetLastItem());
+	}
+
+	return items;
+}
+
+}
+
+TEST(FolderListingCacheTest, StoreAndGet)
+{
+	FolderListingCache cache;
+	PidlAbsolute folder = CreateSimplePidlForTest(L"c:\\folder");
+
+	EXPECT_EQ(cache.MaybeGet(folder, SHCONTF_FOLDERS), nullptr);
+
+	auto listing = BuildListing(L"c:\\folder", { L"a", L"b", L"c" });
+	cache.Store(folder, SHCONTF_FOLDERS, listing);
+
+	auto items = cache.MaybeGet(folder, SHCONTF_FOLDERS);
+	ASSERT_NE(items, nullptr);
+	EXPECT_TRUE(FolderListingCache::AreListingsEqual(*items, listing));
+	EXPECT_EQ(cache.GetNumListings(), 1u);
+	EXPECT_EQ(cache.GetNumItems(), 3u);
+
+	// Storing a listing for the same folder and flags should replace the existing listing.
+	cache.Store(folder, SHCONTF_FOLDERS, BuildListing(L"c:\\folder", { L"d" }));
+	EXPECT_EQ(cache.GetNumListings(), 1u);
+	EXPECT_EQ(cache.GetNumItems(), 1u);
+}
+
+TEST(FolderListingCacheTest, EnumerationFlags)
+{
+	FolderListingCache cache;
+	PidlAbsolute folder = CreateSimplePidlForTest(L"c:\\folder");
+
+	cache.Store(folder, SHCONTF_FOLDERS, BuildListing(L"c:\\folder", { L"a" }));
+
+	// A listing is only valid for the flags that were used to enumerate it.
+	EXPECT_EQ(cache.MaybeGet(folder, SHCONTF_FOLDERS | SHCONTF_INCLUDEHIDDEN), nullptr);
+
+	cache.Store(folder, SHCONTF_FOLDERS | SHCONTF_INCLUDEHIDDEN,
+		BuildListing(L"c:\\folder", { L"a", L"hidden" }));
+	EXPECT_EQ(cache.GetNumListings(), 2u);
+	EXPECT_EQ(cache.MaybeGet(folder, SHCONTF_FOLDERS)->size(), 1u);
+	EXPECT_EQ(cache.MaybeGet(folder, SHCONTF_FOLDERS | SHCONTF_INCLUDEHIDDEN)->size(), 2u);
+}
+
+TEST(FolderListingCacheTest, MaxListings)
+{
+	FolderListingCache cache(2, 100);
+	PidlAbsolute folder1 = CreateSimplePidlForTest(L"c:\\folder1");
+	PidlAbsolute folder2 = CreateSimplePidlForTest(L"c:\\folder2");
+	PidlAbsolute folder3 = CreateSimplePidlForTest(L"c:\\folder3");
+
+	cache.Store(folder1, SHCONTF_FOLDERS, BuildListing(L"c:\\folder1", { L"a" }));
+	cache.Store(folder2, SHCONTF_FOLDERS, BuildListing(L"c:\\folder2", { L"a" }));
+
+	// This should make the listing for folder1 the most recently used, so that the listing for
+	// folder2 is the one that's removed below.
+	EXPECT_NE(cache.MaybeGet(folder1, SHCONTF_FOLDERS), nullptr);
+
+	cache.Store(folder3, SHCONTF_FOLDERS, BuildListing(L"c:\\folder3", { L"a" }));
+	EXPECT_EQ(cache.GetNumListings(), 2u);
+	EXPECT_NE(cache.MaybeGet(folder1, SHCONTF_FOLDERS), nullptr);
+	EXPECT_EQ(cache.MaybeGet(folder2, SHCONTF_FOLDERS), nullptr);
+	EXPECT_NE(cache.MaybeGet(folder3, SHCONTF_FOLDERS), nullptr);
+}
+
+TEST(FolderListingCacheTest, MaxTotalItems)
+{
+	FolderListingCache cache(10, 4);
+	PidlAbsolute folder1 = CreateSimplePidlForTest(L"c:\\folder1");
+	PidlAbsolute folder2 = CreateSimplePidlForTest(L"c:\\folder2");
+	PidlAbsolute folder3 = CreateSimplePidlForTest(L"c:\\folder3");
+
+	cache.Store(folder1, SHCONTF_FOLDERS, BuildListing(L"c:\\folder1", { L"a", L"b" }));
+	cache.Store(folder2, SHCONTF_FOLDERS, BuildListing(L"c:\\folder2", { L"a", L"b" }));
+	EXPECT_EQ(cache.GetNumItems(), 4u);
+
+	cache.Store(folder3, SHCONTF_FOLDERS, BuildListing(L"c:\\folder3", { L"a" }));
+	EXPECT_EQ(cache.GetNumListings(), 2u);
+	EXPECT_EQ(cache.GetNumItems(), 3u);
+	EXPECT_EQ(cache.MaybeGet(folder1, SHCONTF_FOLDERS), nullptr);
+
+	// A listing that exceeds the limit by itself shouldn't be stored, nor should it cause any
+	// existing listings to be removed.
+	PidlAbsolute largeFolder = CreateSimplePidlForTest(L"c:\\large");
+	cache.Store(largeFolder, SHCONTF_FOLDERS,
+		BuildListing(L"c:\\large", { L"a", L"b", L"c", L"d", L"e" }));
+	EXPECT_EQ(cache.MaybeGet(largeFolder, SHCONTF_FOLDERS), nullptr);
+	EXPECT_EQ(cache.GetNumListings(), 2u);
+	EXPECT_EQ(cache.GetNumItems(), 3u);
+}
+
+TEST(FolderListingCacheTest, Invalidate)
+{
+	FolderListingCache cache;
+	PidlAbsolute folder1 = CreateSimplePidlForTest(L"c:\\folder1");
+	PidlAbsolute folder2 = CreateSimplePidlForTest(L"c:\\folder2");
+
+	cache.Store(folder1, SHCONTF_FOLDERS, BuildListing(L"c:\\folder1", { L"a" }));
+	cache.Store(folder1, SHCONTF_FOLDERS | SHCONTF_INCLUDEHIDDEN,
+		BuildListing(L"c:\\folder1", { L"a", L"b" }));
+	cache.Store(folder2, SHCONTF_FOLDERS, BuildListing(L"c:\\folder2", { L"a" }));
+
+	// All listings for the folder should be removed, regardless of the enumeration flags.
+	cache.Invalidate(folder1);
+	EXPECT_EQ(cache.GetNumListings(), 1u);
+	EXPECT_EQ(cache.GetNumItems(), 1u);
+	EXPECT_NE(cache.MaybeGet(folder2, SHCONTF_FOLDERS), nullptr);
+
+	cache.Clear();
+	EXPECT_EQ(cache.GetNumListings(), 0u);
+	EXPECT_EQ(cache.GetNumItems(), 0u);
+}
+
+TEST(FolderListingCacheTest, AreListingsEqual)
+{
+	auto listing = BuildListing(L"c:\\folder", { L"a", L"b", L"c" });
+
+	EXPECT_TRUE(FolderListingCache::AreListingsEqual(listing, listing));
+	EXPECT_TRUE(FolderListingCache::AreListingsEqual(listing,
+		BuildListing(L"c:\\folder", { L"c", L"a", L"b" })));
+
+	EXPECT_FALSE(FolderListingCache::AreListingsEqual(listing,
+		BuildListing(L"c:\\folder", { L"a", L"b" })));
+	EXPECT_FALSE(FolderListingCache::AreListingsEqual(listing,
+		BuildListing(L"c:\\folder", { L"a", L"b", L"d" })));
+}
+
+TEST(FolderListingCacheTest, Lifetime)
+{
+	using namespace std::chrono_literals;
+
+	FolderListingCache cache;
+	PidlAbsolute folder1 = CreateSimplePidlForTest(L"c:\\folder1");
+	PidlAbsolute folder2 = CreateSimplePidlForTest(L"c:\\folder2");
+
+	cache.Store(folder1, SHCONTF_FOLDERS, BuildListing(L"c:\\folder1", { L"a" }), 1h);
+	EXPECT_TRUE(cache.Contains(folder1, SHCONTF_FOLDERS));
+	EXPECT_NE(cache.MaybeGet(folder1, SHCONTF_FOLDERS), nullptr);
+
+	// A listing that has expired shouldn't be returned.
+	cache.Store(folder2, SHCONTF_FOLDERS, BuildListing(L"c:\\folder2", { L"a" }), 0s);
+	EXPECT_FALSE(cache.Contains(folder2, SHCONTF_FOLDERS));
+	EXPECT_EQ(cache.MaybeGet(folder2, SHCONTF_FOLDERS), nullptr);
+	EXPECT_EQ(cache.GetNumListings(), 1u);
+	EXPECT_EQ(cache.GetNumItems(), 1u);
+}
@@ -0,0 +1,172 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "FolderPrefetcher.h"
+#include "FolderListingCache.h"
+#include "ShellEnumeratorFake.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+class FolderPrefetcherTest : public Test
+{
+protected:
+	FolderPrefetcherTest() :
+		m_listingCache(std::make_shared<FolderListingCache>()),
+		m_shellEnumerator(std::make_shared<ShellEnumeratorFake>()),
+		m_executor(std::make_shared<concurrencpp::manual_executor>()),
+		m_prefetcher(m_listingCache, m_executor)
+	{
+	}
+
+	void RunExecutor()
+	{
+		m_executor->loop(std::numeric_limits<size_t>::max());
+	}
+
+	bool IsCached(const PidlAbsolute &folder)
+	{
+		return m_listingCache->Contains(folder, m_shellEnumerator->GetEnumerationFlags());
+	}
+
+	const std::shared_ptr<FolderListingCache> m_listingCache;
+	const std::shared_ptr<ShellEnumeratorFake> m_shellEnumerator;
+	const std::shared_ptr<concurrencpp::manual_executor> m_executor;
+	FolderPrefetcher m_prefetcher;
+};
+
+TEST_F(FolderPrefetcherTest, Prefetch)
+{
+	PidlAbsolute folder1 = CreateSimplePidlForTest(L"c:\\folder1");
+	PidlAbsolute folder2 = CreateSimplePidlForTest(L"c:\\folder2");
+
+	m_prefetcher.Prefetch(folder1, m_shellEnumerator);
+	m_prefetcher.Prefetch(folder2, m_shellEnumerator);
+
+	// Only a single folder is enumerated at a time, so the second request should be queued.
+	EXPECT_EQ(m_prefetcher.GetNumQueuedRequests(), 1u);
+
+	RunExecutor();
+	EXPECT_EQ(m_prefetcher.GetNumQueuedRequests(), 0u);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 2);
+	EXPECT_TRUE(IsCached(folder1));
+	EXPECT_TRUE(IsCached(folder2));
+}
+
+TEST_F(FolderPrefetcherTest, CachedFolderIgnored)
+{
+	PidlAbsolute folder = CreateSimplePidlForTest(L"c:\\folder");
+	m_listingCache->Store(folder, m_shellEnumerator->GetEnumerationFlags(), {});
+
+	m_prefetcher.Prefetch(folder, m_shellEnumerator);
+	RunExecutor();
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 0);
+}
+
+TEST_F(FolderPrefetcherTest, DuplicateRequests)
+{
+	PidlAbsolute folder1 = CreateSimplePidlForTest(L"c:\\folder1");
+	PidlAbsolute folder2 = CreateSimplePidlForTest(L"c:\\folder2");
+
+	m_prefetcher.Prefetch(folder1, m_shellEnumerator);
+	m_prefetcher.Prefetch(folder2, m_shellEnumerator);
+	m_prefetcher.Prefetch(folder2, m_shellEnumerator);
+	EXPECT_EQ(m_prefetcher.GetNumQueuedRequests(), 1u);
+
+	RunExecutor();
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 2);
+}
+
+TEST_F(FolderPrefetcherTest, MaxQueuedRequests)
+{
+	for (size_t i = 0; i < FolderPrefetcher::MAX_QUEUED_REQUESTS + 5; i++)
+	{
+		m_prefetcher.Prefetch(CreateSimplePidlForTest(L"c:\\folder" + std::to_wstring(i)),
+			m_shellEnumerator);
+	}
+
+	EXPECT_EQ(m_prefetcher.GetNumQueuedRequests(), FolderPrefetcher::MAX_QUEUED_REQUESTS);
+
+	RunExecutor();
+
+	// The first request is started immediately, with the oldest of the remaining requests being
+	// dropped once the queue is full.
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(),
+		static_cast<int>(FolderPrefetcher::MAX_QUEUED_REQUESTS + 1));
+	EXPECT_TRUE(IsCached(CreateSimplePidlForTest(L"c:\\folder0")));
+	EXPECT_FALSE(IsCached(CreateSimplePidlForTest(L"c:\\folder1")));
+	EXPECT_TRUE(IsCached(CreateSimplePidlForTest(
+		L"c:\\folder" + std::to_wstring(FolderPrefetcher::MAX_QUEUED_REQUESTS + 4))));
+}
+
+TEST_F(FolderPrefetcherTest, CancelAll)
+{
+	PidlAbsolute folder1 = CreateSimplePidlForTest(L"c:\\folder1");
+	PidlAbsolute folder2 = CreateSimplePidlForTest(L"c:\\folder2");
+
+	m_prefetcher.Prefetch(folder1, m_shellEnumerator);
+	m_prefetcher.Prefetch(folder2, m_shellEnumerator);
+
+	m_prefetcher.CancelAll();
+	EXPECT_EQ(m_prefetcher.GetNumQueuedRequests(), 0u);
+
+	RunExecutor();
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 0);
+	EXPECT_FALSE(IsCached(folder1));
+	EXPECT_FALSE(IsCached(folder2));
+
+	// Requests made after the cancellation should be processed as normal.
+	m_prefetcher.Prefetch(folder1, m_shellEnumerator);
+	RunExecutor();
+	EXPECT_TRUE(IsCached(folder1));
+}
+
+TEST_F(FolderPrefetcherTest, FailedEnumerationNotStored)
+{
+	PidlAbsolute folder = CreateSimplePidlForTest(L"c:\\folder");
+
+	m_shellEnumerator->SetShouldSucceed(false);
+	m_prefetcher.Prefetch(folder, m_shellEnumerator);
+	RunExecutor();
+	EXPECT_FALSE(IsCached(folder));
+}
+
+TEST_F(FolderPrefetcherTest, LargeListingNotStored)
+{
+	PidlAbsolute folder = CreateSimplePidlForTest(L"c:\\folder");
+
+	m_shellEnumerator->SetNumItems(FolderPrefetcher::MAX_ITEMS_PER_LISTING + 1);
+	m_prefetcher.Prefetch(folder, m_shellEnumerator);
+	RunExecutor();
+	EXPECT_FALSE(IsCached(folder));
+}
+
+TEST_F(FolderPrefetcherTest, FolderFilter)
+{
+	PidlAbsolute allowedFolder = CreateSimplePidlForTest(L"c:\\allowed");
+	PidlAbsolute filteredFolder = CreateSimplePidlForTest(L"c:\\filtered");
+
+	auto executor = std::make_shared<concurrencpp::manual_executor>();
+	std::vector<PidlAbsolute> checkedFolders;
+	FolderPrefetcher prefetcher(m_listingCache, executor,
+		[&checkedFolders, &allowedFolder](const PidlAbsolute &folder)
+		{
+			checkedFolders.push_back(folder);
+			return folder == allowedFolder;
+		});
+
+	prefetcher.Prefetch(allowedFolder, m_shellEnumerator);
+	prefetcher.Prefetch(filteredFolder, m_shellEnumerator);
+
+	// The filter should only be run on the executor, not when the request is made.
+	EXPECT_TRUE(checkedFolders.empty());
+
+	executor->loop(std::numeric_limits<size_t>::max());
+	EXPECT_EQ(checkedFolders.size(), 2u);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+	EXPECT_TRUE(IsCached(allowedFolder));
+	EXPECT_FALSE(IsCached(filteredFolder));
+}
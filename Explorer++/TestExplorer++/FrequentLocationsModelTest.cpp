@@ -8,6 +8,7 @@
 #include "ShellTestHelper.h"
 #include "SystemClockFake.h"
 #include "../Helper/StringHelper.h"
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 using namespace std::chrono_literals;
@@ -37,6 +38,15 @@ SystemClock::TimePoint BuildTimePoint(int year, int month, int day, int hour, in
 	return timePoint;
 }
 
+// The frecency of a location that's been visited multiple times depends on the time of each visit,
+// so it won't be exactly equal to the frecency of a LocationVisitInfo constructed in a test. This
+// matcher compares the remaining fields.
+MATCHER_P3(VisitMatches, location, numVisits, lastVisitTime, "")
+{
+	return arg.GetLocation() == location && arg.GetNumVisits() == numVisits
+		&& arg.GetLastVisitTime() == lastVisitTime;
+}
+
 }
 
 HRESULT PrintPath(const LocationVisitInfo &locationInfo, std::ostream *os)
@@ -120,9 +130,9 @@ TEST_F(FrequentLocationsModelTest, RepeatedVisits)
 
 	const auto &visits = m_frequentLocationsModel.GetVisits();
 
-	std::vector<LocationVisitInfo> expectedVisits = { { fake1, 3, SystemClock::TimePoint(2s) },
-		{ fake2, 1, SystemClock::TimePoint(3s) } };
-	EXPECT_THAT(visits, ElementsAreArray(expectedVisits));
+	EXPECT_THAT(visits,
+		ElementsAre(VisitMatches(fake1, 3, SystemClock::TimePoint(2s)),
+			VisitMatches(fake2, 1, SystemClock::TimePoint(3s))));
 }
 
 TEST_F(FrequentLocationsModelTest, VisitCountOrderChanges)
@@ -136,23 +146,23 @@ TEST_F(FrequentLocationsModelTest, VisitCountOrderChanges)
 
 	const auto &visits = m_frequentLocationsModel.GetVisits();
 
-	std::vector<LocationVisitInfo> expectedVisits = { { fake2, 2, SystemClock::TimePoint(2s) },
-		{ fake1, 1, SystemClock::TimePoint(0s) } };
-	EXPECT_THAT(visits, ElementsAreArray(expectedVisits));
+	EXPECT_THAT(visits,
+		ElementsAre(VisitMatches(fake2, 2, SystemClock::TimePoint(2s)),
+			VisitMatches(fake1, 1, SystemClock::TimePoint(0s))));
 
 	m_frequentLocationsModel.RegisterLocationVisit(fake1);
 	m_frequentLocationsModel.RegisterLocationVisit(fake1);
 
-	expectedVisits = { { fake1, 3, SystemClock::TimePoint(4s) },
-		{ fake2, 2, SystemClock::TimePoint(2s) } };
-	EXPECT_THAT(visits, ElementsAreArray(expectedVisits));
+	EXPECT_THAT(visits,
+		ElementsAre(VisitMatches(fake1, 3, SystemClock::TimePoint(4s)),
+			VisitMatches(fake2, 2, SystemClock::TimePoint(2s))));
 
 	m_frequentLocationsModel.RegisterLocationVisit(fake2);
 	m_frequentLocationsModel.RegisterLocationVisit(fake2);
 
-	expectedVisits = { { fake2, 4, SystemClock::TimePoint(6s) },
-		{ fake1, 3, SystemClock::TimePoint(4s) } };
-	EXPECT_THAT(visits, ElementsAreArray(expectedVisits));
+	EXPECT_THAT(visits,
+		ElementsAre(VisitMatches(fake2, 4, SystemClock::TimePoint(6s)),
+			VisitMatches(fake1, 3, SystemClock::TimePoint(4s))));
 }
 
 TEST_F(FrequentLocationsModelTest, VisitTimeOrderChanges)
@@ -168,18 +178,19 @@ TEST_F(FrequentLocationsModelTest, VisitTimeOrderChanges)
 
 	const auto &visits = m_frequentLocationsModel.GetVisits();
 
-	// fake2 is the most recently visited item, so it should appear first.
-	std::vector<LocationVisitInfo> expectedVisits = { { fake2, 2, SystemClock::TimePoint(3s) },
-		{ fake1, 2, SystemClock::TimePoint(2s) } };
-	EXPECT_THAT(visits, ElementsAreArray(expectedVisits));
+	// Both items have been visited the same number of times, but the visits to fake2 are more
+	// recent, so it should appear first.
+	EXPECT_THAT(visits,
+		ElementsAre(VisitMatches(fake2, 2, SystemClock::TimePoint(3s)),
+			VisitMatches(fake1, 2, SystemClock::TimePoint(2s))));
 
-	m_frequentLocationsModel.RegisterLocationVisit(fake2);
+	m_frequentLocationsModel.RegisterLocationVisit(fake1);
 	m_frequentLocationsModel.RegisterLocationVisit(fake1);
 
-	// fake1 is now the most recently visited item.
-	expectedVisits = { { fake1, 3, SystemClock::TimePoint(5s) },
-		{ fake2, 3, SystemClock::TimePoint(4s) } };
-	EXPECT_THAT(visits, ElementsAreArray(expectedVisits));
+	// fake1 now has the most recent visits.
+	EXPECT_THAT(visits,
+		ElementsAre(VisitMatches(fake1, 4, SystemClock::TimePoint(5s)),
+			VisitMatches(fake2, 2, SystemClock::TimePoint(3s))));
 }
 
 TEST_F(FrequentLocationsModelTest, LocationsChangedEvent)
@@ -212,7 +223,64 @@ TEST_F(FrequentLocationsModelTest, SetLocationVisits)
 
 	m_frequentLocationsModel.SetLocationVisits({ location1, location2, location3 });
 
-	// Once the locations have been added, they should be sorted in descending order of their visit
-	// counts.
-	EXPECT_THAT(m_frequentLocationsModel.GetVisits(), ElementsAre(location2, location3, location1));
+	// Once the locations have been added, they should be sorted in descending order of frecency.
+	// Although location2 has the most visits, its visits are the oldest and have decayed the most.
+	EXPECT_THAT(m_frequentLocationsModel.GetVisits(), ElementsAre(location1, location3, location2));
+}
+
+TEST_F(FrequentLocationsModelTest, OldVisitsDecay)
+{
+	auto oldLocation = FrequentLocationsStorageTestHelper::BuildFrequentLocation(L"c:\\fake1", 100,
+		BuildTimePoint(2023, 1, 1, 12, 0));
+	auto recentLocation = FrequentLocationsStorageTestHelper::BuildFrequentLocation(L"c:\\fake2", 5,
+		BuildTimePoint(2024, 12, 1, 12, 0));
+	auto lessRecentLocation = FrequentLocationsStorageTestHelper::BuildFrequentLocation(
+		L"c:\\fake3", 5, BuildTimePoint(2024, 11, 1, 12, 0));
+
+	m_frequentLocationsModel.SetLocationVisits({ oldLocation, recentLocation, lessRecentLocation });
+
+	// A location that was heavily used in the past should eventually be ranked below locations that
+	// have been visited more recently.
+	EXPECT_THAT(m_frequentLocationsModel.GetVisits(),
+		ElementsAre(recentLocation, lessRecentLocation, oldLocation));
+}
+
+TEST_F(FrequentLocationsModelTest, MaxLocations)
+{
+	FrequentLocationsModel frequentLocationsModel(&m_systemClock, 2);
+
+	PidlAbsolute fake1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	frequentLocationsModel.RegisterLocationVisit(fake1);
+	frequentLocationsModel.RegisterLocationVisit(fake1);
+
+	PidlAbsolute fake2 = CreateSimplePidlForTest(L"C:\\Fake2");
+	frequentLocationsModel.RegisterLocationVisit(fake2);
+
+	PidlAbsolute fake3 = CreateSimplePidlForTest(L"C:\\Fake3");
+	frequentLocationsModel.RegisterLocationVisit(fake3);
+
+	// The location with the lowest frecency should have been removed.
+	EXPECT_THAT(frequentLocationsModel.GetVisits(),
+		ElementsAre(VisitMatches(fake1, 2, SystemClock::TimePoint(1s)),
+			VisitMatches(fake3, 1, SystemClock::TimePoint(3s))));
+}
+
+TEST(LocationVisitInfoTest, Frecency)
+{
+	auto visitTime = BuildTimePoint(2024, 6, 1, 12, 0);
+	LocationVisitInfo visitInfo(CreateSimplePidlForTest(L"c:\\fake"), 1, visitTime);
+	EXPECT_DOUBLE_EQ(visitInfo.GetFrecency(visitTime), 1);
+
+	// The score of each visit should halve every half-life.
+	EXPECT_DOUBLE_EQ(visitInfo.GetFrecency(visitTime + LocationVisitInfo::FRECENCY_HALF_LIFE),
+		0.5);
+	EXPECT_DOUBLE_EQ(visitInfo.GetFrecency(visitTime + (2 * LocationVisitInfo::FRECENCY_HALF_LIFE)),
+		0.25);
+
+	// A second visit at the same time should double the frecency.
+	auto frecencyKey = visitInfo.GetFrecencyKey();
+	visitInfo.AddVisit(visitTime);
+	EXPECT_GT(visitInfo.GetFrecencyKey(), frecencyKey);
+	EXPECT_DOUBLE_EQ(visitInfo.GetFrecency(visitTime), 2);
+	EXPECT_DOUBLE_EQ(visitInfo.GetFrecency(visitTime + LocationVisitInfo::FRECENCY_HALF_LIFE), 1);
 }
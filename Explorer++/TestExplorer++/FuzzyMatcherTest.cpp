@@ -0,0 +1,73 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FuzzyMatcher.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+namespace
+{
+
+std::optional<int> Match(std::wstring_view query, std::wstring_view text)
+{
+	return FuzzyMatcher(query).Match(FuzzyMatcher::NormalizeText(text));
+}
+
+}
+
+TEST(FuzzyMatcherTest, EmptyQuery)
+{
+	EXPECT_EQ(Match(L"", L"C:\\Windows"), 0);
+	EXPECT_EQ(Match(L"", L""), 0);
+}
+
+TEST(FuzzyMatcherTest, Match)
+{
+	EXPECT_TRUE(Match(L"windows", L"C:\\Windows"));
+	EXPECT_TRUE(Match(L"WINDOWS", L"C:\\Windows"));
+	EXPECT_TRUE(Match(L"dcmnts", L"C:\\Users\\Documents"));
+	EXPECT_TRUE(Match(L"c:usrs", L"C:\\Users"));
+}
+
+TEST(FuzzyMatcherTest, NoMatch)
+{
+	EXPECT_FALSE(Match(L"system", L"C:\\Windows"));
+
+	// The characters need to appear in the same order as in the query.
+	EXPECT_FALSE(Match(L"swodniw", L"C:\\Windows"));
+
+	EXPECT_FALSE(Match(L"documents", L"docs"));
+	EXPECT_FALSE(Match(L"a", L""));
+}
+
+TEST(FuzzyMatcherTest, Ranking)
+{
+	// A contiguous match should score higher than a scattered match.
+	EXPECT_GT(*Match(L"doc", L"C:\\Documents"), *Match(L"doc", L"D:\\Old Code"));
+
+	// A match at the start of a word should score higher than a match in the middle of a word.
+	EXPECT_GT(*Match(L"port", L"C:\\Reports\\Port"), *Match(L"port", L"C:\\Reports"));
+	EXPECT_GT(*Match(L"pf", L"C:\\Program Files"), *Match(L"pf", L"C:\\Temp\\Profile"));
+
+	// Matches with fewer gaps should score higher.
+	EXPECT_GT(*Match(L"wnd", L"Windows"), *Match(L"wnd", L"Wide Window"));
+}
+
+TEST(FuzzyMatcherTest, Refines)
+{
+	FuzzyMatcher matcher(L"doc");
+
+	EXPECT_TRUE(FuzzyMatcher(L"doc").Refines(matcher));
+	EXPECT_TRUE(FuzzyMatcher(L"docu").Refines(matcher));
+	EXPECT_TRUE(FuzzyMatcher(L"DOCUMENTS").Refines(matcher));
+
+	EXPECT_FALSE(FuzzyMatcher(L"do").Refines(matcher));
+	EXPECT_FALSE(FuzzyMatcher(L"dcu").Refines(matcher));
+	EXPECT_FALSE(FuzzyMatcher(L"").Refines(matcher));
+
+	// Every query refines the empty query.
+	EXPECT_TRUE(matcher.Refines(FuzzyMatcher(L"")));
+}
@@ -11,6 +11,8 @@
 #include "MenuViewFake.h"
 #include "MenuViewFakeTestHelper.h"
 #include "ShellIconLoaderFake.h"
+#include "ShellTestHelper.h"
+#include <format>
 #include <gtest/gtest.h>
 
 class HistoryMenuTest : public BrowserTestBase
@@ -57,3 +59,72 @@ TEST_F(HistoryMenuTest, CheckItems)
 
 	MenuViewFakeTestHelper::CheckItemDetails(&m_menuView, { pidl5, pidl4, pidl3, pidl2, pidl1 });
 }
+
+TEST_F(HistoryMenuTest, ExistingItemMovedToFront)
+{
+	PidlAbsolute pidl1;
+	m_browser->AddTab(L"c:\\windows", {}, &pidl1);
+
+	PidlAbsolute pidl2;
+	m_browser->AddTab(L"d:\\project\\documents", {}, &pidl2);
+
+	PidlAbsolute pidl3;
+	m_browser->AddTab(L"c:\\users", {}, &pidl3);
+
+	m_browser->AddTab(L"c:\\windows");
+
+	MenuViewFakeTestHelper::CheckItemDetails(&m_menuView, { pidl1, pidl3, pidl2 });
+}
+
+TEST_F(HistoryMenuTest, MaxItems)
+{
+	std::vector<PidlAbsolute> pidls;
+
+	for (int i = 0; i < 25; i++)
+	{
+		pidls.push_back(CreateSimplePidlForTest(std::format(L"c:\\folder{}", i)));
+		m_historyModel.AddHistoryItem(pidls.back());
+	}
+
+	// Only the 20 most recent items should be shown, with the oldest items being dropped from the
+	// end of the menu as new items are added.
+	std::vector<PidlAbsolute> expectedItems(pidls.rbegin(), pidls.rbegin() + 20);
+	MenuViewFakeTestHelper::CheckItemDetails(&m_menuView, expectedItems);
+
+	// Moving an item that's not currently shown should add it back to the start of the menu.
+	m_historyModel.AddHistoryItem(pidls[0]);
+
+	expectedItems.insert(expectedItems.begin(), pidls[0]);
+	expectedItems.pop_back();
+	MenuViewFakeTestHelper::CheckItemDetails(&m_menuView, expectedItems);
+}
+
+TEST_F(HistoryMenuTest, HistoryReplaced)
+{
+	PidlAbsolute pidl1;
+	m_browser->AddTab(L"c:\\windows", {}, &pidl1);
+
+	auto pidl2 = CreateSimplePidlForTest(L"c:\\fake1");
+	auto pidl3 = CreateSimplePidlForTest(L"c:\\fake2");
+	m_historyModel.SetHistoryItems({ pidl2, pidl3 });
+
+	MenuViewFakeTestHelper::CheckItemDetails(&m_menuView, { pidl2, pidl3 });
+}
+
+TEST_F(HistoryMenuTest, LeastRecentItemRemoved)
+{
+	HistoryModel historyModel(2);
+	MenuViewFake menuView;
+	HistoryMenu menu(&menuView, &m_acceleratorManager, &historyModel, m_browser,
+		&m_shellIconLoader);
+
+	auto pidl1 = CreateSimplePidlForTest(L"c:\\fake1");
+	auto pidl2 = CreateSimplePidlForTest(L"c:\\fake2");
+	auto pidl3 = CreateSimplePidlForTest(L"c:\\fake3");
+	historyModel.AddHistoryItem(pidl1);
+	historyModel.AddHistoryItem(pidl2);
+	historyModel.AddHistoryItem(pidl3);
+
+	// Once an item is removed from the history, it should also be removed from the menu.
+	MenuViewFakeTestHelper::CheckItemDetails(&menuView, { pidl3, pidl2 });
+}
@@ -6,6 +6,7 @@
 #include "HistoryModel.h"
 #include "ShellTestHelper.h"
 #include "../Helper/ShellHelper.h"
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 using namespace testing;
@@ -27,3 +28,102 @@ TEST(HistoryModelTest, RepeatedNavigation)
 	historyModel.AddHistoryItem(pidl);
 	EXPECT_EQ(history.size(), 1U);
 }
+
+TEST(HistoryModelTest, ExistingItemMovedToFront)
+{
+	HistoryModel historyModel;
+	const auto &history = historyModel.GetHistoryItems();
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake2");
+	PidlAbsolute pidl3 = CreateSimplePidlForTest(L"C:\\Fake3");
+	historyModel.AddHistoryItem(pidl1);
+	historyModel.AddHistoryItem(pidl2);
+	historyModel.AddHistoryItem(pidl3);
+
+	MockFunction<void()> callback;
+	historyModel.AddHistoryChangedObserver(callback.AsStdFunction());
+	EXPECT_CALL(callback, Call());
+
+	// Each location should only appear once, so navigating to an existing location should move it
+	// to the front.
+	historyModel.AddHistoryItem(pidl1);
+	EXPECT_THAT(history, ElementsAre(pidl1, pidl3, pidl2));
+}
+
+TEST(HistoryModelTest, MaxItems)
+{
+	HistoryModel historyModel(3);
+	const auto &history = historyModel.GetHistoryItems();
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake2");
+	PidlAbsolute pidl3 = CreateSimplePidlForTest(L"C:\\Fake3");
+	PidlAbsolute pidl4 = CreateSimplePidlForTest(L"C:\\Fake4");
+	historyModel.AddHistoryItem(pidl1);
+	historyModel.AddHistoryItem(pidl2);
+	historyModel.AddHistoryItem(pidl3);
+	historyModel.AddHistoryItem(pidl4);
+
+	// The least recent item should have been removed.
+	EXPECT_THAT(history, ElementsAre(pidl4, pidl3, pidl2));
+}
+
+TEST(HistoryModelTest, SetHistoryItems)
+{
+	HistoryModel historyModel(3);
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake2");
+	PidlAbsolute pidl3 = CreateSimplePidlForTest(L"C:\\Fake3");
+	PidlAbsolute pidl4 = CreateSimplePidlForTest(L"C:\\Fake4");
+	historyModel.AddHistoryItem(pidl4);
+
+	MockFunction<void()> callback;
+	historyModel.AddHistoryChangedObserver(callback.AsStdFunction());
+	EXPECT_CALL(callback, Call());
+
+	// The existing items should be replaced, duplicates should be ignored and the set of items
+	// should be truncated to the maximum size.
+	historyModel.SetHistoryItems({ pidl1, pidl2, pidl1, pidl3, pidl4 });
+	EXPECT_THAT(historyModel.GetHistoryItems(), ElementsAre(pidl1, pidl2, pidl3));
+}
+
+TEST(HistoryModelTest, ItemSignals)
+{
+	HistoryModel historyModel(2);
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake1");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake2");
+	PidlAbsolute pidl3 = CreateSimplePidlForTest(L"C:\\Fake3");
+
+	MockFunction<void(const PidlAbsolute &item)> addedCallback;
+	historyModel.AddItemAddedObserver(addedCallback.AsStdFunction());
+
+	MockFunction<void(const PidlAbsolute &item)> movedToFrontCallback;
+	historyModel.AddItemMovedToFrontObserver(movedToFrontCallback.AsStdFunction());
+
+	MockFunction<void(const PidlAbsolute &item)> removedCallback;
+	historyModel.AddItemRemovedObserver(removedCallback.AsStdFunction());
+
+	MockFunction<void()> replacedCallback;
+	historyModel.AddHistoryReplacedObserver(replacedCallback.AsStdFunction());
+
+	InSequence seq;
+	EXPECT_CALL(addedCallback, Call(pidl1));
+	EXPECT_CALL(addedCallback, Call(pidl2));
+	EXPECT_CALL(movedToFrontCallback, Call(pidl1));
+	EXPECT_CALL(addedCallback, Call(pidl3));
+	EXPECT_CALL(removedCallback, Call(pidl2));
+	EXPECT_CALL(replacedCallback, Call());
+
+	historyModel.AddHistoryItem(pidl1);
+	historyModel.AddHistoryItem(pidl2);
+	historyModel.AddHistoryItem(pidl1);
+
+	// The history is full at this point, so adding a new item should result in the least recent
+	// item being removed.
+	historyModel.AddHistoryItem(pidl3);
+
+	historyModel.SetHistoryItems({ pidl1 });
+}
@@ -0,0 +1,25 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "HistoryRegistryStorage.h"
+#include "HistoryModel.h"
+#include "HistoryStorageTestHelper.h"
+#include "RegistryStorageTestHelper.h"
+#include <gtest/gtest.h>
+
+using HistoryRegistryStorageTest = RegistryStorageTest;
+
+TEST_F(HistoryRegistryStorageTest, Save)
+{
+	HistoryModel referenceModel;
+	HistoryStorageTestHelper::BuildReferenceModel(&referenceModel);
+
+	HistoryRegistryStorage::Save(m_applicationTestKey.get(), &referenceModel);
+
+	HistoryModel loadedModel;
+	HistoryRegistryStorage::Load(m_applicationTestKey.get(), &loadedModel);
+
+	EXPECT_EQ(loadedModel, referenceModel);
+}
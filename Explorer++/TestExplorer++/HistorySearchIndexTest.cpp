@@ -0,0 +1,156 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "HistorySearchIndex.h"
+#include "HistoryModel.h"
+#include "ShellTestHelper.h"
+#include "TaskScheduler.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <limits>
+
+using namespace testing;
+
+class HistorySearchIndexTest : public Test
+{
+protected:
+	HistorySearchIndexTest() :
+		m_taskExecutor(std::make_shared<concurrencpp::manual_executor>()),
+		m_uiThreadExecutor(std::make_shared<concurrencpp::manual_executor>()),
+		m_taskScheduler({ m_taskExecutor, m_taskExecutor, m_taskExecutor }, 1)
+	{
+	}
+
+	~HistorySearchIndexTest()
+	{
+		m_taskExecutor->shutdown();
+		m_uiThreadExecutor->shutdown();
+	}
+
+	std::unique_ptr<HistorySearchIndex> CreateSearchIndex(HistoryModel *historyModel)
+	{
+		return std::make_unique<HistorySearchIndex>(historyModel, &m_taskScheduler,
+			m_uiThreadExecutor);
+	}
+
+	// Runs the background tasks that retrieve the names of each item, as well as the UI thread
+	// tasks that add those names to the index.
+	void RunPendingTasks()
+	{
+		while (m_uiThreadExecutor->loop(std::numeric_limits<size_t>::max())
+				+ m_taskExecutor->loop(std::numeric_limits<size_t>::max())
+			> 0)
+		{
+		}
+	}
+
+	const std::shared_ptr<concurrencpp::manual_executor> m_taskExecutor;
+	const std::shared_ptr<concurrencpp::manual_executor> m_uiThreadExecutor;
+	TaskScheduler m_taskScheduler;
+};
+
+TEST_F(HistorySearchIndexTest, Search)
+{
+	HistoryModel historyModel;
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Projects\\Explorer");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Users\\Documents");
+	PidlAbsolute pidl3 = CreateSimplePidlForTest(L"D:\\Projects\\Website");
+	historyModel.SetHistoryItems({ pidl1, pidl2, pidl3 });
+
+	auto searchIndex = CreateSearchIndex(&historyModel);
+	RunPendingTasks();
+
+	EXPECT_THAT(searchIndex->Search(L"documents", 10), ElementsAre(pidl2));
+	EXPECT_THAT(searchIndex->Search(L"website", 10), ElementsAre(pidl3));
+
+	// Small typos should be tolerated.
+	EXPECT_THAT(searchIndex->Search(L"docuemnts", 10), ElementsAre(pidl2));
+
+	// Items that match equally well should be ordered by recency.
+	EXPECT_THAT(searchIndex->Search(L"projects", 10), ElementsAre(pidl1, pidl3));
+	historyModel.AddHistoryItem(pidl3);
+	EXPECT_THAT(searchIndex->Search(L"projects", 10), ElementsAre(pidl3, pidl1));
+
+	EXPECT_THAT(searchIndex->Search(L"projects", 1), ElementsAre(pidl3));
+	EXPECT_THAT(searchIndex->Search(L"unknown", 10), IsEmpty());
+}
+
+TEST_F(HistorySearchIndexTest, ItemsIndexedInBackground)
+{
+	HistoryModel historyModel;
+
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"C:\\Fake\\Alpha");
+	historyModel.AddHistoryItem(pidl);
+
+	// The names of each item are retrieved in the background, so an item won't be returned until
+	// that's finished.
+	auto searchIndex = CreateSearchIndex(&historyModel);
+	EXPECT_EQ(searchIndex->GetNumPendingItems(), 1u);
+	EXPECT_THAT(searchIndex->Search(L"alpha", 10), IsEmpty());
+
+	RunPendingTasks();
+	EXPECT_EQ(searchIndex->GetNumPendingItems(), 0u);
+	EXPECT_THAT(searchIndex->Search(L"alpha", 10), ElementsAre(pidl));
+}
+
+TEST_F(HistorySearchIndexTest, IndexUpdated)
+{
+	HistoryModel historyModel(2);
+	auto searchIndex = CreateSearchIndex(&historyModel);
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake\\Alpha");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake\\Bravo");
+	PidlAbsolute pidl3 = CreateSimplePidlForTest(L"C:\\Fake\\Charlie");
+	historyModel.AddHistoryItem(pidl1);
+	historyModel.AddHistoryItem(pidl2);
+	RunPendingTasks();
+
+	EXPECT_THAT(searchIndex->Search(L"alpha", 10), ElementsAre(pidl1));
+
+	// The index should be updated when items are added and removed.
+	historyModel.AddHistoryItem(pidl3);
+	RunPendingTasks();
+	EXPECT_THAT(searchIndex->Search(L"charlie", 10), ElementsAre(pidl3));
+	EXPECT_THAT(searchIndex->Search(L"alpha", 10), IsEmpty());
+
+	// Replacing the history should also replace the indexed items.
+	historyModel.SetHistoryItems({ pidl1 });
+	RunPendingTasks();
+	EXPECT_THAT(searchIndex->Search(L"alpha", 10), ElementsAre(pidl1));
+	EXPECT_THAT(searchIndex->Search(L"charlie", 10), IsEmpty());
+}
+
+TEST_F(HistorySearchIndexTest, ItemRemovedWhilePending)
+{
+	HistoryModel historyModel(1);
+	auto searchIndex = CreateSearchIndex(&historyModel);
+
+	PidlAbsolute pidl1 = CreateSimplePidlForTest(L"C:\\Fake\\Alpha");
+	PidlAbsolute pidl2 = CreateSimplePidlForTest(L"C:\\Fake\\Bravo");
+
+	// The first item will be removed before its names have been retrieved, so the result for it
+	// should be ignored.
+	historyModel.AddHistoryItem(pidl1);
+	historyModel.AddHistoryItem(pidl2);
+	RunPendingTasks();
+
+	EXPECT_EQ(searchIndex->GetNumPendingItems(), 0u);
+	EXPECT_THAT(searchIndex->Search(L"alpha", 10), IsEmpty());
+	EXPECT_THAT(searchIndex->Search(L"bravo", 10), ElementsAre(pidl2));
+}
+
+TEST_F(HistorySearchIndexTest, DestroyedWhilePending)
+{
+	HistoryModel historyModel;
+	historyModel.AddHistoryItem(CreateSimplePidlForTest(L"C:\\Fake\\Alpha"));
+
+	auto searchIndex = CreateSearchIndex(&historyModel);
+	m_uiThreadExecutor->loop(std::numeric_limits<size_t>::max());
+	searchIndex.reset();
+
+	// The index no longer exists, so any outstanding work should have no effect.
+	RunPendingTasks();
+}
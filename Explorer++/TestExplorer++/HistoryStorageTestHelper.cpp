@@ -0,0 +1,25 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "HistoryStorageTestHelper.h"
+#include "HistoryModel.h"
+#include "ShellTestHelper.h"
+#include <algorithm>
+
+bool operator==(const HistoryModel &first, const HistoryModel &second)
+{
+	return std::ranges::equal(first.GetHistoryItems(), second.GetHistoryItems());
+}
+
+namespace HistoryStorageTestHelper
+{
+
+void BuildReferenceModel(HistoryModel *historyModel)
+{
+	historyModel->SetHistoryItems({ CreateSimplePidlForTest(L"c:\\fake1"),
+		CreateSimplePidlForTest(L"c:\\fake2\\folder"), CreateSimplePidlForTest(L"d:\\fake3") });
+}
+
+}
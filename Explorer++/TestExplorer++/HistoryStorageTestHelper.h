@@ -0,0 +1,16 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+class HistoryModel;
+
+bool operator==(const HistoryModel &first, const HistoryModel &second);
+
+namespace HistoryStorageTestHelper
+{
+
+void BuildReferenceModel(HistoryModel *historyModel);
+
+}
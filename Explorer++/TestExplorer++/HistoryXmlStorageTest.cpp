@@ -0,0 +1,28 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "HistoryXmlStorage.h"
+#include "HistoryModel.h"
+#include "HistoryStorageTestHelper.h"
+#include "XmlStorageTestHelper.h"
+#include <gtest/gtest.h>
+
+using HistoryXmlStorageTest = XmlStorageTest;
+
+TEST_F(HistoryXmlStorageTest, Save)
+{
+	HistoryModel referenceModel;
+	HistoryStorageTestHelper::BuildReferenceModel(&referenceModel);
+
+	auto xmlDocumentData = CreateXmlDocument();
+
+	HistoryXmlStorage::Save(xmlDocumentData.xmlDocument.get(), xmlDocumentData.rootNode.get(),
+		&referenceModel);
+
+	HistoryModel loadedModel;
+	HistoryXmlStorage::Load(xmlDocumentData.rootNode.get(), &loadedModel);
+
+	EXPECT_EQ(loadedModel, referenceModel);
+}
@@ -0,0 +1,47 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "HistoryXmlStreamStorage.h"
+#include "HistoryModel.h"
+#include "HistoryStorageTestHelper.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+TEST(HistoryXmlStreamStorageTest, Save)
+{
+	HistoryModel referenceModel;
+	HistoryStorageTestHelper::BuildReferenceModel(&referenceModel);
+
+	std::stringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		HistoryXmlStreamStorage::Save(writer, &referenceModel);
+	}
+
+	XmlReader reader(stream);
+	ASSERT_TRUE(reader.Read());
+
+	auto historyItems = HistoryXmlStreamStorage::Load(reader);
+	ASSERT_TRUE(historyItems.has_value());
+
+	HistoryModel loadedModel;
+	loadedModel.SetHistoryItems(*historyItems);
+
+	EXPECT_EQ(loadedModel, referenceModel);
+}
+
+TEST(HistoryXmlStreamStorageTest, LoadMalformed)
+{
+	std::istringstream stream(R"(<History>
+	<HistoryItem Location="">
+</History>)");
+	XmlReader reader(stream);
+	ASSERT_TRUE(reader.Read());
+
+	EXPECT_FALSE(HistoryXmlStreamStorage::Load(reader).has_value());
+}
@@ -0,0 +1,113 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "IncrementalSettingsWriter.h"
+#include "AppStorage.h"
+#include "BookmarkStorageTestHelper.h"
+#include "Runtime.h"
+#include "RuntimeTestHelper.h"
+#include "ScopedTestDir.h"
+#include "XmlAppStorageFactory.h"
+#include "Bookmarks/BookmarkTree.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+using Section = IncrementalSettingsWriter::Section;
+
+class IncrementalSettingsWriterTest : public Test
+{
+protected:
+	IncrementalSettingsWriterTest() :
+		m_runtime(BuildRuntimeForTest()),
+		m_configFilePath(m_scopedTestDir.GetPath() / L"config.xml"),
+		m_writer(&m_runtime, m_configFilePath, m_sectionSaver.AsStdFunction())
+	{
+		BuildV2LoadSaveReferenceTree(&m_bookmarkTree);
+
+		ON_CALL(m_sectionSaver, Call(_, Section::Bookmarks))
+			.WillByDefault([this](AppStorage *appStorage, Section section)
+				{
+					UNREFERENCED_PARAMETER(section);
+					appStorage->SaveBookmarks(&m_bookmarkTree);
+				});
+	}
+
+	void FlushAndWait()
+	{
+		m_writer.Flush();
+		m_writer.WaitForPendingWrites();
+	}
+
+	void VerifySavedBookmarks()
+	{
+		auto appStorage =
+			XmlAppStorageFactory::MaybeCreate(m_configFilePath, Storage::OperationType::Load);
+		ASSERT_NE(appStorage, nullptr);
+
+		BookmarkTree loadedBookmarkTree;
+		appStorage->LoadBookmarks(&loadedBookmarkTree);
+		CompareBookmarkTrees(&loadedBookmarkTree, &m_bookmarkTree, true);
+	}
+
+	ScopedTestDir m_scopedTestDir;
+	Runtime m_runtime;
+	const std::wstring m_configFilePath;
+	BookmarkTree m_bookmarkTree;
+	NiceMock<MockFunction<void(AppStorage *appStorage, Section section)>> m_sectionSaver;
+	IncrementalSettingsWriter m_writer;
+};
+
+TEST_F(IncrementalSettingsWriterTest, InitialFlush)
+{
+	// All sections should be serialized the first time the settings are flushed.
+	for (size_t i = 0; i < static_cast<size_t>(Section::Count); i++)
+	{
+		EXPECT_TRUE(m_writer.IsDirty(static_cast<Section>(i)));
+		EXPECT_CALL(m_sectionSaver, Call(_, static_cast<Section>(i)));
+	}
+
+	FlushAndWait();
+
+	for (size_t i = 0; i < static_cast<size_t>(Section::Count); i++)
+	{
+		EXPECT_FALSE(m_writer.IsDirty(static_cast<Section>(i)));
+	}
+
+	VerifySavedBookmarks();
+}
+
+TEST_F(IncrementalSettingsWriterTest, OnlyDirtySectionsSerialized)
+{
+	FlushAndWait();
+
+	m_bookmarkTree.AddBookmarkItem(m_bookmarkTree.GetOtherBookmarksFolder(),
+		std::make_unique<BookmarkItem>(std::nullopt, L"New bookmark", L"C:\\"));
+	m_writer.MarkDirty(Section::Bookmarks);
+	EXPECT_TRUE(m_writer.IsDirty(Section::Bookmarks));
+
+	EXPECT_CALL(m_sectionSaver, Call(_, _)).Times(0);
+	EXPECT_CALL(m_sectionSaver, Call(_, Section::Bookmarks));
+
+	FlushAndWait();
+	EXPECT_FALSE(m_writer.IsDirty(Section::Bookmarks));
+
+	VerifySavedBookmarks();
+}
+
+TEST_F(IncrementalSettingsWriterTest, UnchangedSectionNotRewritten)
+{
+	FlushAndWait();
+	ASSERT_TRUE(std::filesystem::exists(m_configFilePath));
+	std::filesystem::remove(m_configFilePath);
+
+	// The section is marked as dirty, but its content is the same, so there's no need for the file
+	// to be written again.
+	m_writer.MarkDirty(Section::Bookmarks);
+	FlushAndWait();
+
+	EXPECT_FALSE(std::filesystem::exists(m_configFilePath));
+}
@@ -0,0 +1,157 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/InternedPidl.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+#include <format>
+
+TEST(InternedPidlTest, Empty)
+{
+	InternedPidl pidl;
+	EXPECT_FALSE(pidl.HasValue());
+	EXPECT_FALSE(pidl.ToPidl().HasValue());
+
+	PidlStore store;
+	EXPECT_FALSE(store.Intern(PidlAbsolute()).HasValue());
+	EXPECT_EQ(store.GetNumNodes(), 0u);
+}
+
+TEST(InternedPidlTest, RoundTrip)
+{
+	PidlStore store;
+
+	auto pidl = CreateSimplePidlForTest(L"C:\\Fake\\Folder\\File.txt");
+	auto interned = store.Intern(pidl);
+	EXPECT_TRUE(interned.HasValue());
+	EXPECT_EQ(interned.ToPidl(), pidl);
+
+	// The desktop pidl contains no items.
+	PidlAbsolute pidlDesktop;
+	HRESULT hr = SHGetKnownFolderIDList(FOLDERID_Desktop, KF_FLAG_DEFAULT, nullptr,
+		PidlOutParam(pidlDesktop));
+	ASSERT_HRESULT_SUCCEEDED(hr);
+
+	auto internedDesktop = store.Intern(pidlDesktop);
+	EXPECT_TRUE(internedDesktop.HasValue());
+	EXPECT_EQ(internedDesktop.ToPidl(), pidlDesktop);
+}
+
+TEST(InternedPidlTest, Deduplication)
+{
+	PidlStore store;
+
+	auto pidl = CreateSimplePidlForTest(L"C:\\Fake\\Folder");
+	auto interned1 = store.Intern(pidl);
+	size_t numNodes = store.GetNumNodes();
+
+	auto interned2 = store.Intern(pidl);
+	EXPECT_EQ(interned1, interned2);
+	EXPECT_EQ(store.GetNumNodes(), numNodes);
+
+	auto interned3 = store.Intern(CreateSimplePidlForTest(L"C:\\Fake\\Other"));
+	EXPECT_NE(interned1, interned3);
+}
+
+TEST(InternedPidlTest, PrefixSharing)
+{
+	PidlStore store;
+
+	auto interned1 = store.Intern(CreateSimplePidlForTest(L"C:\\Fake\\Folder\\File1.txt"));
+	size_t numNodes = store.GetNumNodes();
+
+	// Only the last item differs, so only a single additional node should be needed.
+	auto interned2 = store.Intern(CreateSimplePidlForTest(L"C:\\Fake\\Folder\\File2.txt"));
+	EXPECT_EQ(store.GetNumNodes(), numNodes + 1);
+}
+
+TEST(InternedPidlTest, NodesReleased)
+{
+	PidlStore store;
+
+	{
+		auto interned1 = store.Intern(CreateSimplePidlForTest(L"C:\\Fake\\Folder\\File1.txt"));
+		size_t numNodes = store.GetNumNodes();
+
+		{
+			auto interned2 =
+				store.Intern(CreateSimplePidlForTest(L"C:\\Fake\\Folder\\File2.txt"));
+			EXPECT_EQ(store.GetNumNodes(), numNodes + 1);
+		}
+
+		// The shared parent nodes are still referenced by the first pidl.
+		EXPECT_EQ(store.GetNumNodes(), numNodes);
+	}
+
+	EXPECT_EQ(store.GetNumNodes(), 0u);
+	EXPECT_EQ(store.GetMemoryUsage(), 0u);
+}
+
+TEST(InternedPidlTest, OutlivesStore)
+{
+	auto store = std::make_unique<PidlStore>();
+	auto pidl = CreateSimplePidlForTest(L"C:\\Fake\\Folder");
+	auto interned = store->Intern(pidl);
+
+	store.reset();
+
+	EXPECT_EQ(interned.ToPidl(), pidl);
+}
+
+// Simulates a tab that's navigated 1000 times around a set of nested folders, with a few items
+// selected in each folder, and compares the memory needed to store the resulting history entries
+// as standalone pidls with the memory used when the pidls are interned.
+TEST(InternedPidlTest, MemorySavedForNavigationSession)
+{
+	constexpr int NUM_NAVIGATIONS = 1000;
+	constexpr int NUM_PROJECTS = 20;
+	constexpr int NUM_MODULES = 15;
+	constexpr int MAX_SELECTED_ITEMS = 5;
+
+	struct Entry
+	{
+		InternedPidl pidl;
+		std::vector<InternedPidl> selectedItems;
+	};
+
+	PidlStore store;
+	std::vector<Entry> entries;
+	size_t standaloneUsage = 0;
+
+	for (int i = 0; i < NUM_NAVIGATIONS; i++)
+	{
+		auto path = std::format(L"C:\\Users\\Fake\\Projects\\Project{}\\src\\module{}",
+			i % NUM_PROJECTS, i % NUM_MODULES);
+		auto pidl = CreateSimplePidlForTest(path);
+
+		Entry entry;
+		entry.pidl = store.Intern(pidl);
+		standaloneUsage += sizeof(PidlAbsolute) + ILGetSize(pidl.Raw());
+
+		for (int j = 0; j < (i % (MAX_SELECTED_ITEMS + 1)); j++)
+		{
+			auto selectedItem = CreateSimplePidlForTest(path + std::format(L"\\file{}.cpp", j));
+			entry.selectedItems.push_back(store.Intern(selectedItem));
+			standaloneUsage += sizeof(PidlAbsolute) + ILGetSize(selectedItem.Raw());
+		}
+
+		EXPECT_EQ(entry.pidl.ToPidl(), pidl);
+
+		entries.push_back(std::move(entry));
+	}
+
+	size_t internedUsage = store.GetMemoryUsage();
+
+	for (const auto &entry : entries)
+	{
+		internedUsage += sizeof(InternedPidl) * (1 + entry.selectedItems.size());
+	}
+
+	RecordProperty("StandaloneBytes", std::to_string(standaloneUsage));
+	RecordProperty("InternedBytes", std::to_string(internedUsage));
+	RecordProperty("BytesSaved", std::to_string(standaloneUsage - internedUsage));
+
+	EXPECT_LT(internedUsage * 4, standaloneUsage);
+}
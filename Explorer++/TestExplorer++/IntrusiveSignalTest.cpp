@@ -0,0 +1,373 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/IntrusiveSignal.h"
+#include <boost/signals2.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <new>
+#include <optional>
+#include <vector>
+
+using namespace testing;
+
+namespace
+{
+
+// Set while an AllocationCounter is alive on the current thread.
+thread_local size_t *currentAllocationCount = nullptr;
+
+// Counts the number of heap allocations made by the current thread during its lifetime. This
+// relies on the replacement operator new below.
+class AllocationCounter
+{
+public:
+	AllocationCounter()
+	{
+		CHECK(!currentAllocationCount);
+		currentAllocationCount = &m_count;
+	}
+
+	~AllocationCounter()
+	{
+		currentAllocationCount = nullptr;
+	}
+
+	size_t GetCount() const
+	{
+		return m_count;
+	}
+
+private:
+	size_t m_count = 0;
+};
+
+}
+
+void *operator new(size_t size)
+{
+	if (currentAllocationCount)
+	{
+		(*currentAllocationCount)++;
+	}
+
+	if (void *memory = std::malloc(size == 0 ? 1 : size))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void *memory, size_t size) noexcept
+{
+	UNREFERENCED_PARAMETER(size);
+
+	std::free(memory);
+}
+
+TEST(IntrusiveSignalTest, Emit)
+{
+	IntrusiveSignal<void(int value)> signal;
+
+	MockFunction<void(int value)> callback1;
+	auto connection1 = signal.AddObserver([&callback1](int value) { callback1.Call(value); });
+
+	MockFunction<void(int value)> callback2;
+	auto connection2 = signal.AddObserver([&callback2](int value) { callback2.Call(value); });
+
+	{
+		InSequence seq;
+
+		EXPECT_CALL(callback1, Call(42));
+		EXPECT_CALL(callback2, Call(42));
+	}
+
+	signal(42);
+}
+
+TEST(IntrusiveSignalTest, Disconnect)
+{
+	IntrusiveSignal<void()> signal;
+
+	MockFunction<void()> callback;
+	auto connection = signal.AddObserver([&callback] { callback.Call(); });
+	EXPECT_TRUE(connection.IsConnected());
+	EXPECT_TRUE(signal.HasObservers());
+
+	connection.Disconnect();
+	EXPECT_FALSE(connection.IsConnected());
+	EXPECT_FALSE(signal.HasObservers());
+
+	EXPECT_CALL(callback, Call()).Times(0);
+	signal();
+}
+
+TEST(IntrusiveSignalTest, DisconnectOnDestruction)
+{
+	IntrusiveSignal<void()> signal;
+
+	MockFunction<void()> callback;
+	EXPECT_CALL(callback, Call()).Times(0);
+
+	{
+		auto connection = signal.AddObserver([&callback] { callback.Call(); });
+	}
+
+	EXPECT_FALSE(signal.HasObservers());
+	signal();
+}
+
+TEST(IntrusiveSignalTest, SignalDestroyedFirst)
+{
+	IntrusiveSignal<void()>::Connection connection;
+
+	{
+		IntrusiveSignal<void()> signal;
+		connection = signal.AddObserver([] {});
+		EXPECT_TRUE(connection.IsConnected());
+	}
+
+	EXPECT_FALSE(connection.IsConnected());
+}
+
+TEST(IntrusiveSignalTest, MoveConnection)
+{
+	IntrusiveSignal<void()> signal;
+
+	MockFunction<void()> callback;
+	std::vector<IntrusiveSignal<void()>::Connection> connections;
+
+	// Adding a large number of connections will result in the vector being resized several times,
+	// which will move each of the connections.
+	for (int i = 0; i < 100; i++)
+	{
+		connections.push_back(signal.AddObserver([&callback] { callback.Call(); }));
+	}
+
+	EXPECT_CALL(callback, Call()).Times(100);
+	signal();
+
+	connections.erase(connections.begin(), connections.begin() + 50);
+
+	EXPECT_CALL(callback, Call()).Times(50);
+	signal();
+}
+
+TEST(IntrusiveSignalTest, DisconnectDuringEmission)
+{
+	IntrusiveSignal<void()> signal;
+	IntrusiveSignal<void()>::Connection connection1;
+	IntrusiveSignal<void()>::Connection connection2;
+	IntrusiveSignal<void()>::Connection connection3;
+
+	MockFunction<void()> callback2;
+	MockFunction<void()> callback3;
+
+	connection1 = signal.AddObserver(
+		[&connection1, &connection2]
+		{
+			connection1.Disconnect();
+			connection2.Disconnect();
+		});
+	connection2 = signal.AddObserver([&callback2] { callback2.Call(); });
+	connection3 = signal.AddObserver([&callback3] { callback3.Call(); });
+
+	EXPECT_CALL(callback2, Call()).Times(0);
+	EXPECT_CALL(callback3, Call()).Times(2);
+	signal();
+	signal();
+}
+
+TEST(IntrusiveSignalTest, ConnectDuringEmission)
+{
+	IntrusiveSignal<void()> signal;
+	IntrusiveSignal<void()>::Connection connection2;
+
+	MockFunction<void()> callback2;
+
+	auto connection1 = signal.AddObserver(
+		[&signal, &connection2, &callback2]
+		{
+			if (!connection2.IsConnected())
+			{
+				connection2 = signal.AddObserver([&callback2] { callback2.Call(); });
+			}
+		});
+
+	// An observer added during an emission shouldn't be notified until the next emission.
+	EXPECT_CALL(callback2, Call()).Times(0);
+	signal();
+
+	Mock::VerifyAndClearExpectations(&callback2);
+
+	EXPECT_CALL(callback2, Call());
+	signal();
+}
+
+TEST(IntrusiveSignalTest, RecursiveEmission)
+{
+	IntrusiveSignal<void(int depth)> signal;
+
+	MockFunction<void(int depth)> callback;
+
+	auto connection1 = signal.AddObserver(
+		[&signal](int depth)
+		{
+			if (depth < 2)
+			{
+				signal(depth + 1);
+			}
+		});
+	auto connection2 = signal.AddObserver([&callback](int depth) { callback.Call(depth); });
+
+	{
+		InSequence seq;
+
+		EXPECT_CALL(callback, Call(2));
+		EXPECT_CALL(callback, Call(1));
+		EXPECT_CALL(callback, Call(0));
+	}
+
+	signal(0);
+}
+
+TEST(IntrusiveSignalTest, Wrapper)
+{
+	class Subject
+	{
+	public:
+		void Notify(int value)
+		{
+			valueChangedSignal.m_signal(value);
+		}
+
+		IntrusiveSignalWrapper<Subject, void(int value)> valueChangedSignal;
+	};
+
+	Subject subject;
+
+	MockFunction<void(int value)> callback;
+	auto connection = subject.valueChangedSignal.AddObserver(
+		[&callback](int value) { callback.Call(value); });
+
+	EXPECT_CALL(callback, Call(7));
+	subject.Notify(7);
+}
+
+TEST(IntrusiveSignalTest, Size)
+{
+	// The signal and each connection are fixed in size and don't allocate. That's what makes this
+	// class suitable for embedding in large numbers of objects.
+	EXPECT_EQ(sizeof(IntrusiveSignal<void()>), 3 * sizeof(void *));
+	EXPECT_EQ(sizeof(IntrusiveSignal<void()>::Connection), 8 * sizeof(void *));
+}
+
+// Compares IntrusiveSignal with boost::signals2::signal in the situation it's designed for: a large
+// number of items, each embedding a signal that has a single observer. The size of each signal and
+// connection, the number of allocations needed to create and connect each item and the cost of
+// emitting each signal are recorded, so that they can be compared across changes.
+TEST(IntrusiveSignalTest, ComparedToBoostSignal)
+{
+	using Clock = std::chrono::steady_clock;
+	using Signal = IntrusiveSignal<void(int value)>;
+	using BoostSignal = boost::signals2::signal<void(int value)>;
+
+	constexpr size_t NUM_ITEMS = 10'000;
+	constexpr size_t NUM_EMISSIONS_PER_ITEM = 100;
+
+	auto formatNanosecondsPerEmission = [](Clock::duration duration)
+	{
+		auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+		return std::format("{:.1f}",
+			static_cast<double>(nanoseconds) / (NUM_ITEMS * NUM_EMISSIONS_PER_ITEM));
+	};
+
+	int total = 0;
+	auto observer = [&total](int value) { total += value; };
+
+	// The storage for the items is allocated up front, so that only the allocations made by the
+	// signals and connections themselves are counted.
+	std::vector<std::optional<Signal>> signals(NUM_ITEMS);
+	std::vector<Signal::Connection> connections(NUM_ITEMS);
+	size_t numAllocations;
+
+	{
+		AllocationCounter allocationCounter;
+
+		for (size_t i = 0; i < NUM_ITEMS; i++)
+		{
+			signals[i].emplace();
+			connections[i] = signals[i]->AddObserver(observer);
+		}
+
+		numAllocations = allocationCounter.GetCount();
+	}
+
+	auto emitStart = Clock::now();
+
+	for (size_t i = 0; i < NUM_EMISSIONS_PER_ITEM; i++)
+	{
+		for (auto &signal : signals)
+		{
+			(*signal)(1);
+		}
+	}
+
+	auto emitDuration = Clock::now() - emitStart;
+
+	EXPECT_EQ(numAllocations, 0u);
+	EXPECT_EQ(total, static_cast<int>(NUM_ITEMS * NUM_EMISSIONS_PER_ITEM));
+
+	std::vector<std::optional<BoostSignal>> boostSignals(NUM_ITEMS);
+	std::vector<boost::signals2::scoped_connection> boostConnections(NUM_ITEMS);
+	size_t numBoostAllocations;
+
+	{
+		AllocationCounter allocationCounter;
+
+		for (size_t i = 0; i < NUM_ITEMS; i++)
+		{
+			boostSignals[i].emplace();
+			boostConnections[i] = boostSignals[i]->connect(observer);
+		}
+
+		numBoostAllocations = allocationCounter.GetCount();
+	}
+
+	auto boostEmitStart = Clock::now();
+
+	for (size_t i = 0; i < NUM_EMISSIONS_PER_ITEM; i++)
+	{
+		for (auto &signal : boostSignals)
+		{
+			(*signal)(1);
+		}
+	}
+
+	auto boostEmitDuration = Clock::now() - boostEmitStart;
+
+	EXPECT_EQ(total, static_cast<int>(2 * NUM_ITEMS * NUM_EMISSIONS_PER_ITEM));
+
+	RecordProperty("SignalBytes", std::to_string(sizeof(Signal)));
+	RecordProperty("ConnectionBytes", std::to_string(sizeof(Signal::Connection)));
+	RecordProperty("BoostSignalBytes", std::to_string(sizeof(BoostSignal)));
+	RecordProperty("BoostConnectionBytes",
+		std::to_string(sizeof(boost::signals2::scoped_connection)));
+	RecordProperty("AllocationsPerItem",
+		std::format("{:.2f}", static_cast<double>(numAllocations) / NUM_ITEMS));
+	RecordProperty("BoostAllocationsPerItem",
+		std::format("{:.2f}", static_cast<double>(numBoostAllocations) / NUM_ITEMS));
+	RecordProperty("EmitNanoseconds", formatNanosecondsPerEmission(emitDuration));
+	RecordProperty("BoostEmitNanoseconds", formatNanosecondsPerEmission(boostEmitDuration));
+}
@@ -28,6 +28,22 @@ ListViewItemFake *ListViewModelFake::AddItem(const std::wstring &name)
 	return rawItem;
 }
 
+std::vector<ListViewItemFake *> ListViewModelFake::AddItems(const std::vector<std::wstring> &names)
+{
+	std::vector<std::unique_ptr<ListViewItem>> items;
+	std::vector<ListViewItemFake *> rawItems;
+
+	for (const auto &name : names)
+	{
+		auto item = std::make_unique<ListViewItemFake>(name);
+		rawItems.push_back(item.get());
+		items.push_back(std::move(item));
+	}
+
+	ListViewModel::AddItems(std::move(items));
+	return rawItems;
+}
+
 std::weak_ordering ListViewModelFake::CompareItems(const ListViewItem *first,
 	const ListViewItem *second) const
 {
@@ -6,6 +6,8 @@
 
 #include "ListViewColumnModelFake.h"
 #include "ListViewModel.h"
+#include <string>
+#include <vector>
 
 class ListViewItemFake;
 
@@ -18,9 +20,11 @@ public:
 	const ListViewColumnModel *GetColumnModel() const override;
 
 	ListViewItemFake *AddItem(const std::wstring &name = L"");
+	std::vector<ListViewItemFake *> AddItems(const std::vector<std::wstring> &names);
 
 	using ListViewModel::RemoveAllItems;
 	using ListViewModel::RemoveItem;
+	using ListViewModel::RemoveItems;
 
 protected:
 	std::weak_ordering CompareItems(const ListViewItem *first,
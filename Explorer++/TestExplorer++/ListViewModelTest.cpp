@@ -127,6 +127,82 @@ TEST(ListViewModelTest, InsertInSortedPosition)
 		ElementsAre(itemM, itemH, itemF, itemC, itemA));
 }
 
+TEST(ListViewModelTest, AddItems)
+{
+	ListViewModelFake model;
+	auto items = model.AddItems({ L"B", L"A", L"C" });
+	EXPECT_THAT(GeneratorToVector(model.GetItems()), ElementsAre(items[0], items[1], items[2]));
+}
+
+TEST(ListViewModelTest, AddItemsInSortedPosition)
+{
+	ListViewModelFake model;
+	model.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Ascending);
+
+	const auto *itemB = model.AddItem(L"B");
+	const auto *itemF = model.AddItem(L"F");
+
+	auto items = model.AddItems({ L"G", L"A", L"C" });
+	EXPECT_THAT(GeneratorToVector(model.GetItems()),
+		ElementsAre(items[1], itemB, items[2], itemF, items[0]));
+
+	model.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Descending);
+
+	auto items2 = model.AddItems({ L"D", L"H" });
+	EXPECT_THAT(GeneratorToVector(model.GetItems()),
+		ElementsAre(items2[1], items[0], itemF, items2[0], items[2], itemB, items[1]));
+}
+
+TEST(ListViewModelTest, AddItemsMatchesIndividualAdds)
+{
+	std::vector<std::wstring> names = { L"C", L"A", L"C", L"B", L"A" };
+
+	ListViewModelFake model1;
+	model1.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Ascending);
+	model1.AddItem(L"B");
+	model1.AddItem(L"A");
+
+	for (const auto &name : names)
+	{
+		model1.AddItem(name);
+	}
+
+	ListViewModelFake model2;
+	model2.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Ascending);
+	model2.AddItem(L"B");
+	model2.AddItem(L"A");
+	model2.AddItems(names);
+
+	ASSERT_EQ(model1.GetNumItems(), model2.GetNumItems());
+
+	for (int i = 0; i < model1.GetNumItems(); i++)
+	{
+		EXPECT_EQ(static_cast<const ListViewItemFake *>(model1.GetItemAtIndex(i))->GetName(),
+			static_cast<const ListViewItemFake *>(model2.GetItemAtIndex(i))->GetName());
+	}
+}
+
+TEST(ListViewModelTest, RemoveItems)
+{
+	ListViewModelFake model;
+	auto items = model.AddItems({ L"A", L"B", L"C", L"D" });
+
+	model.RemoveItems({ items[3], items[1] });
+	EXPECT_THAT(GeneratorToVector(model.GetItems()), ElementsAre(items[0], items[2]));
+}
+
+TEST(ListViewModelTest, AddedItemsUpdatedSignal)
+{
+	ListViewModelFake model;
+	auto items = model.AddItems({ L"A" });
+
+	MockFunction<void(ListViewItem * item)> callback;
+	model.itemUpdatedSignal.AddObserver(callback.AsStdFunction());
+
+	EXPECT_CALL(callback, Call(items[0]));
+	items[0]->SetName(L"B");
+}
+
 TEST(ListViewModelTest, UpdateSortedPosition)
 {
 	ListViewModelFake model;
@@ -159,6 +235,28 @@ TEST(ListViewModelTest, AddedSignal)
 	EXPECT_EQ(callbackItem, item);
 }
 
+TEST(ListViewModelTest, ItemsAddedSignal)
+{
+	ListViewModelFake model;
+	model.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Ascending);
+
+	MockFunction<void(ListViewItem * item, int index)> itemAddedCallback;
+	model.itemAddedSignal.AddObserver(itemAddedCallback.AsStdFunction());
+
+	MockFunction<void(const std::vector<ListViewItem *> &items)> itemsAddedCallback;
+	model.itemsAddedSignal.AddObserver(itemsAddedCallback.AsStdFunction());
+
+	std::vector<ListViewItem *> callbackItems;
+	EXPECT_CALL(itemAddedCallback, Call(_, _)).Times(0);
+	EXPECT_CALL(itemsAddedCallback, Call(_)).WillOnce(SaveArg<0>(&callbackItems));
+	auto items = model.AddItems({ L"B", L"C", L"A" });
+	EXPECT_THAT(callbackItems, ElementsAre(items[2], items[0], items[1]));
+
+	// Adding an empty set of items shouldn't result in the signal being emitted.
+	EXPECT_CALL(itemsAddedCallback, Call(_)).Times(0);
+	model.AddItems({});
+}
+
 TEST(ListViewModelTest, UpdatedWithoutMoveSignal)
 {
 	ListViewModelFake model;
@@ -208,6 +306,22 @@ TEST(ListViewModelTest, RemovedSignal)
 	model.RemoveItem(item);
 }
 
+TEST(ListViewModelTest, ItemsRemovedSignal)
+{
+	ListViewModelFake model;
+	auto items = model.AddItems({ L"A", L"B", L"C" });
+
+	MockFunction<void(const ListViewItem *item)> itemRemovedCallback;
+	model.itemRemovedSignal.AddObserver(itemRemovedCallback.AsStdFunction());
+
+	MockFunction<void(const std::vector<const ListViewItem *> &items)> itemsRemovedCallback;
+	model.itemsRemovedSignal.AddObserver(itemsRemovedCallback.AsStdFunction());
+
+	EXPECT_CALL(itemRemovedCallback, Call(_)).Times(0);
+	EXPECT_CALL(itemsRemovedCallback, Call(UnorderedElementsAre(items[0], items[2])));
+	model.RemoveItems({ items[2], items[0] });
+}
+
 TEST(ListViewModelTest, AllItemsRemovedSignal)
 {
 	ListViewModelFake model;
@@ -239,6 +239,113 @@ TEST_F(ListViewTest, InitialItems)
 	}
 }
 
+TEST_F(ListViewTest, AddItems)
+{
+	m_model.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Ascending);
+	m_model.AddItem(L"B");
+	m_model.AddItem(L"E");
+
+	auto listView = BuildListView();
+
+	m_model.AddItems({ L"F", L"A", L"C", L"D" });
+
+	ASSERT_EQ(listView->GetItemCountForTesting(), m_model.GetNumItems());
+
+	for (int i = 0; i < m_model.GetNumItems(); i++)
+	{
+		EXPECT_EQ(listView->GetItemAtIndexForTesting(i), m_model.GetItemAtIndex(i));
+	}
+}
+
+TEST_F(ListViewTest, RemoveItems)
+{
+	auto items = m_model.AddItems({ L"A", L"B", L"C", L"D", L"E" });
+
+	auto listView = BuildListView();
+
+	m_model.RemoveItems({ items[0], items[2], items[4] });
+
+	ASSERT_EQ(listView->GetItemCountForTesting(), 2);
+	EXPECT_EQ(listView->GetItemAtIndexForTesting(0), items[1]);
+	EXPECT_EQ(listView->GetItemAtIndexForTesting(1), items[3]);
+}
+
+// Adding a small number of items to a larger listview inserts each of the items individually,
+// rather than rebuilding the listview.
+TEST_F(ListViewTest, AddSmallBatchOfItems)
+{
+	m_model.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Ascending);
+	m_model.AddItems({ L"A", L"C", L"E", L"G", L"I", L"K", L"M", L"O" });
+
+	auto listView = BuildListView();
+
+	m_model.AddItems({ L"D", L"N" });
+
+	ASSERT_EQ(listView->GetItemCountForTesting(), m_model.GetNumItems());
+
+	for (int i = 0; i < m_model.GetNumItems(); i++)
+	{
+		EXPECT_EQ(listView->GetItemAtIndexForTesting(i), m_model.GetItemAtIndex(i));
+	}
+}
+
+TEST_F(ListViewTest, RemoveSmallBatchOfItems)
+{
+	auto items =
+		m_model.AddItems({ L"A", L"B", L"C", L"D", L"E", L"F", L"G", L"H", L"I", L"J" });
+
+	auto listView = BuildListView();
+
+	m_model.RemoveItems({ items[6], items[1] });
+
+	ASSERT_EQ(listView->GetItemCountForTesting(), m_model.GetNumItems());
+
+	for (int i = 0; i < m_model.GetNumItems(); i++)
+	{
+		EXPECT_EQ(listView->GetItemAtIndexForTesting(i), m_model.GetItemAtIndex(i));
+	}
+}
+
+// A large batch results in the listview being rebuilt. The selection should be retained when that
+// happens.
+TEST_F(ListViewTest, AddLargeBatchOfItemsRetainsSelection)
+{
+	m_model.SetSortDetails(ListViewColumnModelFake::COLUMN_NAME, SortDirection::Ascending);
+	auto items = m_model.AddItems({ L"B", L"D", L"F" });
+
+	auto listView = BuildListView();
+	listView->SelectItem(items[0]);
+	listView->SelectItem(items[2]);
+
+	m_model.AddItems({ L"A", L"C", L"E", L"G" });
+
+	ASSERT_EQ(listView->GetItemCountForTesting(), m_model.GetNumItems());
+
+	for (int i = 0; i < m_model.GetNumItems(); i++)
+	{
+		EXPECT_EQ(listView->GetItemAtIndexForTesting(i), m_model.GetItemAtIndex(i));
+	}
+
+	EXPECT_THAT(listView->GetSelectedItems(), ElementsAre(items[0], items[2]));
+}
+
+TEST_F(ListViewTest, RemoveLargeBatchOfItemsRetainsSelection)
+{
+	auto items = m_model.AddItems({ L"A", L"B", L"C", L"D", L"E" });
+
+	auto listView = BuildListView();
+	listView->SelectItem(items[1]);
+	listView->SelectItem(items[2]);
+
+	m_model.RemoveItems({ items[0], items[2], items[4] });
+
+	ASSERT_EQ(listView->GetItemCountForTesting(), 2);
+	EXPECT_EQ(listView->GetItemAtIndexForTesting(0), items[1]);
+	EXPECT_EQ(listView->GetItemAtIndexForTesting(1), items[3]);
+
+	EXPECT_THAT(listView->GetSelectedItems(), ElementsAre(items[1]));
+}
+
 TEST_F(ListViewTest, GetSelectedItems)
 {
 	const auto *item1 = m_model.AddItem();
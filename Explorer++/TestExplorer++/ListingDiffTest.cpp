@@ -0,0 +1,163 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ListingDiff.h"
+#include "ShellTestHelper.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <format>
+
+using namespace testing;
+
+namespace
+{
+
+struct TestItem
+{
+	std::wstring name;
+	PidlChild pidl;
+};
+
+TestItem BuildItem(const std::wstring &name, ShellItemType shellItemType = ShellItemType::Folder)
+{
+	return { name,
+		CreateSimplePidlForTest(L"c:\\folder\\" + name, nullptr, shellItemType).GetLastItem() };
+}
+
+// The entries refer to the items, so the items need to outlive the entries.
+std::vector<ListingDiff::Entry> BuildEntries(const std::vector<TestItem> &items)
+{
+	std::vector<ListingDiff::Entry> entries;
+
+	for (const auto &item : items)
+	{
+		entries.push_back({ item.name, item.pidl.Raw() });
+	}
+
+	ListingDiff::SortEntries(entries);
+	return entries;
+}
+
+std::vector<std::wstring_view> GetKeys(const std::vector<ListingDiff::Entry> &entries,
+	const std::vector<size_t> &indexes)
+{
+	std::vector<std::wstring_view> keys;
+
+	for (auto index : indexes)
+	{
+		keys.push_back(entries[index].key);
+	}
+
+	return keys;
+}
+
+}
+
+TEST(ListingDiffTest, IdenticalListings)
+{
+	std::vector<TestItem> items = { BuildItem(L"a"), BuildItem(L"b"), BuildItem(L"c") };
+	auto oldEntries = BuildEntries(items);
+	auto newEntries = BuildEntries(items);
+
+	auto delta = ListingDiff::Compute(oldEntries, newEntries);
+	EXPECT_TRUE(delta.IsEmpty());
+}
+
+TEST(ListingDiffTest, EmptyListings)
+{
+	std::vector<TestItem> items = { BuildItem(L"a"), BuildItem(L"b") };
+	auto entries = BuildEntries(items);
+
+	auto delta = ListingDiff::Compute({}, entries);
+	EXPECT_THAT(GetKeys(entries, delta.added), ElementsAre(L"a", L"b"));
+	EXPECT_THAT(delta.removed, IsEmpty());
+
+	delta = ListingDiff::Compute(entries, {});
+	EXPECT_THAT(delta.added, IsEmpty());
+	EXPECT_THAT(GetKeys(entries, delta.removed), ElementsAre(L"a", L"b"));
+
+	delta = ListingDiff::Compute({}, {});
+	EXPECT_TRUE(delta.IsEmpty());
+}
+
+TEST(ListingDiffTest, AddedAndRemoved)
+{
+	std::vector<TestItem> oldItems = { BuildItem(L"a"), BuildItem(L"c"), BuildItem(L"e") };
+	std::vector<TestItem> newItems = { BuildItem(L"b"), BuildItem(L"c"), BuildItem(L"d"),
+		BuildItem(L"f") };
+	auto oldEntries = BuildEntries(oldItems);
+	auto newEntries = BuildEntries(newItems);
+
+	auto delta = ListingDiff::Compute(oldEntries, newEntries);
+	EXPECT_THAT(GetKeys(newEntries, delta.added), ElementsAre(L"b", L"d", L"f"));
+	EXPECT_THAT(GetKeys(oldEntries, delta.removed), ElementsAre(L"a", L"e"));
+	EXPECT_THAT(delta.modified, IsEmpty());
+	EXPECT_EQ(delta.GetNumChanges(), 5u);
+}
+
+TEST(ListingDiffTest, Modified)
+{
+	std::vector<TestItem> oldItems = { BuildItem(L"a"), BuildItem(L"b"), BuildItem(L"c") };
+
+	// The pidl for a file differs from the pidl for a folder with the same name, so "b" should be
+	// reported as modified, even though the key is the same.
+	std::vector<TestItem> newItems = { BuildItem(L"a"), BuildItem(L"b", ShellItemType::File),
+		BuildItem(L"c") };
+
+	auto oldEntries = BuildEntries(oldItems);
+	auto newEntries = BuildEntries(newItems);
+
+	auto delta = ListingDiff::Compute(oldEntries, newEntries);
+	EXPECT_THAT(delta.added, IsEmpty());
+	EXPECT_THAT(delta.removed, IsEmpty());
+	ASSERT_EQ(delta.modified.size(), 1u);
+	EXPECT_EQ(oldEntries[delta.modified[0].first].key, L"b");
+	EXPECT_EQ(newEntries[delta.modified[0].second].key, L"b");
+}
+
+TEST(ListingDiffTest, UnsortedInput)
+{
+	// The order in which items are enumerated shouldn't affect the result.
+	std::vector<TestItem> oldItems = { BuildItem(L"z"), BuildItem(L"m"), BuildItem(L"a") };
+	std::vector<TestItem> newItems = { BuildItem(L"a"), BuildItem(L"z"), BuildItem(L"m") };
+	auto oldEntries = BuildEntries(oldItems);
+	auto newEntries = BuildEntries(newItems);
+
+	auto delta = ListingDiff::Compute(oldEntries, newEntries);
+	EXPECT_TRUE(delta.IsEmpty());
+}
+
+TEST(ListingDiffTest, LargeListingWithFewChanges)
+{
+	constexpr int NUM_ITEMS = 10'000;
+
+	std::vector<TestItem> oldItems;
+	std::vector<TestItem> newItems;
+
+	for (int i = 0; i < NUM_ITEMS; i++)
+	{
+		auto name = std::format(L"item{}", i);
+
+		if (i % 2000 != 0)
+		{
+			oldItems.push_back(BuildItem(name));
+		}
+
+		if (i % 2500 != 1)
+		{
+			newItems.push_back(BuildItem(name));
+		}
+	}
+
+	auto oldEntries = BuildEntries(oldItems);
+	auto newEntries = BuildEntries(newItems);
+
+	auto delta = ListingDiff::Compute(oldEntries, newEntries);
+	EXPECT_THAT(GetKeys(newEntries, delta.added),
+		UnorderedElementsAre(L"item0", L"item2000", L"item4000", L"item6000", L"item8000"));
+	EXPECT_THAT(GetKeys(oldEntries, delta.removed),
+		UnorderedElementsAre(L"item1", L"item2501", L"item5001", L"item7501"));
+	EXPECT_THAT(delta.modified, IsEmpty());
+}
@@ -61,6 +61,24 @@ TEST_F(MenuViewTest, ClearMenu)
 	EXPECT_EQ(m_menuView.GetItemCount(), 0);
 }
 
+TEST_F(MenuViewTest, PrependAndRemoveItems)
+{
+	m_menuView.AppendItem(1, L"Item 1");
+	m_menuView.PrependItem(2, L"Item 2");
+	m_menuView.PrependItem(3, L"Item 3");
+
+	EXPECT_EQ(m_menuView.GetItemCount(), 3);
+	EXPECT_EQ(m_menuView.GetItemId(0), 3u);
+	EXPECT_EQ(m_menuView.GetItemId(1), 2u);
+	EXPECT_EQ(m_menuView.GetItemId(2), 1u);
+
+	m_menuView.RemoveItem(2);
+
+	EXPECT_EQ(m_menuView.GetItemCount(), 2);
+	EXPECT_EQ(m_menuView.GetItemId(0), 3u);
+	EXPECT_EQ(m_menuView.GetItemId(1), 1u);
+}
+
 using MenuViewDeathTest = MenuViewTest;
 
 TEST_F(MenuViewDeathTest, RetrieveHelpTextAfterClearingMenu)
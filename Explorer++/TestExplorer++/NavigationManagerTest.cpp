@@ -4,9 +4,11 @@
 
 #include "pch.h"
 #include "ShellBrowser/NavigationManager.h"
+#include "FolderListingCache.h"
 #include "GeneratorTestHelper.h"
 #include "NavigationRequestTestHelper.h"
 #include "ShellBrowser/NavigationEvents.h"
+#include "ShellBrowser/NavigationRequest.h"
 #include "ShellEnumeratorFake.h"
 #include "ShellTestHelper.h"
 #include "../Helper/UniqueThreadId.h"
@@ -557,3 +559,73 @@ TEST_F(NavigationManagerLatestNavigationLifetimeTest, CancelledNavigation)
 	m_navigationManager->StopLoading();
 	RunExecutors();
 }
+
+class NavigationManagerListingCacheTest : public NavigationManagerTest
+{
+protected:
+	NavigationManagerListingCacheTest() : m_listingCache(std::make_shared<FolderListingCache>())
+	{
+		m_navigationManager = std::make_unique<NavigationManager>(nullptr, &m_navigationEvents,
+			m_shellEnumerator, m_manualExecutorBackground, m_manualExecutorCurrent,
+			m_listingCache);
+
+		m_navigationEvents.AddCommittedObserver(
+			[this](const NavigationRequest *request)
+			{ m_lastNavigationFromCache = request->IsListingFromCache(); },
+			NavigationEventScope::Global());
+	}
+
+	const std::shared_ptr<FolderListingCache> m_listingCache;
+	bool m_lastNavigationFromCache = false;
+};
+
+TEST_F(NavigationManagerListingCacheTest, CachedListingUsed)
+{
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+
+	CompleteNavigation(navigateParams);
+	EXPECT_FALSE(m_lastNavigationFromCache);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+	EXPECT_EQ(m_listingCache->GetNumListings(), 1u);
+
+	// The listing from the first navigation should be reused here, without the folder being
+	// enumerated again.
+	CompleteNavigation(navigateParams);
+	EXPECT_TRUE(m_lastNavigationFromCache);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 1);
+}
+
+TEST_F(NavigationManagerListingCacheTest, CachedListingNotAllowed)
+{
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+
+	CompleteNavigation(navigateParams);
+
+	navigateParams.allowCachedListing = false;
+	CompleteNavigation(navigateParams);
+	EXPECT_FALSE(m_lastNavigationFromCache);
+	EXPECT_EQ(m_shellEnumerator->GetNumEnumerations(), 2);
+}
+
+TEST_F(NavigationManagerListingCacheTest, FailedEnumerationNotCached)
+{
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+
+	m_shellEnumerator->SetShouldSucceed(false);
+	CompleteNavigation(navigateParams);
+	EXPECT_EQ(m_listingCache->GetNumListings(), 0u);
+}
+
+TEST_F(NavigationManagerListingCacheTest, StoppedEnumerationNotCached)
+{
+	PidlAbsolute pidl = CreateSimplePidlForTest(L"c:\\");
+	auto navigateParams = NavigateParams::Normal(pidl.Raw());
+
+	m_navigationManager->StartNavigation(navigateParams);
+	m_navigationManager->StopLoading();
+	RunExecutors();
+	EXPECT_EQ(m_listingCache->GetNumListings(), 0u);
+}
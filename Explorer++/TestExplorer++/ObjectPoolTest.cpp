@@ -0,0 +1,160 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/ObjectPool.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <vector>
+
+using namespace testing;
+
+namespace
+{
+
+struct TestObject
+{
+	int value1;
+	double value2;
+};
+
+}
+
+TEST(ObjectPoolTest, AllocateAndDeallocate)
+{
+	ObjectPool<TestObject> pool;
+	EXPECT_EQ(pool.GetNumAllocatedObjects(), 0u);
+	EXPECT_EQ(pool.GetNumSlabs(), 0u);
+
+	std::set<void *> objects;
+
+	for (int i = 0; i < 10; i++)
+	{
+		objects.insert(pool.Allocate());
+	}
+
+	// Each allocation should be distinct.
+	EXPECT_EQ(objects.size(), 10u);
+	EXPECT_EQ(pool.GetNumAllocatedObjects(), 10u);
+
+	for (auto *object : objects)
+	{
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(object) % alignof(TestObject), 0u);
+	}
+
+	for (auto *object : objects)
+	{
+		pool.Deallocate(object);
+	}
+
+	EXPECT_EQ(pool.GetNumAllocatedObjects(), 0u);
+}
+
+TEST(ObjectPoolTest, MemoryReused)
+{
+	ObjectPool<TestObject> pool;
+
+	auto *object1 = pool.Allocate();
+	pool.Deallocate(object1);
+
+	// A single empty slab is retained, so the memory should be reused, even though the pool was
+	// emptied.
+	auto *object2 = pool.Allocate();
+	EXPECT_EQ(object2, object1);
+	EXPECT_EQ(pool.GetNumSlabs(), 1u);
+
+	pool.Deallocate(object2);
+}
+
+TEST(ObjectPoolTest, Slabs)
+{
+	ObjectPool<TestObject, 4> pool;
+	std::vector<void *> objects;
+
+	for (int i = 0; i < 4; i++)
+	{
+		objects.push_back(pool.Allocate());
+	}
+
+	EXPECT_EQ(pool.GetNumSlabs(), 1u);
+
+	objects.push_back(pool.Allocate());
+	EXPECT_EQ(pool.GetNumSlabs(), 2u);
+
+	// Each slab should be retained while it still contains an allocated object.
+	for (size_t i = 0; i < objects.size() - 1; i++)
+	{
+		pool.Deallocate(objects[i]);
+	}
+
+	EXPECT_EQ(pool.GetNumSlabs(), 2u);
+
+	pool.Deallocate(objects.back());
+	EXPECT_EQ(pool.GetNumAllocatedObjects(), 0u);
+
+	// Only a single empty slab should be retained.
+	EXPECT_EQ(pool.GetNumSlabs(), 1u);
+}
+
+TEST(ObjectPoolTest, EmptySlabsReleased)
+{
+	ObjectPool<TestObject, 4> pool;
+
+	// This object is never freed, which keeps the pool from ever being emptied.
+	auto *longLivedObject = pool.Allocate();
+
+	std::vector<void *> objects;
+
+	for (int i = 0; i < 4 * 10; i++)
+	{
+		objects.push_back(pool.Allocate());
+	}
+
+	EXPECT_EQ(pool.GetNumSlabs(), 11u);
+
+	for (auto *object : objects)
+	{
+		pool.Deallocate(object);
+	}
+
+	// The slab containing the long-lived object should be kept, along with a single empty slab.
+	// All the other slabs are empty, so should have been released.
+	EXPECT_EQ(pool.GetNumAllocatedObjects(), 1u);
+	EXPECT_EQ(pool.GetNumSlabs(), 2u);
+
+	pool.Deallocate(longLivedObject);
+}
+
+TEST(ObjectPoolTest, LowestSlabUsedFirst)
+{
+	ObjectPool<TestObject, 2> pool;
+	std::vector<void *> objects;
+
+	for (int i = 0; i < 6; i++)
+	{
+		objects.push_back(pool.Allocate());
+	}
+
+	EXPECT_EQ(pool.GetNumSlabs(), 3u);
+
+	// Free one object from each slab.
+	pool.Deallocate(objects[0]);
+	pool.Deallocate(objects[2]);
+	pool.Deallocate(objects[4]);
+
+	auto *lowestFreedObject =
+		std::min({ objects[0], objects[2], objects[4] }, std::less<void *>());
+
+	// Allocations should be made from the slab with the lowest address, so that the objects that
+	// are alive are concentrated in as few slabs as possible.
+	auto *object = pool.Allocate();
+	EXPECT_EQ(object, lowestFreedObject);
+
+	pool.Deallocate(object);
+	pool.Deallocate(objects[1]);
+	pool.Deallocate(objects[3]);
+	pool.Deallocate(objects[5]);
+}
@@ -66,6 +66,55 @@ TEST_F(SearchTabsModelTest, GetResults)
 	EXPECT_THAT(GeneratorToVector(m_model.GetResults()), IsEmpty());
 }
 
+TEST_F(SearchTabsModelTest, FuzzyResults)
+{
+	auto *browser1 = AddBrowser();
+	auto *tab1 = browser1->AddTab(L"c:\\users\\documents");
+
+	auto *browser2 = AddBrowser();
+	auto *tab2 = browser2->AddTab(L"d:\\old code");
+
+	auto *browser3 = AddBrowser();
+	browser3->AddTab(L"e:\\projects");
+
+	// Both tabs match, but tab1 is a better match, so it should appear first, even though tab2 was
+	// active more recently.
+	m_model.SetSearchTerm(L"doc");
+	EXPECT_THAT(GeneratorToVector(m_model.GetResults()), ElementsAre(tab1, tab2));
+
+	m_model.SetSearchTerm(L"usrdcmnts");
+	EXPECT_THAT(GeneratorToVector(m_model.GetResults()), ElementsAre(tab1));
+}
+
+TEST_F(SearchTabsModelTest, ExtendedSearchTerm)
+{
+	auto *browser = AddBrowser();
+	auto *tab1 = browser->AddTab(L"c:\\documents");
+	auto *tab2 = browser->AddTab(L"c:\\windows");
+
+	m_model.SetSearchTerm(L"doc");
+	EXPECT_THAT(GeneratorToVector(m_model.GetResults()), ElementsAre(tab1));
+
+	// Neither of these tabs matched the previous search term. They should still be considered when
+	// the search term is extended, since they have changed since the previous search.
+	NavigateTab(tab2, L"c:\\docs");
+	auto *tab3 = browser->AddTab(L"d:\\docs");
+
+	m_model.SetSearchTerm(L"docs");
+	auto results = GeneratorToVector(m_model.GetResults());
+	EXPECT_THAT(results, UnorderedElementsAre(tab1, tab2, tab3));
+
+	// tab1 only matches the search term in a non-contiguous way, so it should appear last.
+	EXPECT_EQ(results.back(), tab1);
+
+	m_model.SetSearchTerm(L"docsx");
+	EXPECT_THAT(GeneratorToVector(m_model.GetResults()), IsEmpty());
+
+	// Shortening the search term should result in all tabs being considered again.
+	m_model.SetSearchTerm(L"do");
+	EXPECT_THAT(GeneratorToVector(m_model.GetResults()), UnorderedElementsAre(tab1, tab2, tab3));
+}
+
 TEST_F(SearchTabsModelTest, TabCreationTriggersUpdatedSignal)
 {
 	auto *browser = AddBrowser();
@@ -140,6 +189,28 @@ TEST_F(SearchTabsModelTest, TabRemovalTriggersUpdatedSignal)
 	browser->GetActiveTabContainer()->CloseTab(browser->GetActiveTabContainer()->GetTab(tabId2));
 }
 
+TEST_F(SearchTabsModelTest, TabRemovalTriggersTabRemovedSignal)
+{
+	auto *browser = AddBrowser();
+	browser->AddTab(L"c:\\");
+	int tabId2 = browser->AddTabAndReturnId(L"c:\\");
+
+	MockFunction<void()> updatedCallback;
+	m_model.updatedSignal.AddObserver(updatedCallback.AsStdFunction());
+
+	MockFunction<void()> tabRemovedCallback;
+	m_model.tabRemovedSignal.AddObserver(tabRemovedCallback.AsStdFunction());
+
+	{
+		InSequence seq;
+
+		EXPECT_CALL(updatedCallback, Call());
+		EXPECT_CALL(tabRemovedCallback, Call());
+	}
+
+	browser->GetActiveTabContainer()->CloseTab(browser->GetActiveTabContainer()->GetTab(tabId2));
+}
+
 TEST_F(SearchTabsModelTest, DirectoryPropertiesChangedTriggersUpdatedSignal)
 {
 	auto *browser = AddBrowser();
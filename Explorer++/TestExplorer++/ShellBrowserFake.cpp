@@ -56,6 +56,11 @@ void ShellBrowserFake::NavigateToPath(const std::wstring &path, HistoryEntryType
 	}
 }
 
+void ShellBrowserFake::SetMemoryUsage(const ShellBrowserMemoryUsage &memoryUsage)
+{
+	m_memoryUsage = memoryUsage;
+}
+
 NavigationManager *ShellBrowserFake::GetNavigationManager()
 {
 	return &m_navigationManager;
@@ -232,6 +237,11 @@ void ShellBrowserFake::EditFilterSettings()
 {
 }
 
+void ShellBrowserFake::Refresh()
+{
+	m_navigationController->Refresh();
+}
+
 bool ShellBrowserFake::CanSaveDirectoryListing() const
 {
 	return false;
@@ -241,6 +251,24 @@ void ShellBrowserFake::SaveDirectoryListing()
 {
 }
 
+ShellBrowserMemoryUsage ShellBrowserFake::GetMemoryUsage() const
+{
+	return m_memoryUsage;
+}
+
+bool ShellBrowserFake::DiscardContents()
+{
+	// Only the history is retained when the contents are discarded.
+	m_memoryUsage = { .history = m_memoryUsage.history };
+	m_contentsDiscarded = true;
+	return true;
+}
+
+bool ShellBrowserFake::AreContentsDiscarded() const
+{
+	return m_contentsDiscarded;
+}
+
 boost::signals2::connection ShellBrowserFake::AddDestroyedObserver(
 	const DestroyedSignal::slot_type &observer)
 {
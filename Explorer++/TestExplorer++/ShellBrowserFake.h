@@ -31,6 +31,8 @@ public:
 		HistoryEntryType addHistoryType = HistoryEntryType::AddEntry,
 		PidlAbsolute *outputPidl = nullptr);
 
+	void SetMemoryUsage(const ShellBrowserMemoryUsage &memoryUsage);
+
 	// ShellBrowser
 	const FolderSettings &GetFolderSettings() const override;
 	ShellNavigationController *GetNavigationController() const override;
@@ -67,8 +69,12 @@ public:
 	bool IsFilterEnabled() const override;
 	void SetFilterEnabled(bool enabled) override;
 	void EditFilterSettings() override;
+	void Refresh() override;
 	bool CanSaveDirectoryListing() const override;
 	void SaveDirectoryListing() override;
+	ShellBrowserMemoryUsage GetMemoryUsage() const override;
+	bool DiscardContents() override;
+	bool AreContentsDiscarded() const override;
 	boost::signals2::connection AddDestroyedObserver(
 		const DestroyedSignal::slot_type &observer) override;
 
@@ -83,5 +89,7 @@ private:
 	const std::shared_ptr<concurrencpp::inline_executor> m_inlineExecutor;
 	NavigationManager m_navigationManager;
 	std::unique_ptr<ShellNavigationController> m_navigationController;
+	ShellBrowserMemoryUsage m_memoryUsage;
+	bool m_contentsDiscarded = false;
 	DestroyedSignal m_destroyedSignal;
 };
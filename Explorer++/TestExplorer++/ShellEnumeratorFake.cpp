@@ -4,18 +4,46 @@
 
 #include "pch.h"
 #include "ShellEnumeratorFake.h"
+#include "ShellTestHelper.h"
 
 HRESULT ShellEnumeratorFake::EnumerateDirectory(PCIDLIST_ABSOLUTE pidlDirectory,
 	std::vector<PidlChild> &outputItems, std::stop_token stopToken) const
 {
 	UNREFERENCED_PARAMETER(pidlDirectory);
-	UNREFERENCED_PARAMETER(outputItems);
 	UNREFERENCED_PARAMETER(stopToken);
 
-	return m_shouldSucceed ? S_OK : E_FAIL;
+	m_numEnumerations++;
+
+	if (!m_shouldSucceed)
+	{
+		return E_FAIL;
+	}
+
+	for (size_t i = 0; i < m_numItems; i++)
+	{
+		outputItems.push_back(
+			CreateSimplePidlForTest(L"c:\\fake\\item" + std::to_wstring(i)).GetLastItem());
+	}
+
+	return S_OK;
+}
+
+SHCONTF ShellEnumeratorFake::GetEnumerationFlags() const
+{
+	return SHCONTF_FOLDERS | SHCONTF_NONFOLDERS;
 }
 
 void ShellEnumeratorFake::SetShouldSucceed(bool shouldSucceed)
 {
 	m_shouldSucceed = shouldSucceed;
 }
+
+void ShellEnumeratorFake::SetNumItems(size_t numItems)
+{
+	m_numItems = numItems;
+}
+
+int ShellEnumeratorFake::GetNumEnumerations() const
+{
+	return m_numEnumerations;
+}
@@ -11,9 +11,14 @@ class ShellEnumeratorFake : public ShellEnumerator
 public:
 	HRESULT EnumerateDirectory(PCIDLIST_ABSOLUTE pidlDirectory, std::vector<PidlChild> &outputItems,
 		std::stop_token stopToken) const override;
+	SHCONTF GetEnumerationFlags() const override;
 
 	void SetShouldSucceed(bool shouldSucceed);
+	void SetNumItems(size_t numItems);
+	int GetNumEnumerations() const;
 
 private:
 	bool m_shouldSucceed = true;
+	size_t m_numItems = 0;
+	mutable int m_numEnumerations = 0;
 };
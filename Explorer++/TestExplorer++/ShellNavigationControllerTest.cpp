@@ -323,6 +323,7 @@ TEST_F(ShellNavigationControllerTest, SetNavigationTargetMode)
 	auto expectedParams = params;
 	expectedParams.historyEntryType = HistoryEntryType::ReplaceCurrentEntry;
 	expectedParams.overrideNavigationTargetMode = true;
+	expectedParams.allowCachedListing = false;
 
 	// Although the navigation mode has been set, the navigation is an implicit refresh and should
 	// always proceed in the same tab.
@@ -0,0 +1,200 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellTreeView/ShellTreeChildren.h"
+#include "ComStaThreadPoolExecutor.h"
+#include "ScopedTestDir.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace testing;
+
+class ShellTreeChildrenEnumerationTest : public Test
+{
+protected:
+	void SetUp() override
+	{
+		HRESULT hr = SHParseDisplayName(m_scopedTestDir.GetPath().c_str(), nullptr,
+			PidlOutParam(m_scopedTestDirPidl), 0, nullptr);
+		ASSERT_HRESULT_SUCCEEDED(hr);
+	}
+
+	void CreateFolder(const std::wstring &name)
+	{
+		ASSERT_TRUE(std::filesystem::create_directory(m_scopedTestDir.GetPath() / name));
+	}
+
+	static std::vector<std::wstring> GetDisplayNames(
+		const std::vector<ShellTreeChildren::ChildNodeInfo> &children)
+	{
+		std::vector<std::wstring> displayNames;
+
+		for (const auto &child : children)
+		{
+			displayNames.push_back(child.nodeInfo.displayName);
+		}
+
+		return displayNames;
+	}
+
+	ScopedTestDir m_scopedTestDir;
+	PidlAbsolute m_scopedTestDirPidl;
+};
+
+TEST_F(ShellTreeChildrenEnumerationTest, EnumerateOnBackgroundThread)
+{
+	CreateFolder(L"b10");
+	CreateFolder(L"a");
+	CreateFolder(L"b9");
+	std::ofstream(m_scopedTestDir.GetPath() / L"file.txt");
+
+	auto executor = std::make_shared<ComStaThreadPoolExecutor>(1);
+
+	std::vector<ShellTreeChildren::ChildNodeInfo> children;
+	auto result = executor->submit(
+		[this, &children]
+		{
+			return ShellTreeChildren::EnumerateChildNodes(m_scopedTestDirPidl.Raw(), {},
+				children);
+		});
+	HRESULT hr = result.get();
+	executor->shutdown();
+	ASSERT_HRESULT_SUCCEEDED(hr);
+
+	// Only folders should be returned, in natural sort order.
+	EXPECT_EQ(GetDisplayNames(children), (std::vector<std::wstring>{ L"a", L"b9", L"b10" }));
+
+	// The shell items were created on the background thread, so shouldn't be retained.
+	for (const auto &child : children)
+	{
+		EXPECT_EQ(child.nodeInfo.shellItem, nullptr);
+	}
+}
+
+TEST_F(ShellTreeChildrenEnumerationTest, SortOrder)
+{
+	CreateFolder(L"b10");
+	CreateFolder(L"b9");
+
+	ShellTreeChildren::EnumerationOptions options;
+	options.useNaturalSortOrder = false;
+
+	std::vector<ShellTreeChildren::ChildNodeInfo> children;
+	HRESULT hr =
+		ShellTreeChildren::EnumerateChildNodes(m_scopedTestDirPidl.Raw(), options, children);
+	ASSERT_HRESULT_SUCCEEDED(hr);
+	EXPECT_EQ(GetDisplayNames(children), (std::vector<std::wstring>{ L"b10", L"b9" }));
+}
+
+TEST_F(ShellTreeChildrenEnumerationTest, RetainShellItems)
+{
+	CreateFolder(L"folder");
+
+	ShellTreeChildren::EnumerationOptions options;
+	options.retainShellItems = true;
+
+	std::vector<ShellTreeChildren::ChildNodeInfo> children;
+	HRESULT hr =
+		ShellTreeChildren::EnumerateChildNodes(m_scopedTestDirPidl.Raw(), options, children);
+	ASSERT_HRESULT_SUCCEEDED(hr);
+	ASSERT_EQ(children.size(), 1u);
+	EXPECT_NE(children[0].nodeInfo.shellItem, nullptr);
+}
+
+TEST_F(ShellTreeChildrenEnumerationTest, HiddenFolders)
+{
+	CreateFolder(L"hidden");
+	ASSERT_TRUE(SetFileAttributes((m_scopedTestDir.GetPath() / L"hidden").c_str(),
+		FILE_ATTRIBUTE_HIDDEN));
+
+	ShellTreeChildren::EnumerationOptions options;
+	options.showHidden = false;
+
+	std::vector<ShellTreeChildren::ChildNodeInfo> children;
+	HRESULT hr =
+		ShellTreeChildren::EnumerateChildNodes(m_scopedTestDirPidl.Raw(), options, children);
+	ASSERT_HRESULT_SUCCEEDED(hr);
+	EXPECT_TRUE(children.empty());
+
+	options.showHidden = true;
+	hr = ShellTreeChildren::EnumerateChildNodes(m_scopedTestDirPidl.Raw(), options, children);
+	ASSERT_HRESULT_SUCCEEDED(hr);
+	ASSERT_EQ(children.size(), 1u);
+	EXPECT_TRUE(children[0].nodeInfo.hidden);
+}
+
+class ShellTreeChildrenInsertionTest : public Test
+{
+protected:
+	static std::vector<ShellTreeChildren::ChildNodeInfo> BuildChildren(size_t numChildren)
+	{
+		std::vector<ShellTreeChildren::ChildNodeInfo> children(numChildren);
+
+		for (size_t i = 0; i < numChildren; i++)
+		{
+			children[i].nodeInfo.displayName = std::to_wstring(i);
+		}
+
+		return children;
+	}
+};
+
+TEST_F(ShellTreeChildrenInsertionTest, NumChildrenToInsertInitially)
+{
+	// Small folders should be inserted in full.
+	EXPECT_EQ(ShellTreeChildren::GetNumChildrenToInsertInitially(
+				  ShellTreeChildren::INCREMENTAL_INSERTION_THRESHOLD, 20),
+		ShellTreeChildren::INCREMENTAL_INSERTION_THRESHOLD);
+
+	// Otherwise, only the children that can be visible should be inserted straight away.
+	EXPECT_EQ(ShellTreeChildren::GetNumChildrenToInsertInitially(
+				  ShellTreeChildren::INCREMENTAL_INSERTION_THRESHOLD + 1, 20),
+		21u);
+}
+
+TEST_F(ShellTreeChildrenInsertionTest, Batches)
+{
+	constexpr size_t NUM_INITIALLY_INSERTED = 5;
+	constexpr size_t NUM_REMAINING = 10;
+	constexpr size_t NUM_CHILDREN = NUM_INITIALLY_INSERTED
+		+ (2 * ShellTreeChildren::INCREMENTAL_INSERTION_BATCH_SIZE) + NUM_REMAINING;
+
+	ShellTreeChildren::PendingInsertion pendingInsertion(BuildChildren(NUM_CHILDREN),
+		NUM_INITIALLY_INSERTED);
+	EXPECT_FALSE(pendingInsertion.IsComplete());
+
+	auto batch = pendingInsertion.TakeNextBatch();
+	ASSERT_EQ(batch.size(), ShellTreeChildren::INCREMENTAL_INSERTION_BATCH_SIZE);
+	EXPECT_EQ(batch.front().nodeInfo.displayName, std::to_wstring(NUM_INITIALLY_INSERTED));
+
+	batch = pendingInsertion.TakeNextBatch();
+	ASSERT_EQ(batch.size(), ShellTreeChildren::INCREMENTAL_INSERTION_BATCH_SIZE);
+	EXPECT_EQ(batch.front().nodeInfo.displayName,
+		std::to_wstring(
+			NUM_INITIALLY_INSERTED + ShellTreeChildren::INCREMENTAL_INSERTION_BATCH_SIZE));
+	EXPECT_FALSE(pendingInsertion.IsComplete());
+
+	batch = pendingInsertion.TakeNextBatch();
+	ASSERT_EQ(batch.size(), NUM_REMAINING);
+	EXPECT_EQ(batch.back().nodeInfo.displayName, std::to_wstring(NUM_CHILDREN - 1));
+	EXPECT_TRUE(pendingInsertion.IsComplete());
+}
+
+TEST_F(ShellTreeChildrenInsertionTest, TakeRemaining)
+{
+	constexpr size_t NUM_CHILDREN = ShellTreeChildren::INCREMENTAL_INSERTION_BATCH_SIZE * 3;
+
+	ShellTreeChildren::PendingInsertion pendingInsertion(BuildChildren(NUM_CHILDREN), 1);
+	pendingInsertion.TakeNextBatch();
+
+	auto remaining = pendingInsertion.TakeRemaining();
+	ASSERT_EQ(remaining.size(),
+		NUM_CHILDREN - 1 - ShellTreeChildren::INCREMENTAL_INSERTION_BATCH_SIZE);
+	EXPECT_EQ(remaining.front().nodeInfo.displayName,
+		std::to_wstring(1 + ShellTreeChildren::INCREMENTAL_INSERTION_BATCH_SIZE));
+	EXPECT_TRUE(pendingInsertion.IsComplete());
+	EXPECT_TRUE(pendingInsertion.TakeNextBatch().empty());
+}
@@ -0,0 +1,201 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "ShellTreeView/ShellTreeNode.h"
+#include "ShellTestHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+using namespace testing;
+
+class ShellTreeNodeTest : public Test
+{
+protected:
+	ShellTreeNodeTest() :
+		m_initialNumAllocatedNodes(ShellTreeNode::GetPool().GetNumAllocatedObjects())
+	{
+	}
+
+	size_t GetNumAllocatedNodes() const
+	{
+		return ShellTreeNode::GetPool().GetNumAllocatedObjects() - m_initialNumAllocatedNodes;
+	}
+
+	const size_t m_initialNumAllocatedNodes;
+};
+
+TEST_F(ShellTreeNodeTest, AddRemoveChildren)
+{
+	auto rootPidl = CreateSimplePidlForTest(L"C:\\Fake");
+	auto rootNode =
+		std::make_unique<ShellTreeNode>(ShellTreeNodeType::Root, rootPidl.Raw(), nullptr);
+
+	auto childPidl = CreateSimplePidlForTest(L"C:\\Fake\\Child");
+	auto *childNode = rootNode->AddChild(
+		std::make_unique<ShellTreeNode>(ShellTreeNodeType::Child, childPidl.Raw(), nullptr));
+	EXPECT_EQ(childNode->GetParent(), rootNode.get());
+	EXPECT_EQ(rootNode->GetChildren().size(), 1u);
+	EXPECT_TRUE(ArePidlsEquivalent(childNode->GetFullPidl().get(), childPidl.Raw()));
+	EXPECT_EQ(GetNumAllocatedNodes(), 2u);
+
+	auto removedNode = rootNode->RemoveChild(childNode);
+	EXPECT_EQ(removedNode.get(), childNode);
+	EXPECT_EQ(removedNode->GetParent(), nullptr);
+	EXPECT_TRUE(rootNode->GetChildren().empty());
+
+	removedNode.reset();
+	EXPECT_EQ(GetNumAllocatedNodes(), 1u);
+}
+
+// Builds a synthetic tree with 100,000 nodes, then collapses it. The time taken for each step is
+// recorded, so that it can be compared across changes.
+TEST_F(ShellTreeNodeTest, ExpandAndCollapseLargeTree)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr size_t NUM_FOLDERS = 100;
+	constexpr size_t NUM_CHILDREN_PER_FOLDER = 999;
+
+	auto rootPidl = CreateSimplePidlForTest(L"C:\\Fake");
+	auto rootNode =
+		std::make_unique<ShellTreeNode>(ShellTreeNodeType::Root, rootPidl.Raw(), nullptr);
+
+	// Each node takes a copy of the pidl, so the same pidl can be used for every child.
+	auto childPidl = CreateSimplePidlForTest(L"C:\\Fake\\Child");
+
+	auto expandStart = Clock::now();
+
+	rootNode->ReserveChildren(NUM_FOLDERS);
+
+	for (size_t i = 0; i < NUM_FOLDERS; i++)
+	{
+		auto *folderNode = rootNode->AddChild(
+			std::make_unique<ShellTreeNode>(ShellTreeNodeType::Child, childPidl.Raw(), nullptr));
+		folderNode->ReserveChildren(NUM_CHILDREN_PER_FOLDER);
+
+		for (size_t j = 0; j < NUM_CHILDREN_PER_FOLDER; j++)
+		{
+			folderNode->AddChild(std::make_unique<ShellTreeNode>(ShellTreeNodeType::Child,
+				childPidl.Raw(), nullptr));
+		}
+	}
+
+	auto expandDuration = Clock::now() - expandStart;
+
+	EXPECT_EQ(GetNumAllocatedNodes(), 1 + NUM_FOLDERS + NUM_FOLDERS * NUM_CHILDREN_PER_FOLDER);
+
+	auto collapseStart = Clock::now();
+	rootNode->RemoveAllChildren();
+	auto collapseDuration = Clock::now() - collapseStart;
+
+	EXPECT_EQ(GetNumAllocatedNodes(), 1u);
+
+	RecordProperty("ExpandMilliseconds",
+		std::to_string(
+			std::chrono::duration_cast<std::chrono::milliseconds>(expandDuration).count()));
+	RecordProperty("CollapseMilliseconds",
+		std::to_string(
+			std::chrono::duration_cast<std::chrono::milliseconds>(collapseDuration).count()));
+}
+
+// Provides a baseline for the test above, by comparing the cost of allocating and freeing nodes
+// from a pool against the cost of allocating and freeing them from the heap. Only memory is
+// allocated here (no nodes are constructed), so the difference between the two timings is the
+// saving (or cost) of the pool.
+//
+// Folders are expanded and collapsed in an interleaved order, as they would be when a user
+// browses a tree. That means that the nodes freed by a collapse are spread across slabs that also
+// contain live nodes, so each deallocation from the pool pays for the slab lookup (in a std::map)
+// and the updates to the set of slabs with free slots, in the same way it does in practice.
+TEST_F(ShellTreeNodeTest, InterleavedExpandAndCollapsePoolComparedToHeap)
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr size_t NUM_FOLDERS = 100;
+	constexpr size_t NUM_CHILDREN_PER_FOLDER = 999;
+	constexpr size_t NUM_ROUNDS = 10;
+
+	auto runScenario = [](auto allocate, auto deallocate)
+	{
+		std::vector<std::vector<void *>> folders(NUM_FOLDERS);
+
+		auto expand = [&folders, &allocate](size_t folderIndex)
+		{
+			auto &children = folders[folderIndex];
+			children.reserve(NUM_CHILDREN_PER_FOLDER);
+
+			for (size_t i = 0; i < NUM_CHILDREN_PER_FOLDER; i++)
+			{
+				children.push_back(allocate());
+			}
+		};
+
+		auto collapse = [&folders, &deallocate](size_t folderIndex)
+		{
+			auto &children = folders[folderIndex];
+
+			for (auto *child : children)
+			{
+				deallocate(child);
+			}
+
+			children.clear();
+		};
+
+		auto start = Clock::now();
+
+		for (size_t i = 0; i < NUM_FOLDERS; i++)
+		{
+			expand(i);
+		}
+
+		// In each round, every other folder is collapsed and then re-expanded, with the set of
+		// folders alternating between rounds. The folders are re-expanded in the reverse order, so
+		// that each folder's new nodes fill the gaps left by other folders.
+		for (size_t round = 0; round < NUM_ROUNDS; round++)
+		{
+			std::vector<size_t> roundFolders;
+
+			for (size_t i = round % 2; i < NUM_FOLDERS; i += 2)
+			{
+				roundFolders.push_back(i);
+			}
+
+			for (auto folderIndex : roundFolders)
+			{
+				collapse(folderIndex);
+			}
+
+			for (auto itr = roundFolders.rbegin(); itr != roundFolders.rend(); ++itr)
+			{
+				expand(*itr);
+			}
+		}
+
+		for (size_t i = 0; i < NUM_FOLDERS; i++)
+		{
+			collapse(i);
+		}
+
+		return Clock::now() - start;
+	};
+
+	ShellTreeNode::Pool pool;
+	auto poolDuration = runScenario([&pool]() { return pool.Allocate(); },
+		[&pool](void *allocation) { pool.Deallocate(allocation); });
+
+	EXPECT_EQ(pool.GetNumAllocatedObjects(), 0u);
+
+	auto heapDuration = runScenario([]() { return ::operator new(sizeof(ShellTreeNode)); },
+		[](void *allocation) { ::operator delete(allocation); });
+
+	RecordProperty("PoolMicroseconds",
+		std::to_string(
+			std::chrono::duration_cast<std::chrono::microseconds>(poolDuration).count()));
+	RecordProperty("HeapMicroseconds",
+		std::to_string(
+			std::chrono::duration_cast<std::chrono::microseconds>(heapDuration).count()));
+}
@@ -0,0 +1,84 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/SnapshotFile.h"
+#include "ScopedTestDir.h"
+#include <gtest/gtest.h>
+#include <fstream>
+
+using namespace testing;
+
+class SnapshotFileTest : public Test
+{
+protected:
+	std::wstring GetSnapshotPath() const
+	{
+		return m_scopedTestDir.GetPath() / L"test.snapshot";
+	}
+
+	ScopedTestDir m_scopedTestDir;
+};
+
+TEST(SnapshotFileCrc32Test, CheckValue)
+{
+	// This is the standard check value for CRC-32.
+	EXPECT_EQ(SnapshotFile::CalculateCrc32("123456789"), 0xCBF43926U);
+	EXPECT_EQ(SnapshotFile::CalculateCrc32(""), 0U);
+}
+
+TEST_F(SnapshotFileTest, WriteAndRead)
+{
+	std::string payload = "payload";
+	payload += '\0';
+	payload += "with embedded null";
+
+	ASSERT_TRUE(SnapshotFile::Write(GetSnapshotPath(), 3, payload));
+
+	auto snapshot = SnapshotFile::MappedSnapshot::MaybeOpen(GetSnapshotPath(), 3);
+	ASSERT_NE(snapshot, nullptr);
+	EXPECT_EQ(snapshot->GetPayload(), payload);
+}
+
+TEST_F(SnapshotFileTest, Overwrite)
+{
+	ASSERT_TRUE(SnapshotFile::Write(GetSnapshotPath(), 1, "first"));
+	ASSERT_TRUE(SnapshotFile::Write(GetSnapshotPath(), 1, "second"));
+
+	auto snapshot = SnapshotFile::MappedSnapshot::MaybeOpen(GetSnapshotPath(), 1);
+	ASSERT_NE(snapshot, nullptr);
+	EXPECT_EQ(snapshot->GetPayload(), "second");
+}
+
+TEST_F(SnapshotFileTest, VersionMismatch)
+{
+	ASSERT_TRUE(SnapshotFile::Write(GetSnapshotPath(), 1, "payload"));
+	EXPECT_EQ(SnapshotFile::MappedSnapshot::MaybeOpen(GetSnapshotPath(), 2), nullptr);
+}
+
+TEST_F(SnapshotFileTest, Corrupted)
+{
+	ASSERT_TRUE(SnapshotFile::Write(GetSnapshotPath(), 1, "payload"));
+
+	{
+		std::fstream stream(GetSnapshotPath(), std::ios::binary | std::ios::in | std::ios::out);
+		stream.seekp(-1, std::ios::end);
+		stream.put('X');
+	}
+
+	EXPECT_EQ(SnapshotFile::MappedSnapshot::MaybeOpen(GetSnapshotPath(), 1), nullptr);
+}
+
+TEST_F(SnapshotFileTest, Truncated)
+{
+	ASSERT_TRUE(SnapshotFile::Write(GetSnapshotPath(), 1, "payload"));
+	std::filesystem::resize_file(GetSnapshotPath(), 10);
+
+	EXPECT_EQ(SnapshotFile::MappedSnapshot::MaybeOpen(GetSnapshotPath(), 1), nullptr);
+}
+
+TEST_F(SnapshotFileTest, Missing)
+{
+	EXPECT_EQ(SnapshotFile::MappedSnapshot::MaybeOpen(GetSnapshotPath(), 1), nullptr);
+}
@@ -401,6 +401,60 @@ TEST_F(TabContainerTest, DuplicateTabWithHistory)
 		CreateSimplePidlForTest(L"e:\\"));
 }
 
+TEST_F(TabContainerTest, DeferredNavigation)
+{
+	auto *tab1 = m_browser->AddTab(L"c:\\");
+
+	MockFunction<void(const NavigationRequest *request)> startedCallback;
+	m_navigationEvents.AddStartedObserver(startedCallback.AsStdFunction(),
+		NavigationEventScope::ForBrowser(*m_browser));
+
+	// The navigation in a background tab shouldn't start until the tab is selected.
+	EXPECT_CALL(startedCallback, Call(_)).Times(0);
+	auto *tab2 = m_browser->AddTab(L"c:\\path\\to\\folder", { .deferNavigation = true });
+	EXPECT_FALSE(m_tabContainer->IsTabLoaded(*tab2));
+	EXPECT_TRUE(m_tabContainer->IsTabLoaded(*tab1));
+
+	// The tab should still show the name of the folder it was created in.
+	EXPECT_EQ(tab2->GetName(), L"folder");
+
+	Mock::VerifyAndClearExpectations(&startedCallback);
+
+	EXPECT_CALL(startedCallback, Call(_));
+	m_tabContainer->SelectTab(*tab2);
+	EXPECT_TRUE(m_tabContainer->IsTabLoaded(*tab2));
+
+	Mock::VerifyAndClearExpectations(&startedCallback);
+
+	// Selecting the tab again shouldn't result in another navigation.
+	EXPECT_CALL(startedCallback, Call(_)).Times(0);
+	m_tabContainer->SelectTab(*tab1);
+	m_tabContainer->SelectTab(*tab2);
+}
+
+TEST_F(TabContainerTest, DeferredNavigationSelectedTab)
+{
+	m_browser->AddTab(L"c:\\");
+
+	// A tab that's selected on creation can't be deferred.
+	auto *tab = m_browser->AddTab(L"d:\\", { .selected = true, .deferNavigation = true });
+	EXPECT_TRUE(m_tabContainer->IsTabLoaded(*tab));
+}
+
+TEST_F(TabContainerTest, DeferredNavigationReplacedByNavigation)
+{
+	m_browser->AddTab(L"c:\\");
+	auto *tab = m_browser->AddTab(L"d:\\", { .deferNavigation = true });
+
+	// Navigating the tab directly should cancel the deferred navigation.
+	NavigateTab(tab, L"c:\\path\\to\\folder");
+	EXPECT_TRUE(m_tabContainer->IsTabLoaded(*tab));
+
+	// Selecting the tab shouldn't then navigate back to the original folder.
+	m_tabContainer->SelectTab(*tab);
+	EXPECT_EQ(tab->GetName(), L"folder");
+}
+
 TEST_F(TabContainerTest, CloseAllTabs)
 {
 	m_browser->AddTab(L"c:\\");
@@ -0,0 +1,106 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "TabMemoryManager.h"
+#include "BrowserTestBase.h"
+#include "BrowserWindowFake.h"
+#include "ShellBrowserFake.h"
+#include "Tab.h"
+#include "TabList.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+class TabMemoryManagerTest : public BrowserTestBase
+{
+protected:
+	static constexpr size_t ONE_MB = 1024 * 1024;
+
+	TabMemoryManagerTest() :
+		m_tabList(&m_tabEvents),
+		m_tabMemoryManager(&m_tabList, &m_config),
+		m_browser(AddBrowser()),
+		m_tab1(m_browser->AddTab(L"c:\\")),
+		m_tab2(m_browser->AddTab(L"d:\\")),
+		m_tab3(m_browser->AddTab(L"e:\\"))
+	{
+		// Results in the tabs being ordered (from least to most recently used) as: tab 2, tab 3,
+		// tab 1. Tab 1 is selected.
+		auto *tabContainer = m_browser->GetActiveTabContainer();
+		tabContainer->SelectTab(*m_tab2);
+		tabContainer->SelectTab(*m_tab3);
+		tabContainer->SelectTab(*m_tab1);
+
+		for (auto *tab : { m_tab1, m_tab2, m_tab3 })
+		{
+			GetShellBrowser(tab)->SetMemoryUsage({ .items = 2 * ONE_MB, .history = 1024 });
+		}
+	}
+
+	static ShellBrowserFake *GetShellBrowser(const Tab *tab)
+	{
+		return static_cast<ShellBrowserFake *>(tab->GetShellBrowser());
+	}
+
+	TabList m_tabList;
+	TabMemoryManager m_tabMemoryManager;
+
+	BrowserWindowFake *const m_browser;
+	Tab *const m_tab1;
+	Tab *const m_tab2;
+	Tab *const m_tab3;
+};
+
+TEST_F(TabMemoryManagerTest, GetTotalMemoryUsage)
+{
+	EXPECT_EQ(m_tabMemoryManager.GetTotalMemoryUsage(), (6 * ONE_MB) + (3 * 1024));
+}
+
+TEST_F(TabMemoryManagerTest, NoBudget)
+{
+	m_config.tabMemoryBudgetMB = 0;
+	m_tabMemoryManager.EnforceBudget();
+
+	EXPECT_FALSE(GetShellBrowser(m_tab1)->AreContentsDiscarded());
+	EXPECT_FALSE(GetShellBrowser(m_tab2)->AreContentsDiscarded());
+	EXPECT_FALSE(GetShellBrowser(m_tab3)->AreContentsDiscarded());
+}
+
+TEST_F(TabMemoryManagerTest, WithinBudget)
+{
+	m_config.tabMemoryBudgetMB = 10;
+	m_tabMemoryManager.EnforceBudget();
+
+	EXPECT_FALSE(GetShellBrowser(m_tab1)->AreContentsDiscarded());
+	EXPECT_FALSE(GetShellBrowser(m_tab2)->AreContentsDiscarded());
+	EXPECT_FALSE(GetShellBrowser(m_tab3)->AreContentsDiscarded());
+}
+
+TEST_F(TabMemoryManagerTest, LeastRecentlyUsedDiscardedFirst)
+{
+	m_config.tabMemoryBudgetMB = 5;
+	m_tabMemoryManager.EnforceBudget();
+
+	// Discarding tab 2 is enough to bring the total usage within the budget.
+	EXPECT_FALSE(GetShellBrowser(m_tab1)->AreContentsDiscarded());
+	EXPECT_TRUE(GetShellBrowser(m_tab2)->AreContentsDiscarded());
+	EXPECT_FALSE(GetShellBrowser(m_tab3)->AreContentsDiscarded());
+
+	EXPECT_LE(m_tabMemoryManager.GetTotalMemoryUsage(), 5 * ONE_MB);
+}
+
+TEST_F(TabMemoryManagerTest, SelectedTabNotDiscarded)
+{
+	m_config.tabMemoryBudgetMB = 1;
+	m_tabMemoryManager.EnforceBudget();
+
+	// The budget can't be met, since the selected tab is visible and can't be discarded.
+	EXPECT_FALSE(GetShellBrowser(m_tab1)->AreContentsDiscarded());
+	EXPECT_TRUE(GetShellBrowser(m_tab2)->AreContentsDiscarded());
+	EXPECT_TRUE(GetShellBrowser(m_tab3)->AreContentsDiscarded());
+
+	// The history for each tab is retained.
+	EXPECT_EQ(m_tabMemoryManager.GetTotalMemoryUsage(), (2 * ONE_MB) + (3 * 1024));
+}
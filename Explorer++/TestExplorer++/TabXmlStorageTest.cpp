@@ -8,7 +8,11 @@
 #include "TabStorage.h"
 #include "TabStorageTestHelper.h"
 #include "XmlStorageTestHelper.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
 
 using namespace testing;
 
@@ -53,3 +57,45 @@ TEST_F(TabXmlStorageTest, Save)
 
 	EXPECT_EQ(loadedTabs, referenceTabs);
 }
+
+TEST_F(TabXmlStorageTest, StreamLoad)
+{
+	std::vector<TabStorageData> referenceTabs;
+	BuildTabStorageLoadSaveReference(referenceTabs, TestStorageType::Xml);
+
+	std::ifstream stream(GetResourcePath(L"tabs.xml"), std::ios::binary);
+	XmlReader reader(stream);
+
+	// Move to the tabs element, which is the first child of the root element.
+	ASSERT_TRUE(reader.Read());
+	ASSERT_TRUE(reader.Read());
+	ASSERT_EQ(reader.GetName(), TABS_NODE_NAME);
+
+	auto loadedTabs = TabXmlStorage::Load(reader);
+	ASSERT_TRUE(loadedTabs.has_value());
+
+	EXPECT_EQ(*loadedTabs, referenceTabs);
+}
+
+TEST_F(TabXmlStorageTest, StreamSave)
+{
+	std::vector<TabStorageData> referenceTabs;
+	BuildTabStorageLoadSaveReference(referenceTabs, TestStorageType::Xml);
+
+	std::stringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		writer.StartElement(TABS_NODE_NAME);
+		TabXmlStorage::Save(writer, referenceTabs);
+		writer.EndElement();
+	}
+
+	XmlReader reader(stream);
+	ASSERT_TRUE(reader.Read());
+
+	auto loadedTabs = TabXmlStorage::Load(reader);
+	ASSERT_TRUE(loadedTabs.has_value());
+
+	EXPECT_EQ(*loadedTabs, referenceTabs);
+}
@@ -0,0 +1,296 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "TaskScheduler.h"
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace testing;
+
+class TaskSchedulerTest : public Test
+{
+protected:
+	using Priority = TaskScheduler::Priority;
+
+	TaskSchedulerTest() :
+		m_executor(std::make_shared<concurrencpp::manual_executor>()),
+		m_scheduler({ m_executor, m_executor, m_executor }, 1)
+	{
+	}
+
+	~TaskSchedulerTest()
+	{
+		m_executor->shutdown();
+	}
+
+	auto PushLabelledTask(std::shared_ptr<TaskScheduler::Group> group, Priority priority,
+		const std::wstring &label, std::optional<TaskScheduler::TaskTag> tag = std::nullopt)
+	{
+		return m_scheduler.Push(
+			group, priority, [this, label] { m_completedTasks.push_back(label); }, tag);
+	}
+
+	void RunAllTasks()
+	{
+		m_executor->loop(std::numeric_limits<size_t>::max());
+	}
+
+	const std::shared_ptr<concurrencpp::manual_executor> m_executor;
+	TaskScheduler m_scheduler;
+	std::vector<std::wstring> m_completedTasks;
+};
+
+TEST_F(TaskSchedulerTest, Result)
+{
+	auto group = m_scheduler.CreateGroup();
+	auto future = m_scheduler.Push(group, Priority::Visible, [] { return 42; });
+
+	RunAllTasks();
+	EXPECT_EQ(future.get(), 42);
+}
+
+TEST_F(TaskSchedulerTest, PriorityOrdering)
+{
+	auto group = m_scheduler.CreateGroup();
+
+	// The first task will be started immediately, which means the remaining tasks will be queued
+	// behind it.
+	PushLabelledTask(group, Priority::Background, L"Background1");
+	PushLabelledTask(group, Priority::Background, L"Background2");
+	PushLabelledTask(group, Priority::Visible, L"Visible");
+	PushLabelledTask(group, Priority::Interactive, L"Interactive");
+
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks,
+		ElementsAre(L"Background1", L"Interactive", L"Visible", L"Background2"));
+}
+
+TEST_F(TaskSchedulerTest, ConcurrencyCapped)
+{
+	auto group = m_scheduler.CreateGroup();
+
+	for (int i = 0; i < 5; i++)
+	{
+		PushLabelledTask(group, Priority::Visible, std::to_wstring(i));
+	}
+
+	EXPECT_EQ(m_scheduler.GetNumRunningTasks(), 1);
+	EXPECT_EQ(m_scheduler.GetNumQueuedTasks(), 4u);
+	EXPECT_EQ(m_executor->size(), 1u);
+
+	m_executor->loop_once();
+	EXPECT_EQ(m_scheduler.GetNumRunningTasks(), 1);
+	EXPECT_EQ(m_scheduler.GetNumQueuedTasks(), 3u);
+
+	RunAllTasks();
+	EXPECT_EQ(m_scheduler.GetNumRunningTasks(), 0);
+	EXPECT_EQ(m_scheduler.GetNumQueuedTasks(), 0u);
+	EXPECT_THAT(m_completedTasks, ElementsAre(L"0", L"1", L"2", L"3", L"4"));
+}
+
+TEST_F(TaskSchedulerTest, CancelGroup)
+{
+	auto tabGroup = m_scheduler.CreateGroup();
+	auto navigationGroup = m_scheduler.CreateGroup(tabGroup);
+	auto otherGroup = m_scheduler.CreateGroup();
+
+	PushLabelledTask(otherGroup, Priority::Visible, L"Other1");
+	PushLabelledTask(tabGroup, Priority::Visible, L"Tab");
+	PushLabelledTask(navigationGroup, Priority::Visible, L"Navigation");
+	PushLabelledTask(otherGroup, Priority::Visible, L"Other2");
+
+	// Cancelling the tab group should also cancel the tasks in the nested navigation group.
+	m_scheduler.CancelGroup(tabGroup);
+	EXPECT_TRUE(tabGroup->IsCancelled());
+	EXPECT_TRUE(navigationGroup->IsCancelled());
+	EXPECT_FALSE(otherGroup->IsCancelled());
+	EXPECT_EQ(m_scheduler.GetNumQueuedTasks(), 1u);
+
+	// Tasks pushed to a cancelled group should be ignored.
+	PushLabelledTask(navigationGroup, Priority::Visible, L"Navigation2");
+	EXPECT_EQ(m_scheduler.GetNumQueuedTasks(), 1u);
+
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks, ElementsAre(L"Other1", L"Other2"));
+}
+
+TEST_F(TaskSchedulerTest, CancelStartedTask)
+{
+	auto group = m_scheduler.CreateGroup();
+	PushLabelledTask(group, Priority::Visible, L"Task");
+	EXPECT_EQ(m_executor->size(), 1u);
+
+	// The task has already been posted to the executor, but it hasn't started running yet, so it
+	// shouldn't run.
+	m_scheduler.CancelGroup(group);
+
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks, IsEmpty());
+	EXPECT_EQ(m_scheduler.GetNumRunningTasks(), 0);
+}
+
+TEST_F(TaskSchedulerTest, ReplaceGroup)
+{
+	auto tabGroup = m_scheduler.CreateGroup();
+	auto navigationGroup = m_scheduler.CreateGroup(tabGroup);
+	m_scheduler.SetGroupVisible(navigationGroup, false);
+
+	PushLabelledTask(tabGroup, Priority::Visible, L"Tab");
+	PushLabelledTask(navigationGroup, Priority::Visible, L"Navigation1");
+
+	auto updatedNavigationGroup = m_scheduler.ReplaceGroup(navigationGroup);
+	EXPECT_TRUE(navigationGroup->IsCancelled());
+	EXPECT_FALSE(updatedNavigationGroup->IsCancelled());
+	EXPECT_FALSE(updatedNavigationGroup->IsVisible());
+
+	PushLabelledTask(updatedNavigationGroup, Priority::Visible, L"Navigation2");
+
+	// The new group should still be nested within the tab group.
+	m_scheduler.CancelGroup(tabGroup);
+	EXPECT_TRUE(updatedNavigationGroup->IsCancelled());
+
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks, ElementsAre(L"Tab"));
+}
+
+TEST_F(TaskSchedulerTest, HiddenGroupDemoted)
+{
+	auto blockingGroup = m_scheduler.CreateGroup();
+	auto visibleTabGroup = m_scheduler.CreateGroup();
+	auto hiddenTabGroup = m_scheduler.CreateGroup();
+	auto hiddenNavigationGroup = m_scheduler.CreateGroup(hiddenTabGroup);
+	m_scheduler.SetGroupVisible(hiddenTabGroup, false);
+	EXPECT_FALSE(hiddenNavigationGroup->IsVisible());
+
+	PushLabelledTask(blockingGroup, Priority::Visible, L"Blocking");
+	PushLabelledTask(hiddenNavigationGroup, Priority::Visible, L"HiddenVisible");
+	PushLabelledTask(visibleTabGroup, Priority::Visible, L"VisibleVisible");
+
+	// Interactive tasks shouldn't be demoted, even in a hidden group.
+	PushLabelledTask(hiddenNavigationGroup, Priority::Interactive, L"HiddenInteractive");
+
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks,
+		ElementsAre(L"Blocking", L"HiddenInteractive", L"VisibleVisible", L"HiddenVisible"));
+}
+
+TEST_F(TaskSchedulerTest, GroupShown)
+{
+	auto blockingGroup = m_scheduler.CreateGroup();
+	auto tabGroup1 = m_scheduler.CreateGroup();
+	auto tabGroup2 = m_scheduler.CreateGroup();
+	m_scheduler.SetGroupVisible(tabGroup1, false);
+	m_scheduler.SetGroupVisible(tabGroup2, false);
+
+	PushLabelledTask(blockingGroup, Priority::Visible, L"Blocking");
+	PushLabelledTask(tabGroup1, Priority::Visible, L"Tab1");
+	PushLabelledTask(tabGroup2, Priority::Visible, L"Tab2");
+
+	// Once the second tab is shown, its tasks should be run ahead of the tasks for the first tab.
+	m_scheduler.SetGroupVisible(tabGroup2, true);
+
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks, ElementsAre(L"Blocking", L"Tab2", L"Tab1"));
+}
+
+TEST_F(TaskSchedulerTest, GroupHidden)
+{
+	auto blockingGroup = m_scheduler.CreateGroup();
+	auto tabGroup1 = m_scheduler.CreateGroup();
+	auto navigationGroup1 = m_scheduler.CreateGroup(tabGroup1);
+	auto tabGroup2 = m_scheduler.CreateGroup();
+
+	PushLabelledTask(blockingGroup, Priority::Visible, L"Blocking");
+	PushLabelledTask(tabGroup2, Priority::Background, L"Tab2Background");
+	PushLabelledTask(navigationGroup1, Priority::Visible, L"Tab1Visible");
+	PushLabelledTask(navigationGroup1, Priority::Interactive, L"Tab1Interactive");
+	PushLabelledTask(tabGroup2, Priority::Visible, L"Tab2Visible");
+
+	// The visible task for the first tab should be demoted once that tab is hidden. It should then
+	// be run after the background task that was queued before it. The other tasks shouldn't be
+	// affected.
+	m_scheduler.SetGroupVisible(tabGroup1, false);
+
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks,
+		ElementsAre(L"Blocking", L"Tab1Interactive", L"Tab2Visible", L"Tab2Background",
+			L"Tab1Visible"));
+}
+
+TEST_F(TaskSchedulerTest, Reprioritize)
+{
+	auto blockingGroup = m_scheduler.CreateGroup();
+	auto group = m_scheduler.CreateGroup();
+	auto otherGroup = m_scheduler.CreateGroup();
+
+	PushLabelledTask(blockingGroup, Priority::Visible, L"Blocking");
+	PushLabelledTask(group, Priority::Visible, L"Task0", 0);
+	PushLabelledTask(group, Priority::Visible, L"Untagged");
+	PushLabelledTask(otherGroup, Priority::Visible, L"Other", 1);
+	PushLabelledTask(group, Priority::Visible, L"Task1", 1);
+	PushLabelledTask(group, Priority::Visible, L"Task2", 2);
+	PushLabelledTask(group, Priority::Background, L"Task3", 3);
+
+	auto cancelledTags = m_scheduler.Reprioritize(group,
+		[](TaskScheduler::TaskTag tag) -> std::optional<Priority>
+		{
+			switch (tag)
+			{
+			case 0:
+			case 3:
+				return Priority::Visible;
+
+			case 1:
+				return Priority::Background;
+
+			default:
+				return std::nullopt;
+			}
+		});
+	EXPECT_THAT(cancelledTags, ElementsAre(2));
+	EXPECT_EQ(m_scheduler.GetNumQueuedTasks(), 5u);
+
+	// Untagged tasks and tasks in other groups should be unaffected. Tasks that remain within the
+	// same priority should also retain their relative order.
+	RunAllTasks();
+	EXPECT_THAT(m_completedTasks,
+		ElementsAre(L"Blocking", L"Task0", L"Untagged", L"Other", L"Task3", L"Task1"));
+}
+
+TEST_F(TaskSchedulerTest, ExecutorPerPriority)
+{
+	auto interactiveExecutor = std::make_shared<concurrencpp::manual_executor>();
+	auto visibleExecutor = std::make_shared<concurrencpp::manual_executor>();
+	auto backgroundExecutor = std::make_shared<concurrencpp::manual_executor>();
+
+	{
+		TaskScheduler scheduler({ interactiveExecutor, visibleExecutor, backgroundExecutor }, 3);
+
+		auto visibleGroup = scheduler.CreateGroup();
+		auto hiddenGroup = scheduler.CreateGroup();
+		scheduler.SetGroupVisible(hiddenGroup, false);
+
+		scheduler.Push(visibleGroup, Priority::Interactive, [] {});
+		scheduler.Push(visibleGroup, Priority::Visible, [] {});
+		scheduler.Push(hiddenGroup, Priority::Visible, [] {});
+
+		// Tasks should be run on the executor that corresponds to their effective priority.
+		EXPECT_EQ(interactiveExecutor->size(), 1u);
+		EXPECT_EQ(visibleExecutor->size(), 1u);
+		EXPECT_EQ(backgroundExecutor->size(), 1u);
+	}
+
+	// Tasks that are already running should be able to finish after the scheduler has been
+	// destroyed.
+	interactiveExecutor->loop(std::numeric_limits<size_t>::max());
+	visibleExecutor->loop(std::numeric_limits<size_t>::max());
+	backgroundExecutor->loop(std::numeric_limits<size_t>::max());
+
+	interactiveExecutor->shutdown();
+	visibleExecutor->shutdown();
+	backgroundExecutor->shutdown();
+}
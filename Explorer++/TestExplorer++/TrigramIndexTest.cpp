@@ -0,0 +1,145 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/TrigramIndex.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iterator>
+
+using namespace testing;
+
+namespace
+{
+
+std::vector<TrigramIndex::DocumentId> GetDocumentIds(const std::vector<TrigramIndex::Match> &matches)
+{
+	std::vector<TrigramIndex::DocumentId> documentIds;
+	std::ranges::transform(matches, std::back_inserter(documentIds),
+		&TrigramIndex::Match::documentId);
+	return documentIds;
+}
+
+}
+
+TEST(TrigramIndexTest, SubstringMatch)
+{
+	TrigramIndex index({ 1.0 });
+	index.SetDocument(1, { L"Explorer++ project" });
+	index.SetDocument(2, { L"GitHub" });
+	index.SetDocument(3, { L"Project notes" });
+
+	EXPECT_THAT(GetDocumentIds(index.Search(L"project", 10)), UnorderedElementsAre(1, 3));
+	EXPECT_THAT(GetDocumentIds(index.Search(L"GITHUB", 10)), ElementsAre(2));
+	EXPECT_THAT(index.Search(L"unrelated", 10), IsEmpty());
+}
+
+TEST(TrigramIndexTest, ApproximateMatch)
+{
+	TrigramIndex index({ 1.0 });
+	index.SetDocument(1, { L"Explorer" });
+	index.SetDocument(2, { L"Documents" });
+
+	// The query is missing a character, but still shares most of its trigrams with the first
+	// document.
+	EXPECT_THAT(GetDocumentIds(index.Search(L"explrer", 10)), ElementsAre(1));
+}
+
+TEST(TrigramIndexTest, ShortQuery)
+{
+	TrigramIndex index({ 1.0 });
+	index.SetDocument(1, { L"abc" });
+	index.SetDocument(2, { L"xyz" });
+	index.SetDocument(3, { L"xab" });
+
+	EXPECT_THAT(GetDocumentIds(index.Search(L"ab", 10)), ElementsAre(1, 3));
+	EXPECT_THAT(GetDocumentIds(index.Search(L"y", 10)), ElementsAre(2));
+}
+
+TEST(TrigramIndexTest, Ranking)
+{
+	TrigramIndex index({ 2.0, 1.0 });
+	index.SetDocument(1, { L"Other", L"https://example.com/music" });
+	index.SetDocument(2, { L"My music", L"https://example.com" });
+	index.SetDocument(3, { L"Music", L"https://example.com" });
+	index.SetDocument(4, { L"Musik", L"https://example.com" });
+
+	// A prefix match should be ranked above a substring match, which should in turn be ranked above
+	// an approximate match. A match in the first field should be ranked above a match in the second
+	// field.
+	EXPECT_THAT(GetDocumentIds(index.Search(L"music", 10)), ElementsAre(3, 2, 1, 4));
+}
+
+TEST(TrigramIndexTest, MaxResults)
+{
+	TrigramIndex index({ 1.0 });
+
+	for (TrigramIndex::DocumentId i = 0; i < 10; i++)
+	{
+		index.SetDocument(i, { L"Document " + std::to_wstring(i) });
+	}
+
+	// Matches with the same score should be ordered by ID.
+	EXPECT_THAT(GetDocumentIds(index.Search(L"document", 3)), ElementsAre(0, 1, 2));
+	EXPECT_THAT(index.Search(L"document", 0), IsEmpty());
+}
+
+TEST(TrigramIndexTest, UpdateDocument)
+{
+	TrigramIndex index({ 1.0 });
+	index.SetDocument(1, { L"Old name" });
+	index.SetDocument(1, { L"New name" });
+
+	EXPECT_EQ(index.GetNumDocuments(), 1u);
+	EXPECT_THAT(index.Search(L"old", 10), IsEmpty());
+	EXPECT_THAT(GetDocumentIds(index.Search(L"new", 10)), ElementsAre(1));
+}
+
+TEST(TrigramIndexTest, RemoveDocument)
+{
+	TrigramIndex index({ 1.0 });
+	index.SetDocument(1, { L"Pictures" });
+	index.SetDocument(2, { L"Pictures backup" });
+
+	index.RemoveDocument(1);
+	EXPECT_FALSE(index.HasDocument(1));
+	EXPECT_TRUE(index.HasDocument(2));
+	EXPECT_THAT(GetDocumentIds(index.Search(L"pictures", 10)), ElementsAre(2));
+	EXPECT_THAT(GetDocumentIds(index.Search(L"pi", 10)), ElementsAre(2));
+
+	// Removing a document that doesn't exist should have no effect.
+	index.RemoveDocument(1);
+	EXPECT_EQ(index.GetNumDocuments(), 1u);
+
+	index.Clear();
+	EXPECT_EQ(index.GetNumDocuments(), 0u);
+	EXPECT_THAT(index.Search(L"pictures", 10), IsEmpty());
+}
+
+TEST(TrigramIndexTest, RemoveManyDocuments)
+{
+	TrigramIndex index({ 1.0 });
+
+	for (TrigramIndex::DocumentId i = 0; i < 5000; i++)
+	{
+		index.SetDocument(i, { L"Item " + std::to_wstring(i) });
+	}
+
+	// Removing a large number of documents will cause the index to be compacted. The remaining
+	// documents should still be found.
+	for (TrigramIndex::DocumentId i = 0; i < 5000; i++)
+	{
+		if (i != 4321)
+		{
+			index.RemoveDocument(i);
+		}
+	}
+
+	EXPECT_EQ(index.GetNumDocuments(), 1u);
+	EXPECT_THAT(GetDocumentIds(index.Search(L"item 4321", 10)), ElementsAre(4321));
+
+	index.SetDocument(7, { L"Item 7" });
+	EXPECT_THAT(GetDocumentIds(index.Search(L"item 7", 10)), ElementsAre(7, 4321));
+}
@@ -0,0 +1,175 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "UiResultSink.h"
+#include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace testing;
+
+class UiResultSinkTest : public Test
+{
+protected:
+	UiResultSinkTest() :
+		m_executor(std::make_shared<concurrencpp::manual_executor>()),
+		m_timerQueue(std::make_shared<concurrencpp::timer_queue>(std::chrono::seconds(120)))
+	{
+	}
+
+	~UiResultSinkTest()
+	{
+		m_sink.reset();
+		m_executor->shutdown();
+	}
+
+	void CreateSink(UiResultSink::Clock::duration frameInterval = UiResultSink::Clock::duration(0),
+		UiResultSink::Clock::duration timeBudget = UiResultSink::DEFAULT_TIME_BUDGET)
+	{
+		m_sink = std::make_unique<UiResultSink>(m_executor, m_timerQueue,
+			[this](size_t numCompletions, const std::function<void()> &runBatch)
+			{
+				m_batchSizes.push_back(numCompletions);
+				runBatch();
+			},
+			frameInterval, timeBudget);
+	}
+
+	void PostValue(int value)
+	{
+		m_sink->GetHandle().Post([this, value] { m_values.push_back(value); });
+	}
+
+	void RunAllTasks()
+	{
+		m_executor->loop(std::numeric_limits<size_t>::max());
+	}
+
+	const std::shared_ptr<concurrencpp::manual_executor> m_executor;
+	const std::shared_ptr<concurrencpp::timer_queue> m_timerQueue;
+	std::unique_ptr<UiResultSink> m_sink;
+	std::vector<int> m_values;
+	std::vector<size_t> m_batchSizes;
+};
+
+TEST_F(UiResultSinkTest, Order)
+{
+	CreateSink();
+
+	PostValue(1);
+	PostValue(2);
+	PostValue(3);
+
+	RunAllTasks();
+	EXPECT_EQ(m_values, (std::vector{ 1, 2, 3 }));
+}
+
+TEST_F(UiResultSinkTest, SingleBatch)
+{
+	CreateSink();
+
+	PostValue(1);
+	PostValue(2);
+	PostValue(3);
+
+	// Only the first completion should have scheduled a drain.
+	EXPECT_EQ(m_executor->size(), 1u);
+
+	RunAllTasks();
+	EXPECT_EQ(m_batchSizes, (std::vector<size_t>{ 3 }));
+	EXPECT_EQ(m_values, (std::vector{ 1, 2, 3 }));
+}
+
+TEST_F(UiResultSinkTest, TimeBudget)
+{
+	// With no time budget, only a single completion will be run in each batch.
+	CreateSink(UiResultSink::Clock::duration(0), UiResultSink::Clock::duration(0));
+
+	PostValue(1);
+	PostValue(2);
+	PostValue(3);
+
+	m_executor->loop_once();
+	EXPECT_EQ(m_values, (std::vector{ 1 }));
+
+	// The remaining completions should be carried over to the next batch.
+	RunAllTasks();
+	EXPECT_EQ(m_values, (std::vector{ 1, 2, 3 }));
+	EXPECT_EQ(m_batchSizes, (std::vector<size_t>{ 3, 2, 1 }));
+}
+
+TEST_F(UiResultSinkTest, NextFrame)
+{
+	CreateSink(std::chrono::hours(1));
+
+	PostValue(1);
+	RunAllTasks();
+	EXPECT_EQ(m_values, (std::vector{ 1 }));
+
+	// The previous drain has only just taken place, so this completion shouldn't be run until the
+	// next frame.
+	PostValue(2);
+	EXPECT_EQ(m_executor->size(), 0u);
+
+	RunAllTasks();
+	EXPECT_EQ(m_values, (std::vector{ 1 }));
+}
+
+TEST_F(UiResultSinkTest, SinkDestroyed)
+{
+	CreateSink();
+
+	auto handle = m_sink->GetHandle();
+	handle.Post([this] { m_values.push_back(1); });
+
+	m_sink.reset();
+
+	// Posting via a handle that's outlived the sink should be safe.
+	handle.Post([this] { m_values.push_back(2); });
+
+	RunAllTasks();
+	EXPECT_TRUE(m_values.empty());
+}
+
+TEST_F(UiResultSinkTest, PostFromMultipleThreads)
+{
+	CreateSink();
+
+	constexpr int NUM_THREADS = 4;
+	constexpr int NUM_COMPLETIONS_PER_THREAD = 1000;
+
+	std::vector<std::vector<int>> valuesByThread(NUM_THREADS);
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		threads.emplace_back(
+			[handle = m_sink->GetHandle(), &values = valuesByThread[i]]
+			{
+				for (int j = 0; j < NUM_COMPLETIONS_PER_THREAD; j++)
+				{
+					handle.Post([&values, j] { values.push_back(j); });
+				}
+			});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	RunAllTasks();
+
+	// The completions posted by each thread should have been run in the order they were posted.
+	std::vector<int> expectedValues(NUM_COMPLETIONS_PER_THREAD);
+	std::iota(expectedValues.begin(), expectedValues.end(), 0);
+
+	for (const auto &values : valuesByThread)
+	{
+		EXPECT_EQ(values, expectedValues);
+	}
+}
@@ -10,11 +10,34 @@
 #include "WindowStorage.h"
 #include "WindowStorageTestHelper.h"
 #include "XmlStorageTestHelper.h"
+#include "../Helper/XmlReader.h"
+#include "../Helper/XmlWriter.h"
 #include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
 
 using namespace testing;
 using namespace WindowStorageTestHelper;
 
+namespace
+{
+
+bool MoveToWindowsNode(XmlReader &reader)
+{
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() == XmlReader::NodeType::StartElement
+			&& reader.GetName() == WindowXmlStorage::WINDOWS_NODE_NAME)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
+
 class WindowXmlStorageTest : public XmlStorageTest
 {
 };
@@ -68,3 +91,49 @@ TEST_F(WindowXmlStorageTest, V1Load)
 
 	EXPECT_THAT(loadedWindows, ElementsAre(referenceWindow));
 }
+
+TEST(WindowXmlStreamStorageTest, V2Load)
+{
+	auto referenceWindows = BuildV2ReferenceWindows(TestStorageType::Xml);
+
+	std::ifstream stream(GetResourcePath(L"windows-v2.xml"), std::ios::binary);
+	XmlReader reader(stream);
+	ASSERT_TRUE(MoveToWindowsNode(reader));
+
+	auto loadedWindows = WindowXmlStorage::Load(reader);
+	ASSERT_TRUE(loadedWindows.has_value());
+
+	EXPECT_EQ(*loadedWindows, referenceWindows);
+}
+
+TEST(WindowXmlStreamStorageTest, V2LoadFallback)
+{
+	// The window here is missing data that's stored in the v1 sections, which can only be loaded
+	// using the DOM.
+	std::ifstream stream(GetResourcePath(L"windows-v2-fallback.xml"), std::ios::binary);
+	XmlReader reader(stream);
+	ASSERT_TRUE(MoveToWindowsNode(reader));
+
+	auto loadedWindows = WindowXmlStorage::Load(reader);
+	EXPECT_FALSE(loadedWindows.has_value());
+}
+
+TEST(WindowXmlStreamStorageTest, V2Save)
+{
+	auto referenceWindows = BuildV2ReferenceWindows(TestStorageType::Xml);
+
+	std::stringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		WindowXmlStorage::Save(writer, referenceWindows);
+	}
+
+	XmlReader reader(stream);
+	ASSERT_TRUE(reader.Read());
+
+	auto loadedWindows = WindowXmlStorage::Load(reader);
+	ASSERT_TRUE(loadedWindows.has_value());
+
+	EXPECT_EQ(*loadedWindows, referenceWindows);
+}
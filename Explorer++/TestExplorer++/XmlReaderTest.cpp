@@ -0,0 +1,231 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/XmlReader.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace testing;
+
+TEST(XmlReaderTest, Elements)
+{
+	std::istringstream stream(R"(<?xml version="1.0" encoding="UTF-8"?>
+<!-- Comment -->
+<Root attribute="value">
+	<Child first="1" second='2'/>
+	<Child>Text</Child>
+</Root>
+)");
+	XmlReader reader(stream);
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::StartElement);
+	EXPECT_EQ(reader.GetName(), L"Root");
+	EXPECT_EQ(reader.GetDepth(), 0U);
+	ASSERT_NE(reader.MaybeGetAttribute(L"attribute"), nullptr);
+	EXPECT_EQ(*reader.MaybeGetAttribute(L"attribute"), L"value");
+	EXPECT_EQ(reader.MaybeGetAttribute(L"missing"), nullptr);
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::StartElement);
+	EXPECT_EQ(reader.GetName(), L"Child");
+	EXPECT_EQ(reader.GetDepth(), 1U);
+	ASSERT_EQ(reader.GetAttributes().size(), 2U);
+	EXPECT_EQ(reader.GetAttributes()[0].name, L"first");
+	EXPECT_EQ(reader.GetAttributes()[0].value, L"1");
+	EXPECT_EQ(reader.GetAttributes()[1].name, L"second");
+	EXPECT_EQ(reader.GetAttributes()[1].value, L"2");
+
+	// An empty element still results in an EndElement node.
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::EndElement);
+	EXPECT_EQ(reader.GetName(), L"Child");
+	EXPECT_EQ(reader.GetDepth(), 1U);
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::StartElement);
+	EXPECT_TRUE(reader.GetAttributes().empty());
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::Text);
+	EXPECT_EQ(reader.GetText(), L"Text");
+	EXPECT_EQ(reader.GetDepth(), 2U);
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::EndElement);
+	EXPECT_EQ(reader.GetName(), L"Child");
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::EndElement);
+	EXPECT_EQ(reader.GetName(), L"Root");
+	EXPECT_EQ(reader.GetDepth(), 0U);
+
+	EXPECT_FALSE(reader.Read());
+	EXPECT_FALSE(reader.HasError());
+}
+
+TEST(XmlReaderTest, Entities)
+{
+	std::istringstream stream(
+		"<Root value=\"&lt;&amp;&gt;&quot;&apos;&#65;&#x42;&#10;\tnormalized\">"
+		"&lt;text&gt;<![CDATA[<raw & text>]]></Root>");
+	XmlReader reader(stream);
+
+	ASSERT_TRUE(reader.Read());
+	ASSERT_NE(reader.MaybeGetAttribute(L"value"), nullptr);
+	EXPECT_EQ(*reader.MaybeGetAttribute(L"value"), L"<&>\"'AB\n normalized");
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::Text);
+	EXPECT_EQ(reader.GetText(), L"<text>");
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::Text);
+	EXPECT_EQ(reader.GetText(), L"<raw & text>");
+}
+
+TEST(XmlReaderTest, Utf8)
+{
+	// A byte order mark, followed by characters that are encoded using 2, 3 and 4 bytes.
+	std::istringstream stream(
+		"\xEF\xBB\xBF<Root value=\"\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\"/>");
+	XmlReader reader(stream);
+
+	ASSERT_TRUE(reader.Read());
+	ASSERT_NE(reader.MaybeGetAttribute(L"value"), nullptr);
+
+	std::wstring expected = L"é€";
+
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		expected += L"\xD83D\xDE00";
+	}
+	else
+	{
+		expected += static_cast<wchar_t>(0x1F600);
+	}
+
+	EXPECT_EQ(*reader.MaybeGetAttribute(L"value"), expected);
+}
+
+TEST(XmlReaderTest, Whitespace)
+{
+	std::istringstream stream(R"(<Root>
+	<Child> </Child>
+	<Child>
+		<Grandchild/>
+	</Child>
+</Root>)");
+	XmlReader reader(stream);
+
+	ASSERT_TRUE(reader.Read());
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetName(), L"Child");
+
+	// Whitespace that makes up the content of an element is significant.
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::Text);
+	EXPECT_EQ(reader.GetText(), L" ");
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::EndElement);
+
+	// Whitespace that's used for indentation isn't.
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::StartElement);
+	EXPECT_EQ(reader.GetName(), L"Child");
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::StartElement);
+	EXPECT_EQ(reader.GetName(), L"Grandchild");
+}
+
+TEST(XmlReaderTest, SkipElement)
+{
+	std::istringstream stream(R"(<Root>
+	<Skipped><Child><Grandchild/></Child>Text</Skipped>
+	<Next/>
+</Root>)");
+	XmlReader reader(stream);
+
+	ASSERT_TRUE(reader.Read());
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetName(), L"Skipped");
+
+	ASSERT_TRUE(reader.SkipElement());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::EndElement);
+	EXPECT_EQ(reader.GetName(), L"Skipped");
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::StartElement);
+	EXPECT_EQ(reader.GetName(), L"Next");
+}
+
+// Elements and attributes that straddle the internal buffer boundary should be read correctly.
+TEST(XmlReaderTest, LargeDocument)
+{
+	const int numElements = 20000;
+
+	std::string xml = "<Root>";
+
+	for (int i = 0; i < numElements; i++)
+	{
+		xml += "<Item index=\"" + std::to_string(i) + "\">Text &amp; " + std::to_string(i)
+			+ "</Item>";
+	}
+
+	xml += "</Root>";
+
+	std::istringstream stream(xml);
+	XmlReader reader(stream);
+
+	ASSERT_TRUE(reader.Read());
+
+	int numItems = 0;
+
+	while (reader.Read() && reader.GetDepth() > 0)
+	{
+		ASSERT_EQ(reader.GetNodeType(), XmlReader::NodeType::StartElement);
+		ASSERT_NE(reader.MaybeGetAttribute(L"index"), nullptr);
+		EXPECT_EQ(*reader.MaybeGetAttribute(L"index"), std::to_wstring(numItems));
+
+		ASSERT_TRUE(reader.Read());
+		EXPECT_EQ(reader.GetText(), L"Text & " + std::to_wstring(numItems));
+
+		ASSERT_TRUE(reader.Read());
+		EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::EndElement);
+
+		numItems++;
+	}
+
+	EXPECT_EQ(numItems, numElements);
+	EXPECT_FALSE(reader.Read());
+	EXPECT_FALSE(reader.HasError());
+}
+
+TEST(XmlReaderTest, Malformed)
+{
+	auto readAll = [](const std::string &xml)
+	{
+		std::istringstream stream(xml);
+		XmlReader reader(stream);
+
+		while (reader.Read())
+		{
+		}
+
+		return reader.HasError();
+	};
+
+	EXPECT_TRUE(readAll(""));
+	EXPECT_TRUE(readAll("<Root>"));
+	EXPECT_TRUE(readAll("<Root></Other>"));
+	EXPECT_TRUE(readAll("<Root attribute=value/>"));
+	EXPECT_TRUE(readAll("<Root attribute=\"&unknown;\"/>"));
+	EXPECT_TRUE(readAll("<Root/><Second/>"));
+	EXPECT_TRUE(readAll("Text<Root/>"));
+	EXPECT_TRUE(readAll("<Root value=\"\xFF\"/>"));
+	EXPECT_FALSE(readAll("<Root/>\n"));
+}
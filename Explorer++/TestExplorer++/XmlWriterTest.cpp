@@ -0,0 +1,109 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/XmlWriter.h"
+#include "../Helper/XmlReader.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace testing;
+
+TEST(XmlWriterTest, Output)
+{
+	std::ostringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		writer.WriteDeclaration();
+		writer.WriteComment(L" Comment ");
+		writer.StartElement(L"Root");
+		writer.StartElement(L"Empty");
+		writer.WriteAttribute(L"value", L"<\"&\">");
+		writer.EndElement();
+		writer.StartElement(L"Text");
+		writer.WriteText(L"a < b & c");
+		writer.EndElement();
+		writer.StartElement(L"Parent");
+		writer.StartElement(L"Child");
+		writer.EndElement();
+		writer.EndElement();
+		writer.EndElement();
+	}
+
+	EXPECT_EQ(stream.str(),
+		"<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\r\n"
+		"<!-- Comment -->\r\n"
+		"<Root>\r\n"
+		"\t<Empty value=\"&lt;&quot;&amp;&quot;&gt;\"/>\r\n"
+		"\t<Text>a &lt; b &amp; c</Text>\r\n"
+		"\t<Parent>\r\n"
+		"\t\t<Child/>\r\n"
+		"\t</Parent>\r\n"
+		"</Root>");
+}
+
+TEST(XmlWriterTest, RoundTrip)
+{
+	std::wstring attributeValue = L"line 1\nline 2\r\n\ttabbed é€";
+
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		attributeValue += L"\xD83D\xDE00";
+	}
+	else
+	{
+		attributeValue += static_cast<wchar_t>(0x1F600);
+	}
+
+	std::wstring text = L"Text with <markup> & ü";
+
+	std::stringstream stream;
+
+	{
+		XmlWriter writer(stream);
+		writer.StartElement(L"Root");
+		writer.WriteAttribute(L"value", attributeValue);
+		writer.WriteText(text);
+		writer.EndElement();
+	}
+
+	XmlReader reader(stream);
+
+	ASSERT_TRUE(reader.Read());
+	ASSERT_NE(reader.MaybeGetAttribute(L"value"), nullptr);
+	EXPECT_EQ(*reader.MaybeGetAttribute(L"value"), attributeValue);
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetText(), text);
+
+	ASSERT_TRUE(reader.Read());
+	EXPECT_EQ(reader.GetNodeType(), XmlReader::NodeType::EndElement);
+	EXPECT_FALSE(reader.Read());
+	EXPECT_FALSE(reader.HasError());
+}
+
+TEST(XmlWriterTest, WriteNode)
+{
+	std::string xml = "<Root attribute=\"value\">\r\n"
+					  "\t<Child>Text &amp; more text</Child>\r\n"
+					  "\t<Empty/>\r\n"
+					  "</Root>";
+	std::istringstream inputStream(xml);
+	XmlReader reader(inputStream);
+
+	std::ostringstream outputStream;
+
+	{
+		XmlWriter writer(outputStream);
+
+		while (reader.Read())
+		{
+			writer.WriteNode(reader);
+		}
+	}
+
+	EXPECT_FALSE(reader.HasError());
+	EXPECT_EQ(outputStream.str(), xml);
+}